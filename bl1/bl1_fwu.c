@@ -49,6 +49,12 @@ __dead2 static void bl1_fwu_done(void *client_cookie, void *reserved);
  */
 static unsigned int sec_exec_image_id = INVALID_IMAGE_ID;
 
+/*
+ * This keeps track of the image whose hash is computed as its blocks are
+ * copied, so that its authentication only has to finalize the hash.
+ */
+static unsigned int hashed_image_id = INVALID_IMAGE_ID;
+
 /* Authentication status of each image. */
 extern unsigned int auth_img_flags[];
 
@@ -328,6 +334,14 @@ static int bl1_fwu_image_copy(unsigned int image_id,
 		 * machine.
 		 */
 		image_desc->copied_size = 0;
+
+		/*
+		 * Hash the image as it is copied if its parent certificate has
+		 * been authenticated. This discards the hash of any other image
+		 * being copied, which is then hashed as a whole.
+		 */
+		hashed_image_id = (auth_mod_hash_start(image_id) == 0) ?
+			image_id : INVALID_IMAGE_ID;
 	}
 
 	/*
@@ -356,6 +370,11 @@ static int bl1_fwu_image_copy(unsigned int image_id,
 	memcpy((void *) dest_addr, (const void *) image_src, block_size);
 	flush_dcache_range(dest_addr, block_size);
 
+	/* Hash the secure copy, which the non-secure world cannot modify */
+	if ((hashed_image_id == image_id) &&
+	    (auth_mod_hash_update((void *) dest_addr, block_size) != 0))
+		hashed_image_id = INVALID_IMAGE_ID;
+
 	image_desc->copied_size += block_size;
 	image_desc->state = (block_size == remaining) ?
 		IMAGE_STATE_COPIED : IMAGE_STATE_COPYING;
@@ -444,6 +463,8 @@ static int bl1_fwu_image_auth(unsigned int image_id,
 	 * Authenticate the image.
 	 */
 	INFO("BL1-FWU: Authenticating image_id:%d\n", image_id);
+	if (hashed_image_id == image_id)
+		hashed_image_id = INVALID_IMAGE_ID;
 	result = auth_mod_verify_img(image_id, (void *)base_addr, total_size);
 	if (result != 0) {
 		WARN("BL1-FWU: Authentication Failed err=%d\n", result);
@@ -718,6 +739,12 @@ static int bl1_fwu_image_reset(unsigned int image_id, unsigned int flags)
 		/* Clear authentication state */
 		auth_img_flags[image_id] = 0;
 
+		/* Discard the hash computed while copying the image */
+		if (hashed_image_id == image_id) {
+			auth_mod_hash_abort();
+			hashed_image_id = INVALID_IMAGE_ID;
+		}
+
 		break;
 
 	case IMAGE_STATE_EXECUTED:
@@ -10,6 +10,7 @@
 #include <auth_mod.h>
 #include <bl1.h>
 #include <bl_common.h>
+#include <boot_prof.h>
 #include <console.h>
 #include <debug.h>
 #include <errata_report.h>
@@ -122,6 +123,11 @@ void bl1_main(void)
 	/* Perform remaining generic architectural setup from EL3 */
 	bl1_arch_setup();
 
+#if ENABLE_BOOT_PROFILE
+	/* Start recording the boot milestones */
+	boot_prof_init();
+#endif
+
 #if TRUSTED_BOARD_BOOT
 	/* Initialize authentication module */
 	auth_mod_init();
@@ -136,6 +142,11 @@ void bl1_main(void)
 	/*
 	 * We currently interpret any image id other than
 	 * BL2_IMAGE_ID as the start of firmware update.
+	 *
+	 * BL2 is always loaded on the normal boot path: besides loading the
+	 * remaining images, its platform code configures the memory and its
+	 * protection (e.g. the TZC) before BL31 runs. Platforms whose images
+	 * are already in memory can skip BL1 and BL2 with RESET_TO_BL31.
 	 */
 	if (image_id == BL2_IMAGE_ID)
 		bl1_load_bl2();
@@ -143,6 +154,7 @@ void bl1_main(void)
 		NOTICE("BL1-FWU: *******FWU Process Started*******\n");
 
 	bl1_prepare_next_image(image_id);
+	BOOT_PROF_CAPTURE(image_id, BOOT_PROF_HANDOFF);
 
 	console_flush();
 }
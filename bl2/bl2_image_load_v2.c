@@ -25,6 +25,9 @@ entry_point_info_t *bl2_load_images(void)
 	bl_params_t *bl2_to_next_bl_params;
 	bl_load_info_t *bl2_load_info;
 	const bl_load_info_node_t *bl2_node_info;
+#if LOAD_IMAGE_PIPELINE
+	const bl_load_info_node_t *next_node_info;
+#endif
 	int plat_setup_done = 0;
 	int err;
 
@@ -56,6 +59,23 @@ entry_point_info_t *bl2_load_images(void)
 
 		if (!(bl2_node_info->image_info->h.attr & IMAGE_ATTRIB_SKIP_LOADING)) {
 			INFO("BL2: Loading image id %d\n", bl2_node_info->image_id);
+#if LOAD_IMAGE_PIPELINE
+			/*
+			 * Let the next image be read while this one is being
+			 * authenticated, unless it has to wait for the
+			 * platform setup.
+			 */
+			next_node_info = bl2_node_info->next_load_info;
+			if ((next_node_info != NULL) &&
+			    !(next_node_info->image_info->h.attr &
+			      IMAGE_ATTRIB_SKIP_LOADING) &&
+			    (plat_setup_done ||
+			     !(next_node_info->image_info->h.attr &
+			       IMAGE_ATTRIB_PLAT_SETUP))) {
+				load_image_set_next(next_node_info->image_id,
+						next_node_info->image_info);
+			}
+#endif
 			err = load_auth_image(bl2_node_info->image_id,
 				bl2_node_info->image_info);
 			if (err) {
@@ -8,8 +8,10 @@
 #include <auth_mod.h>
 #include <bl1.h>
 #include <bl_common.h>
+#include <boot_prof.h>
 #include <console.h>
 #include <debug.h>
+#include <errata_report.h>
 #include <platform.h>
 #include "bl2_private.h"
 
@@ -17,7 +19,7 @@
 /*******************************************************************************
  * The only thing to do in BL2 is to load further images and pass control to
  * next BL. The memory occupied by BL2 will be reclaimed by BL3x stages. BL2
- * runs entirely in S-EL1.
+ * runs entirely in S-EL1, or in EL3 when it is the reset image (BL2_AT_EL3).
  ******************************************************************************/
 void bl2_main(void)
 {
@@ -26,8 +28,13 @@ void bl2_main(void)
 	NOTICE("BL2: %s\n", version_string);
 	NOTICE("BL2: %s\n", build_message);
 
+#if BL2_AT_EL3
+	/* Report the errata workarounds applied by the reset handler */
+	print_errata_status();
+#else
 	/* Perform remaining generic architectural setup in S-EL1 */
 	bl2_arch_setup();
+#endif
 
 #if TRUSTED_BOARD_BOOT
 	/* Initialize authentication module */
@@ -37,6 +44,12 @@ void bl2_main(void)
 	/* Load the subsequent bootloader images. */
 	next_bl_ep_info = bl2_load_images();
 
+#ifdef AARCH32
+	BOOT_PROF_CAPTURE(BL32_IMAGE_ID, BOOT_PROF_HANDOFF);
+#else
+	BOOT_PROF_CAPTURE(BL31_IMAGE_ID, BOOT_PROF_HANDOFF);
+#endif
+
 #ifdef AARCH32
 	/*
 	 * For AArch32 state BL1 and BL2 share the MMU setup.
@@ -48,10 +61,19 @@ void bl2_main(void)
 
 	console_flush();
 
+#if BL2_AT_EL3
+	/*
+	 * There is no BL1 to return to: run the next BL image directly.
+	 * Information on how to pass control to the BL32 (if present) and
+	 * BL33 software images will be passed to it as an argument.
+	 */
+	bl2_el3_run_next_image(next_bl_ep_info);
+#else
 	/*
 	 * Run next BL image via an SMC to BL1. Information on how to pass
 	 * control to the BL32 (if present) and BL33 software images will
 	 * be passed to next BL image as an argument.
 	 */
 	smc(BL1_SMC_RUN_IMAGE, (unsigned long)next_bl_ep_info, 0, 0, 0, 0, 0, 0);
+#endif
 }
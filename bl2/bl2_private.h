@@ -17,5 +17,6 @@ struct entry_point_info;
  *****************************************/
 void bl2_arch_setup(void);
 struct entry_point_info *bl2_load_images(void);
+void bl2_el3_run_next_image(const struct entry_point_info *ep_info) __dead2;
 
 #endif /* __BL2_PRIVATE_H__ */
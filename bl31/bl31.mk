@@ -14,6 +14,7 @@ BL31_SOURCES		+=	bl31/bl31_main.c				\
 				bl31/bl31_context_mgmt.c			\
 				common/runtime_svc.c				\
 				plat/common/aarch64/platform_mp_stack.S		\
+				services/arm_arch_svc/arm_arch_svc_setup.c	\
 				services/std_svc/std_svc_setup.c		\
 				${PSCI_LIB_SOURCES}
 
@@ -21,6 +22,45 @@ ifeq (${ENABLE_PMF}, 1)
 BL31_SOURCES		+=	lib/pmf/pmf_main.c
 endif
 
+ifeq (${EL3_EXCEPTION_HANDLING}, 1)
+BL31_SOURCES		+=	bl31/ehf.c
+endif
+
+ifeq (${SDEI_SUPPORT}, 1)
+BL31_SOURCES		+=	services/std_svc/sdei/sdei_dispatch.c		\
+				services/std_svc/sdei/sdei_main.c
+endif
+
+ifeq (${ENABLE_SPM}, 1)
+BL31_SOURCES		+=	services/std_svc/spm/spm_helpers.S		\
+				services/std_svc/spm/spm_main.c			\
+				services/std_svc/spm/spm_shim_exceptions.S
+endif
+
+ifeq (${EL3_SMP_CALL}, 1)
+BL31_SOURCES		+=	bl31/smp_call.c
+endif
+
+ifeq (${ENABLE_DCSW_BENCHMARK}, 1)
+BL31_SOURCES		+=	bl31/dcsw_benchmark.c
+endif
+
+ifeq (${ENABLE_CONSOLE_BUFFER}, 1)
+BL31_SOURCES		+=	drivers/console/console_buffer.c
+endif
+
+ifeq (${ENABLE_STACK_WATERMARK}, 1)
+BL31_SOURCES		+=	bl31/stack_watermark.c
+endif
+
+ifeq (${ENABLE_TRACE_EVENTS}, 1)
+BL31_SOURCES		+=	lib/trace/trace_event.c
+endif
+
+ifeq (${RAS_EXTENSION}, 1)
+BL31_SOURCES		+=	lib/ras/ras.c
+endif
+
 BL31_LINKERFILE		:=	bl31/bl31.ld.S
 
 # Flag used to indicate if Crash reporting via console should be included
@@ -31,3 +71,11 @@ endif
 
 $(eval $(call assert_boolean,CRASH_REPORTING))
 $(eval $(call add_define,CRASH_REPORTING))
+
+# The crash record is written by the crash reporting code, from its crash buf.
+ifeq (${CRASH_DUMP_BUFFER},1)
+    ifneq (${CRASH_REPORTING},1)
+        $(error "CRASH_DUMP_BUFFER requires CRASH_REPORTING")
+    endif
+BL31_SOURCES		+=	bl31/crash_dump.c
+endif
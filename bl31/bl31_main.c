@@ -9,14 +9,23 @@
 #include <assert.h>
 #include <bl_common.h>
 #include <bl31.h>
+#include <boot_prof.h>
 #include <console.h>
 #include <context_mgmt.h>
+#include <crash_dump.h>
 #include <debug.h>
+#include <ehf.h>
 #include <platform.h>
 #include <pmf.h>
+#include <ras.h>
 #include <runtime_instr.h>
 #include <runtime_svc.h>
+#include <smp_call.h>
 #include <string.h>
+#include <utils.h>
+#if RECLAIM_INIT_CODE
+#include <xlat_tables_v2.h>
+#endif
 
 #if ENABLE_RUNTIME_INSTRUMENTATION
 PMF_REGISTER_SERVICE_SMC(rt_instr_svc, PMF_RT_INSTR_SVC_ID,
@@ -52,10 +61,38 @@ uintptr_t get_arm_std_svc_args(unsigned int svc_mask)
 	return (uintptr_t)&psci_args;
 }
 
+#if RECLAIM_INIT_CODE
+/*
+ * Remap the pages of the code only run during the cold boot as data and clear
+ * them for the data marked __runtime_bss. This must not be called from an
+ * __init function, and no __runtime_bss data may be accessed before.
+ */
+static void bl31_reclaim_init_memory(void)
+{
+	uintptr_t base = (uintptr_t)&__INIT_CODE_START__;
+	size_t size = (uintptr_t)&__INIT_CODE_END__ - base;
+	int rc;
+
+	if (size == 0)
+		return;
+
+	rc = change_mem_attributes(base, size, MT_MEMORY | MT_RW | MT_SECURE);
+	if (rc != 0) {
+		ERROR("BL31: Failed to remap the init code as data (%d)\n", rc);
+		panic();
+	}
+
+	zeromem((void *)base, size);
+	flush_dcache_range(base, size);
+
+	INFO("BL31: Reclaimed %zu bytes of init code\n", size);
+}
+#endif
+
 /*******************************************************************************
  * Simple function to initialise all BL31 helper libraries.
  ******************************************************************************/
-void bl31_lib_init(void)
+void __init bl31_lib_init(void)
 {
 	cm_init();
 }
@@ -66,19 +103,47 @@ void bl31_lib_init(void)
  * function calls runtime_svc_init() which initializes all registered runtime
  * services. The run time services would setup enough context for the core to
  * swtich to the next exception level. When this function returns, the core will
- * switch to the programmed exception level via. an ERET.
+ * switch to the programmed exception level via. an ERET. This function isn't
+ * marked __init as it reclaims the memory of the init code before returning.
  ******************************************************************************/
-void bl31_main(void)
+void __cold bl31_main(void)
 {
+#if ENABLE_STACK_WATERMARK
+	/* Paint the stacks before anything else runs on the secondary CPUs */
+	bl31_stack_watermark_init();
+#endif
+
 	NOTICE("BL31: %s\n", version_string);
 	NOTICE("BL31: %s\n", build_message);
 
 	/* Perform platform setup in BL31 */
 	bl31_platform_setup();
 
+#if CRASH_DUMP_BUFFER
+	crash_dump_init();
+#endif
+
+#if ENABLE_DCSW_BENCHMARK
+	/* Report the cost of the set/way maintenance of each cache level */
+	bl31_dcsw_op_benchmark();
+#endif
+
 	/* Initialise helper libraries */
 	bl31_lib_init();
 
+#if EL3_EXCEPTION_HANDLING
+	INFO("BL31: Initialising Exception Handling Framework\n");
+	ehf_init();
+#endif
+
+#if EL3_SMP_CALL
+	smp_call_init();
+#endif
+
+#if RAS_EXTENSION
+	ras_init();
+#endif
+
 	/* Initialize the runtime services e.g. psci. */
 	INFO("BL31: Initializing runtime services\n");
 	runtime_svc_init();
@@ -113,6 +178,13 @@ void bl31_main(void)
 	 * from BL31
 	 */
 	bl31_plat_runtime_setup();
+
+#if RECLAIM_INIT_CODE
+	bl31_reclaim_init_memory();
+#endif
+
+	/* Buffer the console output of the CPUs from now on */
+	console_buffer_start();
 }
 
 /*******************************************************************************
@@ -138,7 +210,7 @@ uint32_t bl31_get_next_image_type(void)
  * This function programs EL3 registers and performs other setup to enable entry
  * into the next image after BL31 at the next ERET.
  ******************************************************************************/
-void bl31_prepare_next_image_entry(void)
+void __init bl31_prepare_next_image_entry(void)
 {
 	entry_point_info_t *next_image_info;
 	uint32_t image_type;
@@ -168,6 +240,8 @@ void bl31_prepare_next_image_entry(void)
 	print_entry_point_info(next_image_info);
 	cm_init_my_context(next_image_info);
 	cm_prepare_el3_exit(image_type);
+	BOOT_PROF_CAPTURE((image_type == SECURE) ? BL32_IMAGE_ID :
+			  BL33_IMAGE_ID, BOOT_PROF_HANDOFF);
 }
 
 /*******************************************************************************
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch_helpers.h>
+#include <cassert.h>
+#include <crash_dump.h>
+#include <debug.h>
+#include <platform_def.h>
+
+#if ENABLE_TRACE_EVENTS
+CASSERT(CRASH_DUMP_TRACE_EVENTS <= PLAT_TRACE_EVENTS,
+	assert_crash_dump_trace_events);
+#endif
+
+CASSERT((PLAT_CRASH_DUMP_BASE & (CACHE_WRITEBACK_GRANULE - 1)) == 0,
+	assert_crash_dump_base_alignment);
+
+static crash_dump_t *crash_dump_record(unsigned int cpu_idx)
+{
+	return (crash_dump_t *)(PLAT_CRASH_DUMP_BASE +
+				((uintptr_t)cpu_idx << CRASH_DUMP_SLOT_SHIFT));
+}
+
+static int crash_dump_valid(const crash_dump_t *dump)
+{
+	return (dump->magic == CRASH_DUMP_MAGIC) &&
+	       (dump->version == CRASH_DUMP_VERSION);
+}
+
+/*******************************************************************************
+ * Copy 'count' double words of the crash record of the CPU 'cpu_idx' from the
+ * byte 'offset', the words beyond the end of the record being 0. The record is
+ * left by a crash of the CPU, possibly before the last reset. Return the size
+ * of the record, or -1 if the CPU has no valid record or 'offset' is not a
+ * double word in it.
+ ******************************************************************************/
+int crash_dump_read(unsigned int cpu_idx, unsigned int offset,
+		    uint64_t *data, unsigned int count)
+{
+	const crash_dump_t *dump;
+	unsigned int i;
+
+	if (cpu_idx >= PLATFORM_CORE_COUNT)
+		return -1;
+
+	dump = crash_dump_record(cpu_idx);
+	if (!crash_dump_valid(dump) || (offset >= sizeof(*dump)) ||
+	    (offset & (sizeof(uint64_t) - 1)))
+		return -1;
+
+	for (i = 0; i < count; i++, offset += sizeof(uint64_t)) {
+		data[i] = (offset < sizeof(*dump)) ?
+			  *(const uint64_t *)((uintptr_t)dump + offset) : 0;
+	}
+
+	return sizeof(*dump);
+}
+
+/* Invalidate the crash record of the CPU 'cpu_idx' once it has been read */
+int crash_dump_clear(unsigned int cpu_idx)
+{
+	crash_dump_t *dump;
+
+	if (cpu_idx >= PLATFORM_CORE_COUNT)
+		return -1;
+
+	dump = crash_dump_record(cpu_idx);
+	dump->magic = 0;
+	flush_dcache_range((uintptr_t)&dump->magic, sizeof(dump->magic));
+
+	return 0;
+}
+
+/* Report the CPUs that left a crash record before the last reset */
+void crash_dump_init(void)
+{
+	const crash_dump_t *dump;
+	unsigned int i;
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		dump = crash_dump_record(i);
+		if (!crash_dump_valid(dump))
+			continue;
+
+		NOTICE("BL31: CPU %u crashed (reason %llu) at 0x%llx\n", i,
+		       (unsigned long long)dump->reason,
+		       (unsigned long long)dump->gpregs[30]);
+	}
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <bl31.h>
+#include <debug.h>
+
+/* Highest cache level that has a dcsw_op_levelN() helper */
+#define DCSW_BENCHMARK_MAX_LEVEL	3
+
+static void (*const dcsw_op_level[DCSW_BENCHMARK_MAX_LEVEL])(u_register_t) = {
+	dcsw_op_level1,
+	dcsw_op_level2,
+	dcsw_op_level3
+};
+
+/*******************************************************************************
+ * Time a clean and invalidate by set/way of each data or unified cache level up
+ * to the Level of Coherency and print the result. This is called on the cold
+ * boot path, before the secondary CPUs are powered on, so that the operations
+ * are not disturbed by the traffic of the other CPUs.
+ ******************************************************************************/
+void bl31_dcsw_op_benchmark(void)
+{
+	u_register_t clidr = read_clidr_el1();
+	unsigned long long freq = read_cntfrq_el0();
+	unsigned long long start, ticks;
+	unsigned int level, loc, ctype;
+
+	loc = (clidr >> LOC_SHIFT) & ((1 << CLIDR_FIELD_WIDTH) - 1);
+	if (loc > DCSW_BENCHMARK_MAX_LEVEL)
+		loc = DCSW_BENCHMARK_MAX_LEVEL;
+
+	for (level = 0; level < loc; level++) {
+		ctype = (clidr >> (level * CLIDR_FIELD_WIDTH)) &
+			((1 << CLIDR_FIELD_WIDTH) - 1);
+
+		/* Stop at the first level without cache, skip the icaches */
+		if (ctype == 0)
+			break;
+		if (ctype < 2)
+			continue;
+
+		isb();
+		start = read_cntpct_el0();
+		dcsw_op_level[level](DCCISW);
+		isb();
+		ticks = read_cntpct_el0() - start;
+
+		INFO("BL31: DC CISW level %u: %llu ticks (%llu us)\n",
+		     level + 1, ticks,
+		     (freq != 0) ? (ticks * 1000000ULL) / freq : 0ULL);
+	}
+}
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Exception handlers at EL3, their priority levels, and management.
+ */
+
+#include <assert.h>
+#include <debug.h>
+#include <ehf.h>
+#include <errno.h>
+#include <interrupt_mgmt.h>
+#include <platform.h>
+#include <platform_def.h>
+
+/*
+ * Per-CPU state of the framework. 'active_pri_bits' has the bit N set when the
+ * priority level N is active, and 'init_pri_mask' holds the priority mask of
+ * the CPU interface before the first of the active levels was activated.
+ */
+typedef struct pe_exc_data {
+	uint32_t active_pri_bits;
+	uint8_t init_pri_mask;
+} pe_exc_data_t;
+
+static pe_exc_data_t pe_exc_data[PLATFORM_CORE_COUNT];
+
+#define pri_bits		(exception_data.pri_bits)
+#define pri_desc(idx)		(exception_data.ehf_priorities[(idx)])
+
+/* Return the index of the level of 'priority', which must be valid */
+static unsigned int pri_to_idx(unsigned int priority)
+{
+	unsigned int idx;
+
+	idx = EHF_PRI_TO_IDX(priority, pri_bits);
+	assert(idx < exception_data.num_priorities);
+	assert(pri_desc(idx).valid);
+
+	return idx;
+}
+
+/* Return the index of the highest active level, with at least one active */
+static unsigned int get_highest_active_idx(const pe_exc_data_t *pe_data)
+{
+	assert(pe_data->active_pri_bits);
+	return __builtin_ctz(pe_data->active_pri_bits);
+}
+
+/*******************************************************************************
+ * Mark the priority level of 'priority' as active on the calling CPU and mask
+ * the interrupts of this level and of the lower ones at the CPU interface. The
+ * level must be higher than the ones already active.
+ *
+ * This is meant for the dispatchers that let S-EL1 or EL3 run on behalf of an
+ * interrupt or of a request, so that only the interrupts of a higher priority
+ * level can preempt this execution.
+ ******************************************************************************/
+void ehf_activate_priority(unsigned int priority)
+{
+	pe_exc_data_t *pe_data = &pe_exc_data[plat_my_core_pos()];
+	unsigned int idx, old_mask;
+
+	idx = pri_to_idx(priority);
+
+	if (pe_data->active_pri_bits &&
+	    (idx >= get_highest_active_idx(pe_data))) {
+		ERROR("EHF: Activation of priority 0x%x below 0x%x\n", priority,
+		      EHF_IDX_TO_PRI(get_highest_active_idx(pe_data), pri_bits));
+		panic();
+	}
+
+	old_mask = plat_ic_set_priority_mask(EHF_IDX_TO_PRI(idx, pri_bits));
+	if (!pe_data->active_pri_bits)
+		pe_data->init_pri_mask = old_mask;
+
+	pe_data->active_pri_bits |= 1 << idx;
+}
+
+/*******************************************************************************
+ * Mark the priority level of 'priority', which must be the highest active one
+ * on the calling CPU, as no longer active and restore the priority mask of the
+ * previous active level, or the initial one.
+ ******************************************************************************/
+void ehf_deactivate_priority(unsigned int priority)
+{
+	pe_exc_data_t *pe_data = &pe_exc_data[plat_my_core_pos()];
+	unsigned int idx;
+
+	idx = pri_to_idx(priority);
+
+	if (!pe_data->active_pri_bits ||
+	    (idx != get_highest_active_idx(pe_data))) {
+		ERROR("EHF: Deactivation of priority 0x%x not active\n",
+		      priority);
+		panic();
+	}
+
+	pe_data->active_pri_bits &= ~(1 << idx);
+
+	if (pe_data->active_pri_bits)
+		plat_ic_set_priority_mask(EHF_IDX_TO_PRI(
+				get_highest_active_idx(pe_data), pri_bits));
+	else
+		plat_ic_set_priority_mask(pe_data->init_pri_mask);
+}
+
+/*******************************************************************************
+ * Top-level handler of the EL3 interrupts, which dispatches each of them to
+ * the handler registered for its priority level. The handler is responsible
+ * for signalling the end of the interrupt to the interrupt controller.
+ ******************************************************************************/
+static uint64_t ehf_el3_interrupt_handler(uint32_t id, uint32_t flags,
+					  void *handle, void *cookie)
+{
+	unsigned int pri, idx, intr_raw;
+	ehf_handler_t handler;
+
+	/* Acknowledging the interrupt makes its priority the running one */
+	intr_raw = plat_ic_acknowledge_interrupt();
+	if (plat_ic_is_spurious(intr_raw))
+		return (uint64_t) handle;
+
+	pri = plat_ic_get_running_priority();
+	idx = EHF_PRI_TO_IDX(pri, pri_bits);
+
+	handler = NULL;
+	if ((pri <= 0x7f) && (idx < exception_data.num_priorities) &&
+	    pri_desc(idx).valid)
+		handler = pri_desc(idx).handler;
+
+	if (!handler) {
+		ERROR("EHF: No handler for interrupt %u of priority 0x%x\n",
+		      intr_raw, pri);
+		panic();
+	}
+
+	return (uint64_t) handler(intr_raw, flags, handle, cookie);
+}
+
+/*******************************************************************************
+ * Register 'handler' for the EL3 interrupts of the priority level of 'pri',
+ * which the platform must have declared with EHF_PRI_DESC().
+ ******************************************************************************/
+int ehf_register_priority_handler(unsigned int pri, ehf_handler_t handler)
+{
+	unsigned int idx;
+
+	if (!handler || (pri > 0x7f))
+		return -EINVAL;
+
+	idx = EHF_PRI_TO_IDX(pri, pri_bits);
+	if ((idx >= exception_data.num_priorities) || !pri_desc(idx).valid)
+		return -EINVAL;
+
+	if (pri_desc(idx).handler)
+		return -EALREADY;
+
+	pri_desc(idx).handler = handler;
+
+	return 0;
+}
+
+/*******************************************************************************
+ * Initialise the framework: check the table of priority levels provided by the
+ * platform and route the EL3 interrupts to EL3 from both security states.
+ ******************************************************************************/
+void ehf_init(void)
+{
+	uint32_t flags = 0;
+	int ret;
+
+	assert(exception_data.ehf_priorities);
+	assert((pri_bits >= 1) && (pri_bits <= EHF_MAX_PRI_BITS));
+	assert(exception_data.num_priorities <= (1 << pri_bits));
+
+	set_interrupt_rm_flag(flags, NON_SECURE);
+	set_interrupt_rm_flag(flags, SECURE);
+
+	ret = register_interrupt_type_handler(INTR_TYPE_EL3,
+					      ehf_el3_interrupt_handler, flags);
+	if (ret) {
+		ERROR("EHF: Failed to register the EL3 interrupt handler\n");
+		panic();
+	}
+}
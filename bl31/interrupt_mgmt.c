@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <arch.h>
+#include <arch_helpers.h>
 #include <assert.h>
 #include <bl_common.h>
 #include <context_mgmt.h>
@@ -11,6 +13,7 @@
 #include <interrupt_mgmt.h>
 #include <platform.h>
 #include <stdio.h>
+#include <trace_event.h>
 
 /*******************************************************************************
  * Local structure and corresponding array to keep track of the state of the
@@ -221,6 +224,7 @@ interrupt_type_handler_t get_interrupt_type_handler(uint32_t type)
 	if (validate_interrupt_type(type))
 		return NULL;
 
+	TRACE_EVENT(TRACE_EV_INTR, type, read_scr_el3() & SCR_NS_BIT, 0, 0);
 	return intr_type_descs[type].handler;
 }
 
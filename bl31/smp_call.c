@@ -0,0 +1,311 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Calls of functions at EL3 on other CPUs, signalled with a Secure SGI.
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <assert.h>
+#include <debug.h>
+#include <ehf.h>
+#include <errno.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <pmf.h>
+#include <psci.h>
+#include <runtime_instr.h>
+#include <smp_call.h>
+#include <spinlock.h>
+#include <utils.h>
+#include <utils_def.h>
+
+/* Number of CPUs a single SGI can target, with the same Aff1 to Aff3 */
+#define SMP_CALL_MAX_AFF0	16
+
+/*
+ * Request slot of a CPU. The caller holding 'lock' can post a request when
+ * 'req_seq' equals 'done_seq', which it does by updating 'func' and 'arg' and
+ * then incrementing 'req_seq'. The target CPU updates 'done_seq' to 'req_seq'
+ * once the function has returned.
+ */
+typedef struct smp_call_slot {
+	spinlock_t lock;
+	smp_call_func_t func;
+	void *arg;
+	volatile unsigned int req_seq;
+	volatile unsigned int done_seq;
+} __aligned(CACHE_WRITEBACK_GRANULE) smp_call_slot_t;
+
+static smp_call_slot_t smp_call_slots[PLATFORM_CORE_COUNT];
+
+/* Part of a memory range zeroed by a CPU */
+typedef struct smp_zero_chunk {
+	uintptr_t base;
+	u_register_t length;
+} smp_zero_chunk_t;
+
+/* Post a request to the slot of the CPU 'cpu_idx' and return its number */
+static unsigned int smp_call_post(unsigned int cpu_idx, smp_call_func_t func,
+				  void *arg)
+{
+	smp_call_slot_t *slot = &smp_call_slots[cpu_idx];
+	unsigned int seq;
+
+	for (;;) {
+		spin_lock(&slot->lock);
+		if (slot->req_seq == slot->done_seq)
+			break;
+		spin_unlock(&slot->lock);
+
+		/*
+		 * The target CPU may itself be waiting for the calling CPU to
+		 * service its own request.
+		 */
+		smp_call_poll();
+	}
+
+	slot->func = func;
+	slot->arg = arg;
+
+	/* Make the request visible before its number */
+	dmbish();
+	seq = slot->req_seq + 1;
+	slot->req_seq = seq;
+	spin_unlock(&slot->lock);
+
+	return seq;
+}
+
+/* Wait until the CPU 'cpu_idx' has serviced the request 'seq' */
+static void smp_call_wait(unsigned int cpu_idx, unsigned int seq)
+{
+	const smp_call_slot_t *slot = &smp_call_slots[cpu_idx];
+
+	while ((int)(slot->done_seq - seq) < 0)
+		smp_call_poll();
+}
+
+/*******************************************************************************
+ * Service the pending request of the calling CPU, if any. This is called on
+ * the Secure SGI and by the CPUs waiting for another CPU, which services the
+ * requests made to them meanwhile.
+ ******************************************************************************/
+void smp_call_poll(void)
+{
+	smp_call_slot_t *slot = &smp_call_slots[plat_my_core_pos()];
+	unsigned int seq = slot->req_seq;
+
+	if (seq == slot->done_seq)
+		return;
+
+	/* Read the request after its number */
+	dmbish();
+	slot->func(slot->arg);
+
+	/* Make the effects of the function visible before the completion */
+	dmbish();
+	slot->done_seq = seq;
+}
+
+/*******************************************************************************
+ * Call 'func' with 'arg' on the CPUs whose MPIDR is 'target_group' with Aff0
+ * set to the position of each bit set in 'aff0_mask', and wait until it has
+ * returned on all of them. The function is called directly when the calling
+ * CPU is one of the targets. The target CPUs must be powered on, and the
+ * function must neither block nor make another call through this facility.
+ *
+ * Return 0 on success or -EINVAL if a target CPU is invalid.
+ ******************************************************************************/
+int smp_call_cpus(u_register_t target_group, unsigned int aff0_mask,
+		  smp_call_func_t func, void *arg)
+{
+	unsigned int seq[SMP_CALL_MAX_AFF0];
+	unsigned int cpu_idx[SMP_CALL_MAX_AFF0];
+	unsigned int self = 0, aff0;
+	u_register_t my_mpidr = read_mpidr_el1() & MPIDR_AFFINITY_MASK;
+	int pos;
+
+	assert(func);
+
+	target_group &= MPIDR_AFFINITY_MASK &
+			~((u_register_t)MPIDR_AFFLVL_MASK << MPIDR_AFF0_SHIFT);
+	if ((aff0_mask == 0) || (aff0_mask >> SMP_CALL_MAX_AFF0))
+		return -EINVAL;
+
+	/* Check all the targets before making any request */
+	for (aff0 = 0; aff0 < SMP_CALL_MAX_AFF0; aff0++) {
+		if (!(aff0_mask & (1 << aff0)))
+			continue;
+
+		pos = plat_core_pos_by_mpidr(target_group | aff0);
+		if (pos < 0)
+			return -EINVAL;
+		cpu_idx[aff0] = pos;
+
+		if ((target_group | aff0) == my_mpidr)
+			self = 1 << aff0;
+	}
+	aff0_mask &= ~self;
+
+	for (aff0 = 0; aff0 < SMP_CALL_MAX_AFF0; aff0++) {
+		if (aff0_mask & (1 << aff0))
+			seq[aff0] = smp_call_post(cpu_idx[aff0], func, arg);
+	}
+
+	/* A single SGI signals all the requests */
+	if (aff0_mask)
+		plat_ic_raise_el3_sgi(PLAT_SMP_CALL_SGI, target_group,
+				      aff0_mask);
+
+	if (self)
+		func(arg);
+
+	for (aff0 = 0; aff0 < SMP_CALL_MAX_AFF0; aff0++) {
+		if (aff0_mask & (1 << aff0))
+			smp_call_wait(cpu_idx[aff0], seq[aff0]);
+	}
+
+	return 0;
+}
+
+/* Call 'func' with 'arg' on the CPU 'mpidr', as smp_call_cpus() does */
+int smp_call_cpu(u_register_t mpidr, smp_call_func_t func, void *arg)
+{
+	unsigned int aff0 = MPIDR_AFFLVL0_VAL(mpidr);
+
+	if (aff0 >= SMP_CALL_MAX_AFF0)
+		return -EINVAL;
+
+	return smp_call_cpus(mpidr, 1 << aff0, func, arg);
+}
+
+/* Zero the part of the range given to the calling CPU */
+static void smp_zero_chunk(void *arg)
+{
+	const smp_zero_chunk_t *chunk = arg;
+
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc, RT_INSTR_ENTER_MEM_ZERO,
+			      PMF_NO_CACHE_MAINT);
+#endif
+
+	if (chunk->length != 0)
+		zero_normalmem((void *)chunk->base, chunk->length);
+
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc, RT_INSTR_EXIT_MEM_ZERO,
+			      PMF_NO_CACHE_MAINT);
+#endif
+}
+
+/*******************************************************************************
+ * Zero the 'length' bytes of normal memory at 'mem', mapped in BL31, by
+ * splitting them between the CPUs that are on. Each CPU zeroes its part with
+ * zero_normalmem(), which uses DC ZVA. The CPUs must not be turned off until
+ * this returns. When ENABLE_RUNTIME_INSTRUMENTATION is set, the time taken by
+ * each CPU is recorded with the RT_INSTR_ENTER_MEM_ZERO and
+ * RT_INSTR_EXIT_MEM_ZERO timestamps.
+ *
+ * Return 0 on success or -EINVAL if the range overflows.
+ ******************************************************************************/
+int smp_call_zero_mem(void *mem, u_register_t length)
+{
+	smp_zero_chunk_t chunk[PLATFORM_CORE_COUNT];
+	u_register_t target[PLATFORM_CORE_COUNT];
+	unsigned int seq[PLATFORM_CORE_COUNT];
+	unsigned int idx, num_cpus = 1, aff0_mask = 0;
+	unsigned int my_idx = plat_my_core_pos();
+	u_register_t group = 0, chunk_len;
+	uintptr_t base = (uintptr_t)mem;
+
+	if ((length == 0) || check_uptr_overflow(base, length - 1))
+		return -EINVAL;
+
+	/* Find the other CPUs that can be signalled */
+	for (idx = 0; idx < PLATFORM_CORE_COUNT; idx++) {
+		target[idx] = psci_get_on_cpu_mpidr(idx);
+		if ((idx == my_idx) || (target[idx] == PSCI_INVALID_MPIDR) ||
+		    (MPIDR_AFFLVL0_VAL(target[idx]) >= SMP_CALL_MAX_AFF0)) {
+			target[idx] = PSCI_INVALID_MPIDR;
+			continue;
+		}
+		target[idx] &= MPIDR_AFFINITY_MASK;
+		num_cpus++;
+	}
+
+	/* Give each CPU a part made of whole cache lines */
+	chunk_len = round_up(length / num_cpus, CACHE_WRITEBACK_GRANULE);
+
+	for (idx = 0; idx < PLATFORM_CORE_COUNT; idx++) {
+		if (target[idx] == PSCI_INVALID_MPIDR)
+			continue;
+		if (length == 0) {
+			target[idx] = PSCI_INVALID_MPIDR;
+			continue;
+		}
+
+		chunk[idx].base = base;
+		chunk[idx].length = MIN(chunk_len, length);
+		base += chunk[idx].length;
+		length -= chunk[idx].length;
+
+		/* A single SGI signals the CPUs of a group */
+		if ((aff0_mask != 0) &&
+		    (group != (target[idx] & ~MPIDR_AFFLVL_MASK))) {
+			plat_ic_raise_el3_sgi(PLAT_SMP_CALL_SGI, group,
+					      aff0_mask);
+			aff0_mask = 0;
+		}
+		group = target[idx] & ~MPIDR_AFFLVL_MASK;
+		aff0_mask |= 1 << MPIDR_AFFLVL0_VAL(target[idx]);
+
+		seq[idx] = smp_call_post(idx, smp_zero_chunk, &chunk[idx]);
+	}
+
+	if (aff0_mask != 0)
+		plat_ic_raise_el3_sgi(PLAT_SMP_CALL_SGI, group, aff0_mask);
+
+	/* The calling CPU zeroes the rest */
+	chunk[my_idx].base = base;
+	chunk[my_idx].length = length;
+	smp_zero_chunk(&chunk[my_idx]);
+
+	for (idx = 0; idx < PLATFORM_CORE_COUNT; idx++) {
+		if (target[idx] != PSCI_INVALID_MPIDR)
+			smp_call_wait(idx, seq[idx]);
+	}
+
+	return 0;
+}
+
+/* Handler of the priority level of the Secure SGI */
+static int smp_call_sgi_handler(uint32_t intr_raw, uint32_t flags,
+				void *handle, void *cookie)
+{
+	assert(intr_raw == PLAT_SMP_CALL_SGI);
+
+	smp_call_poll();
+	plat_ic_end_of_interrupt(intr_raw);
+
+	return 0;
+}
+
+/*******************************************************************************
+ * Register the handler of the Secure SGI with the EL3 exception handling
+ * framework. The platform must configure PLAT_SMP_CALL_SGI as a Group 0
+ * interrupt of the priority PLAT_SMP_CALL_PRI on every CPU, a level of which
+ * no other interrupt is used.
+ ******************************************************************************/
+void smp_call_init(void)
+{
+	if (ehf_register_priority_handler(PLAT_SMP_CALL_PRI,
+					  smp_call_sgi_handler) != 0) {
+		ERROR("SMP call: Failed to register the SGI handler\n");
+		panic();
+	}
+}
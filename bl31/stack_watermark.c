@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <bl31.h>
+#include <platform_def.h>
+#include <stdint.h>
+
+/* Value written to the unused part of the stacks */
+#define STACK_WATERMARK_PATTERN	0x57a6c5a57a6c5a5ULL
+
+/* Unused space kept between the painted area and the stack of the caller */
+#define STACK_WATERMARK_MARGIN	512
+
+/*
+ * Bounds of the tzfw_normal_stacks section, which only holds the array of the
+ * per-CPU stacks declared by platform_mp_stack.S.
+ */
+extern unsigned long __STACKS_START__;
+extern unsigned long __STACKS_END__;
+
+#define STACKS_START	((uintptr_t)&__STACKS_START__)
+#define STACKS_END	((uintptr_t)&__STACKS_END__)
+
+/*******************************************************************************
+ * Fill the stacks of all the CPUs with a known pattern, except the part of the
+ * stack of the calling CPU that is in use. This is called on the cold boot path,
+ * before the secondary CPUs are powered on. The stacks are then cleaned to
+ * memory, as the secondary CPUs use them before enabling their data cache.
+ ******************************************************************************/
+static void stack_watermark_paint(uintptr_t base, uintptr_t end)
+{
+	volatile uint64_t *p;
+
+	for (p = (volatile uint64_t *)base; (uintptr_t)p < end; p++)
+		*p = STACK_WATERMARK_PATTERN;
+}
+
+void bl31_stack_watermark_init(void)
+{
+	uintptr_t sp = (uintptr_t)__builtin_frame_address(0);
+	uintptr_t base;
+	unsigned int i;
+
+	assert(STACKS_END - STACKS_START >=
+	       PLATFORM_STACK_SIZE * PLATFORM_CORE_COUNT);
+	assert((sp >= STACKS_START) && (sp < STACKS_END));
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		base = STACKS_START + i * PLATFORM_STACK_SIZE;
+		if ((sp >= base) && (sp < base + PLATFORM_STACK_SIZE))
+			stack_watermark_paint(base,
+					      sp - STACK_WATERMARK_MARGIN);
+		else
+			stack_watermark_paint(base,
+					      base + PLATFORM_STACK_SIZE);
+	}
+
+	flush_dcache_range(STACKS_START, STACKS_END - STACKS_START);
+}
+
+/*******************************************************************************
+ * Return the largest number of bytes of its stack that a CPU has used since the
+ * cold boot, found from the lowest address of the stack that no longer holds
+ * the pattern. The stack is cleaned and invalidated first so that the writes of
+ * the CPU made with its data cache disabled are seen.
+ ******************************************************************************/
+unsigned int bl31_stack_watermark_get(unsigned int cpu_idx)
+{
+	const uint64_t *stack;
+	unsigned int i;
+
+	assert(cpu_idx < PLATFORM_CORE_COUNT);
+
+	stack = (const uint64_t *)(STACKS_START + cpu_idx * PLATFORM_STACK_SIZE);
+	flush_dcache_range((uintptr_t)stack, PLATFORM_STACK_SIZE);
+
+	for (i = 0; i < PLATFORM_STACK_SIZE / sizeof(uint64_t); i++) {
+		if (stack[i] != STACK_WATERMARK_PATTERN)
+			break;
+	}
+
+	return PLATFORM_STACK_SIZE - i * sizeof(uint64_t);
+}
@@ -8,6 +8,7 @@
 #include <arch_helpers.h>
 #include <assert.h>
 #include <bl_common.h>
+#include <boot_prof.h>
 #include <context.h>
 #include <context_mgmt.h>
 #include <debug.h>
@@ -121,6 +122,7 @@ static void sp_min_prepare_next_image_entry(void)
 	assert(NON_SECURE == GET_SECURITY_STATE(next_image_info->h.attr));
 
 	INFO("SP_MIN: Preparing exit to normal world\n");
+	BOOT_PROF_CAPTURE(BL33_IMAGE_ID, BOOT_PROF_HANDOFF);
 
 	psci_prepare_next_non_secure_ctx(next_image_info);
 	smc_set_next_ctx(NON_SECURE);
@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
+# Copyright (c) 2013-2017, ARM Limited and Contributors. All rights reserved.
 #
 # SPDX-License-Identifier: BSD-3-Clause
 #
@@ -25,6 +25,20 @@ TSP_INIT_ASYNC         :=      0
 $(eval $(call assert_boolean,TSP_INIT_ASYNC))
 $(eval $(call add_define,TSP_INIT_ASYNC))
 
+# This flag lets the normal world register a command ring with the TSP, whose
+# requests are all serviced by a single SMC. The TSP maps the ring dynamically.
+TSP_RING_BUFFER		:=	0
+
+$(eval $(call assert_boolean,TSP_RING_BUFFER))
+$(eval $(call add_define,TSP_RING_BUFFER))
+
+ifeq (${TSP_RING_BUFFER},1)
+BL32_SOURCES		+=	bl32/tsp/tsp_ring.c
+
+PLAT_XLAT_TABLES_DYNAMIC :=	1
+$(eval $(call add_define,PLAT_XLAT_TABLES_DYNAMIC))
+endif
+
 # Include the platform-specific TSP Makefile
 # If no platform-specific TSP Makefile exists, it means TSP is not supported
 # on this platform.
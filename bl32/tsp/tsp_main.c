@@ -7,6 +7,7 @@
 #include <arch_helpers.h>
 #include <bl_common.h>
 #include <debug.h>
+#include <errno.h>
 #include <platform.h>
 #include <platform_def.h>
 #include <platform_tsp.h>
@@ -342,11 +343,18 @@ tsp_args_t *tsp_smc_handler(uint64_t func,
 	uint64_t results[2];
 	uint64_t service_args[2];
 	uint32_t linear_id = plat_my_core_pos();
+#if TSP_RING_BUFFER
+	int ret;
+#endif
 
 	/* Update this cpu's statistics */
 	tsp_stats[linear_id].smc_count++;
 	tsp_stats[linear_id].eret_count++;
 
+	/* Do not let the logging below skew the timing of the null service */
+	if (TSP_BARE_FID(func) == TSP_NOP)
+		return set_smc_args(func, 0, 0, 0, 0, 0, 0, 0);
+
 	INFO("TSP: cpu 0x%lx received %s smc 0x%lx\n", read_mpidr(),
 		((func >> 31) & 1) == 1 ? "fast" : "yielding",
 		func);
@@ -354,6 +362,23 @@ tsp_args_t *tsp_smc_handler(uint64_t func,
 		tsp_stats[linear_id].smc_count,
 		tsp_stats[linear_id].eret_count);
 
+#if TSP_RING_BUFFER
+	/* The command ring services do not need the arguments from the SPD */
+	switch (TSP_BARE_FID(func)) {
+	case TSP_RING_SETUP:
+		return set_smc_args(func, tsp_ring_setup(arg1, arg2),
+				    0, 0, 0, 0, 0, 0);
+	case TSP_RING_DRAIN:
+		ret = tsp_ring_drain();
+		if (ret < 0)
+			return set_smc_args(func, ret, 0, 0, 0, 0, 0, 0);
+
+		return set_smc_args(func, 0, ret, 0, 0, 0, 0, 0);
+	default:
+		break;
+	}
+#endif
+
 	/* Render secure services and obtain results here */
 	results[0] = arg1;
 	results[1] = arg2;
@@ -365,6 +390,21 @@ tsp_args_t *tsp_smc_handler(uint64_t func,
 	tsp_get_magic(service_args);
 
 	/* Determine the function to perform based on the function ID */
+	tsp_arith_op(func, results, service_args);
+
+	return set_smc_args(func, 0,
+			    results[0],
+			    results[1],
+			    0, 0, 0, 0);
+}
+
+/*******************************************************************************
+ * Apply the arithmetic operation of 'func' to 'results' and 'service_args'.
+ * Returns -EINVAL if 'func' is not an arithmetic operation.
+ ******************************************************************************/
+int tsp_arith_op(uint64_t func, uint64_t results[2],
+		 const uint64_t service_args[2])
+{
 	switch (TSP_BARE_FID(func)) {
 	case TSP_ADD:
 		results[0] += service_args[0];
@@ -383,13 +423,10 @@ tsp_args_t *tsp_smc_handler(uint64_t func,
 		results[1] /= service_args[1] ? service_args[1] : 1;
 		break;
 	default:
-		break;
+		return -EINVAL;
 	}
 
-	return set_smc_args(func, 0,
-			    results[0],
-			    results[1],
-			    0, 0, 0, 0);
+	return 0;
 }
 
 /*******************************************************************************
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2017, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -98,6 +98,16 @@ void tsp_generic_timer_restore(void);
 /* S-EL1 interrupt management functions */
 void tsp_update_sync_sel1_intr_stats(uint32_t type, uint64_t elr_el3);
 
+/* Arithmetic services */
+int tsp_arith_op(uint64_t func, uint64_t results[2],
+		 const uint64_t service_args[2]);
+
+#if TSP_RING_BUFFER
+/* Command ring functions */
+int tsp_ring_setup(uint64_t base, uint64_t size);
+int tsp_ring_drain(void);
+#endif
+
 
 /* Data structure to keep track of TSP statistics */
 extern spinlock_t console_lock;
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch_helpers.h>
+#include <debug.h>
+#include <errno.h>
+#include <spinlock.h>
+#include <tsp.h>
+#include <xlat_tables_v2.h>
+#include "tsp_private.h"
+
+/*
+ * Command ring registered by the normal world. The number of descriptors and
+ * the consumer index are kept here, so that the normal world can't make the
+ * TSP access memory out of the ring by corrupting their copies in the ring.
+ */
+static tsp_ring_t *tsp_ring;
+static uint32_t tsp_ring_num_desc;
+static uint32_t tsp_ring_cons;
+
+/* The ring can be drained from any cpu */
+static spinlock_t tsp_ring_lock;
+
+/*******************************************************************************
+ * Map the command ring of 'size' bytes at 'base' in the normal world memory
+ * and check its header. The ring can be registered only once.
+ ******************************************************************************/
+int tsp_ring_setup(uint64_t base, uint64_t size)
+{
+	tsp_ring_t *ring = (tsp_ring_t *)(uintptr_t)base;
+	uint32_t num_desc;
+	int rc;
+
+	if (!base || !size || !IS_PAGE_ALIGNED(base) || !IS_PAGE_ALIGNED(size))
+		return -EINVAL;
+
+	spin_lock(&tsp_ring_lock);
+
+	if (tsp_ring) {
+		rc = -EALREADY;
+		goto exit;
+	}
+
+	rc = mmap_add_dynamic_region(base, base, size,
+				     MT_MEMORY | MT_RW | MT_NS |
+				     MT_EXECUTE_NEVER);
+	if (rc)
+		goto exit;
+
+	/* All the descriptors must fit in the mapped memory */
+	num_desc = ring->num_desc;
+	if (!num_desc || (num_desc & (num_desc - 1)) ||
+	    (num_desc > (size - sizeof(tsp_ring_t)) /
+			sizeof(tsp_ring_desc_t))) {
+		mmap_remove_dynamic_region(base, size);
+		rc = -EINVAL;
+		goto exit;
+	}
+
+	tsp_ring_num_desc = num_desc;
+	tsp_ring_cons = ring->cons;
+	tsp_ring = ring;
+
+	INFO("TSP: command ring of %u descriptors at 0x%llx\n", num_desc,
+	     (unsigned long long)base);
+
+exit:
+	spin_unlock(&tsp_ring_lock);
+	return rc;
+}
+
+/*******************************************************************************
+ * Service the descriptors that the normal world added to the command ring
+ * since the last drain, and publish their completion at once by advancing the
+ * consumer index. Returns the number of descriptors serviced.
+ ******************************************************************************/
+int tsp_ring_drain(void)
+{
+	tsp_ring_desc_t *desc;
+	uint64_t func, results[2], service_args[2];
+	uint32_t prod, cons, count;
+
+	spin_lock(&tsp_ring_lock);
+
+	if (!tsp_ring) {
+		spin_unlock(&tsp_ring_lock);
+		return -EINVAL;
+	}
+
+	/* Read the descriptors only after the producer index */
+	prod = tsp_ring->prod;
+	dmbish();
+
+	cons = tsp_ring_cons;
+	count = prod - cons;
+	if (count > tsp_ring_num_desc) {
+		spin_unlock(&tsp_ring_lock);
+		return -EINVAL;
+	}
+
+	for (; cons != prod; cons++) {
+		desc = &tsp_ring->desc[cons & (tsp_ring_num_desc - 1)];
+
+		/* Use the same operands as the SMCs, see tsp_smc_handler() */
+		func = desc->func;
+		results[0] = service_args[0] = desc->args[0];
+		results[1] = service_args[1] = desc->args[1];
+
+		desc->status = tsp_arith_op(func, results, service_args);
+		desc->results[0] = results[0];
+		desc->results[1] = results[1];
+	}
+
+	/* Make the results visible before the new consumer index */
+	dmbish();
+	tsp_ring->cons = cons;
+	tsp_ring_cons = cons;
+
+	spin_unlock(&tsp_ring_lock);
+
+	return count;
+}
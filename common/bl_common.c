@@ -9,6 +9,7 @@
 #include <assert.h>
 #include <auth_mod.h>
 #include <bl_common.h>
+#include <boot_prof.h>
 #include <debug.h>
 #include <errno.h>
 #include <io_storage.h>
@@ -200,30 +201,22 @@ size_t image_size(unsigned int image_id)
 #if LOAD_IMAGE_V2
 
 /*******************************************************************************
- * Generic function to load an image at a specific address given
- * an image ID and extents of free memory.
- *
- * If the load is successful then the image information is updated.
- *
- * Returns 0 on success, a negative error code otherwise.
+ * Open an image given its ID, check that it fits in the space described by
+ * 'image_data' and record its size there. On success the device and image
+ * handles are returned and must be released with load_image_end().
  ******************************************************************************/
-int load_image(unsigned int image_id, image_info_t *image_data)
+static int load_image_begin(unsigned int image_id, image_info_t *image_data,
+			    uintptr_t *dev_handle, uintptr_t *image_handle)
 {
-	uintptr_t dev_handle;
-	uintptr_t image_handle;
 	uintptr_t image_spec;
-	uintptr_t image_base;
 	size_t image_size;
-	size_t bytes_read;
 	int io_result;
 
 	assert(image_data != NULL);
 	assert(image_data->h.version >= VERSION_2);
 
-	image_base = image_data->image_base;
-
 	/* Obtain a reference to the image by querying the platform layer */
-	io_result = plat_get_image_source(image_id, &dev_handle, &image_spec);
+	io_result = plat_get_image_source(image_id, dev_handle, &image_spec);
 	if (io_result != 0) {
 		WARN("Failed to obtain reference to image id=%u (%i)\n",
 			image_id, io_result);
@@ -231,7 +224,8 @@ int load_image(unsigned int image_id, image_info_t *image_data)
 	}
 
 	/* Attempt to access the image */
-	io_result = io_open(dev_handle, image_spec, &image_handle);
+	BOOT_PROF_CAPTURE(image_id, BOOT_PROF_OPEN);
+	io_result = io_open(*dev_handle, image_spec, image_handle);
 	if (io_result != 0) {
 		WARN("Failed to access image id=%u (%i)\n",
 			image_id, io_result);
@@ -239,10 +233,10 @@ int load_image(unsigned int image_id, image_info_t *image_data)
 	}
 
 	INFO("Loading image id=%u at address %p\n", image_id,
-		(void *) image_base);
+		(void *) image_data->image_base);
 
 	/* Find the size of the image */
-	io_result = io_size(image_handle, &image_size);
+	io_result = io_size(*image_handle, &image_size);
 	if ((io_result != 0) || (image_size == 0)) {
 		WARN("Failed to determine the size of the image id=%u (%i)\n",
 			image_id, io_result);
@@ -257,14 +251,35 @@ int load_image(unsigned int image_id, image_info_t *image_data)
 	}
 
 	image_data->image_size = image_size;
+	return 0;
+
+exit:
+	io_close(*image_handle);
+	/* Ignore improbable/unrecoverable error in 'close' */
+
+	io_dev_close(*dev_handle);
+	/* Ignore improbable/unrecoverable error in 'dev_close' */
+
+	return io_result;
+}
+
+/*******************************************************************************
+ * Finish loading an image opened by load_image_begin(), once 'bytes_read' bytes
+ * of it have been read into memory, and release its handles.
+ ******************************************************************************/
+static int load_image_end(unsigned int image_id, image_info_t *image_data,
+			  uintptr_t dev_handle, uintptr_t image_handle,
+			  int io_result, size_t bytes_read)
+{
+	uintptr_t image_base = image_data->image_base;
+	size_t image_size = image_data->image_size;
 
-	/* We have enough space so load the image now */
 	/* TODO: Consider whether to try to recover/retry a partially successful read */
-	io_result = io_read(image_handle, image_base, image_size, &bytes_read);
 	if ((io_result != 0) || (bytes_read < image_size)) {
 		WARN("Failed to load image id=%u (%i)\n", image_id, io_result);
 		goto exit;
 	}
+	BOOT_PROF_CAPTURE(image_id, BOOT_PROF_LOAD_END);
 
 #if !TRUSTED_BOARD_BOOT
 	/*
@@ -275,6 +290,7 @@ int load_image(unsigned int image_id, image_info_t *image_data)
 	 * authentication.
 	 */
 	flush_dcache_range(image_base, image_size);
+	BOOT_PROF_CAPTURE(image_id, BOOT_PROF_FLUSH_END);
 #endif /* TRUSTED_BOARD_BOOT */
 
 	INFO("Image id=%u loaded: %p - %p\n", image_id, (void *) image_base,
@@ -291,31 +307,420 @@ exit:
 	return io_result;
 }
 
+#if TRUSTED_BOARD_BOOT
+/*
+ * Size of the chunks in which an image is read when its hash is computed while
+ * it is loaded. Each chunk is hashed while the next one is being read.
+ */
+#ifndef PLAT_LOAD_IMAGE_CHUNK_SIZE
+#define PLAT_LOAD_IMAGE_CHUNK_SIZE	(64 * 1024)
+#endif
+
+/*******************************************************************************
+ * Read an image opened by load_image_begin() chunk by chunk, passing each chunk
+ * to the authentication module as soon as it is in memory. The hash is then
+ * ready for auth_mod_verify_img() when the last chunk has been read.
+ ******************************************************************************/
+static int load_image_hashed(uintptr_t image_handle, image_info_t *image_data,
+			     size_t *bytes_read)
+{
+	uintptr_t image_base = image_data->image_base;
+	size_t image_size = image_data->image_size;
+	size_t offset = 0, next_offset;
+	size_t chunk_size, next_chunk_size = 0, max_chunk_size;
+	size_t chunk_read;
+	int hashing = 1;
+	int io_result;
+
+	/*
+	 * Reads can't overlap with the hashing on synchronous devices, such as
+	 * semihosting, so read the image at once to save the cost of each read.
+	 */
+	if (io_read_is_async(image_handle) != 0)
+		max_chunk_size = PLAT_LOAD_IMAGE_CHUNK_SIZE;
+	else
+		max_chunk_size = image_size;
+
+	chunk_size = MIN(image_size, max_chunk_size);
+	io_result = io_read_start(image_handle, image_base, chunk_size);
+
+	while (io_result == 0) {
+		io_result = io_read_wait(image_handle, &chunk_read);
+		if ((io_result != 0) || (chunk_read != chunk_size))
+			break;
+
+		/* Start reading the next chunk before hashing this one */
+		next_offset = offset + chunk_size;
+		if (next_offset < image_size) {
+			next_chunk_size = MIN(image_size - next_offset,
+					      max_chunk_size);
+			io_result = io_read_start(image_handle,
+						  image_base + next_offset,
+						  next_chunk_size);
+		}
+
+		/* On failure, the image is hashed as a whole later on */
+		if (hashing != 0) {
+			if (auth_mod_hash_update((void *)(image_base + offset),
+						 chunk_size) != 0)
+				hashing = 0;
+		}
+
+		offset = next_offset;
+		chunk_size = next_chunk_size;
+		if (offset >= image_size)
+			break;
+	}
+
+	if (io_result != 0)
+		auth_mod_hash_abort();
+
+	*bytes_read = offset;
+	return io_result;
+}
+#endif /* TRUSTED_BOARD_BOOT */
+
+#if LOAD_IMAGE_PIPELINE
+/*
+ * State of the image whose data is read ahead while the previous image is
+ * being authenticated.
+ */
+#define PREFETCH_NONE		0
+#define PREFETCH_PENDING	1
+#define PREFETCH_DONE		2
+
+static struct {
+	int state;
+	int result;
+	unsigned int image_id;
+	image_info_t *image_data;
+	uintptr_t dev_handle;
+	uintptr_t image_handle;
+} prefetch = { .state = PREFETCH_NONE };
+
+/* Image to read ahead once the current image has been loaded */
+static unsigned int next_image_id = INVALID_IMAGE_ID;
+static image_info_t *next_image_data;
+
+/*******************************************************************************
+ * Register the image loaded after the next call to load_auth_image(). Its data
+ * is read from storage while the current image is being authenticated. The
+ * caller must ensure that nothing modifies the memory of the next image until
+ * it has been loaded.
+ ******************************************************************************/
+void load_image_set_next(unsigned int image_id, image_info_t *image_data)
+{
+	next_image_id = image_id;
+	next_image_data = image_data;
+}
+
+/* Wait for the read-ahead in progress, if any, and release its handles */
+static void load_image_prefetch_wait(void)
+{
+	size_t bytes_read = 0;
+	int io_result;
+
+	if (prefetch.state != PREFETCH_PENDING)
+		return;
+
+	io_result = io_read_wait(prefetch.image_handle, &bytes_read);
+	prefetch.result = load_image_end(prefetch.image_id, prefetch.image_data,
+					 prefetch.dev_handle,
+					 prefetch.image_handle, io_result,
+					 bytes_read);
+	prefetch.state = PREFETCH_DONE;
+}
+
+/* Return 1 if the read-ahead has been started for the given image */
+static int is_image_prefetched(unsigned int image_id,
+			       const image_info_t *image_data)
+{
+	return (prefetch.state != PREFETCH_NONE) &&
+	       (prefetch.image_id == image_id) &&
+	       (prefetch.image_data == image_data);
+}
+
+/* Return 1 if the two memory regions overlap */
+static int regions_overlap(uintptr_t base1, size_t size1,
+			   uintptr_t base2, size_t size2)
+{
+	return (base1 < (base2 + size2)) && (base2 < (base1 + size1));
+}
+#endif /* LOAD_IMAGE_PIPELINE */
+
+/*******************************************************************************
+ * Generic function to load an image at a specific address given
+ * an image ID and extents of free memory.
+ *
+ * If the load is successful then the image information is updated.
+ *
+ * Returns 0 on success, a negative error code otherwise.
+ ******************************************************************************/
+int load_image(unsigned int image_id, image_info_t *image_data)
+{
+	uintptr_t dev_handle;
+	uintptr_t image_handle;
+	size_t bytes_read = 0;
+	int io_result;
+
+#if LOAD_IMAGE_PIPELINE
+	/* The storage must be idle before it is used for another image */
+	load_image_prefetch_wait();
+
+	if (is_image_prefetched(image_id, image_data)) {
+		prefetch.state = PREFETCH_NONE;
+		return prefetch.result;
+	}
+#endif
+
+	io_result = load_image_begin(image_id, image_data, &dev_handle,
+				     &image_handle);
+	if (io_result != 0)
+		return io_result;
+
+#if TRUSTED_BOARD_BOOT
+	/* Compute the hash of the image while it is being loaded if possible */
+	if (auth_mod_hash_start(image_id) == 0) {
+		io_result = load_image_hashed(image_handle, image_data,
+					      &bytes_read);
+		return load_image_end(image_id, image_data, dev_handle,
+				      image_handle, io_result, bytes_read);
+	}
+#endif
+
+	/* We have enough space so load the image now */
+	io_result = io_read(image_handle, image_data->image_base,
+			    image_data->image_size, &bytes_read);
+
+	return load_image_end(image_id, image_data, dev_handle, image_handle,
+			      io_result, bytes_read);
+}
+
 static int load_auth_image_internal(unsigned int image_id,
 				    image_info_t *image_data,
-				    int is_parent_image)
+				    int is_parent_image);
+
+#if LOAD_CERT_IN_PLACE
+/*******************************************************************************
+ * Authenticate the certificate 'image_id' where it sits in storage, which must
+ * be memory-mapped, instead of copying it into the memory of the next image.
+ * Returns -ENODEV if the certificate cannot be accessed in place, in which
+ * case it must be loaded as usual.
+ ******************************************************************************/
+static int auth_cert_in_place(unsigned int image_id, image_info_t *image_data)
 {
+	uintptr_t dev_handle;
+	uintptr_t image_handle;
+	uintptr_t cert_base;
 	int rc;
 
+#if LOAD_IMAGE_PIPELINE
+	/* The storage must be idle before it is used for another image */
+	load_image_prefetch_wait();
+#endif
+
+	rc = load_image_begin(image_id, image_data, &dev_handle,
+			      &image_handle);
+	if (rc != 0)
+		return rc;
+
+	rc = io_map(image_handle, image_data->image_size, &cert_base);
+	if (rc == 0) {
+		rc = auth_mod_verify_img(image_id, (void *)cert_base,
+					 image_data->image_size);
+		if (rc != 0)
+			rc = -EAUTH;
+		else
+			BOOT_PROF_CAPTURE(image_id, BOOT_PROF_AUTH_END);
+	}
+
+	io_close(image_handle);
+	/* Ignore improbable/unrecoverable error in 'close' */
+
+	io_dev_close(dev_handle);
+	/* Ignore improbable/unrecoverable error in 'dev_close' */
+
+	return rc;
+}
+#endif /* LOAD_CERT_IN_PLACE */
+
+#if LOAD_IMAGE_PIPELINE
+/*******************************************************************************
+ * Start reading the image registered by load_image_set_next() after the image
+ * described by 'cur_data' has been loaded. With TBB, the parent certificates
+ * are loaded into the memory of the next image, so they are authenticated
+ * before its data read is started. Any failure simply leaves the next image
+ * to be loaded synchronously, which reports the error.
+ ******************************************************************************/
+static void load_image_prefetch_next(const image_info_t *cur_data)
+{
+	unsigned int image_id = next_image_id;
+	image_info_t *image_data = next_image_data;
+	int rc;
+
+	next_image_id = INVALID_IMAGE_ID;
+	next_image_data = NULL;
+
+	if ((image_id == INVALID_IMAGE_ID) || (image_data == NULL) ||
+	    (prefetch.state != PREFETCH_NONE))
+		return;
+
+#if REUSE_PRESERVED_IMAGES
+	/* Reading the image ahead would overwrite the copy left in memory */
+	if (plat_is_image_preserved(image_id) != 0)
+		return;
+#endif
+
+	if (regions_overlap(cur_data->image_base, cur_data->image_size,
+			    image_data->image_base,
+			    image_data->image_max_size)) {
+		VERBOSE("Image id=%u overlaps current image, not read ahead\n",
+			image_id);
+		return;
+	}
+
 #if TRUSTED_BOARD_BOOT
 	unsigned int parent_id;
 
-	/* Use recursion to authenticate parent images */
-	rc = auth_mod_get_parent_id(image_id, &parent_id);
-	if (rc == 0) {
+	if (auth_mod_get_parent_id(image_id, &parent_id) == 0) {
 		rc = load_auth_image_internal(parent_id, image_data, 1);
-		if (rc != 0) {
-			return rc;
+		if (rc != 0)
+			return;
+	}
+#endif /* TRUSTED_BOARD_BOOT */
+
+	rc = load_image_begin(image_id, image_data, &prefetch.dev_handle,
+			      &prefetch.image_handle);
+	if (rc != 0)
+		return;
+
+	rc = io_read_start(prefetch.image_handle, image_data->image_base,
+			   image_data->image_size);
+	if (rc != 0) {
+		load_image_end(image_id, image_data, prefetch.dev_handle,
+			       prefetch.image_handle, rc, 0);
+		return;
+	}
+
+	prefetch.image_id = image_id;
+	prefetch.image_data = image_data;
+	prefetch.state = PREFETCH_PENDING;
+}
+#endif /* LOAD_IMAGE_PIPELINE */
+
+#if REUSE_PRESERVED_IMAGES
+/*******************************************************************************
+ * Authenticate the copy of the image 'image_id' left in memory by the previous
+ * boot instead of loading it again. Its size is taken from the storage, and
+ * its parent certificates must already have been authenticated. Returns
+ * -EAUTH if the copy does not match the image in storage, in which case it
+ * must be loaded as usual.
+ ******************************************************************************/
+static int auth_preserved_image(unsigned int image_id, image_info_t *image_data)
+{
+	uintptr_t dev_handle;
+	uintptr_t image_handle;
+	int rc;
+
+#if LOAD_IMAGE_PIPELINE
+	/* The storage must be idle before it is used for another image */
+	load_image_prefetch_wait();
+#endif
+
+	rc = load_image_begin(image_id, image_data, &dev_handle,
+			      &image_handle);
+	if (rc != 0)
+		return rc;
+
+	io_close(image_handle);
+	/* Ignore improbable/unrecoverable error in 'close' */
+
+	io_dev_close(dev_handle);
+	/* Ignore improbable/unrecoverable error in 'dev_close' */
+
+	rc = auth_mod_verify_img(image_id, (void *)image_data->image_base,
+				 image_data->image_size);
+	if (rc != 0)
+		return -EAUTH;
+	BOOT_PROF_CAPTURE(image_id, BOOT_PROF_AUTH_END);
+
+	flush_dcache_range(image_data->image_base, image_data->image_size);
+	BOOT_PROF_CAPTURE(image_id, BOOT_PROF_FLUSH_END);
+
+	INFO("Image id=%u reused: %p - %p\n", image_id,
+	     (void *) image_data->image_base,
+	     (void *) (image_data->image_base + image_data->image_size));
+
+	return 0;
+}
+#endif /* REUSE_PRESERVED_IMAGES */
+
+static int load_auth_image_internal(unsigned int image_id,
+				    image_info_t *image_data,
+				    int is_parent_image)
+{
+	int rc;
+
+#if TRUSTED_BOARD_BOOT
+	unsigned int parent_id;
+
+	/*
+	 * Use recursion to authenticate parent images, unless this was done
+	 * when the read-ahead of this image was started.
+	 */
+#if LOAD_IMAGE_PIPELINE
+	if (!is_image_prefetched(image_id, image_data))
+#endif
+	{
+		rc = auth_mod_get_parent_id(image_id, &parent_id);
+		if (rc == 0) {
+			rc = load_auth_image_internal(parent_id, image_data, 1);
+			if (rc != 0) {
+				return rc;
+			}
 		}
 	}
 #endif /* TRUSTED_BOARD_BOOT */
 
+#if LOAD_CERT_IN_PLACE
+	/* The certificates are only accessed while they are authenticated */
+	if (is_parent_image) {
+		rc = auth_cert_in_place(image_id, image_data);
+		if (rc != -ENODEV)
+			return rc;
+	}
+#endif
+
+#if REUSE_PRESERVED_IMAGES
+	/*
+	 * Skip the read of the image if its copy in memory is intact. The copy
+	 * is lost if a parent certificate had to be loaded into its memory, so
+	 * this relies on LOAD_CERT_IN_PLACE to be of any benefit.
+	 */
+	if (!is_parent_image &&
+#if LOAD_IMAGE_PIPELINE
+	    !is_image_prefetched(image_id, image_data) &&
+#endif
+	    (plat_is_image_preserved(image_id) != 0)) {
+		rc = auth_preserved_image(image_id, image_data);
+		if (rc == 0)
+			return 0;
+		VERBOSE("Image id=%u not preserved, loading it\n", image_id);
+	}
+#endif
+
 	/* Load the image */
 	rc = load_image(image_id, image_data);
 	if (rc != 0) {
 		return rc;
 	}
 
+#if LOAD_IMAGE_PIPELINE
+	/* Overlap the read of the next image with the authentication below */
+	if (!is_parent_image)
+		load_image_prefetch_next(image_data);
+#endif
+
 #if TRUSTED_BOARD_BOOT
 	/* Authenticate it */
 	rc = auth_mod_verify_img(image_id,
@@ -329,6 +734,7 @@ static int load_auth_image_internal(unsigned int image_id,
 				   image_data->image_size);
 		return -EAUTH;
 	}
+	BOOT_PROF_CAPTURE(image_id, BOOT_PROF_AUTH_END);
 
 	/*
 	 * File has been successfully loaded and authenticated.
@@ -339,6 +745,7 @@ static int load_auth_image_internal(unsigned int image_id,
 	if (!is_parent_image) {
 		flush_dcache_range(image_data->image_base,
 				   image_data->image_size);
+		BOOT_PROF_CAPTURE(image_id, BOOT_PROF_FLUSH_END);
 	}
 #endif /* TRUSTED_BOARD_BOOT */
 
@@ -402,6 +809,7 @@ int load_image(meminfo_t *mem_layout,
 	}
 
 	/* Attempt to access the image */
+	BOOT_PROF_CAPTURE(image_id, BOOT_PROF_OPEN);
 	io_result = io_open(dev_handle, image_spec, &image_handle);
 	if (io_result != 0) {
 		WARN("Failed to access image id=%u (%i)\n",
@@ -437,6 +845,7 @@ int load_image(meminfo_t *mem_layout,
 		WARN("Failed to load image id=%u (%i)\n", image_id, io_result);
 		goto exit;
 	}
+	BOOT_PROF_CAPTURE(image_id, BOOT_PROF_LOAD_END);
 
 	image_data->image_base = image_base;
 	image_data->image_size = image_size;
@@ -466,6 +875,7 @@ int load_image(meminfo_t *mem_layout,
 	 * authentication.
 	 */
 	flush_dcache_range(image_base, image_size);
+	BOOT_PROF_CAPTURE(image_id, BOOT_PROF_FLUSH_END);
 #endif /* TRUSTED_BOARD_BOOT */
 
 	INFO("Image id=%u loaded at address %p, size = 0x%zx\n", image_id,
@@ -525,6 +935,7 @@ static int load_auth_image_internal(meminfo_t *mem_layout,
 				   image_data->image_size);
 		return -EAUTH;
 	}
+	BOOT_PROF_CAPTURE(image_id, BOOT_PROF_AUTH_END);
 	/*
 	 * File has been successfully loaded and authenticated.
 	 * Flush the image to main memory so that it can be executed later by
@@ -534,6 +945,7 @@ static int load_auth_image_internal(meminfo_t *mem_layout,
 	if (!is_parent_image) {
 		flush_dcache_range(image_data->image_base,
 				   image_data->image_size);
+		BOOT_PROF_CAPTURE(image_id, BOOT_PROF_FLUSH_END);
 	}
 #endif /* TRUSTED_BOARD_BOOT */
 
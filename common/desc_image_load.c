@@ -34,6 +34,10 @@ void flush_bl_params_desc(void)
  * This function returns the index for given image_id, within the
  * image descriptor array provided by bl_image_info_descs_ptr, if the
  * image is found else it returns -1.
+ *
+ * The array only holds the few images loaded by BL2, so a linear search is
+ * cheaper than maintaining a table indexed by image ID, whose size would depend
+ * on the largest image ID used by the platform.
  ******************************************************************************/
 int get_bl_params_node_index(unsigned int image_id)
 {
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <fdt_index.h>
+#include <libfdt.h>
+#include <string.h>
+
+/* Maximum depth of the nodes of an indexed DT, the root node being at 0 */
+#define FDT_INDEX_MAX_DEPTH	16
+
+/*
+ * Build the index of the nodes of 'fdt' in the array 'nodes' of 'max_nodes'
+ * entries. The index is left invalid if the blob has more nodes, or nodes
+ * deeper than FDT_INDEX_MAX_DEPTH.
+ *
+ * Return: 0 = success, Otherwise = libfdt error code
+ */
+int fdt_index_init(fdt_index_t *index, const void *fdt,
+		   fdt_index_node_t *nodes, unsigned int max_nodes)
+{
+	/* Position in the index of the last node seen at each depth */
+	int last[FDT_INDEX_MAX_DEPTH + 1];
+	fdt_index_node_t *node;
+	unsigned int num_nodes = 0;
+	int offset = 0, depth = 0;
+	int rc;
+
+	index->fdt = fdt;
+	index->nodes = nodes;
+	index->max_nodes = max_nodes;
+	index->num_nodes = 0;
+
+	rc = fdt_check_header(fdt);
+	if (rc != 0)
+		return rc;
+
+	last[0] = -1;
+	do {
+		if (num_nodes == max_nodes)
+			return -FDT_ERR_NOSPACE;
+		if (depth > FDT_INDEX_MAX_DEPTH)
+			return -FDT_ERR_BADSTRUCTURE;
+
+		node = &nodes[num_nodes];
+		node->offset = offset;
+		node->first_child = -1;
+		node->next_sibling = -1;
+		node->phandle = fdt_get_phandle(fdt, offset);
+
+		if (last[depth] >= 0)
+			nodes[last[depth]].next_sibling = num_nodes;
+		else if (depth > 0)
+			nodes[last[depth - 1]].first_child = num_nodes;
+		last[depth] = num_nodes;
+		if (depth < FDT_INDEX_MAX_DEPTH)
+			last[depth + 1] = -1;
+		num_nodes++;
+
+		offset = fdt_next_node(fdt, offset, &depth);
+	} while ((offset >= 0) && (depth > 0));
+
+	if ((offset < 0) && (offset != -FDT_ERR_NOTFOUND))
+		return offset;
+
+	index->size_dt_struct = fdt_size_dt_struct(fdt);
+	index->num_nodes = num_nodes;
+	return 0;
+}
+
+/* Discard the index, after the blob has been modified */
+void fdt_index_invalidate(fdt_index_t *index)
+{
+	index->num_nodes = 0;
+}
+
+int fdt_index_valid(const fdt_index_t *index)
+{
+	return (index->num_nodes != 0) &&
+	       (fdt_size_dt_struct(index->fdt) == index->size_dt_struct);
+}
+
+/* Return the position in the index of the node at 'offset', or -1 */
+static int fdt_index_find(const fdt_index_t *index, int offset)
+{
+	int low = 0, high = (int)index->num_nodes - 1, mid;
+
+	while (low <= high) {
+		mid = (low + high) / 2;
+		if (index->nodes[mid].offset == offset)
+			return mid;
+		if (index->nodes[mid].offset < offset)
+			low = mid + 1;
+		else
+			high = mid - 1;
+	}
+	return -1;
+}
+
+/*
+ * Same matching of a node name as libfdt: the unit address of the node can be
+ * left out of the name that is looked up.
+ */
+static int fdt_index_name_eq(const fdt_index_t *index, int offset,
+			     const char *s, int len)
+{
+	const char *p = fdt_offset_ptr(index->fdt, offset + FDT_TAGSIZE,
+				       len + 1);
+
+	if ((p == NULL) || (memcmp(p, s, len) != 0))
+		return 0;
+
+	return (p[len] == '\0') ||
+	       ((memchr(s, '@', len) == NULL) && (p[len] == '@'));
+}
+
+int fdt_index_path_offset(const fdt_index_t *index, const char *path)
+{
+	const char *p = path, *q;
+	int pos = 0;
+
+	/* Aliases are resolved by libfdt */
+	if (!fdt_index_valid(index) || (*path != '/'))
+		return fdt_path_offset(index->fdt, path);
+
+	while (*p != '\0') {
+		while (*p == '/')
+			p++;
+		if (*p == '\0')
+			break;
+		q = strchr(p, '/');
+		if (q == NULL)
+			q = p + strlen(p);
+
+		for (pos = index->nodes[pos].first_child; pos >= 0;
+		     pos = index->nodes[pos].next_sibling) {
+			if (fdt_index_name_eq(index, index->nodes[pos].offset,
+					      p, q - p))
+				break;
+		}
+		if (pos < 0)
+			return -FDT_ERR_NOTFOUND;
+		p = q;
+	}
+
+	return index->nodes[pos].offset;
+}
+
+int fdt_index_node_offset_by_compatible(const fdt_index_t *index,
+					int startoffset,
+					const char *compatible)
+{
+	unsigned int i = 0;
+	int pos;
+
+	if (!fdt_index_valid(index))
+		return fdt_node_offset_by_compatible(index->fdt, startoffset,
+						     compatible);
+
+	if (startoffset >= 0) {
+		pos = fdt_index_find(index, startoffset);
+		if (pos < 0)
+			return -FDT_ERR_BADOFFSET;
+		i = pos + 1;
+	}
+
+	for (; i < index->num_nodes; i++) {
+		if (fdt_node_check_compatible(index->fdt,
+					      index->nodes[i].offset,
+					      compatible) == 0)
+			return index->nodes[i].offset;
+	}
+	return -FDT_ERR_NOTFOUND;
+}
+
+int fdt_index_node_offset_by_phandle(const fdt_index_t *index,
+				     uint32_t phandle)
+{
+	unsigned int i;
+
+	if (!fdt_index_valid(index))
+		return fdt_node_offset_by_phandle(index->fdt, phandle);
+
+	if ((phandle == 0) || (phandle == (uint32_t)-1))
+		return -FDT_ERR_BADPHANDLE;
+
+	for (i = 0; i < index->num_nodes; i++) {
+		if (index->nodes[i].phandle == phandle)
+			return index->nodes[i].offset;
+	}
+	return -FDT_ERR_NOTFOUND;
+}
+
+int fdt_index_first_subnode(const fdt_index_t *index, int offset)
+{
+	int pos;
+
+	if (!fdt_index_valid(index))
+		return fdt_first_subnode(index->fdt, offset);
+
+	pos = fdt_index_find(index, offset);
+	if (pos < 0)
+		return -FDT_ERR_BADOFFSET;
+	pos = index->nodes[pos].first_child;
+
+	return (pos < 0) ? -FDT_ERR_NOTFOUND : index->nodes[pos].offset;
+}
+
+int fdt_index_next_subnode(const fdt_index_t *index, int offset)
+{
+	int pos;
+
+	if (!fdt_index_valid(index))
+		return fdt_next_subnode(index->fdt, offset);
+
+	pos = fdt_index_find(index, offset);
+	if (pos < 0)
+		return -FDT_ERR_BADOFFSET;
+	pos = index->nodes[pos].next_sibling;
+
+	return (pos < 0) ? -FDT_ERR_NOTFOUND : index->nodes[pos].offset;
+}
@@ -4,11 +4,15 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <arch_helpers.h>
 #include <assert.h>
 #include <debug.h>
 #include <errno.h>
+#include <platform.h>
+#include <platform_def.h>
 #include <runtime_svc.h>
 #include <string.h>
+#include <trace_event.h>
 
 /*******************************************************************************
  * The 'rt_svc_descs' array holds the runtime service descriptors exported by
@@ -18,6 +22,13 @@
  * type[31] bit in the function id are combined to get an index into the
  * 'rt_svc_descs_indices' array. This gives the index of the descriptor in the
  * 'rt_svc_descs' array which contains the SMC handler.
+ *
+ * The indices are filled at boot rather than generated at build time, so that
+ * a service is added by linking in its descriptor alone. This costs a single
+ * pass over the few descriptors at cold boot. On each SMC, the dispatch costs a
+ * byte load, a load of the handler and a call to a target that does not change
+ * for a given OEN, which branch predictors handle well. The branch predictor
+ * hardening is applied on entry to EL3, not on each indirect branch.
  ******************************************************************************/
 #define RT_SVC_DESCS_START	((uintptr_t) (&__RT_SVC_DESCS_START__))
 #define RT_SVC_DESCS_END	((uintptr_t) (&__RT_SVC_DESCS_END__))
@@ -27,13 +38,79 @@ static rt_svc_desc_t *rt_svc_descs;
 #define RT_SVC_DECS_NUM		((RT_SVC_DESCS_END - RT_SVC_DESCS_START)\
 					/ sizeof(rt_svc_desc_t))
 
+#if ENABLE_SMC_LATENCY_STATS
+/*******************************************************************************
+ * SMC latency histograms, one per CPU and per owning entity range defined by
+ * the SMC Calling Convention. Each CPU only updates its own histograms so no
+ * locking is needed. They are read without synchronisation, which can only
+ * make a count slightly out of date.
+ ******************************************************************************/
+#define SMC_STATS_OEN_TAP	5
+#define SMC_STATS_OEN_TOS	6
+#define SMC_STATS_OEN_OTHER	7
+#define SMC_STATS_OEN_RANGES	8
+
+static unsigned int smc_stats[PLATFORM_CORE_COUNT][SMC_STATS_OEN_RANGES]
+			     [SMC_STATS_BUCKETS]
+	__aligned(CACHE_WRITEBACK_GRANULE);
+
+static unsigned int smc_stats_oen_range(unsigned int oen)
+{
+	if (oen <= OEN_STD_END)
+		return oen;
+	if ((oen >= OEN_TAP_START) && (oen <= OEN_TAP_END))
+		return SMC_STATS_OEN_TAP;
+	if ((oen >= OEN_TOS_START) && (oen <= OEN_TOS_END))
+		return SMC_STATS_OEN_TOS;
+	return SMC_STATS_OEN_OTHER;
+}
+
+/* Return floor(log2(ticks)), clamped to the number of buckets */
+static unsigned int smc_stats_bucket(unsigned long long ticks)
+{
+	unsigned int hi = (unsigned int)(ticks >> 32);
+	unsigned int lo = (unsigned int)ticks;
+
+	if (hi != 0)
+		return SMC_STATS_BUCKETS - 1;
+	if (lo == 0)
+		return 0;
+	return 31 - __builtin_clz(lo);
+}
+
+/*******************************************************************************
+ * Account for an SMC that took 'ticks' system counter ticks to handle on the
+ * calling CPU.
+ ******************************************************************************/
+void smc_stats_record(uint32_t smc_fid, unsigned long long ticks)
+{
+	unsigned int oen = (smc_fid >> FUNCID_OEN_SHIFT) & FUNCID_OEN_MASK;
+
+	smc_stats[plat_my_core_pos()][smc_stats_oen_range(oen)]
+		 [smc_stats_bucket(ticks)]++;
+}
+
+/*******************************************************************************
+ * Return the number of SMCs of the given owning entity number handled by a CPU
+ * that fall in the given latency bucket.
+ ******************************************************************************/
+unsigned int smc_stats_get(unsigned int cpu_idx, unsigned int oen,
+			   unsigned int bucket)
+{
+	assert((cpu_idx < PLATFORM_CORE_COUNT) && (oen < OEN_LIMIT) &&
+	       (bucket < SMC_STATS_BUCKETS));
+
+	return smc_stats[cpu_idx][smc_stats_oen_range(oen)][bucket];
+}
+#endif /* ENABLE_SMC_LATENCY_STATS */
+
 /*******************************************************************************
  * Function to invoke the registered `handle` corresponding to the smc_fid.
  ******************************************************************************/
-uintptr_t handle_runtime_svc(uint32_t smc_fid,
-			     void *cookie,
-			     void *handle,
-			     unsigned int flags)
+uintptr_t __hot handle_runtime_svc(uint32_t smc_fid,
+				   void *cookie,
+				   void *handle,
+				   unsigned int flags)
 {
 	u_register_t x1, x2, x3, x4;
 	int index, idx;
@@ -50,15 +127,26 @@ uintptr_t handle_runtime_svc(uint32_t smc_fid,
 	rt_svc_descs = (rt_svc_desc_t *) RT_SVC_DESCS_START;
 
 	get_smc_params_from_ctx(handle, x1, x2, x3, x4);
+	TRACE_EVENT(TRACE_EV_SMC, smc_fid, x1, x2, x3);
+
+#if ENABLE_SMC_LATENCY_STATS
+	unsigned long long start = read_cntpct_el0();
+	uintptr_t ret;
 
+	ret = rt_svc_descs[index].handle(smc_fid, x1, x2, x3, x4, cookie,
+						handle, flags);
+	smc_stats_record(smc_fid, read_cntpct_el0() - start);
+	return ret;
+#else
 	return rt_svc_descs[index].handle(smc_fid, x1, x2, x3, x4, cookie,
 						handle, flags);
+#endif
 }
 
 /*******************************************************************************
  * Simple routine to sanity check a runtime service descriptor before using it
  ******************************************************************************/
-static int32_t validate_rt_svc_desc(const rt_svc_desc_t *desc)
+static int32_t __init validate_rt_svc_desc(const rt_svc_desc_t *desc)
 {
 	if (desc == NULL)
 		return -EINVAL;
@@ -87,7 +175,7 @@ static int32_t validate_rt_svc_desc(const rt_svc_desc_t *desc)
  * The unique oen is used as an index into the 'rt_svc_descs_indices' array.
  * The index of the runtime service descriptor is stored at this index.
  ******************************************************************************/
-void runtime_svc_init(void)
+void __init runtime_svc_init(void)
 {
 	int rc = 0, index, start_idx, end_idx;
 
@@ -5,12 +5,21 @@
  */
 
 #include <arch.h>
+#include <arch_helpers.h>
 #include <assert.h>
 #include <cci.h>
 #include <debug.h>
 #include <mmio.h>
+#include <pmf.h>
+#include <runtime_instr.h>
 #include <stdint.h>
 
+/*
+ * Bound of the wait for a change of the snoop control registers. It divides a
+ * second, so the timeout is computed with a 32-bit division by a constant.
+ */
+#define CCI_STATUS_TIMEOUT_US		10000
+
 static uintptr_t g_cci_base;
 static unsigned int g_max_master_id;
 static const int *g_cci_slave_if_map;
@@ -69,49 +78,82 @@ void cci_init(uintptr_t cci_base,
 	g_cci_slave_if_map = map;
 }
 
-void cci_enable_snoop_dvm_reqs(unsigned int master_id)
+/*
+ * Write the snoop control register of the slave interface of each master in
+ * 'master_mask' with 'val', then wait once for the CCI to apply all the
+ * changes. The wait is bounded so that a CCI that never settles is reported
+ * instead of hanging the CPU powering up or down its cluster.
+ */
+static void cci_set_snoop_ctrl(unsigned int master_mask, uint32_t val)
 {
+	unsigned int master_id;
+	uint64_t timeout;
 	int slave_if_id;
 
 	assert(g_cci_base);
-	assert(master_id <= g_max_master_id);
+	assert((master_mask != 0) &&
+	       ((master_mask >> g_max_master_id) <= 1));
 
-	slave_if_id = g_cci_slave_if_map[master_id];
-	assert((slave_if_id < CCI_SLAVE_INTERFACE_COUNT) && (slave_if_id >= 0));
+#if ENABLE_RUNTIME_INSTRUMENTATION && defined(IMAGE_BL31)
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc, RT_INSTR_ENTER_CCI_SNOOP,
+			      PMF_NO_CACHE_MAINT);
+#endif
 
-	/*
-	 * Enable Snoops and DVM messages, no need for Read/Modify/Write as
-	 * rest of bits are write ignore
-	 */
-	mmio_write_32(g_cci_base +
-		      SLAVE_IFACE_OFFSET(slave_if_id) +
-		      SNOOP_CTRL_REG, DVM_EN_BIT | SNOOP_EN_BIT);
+	for (master_id = 0; master_id <= g_max_master_id; master_id++) {
+		if (!(master_mask & (1U << master_id)))
+			continue;
+
+		slave_if_id = g_cci_slave_if_map[master_id];
+		assert((slave_if_id < CCI_SLAVE_INTERFACE_COUNT) &&
+		       (slave_if_id >= 0));
+
+		/*
+		 * No need for Read/Modify/Write as rest of bits are write
+		 * ignore
+		 */
+		mmio_write_32(g_cci_base +
+			      SLAVE_IFACE_OFFSET(slave_if_id) +
+			      SNOOP_CTRL_REG, val);
+	}
 
 	/* Wait for the dust to settle down */
-	while (mmio_read_32(g_cci_base + STATUS_REG) & CHANGE_PENDING_BIT)
-		;
+	timeout = read_cntpct_el0() +
+		  (read_cntfrq_el0() / (1000000 / CCI_STATUS_TIMEOUT_US));
+	while (mmio_read_32(g_cci_base + STATUS_REG) & CHANGE_PENDING_BIT) {
+		if (read_cntpct_el0() > timeout) {
+			ERROR("CCI: Snoop control change still pending\n");
+			panic();
+		}
+	}
+
+#if ENABLE_RUNTIME_INSTRUMENTATION && defined(IMAGE_BL31)
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc, RT_INSTR_EXIT_CCI_SNOOP,
+			      PMF_NO_CACHE_MAINT);
+#endif
 }
 
-void cci_disable_snoop_dvm_reqs(unsigned int master_id)
+/* Enable Snoops and DVM messages for all the masters in 'master_mask' */
+void cci_enable_snoop_dvm_reqs_mask(unsigned int master_mask)
 {
-	int slave_if_id;
+	cci_set_snoop_ctrl(master_mask, DVM_EN_BIT | SNOOP_EN_BIT);
+}
 
-	assert(g_cci_base);
+/* Disable Snoops and DVM messages for all the masters in 'master_mask' */
+void cci_disable_snoop_dvm_reqs_mask(unsigned int master_mask)
+{
+	cci_set_snoop_ctrl(master_mask, ~(DVM_EN_BIT | SNOOP_EN_BIT));
+}
+
+void cci_enable_snoop_dvm_reqs(unsigned int master_id)
+{
 	assert(master_id <= g_max_master_id);
 
-	slave_if_id = g_cci_slave_if_map[master_id];
-	assert((slave_if_id < CCI_SLAVE_INTERFACE_COUNT) && (slave_if_id >= 0));
+	cci_enable_snoop_dvm_reqs_mask(1U << master_id);
+}
 
-	/*
-	 * Disable Snoops and DVM messages, no need for Read/Modify/Write as
-	 * rest of bits are write ignore.
-	 */
-	mmio_write_32(g_cci_base +
-		      SLAVE_IFACE_OFFSET(slave_if_id) +
-		      SNOOP_CTRL_REG, ~(DVM_EN_BIT | SNOOP_EN_BIT));
+void cci_disable_snoop_dvm_reqs(unsigned int master_id)
+{
+	assert(master_id <= g_max_master_id);
 
-	/* Wait for the dust to settle down */
-	while (mmio_read_32(g_cci_base + STATUS_REG) & CHANGE_PENDING_BIT)
-		;
+	cci_disable_snoop_dvm_reqs_mask(1U << master_id);
 }
-
@@ -264,6 +264,11 @@ static void ccn_snoop_dvm_do_op(unsigned long long rn_id_map,
 #if defined(IMAGE_BL31) || (defined(AARCH32) && defined(IMAGE_BL32))
 	bakery_lock_get(&ccn_lock);
 #endif
+	/*
+	 * Request the operation from all the nodes before polling any of them,
+	 * so that the nodes carry it out in parallel and the polls after the
+	 * first one usually find it already complete.
+	 */
 	start_region_id = region_id;
 	FOR_EACH_PRESENT_REGION_ID(start_region_id, hn_id_map) {
 		ccn_reg_write(ccn_plat_desc->periphbase,
@@ -299,6 +304,9 @@ static void ccn_snoop_dvm_do_op(unsigned long long rn_id_map,
  * the snoop and dvm domain, the bit position corresponding to the cluster ID
  * should be set in the 'master_iface_map' i.e. to remove both clusters the
  * bitmap would equal 0x11.
+ * Several clusters powering up or down together should be passed in a single
+ * call, so that each HN-F and the MN are only programmed and polled once for
+ * all of them.
  ******************************************************************************/
 void ccn_enter_snoop_dvm_domain(unsigned long long master_iface_map)
 {
@@ -105,7 +105,7 @@ void gicv2_distif_init(void)
 /*******************************************************************************
  * Initialize the ARM GICv2 driver with the provided platform inputs
  ******************************************************************************/
-void gicv2_driver_init(const gicv2_driver_data_t *plat_driver_data)
+void __init gicv2_driver_init(const gicv2_driver_data_t *plat_driver_data)
 {
 	unsigned int gic_version;
 	assert(plat_driver_data);
@@ -240,3 +240,34 @@ unsigned int gicv2_get_interrupt_group(unsigned int id)
 
 	return gicd_get_igroupr(driver_data->gicd_base, id);
 }
+
+/*******************************************************************************
+ * This function raises the Group 1 SGI 'sgi_num' on the calling CPU. As the
+ * write to GICD_SGIR is secure, NSATT selects the Non-secure SGI. The memory
+ * updates of the calling CPU are made visible to its handler first.
+ ******************************************************************************/
+void gicv2_raise_ns_sgi(unsigned int sgi_num)
+{
+	assert(driver_data);
+	assert(driver_data->gicd_base);
+	assert(sgi_num < MIN_PPI_ID);
+
+	dsbishst();
+	gicd_write_sgir(driver_data->gicd_base,
+			(SGIR_TGT_FILTER_SELF << SGIR_TGT_FILTER_SHIFT) |
+			SGIR_NSATT_BIT | (sgi_num & SGIR_INTID_MASK));
+}
+
+/*******************************************************************************
+ * This function sets the CPU interfaces targeted by the SPI 'id' to the mask
+ * 'target'. With several targets, the first CPU to acknowledge the interrupt
+ * handles it and the others read a spurious interrupt.
+ ******************************************************************************/
+void gicv2_set_spi_targets(unsigned int id, unsigned int target)
+{
+	assert(driver_data);
+	assert(driver_data->gicd_base);
+	assert((id >= MIN_SPI_ID) && (id <= MAX_SPI_ID));
+
+	gicd_set_itargetsr(driver_data->gicd_base, id, target);
+}
@@ -22,6 +22,7 @@ void gicv2_secure_ppi_sgi_setup(uintptr_t gicd_base,
 					unsigned int num_ints,
 					const unsigned int *sec_intr_list);
 unsigned int gicv2_get_cpuif_id(uintptr_t base);
+void gicd_set_itargetsr(uintptr_t base, unsigned int id, unsigned int target);
 
 /*******************************************************************************
  * GIC Distributor interface accessors for reading entire registers
@@ -31,6 +32,14 @@ static inline unsigned int gicd_read_pidr2(uintptr_t base)
 	return mmio_read_32(base + GICD_PIDR2_GICV2);
 }
 
+/*******************************************************************************
+ * GIC Distributor interface accessors for writing entire registers
+ ******************************************************************************/
+static inline void gicd_write_sgir(uintptr_t base, unsigned int val)
+{
+	mmio_write_32(base + GICD_SGIR, val);
+}
+
 /*******************************************************************************
  * GIC CPU interface accessors for reading entire registers
  ******************************************************************************/
@@ -9,6 +9,7 @@
 #include <assert.h>
 #include <debug.h>
 #include <gic_common.h>
+#include <utils.h>
 #include "../common/gic_common_private.h"
 #include "gicv3_private.h"
 
@@ -255,6 +256,29 @@ void gicv3_rdistif_base_addrs_probe(uintptr_t *rdistif_base_addrs,
 	} while (!(typer_val & TYPER_LAST_BIT));
 }
 
+/*******************************************************************************
+ * This function walks the Redistributor frames starting at `gicr_base` and
+ * returns the base address of the frame of the CPU with the affinity `mpidr`,
+ * or 0 if there is no such frame.
+ ******************************************************************************/
+uintptr_t gicv3_rdistif_base_addr_find(uintptr_t gicr_base,
+					u_register_t mpidr)
+{
+	unsigned long long typer_val;
+	uintptr_t rdistif_base = gicr_base;
+
+	mpidr &= MPIDR_AFFINITY_MASK;
+
+	do {
+		typer_val = gicr_read_typer(rdistif_base);
+		if (mpidr_from_gicr_typer(typer_val) == mpidr)
+			return rdistif_base;
+		rdistif_base += (1 << GICR_PCPUBASE_SHIFT);
+	} while (!(typer_val & TYPER_LAST_BIT));
+
+	return 0;
+}
+
 /*******************************************************************************
  * Helper function to configure the default attributes of SPIs.
  ******************************************************************************/
@@ -289,49 +313,92 @@ void gicv3_spis_configure_defaults(uintptr_t gicd_base)
 
 /*******************************************************************************
  * Helper function to configure secure G0 and G1S SPIs.
+ *
+ * The interrupts of the list are first gathered in a bitmap with one word per
+ * 32 interrupt IDs, so that each IGROUPR, IGRPMODR and ISENABLER register is
+ * accessed once, and each IPRIORITYR register once as a whole when its four
+ * interrupts are all in the list, however the list is ordered.
  ******************************************************************************/
 void gicv3_secure_spis_configure(uintptr_t gicd_base,
 				     unsigned int num_ints,
 				     const unsigned int *sec_intr_list,
 				     unsigned int int_grp)
 {
-	unsigned int index, irq_num;
+	unsigned int spi_map[(MAX_SPI_ID >> IGROUPR_SHIFT) + 1] = { 0 };
+	unsigned int index, irq_num, num_regs, mask, reg_val;
+	unsigned int bit_num, pri_mask, n;
 	unsigned long long gic_affinity_val;
 
 	assert((int_grp == INTR_GROUP1S) || (int_grp == INTR_GROUP0));
 	/* If `num_ints` is not 0, ensure that `sec_intr_list` is not NULL */
 	assert(num_ints ? (uintptr_t)sec_intr_list : 1);
 
+	/* Target SPIs to the primary CPU */
+	gic_affinity_val = gicd_irouter_val_from_mpidr(read_mpidr(), 0);
+
 	for (index = 0; index < num_ints; index++) {
 		irq_num = sec_intr_list[index];
 		if (irq_num >= MIN_SPI_ID) {
+			assert(irq_num <= MAX_SPI_ID);
+			spi_map[irq_num >> IGROUPR_SHIFT] |=
+				1 << (irq_num & ((1 << IGROUPR_SHIFT) - 1));
 
-			/* Configure this interrupt as a secure interrupt */
-			gicd_clr_igroupr(gicd_base, irq_num);
-
-			/* Configure this interrupt as G0 or a G1S interrupt */
-			if (int_grp == INTR_GROUP1S)
-				gicd_set_igrpmodr(gicd_base, irq_num);
-			else
-				gicd_clr_igrpmodr(gicd_base, irq_num);
-
-			/* Set the priority of this interrupt */
-			gicd_set_ipriorityr(gicd_base,
-					      irq_num,
-					      GIC_HIGHEST_SEC_PRIORITY);
-
-			/* Target SPIs to the primary CPU */
-			gic_affinity_val =
-				gicd_irouter_val_from_mpidr(read_mpidr(), 0);
+			/* The routing is not shared with other interrupts */
 			gicd_write_irouter(gicd_base,
 					   irq_num,
 					   gic_affinity_val);
-
-			/* Enable this interrupt */
-			gicd_set_isenabler(gicd_base, irq_num);
 		}
 	}
 
+	/* Number of registers of 32 interrupts implemented by the GIC */
+	num_regs = (gicd_read_typer(gicd_base) & TYPER_IT_LINES_NO_MASK) + 1;
+	if (num_regs > ARRAY_SIZE(spi_map))
+		num_regs = ARRAY_SIZE(spi_map);
+
+	for (index = MIN_SPI_ID >> IGROUPR_SHIFT; index < num_regs; index++) {
+		mask = spi_map[index];
+		if (mask == 0)
+			continue;
+
+		irq_num = index << IGROUPR_SHIFT;
+
+		/* Configure these interrupts as secure interrupts */
+		reg_val = gicd_read_igroupr(gicd_base, irq_num);
+		gicd_write_igroupr(gicd_base, irq_num, reg_val & ~mask);
+
+		/* Configure these interrupts as G0 or G1S interrupts */
+		reg_val = gicd_read_igrpmodr(gicd_base, irq_num);
+		if (int_grp == INTR_GROUP1S)
+			reg_val |= mask;
+		else
+			reg_val &= ~mask;
+		gicd_write_igrpmodr(gicd_base, irq_num, reg_val);
+
+		/*
+		 * Set the priority of these interrupts, with a single write
+		 * for the four interrupts of an IPRIORITYR register when they
+		 * are all secure.
+		 */
+		for (bit_num = 0; bit_num < 32; bit_num += 4) {
+			pri_mask = (mask >> bit_num) & 0xf;
+			if (pri_mask == 0xf) {
+				gicd_write_ipriorityr(gicd_base,
+						      irq_num + bit_num,
+						      GICD_IPRIORITYR_SEC_VAL);
+				continue;
+			}
+
+			for (n = 0; pri_mask != 0; n++, pri_mask >>= 1) {
+				if (pri_mask & 1)
+					gicd_set_ipriorityr(gicd_base,
+						irq_num + bit_num + n,
+						GIC_HIGHEST_SEC_PRIORITY);
+			}
+		}
+
+		/* Enable these interrupts */
+		gicd_write_isenabler(gicd_base, irq_num, mask);
+	}
 }
 
 /*******************************************************************************
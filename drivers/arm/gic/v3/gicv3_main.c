@@ -9,11 +9,63 @@
 #include <assert.h>
 #include <debug.h>
 #include <gicv3.h>
+#include <utils.h>
 #include "gicv3_private.h"
 
 const gicv3_driver_data_t *gicv3_driver_data;
 static unsigned int gicv2_compat;
 
+#if GICV3_INTR_TYPE_CACHE
+/*
+ * Bitmaps of the Secure (G0 or G1S) interrupts and of the G1S interrupts,
+ * indexed by INTID. They are built from the interrupt arrays of the platform,
+ * which are the same for the SGIs and PPIs of all the CPUs, and let
+ * gicv3_get_interrupt_type() avoid reading the GIC.
+ */
+static unsigned int gicv3_sec_intr_map[(MAX_SPI_ID >> IGROUPR_SHIFT) + 1];
+static unsigned int gicv3_g1s_intr_map[(MAX_SPI_ID >> IGROUPR_SHIFT) + 1];
+
+static void gicv3_intr_type_cache_add(unsigned int num_ints,
+				      const unsigned int *sec_intr_list,
+				      unsigned int int_grp)
+{
+	unsigned int index, irq_num, bit;
+
+	for (index = 0; index < num_ints; index++) {
+		irq_num = sec_intr_list[index];
+		assert(irq_num <= MAX_SPI_ID);
+
+		bit = 1 << (irq_num & ((1 << IGROUPR_SHIFT) - 1));
+		gicv3_sec_intr_map[irq_num >> IGROUPR_SHIFT] |= bit;
+		if (int_grp == INTR_GROUP1S)
+			gicv3_g1s_intr_map[irq_num >> IGROUPR_SHIFT] |= bit;
+		else
+			gicv3_g1s_intr_map[irq_num >> IGROUPR_SHIFT] &= ~bit;
+	}
+}
+
+/*
+ * Build the bitmaps, adding the G0 interrupts last as they are configured last
+ * by the driver.
+ */
+static void gicv3_intr_type_cache_init(void)
+{
+	unsigned int index;
+
+	for (index = 0; index < ARRAY_SIZE(gicv3_sec_intr_map); index++) {
+		gicv3_sec_intr_map[index] = 0;
+		gicv3_g1s_intr_map[index] = 0;
+	}
+
+	gicv3_intr_type_cache_add(gicv3_driver_data->g1s_interrupt_num,
+				  gicv3_driver_data->g1s_interrupt_array,
+				  INTR_GROUP1S);
+	gicv3_intr_type_cache_add(gicv3_driver_data->g0_interrupt_num,
+				  gicv3_driver_data->g0_interrupt_array,
+				  INTR_GROUP0);
+}
+#endif /* GICV3_INTR_TYPE_CACHE */
+
 /*
  * Redistributor power operations are weakly bound so that they can be
  * overridden
@@ -25,7 +77,7 @@ static unsigned int gicv2_compat;
  * This function initialises the ARM GICv3 driver in EL3 with provided platform
  * inputs.
  ******************************************************************************/
-void gicv3_driver_init(const gicv3_driver_data_t *plat_driver_data)
+void __init gicv3_driver_init(const gicv3_driver_data_t *plat_driver_data)
 {
 	unsigned int gic_version;
 
@@ -81,12 +133,15 @@ void gicv3_driver_init(const gicv3_driver_data_t *plat_driver_data)
 	 * Find the base address of each implemented Redistributor interface.
 	 * The number of interfaces should be equal to the number of CPUs in the
 	 * system. The memory for saving these addresses has to be allocated by
-	 * the platform port
+	 * the platform port. If the platform has already filled it, each entry
+	 * is only checked when the corresponding CPU initialises its interface.
 	 */
-	gicv3_rdistif_base_addrs_probe(plat_driver_data->rdistif_base_addrs,
-					   plat_driver_data->rdistif_num,
-					   plat_driver_data->gicr_base,
-					   plat_driver_data->mpidr_to_core_pos);
+	if (!plat_driver_data->rdistif_base_addrs_provided)
+		gicv3_rdistif_base_addrs_probe(
+					plat_driver_data->rdistif_base_addrs,
+					plat_driver_data->rdistif_num,
+					plat_driver_data->gicr_base,
+					plat_driver_data->mpidr_to_core_pos);
 
 	gicv3_driver_data = plat_driver_data;
 
@@ -162,6 +217,35 @@ void gicv3_distif_init(void)
 
 	/* Enable the secure SPIs now that they have been configured */
 	gicd_set_ctlr(gicv3_driver_data->gicd_base, bitmap, RWP_TRUE);
+
+#if GICV3_INTR_TYPE_CACHE
+	gicv3_intr_type_cache_init();
+#endif
+}
+
+/*******************************************************************************
+ * This function checks that the Redistributor base address provided by the
+ * platform for the calling CPU is the one of its frame. If it is not, or if the
+ * platform left it to 0, the frame is looked for and the address is updated.
+ ******************************************************************************/
+static void gicv3_rdistif_base_addr_validate(unsigned int proc_num)
+{
+	uintptr_t *rdistif_base_addrs = gicv3_driver_data->rdistif_base_addrs;
+	uintptr_t rdistif_base = rdistif_base_addrs[proc_num];
+	u_register_t mpidr = read_mpidr() & MPIDR_AFFINITY_MASK;
+
+	if (rdistif_base &&
+	    (mpidr_from_gicr_typer(gicr_read_typer(rdistif_base)) == mpidr))
+		return;
+
+	if (rdistif_base)
+		WARN("GICv3: Wrong Redistributor base address for CPU %u\n",
+		     proc_num);
+
+	rdistif_base = gicv3_rdistif_base_addr_find(
+					gicv3_driver_data->gicr_base, mpidr);
+	assert(rdistif_base);
+	rdistif_base_addrs[proc_num] = rdistif_base;
 }
 
 /*******************************************************************************
@@ -183,6 +267,9 @@ void gicv3_rdistif_init(unsigned int proc_num)
 
 	assert(IS_IN_EL3());
 
+	if (gicv3_driver_data->rdistif_base_addrs_provided)
+		gicv3_rdistif_base_addr_validate(proc_num);
+
 	/* Power on redistributor */
 	gicv3_rdistif_on(proc_num);
 
@@ -368,7 +455,11 @@ unsigned int gicv3_get_interrupt_type(unsigned int id,
 					  unsigned int proc_num)
 {
 	unsigned int igroup, grpmodr;
+#if GICV3_INTR_TYPE_CACHE
+	unsigned int bit;
+#else
 	uintptr_t gicr_base;
+#endif
 
 	assert(IS_IN_EL3());
 	assert(gicv3_driver_data);
@@ -381,6 +472,12 @@ unsigned int gicv3_get_interrupt_type(unsigned int id,
 	if (id >= MIN_LPI_ID)
 		return INTR_GROUP1NS;
 
+#if GICV3_INTR_TYPE_CACHE
+	/* The group of the interrupt is the same as in the GIC registers */
+	bit = 1 << (id & ((1 << IGROUPR_SHIFT) - 1));
+	igroup = !(gicv3_sec_intr_map[id >> IGROUPR_SHIFT] & bit);
+	grpmodr = gicv3_g1s_intr_map[id >> IGROUPR_SHIFT] & bit;
+#else
 	if (id < MIN_SPI_ID) {
 		assert(gicv3_driver_data->rdistif_base_addrs);
 		gicr_base = gicv3_driver_data->rdistif_base_addrs[proc_num];
@@ -391,6 +488,7 @@ unsigned int gicv3_get_interrupt_type(unsigned int id,
 		igroup = gicd_get_igroupr(gicv3_driver_data->gicd_base, id);
 		grpmodr = gicd_get_igrpmodr(gicv3_driver_data->gicd_base, id);
 	}
+#endif
 
 	/*
 	 * If the IGROUP bit is set, then it is a Group 1 Non secure
@@ -406,3 +504,332 @@ unsigned int gicv3_get_interrupt_type(unsigned int id,
 	/* Else it is a Group 0 Secure interrupt */
 	return INTR_GROUP0;
 }
+
+/*******************************************************************************
+ * This function returns the running priority of the GIC CPU interface of the
+ * calling CPU, i.e. the priority of its highest priority active interrupt, or
+ * the idle priority if there is none.
+ ******************************************************************************/
+unsigned int gicv3_get_running_priority(void)
+{
+	return read_icc_rpr_el1();
+}
+
+/*******************************************************************************
+ * This function sets the priority mask of the GIC CPU interface of the calling
+ * CPU to 'mask' and returns its previous value. Only the interrupts with a
+ * higher priority (lower value) than the mask are signalled to the CPU.
+ ******************************************************************************/
+unsigned int gicv3_set_pmr(unsigned int mask)
+{
+	unsigned int old_mask;
+
+	old_mask = read_icc_pmr_el1();
+
+	/*
+	 * Make the memory updates visible before an interrupt that the new mask
+	 * lets through can be taken. The writes to the PMR are self
+	 * synchronising.
+	 */
+	dsbishst();
+	write_icc_pmr_el1(mask & GIC_PRI_MASK);
+
+	return old_mask;
+}
+
+/*******************************************************************************
+ * This function sets the priority of the interrupt 'id'. The SGIs and PPIs are
+ * those of the CPU 'proc_num'.
+ ******************************************************************************/
+void gicv3_set_interrupt_priority(unsigned int id, unsigned int proc_num,
+				  unsigned int priority)
+{
+	uintptr_t gicr_base;
+
+	assert(gicv3_driver_data);
+	assert(proc_num < gicv3_driver_data->rdistif_num);
+	assert(id <= MAX_SPI_ID);
+
+	if (id < MIN_SPI_ID) {
+		assert(gicv3_driver_data->rdistif_base_addrs);
+		gicr_base = gicv3_driver_data->rdistif_base_addrs[proc_num];
+		gicr_set_ipriorityr(gicr_base, id, priority);
+	} else {
+		assert(gicv3_driver_data->gicd_base);
+		gicd_set_ipriorityr(gicv3_driver_data->gicd_base, id, priority);
+	}
+}
+
+/*******************************************************************************
+ * Return the value of the ICC_SGI*R registers raising the SGI 'sgi_num' on the
+ * CPUs whose MPIDR is 'target_group' with Aff0 set to the position of each bit
+ * set in 'aff0_mask'.
+ ******************************************************************************/
+static uint64_t gicv3_sgir_value(unsigned int sgi_num,
+				 u_register_t target_group,
+				 unsigned int aff0_mask)
+{
+	uint64_t sgir;
+
+	assert(sgi_num < MIN_PPI_ID);
+	assert(!(aff0_mask & ~SGIR_TGT_MASK));
+
+	sgir = ((uint64_t)MPIDR_AFFLVL1_VAL(target_group) << SGIR_AFF1_SHIFT) |
+	       ((uint64_t)MPIDR_AFFLVL2_VAL(target_group) << SGIR_AFF2_SHIFT) |
+	       ((uint64_t)(sgi_num & SGIR_INTID_MASK) << SGIR_INTID_SHIFT) |
+	       (aff0_mask & SGIR_TGT_MASK);
+#ifndef AARCH32
+	sgir |= (uint64_t)MPIDR_AFFLVL3_VAL(target_group) << SGIR_AFF3_SHIFT;
+#endif
+
+	return sgir;
+}
+
+/*******************************************************************************
+ * This function raises the Group 0 SGI 'sgi_num' on the CPUs whose MPIDR is
+ * 'target_group' with Aff0 set to the position of each bit set in 'aff0_mask'.
+ * The memory updates of the calling CPU are made visible to the targets first.
+ ******************************************************************************/
+void gicv3_raise_secure_g0_sgi(unsigned int sgi_num, u_register_t target_group,
+			       unsigned int aff0_mask)
+{
+	uint64_t sgir = gicv3_sgir_value(sgi_num, target_group, aff0_mask);
+
+	dsbishst();
+#ifdef AARCH32
+	write64_icc_sgi0r_el1(sgir);
+#else
+	write_icc_sgi0r_el1(sgir);
+#endif
+	isb();
+}
+
+/*******************************************************************************
+ * This function raises the Non-secure Group 1 SGI 'sgi_num' on the same CPUs
+ * as gicv3_raise_secure_g0_sgi(). ICC_SGI1R_EL1 raises the Group 1 SGIs of the
+ * Security state given by SCR_EL3.NS, and ICC_ASGI1R_EL1 those of the other
+ * Security state.
+ ******************************************************************************/
+void gicv3_raise_ns_g1_sgi(unsigned int sgi_num, u_register_t target_group,
+			   unsigned int aff0_mask)
+{
+	uint64_t sgir = gicv3_sgir_value(sgi_num, target_group, aff0_mask);
+	unsigned int ns = read_scr() & SCR_NS_BIT;
+
+	dsbishst();
+#ifdef AARCH32
+	if (ns)
+		write64_icc_sgi1r_el1(sgir);
+	else
+		write64_icc_asgi1r_el1(sgir);
+#else
+	if (ns)
+		write_icc_sgi1r_el1(sgir);
+	else
+		write_icc_asgi1r_el1(sgir);
+#endif
+	isb();
+}
+
+/*******************************************************************************
+ * Helpers to save and restore the 'reg' field of all the SPIs below 'num_ints'
+ * with one access per register, from and to the 'gicd_reg' array of the
+ * Distributor context.
+ ******************************************************************************/
+#define SAVE_GICD_REGS(base, ctx, num_ints, reg, REG)			\
+	do {								\
+		unsigned int _id;					\
+									\
+		for (_id = MIN_SPI_ID; _id < (num_ints);		\
+		     _id += (1 << REG##_SHIFT))				\
+			(ctx)->gicd_##reg[(_id - MIN_SPI_ID) >>		\
+					  REG##_SHIFT] =		\
+				gicd_read_##reg(base, _id);		\
+	} while (0)
+
+#define RESTORE_GICD_REGS(base, ctx, num_ints, reg, REG)		\
+	do {								\
+		unsigned int _id;					\
+									\
+		for (_id = MIN_SPI_ID; _id < (num_ints);		\
+		     _id += (1 << REG##_SHIFT))				\
+			gicd_write_##reg(base, _id,			\
+				(ctx)->gicd_##reg[(_id - MIN_SPI_ID) >>	\
+						  REG##_SHIFT]);	\
+	} while (0)
+
+/* Return the number of interrupt IDs covered by the SPIs of the GIC */
+static unsigned int gicv3_spi_num_ints(uintptr_t gicd_base)
+{
+	unsigned int num_ints;
+
+	num_ints = ((gicd_read_typer(gicd_base) & TYPER_IT_LINES_NO_MASK) + 1)
+		   << 5;
+	if (num_ints > MAX_SPI_ID + 1)
+		num_ints = MAX_SPI_ID + 1;
+	return num_ints;
+}
+
+/*******************************************************************************
+ * This function saves the state of the GIC Distributor in 'dist_ctx', so that
+ * it can be restored by gicv3_distif_restore() after the Distributor has been
+ * powered down, e.g. during a system suspend. Only the registers of the SPIs
+ * implemented by the GIC are saved.
+ ******************************************************************************/
+void gicv3_distif_save(gicv3_dist_ctx_t *dist_ctx)
+{
+	uintptr_t gicd_base;
+	unsigned int num_ints, id;
+
+	assert(gicv3_driver_data);
+	assert(gicv3_driver_data->gicd_base);
+	assert(IS_IN_EL3());
+	assert(dist_ctx);
+
+	gicd_base = gicv3_driver_data->gicd_base;
+	num_ints = gicv3_spi_num_ints(gicd_base);
+
+	dist_ctx->gicd_ctlr = gicd_read_ctlr(gicd_base);
+
+	for (id = MIN_SPI_ID; id < num_ints; id++)
+		dist_ctx->gicd_irouter[id - MIN_SPI_ID] =
+			gicd_read_irouter(gicd_base, id);
+
+	SAVE_GICD_REGS(gicd_base, dist_ctx, num_ints, igroupr, IGROUPR);
+	SAVE_GICD_REGS(gicd_base, dist_ctx, num_ints, isenabler, ISENABLER);
+	SAVE_GICD_REGS(gicd_base, dist_ctx, num_ints, ispendr, ISPENDR);
+	SAVE_GICD_REGS(gicd_base, dist_ctx, num_ints, isactiver, ISACTIVER);
+	SAVE_GICD_REGS(gicd_base, dist_ctx, num_ints, ipriorityr, IPRIORITYR);
+	SAVE_GICD_REGS(gicd_base, dist_ctx, num_ints, icfgr, ICFGR);
+	SAVE_GICD_REGS(gicd_base, dist_ctx, num_ints, igrpmodr, IGRPMODR);
+	SAVE_GICD_REGS(gicd_base, dist_ctx, num_ints, nsacr, NSACR);
+}
+
+/*******************************************************************************
+ * This function restores the state of the GIC Distributor saved in 'dist_ctx'
+ * by gicv3_distif_save(). It replaces gicv3_distif_init() on resume from a
+ * power down of the Distributor, whose registers are then in their reset state,
+ * so the set-enable, set-pending and set-active registers are written directly.
+ ******************************************************************************/
+void gicv3_distif_restore(const gicv3_dist_ctx_t *dist_ctx)
+{
+	uintptr_t gicd_base;
+	unsigned int num_ints, id;
+
+	assert(gicv3_driver_data);
+	assert(gicv3_driver_data->gicd_base);
+	assert(IS_IN_EL3());
+	assert(dist_ctx);
+
+	gicd_base = gicv3_driver_data->gicd_base;
+	num_ints = gicv3_spi_num_ints(gicd_base);
+
+	/*
+	 * Clear the "enable" bits for G0/G1S/G1NS interrupts before configuring
+	 * the ARE_S bit. The Distributor might generate a system error
+	 * otherwise.
+	 */
+	gicd_clr_ctlr(gicd_base,
+		      CTLR_ENABLE_G0_BIT |
+		      CTLR_ENABLE_G1S_BIT |
+		      CTLR_ENABLE_G1NS_BIT,
+		      RWP_TRUE);
+
+	/* Set the ARE_S and ARE_NS bits now that interrupts are disabled */
+	gicd_set_ctlr(gicd_base, CTLR_ARE_S_BIT | CTLR_ARE_NS_BIT, RWP_TRUE);
+
+	/* Restore the configuration of the SPIs before enabling them */
+	for (id = MIN_SPI_ID; id < num_ints; id++)
+		gicd_write_irouter(gicd_base, id,
+				   dist_ctx->gicd_irouter[id - MIN_SPI_ID]);
+
+	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, igroupr, IGROUPR);
+	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, ipriorityr,
+			  IPRIORITYR);
+	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, icfgr, ICFGR);
+	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, igrpmodr, IGRPMODR);
+	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, nsacr, NSACR);
+	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, ispendr, ISPENDR);
+	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, isactiver, ISACTIVER);
+	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, isenabler, ISENABLER);
+
+	/* Restore the group enables last */
+	gicd_write_ctlr(gicd_base, dist_ctx->gicd_ctlr & ~GICD_CTLR_RWP_BIT);
+	gicd_wait_for_pending_write(gicd_base);
+}
+
+/*******************************************************************************
+ * This function saves the state of the SGIs and PPIs of the GIC Redistributor
+ * of the CPU 'proc_num' in 'rdist_ctx', so that it can be restored by
+ * gicv3_rdistif_restore() after the Redistributor has been powered down.
+ ******************************************************************************/
+void gicv3_rdistif_save(unsigned int proc_num, gicv3_redist_ctx_t *rdist_ctx)
+{
+	uintptr_t gicr_base;
+	unsigned int i;
+
+	assert(gicv3_driver_data);
+	assert(proc_num < gicv3_driver_data->rdistif_num);
+	assert(gicv3_driver_data->rdistif_base_addrs);
+	assert(IS_IN_EL3());
+	assert(rdist_ctx);
+
+	gicr_base = gicv3_driver_data->rdistif_base_addrs[proc_num];
+
+	rdist_ctx->gicr_ctlr = (unsigned int)gicr_read_ctlr(gicr_base);
+	rdist_ctx->gicr_igroupr0 = gicr_read_igroupr0(gicr_base);
+	rdist_ctx->gicr_isenabler0 = gicr_read_isenabler0(gicr_base);
+	rdist_ctx->gicr_ispendr0 = gicr_read_ispendr0(gicr_base);
+	rdist_ctx->gicr_isactiver0 = gicr_read_isactiver0(gicr_base);
+	for (i = 0; i < ARRAY_SIZE(rdist_ctx->gicr_ipriorityr); i++)
+		rdist_ctx->gicr_ipriorityr[i] =
+			gicr_read_ipriorityr(gicr_base, i << IPRIORITYR_SHIFT);
+	rdist_ctx->gicr_icfgr0 = gicr_read_icfgr0(gicr_base);
+	rdist_ctx->gicr_icfgr1 = gicr_read_icfgr1(gicr_base);
+	rdist_ctx->gicr_igrpmodr0 = gicr_read_igrpmodr0(gicr_base);
+	rdist_ctx->gicr_nsacr = gicr_read_nsacr(gicr_base);
+}
+
+/*******************************************************************************
+ * This function restores the state of the GIC Redistributor of the CPU
+ * 'proc_num' saved in 'rdist_ctx' by gicv3_rdistif_save(). It replaces
+ * gicv3_rdistif_init() on resume from a power down of the Redistributor.
+ ******************************************************************************/
+void gicv3_rdistif_restore(unsigned int proc_num,
+			   const gicv3_redist_ctx_t *rdist_ctx)
+{
+	uintptr_t gicr_base;
+	unsigned int i;
+
+	assert(gicv3_driver_data);
+	assert(proc_num < gicv3_driver_data->rdistif_num);
+	assert(gicv3_driver_data->rdistif_base_addrs);
+	assert(gicv3_driver_data->gicd_base);
+	assert(gicd_read_ctlr(gicv3_driver_data->gicd_base) & CTLR_ARE_S_BIT);
+	assert(IS_IN_EL3());
+	assert(rdist_ctx);
+
+	/* Power on redistributor */
+	gicv3_rdistif_on(proc_num);
+
+	gicr_base = gicv3_driver_data->rdistif_base_addrs[proc_num];
+
+	/* Disable all SGIs and PPIs while they are configured */
+	gicr_write_icenabler0(gicr_base, ~0U);
+	gicr_wait_for_pending_write(gicr_base);
+
+	gicr_write_igroupr0(gicr_base, rdist_ctx->gicr_igroupr0);
+	for (i = 0; i < ARRAY_SIZE(rdist_ctx->gicr_ipriorityr); i++)
+		gicr_write_ipriorityr(gicr_base, i << IPRIORITYR_SHIFT,
+				      rdist_ctx->gicr_ipriorityr[i]);
+	gicr_write_icfgr0(gicr_base, rdist_ctx->gicr_icfgr0);
+	gicr_write_icfgr1(gicr_base, rdist_ctx->gicr_icfgr1);
+	gicr_write_igrpmodr0(gicr_base, rdist_ctx->gicr_igrpmodr0);
+	gicr_write_nsacr(gicr_base, rdist_ctx->gicr_nsacr);
+	gicr_write_ispendr0(gicr_base, rdist_ctx->gicr_ispendr0);
+	gicr_write_isactiver0(gicr_base, rdist_ctx->gicr_isactiver0);
+	gicr_write_isenabler0(gicr_base, rdist_ctx->gicr_isenabler0);
+
+	gicr_write_ctlr(gicr_base, rdist_ctx->gicr_ctlr & ~GICR_CTLR_RWP_BIT);
+	gicr_wait_for_pending_write(gicr_base);
+}
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <mmio.h>
+#include <pl330.h>
+#include <stdint.h>
+#include <utils_def.h>
+
+/* Instruction opcodes */
+#define DMAEND			0x00
+#define DMAKILL			0x01
+#define DMALD			0x04
+#define DMAST			0x08
+#define DMAWMB			0x13
+#define DMALP(lc)		(0x20 | ((lc) << 1))
+#define DMALPEND(lc)		(0x38 | ((lc) << 2))
+#define DMAGO(ns)		(0xa0 | ((ns) << 1))
+#define DMAMOV			0xbc
+
+/* Destination registers of DMAMOV */
+#define RD_SAR			0
+#define RD_CCR			1
+#define RD_DAR			2
+
+/* Channel control register fields */
+#define CCR_SRC_INC		(1 << 0)
+#define CCR_SRC_BURST_SIZE(s)	((s) << 1)
+#define CCR_SRC_BURST_LEN(l)	(((l) - 1) << 4)
+#define CCR_SRC_PROT(p)		((p) << 8)
+#define CCR_DST_INC		(1 << 14)
+#define CCR_DST_BURST_SIZE(s)	((s) << 15)
+#define CCR_DST_BURST_LEN(l)	(((l) - 1) << 18)
+#define CCR_DST_PROT(p)		((p) << 22)
+
+/* AXI protection of the transfers: privileged, Non-secure if 'ns' is set */
+#define PROT(ns)		(0x1 | ((ns) << 1))
+
+/* Longest burst the channel control register can describe */
+#define MAX_BURST_LEN		16
+
+/* Iterations of a loop counter */
+#define MAX_LOOP_ITER		256
+
+/* The PL330 has 32-bit addresses */
+#define ADDR_LIMIT		0x100000000ULL
+
+/* Debug instruction targets */
+#define DBG_MANAGER		0
+#define DBG_CHANNEL(ch)		(((ch) << 8) | 1)
+
+static uintptr_t pl330_base;
+static unsigned int pl330_channel;
+static uint8_t *pl330_prog;
+static int pl330_ns;
+static unsigned int pl330_beat_shift;
+static unsigned int pl330_burst_len;
+
+/* Execute an instruction of up to 6 bytes through the debug interface */
+static void pl330_dbg_exec(unsigned int target, unsigned int byte0,
+			   unsigned int byte1, uint32_t imm)
+{
+	while (mmio_read_32(pl330_base + PL330_DBGSTATUS_OFF) &
+	       PL330_DBGSTATUS_BUSY)
+		;
+
+	mmio_write_32(pl330_base + PL330_DBGINST0_OFF,
+		      (byte1 << 24) | (byte0 << 16) | target);
+	mmio_write_32(pl330_base + PL330_DBGINST1_OFF, imm);
+	mmio_write_32(pl330_base + PL330_DBGCMD_OFF, 0);
+}
+
+static unsigned int pl330_emit_mov(uint8_t *p, unsigned int rd, uint32_t imm)
+{
+	p[0] = DMAMOV;
+	p[1] = rd;
+	p[2] = imm & 0xff;
+	p[3] = (imm >> 8) & 0xff;
+	p[4] = (imm >> 16) & 0xff;
+	p[5] = imm >> 24;
+
+	return 6;
+}
+
+/*
+ * Write the program copying 'outer' x 'inner' bursts from 'src' to 'dst' and
+ * return its size.
+ */
+static unsigned int pl330_write_prog(uint32_t dst, uint32_t src,
+				     unsigned int outer, unsigned int inner)
+{
+	uint8_t *p = pl330_prog;
+	unsigned int n = 0, outer_start, inner_start;
+	uint32_t ccr;
+
+	ccr = CCR_SRC_INC | CCR_SRC_BURST_SIZE(pl330_beat_shift) |
+	      CCR_SRC_BURST_LEN(pl330_burst_len) | CCR_SRC_PROT(PROT(pl330_ns)) |
+	      CCR_DST_INC | CCR_DST_BURST_SIZE(pl330_beat_shift) |
+	      CCR_DST_BURST_LEN(pl330_burst_len) | CCR_DST_PROT(PROT(pl330_ns));
+
+	n += pl330_emit_mov(&p[n], RD_SAR, src);
+	n += pl330_emit_mov(&p[n], RD_DAR, dst);
+	n += pl330_emit_mov(&p[n], RD_CCR, ccr);
+
+	p[n++] = DMALP(1);
+	p[n++] = outer - 1;
+	outer_start = n;
+	p[n++] = DMALP(0);
+	p[n++] = inner - 1;
+	inner_start = n;
+	p[n++] = DMALD;
+	p[n++] = DMAST;
+	p[n] = DMALPEND(0);
+	p[n + 1] = n - inner_start;
+	n += 2;
+	p[n] = DMALPEND(1);
+	p[n + 1] = n - outer_start;
+	n += 2;
+
+	/* Wait for the last writes to complete before stopping the channel */
+	p[n++] = DMAWMB;
+	p[n++] = DMAEND;
+
+	assert(n <= PL330_PROG_SIZE);
+	return n;
+}
+
+/* Run the program of the channel and wait for it to complete */
+static int pl330_run_prog(unsigned int size)
+{
+	unsigned int state;
+
+	flush_dcache_range((uintptr_t)pl330_prog, size);
+
+	pl330_dbg_exec(DBG_MANAGER, DMAGO(pl330_ns), pl330_channel,
+		       (uintptr_t)pl330_prog);
+
+	do {
+		if (mmio_read_32(pl330_base + PL330_FSRD_OFF) != 0) {
+			ERROR("PL330: manager fault\n");
+			pl330_dbg_exec(DBG_MANAGER, DMAKILL, 0, 0);
+			return -EIO;
+		}
+		state = mmio_read_32(pl330_base + PL330_CSR_OFF(pl330_channel))
+			& PL330_CSR_STATE_MASK;
+	} while ((state != PL330_CSR_STOPPED) &&
+		 (state != PL330_CSR_FAULTING) &&
+		 (state != PL330_CSR_FAULT_COMPLETING));
+
+	if (state != PL330_CSR_STOPPED) {
+		ERROR("PL330: channel %u fault\n", pl330_channel);
+		pl330_dbg_exec(DBG_CHANNEL(pl330_channel), DMAKILL, 0, 0);
+		return -EIO;
+	}
+
+	return 0;
+}
+
+void pl330_init(uintptr_t base, unsigned int channel, uintptr_t prog_base,
+		int ns)
+{
+	uint32_t crd;
+	unsigned int depth;
+
+	assert(channel <= ((mmio_read_32(base + PL330_CR0_OFF) >>
+			    PL330_CR0_NUM_CHNLS_SHIFT) &
+			   PL330_CR0_NUM_CHNLS_MASK));
+	assert((prog_base != 0) && (prog_base + PL330_PROG_SIZE <= ADDR_LIMIT));
+
+	/* A Non-secure manager can only start Non-secure channels */
+	assert((ns != 0) ||
+	       ((mmio_read_32(base + PL330_DSR_OFF) & PL330_DSR_DNS) == 0));
+
+	pl330_base = base;
+	pl330_channel = channel;
+	pl330_prog = (uint8_t *)prog_base;
+	pl330_ns = (ns != 0);
+
+	/* Use bursts of the width of the bus that fit the data buffer */
+	crd = mmio_read_32(base + PL330_CRD_OFF);
+	pl330_beat_shift = crd & PL330_CRD_DATA_WIDTH_MASK;
+	depth = ((crd >> PL330_CRD_DATA_BUFFER_DEP_SHIFT) &
+		 PL330_CRD_DATA_BUFFER_DEP_MASK) + 1;
+	pl330_burst_len = MIN(depth, (unsigned int)MAX_BURST_LEN);
+}
+
+/* Return the alignment of the addresses and size of a copy */
+size_t pl330_get_copy_align(void)
+{
+	assert(pl330_base != 0);
+
+	return (size_t)pl330_burst_len << pl330_beat_shift;
+}
+
+/*
+ * Copy 'length' bytes from 'src' to 'dst', which must be aligned to
+ * pl330_get_copy_align(). The caller is responsible for the maintenance of the
+ * data caches. Return 0 on success or a negative error code, in which case the
+ * destination may have been partly written.
+ */
+int pl330_copy(uintptr_t dst, uintptr_t src, size_t length)
+{
+	size_t align = pl330_get_copy_align();
+	size_t bursts, count;
+	unsigned int inner, outer;
+	uintptr_t prog = (uintptr_t)pl330_prog;
+	int ret;
+
+	assert(((dst | src | length) & (align - 1)) == 0);
+
+	/* The PL330 mustn't overwrite its program */
+	if ((dst + length > ADDR_LIMIT) || (src + length > ADDR_LIMIT) ||
+	    ((dst < prog + PL330_PROG_SIZE) && (prog < dst + length)))
+		return -EINVAL;
+
+	bursts = length / align;
+	while (bursts != 0) {
+		inner = MIN(bursts, (size_t)MAX_LOOP_ITER);
+		outer = MIN(bursts / inner, (size_t)MAX_LOOP_ITER);
+		count = (size_t)outer * inner;
+
+		ret = pl330_run_prog(pl330_write_prog(dst, src, outer, inner));
+		if (ret != 0)
+			return ret;
+
+		dst += count * align;
+		src += count * align;
+		bursts -= count;
+	}
+
+	return 0;
+}
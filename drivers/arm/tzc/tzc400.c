@@ -78,9 +78,12 @@ static unsigned int _tzc400_get_gate_keeper(uintptr_t base,
 	return (open_status >> filter) & GATE_KEEPER_FILTER_MASK;
 }
 
-/* This function is not MP safe. */
+/*
+ * Open or close the gatekeepers of the filters in the 'filters' bitmap with a
+ * single request. This function is not MP safe.
+ */
 static void _tzc400_set_gate_keeper(uintptr_t base,
-				unsigned int filter,
+				unsigned int filters,
 				int val)
 {
 	unsigned int open_status;
@@ -89,9 +92,9 @@ static void _tzc400_set_gate_keeper(uintptr_t base,
 	open_status = get_gate_keeper_os(base);
 
 	if (val)
-		open_status |=  (1 << filter);
+		open_status |=  filters;
 	else
-		open_status &= ~(1 << filter);
+		open_status &= ~filters;
 
 	_tzc400_write_gate_keeper(base, (open_status & GATE_KEEPER_OR_MASK) <<
 			      GATE_KEEPER_OR_SHIFT);
@@ -157,23 +160,13 @@ void tzc400_configure_region0(tzc_region_attributes_t sec_attr,
 	_tzc400_configure_region0(tzc400.base, sec_attr, ns_device_access);
 }
 
-/*
- * `tzc400_configure_region` is used to program regions into the TrustZone
- * controller. A region can be associated with more than one filter. The
- * associated filters are passed in as a bitmap (bit0 = filter0).
- * NOTE:
- * Region 0 is special; it is preferable to use tzc400_configure_region0
- * for this region (see comment for that function).
- */
-void tzc400_configure_region(unsigned int filters,
+/* Check the arguments of a region to program */
+static void tzc400_check_region(unsigned int filters,
 			  int region,
 			  unsigned long long region_base,
 			  unsigned long long region_top,
-			  tzc_region_attributes_t sec_attr,
-			  unsigned int nsaid_permissions)
+			  tzc_region_attributes_t sec_attr)
 {
-	assert(tzc400.base);
-
 	/* Do range checks on filters and regions. */
 	assert(((filters >> tzc400.num_filters) == 0) &&
 	       (region >= 0) && (region < tzc400.num_regions));
@@ -189,6 +182,27 @@ void tzc400_configure_region(unsigned int filters,
 	assert(((region_base | (region_top + 1)) & (4096 - 1)) == 0);
 
 	assert(sec_attr <= TZC_REGION_S_RDWR);
+}
+
+/*
+ * `tzc400_configure_region` is used to program regions into the TrustZone
+ * controller. A region can be associated with more than one filter. The
+ * associated filters are passed in as a bitmap (bit0 = filter0).
+ * NOTE:
+ * Region 0 is special; it is preferable to use tzc400_configure_region0
+ * for this region (see comment for that function).
+ */
+void tzc400_configure_region(unsigned int filters,
+			  int region,
+			  unsigned long long region_base,
+			  unsigned long long region_top,
+			  tzc_region_attributes_t sec_attr,
+			  unsigned int nsaid_permissions)
+{
+	assert(tzc400.base);
+
+	tzc400_check_region(filters, region, region_base, region_top,
+			    sec_attr);
 
 	_tzc400_configure_region(tzc400.base, filters, region, region_base,
 						region_top,
@@ -202,6 +216,7 @@ void tzc400_enable_filters(void)
 
 	assert(tzc400.base);
 
+	/* Check all the filters, then open them with a single request */
 	for (filter = 0; filter < tzc400.num_filters; filter++) {
 		state = _tzc400_get_gate_keeper(tzc400.base, filter);
 		if (state) {
@@ -216,20 +231,63 @@ void tzc400_enable_filters(void)
 				" enabled.\n", filter);
 			panic();
 		}
-		_tzc400_set_gate_keeper(tzc400.base, filter, 1);
 	}
+	_tzc400_set_gate_keeper(tzc400.base, (1 << tzc400.num_filters) - 1,
+				1);
 }
 
 void tzc400_disable_filters(void)
 {
-	unsigned int filter;
-
 	assert(tzc400.base);
 
 	/*
 	 * We don't do the same state check as above as the Gatekeepers are
 	 * disabled after reset.
 	 */
-	for (filter = 0; filter < tzc400.num_filters; filter++)
-		_tzc400_set_gate_keeper(tzc400.base, filter, 0);
+	_tzc400_set_gate_keeper(tzc400.base, (1 << tzc400.num_filters) - 1,
+				0);
+}
+
+/*
+ * `tzc400_update_regions` reprograms a set of regions of an active TZC. The
+ * gatekeepers of all the filters used by these regions are closed once for the
+ * whole update, which then appears atomic to the masters: their accesses
+ * through these filters are stalled until the gatekeepers are open again.
+ * The caller must therefore not execute from, or access, memory behind these
+ * filters meanwhile. Like the other functions of this driver, this is not MP
+ * safe.
+ *
+ * Overlapping regions are not rejected: the TZC-400 resolves them in favour of
+ * the region with the highest number.
+ */
+void tzc400_update_regions(const tzc400_region_info_t *regions,
+			   unsigned int count)
+{
+	unsigned int filters = 0, open_status, i;
+
+	assert(tzc400.base);
+	assert((regions != NULL) || (count == 0));
+
+	/* Check all the regions before changing anything */
+	for (i = 0; i < count; i++) {
+		tzc400_check_region(regions[i].filters, regions[i].region,
+				    regions[i].region_base,
+				    regions[i].region_top,
+				    regions[i].sec_attr);
+		filters |= regions[i].filters;
+	}
+
+	/* Only reopen the gatekeepers that were open before the update */
+	open_status = get_gate_keeper_os(tzc400.base) & filters;
+	_tzc400_set_gate_keeper(tzc400.base, filters, 0);
+
+	for (i = 0; i < count; i++)
+		_tzc400_configure_region(tzc400.base, regions[i].filters,
+					 regions[i].region,
+					 regions[i].region_base,
+					 regions[i].region_top,
+					 regions[i].sec_attr,
+					 regions[i].nsaid_permissions);
+
+	_tzc400_set_gate_keeper(tzc400.base, open_status, 1);
 }
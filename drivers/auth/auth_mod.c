@@ -1,9 +1,10 @@
 /*
- * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <arch_helpers.h>
 #include <assert.h>
 #include <auth_common.h>
 #include <auth_mod.h>
@@ -15,10 +16,22 @@
 #include <platform_def.h>
 #include <stdint.h>
 #include <string.h>
+#include <utils.h>
 
 /* ASN.1 tags */
 #define ASN1_INTEGER                 0x02
 
+/* Number of platform NV counters whose value is cached */
+#ifndef PLAT_NV_CTR_CACHE_ENTRIES
+#define PLAT_NV_CTR_CACHE_ENTRIES	2
+#endif
+
+/* Value of 'magic' in a valid NV counter cache */
+#define NV_CTR_CACHE_MAGIC		0x4e564343	/* "NVCC" */
+
+/* Size of the copy of the cookies kept to match them across boot stages */
+#define NV_CTR_COOKIE_LEN		32
+
 #define return_if_error(rc) \
 	do { \
 		if (rc != 0) { \
@@ -30,37 +43,132 @@
 
 /* Pointer to CoT */
 extern const auth_img_desc_t *const cot_desc_ptr;
+extern const unsigned int cot_desc_size;
 extern unsigned int auth_img_flags[];
+extern uint8_t auth_img_param_slots[][AUTH_METHOD_NUM];
+
+/* Value of a slot in auth_img_param_slots[] for a method without parent data */
+#define AUTH_PARAM_SLOT_NONE		0xff
+
+/*
+ * Image whose hash is computed while it is being loaded, and number of bytes
+ * hashed so far.
+ */
+static unsigned int stream_img_id = INVALID_IMAGE_ID;
+static unsigned int stream_len;
+
+/*
+ * Values of the platform NV counters read or written during this boot, so that
+ * each counter is read from the platform once. A shared cache is seeded by BL1
+ * and reused by BL2, and the cookies of the counters are then compared as
+ * strings, as the pointers differ between the images.
+ */
+typedef struct {
+#ifdef PLAT_NV_CTR_CACHE_BASE
+	char cookie[NV_CTR_COOKIE_LEN];
+#else
+	const void *cookie;
+#endif
+	unsigned int value;
+} nv_ctr_cache_entry_t;
+
+typedef struct {
+	unsigned int magic;
+	unsigned int count;
+	nv_ctr_cache_entry_t entries[PLAT_NV_CTR_CACHE_ENTRIES];
+} nv_ctr_cache_t;
+
+#ifdef PLAT_NV_CTR_CACHE_BASE
+static nv_ctr_cache_t *const nv_ctr_cache =
+	(nv_ctr_cache_t *)PLAT_NV_CTR_CACHE_BASE;
+#else
+static nv_ctr_cache_t nv_ctr_cache_mem;
+static nv_ctr_cache_t *const nv_ctr_cache = &nv_ctr_cache_mem;
+#endif
 
 static int cmp_auth_param_type_desc(const auth_param_type_desc_t *a,
 		const auth_param_type_desc_t *b)
 {
-	if ((a->type == b->type) && (a->cookie == b->cookie)) {
+	if ((b != NULL) && (a->type == b->type) && (a->cookie == b->cookie)) {
 		return 0;
 	}
 	return 1;
 }
 
 /*
- * This function obtains the requested authentication parameter data from the
- * information extracted from the parent image after its authentication.
+ * Return the parameter that an authentication method takes from the data
+ * extracted from the parent image, or NULL if there is none.
  */
-static int auth_get_param(const auth_param_type_desc_t *param_type_desc,
-			  const auth_img_desc_t *img_desc,
-			  void **param, unsigned int *len)
+static const auth_param_type_desc_t *auth_method_parent_param(
+		const auth_method_desc_t *auth_method)
 {
-	int i;
+	switch (auth_method->type) {
+	case AUTH_METHOD_HASH:
+		return auth_method->param.hash.hash;
+	case AUTH_METHOD_SIG:
+		return auth_method->param.sig.pk;
+	default:
+		return NULL;
+	}
+}
 
-	for (i = 0 ; i < COT_MAX_VERIFIED_PARAMS ; i++) {
-		if (0 == cmp_auth_param_type_desc(param_type_desc,
-				img_desc->authenticated_data[i].type_desc)) {
-			*param = img_desc->authenticated_data[i].data.ptr;
-			*len = img_desc->authenticated_data[i].data.len;
-			return 0;
+/*
+ * Find, for each authentication method of each image of the CoT, the slot of
+ * the parent's authenticated data holding the parameter it needs. The CoT is
+ * constant, so this is done once instead of searching the parent's data each
+ * time an image is authenticated.
+ */
+static void auth_resolve_params(void)
+{
+	const auth_img_desc_t *img_desc;
+	const auth_param_type_desc_t *param;
+	const auth_param_desc_t *data;
+	unsigned int i, j, slot;
+
+	for (i = 0; i < cot_desc_size; i++) {
+		img_desc = &cot_desc_ptr[i];
+		for (j = 0; j < AUTH_METHOD_NUM; j++) {
+			auth_img_param_slots[i][j] = AUTH_PARAM_SLOT_NONE;
+			param = auth_method_parent_param(
+					&img_desc->img_auth_methods[j]);
+			if ((param == NULL) || (img_desc->parent == NULL)) {
+				continue;
+			}
+
+			data = img_desc->parent->authenticated_data;
+			for (slot = 0; slot < COT_MAX_VERIFIED_PARAMS; slot++) {
+				if (0 == cmp_auth_param_type_desc(param,
+						data[slot].type_desc)) {
+					auth_img_param_slots[i][j] = slot;
+					break;
+				}
+			}
+			/* The CoT must provide the data to the children */
+			assert(auth_img_param_slots[i][j] !=
+			       AUTH_PARAM_SLOT_NONE);
 		}
 	}
+}
 
-	return 1;
+/*
+ * This function obtains the authentication parameter data needed by the method
+ * 'method' of an image from the information extracted from its parent image
+ * after its authentication.
+ */
+static int auth_get_param(const auth_img_desc_t *img_desc, unsigned int method,
+			  void **param, unsigned int *len)
+{
+	const auth_param_desc_t *data;
+	unsigned int slot = auth_img_param_slots[img_desc->img_id][method];
+
+	if (slot == AUTH_PARAM_SLOT_NONE) {
+		return 1;
+	}
+
+	data = &img_desc->parent->authenticated_data[slot];
+	*param = data->data.ptr;
+	*len = data->data.len;
+	return 0;
 }
 
 /*
@@ -89,7 +197,7 @@ static int auth_get_param(const auth_param_type_desc_t *param_type_desc,
  *   0 = success, Otherwise = error
  */
 static int auth_hash(const auth_method_param_hash_t *param,
-		     const auth_img_desc_t *img_desc,
+		     const auth_img_desc_t *img_desc, unsigned int method,
 		     void *img, unsigned int img_len)
 {
 	void *data_ptr, *hash_der_ptr;
@@ -98,10 +206,19 @@ static int auth_hash(const auth_method_param_hash_t *param,
 
 	/* Get the hash from the parent image. This hash will be DER encoded
 	 * and contain the hash algorithm */
-	rc = auth_get_param(param->hash, img_desc->parent,
-			&hash_der_ptr, &hash_der_len);
+	rc = auth_get_param(img_desc, method, &hash_der_ptr, &hash_der_len);
 	return_if_error(rc);
 
+	/* Use the hash computed while loading, if it covers the whole image */
+	if (stream_img_id == img_desc->img_id) {
+		stream_img_id = INVALID_IMAGE_ID;
+		if (stream_len == img_len) {
+			return crypto_mod_hash_final(hash_der_ptr,
+						     hash_der_len);
+		}
+		(void)crypto_mod_hash_final(NULL, 0);
+	}
+
 	/* Get the data to be hashed from the current image */
 	rc = img_parser_get_auth_param(img_desc->img_type, param->data,
 			img, img_len, &data_ptr, &data_len);
@@ -142,7 +259,7 @@ static int auth_hash(const auth_method_param_hash_t *param,
  * Return: 0 = success, Otherwise = error
  */
 static int auth_signature(const auth_method_param_sig_t *param,
-			  const auth_img_desc_t *img_desc,
+			  const auth_img_desc_t *img_desc, unsigned int method,
 			  void *img, unsigned int img_len)
 {
 	void *data_ptr, *pk_ptr, *pk_hash_ptr, *sig_ptr, *sig_alg_ptr;
@@ -169,8 +286,7 @@ static int auth_signature(const auth_method_param_sig_t *param,
 	 * the certificate has been signed with the ROTPK, so we have to get
 	 * the PK from the platform */
 	if (img_desc->parent) {
-		rc = auth_get_param(param->pk, img_desc->parent,
-				&pk_ptr, &pk_len);
+		rc = auth_get_param(img_desc, method, &pk_ptr, &pk_len);
 	} else {
 		rc = plat_get_rotpk_info(param->pk->cookie, &pk_ptr, &pk_len,
 				&flags);
@@ -213,6 +329,58 @@ static int auth_signature(const auth_method_param_sig_t *param,
 	return rc;
 }
 
+/* Return the cache entry of the counter identified by 'cookie', or NULL */
+static nv_ctr_cache_entry_t *nv_ctr_cache_lookup(const void *cookie)
+{
+	nv_ctr_cache_entry_t *entry;
+	unsigned int i;
+
+	for (i = 0; i < nv_ctr_cache->count; i++) {
+		entry = &nv_ctr_cache->entries[i];
+#ifdef PLAT_NV_CTR_CACHE_BASE
+		if (strcmp(entry->cookie, cookie) == 0) {
+#else
+		if (entry->cookie == cookie) {
+#endif
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+/* Record the value of a counter, once read from or written to the platform */
+static void nv_ctr_cache_set(const void *cookie, unsigned int value)
+{
+	nv_ctr_cache_entry_t *entry = nv_ctr_cache_lookup(cookie);
+#ifdef PLAT_NV_CTR_CACHE_BASE
+	size_t len;
+#endif
+
+	if (entry == NULL) {
+		if (nv_ctr_cache->count == PLAT_NV_CTR_CACHE_ENTRIES) {
+			return;
+		}
+#ifdef PLAT_NV_CTR_CACHE_BASE
+		len = strnlen(cookie, NV_CTR_COOKIE_LEN);
+		if (len == NV_CTR_COOKIE_LEN) {
+			return;
+		}
+#endif
+		entry = &nv_ctr_cache->entries[nv_ctr_cache->count++];
+#ifdef PLAT_NV_CTR_CACHE_BASE
+		memcpy(entry->cookie, cookie, len + 1);
+#else
+		entry->cookie = cookie;
+#endif
+	}
+	entry->value = value;
+
+#ifdef PLAT_NV_CTR_CACHE_BASE
+	/* The next boot stage may read the cache with its caches disabled */
+	flush_dcache_range((uintptr_t)nv_ctr_cache, sizeof(nv_ctr_cache_t));
+#endif
+}
+
 /*
  * Authenticate by Non-Volatile counter
  *
@@ -232,6 +400,7 @@ static int auth_nvctr(const auth_method_param_nv_ctr_t *param,
 	void *data_ptr = NULL;
 	unsigned int data_len, len, i;
 	unsigned int cert_nv_ctr, plat_nv_ctr;
+	const nv_ctr_cache_entry_t *cache_entry;
 	int rc = 0;
 
 	/* Get the counter value from current image. The AM expects the IPM
@@ -267,9 +436,15 @@ static int auth_nvctr(const auth_method_param_nv_ctr_t *param,
 		cert_nv_ctr = (cert_nv_ctr << 8) | *p++;
 	}
 
-	/* Get the counter from the platform */
-	rc = plat_get_nv_ctr(param->plat_nv_ctr->cookie, &plat_nv_ctr);
-	return_if_error(rc);
+	/* Get the counter from the cache, or else from the platform */
+	cache_entry = nv_ctr_cache_lookup(param->plat_nv_ctr->cookie);
+	if (cache_entry != NULL) {
+		plat_nv_ctr = cache_entry->value;
+	} else {
+		rc = plat_get_nv_ctr(param->plat_nv_ctr->cookie, &plat_nv_ctr);
+		return_if_error(rc);
+		nv_ctr_cache_set(param->plat_nv_ctr->cookie, plat_nv_ctr);
+	}
 
 	if (cert_nv_ctr < plat_nv_ctr) {
 		/* Invalid NV-counter */
@@ -278,6 +453,7 @@ static int auth_nvctr(const auth_method_param_nv_ctr_t *param,
 		rc = plat_set_nv_ctr2(param->plat_nv_ctr->cookie,
 			img_desc, cert_nv_ctr);
 		return_if_error(rc);
+		nv_ctr_cache_set(param->plat_nv_ctr->cookie, cert_nv_ctr);
 	}
 
 	return 0;
@@ -320,6 +496,83 @@ int auth_mod_get_parent_id(unsigned int img_id, unsigned int *parent_id)
 	return 0;
 }
 
+/*
+ * Start hashing an image while it is being loaded, so that its hash does not
+ * need to be computed again by auth_mod_verify_img(). This is only possible
+ * for raw images authenticated by hash whose parent has been authenticated.
+ *
+ * Return value:
+ *   0 = The data of the image must be passed to auth_mod_hash_update() as
+ *       it is loaded, Otherwise = the image is authenticated as a whole
+ */
+int auth_mod_hash_start(unsigned int img_id)
+{
+	const auth_img_desc_t *img_desc = &cot_desc_ptr[img_id];
+	const auth_method_param_hash_t *param = NULL;
+	void *hash_der_ptr;
+	unsigned int hash_der_len;
+	int i;
+
+	if (stream_img_id != INVALID_IMAGE_ID)
+		auth_mod_hash_abort();
+
+	if ((img_desc->img_type != IMG_RAW) || (img_desc->parent == NULL) ||
+	    !(auth_img_flags[img_desc->parent->img_id] &
+	      IMG_FLAG_AUTHENTICATED))
+		return 1;
+
+	for (i = 0 ; i < AUTH_METHOD_NUM ; i++) {
+		if (img_desc->img_auth_methods[i].type == AUTH_METHOD_HASH) {
+			param = &img_desc->img_auth_methods[i].param.hash;
+			break;
+		}
+	}
+	if ((param == NULL) || (param->data->type != AUTH_PARAM_RAW_DATA))
+		return 1;
+
+	if (auth_get_param(img_desc, i, &hash_der_ptr, &hash_der_len) != 0)
+		return 1;
+
+	if (crypto_mod_hash_init(hash_der_ptr, hash_der_len) != CRYPTO_SUCCESS)
+		return 1;
+
+	stream_img_id = img_id;
+	stream_len = 0;
+	return 0;
+}
+
+/*
+ * Add the next chunk of the image being loaded to its hash
+ */
+int auth_mod_hash_update(void *data_ptr, unsigned int data_len)
+{
+	int rc;
+
+	assert(stream_img_id != INVALID_IMAGE_ID);
+
+	rc = crypto_mod_hash_update(data_ptr, data_len);
+	if (rc != CRYPTO_SUCCESS) {
+		auth_mod_hash_abort();
+		return rc;
+	}
+
+	stream_len += data_len;
+	return 0;
+}
+
+/*
+ * Discard the hash of the image being loaded, which will then be hashed as a
+ * whole by auth_mod_verify_img()
+ */
+void auth_mod_hash_abort(void)
+{
+	if (stream_img_id == INVALID_IMAGE_ID)
+		return;
+
+	stream_img_id = INVALID_IMAGE_ID;
+	(void)crypto_mod_hash_final(NULL, 0);
+}
+
 /*
  * Initialize the different modules in the authentication framework
  */
@@ -333,6 +586,21 @@ void auth_mod_init(void)
 
 	/* Image parser module */
 	img_parser_init();
+
+	/* Parent data used by the authentication methods */
+	auth_resolve_params();
+
+	/*
+	 * The first boot stage discards the NV counter values cached during the
+	 * previous boot. The next ones reuse the values it has cached.
+	 */
+#if defined(IMAGE_BL1) || (defined(IMAGE_BL2) && BL2_AT_EL3)
+	nv_ctr_cache->magic = 0;
+#endif
+	if (nv_ctr_cache->magic != NV_CTR_CACHE_MAGIC) {
+		zeromem(nv_ctr_cache, sizeof(nv_ctr_cache_t));
+		nv_ctr_cache->magic = NV_CTR_CACHE_MAGIC;
+	}
 }
 
 /*
@@ -340,9 +608,7 @@ void auth_mod_init(void)
  *
  * Return: 0 = success, Otherwise = error
  */
-int auth_mod_verify_img(unsigned int img_id,
-			void *img_ptr,
-			unsigned int img_len)
+static int verify_img(unsigned int img_id, void *img_ptr, unsigned int img_len)
 {
 	const auth_img_desc_t *img_desc = NULL;
 	const auth_method_desc_t *auth_method = NULL;
@@ -367,11 +633,11 @@ int auth_mod_verify_img(unsigned int img_id,
 			break;
 		case AUTH_METHOD_HASH:
 			rc = auth_hash(&auth_method->param.hash,
-					img_desc, img_ptr, img_len);
+					img_desc, i, img_ptr, img_len);
 			break;
 		case AUTH_METHOD_SIG:
 			rc = auth_signature(&auth_method->param.sig,
-					img_desc, img_ptr, img_len);
+					img_desc, i, img_ptr, img_len);
 			break;
 		case AUTH_METHOD_NV_CTR:
 			rc = auth_nvctr(&auth_method->param.nv_ctr,
@@ -413,3 +679,23 @@ int auth_mod_verify_img(unsigned int img_id,
 
 	return 0;
 }
+
+/*
+ * Authenticate a certificate/image, then let the crypto library reclaim the
+ * memory it used
+ *
+ * Return: 0 = success, Otherwise = error
+ */
+int auth_mod_verify_img(unsigned int img_id,
+			void *img_ptr,
+			unsigned int img_len)
+{
+	int rc;
+
+	rc = verify_img(img_id, img_ptr, img_len);
+
+	/* Nothing the crypto library allocated is needed past this point */
+	crypto_mod_release();
+
+	return rc;
+}
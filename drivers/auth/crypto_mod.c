@@ -11,6 +11,30 @@
 /* Variable exported by the crypto library through REGISTER_CRYPTO_LIB() */
 extern const crypto_lib_desc_t crypto_lib_desc;
 
+/*
+ * Variable optionally exported by the platform through REGISTER_CRYPTO_ACCEL()
+ * to offload the operations to a hardware engine. The crypto library is used
+ * for the operations that the accelerator does not provide, and for those it
+ * rejects with CRYPTO_ERR_UNKNOWN (e.g. an unsupported algorithm).
+ */
+#pragma weak crypto_accel_desc
+extern const crypto_lib_desc_t crypto_accel_desc;
+
+#define accel_provides(_op)	((&crypto_accel_desc != NULL) &&	\
+				 (crypto_accel_desc._op != NULL))
+
+/* Library or accelerator computing the incremental hash in progress */
+static const crypto_lib_desc_t *hash_desc;
+
+/* Check that a library provides all or none of the incremental hash calls */
+#define assert_hash_desc(_desc)						\
+	assert((((_desc).hash_init == NULL) &&				\
+		((_desc).hash_update == NULL) &&			\
+		((_desc).hash_final == NULL)) ||			\
+	       (((_desc).hash_init != NULL) &&				\
+		((_desc).hash_update != NULL) &&			\
+		((_desc).hash_final != NULL)))
+
 /*
  * The crypto module is responsible for verifying digital signatures and hashes.
  * It relies on a crypto library to perform the cryptographic operations.
@@ -48,10 +72,22 @@ void crypto_mod_init(void)
 	assert(crypto_lib_desc.init != NULL);
 	assert(crypto_lib_desc.verify_signature != NULL);
 	assert(crypto_lib_desc.verify_hash != NULL);
+	assert_hash_desc(crypto_lib_desc);
 
 	/* Initialize the cryptographic library */
 	crypto_lib_desc.init();
 	INFO("Using crypto library '%s'\n", crypto_lib_desc.name);
+
+	if (&crypto_accel_desc == NULL)
+		return;
+
+	assert(crypto_accel_desc.name != NULL);
+	assert(crypto_accel_desc.init != NULL);
+	assert_hash_desc(crypto_accel_desc);
+
+	/* Initialize the crypto accelerator */
+	crypto_accel_desc.init();
+	INFO("Using crypto accelerator '%s'\n", crypto_accel_desc.name);
 }
 
 /*
@@ -69,6 +105,8 @@ int crypto_mod_verify_signature(void *data_ptr, unsigned int data_len,
 				void *sig_alg_ptr, unsigned int sig_alg_len,
 				void *pk_ptr, unsigned int pk_len)
 {
+	int rc;
+
 	assert(data_ptr != NULL);
 	assert(data_len != 0);
 	assert(sig_ptr != NULL);
@@ -78,6 +116,16 @@ int crypto_mod_verify_signature(void *data_ptr, unsigned int data_len,
 	assert(pk_ptr != NULL);
 	assert(pk_len != 0);
 
+	if (accel_provides(verify_signature)) {
+		rc = crypto_accel_desc.verify_signature(data_ptr, data_len,
+							sig_ptr, sig_len,
+							sig_alg_ptr,
+							sig_alg_len,
+							pk_ptr, pk_len);
+		if (rc != CRYPTO_ERR_UNKNOWN)
+			return rc;
+	}
+
 	return crypto_lib_desc.verify_signature(data_ptr, data_len,
 						sig_ptr, sig_len,
 						sig_alg_ptr, sig_alg_len,
@@ -95,11 +143,107 @@ int crypto_mod_verify_signature(void *data_ptr, unsigned int data_len,
 int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 			   void *digest_info_ptr, unsigned int digest_info_len)
 {
+	int rc;
+
 	assert(data_ptr != NULL);
 	assert(data_len != 0);
 	assert(digest_info_ptr != NULL);
 	assert(digest_info_len != 0);
 
+	if (accel_provides(verify_hash)) {
+		rc = crypto_accel_desc.verify_hash(data_ptr, data_len,
+						   digest_info_ptr,
+						   digest_info_len);
+		if (rc != CRYPTO_ERR_UNKNOWN)
+			return rc;
+	}
+
 	return crypto_lib_desc.verify_hash(data_ptr, data_len,
 					   digest_info_ptr, digest_info_len);
 }
+
+/*
+ * Start computing a hash incrementally. Only one hash can be in progress at a
+ * time. Returns CRYPTO_ERR_UNKNOWN if neither the accelerator nor the library
+ * support it. The hash is then computed by the one that accepted this call.
+ *
+ * Parameters:
+ *
+ *   digest_info_ptr, digest_info_len: hash to be compared, used to select the
+ *                                     hash algorithm
+ */
+int crypto_mod_hash_init(void *digest_info_ptr, unsigned int digest_info_len)
+{
+	int rc;
+
+	assert(digest_info_ptr != NULL);
+	assert(digest_info_len != 0);
+	assert(hash_desc == NULL);
+
+	if (accel_provides(hash_init)) {
+		rc = crypto_accel_desc.hash_init(digest_info_ptr,
+						 digest_info_len);
+		if (rc != CRYPTO_ERR_UNKNOWN) {
+			if (rc == CRYPTO_SUCCESS)
+				hash_desc = &crypto_accel_desc;
+			return rc;
+		}
+	}
+
+	if (crypto_lib_desc.hash_init == NULL)
+		return CRYPTO_ERR_UNKNOWN;
+
+	rc = crypto_lib_desc.hash_init(digest_info_ptr, digest_info_len);
+	if (rc == CRYPTO_SUCCESS)
+		hash_desc = &crypto_lib_desc;
+
+	return rc;
+}
+
+/*
+ * Add data to the hash started by crypto_mod_hash_init()
+ *
+ * Parameters:
+ *
+ *   data_ptr, data_len: data to be hashed
+ */
+int crypto_mod_hash_update(void *data_ptr, unsigned int data_len)
+{
+	assert(data_ptr != NULL);
+	assert(data_len != 0);
+	assert(hash_desc != NULL);
+
+	return hash_desc->hash_update(data_ptr, data_len);
+}
+
+/*
+ * Finish the hash started by crypto_mod_hash_init() and compare it with the
+ * expected value. Passing a NULL digest info discards the hash.
+ *
+ * Parameters:
+ *
+ *   digest_info_ptr, digest_info_len: hash to be compared
+ */
+int crypto_mod_hash_final(void *digest_info_ptr, unsigned int digest_info_len)
+{
+	const crypto_lib_desc_t *desc = hash_desc;
+
+	assert((digest_info_ptr == NULL) || (digest_info_len != 0));
+	assert(desc != NULL);
+
+	hash_desc = NULL;
+	return desc->hash_final(digest_info_ptr, digest_info_len);
+}
+
+/*
+ * Let the library reclaim the memory it used to authenticate an image. This is
+ * deferred while an incremental hash is in progress, as its context has to be
+ * kept until crypto_mod_hash_final().
+ */
+void crypto_mod_release(void)
+{
+	if ((hash_desc != NULL) || (crypto_lib_desc.release == NULL))
+		return;
+
+	crypto_lib_desc.release();
+}
@@ -5,6 +5,7 @@
  */
 
 #include <debug.h>
+#include <mbedtls_common.h>
 
 /* mbed TLS headers */
 #include <mbedtls/memory_buffer_alloc.h>
@@ -20,6 +21,33 @@
 #endif
 static unsigned char heap[MBEDTLS_HEAP_SIZE];
 
+#if LOG_LEVEL >= LOG_LEVEL_VERBOSE
+/* Highest number of heap bytes used by the authentication of an image */
+static unsigned int heap_peak;
+
+/*
+ * Report the heap usage of the image just authenticated, to help sizing
+ * MBEDTLS_HEAP_SIZE. The allocator clears the heap when it is initialised and
+ * carves the blocks from its start, so the last non-zero byte gives the high
+ * water mark.
+ */
+static void heap_report(void)
+{
+	unsigned int used = MBEDTLS_HEAP_SIZE;
+
+	while ((used > 0) && (heap[used - 1] == 0))
+		used--;
+
+	if (used > heap_peak)
+		heap_peak = used;
+
+	VERBOSE("mbed TLS heap: %u bytes used, peak %u of %u\n", used,
+		heap_peak, MBEDTLS_HEAP_SIZE);
+}
+#else
+#define heap_report()
+#endif
+
 /*
  * mbed TLS initialization function
  */
@@ -34,6 +62,26 @@ void mbedtls_init(void)
 		/* Use reduced version of snprintf to save space. */
 		mbedtls_platform_set_snprintf(tf_snprintf);
 
+#if TF_MBEDTLS_SHA256_CE
+		/* Use the SHA-256 instructions if the CPU implements them */
+		mbedtls_sha256_ce_init();
+#endif
+
 		ready = 1;
 	}
 }
+
+/*
+ * Called once an image has been authenticated. Nothing allocated by mbed TLS
+ * outlives an authentication, so the heap is reset to empty rather than left
+ * to fragment over the images loaded by BL2.
+ */
+void mbedtls_heap_release(void)
+{
+	heap_report();
+
+#if TF_MBEDTLS_HEAP_RESET
+	mbedtls_memory_buffer_alloc_free();
+	mbedtls_memory_buffer_alloc_init(heap, MBEDTLS_HEAP_SIZE);
+#endif
+}
@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+# Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
 #
 # SPDX-License-Identifier: BSD-3-Clause
 #
@@ -29,6 +29,15 @@ MBEDTLS_COMMON_SOURCES	:=	drivers/auth/mbedtls/mbedtls_common.c	\
 				platform.c 				\
 				)
 
+# The mbed TLS heap is reset to empty after the authentication of each image.
+# The platform may set 'TF_MBEDTLS_HEAP_RESET' to 0 if it keeps data allocated
+# by mbed TLS across authentications.
+ifeq (${TF_MBEDTLS_HEAP_RESET},)
+    TF_MBEDTLS_HEAP_RESET	:=	1
+endif
+$(eval $(call assert_boolean,TF_MBEDTLS_HEAP_RESET))
+$(eval $(call add_define,TF_MBEDTLS_HEAP_RESET))
+
 BL1_SOURCES		+=	${MBEDTLS_COMMON_SOURCES}
 BL2_SOURCES		+=	${MBEDTLS_COMMON_SOURCES}
 
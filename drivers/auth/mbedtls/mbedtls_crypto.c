@@ -12,10 +12,19 @@
 #include <string.h>
 
 /* mbed TLS headers */
+#include <mbedtls/asn1.h>
 #include <mbedtls/md.h>
 #include <mbedtls/memory_buffer_alloc.h>
 #include <mbedtls/oid.h>
+#include <mbedtls/pk.h>
 #include <mbedtls/platform.h>
+#include <mbedtls/x509.h>
+#if (TF_MBEDTLS_KEY_ALG_ID == TF_MBEDTLS_RSA)
+#include <mbedtls/rsa.h>
+#elif (TF_MBEDTLS_KEY_ALG_ID == TF_MBEDTLS_ECDSA)
+#include <mbedtls/ecdsa.h>
+#include <mbedtls/ecp.h>
+#endif
 
 #define LIB_NAME		"mbed TLS"
 
@@ -45,26 +54,188 @@ static void init(void)
 	mbedtls_init();
 }
 
+/*
+ * Get the algorithm and the key of a SubjectPublicKeyInfo. The key points to
+ * the content of the subjectPublicKey bit string.
+ */
+static int get_pk_info(void *pk_ptr, unsigned int pk_len,
+		       mbedtls_pk_type_t *pk_alg, mbedtls_asn1_buf *pk_params,
+		       unsigned char **key, size_t *key_len)
+{
+	mbedtls_asn1_buf pk_oid;
+	unsigned char *p, *end;
+	size_t len;
+	int rc;
+
+	p = (unsigned char *)pk_ptr;
+	end = p + pk_len;
+	rc = mbedtls_asn1_get_tag(&p, end, &len, MBEDTLS_ASN1_CONSTRUCTED |
+				  MBEDTLS_ASN1_SEQUENCE);
+	if (rc != 0) {
+		return CRYPTO_ERR_SIGNATURE;
+	}
+	end = p + len;
+
+	rc = mbedtls_asn1_get_alg(&p, end, &pk_oid, pk_params);
+	if (rc != 0) {
+		return CRYPTO_ERR_SIGNATURE;
+	}
+
+	rc = mbedtls_oid_get_pk_alg(&pk_oid, pk_alg);
+	if (rc != 0) {
+		return CRYPTO_ERR_SIGNATURE;
+	}
+
+	/* The RSA keys have NULL parameters */
+	if ((*pk_alg == MBEDTLS_PK_RSA) &&
+	    (((pk_params->tag != MBEDTLS_ASN1_NULL) && (pk_params->tag != 0)) ||
+	     (pk_params->len != 0))) {
+		return CRYPTO_ERR_SIGNATURE;
+	}
+
+	rc = mbedtls_asn1_get_bitstring_null(&p, end, key_len);
+	if ((rc != 0) || (p + *key_len != end)) {
+		return CRYPTO_ERR_SIGNATURE;
+	}
+	*key = p;
+
+	return CRYPTO_SUCCESS;
+}
+
+#if (TF_MBEDTLS_KEY_ALG_ID == TF_MBEDTLS_RSA)
+/*
+ * RSAPublicKey ::= SEQUENCE {
+ *     modulus            INTEGER,  -- n
+ *     publicExponent     INTEGER   -- e
+ * }
+ *
+ * Verify an RSA signature with the key context on the stack, the RSASSA-PSS
+ * parameters being read from the signature algorithm parameters.
+ */
+static int verify_rsa(mbedtls_pk_type_t sig_pk_alg,
+		      mbedtls_asn1_buf *sig_params,
+		      mbedtls_md_type_t md_alg,
+		      const unsigned char *hash, unsigned int hash_len,
+		      unsigned char *key, size_t key_len,
+		      const unsigned char *sig, size_t sig_len)
+{
+	mbedtls_rsa_context rsa;
+	mbedtls_md_type_t mgf1_md_alg, pss_md_alg;
+	unsigned char *p, *end;
+	size_t len;
+	int salt_len, rc;
+
+	mbedtls_rsa_init(&rsa, MBEDTLS_RSA_PKCS_V15, 0);
+
+	p = key;
+	end = key + key_len;
+	rc = mbedtls_asn1_get_tag(&p, end, &len, MBEDTLS_ASN1_CONSTRUCTED |
+				  MBEDTLS_ASN1_SEQUENCE);
+	if ((rc != 0) || (p + len != end)) {
+		rc = CRYPTO_ERR_SIGNATURE;
+		goto exit;
+	}
+
+	if ((mbedtls_asn1_get_mpi(&p, end, &rsa.N) != 0) ||
+	    (mbedtls_asn1_get_mpi(&p, end, &rsa.E) != 0) || (p != end)) {
+		rc = CRYPTO_ERR_SIGNATURE;
+		goto exit;
+	}
+
+	rsa.len = mbedtls_mpi_size(&rsa.N);
+	if ((mbedtls_rsa_check_pubkey(&rsa) != 0) || (sig_len != rsa.len)) {
+		rc = CRYPTO_ERR_SIGNATURE;
+		goto exit;
+	}
+
+	if (sig_pk_alg == MBEDTLS_PK_RSASSA_PSS) {
+		rc = mbedtls_x509_get_rsassa_pss_params(sig_params, &pss_md_alg,
+							&mgf1_md_alg,
+							&salt_len);
+		if ((rc != 0) || (pss_md_alg != md_alg)) {
+			rc = CRYPTO_ERR_SIGNATURE;
+			goto exit;
+		}
+
+		rc = mbedtls_rsa_rsassa_pss_verify_ext(&rsa, NULL, NULL,
+						       MBEDTLS_RSA_PUBLIC,
+						       md_alg, hash_len, hash,
+						       mgf1_md_alg, salt_len,
+						       sig);
+	} else {
+		rc = mbedtls_rsa_pkcs1_verify(&rsa, NULL, NULL,
+					      MBEDTLS_RSA_PUBLIC, md_alg,
+					      hash_len, hash, sig);
+	}
+	rc = (rc == 0) ? CRYPTO_SUCCESS : CRYPTO_ERR_SIGNATURE;
+
+exit:
+	mbedtls_rsa_free(&rsa);
+	return rc;
+}
+#elif (TF_MBEDTLS_KEY_ALG_ID == TF_MBEDTLS_ECDSA)
+/*
+ * ECParameters ::= CHOICE {
+ *     namedCurve         OBJECT IDENTIFIER
+ * }
+ *
+ * Verify an ECDSA signature with the key context on the stack, the key being
+ * an uncompressed or compressed point of the named curve.
+ */
+static int verify_ecdsa(mbedtls_asn1_buf *pk_params,
+			const unsigned char *hash, unsigned int hash_len,
+			const unsigned char *key, size_t key_len,
+			const unsigned char *sig, size_t sig_len)
+{
+	mbedtls_ecdsa_context ecdsa;
+	mbedtls_ecp_group_id grp_id;
+	int rc;
+
+	if ((pk_params->tag != MBEDTLS_ASN1_OID) ||
+	    (mbedtls_oid_get_ec_grp(pk_params, &grp_id) != 0)) {
+		return CRYPTO_ERR_SIGNATURE;
+	}
+
+	mbedtls_ecdsa_init(&ecdsa);
+
+	if ((mbedtls_ecp_group_load(&ecdsa.grp, grp_id) != 0) ||
+	    (mbedtls_ecp_point_read_binary(&ecdsa.grp, &ecdsa.Q, key,
+					   key_len) != 0) ||
+	    (mbedtls_ecp_check_pubkey(&ecdsa.grp, &ecdsa.Q) != 0)) {
+		rc = CRYPTO_ERR_SIGNATURE;
+		goto exit;
+	}
+
+	rc = mbedtls_ecdsa_read_signature(&ecdsa, hash, hash_len, sig, sig_len);
+	rc = (rc == 0) ? CRYPTO_SUCCESS : CRYPTO_ERR_SIGNATURE;
+
+exit:
+	mbedtls_ecdsa_free(&ecdsa);
+	return rc;
+}
+#endif
+
 /*
  * Verify a signature.
  *
  * Parameters are passed using the DER encoding format following the ASN.1
- * structures detailed above.
+ * structures detailed above. The key and the signature are used where they
+ * are in the DER buffers rather than through the mbed TLS public key layer,
+ * which allocates the key context and the signature options on the heap.
  */
 static int verify_signature(void *data_ptr, unsigned int data_len,
 			    void *sig_ptr, unsigned int sig_len,
 			    void *sig_alg, unsigned int sig_alg_len,
 			    void *pk_ptr, unsigned int pk_len)
 {
-	mbedtls_asn1_buf sig_oid, sig_params;
+	mbedtls_asn1_buf sig_oid, sig_params, pk_params;
 	mbedtls_asn1_buf signature;
 	mbedtls_md_type_t md_alg;
-	mbedtls_pk_type_t pk_alg;
-	mbedtls_pk_context pk = {0};
+	mbedtls_pk_type_t sig_pk_alg, pk_alg;
 	int rc;
-	void *sig_opts = NULL;
 	const mbedtls_md_info_t *md_info;
-	unsigned char *p, *end;
+	unsigned char *p, *end, *key;
+	size_t key_len;
 	unsigned char hash[MBEDTLS_MD_MAX_SIZE];
 
 	/* Get pointers to signature OID and parameters */
@@ -76,19 +247,25 @@ static int verify_signature(void *data_ptr, unsigned int data_len,
 	}
 
 	/* Get the actual signature algorithm (MD + PK) */
-	rc = mbedtls_x509_get_sig_alg(&sig_oid, &sig_params, &md_alg, &pk_alg, &sig_opts);
+	rc = mbedtls_oid_get_sig_alg(&sig_oid, &md_alg, &sig_pk_alg);
 	if (rc != 0) {
 		return CRYPTO_ERR_SIGNATURE;
 	}
 
-	/* Parse the public key */
-	mbedtls_pk_init(&pk);
-	p = (unsigned char *)pk_ptr;
-	end = (unsigned char *)(p + pk_len);
-	rc = mbedtls_pk_parse_subpubkey(&p, end, &pk);
+	/*
+	 * Only RSASSA-PSS has parameters, the others must have them absent or
+	 * NULL (see mbedtls_x509_get_sig_alg())
+	 */
+	if ((sig_pk_alg != MBEDTLS_PK_RSASSA_PSS) &&
+	    (((sig_params.tag != MBEDTLS_ASN1_NULL) && (sig_params.tag != 0)) ||
+	     (sig_params.len != 0))) {
+		return CRYPTO_ERR_SIGNATURE;
+	}
+
+	/* Get the algorithm and the key from the public key */
+	rc = get_pk_info(pk_ptr, pk_len, &pk_alg, &pk_params, &key, &key_len);
 	if (rc != 0) {
-		rc = CRYPTO_ERR_SIGNATURE;
-		goto end2;
+		return rc;
 	}
 
 	/* Get the signature (bitstring) */
@@ -97,57 +274,52 @@ static int verify_signature(void *data_ptr, unsigned int data_len,
 	signature.tag = *p;
 	rc = mbedtls_asn1_get_bitstring_null(&p, end, &signature.len);
 	if (rc != 0) {
-		rc = CRYPTO_ERR_SIGNATURE;
-		goto end1;
+		return CRYPTO_ERR_SIGNATURE;
 	}
 	signature.p = p;
 
 	/* Calculate the hash of the data */
 	md_info = mbedtls_md_info_from_type(md_alg);
 	if (md_info == NULL) {
-		rc = CRYPTO_ERR_SIGNATURE;
-		goto end1;
+		return CRYPTO_ERR_SIGNATURE;
 	}
 	p = (unsigned char *)data_ptr;
 	rc = mbedtls_md(md_info, p, data_len, hash);
 	if (rc != 0) {
-		rc = CRYPTO_ERR_SIGNATURE;
-		goto end1;
+		return CRYPTO_ERR_SIGNATURE;
 	}
 
-	/* Verify the signature */
-	rc = mbedtls_pk_verify_ext(pk_alg, sig_opts, &pk, md_alg, hash,
-			mbedtls_md_get_size(md_info),
-			signature.p, signature.len);
-	if (rc != 0) {
-		rc = CRYPTO_ERR_SIGNATURE;
-		goto end1;
+	/* Verify the signature with the key algorithm of the build */
+#if (TF_MBEDTLS_KEY_ALG_ID == TF_MBEDTLS_RSA)
+	if ((pk_alg != MBEDTLS_PK_RSA) ||
+	    ((sig_pk_alg != MBEDTLS_PK_RSA) &&
+	     (sig_pk_alg != MBEDTLS_PK_RSASSA_PSS))) {
+		return CRYPTO_ERR_SIGNATURE;
 	}
 
-	/* Signature verification success */
-	rc = CRYPTO_SUCCESS;
+	return verify_rsa(sig_pk_alg, &sig_params, md_alg, hash,
+			  mbedtls_md_get_size(md_info), key, key_len,
+			  signature.p, signature.len);
+#elif (TF_MBEDTLS_KEY_ALG_ID == TF_MBEDTLS_ECDSA)
+	if ((pk_alg != MBEDTLS_PK_ECKEY) || (sig_pk_alg != MBEDTLS_PK_ECDSA)) {
+		return CRYPTO_ERR_SIGNATURE;
+	}
 
-end1:
-	mbedtls_pk_free(&pk);
-end2:
-	mbedtls_free(sig_opts);
-	return rc;
+	return verify_ecdsa(&pk_params, hash, mbedtls_md_get_size(md_info),
+			    key, key_len, signature.p, signature.len);
+#endif
 }
 
 /*
- * Match a hash
- *
- * Digest info is passed in DER format following the ASN.1 structure detailed
- * above.
+ * Parse a digest info to obtain the hash algorithm and the expected hash.
  */
-static int verify_hash(void *data_ptr, unsigned int data_len,
-		       void *digest_info_ptr, unsigned int digest_info_len)
+static int get_digest_info(void *digest_info_ptr, unsigned int digest_info_len,
+			   const mbedtls_md_info_t **md_info,
+			   unsigned char **hash)
 {
 	mbedtls_asn1_buf hash_oid, params;
 	mbedtls_md_type_t md_alg;
-	const mbedtls_md_info_t *md_info;
-	unsigned char *p, *end, *hash;
-	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	unsigned char *p, *end;
 	size_t len;
 	int rc;
 
@@ -171,8 +343,8 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 		return CRYPTO_ERR_HASH;
 	}
 
-	md_info = mbedtls_md_info_from_type(md_alg);
-	if (md_info == NULL) {
+	*md_info = mbedtls_md_info_from_type(md_alg);
+	if (*md_info == NULL) {
 		return CRYPTO_ERR_HASH;
 	}
 
@@ -183,10 +355,32 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 	}
 
 	/* Length of hash must match the algorithm's size */
-	if (len != mbedtls_md_get_size(md_info)) {
+	if (len != mbedtls_md_get_size(*md_info)) {
 		return CRYPTO_ERR_HASH;
 	}
-	hash = p;
+	*hash = p;
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Match a hash
+ *
+ * Digest info is passed in DER format following the ASN.1 structure detailed
+ * above.
+ */
+static int verify_hash(void *data_ptr, unsigned int data_len,
+		       void *digest_info_ptr, unsigned int digest_info_len)
+{
+	const mbedtls_md_info_t *md_info;
+	unsigned char *p, *hash;
+	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	int rc;
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len, &md_info, &hash);
+	if (rc != 0) {
+		return rc;
+	}
 
 	/* Calculate the hash of the data */
 	p = (unsigned char *)data_ptr;
@@ -204,7 +398,106 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 	return CRYPTO_SUCCESS;
 }
 
+/*
+ * Context of the hash computed incrementally by hash_init(), hash_update() and
+ * hash_final()
+ */
+static mbedtls_md_context_t hash_ctx;
+
+/*
+ * Start an incremental hash using the algorithm given in the digest info
+ */
+static int hash_init(void *digest_info_ptr, unsigned int digest_info_len)
+{
+	const mbedtls_md_info_t *md_info;
+	unsigned char *hash;
+	int rc;
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len, &md_info, &hash);
+	if (rc != 0) {
+		return rc;
+	}
+
+	mbedtls_md_init(&hash_ctx);
+	rc = mbedtls_md_setup(&hash_ctx, md_info, 0);
+	if (rc != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	rc = mbedtls_md_starts(&hash_ctx);
+	if (rc != 0) {
+		mbedtls_md_free(&hash_ctx);
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Add data to the incremental hash
+ */
+static int hash_update(void *data_ptr, unsigned int data_len)
+{
+	int rc;
+
+	rc = mbedtls_md_update(&hash_ctx, (unsigned char *)data_ptr, data_len);
+	if (rc != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Finish the incremental hash and match it against the digest info. The hash
+ * is discarded if no digest info is given.
+ */
+static int hash_final(void *digest_info_ptr, unsigned int digest_info_len)
+{
+	const mbedtls_md_info_t *md_info;
+	unsigned char *hash;
+	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	int rc;
+
+	rc = mbedtls_md_finish(&hash_ctx, data_hash);
+	if (rc != 0) {
+		rc = CRYPTO_ERR_HASH;
+		goto exit;
+	}
+
+	if (digest_info_ptr == NULL) {
+		rc = CRYPTO_ERR_HASH;
+		goto exit;
+	}
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len, &md_info, &hash);
+	if (rc != 0) {
+		goto exit;
+	}
+
+	/* The algorithm must be the one the hash was started with */
+	if (md_info != hash_ctx.md_info) {
+		rc = CRYPTO_ERR_HASH;
+		goto exit;
+	}
+
+	/* Compare values */
+	rc = memcmp(data_hash, hash, mbedtls_md_get_size(md_info));
+	if (rc != 0) {
+		rc = CRYPTO_ERR_HASH;
+		goto exit;
+	}
+
+	rc = CRYPTO_SUCCESS;
+
+exit:
+	mbedtls_md_free(&hash_ctx);
+	return rc;
+}
+
 /*
  * Register crypto library descriptor
  */
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash);
+REGISTER_CRYPTO_LIB_HASH(LIB_NAME, init, verify_signature, verify_hash,
+			 hash_init, hash_update, hash_final,
+			 mbedtls_heap_release);
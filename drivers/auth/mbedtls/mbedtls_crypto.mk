@@ -54,5 +54,22 @@ endif
 # Needs to be set to drive mbed TLS configuration correctly
 $(eval $(call add_define,TF_MBEDTLS_KEY_ALG_ID))
 
+# The platform may set 'TF_MBEDTLS_SHA256_CE' to compute SHA-256 with the ARMv8
+# Cryptographic Extension on the CPUs that implement it
+ifeq (${TF_MBEDTLS_SHA256_CE},)
+    TF_MBEDTLS_SHA256_CE	:=	0
+endif
+
+ifeq (${TF_MBEDTLS_SHA256_CE},1)
+    ifneq (${ARCH},aarch64)
+        $(error "TF_MBEDTLS_SHA256_CE is only supported on AArch64")
+    endif
+    MBEDTLS_CRYPTO_SOURCES	+=	drivers/auth/mbedtls/mbedtls_sha256_ce.c	\
+					drivers/auth/mbedtls/aarch64/sha256_ce.S
+endif
+
+$(eval $(call assert_boolean,TF_MBEDTLS_SHA256_CE))
+$(eval $(call add_define,TF_MBEDTLS_SHA256_CE))
+
 BL1_SOURCES			+=	${MBEDTLS_CRYPTO_SOURCES}
 BL2_SOURCES			+=	${MBEDTLS_CRYPTO_SOURCES}
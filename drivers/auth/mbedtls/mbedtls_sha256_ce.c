@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <mbedtls_common.h>
+#include <stdint.h>
+#include <string.h>
+
+/* mbed TLS headers */
+#include <mbedtls/sha256.h>
+
+/*
+ * SHA-256 block function of mbed TLS, used in place of its own implementation
+ * with MBEDTLS_SHA256_PROCESS_ALT. The blocks are processed with the ARMv8
+ * Cryptographic Extension when the CPU implements it, or with the generic C
+ * code below otherwise.
+ */
+
+void sha256_ce_process_blocks(uint32_t state[8], const unsigned char *data,
+			      unsigned int blocks, const uint32_t k[64]);
+
+/* Whether the CPU implements the SHA-256 instructions */
+static int sha256_ce_supported;
+
+/* SHA-256 round constants */
+static const uint32_t sha256_k[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+	0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+	0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+	0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#define ROTR(x, n)	(((x) >> (n)) | ((x) << (32 - (n))))
+#define CH(x, y, z)	(((x) & (y)) ^ (~(x) & (z)))
+#define MAJ(x, y, z)	(((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+#define EP0(x)		(ROTR(x, 2) ^ ROTR(x, 13) ^ ROTR(x, 22))
+#define EP1(x)		(ROTR(x, 6) ^ ROTR(x, 11) ^ ROTR(x, 25))
+#define SIG0(x)		(ROTR(x, 7) ^ ROTR(x, 18) ^ ((x) >> 3))
+#define SIG1(x)		(ROTR(x, 17) ^ ROTR(x, 19) ^ ((x) >> 10))
+
+static void sha256_process_c(uint32_t state[8], const unsigned char data[64])
+{
+	uint32_t w[64], s[8], t1, t2;
+	unsigned int i;
+
+	for (i = 0; i < 16; i++) {
+		w[i] = ((uint32_t)data[4 * i] << 24) |
+		       ((uint32_t)data[4 * i + 1] << 16) |
+		       ((uint32_t)data[4 * i + 2] << 8) |
+		       (uint32_t)data[4 * i + 3];
+	}
+
+	for (i = 16; i < 64; i++)
+		w[i] = SIG1(w[i - 2]) + w[i - 7] + SIG0(w[i - 15]) + w[i - 16];
+
+	memcpy(s, state, sizeof(s));
+
+	for (i = 0; i < 64; i++) {
+		t1 = s[7] + EP1(s[4]) + CH(s[4], s[5], s[6]) + sha256_k[i] +
+		     w[i];
+		t2 = EP0(s[0]) + MAJ(s[0], s[1], s[2]);
+		s[7] = s[6];
+		s[6] = s[5];
+		s[5] = s[4];
+		s[4] = s[3] + t1;
+		s[3] = s[2];
+		s[2] = s[1];
+		s[1] = s[0];
+		s[0] = t1 + t2;
+	}
+
+	for (i = 0; i < 8; i++)
+		state[i] += s[i];
+}
+
+void mbedtls_sha256_process(mbedtls_sha256_context *ctx,
+			    const unsigned char data[64])
+{
+	if (sha256_ce_supported)
+		sha256_ce_process_blocks(ctx->state, data, 1, sha256_k);
+	else
+		sha256_process_c(ctx->state, data);
+}
+
+/*
+ * Check whether the CPU implements the SHA-256 instructions, which must be
+ * the case of all the CPUs running the BL image. They are SIMD instructions,
+ * so their accesses are also enabled at EL1.
+ */
+void mbedtls_sha256_ce_init(void)
+{
+	unsigned int sha2;
+
+	sha2 = (read_id_aa64isar0_el1() >> ID_AA64ISAR0_SHA2_SHIFT) &
+		ID_AA64ISAR0_SHA2_MASK;
+	if (sha2 < ID_AA64ISAR0_SHA2_SHA256)
+		return;
+
+	if (IS_IN_EL1()) {
+		write_cpacr_el1(read_cpacr_el1() |
+				CPACR_EL1_FPEN(CPACR_EL1_FP_TRAP_NONE));
+		isb();
+	}
+
+	sha256_ce_supported = 1;
+}
@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <assert.h>
+#include <cassert.h>
+#include <console.h>
+#include <debug.h>
+#include <ehf.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <spinlock.h>
+#include <stdint.h>
+#include <utils_def.h>
+
+/* Size of the log buffer of each CPU */
+#ifndef PLAT_CONSOLE_BUFFER_SIZE
+#define PLAT_CONSOLE_BUFFER_SIZE	1024
+#endif
+
+CASSERT((PLAT_CONSOLE_BUFFER_SIZE & (PLAT_CONSOLE_BUFFER_SIZE - 1)) == 0,
+	assert_console_buffer_size_power_of_2);
+
+/*
+ * Log buffer of a CPU. Only the owning CPU writes characters to it, so this
+ * needs no lock. 'head' counts the characters ever written and 'tail' the
+ * ones already output to the console. The buffer keeps the last
+ * PLAT_CONSOLE_BUFFER_SIZE characters, which can be read back through
+ * console_buffer_read().
+ */
+typedef struct console_buffer {
+	volatile unsigned long long	head;
+	volatile unsigned long long	tail;
+#if CONSOLE_BUFFER_TX_IRQ
+	/* The '\r' of the '\n' at 'tail' has been output */
+	unsigned int			cr_sent;
+#endif
+	char				data[PLAT_CONSOLE_BUFFER_SIZE];
+} __aligned(CACHE_WRITEBACK_GRANULE) console_buffer_t;
+
+static console_buffer_t console_buffers[PLATFORM_CORE_COUNT] __runtime_bss;
+
+/* Serialises the output of the buffers to the console */
+static spinlock_t console_buffer_lock;
+
+/* Characters are output directly until the end of the cold boot */
+static int console_buffer_enabled;
+
+/* Output the characters of a buffer not yet sent to the console */
+static void console_buffer_drain(console_buffer_t *buf)
+{
+	unsigned long long head = buf->head;
+
+	if (head - buf->tail > PLAT_CONSOLE_BUFFER_SIZE)
+		buf->tail = head - PLAT_CONSOLE_BUFFER_SIZE;
+
+	while (buf->tail != head) {
+		(void)console_putc(buf->data[buf->tail %
+					     PLAT_CONSOLE_BUFFER_SIZE]);
+		buf->tail++;
+	}
+	(void)console_flush();
+#if CONSOLE_BUFFER_TX_IRQ
+	buf->cr_sent = 0;
+#endif
+}
+
+#if CONSOLE_BUFFER_TX_IRQ
+/*
+ * Output the characters of a buffer for as long as the transmit FIFO has room.
+ * Return 1 if characters are left in the buffer.
+ */
+static int console_buffer_drain_nowait(console_buffer_t *buf)
+{
+	unsigned long long head = buf->head;
+	char c;
+
+	if (head - buf->tail > PLAT_CONSOLE_BUFFER_SIZE) {
+		buf->tail = head - PLAT_CONSOLE_BUFFER_SIZE;
+		buf->cr_sent = 0;
+	}
+
+	while (buf->tail != head) {
+		c = buf->data[buf->tail % PLAT_CONSOLE_BUFFER_SIZE];
+		if ((c == '\n') && (buf->cr_sent == 0)) {
+			if (console_putc_nowait('\r') < 0)
+				return 1;
+			buf->cr_sent = 1;
+		}
+		if (console_putc_nowait(c) < 0)
+			return 1;
+		buf->cr_sent = 0;
+		buf->tail++;
+	}
+
+	return 0;
+}
+
+/*
+ * Fill the transmit FIFO from the buffers of all the CPUs, and let the transmit
+ * interrupt output the rest once the FIFO drains. Called with the lock held.
+ */
+static void console_buffer_kick(void)
+{
+	unsigned int i;
+	int pending = 0;
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+		pending |= console_buffer_drain_nowait(&console_buffers[i]);
+
+	console_set_tx_irq(pending);
+}
+
+/*
+ * Handler of the transmit interrupt of the console, registered with the EL3
+ * exception handling framework at the priority PLAT_CONSOLE_TX_PRI. The
+ * platform configures PLAT_CONSOLE_TX_IRQ as a Group 0 interrupt.
+ */
+static int console_buffer_tx_handler(uint32_t intr_raw, uint32_t flags,
+				     void *handle, void *cookie)
+{
+	assert(intr_raw == PLAT_CONSOLE_TX_IRQ);
+
+	spin_lock(&console_buffer_lock);
+	console_buffer_kick();
+	spin_unlock(&console_buffer_lock);
+
+	plat_ic_end_of_interrupt(intr_raw);
+
+	return 0;
+}
+#endif /* CONSOLE_BUFFER_TX_IRQ */
+
+/*
+ * Start buffering the characters printed by each CPU. This is called once the
+ * runtime console is set up on the primary CPU at the end of the cold boot, so
+ * that boot messages are not held in the buffer if BL31 hangs. With
+ * CONSOLE_BUFFER_TX_IRQ, the handler of the transmit interrupt is registered
+ * too.
+ */
+void console_buffer_start(void)
+{
+#if CONSOLE_BUFFER_TX_IRQ
+	if (ehf_register_priority_handler(PLAT_CONSOLE_TX_PRI,
+					  console_buffer_tx_handler) != 0) {
+		ERROR("Console: Failed to register the TX interrupt handler\n");
+		panic();
+	}
+#endif
+	console_buffer_enabled = 1;
+}
+
+int console_buffer_putc(int c)
+{
+	console_buffer_t *buf;
+
+	/*
+	 * The buffers are only coherent with the other CPUs once the data cache
+	 * is enabled, which is not the case early in the warm boot.
+	 */
+	if ((console_buffer_enabled == 0) ||
+	    ((read_sctlr_el3() & SCTLR_C_BIT) == 0))
+		return console_putc(c);
+
+	buf = &console_buffers[plat_my_core_pos()];
+
+	/* Output the buffer rather than dropping characters when it is full */
+	if (buf->head - buf->tail >= PLAT_CONSOLE_BUFFER_SIZE)
+		console_buffer_flush();
+
+	buf->data[buf->head % PLAT_CONSOLE_BUFFER_SIZE] = (char)c;
+
+	/* Make the character visible to readers before accounting for it */
+	dmbish();
+	buf->head++;
+
+#if CONSOLE_BUFFER_TX_IRQ
+	/* Start outputting each line as soon as it is complete */
+	if (c == '\n') {
+		spin_lock(&console_buffer_lock);
+		console_buffer_kick();
+		spin_unlock(&console_buffer_lock);
+	}
+#endif
+
+	return c;
+}
+
+/* Output the buffered characters of the calling CPU */
+void console_buffer_flush(void)
+{
+	console_buffer_t *buf = &console_buffers[plat_my_core_pos()];
+
+	if (buf->tail == buf->head)
+		return;
+
+	spin_lock(&console_buffer_lock);
+	console_buffer_drain(buf);
+	spin_unlock(&console_buffer_lock);
+}
+
+/* Output the buffered characters of all the CPUs */
+void console_buffer_flush_all(void)
+{
+	unsigned int i;
+
+	if (console_buffer_enabled == 0)
+		return;
+
+	spin_lock(&console_buffer_lock);
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+		console_buffer_drain(&console_buffers[i]);
+	spin_unlock(&console_buffer_lock);
+}
+
+/*
+ * Output the buffered characters of all the CPUs on a panic. The lock is not
+ * taken as it may be held by the panicking CPU, so the output of another CPU
+ * flushing its buffer at the same time may be interleaved. Nothing is buffered
+ * during the cold boot, when the buffers may not be initialised yet.
+ */
+void console_buffer_panic_flush(void)
+{
+	unsigned int i;
+
+	if (console_buffer_enabled == 0)
+		return;
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+		console_buffer_drain(&console_buffers[i]);
+}
+
+/*
+ * Copy up to 'len' characters of the log of a CPU, starting from the position
+ * '*pos' in the sequence of characters it has printed. If these have already
+ * been overwritten, start from the oldest character still in the buffer.
+ * Return the number of characters copied and update '*pos' to the position of
+ * the first one, or -1 if 'cpu_idx' is invalid.
+ */
+int console_buffer_read(unsigned int cpu_idx, unsigned long long *pos,
+			char *dst, unsigned int len)
+{
+	const console_buffer_t *buf;
+	unsigned long long head, start;
+	unsigned int count, i;
+
+	if (cpu_idx >= PLATFORM_CORE_COUNT)
+		return -1;
+
+	buf = &console_buffers[cpu_idx];
+	do {
+		head = buf->head;
+		dmbish();
+
+		start = MIN(*pos, head);
+		if (head - start > PLAT_CONSOLE_BUFFER_SIZE)
+			start = head - PLAT_CONSOLE_BUFFER_SIZE;
+
+		count = MIN(head - start, (unsigned long long)len);
+		for (i = 0; i < count; i++)
+			dst[i] = buf->data[(start + i) %
+					  PLAT_CONSOLE_BUFFER_SIZE];
+
+		/* Retry if the owning CPU overwrote the characters meanwhile */
+		dmbish();
+	} while (buf->head - start > PLAT_CONSOLE_BUFFER_SIZE);
+
+	*pos = start;
+	return count;
+}
@@ -4,8 +4,11 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <arch_helpers.h>
 #include <assert.h>
 #include <delay_timer.h>
+#include <errno.h>
+#include <mmio.h>
 #include <platform_def.h>
 
 /***********************************************************
@@ -14,32 +17,73 @@
 static const timer_ops_t *ops;
 
 /***********************************************************
- * Delay for the given number of microseconds. The driver must
- * be initialized before calling this function.
+ * Start a timeout expiring after the given number of
+ * microseconds. The driver must be initialized before calling
+ * this function.
  ***********************************************************/
-void udelay(uint32_t usec)
+void timeout_init_us(timeout_t *timeout, uint32_t usec)
 {
 	assert(ops != 0 &&
 		(ops->clk_mult != 0) &&
 		(ops->clk_div != 0) &&
 		(ops->get_timer_value != 0));
 
-	uint32_t start, delta, total_delta;
-
 	assert(usec < UINT32_MAX / ops->clk_div);
 
-	start = ops->get_timer_value();
+	timeout->start = ops->get_timer_value();
+	timeout->ticks = (usec * ops->clk_div) / ops->clk_mult;
+}
+
+/***********************************************************
+ * Return 1 if the given timeout has expired, 0 otherwise.
+ ***********************************************************/
+int timeout_elapsed(const timeout_t *timeout)
+{
+	/*
+	 * If the timer value wraps around, the subtraction will
+	 * overflow and it will still give the correct result.
+	 */
+	uint32_t delta = timeout->start - ops->get_timer_value();
 
-	total_delta = (usec * ops->clk_div) / ops->clk_mult;
+	return delta >= timeout->ticks; /* Decreasing counter */
+}
 
-	do {
-		/*
-		 * If the timer value wraps around, the subtraction will
-		 * overflow and it will still give the correct result.
-		 */
-		delta = start - ops->get_timer_value(); /* Decreasing counter */
+/***********************************************************
+ * Delay for the given number of microseconds. The driver must
+ * be initialized before calling this function.
+ ***********************************************************/
+void udelay(uint32_t usec)
+{
+	timeout_t timeout;
+
+	timeout_init_us(&timeout, usec);
+
+	/* Let other hardware threads of the core run meanwhile */
+	while (!timeout_elapsed(&timeout))
+		yield();
+}
+
+/***********************************************************
+ * Wait until the bits of the register at 'addr' selected by
+ * 'mask' read as 'val'. Return 0 once they do, or -ETIMEDOUT
+ * if they still do not after the given number of
+ * microseconds. The driver must be initialized before calling
+ * this function.
+ ***********************************************************/
+int mmio_poll_timeout_32(uintptr_t addr, uint32_t mask, uint32_t val,
+			 uint32_t usec)
+{
+	timeout_t timeout;
 
-	} while (delta < total_delta);
+	timeout_init_us(&timeout, usec);
+	while ((mmio_read_32(addr) & mask) != val) {
+		/* Check the register once more after the timeout expires */
+		if (timeout_elapsed(&timeout))
+			return ((mmio_read_32(addr) & mask) == val) ?
+				0 : -ETIMEDOUT;
+		yield();
+	}
+	return 0;
 }
 
 /***********************************************************
@@ -18,6 +18,13 @@ static const emmc_ops_t *ops;
 static unsigned int emmc_ocr_value;
 static emmc_csd_t emmc_csd;
 static unsigned int emmc_flags;
+/* Size of the read started by emmc_read_blocks_start(), if any */
+static size_t emmc_pending_size;
+static unsigned char emmc_ext_csd[EMMC_BLOCK_SIZE] __aligned(EMMC_BLOCK_SIZE);
+/* Set once emmc_ext_csd holds the EXT_CSD register of the device */
+static int emmc_ext_csd_valid;
+/* PARTITION_CONFIG of the device, read with the EXT_CSD register when needed */
+static int emmc_part_config = -1;
 
 static int is_cmd23_enabled(void)
 {
@@ -76,13 +83,152 @@ static void emmc_set_ios(int clk, int bus_width)
 	(void)ret;
 }
 
+static void emmc_read_ext_csd(void)
+{
+	emmc_cmd_t cmd;
+	uintptr_t buf = (uintptr_t)emmc_ext_csd;
+	int ret;
+
+	inv_dcache_range(buf, EMMC_BLOCK_SIZE);
+	ret = ops->prepare(0, buf, EMMC_BLOCK_SIZE);
+	assert(ret == 0);
+
+	zeromem(&cmd, sizeof(emmc_cmd_t));
+	cmd.cmd_idx = EMMC_CMD8;
+	cmd.resp_type = EMMC_RESPONSE_R1;
+	ret = ops->send_cmd(&cmd);
+	assert(ret == 0);
+
+	ret = ops->read(0, buf, EMMC_BLOCK_SIZE);
+	assert(ret == 0);
+
+	/* wait buffer empty */
+	emmc_device_state();
+	inv_dcache_range(buf, EMMC_BLOCK_SIZE);
+	emmc_ext_csd_valid = 1;
+	/* Ignore improbable errors in release builds */
+	(void)ret;
+}
+
+/*
+ * Switch the device to the HS_TIMING value hs_timing, then the host to the
+ * matching timing and clock rate.
+ */
+static void emmc_switch_timing(unsigned int hs_timing, int timing, int clk,
+			       int bus_width)
+{
+	int ret;
+
+	emmc_set_ext_csd(CMD_EXTCSD_HS_TIMING, hs_timing);
+	if (ops->set_timing != 0) {
+		ret = ops->set_timing(timing);
+		assert(ret == 0);
+	}
+	ret = ops->set_ios(clk, bus_width);
+	assert(ret == 0);
+	/* Ignore improbable errors in release builds */
+	(void)ret;
+}
+
+static int emmc_select_hs200(int bus_width)
+{
+	int ret;
+
+	emmc_switch_timing(EMMC_HS_TIMING_HS200, EMMC_TIMING_HS200,
+			   EMMC_HS200_CLK_RATE, bus_width);
+	ret = ops->execute_tuning(bus_width);
+	if (ret == 0)
+		return 0;
+
+	/* Lower the clock and fall back to high speed to try other timings */
+	WARN("eMMC: HS200 tuning failed (%d)\n", ret);
+	ret = ops->set_ios(EMMC_HS_CLK_RATE, bus_width);
+	assert(ret == 0);
+	emmc_switch_timing(EMMC_HS_TIMING_HS, EMMC_TIMING_HS,
+			   EMMC_HS_CLK_RATE, bus_width);
+	return -EIO;
+}
+
+static void emmc_select_hs400(void)
+{
+	int ret;
+
+	/*
+	 * HS400 is entered from a tuned HS200 bus, going through high speed to
+	 * switch the bus to 8-bit DDR.
+	 */
+	ret = ops->set_ios(EMMC_HS_CLK_RATE, EMMC_BUS_WIDTH_8);
+	assert(ret == 0);
+	emmc_switch_timing(EMMC_HS_TIMING_HS, EMMC_TIMING_HS,
+			   EMMC_HS_CLK_RATE, EMMC_BUS_WIDTH_8);
+	emmc_set_ext_csd(CMD_EXTCSD_BUS_WIDTH, EMMC_BUS_WIDTH_DDR_8);
+	emmc_switch_timing(EMMC_HS_TIMING_HS400, EMMC_TIMING_HS400,
+			   EMMC_HS200_CLK_RATE, EMMC_BUS_WIDTH_8);
+	/* Ignore improbable errors in release builds */
+	(void)ret;
+}
+
+/*
+ * Select the fastest bus timing supported by both the device and the host,
+ * the latter being described by the EMMC_FLAG_* timing flags given by the
+ * platform. The bus stays in legacy timing when no flag is set.
+ */
+static void emmc_select_timing(int bus_width)
+{
+	unsigned int type;
+	int wide, tuning, ret;
+
+	if ((emmc_csd.spec_vers != 4) ||
+	    ((emmc_flags & (EMMC_FLAG_HS | EMMC_FLAG_DDR52 |
+			    EMMC_FLAG_HS200 | EMMC_FLAG_HS400)) == 0))
+		return;
+
+	if (!emmc_ext_csd_valid)
+		emmc_read_ext_csd();
+	type = emmc_ext_csd[CMD_EXTCSD_DEVICE_TYPE];
+	wide = (bus_width != EMMC_BUS_WIDTH_1);
+	tuning = (ops->set_timing != 0) && (ops->execute_tuning != 0);
+
+	if (tuning && wide &&
+	    (emmc_flags & (EMMC_FLAG_HS200 | EMMC_FLAG_HS400)) &&
+	    (type & (EMMC_DEVICE_TYPE_HS200_1V8 |
+		     EMMC_DEVICE_TYPE_HS400_1V8)) &&
+	    (emmc_select_hs200(bus_width) == 0)) {
+		if ((emmc_flags & EMMC_FLAG_HS400) &&
+		    (type & EMMC_DEVICE_TYPE_HS400_1V8) &&
+		    (bus_width == EMMC_BUS_WIDTH_8)) {
+			emmc_select_hs400();
+			INFO("eMMC: HS400 timing\n");
+		} else {
+			INFO("eMMC: HS200 timing\n");
+		}
+		return;
+	}
+
+	if ((emmc_flags & EMMC_FLAG_DDR52) && (ops->set_timing != 0) && wide &&
+	    (type & EMMC_DEVICE_TYPE_DDR_52_1V8)) {
+		emmc_switch_timing(EMMC_HS_TIMING_HS, EMMC_TIMING_HS,
+				   EMMC_HS_CLK_RATE, bus_width);
+		emmc_set_ext_csd(CMD_EXTCSD_BUS_WIDTH,
+				 (bus_width == EMMC_BUS_WIDTH_8) ?
+				 EMMC_BUS_WIDTH_DDR_8 : EMMC_BUS_WIDTH_DDR_4);
+		ret = ops->set_timing(EMMC_TIMING_DDR52);
+		assert(ret == 0);
+		INFO("eMMC: DDR52 timing\n");
+	} else if (type & EMMC_DEVICE_TYPE_HS_52) {
+		emmc_switch_timing(EMMC_HS_TIMING_HS, EMMC_TIMING_HS,
+				   EMMC_HS_CLK_RATE, bus_width);
+		INFO("eMMC: high speed timing\n");
+	}
+	/* Ignore improbable errors in release builds */
+	(void)ret;
+}
+
 static int emmc_enumerate(int clk, int bus_width)
 {
 	emmc_cmd_t cmd;
 	int ret, state;
 
-	ops->init();
-
 	/* CMD0: reset to IDLE */
 	zeromem(&cmd, sizeof(emmc_cmd_t));
 	cmd.cmd_idx = EMMC_CMD0;
@@ -140,10 +286,59 @@ static int emmc_enumerate(int clk, int bus_width)
 	} while (state != EMMC_STATE_TRAN);
 
 	emmc_set_ios(clk, bus_width);
+	emmc_select_timing(bus_width);
 	return ret;
 }
 
-size_t emmc_read_blocks(int lba, uintptr_t buf, size_t size)
+/*
+ * Take over a device left in transfer state by an earlier boot stage, with the
+ * relative address EMMC_FIX_RCA, skipping its identification. The access mode
+ * and the version that the identification would give are deduced from the
+ * EXT_CSD register instead, which only eMMC 4.0 and later devices have. Return
+ * 0 on success, or -ENODEV if the device must be enumerated.
+ */
+static int emmc_resume(int clk, int bus_width)
+{
+	emmc_cmd_t cmd;
+	unsigned long long sec_count;
+
+	/* CMD13: check that the device is already selected */
+	zeromem(&cmd, sizeof(emmc_cmd_t));
+	cmd.cmd_idx = EMMC_CMD13;
+	cmd.cmd_arg = EMMC_FIX_RCA << RCA_SHIFT_OFFSET;
+	cmd.resp_type = EMMC_RESPONSE_R1;
+	if ((ops->send_cmd(&cmd) != 0) ||
+	    (EMMC_GET_STATE(cmd.resp_data[0]) != EMMC_STATE_TRAN))
+		return -ENODEV;
+
+	/*
+	 * Match the bus width of the device before reading the EXT_CSD
+	 * register, as the earlier stage may have widened it.
+	 */
+	emmc_csd.spec_vers = 4;
+	emmc_set_ios(clk, bus_width);
+	emmc_read_ext_csd();
+
+	/* Only the devices larger than 2GB use the sector access mode */
+	sec_count = emmc_ext_csd[CMD_EXTCSD_SEC_CNT] |
+		    (emmc_ext_csd[CMD_EXTCSD_SEC_CNT + 1] << 8) |
+		    (emmc_ext_csd[CMD_EXTCSD_SEC_CNT + 2] << 16) |
+		    ((unsigned long long)emmc_ext_csd[CMD_EXTCSD_SEC_CNT + 3]
+		     << 24);
+	emmc_ocr_value = (sec_count > EMMC_BYTE_MODE_MAX_SECTORS) ?
+			 OCR_SECTOR_MODE : OCR_BYTE_MODE;
+	emmc_part_config = emmc_ext_csd[CMD_EXTCSD_PARTITION_CONFIG];
+
+	emmc_select_timing(bus_width);
+	return 0;
+}
+
+/*
+ * Issue a multiple block read and return as soon as the command has been
+ * accepted, leaving the data transfer to the controller DMA. The transfer must
+ * be completed with emmc_read_blocks_wait() before any other eMMC access.
+ */
+int emmc_read_blocks_start(int lba, uintptr_t buf, size_t size)
 {
 	emmc_cmd_t cmd;
 	int ret;
@@ -151,7 +346,8 @@ size_t emmc_read_blocks(int lba, uintptr_t buf, size_t size)
 	assert((ops != 0) &&
 	       (ops->read != 0) &&
 	       ((buf & EMMC_BLOCK_MASK) == 0) &&
-	       ((size & EMMC_BLOCK_MASK) == 0));
+	       ((size & EMMC_BLOCK_MASK) == 0) &&
+	       (emmc_pending_size == 0));
 
 	inv_dcache_range(buf, size);
 	ret = ops->prepare(lba, buf, size);
@@ -185,6 +381,21 @@ size_t emmc_read_blocks(int lba, uintptr_t buf, size_t size)
 	ret = ops->read(lba, buf, size);
 	assert(ret == 0);
 
+	emmc_pending_size = size;
+	/* Ignore improbable errors in release builds */
+	(void)ret;
+	return 0;
+}
+
+/* Wait for the read issued by emmc_read_blocks_start() to complete */
+size_t emmc_read_blocks_wait(void)
+{
+	emmc_cmd_t cmd;
+	size_t size = emmc_pending_size;
+	int ret;
+
+	assert(size != 0);
+
 	/* wait buffer empty */
 	emmc_device_state();
 
@@ -194,13 +405,20 @@ size_t emmc_read_blocks(int lba, uintptr_t buf, size_t size)
 			cmd.cmd_idx = EMMC_CMD12;
 			ret = ops->send_cmd(&cmd);
 			assert(ret == 0);
+			/* Ignore improbable errors in release builds */
+			(void)ret;
 		}
 	}
-	/* Ignore improbable errors in release builds */
-	(void)ret;
+	emmc_pending_size = 0;
 	return size;
 }
 
+size_t emmc_read_blocks(int lba, uintptr_t buf, size_t size)
+{
+	emmc_read_blocks_start(lba, buf, size);
+	return emmc_read_blocks_wait();
+}
+
 size_t emmc_write_blocks(int lba, const uintptr_t buf, size_t size)
 {
 	emmc_cmd_t cmd;
@@ -297,17 +515,47 @@ size_t emmc_erase_blocks(int lba, size_t size)
 	return size;
 }
 
+static void emmc_set_part_config(unsigned int value)
+{
+	emmc_set_ext_csd(CMD_EXTCSD_PARTITION_CONFIG, value);
+	emmc_part_config = value;
+}
+
+/*
+ * Select the partition accessed by the following reads, writes and erases,
+ * one of the EMMC_PART_* values, keeping the boot configuration of the device.
+ * Nothing is sent to the device if the partition is already selected.
+ */
+void emmc_select_partition(unsigned int part)
+{
+	unsigned int config;
+
+	assert((ops != 0) &&
+	       (part <= PART_CFG_PARTITION_ACCESS_MASK) &&
+	       (emmc_pending_size == 0));
+
+	if (emmc_part_config < 0) {
+		emmc_read_ext_csd();
+		emmc_part_config = emmc_ext_csd[CMD_EXTCSD_PARTITION_CONFIG];
+	}
+
+	config = emmc_part_config;
+	if ((config & PART_CFG_PARTITION_ACCESS_MASK) == part)
+		return;
+
+	config &= ~PART_CFG_PARTITION_ACCESS_MASK;
+	emmc_set_part_config(config | part);
+}
+
 static inline void emmc_rpmb_enable(void)
 {
-	emmc_set_ext_csd(CMD_EXTCSD_PARTITION_CONFIG,
-			PART_CFG_BOOT_PARTITION1_ENABLE |
-			PART_CFG_PARTITION1_ACCESS);
+	emmc_set_part_config(PART_CFG_BOOT_PARTITION1_ENABLE |
+			     PART_CFG_PARTITION1_ACCESS);
 }
 
 static inline void emmc_rpmb_disable(void)
 {
-	emmc_set_ext_csd(CMD_EXTCSD_PARTITION_CONFIG,
-			PART_CFG_BOOT_PARTITION1_ENABLE);
+	emmc_set_part_config(PART_CFG_BOOT_PARTITION1_ENABLE);
 }
 
 size_t emmc_rpmb_read_blocks(int lba, uintptr_t buf, size_t size)
@@ -357,5 +605,10 @@ void emmc_init(const emmc_ops_t *ops_ptr, int clk, int width,
 	ops = ops_ptr;
 	emmc_flags = flags;
 
+	ops->init();
+
+	if ((flags & EMMC_FLAG_PREINIT) && (emmc_resume(clk, width) == 0))
+		return;
+
 	emmc_enumerate(clk, width);
 }
@@ -14,11 +14,38 @@
 #include <string.h>
 #include <utils.h>
 
+/* Maximum number of blocks held by the block cache of a device */
+#ifndef PLAT_IO_BLOCK_CACHE_MAX_BLOCKS
+# define PLAT_IO_BLOCK_CACHE_MAX_BLOCKS	8
+#endif
+
 typedef struct {
 	io_block_dev_spec_t	*dev_spec;
 	uintptr_t		base;
 	size_t			file_pos;
 	size_t			size;
+	/*
+	 * Length of the read issued by block_read_start() and not yet waited
+	 * for, and how much of it is still in flight on the device.
+	 */
+	size_t			pending_length;
+	size_t			async_length;
+	/*
+	 * LBA held by each block of the cache and when it was last used. A
+	 * zero stamp marks an empty block.
+	 */
+	int			cache_lba[PLAT_IO_BLOCK_CACHE_MAX_BLOCKS];
+	unsigned int		cache_stamp[PLAT_IO_BLOCK_CACHE_MAX_BLOCKS];
+	unsigned int		cache_clock;
+	/*
+	 * Device offset following the last read, and the blocks held by the
+	 * read-ahead region, still in flight on the device if ra_pending is
+	 * set.
+	 */
+	size_t			next_pos;
+	int			ra_lba;
+	size_t			ra_length;
+	int			ra_pending;
 } block_dev_state_t;
 
 #define is_power_of_2(x)	((x != 0) && ((x & (x - 1)) == 0))
@@ -30,6 +57,9 @@ static int block_open(io_dev_info_t *dev_info, const uintptr_t spec,
 static int block_seek(io_entity_t *entity, int mode, ssize_t offset);
 static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		      size_t *length_read);
+static int block_read_start(io_entity_t *entity, uintptr_t buffer,
+			    size_t length);
+static int block_read_wait(io_entity_t *entity, size_t *length_read);
 static int block_write(io_entity_t *entity, const uintptr_t buffer,
 		       size_t length, size_t *length_written);
 static int block_close(io_entity_t *entity);
@@ -46,6 +76,8 @@ static const io_dev_funcs_t block_dev_funcs = {
 	.seek		= block_seek,
 	.size		= NULL,
 	.read		= block_read,
+	.read_start	= block_read_start,
+	.read_wait	= block_read_wait,
 	.write		= block_write,
 	.close		= block_close,
 	.dev_init	= NULL,
@@ -138,6 +170,8 @@ static int block_open(io_dev_info_t *dev_info, const uintptr_t spec,
 	cur->base = region->offset;
 	cur->size = region->length;
 	cur->file_pos = 0;
+	cur->pending_length = 0;
+	cur->async_length = 0;
 
 	entity->info = (uintptr_t)cur;
 	return 0;
@@ -167,15 +201,184 @@ static int block_seek(io_entity_t *entity, int mode, ssize_t offset)
 	return 0;
 }
 
+static unsigned int cache_blocks(const block_dev_state_t *cur)
+{
+	return cur->dev_spec->cache.length / cur->dev_spec->block_size;
+}
+
+static uintptr_t cache_block_addr(const block_dev_state_t *cur,
+				  unsigned int index)
+{
+	return cur->dev_spec->cache.offset +
+	       (uintptr_t)index * cur->dev_spec->block_size;
+}
+
+static void cache_touch(block_dev_state_t *cur, unsigned int index)
+{
+	if (++cur->cache_clock == 0) {
+		/* The clock wrapped around, start again with an empty cache */
+		zeromem(cur->cache_stamp, sizeof(cur->cache_stamp));
+		cur->cache_clock = 1;
+	}
+	cur->cache_stamp[index] = cur->cache_clock;
+}
+
+/*
+ * Return the address of a copy of block lba in the block cache, reading it
+ * from the device in place of the least recently used block if needed. Return
+ * 0 if the device has no cache.
+ */
+static uintptr_t cache_get_block(block_dev_state_t *cur, int lba)
+{
+	unsigned int blocks = cache_blocks(cur);
+	size_t count;
+	unsigned int index, victim = 0;
+
+	if (blocks == 0)
+		return 0;
+
+	for (index = 0; index < blocks; index++) {
+		if (cur->cache_stamp[index] == 0) {
+			victim = index;
+			continue;
+		}
+		if (cur->cache_lba[index] == lba) {
+			cache_touch(cur, index);
+			return cache_block_addr(cur, index);
+		}
+		if ((cur->cache_stamp[victim] != 0) &&
+		    (cur->cache_stamp[index] < cur->cache_stamp[victim]))
+			victim = index;
+	}
+
+	cur->cache_stamp[victim] = 0;
+	count = cur->dev_spec->ops.read(lba, cache_block_addr(cur, victim),
+					cur->dev_spec->block_size);
+	assert(count == cur->dev_spec->block_size);
+	(void)count;
+	cur->cache_lba[victim] = lba;
+	cache_touch(cur, victim);
+	return cache_block_addr(cur, victim);
+}
+
+/* Keep the block cache coherent with size bytes written from buf at lba */
+static void cache_write_blocks(block_dev_state_t *cur, int lba,
+			       uintptr_t buf, size_t size)
+{
+	unsigned int blocks = cache_blocks(cur);
+	size_t block_size = cur->dev_spec->block_size;
+	unsigned int index;
+	int last = lba + size / block_size;
+
+	for (index = 0; index < blocks; index++) {
+		if ((cur->cache_stamp[index] == 0) ||
+		    (cur->cache_lba[index] < lba) ||
+		    (cur->cache_lba[index] >= last))
+			continue;
+		if (cur->dev_spec->cache_write_through != 0)
+			memcpy((void *)cache_block_addr(cur, index),
+			       (void *)(buf + (cur->cache_lba[index] - lba) *
+					block_size),
+			       block_size);
+		else
+			cur->cache_stamp[index] = 0;
+	}
+}
+
+/* Wait for the read-ahead in flight, if any, so that the device is idle */
+static void readahead_wait(block_dev_state_t *cur)
+{
+	size_t count;
+
+	if (cur->ra_pending == 0)
+		return;
+
+	count = cur->dev_spec->ops.read_wait();
+	assert(count == cur->ra_length);
+	(void)count;
+	cur->ra_pending = 0;
+}
+
+/* Return whether the read-ahead region holds the data at device offset pos */
+static int readahead_hit(const block_dev_state_t *cur, size_t pos)
+{
+	size_t start = (size_t)cur->ra_lba * cur->dev_spec->block_size;
+
+	return (cur->ra_length != 0) && (pos >= start) &&
+	       (pos < start + cur->ra_length);
+}
+
+/*
+ * Copy up to length bytes from the read-ahead region if it holds the data at
+ * the current position, and return the number of bytes copied.
+ */
+static size_t readahead_copy(block_dev_state_t *cur, uintptr_t buffer,
+			     size_t length)
+{
+	size_t pos = cur->base + cur->file_pos;
+	size_t start = (size_t)cur->ra_lba * cur->dev_spec->block_size;
+	size_t count;
+
+	if (readahead_hit(cur, pos) == 0)
+		return 0;
+
+	readahead_wait(cur);
+	count = MIN(length, start + cur->ra_length - pos);
+	memcpy((void *)buffer,
+	       (void *)(cur->dev_spec->readahead.offset + pos - start), count);
+	return count;
+}
+
+/*
+ * Start reading the blocks from the current position up to the end of the
+ * region into the read-ahead region, unless it already holds them.
+ */
+static void readahead_start(block_dev_state_t *cur)
+{
+	io_block_dev_spec_t *dev_spec = cur->dev_spec;
+	size_t block_size = dev_spec->block_size;
+	size_t pos = cur->base + cur->file_pos;
+	size_t start, end, length;
+	int lba;
+
+	if ((dev_spec->readahead.length == 0) ||
+	    (dev_spec->ops.read_start == NULL) ||
+	    (dev_spec->ops.read_wait == NULL) ||
+	    (readahead_hit(cur, pos) != 0))
+		return;
+
+	lba = pos / block_size;
+	start = (size_t)lba * block_size;
+	end = cur->base + cur->size;
+	if (start >= end)
+		return;
+	length = MIN(dev_spec->readahead.length, end - start);
+
+	cur->ra_length = 0;
+	if (dev_spec->ops.read_start(lba, dev_spec->readahead.offset,
+				     length) != 0)
+		return;
+	cur->ra_lba = lba;
+	cur->ra_length = length;
+	cur->ra_pending = 1;
+}
+
+/*
+ * Read from the device. Whole blocks that can be transferred straight into the
+ * caller's buffer are read with a single call to ops->read(). Only the partial
+ * blocks at the head and the tail of the request, and the whole request if the
+ * caller's buffer can't be block aligned with the device, go through the block
+ * buffer.
+ */
 static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		      size_t *length_read)
 {
 	block_dev_state_t *cur;
 	io_block_spec_t *buf;
 	io_block_ops_t *ops;
-	size_t aligned_length, skip, count, left, padding, block_size;
-	int lba;
-	int buffer_not_aligned;
+	size_t skip, count, left, size, block_size;
+	uintptr_t src;
+	int lba, sequential;
 
 	assert(entity->info != (uintptr_t)NULL);
 	cur = (block_dev_state_t *)entity->info;
@@ -186,90 +389,133 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	       (length > 0) &&
 	       (ops->read != 0));
 
-	if ((buffer & (block_size - 1)) != 0) {
-		/*
-		 * buffer isn't aligned with block size.
-		 * Block device always relies on DMA operation.
-		 * It's better to make the buffer as block size aligned.
-		 */
-		buffer_not_aligned = 1;
-	} else {
-		buffer_not_aligned = 0;
-	}
+	/* A read following the previous one is likely followed by another */
+	sequential = (cur->base + cur->file_pos == cur->next_pos);
+	count = readahead_copy(cur, buffer, length);
+	buffer += count;
+	left = length - count;
+	cur->file_pos += count;
+	if (left > 0)
+		readahead_wait(cur);
 
-	skip = cur->file_pos % block_size;
-	aligned_length = ((skip + length) + (block_size - 1)) &
-			 ~(block_size - 1);
-	padding = aligned_length - (skip + length);
-	left = aligned_length;
-	do {
+	while (left > 0) {
 		lba = (cur->file_pos + cur->base) / block_size;
-		if (left >= buf->length) {
+		skip = cur->file_pos % block_size;
+		if ((skip == 0) && (left >= block_size) &&
+		    ((buffer & (block_size - 1)) == 0)) {
 			/*
-			 * Since left is larger, it's impossible to padding.
-			 *
-			 * If buffer isn't aligned, we need to use aligned
-			 * buffer instead.
+			 * Block device always relies on DMA operation. Both
+			 * the position and the buffer are block aligned, so
+			 * read all the whole blocks in place.
 			 */
-			if (skip || buffer_not_aligned) {
-				/*
-				 * The beginning address (file_pos) isn't
-				 * aligned with block size, we need to use
-				 * block buffer to read block. Since block
-				 * device is always relied on DMA operation.
-				 */
-				count = ops->read(lba, buf->offset,
-						  buf->length);
+			count = round_down(left, block_size);
+			src = 0;
+			if (count == block_size)
+				src = cache_get_block(cur, lba);
+			if (src != 0) {
+				memcpy((void *)buffer, (void *)src, count);
 			} else {
-				count = ops->read(lba, buffer, buf->length);
+				size = ops->read(lba, buffer, count);
+				assert(size == count);
 			}
-			assert(count == buf->length);
-			cur->file_pos += count - skip;
-			if (skip || buffer_not_aligned) {
-				/*
-				 * Since there's not aligned block size caused
-				 * by skip or not aligned buffer, block buffer
-				 * is used to store data.
-				 */
-				memcpy((void *)buffer,
-				       (void *)(buf->offset + skip),
-				       count - skip);
-			}
-			left = left - (count - skip);
 		} else {
-			if (skip || padding || buffer_not_aligned) {
-				/*
-				 * The beginning address (file_pos) isn't
-				 * aligned with block size, we have to read
-				 * full block by block buffer instead.
-				 * The size isn't aligned with block size.
-				 * Use block buffer to avoid overflow.
-				 *
-				 * If buffer isn't aligned, use block buffer
-				 * to avoid DMA error.
-				 */
-				count = ops->read(lba, buf->offset, left);
-			} else
-				count = ops->read(lba, buffer, left);
-			assert(count == left);
-			left = left - (skip + padding);
-			cur->file_pos += left;
-			if (skip || padding || buffer_not_aligned) {
-				/*
-				 * Since there's not aligned block size or
-				 * buffer, block buffer is used to store data.
-				 */
-				memcpy((void *)buffer,
-				       (void *)(buf->offset + skip),
-				       left);
+			/*
+			 * Use the block buffer. If the caller's buffer gets
+			 * block aligned after this block, only read this block
+			 * so that the following ones can be read in place.
+			 */
+			if (((buffer + block_size - skip) &
+			     (block_size - 1)) == 0)
+				size = block_size;
+			else
+				size = round_up(skip + left, block_size);
+			if (size > buf->length)
+				size = buf->length;
+			src = 0;
+			if (size == block_size)
+				src = cache_get_block(cur, lba);
+			if (src == 0) {
+				count = ops->read(lba, buf->offset, size);
+				assert(count == size);
+				src = buf->offset;
 			}
-			/* It's already the last block operation */
-			left = 0;
+			count = MIN(size - skip, left);
+			memcpy((void *)buffer, (void *)(src + skip), count);
 		}
-		skip = cur->file_pos % block_size;
-	} while (left > 0);
+		buffer += count;
+		left -= count;
+		cur->file_pos += count;
+	}
 	*length_read = length;
 
+	cur->next_pos = cur->base + cur->file_pos;
+	if (sequential != 0)
+		readahead_start(cur);
+	return 0;
+}
+
+/*
+ * Start a read. The transfer is left in flight if the device supports split
+ * reads and the request covers whole blocks of an aligned buffer, otherwise
+ * it is completed synchronously.
+ */
+static int block_read_start(io_entity_t *entity, uintptr_t buffer,
+			    size_t length)
+{
+	block_dev_state_t *cur;
+	io_block_ops_t *ops;
+	size_t block_size;
+	int lba;
+	int result;
+
+	assert(entity->info != (uintptr_t)NULL);
+	cur = (block_dev_state_t *)entity->info;
+	ops = &(cur->dev_spec->ops);
+	block_size = cur->dev_spec->block_size;
+	assert((length <= cur->size) &&
+	       (length > 0) &&
+	       (cur->pending_length == 0));
+
+	cur->async_length = 0;
+	if ((ops->read_start == NULL) || (ops->read_wait == NULL) ||
+	    ((buffer & (block_size - 1)) != 0) ||
+	    ((cur->file_pos & (block_size - 1)) != 0) ||
+	    ((length & (block_size - 1)) != 0) ||
+	    (readahead_hit(cur, cur->base + cur->file_pos) != 0))
+		return block_read(entity, buffer, length, &cur->pending_length);
+
+	readahead_wait(cur);
+
+	lba = (cur->file_pos + cur->base) / block_size;
+	result = ops->read_start(lba, buffer, length);
+	if (result != 0)
+		return result;
+
+	cur->async_length = length;
+	cur->pending_length = length;
+	cur->file_pos += length;
+	cur->next_pos = cur->base + cur->file_pos;
+	return 0;
+}
+
+/* Wait for the read issued by block_read_start() */
+static int block_read_wait(io_entity_t *entity, size_t *length_read)
+{
+	block_dev_state_t *cur;
+	size_t count;
+
+	assert(entity->info != (uintptr_t)NULL);
+	cur = (block_dev_state_t *)entity->info;
+
+	if (cur->async_length != 0) {
+		count = cur->dev_spec->ops.read_wait();
+		assert(count == cur->async_length);
+		(void)count;
+		cur->async_length = 0;
+	}
+
+	*length_read = cur->pending_length;
+	cur->pending_length = 0;
 	return 0;
 }
 
@@ -293,6 +539,10 @@ static int block_write(io_entity_t *entity, const uintptr_t buffer,
 	       (ops->read != 0) &&
 	       (ops->write != 0));
 
+	/* The read-ahead data may be overwritten */
+	readahead_wait(cur);
+	cur->ra_length = 0;
+
 	if ((buffer & (block_size - 1)) != 0) {
 		/*
 		 * buffer isn't aligned with block size.
@@ -328,8 +578,12 @@ static int block_write(io_entity_t *entity, const uintptr_t buffer,
 				       count - skip);
 				count = ops->write(lba, buf->offset,
 						   buf->length);
-			} else
+				cache_write_blocks(cur, lba, buf->offset,
+						   count);
+			} else {
 				count = ops->write(lba, buffer, buf->length);
+				cache_write_blocks(cur, lba, buffer, count);
+			}
 			assert(count == buf->length);
 			cur->file_pos += count - skip;
 			left = left - (count - skip);
@@ -352,8 +606,12 @@ static int block_write(io_entity_t *entity, const uintptr_t buffer,
 				       (void *)buffer,
 				       left - skip - padding);
 				count = ops->write(lba, buf->offset, left);
-			} else
+				cache_write_blocks(cur, lba, buf->offset,
+						   count);
+			} else {
 				count = ops->write(lba, buffer, left);
+				cache_write_blocks(cur, lba, buffer, count);
+			}
 			assert(count == left);
 			cur->file_pos += left - (skip + padding);
 			/* It's already the last block operation */
@@ -367,6 +625,8 @@ static int block_write(io_entity_t *entity, const uintptr_t buffer,
 
 static int block_close(io_entity_t *entity)
 {
+	/* Leave the device idle, the read-ahead data stays valid */
+	readahead_wait((block_dev_state_t *)entity->info);
 	entity->info = (uintptr_t)NULL;
 	return 0;
 }
@@ -374,7 +634,7 @@ static int block_close(io_entity_t *entity)
 static int block_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info)
 {
 	block_dev_state_t *cur;
-	io_block_spec_t *buffer;
+	io_block_spec_t *buffer, *cache;
 	io_dev_info_t *info;
 	size_t block_size;
 	int result;
@@ -393,10 +653,17 @@ static int block_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info)
 	       (is_power_of_2(block_size) != 0) &&
 	       ((buffer->offset % block_size) == 0) &&
 	       ((buffer->length % block_size) == 0));
+	cache = &(cur->dev_spec->cache);
+	assert(((cache->offset % block_size) == 0) &&
+	       ((cache->length % block_size) == 0) &&
+	       (cache_blocks(cur) <= PLAT_IO_BLOCK_CACHE_MAX_BLOCKS));
+	assert(((cur->dev_spec->readahead.offset % block_size) == 0) &&
+	       ((cur->dev_spec->readahead.length % block_size) == 0));
 
 	*dev_info = info;	/* cast away const */
 	(void)block_size;
 	(void)buffer;
+	(void)cache;
 	return 0;
 }
 
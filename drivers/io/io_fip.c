@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <arch_helpers.h>
 #include <assert.h>
 #include <bl_common.h>
 #include <debug.h>
@@ -12,6 +13,7 @@
 #include <io_driver.h>
 #include <io_fip.h>
 #include <io_storage.h>
+#include <lz4.h>
 #include <platform.h>
 #include <platform_def.h>
 #include <stdint.h>
@@ -34,12 +36,78 @@ typedef struct {
 	 */
 	unsigned int file_pos;
 	fip_toc_entry_t entry;
+	/* Backend handle of a read started by fip_file_read_start() */
+	uintptr_t pending_handle;
+#if FIP_COMPRESS_LZ4
+	/*
+	 * State of an entry flagged with TOC_ENTRY_FLAG_LZ4, 'file_pos' being
+	 * the position in the decompressed image. 'comp_pos' is the offset in
+	 * the payload of the data of the next block, whose size word has been
+	 * read in 'block_word'. The block decompressed in lz4_out_buf covers
+	 * 'cache_len' bytes of the image from 'cache_pos'.
+	 */
+	size_t image_size;
+	size_t comp_pos;
+	uint32_t block_word;
+	size_t cache_pos;
+	size_t cache_len;
+	/* Outcome of the read "started" by fip_file_read_start() */
+	int pending_result;
+	size_t pending_length;
+#endif
 } file_state_t;
 
+/*
+ * Maximum number of ToC entries kept in the in-memory index. Platforms with
+ * more images in their FIP can raise it from their makefile; a package that
+ * does not fit in the index is still accessible through a linear ToC scan.
+ */
+#ifndef PLAT_FIP_MAX_TOC_ENTRIES
+# define PLAT_FIP_MAX_TOC_ENTRIES	32
+#endif
+
+/* Number of hash slots, twice the number of entries to keep probing short */
+#define FIP_TOC_HASH_SLOTS	(2 * PLAT_FIP_MAX_TOC_ENTRIES)
+CASSERT(PLAT_FIP_MAX_TOC_ENTRIES < 256, assert_fip_toc_max_entries);
+
+/* Value of 'magic' in an index that describes a package */
+#define FIP_TOC_INDEX_MAGIC	0x46495049	/* "FIPI" */
+
+/*
+ * In-memory copy of the ToC built by fip_dev_init(). Each hash slot holds the
+ * index of an entry plus one, zero marking an empty slot. 'image_id' is the
+ * image ID of the package, as passed to fip_dev_init().
+ */
+typedef struct {
+	unsigned int magic;
+	unsigned int image_id;
+	unsigned int complete;
+	fip_toc_entry_t entries[PLAT_FIP_MAX_TOC_ENTRIES];
+	uint8_t slots[FIP_TOC_HASH_SLOTS];
+} toc_index_t;
+
 static const uuid_t uuid_null = {0};
 static file_state_t current_file = {0};
 static uintptr_t backend_dev_handle;
 static uintptr_t backend_image_spec;
+#ifdef PLAT_FIP_TOC_INDEX_BASE
+/* The index is shared with the later boot stages, see fip_dev_init() */
+static toc_index_t *const toc_index = (toc_index_t *)PLAT_FIP_TOC_INDEX_BASE;
+#else
+static toc_index_t toc_index_mem;
+static toc_index_t *const toc_index = &toc_index_mem;
+#endif
+/* Set once the backend header has been checked and the ToC indexed */
+static int fip_dev_ready;
+#if FIP_PERSISTENT_BACKEND
+/* Backend handle kept open between fip_dev_init() and fip_dev_close() */
+static uintptr_t backend_handle_cache;
+#endif
+#if FIP_COMPRESS_LZ4
+/* Only one file is open at a time, so the block buffers can be shared */
+static uint8_t lz4_in_buf[FIP_LZ4_BLOCK_SIZE + sizeof(uint32_t)];
+static uint8_t lz4_out_buf[FIP_LZ4_BLOCK_SIZE];
+#endif
 
 
 /* Firmware Image Package driver functions */
@@ -49,6 +117,10 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 static int fip_file_len(io_entity_t *entity, size_t *length);
 static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 			  size_t *length_read);
+static int fip_file_read_start(io_entity_t *entity, uintptr_t buffer,
+			       size_t length);
+static int fip_file_read_wait(io_entity_t *entity, size_t *length_read);
+static int fip_file_map(io_entity_t *entity, size_t length, uintptr_t *addr);
 static int fip_file_close(io_entity_t *entity);
 static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params);
 static int fip_dev_close(io_dev_info_t *dev_info);
@@ -61,6 +133,317 @@ static inline int compare_uuids(const uuid_t *uuid1, const uuid_t *uuid2)
 }
 
 
+/*
+ * Obtain a handle to the backend holding the FIP. When the persistent backend
+ * mode is enabled, the handle opened by fip_dev_init() is reused so that image
+ * reads do not pay an open/close round trip on every call.
+ */
+static int fip_backend_open(uintptr_t *backend_handle)
+{
+#if FIP_PERSISTENT_BACKEND
+	if (backend_handle_cache != (uintptr_t)NULL) {
+		*backend_handle = backend_handle_cache;
+		return 0;
+	}
+#endif
+	return io_open(backend_dev_handle, backend_image_spec, backend_handle);
+}
+
+
+/* Release a handle obtained through fip_backend_open() */
+static void fip_backend_close(uintptr_t backend_handle)
+{
+#if FIP_PERSISTENT_BACKEND
+	if (backend_handle == backend_handle_cache)
+		return;
+#endif
+	io_close(backend_handle);
+}
+
+
+#if FIP_COMPRESS_LZ4
+/* Read exactly 'length' bytes at 'offset' in the payload of the open file */
+static int lz4_read_payload(uintptr_t backend_handle, const file_state_t *fp,
+			    size_t offset, uintptr_t buffer, size_t length)
+{
+	size_t bytes_read;
+	int result;
+
+	result = io_seek(backend_handle, IO_SEEK_SET,
+			 fp->entry.offset_address + offset);
+	if (result != 0)
+		return result;
+
+	result = io_read(backend_handle, buffer, length, &bytes_read);
+	if ((result == 0) && (bytes_read != length))
+		result = -EIO;
+
+	return result;
+}
+
+
+/*
+ * Check the LZ4 frame header of the open file and read the size word of its
+ * first block. Only the frames written by fiptool are supported. The header
+ * checksum is not verified, as the decompressed image is authenticated anyway
+ * with TBB.
+ */
+static int lz4_file_open(file_state_t *fp)
+{
+	uint8_t header[LZ4_FRAME_HEADER_SIZE + sizeof(uint32_t)];
+	uintptr_t backend_handle;
+	uint32_t magic;
+	uint64_t content_size;
+	uint8_t flg;
+	int result;
+
+	if (fp->entry.size < sizeof(header))
+		return -ENOENT;
+
+	result = fip_backend_open(&backend_handle);
+	if (result != 0) {
+		WARN("Failed to open FIP (%i)\n", result);
+		return -ENOENT;
+	}
+
+	result = lz4_read_payload(backend_handle, fp, 0, (uintptr_t)header,
+				  sizeof(header));
+	fip_backend_close(backend_handle);
+	if (result != 0) {
+		WARN("Failed to read LZ4 frame header (%i)\n", result);
+		return -ENOENT;
+	}
+
+	memcpy(&magic, &header[0], sizeof(magic));
+	flg = header[4];
+	memcpy(&content_size, &header[6], sizeof(content_size));
+
+	if ((magic != LZ4_FRAME_MAGIC) ||
+	    ((flg & LZ4_FLG_VERSION_MASK) != LZ4_FLG_VERSION) ||
+	    ((flg & LZ4_FLG_BLOCK_INDEP) == 0) ||
+	    ((flg & LZ4_FLG_CONTENT_SIZE) == 0) ||
+	    ((flg & (LZ4_FLG_BLOCK_CHECKSUM | LZ4_FLG_DICT_ID)) != 0) ||
+	    ((size_t)content_size != content_size)) {
+		WARN("Unsupported LZ4 frame in FIP\n");
+		return -ENOENT;
+	}
+
+	fp->image_size = content_size;
+	fp->comp_pos = sizeof(header);
+	memcpy(&fp->block_word, &header[LZ4_FRAME_HEADER_SIZE],
+	       sizeof(fp->block_word));
+
+	return 0;
+}
+
+
+/*
+ * Read 'length' bytes of the decompressed image at the current position. The
+ * blocks are decompressed straight into 'buffer' when it has room for a whole
+ * block, otherwise through lz4_out_buf, from which the next reads are served.
+ */
+static int lz4_file_read(file_state_t *fp, uintptr_t buffer, size_t length,
+			 size_t *length_read)
+{
+	uint8_t *dst = (uint8_t *)buffer;
+	uint8_t *out;
+	uintptr_t backend_handle;
+	size_t done = 0;
+	size_t block_size, left, n;
+	int result;
+
+	result = fip_backend_open(&backend_handle);
+	if (result != 0) {
+		WARN("Failed to open FIP (%i)\n", result);
+		return -ENOENT;
+	}
+
+	while (done < length) {
+		left = length - done;
+
+		/* Serve the data left in the last block decompressed */
+		if (fp->file_pos < (fp->cache_pos + fp->cache_len)) {
+			n = MIN(left, fp->cache_pos + fp->cache_len -
+				fp->file_pos);
+			memcpy(dst + done,
+			       lz4_out_buf + (fp->file_pos - fp->cache_pos), n);
+			done += n;
+			fp->file_pos += n;
+			continue;
+		}
+
+		/* The end mark is a block of size zero */
+		block_size = fp->block_word & LZ4_BLOCK_SIZE_MASK;
+		if (block_size == 0)
+			break;
+
+		if ((block_size > FIP_LZ4_BLOCK_SIZE) ||
+		    (fp->comp_pos > fp->entry.size) ||
+		    ((block_size + sizeof(uint32_t)) >
+		     (fp->entry.size - fp->comp_pos))) {
+			result = -EINVAL;
+			break;
+		}
+
+		/* Blocks stored as is are read in place if possible */
+		if (((fp->block_word & LZ4_BLOCK_UNCOMPRESSED) != 0) &&
+		    (left >= block_size)) {
+			result = lz4_read_payload(backend_handle, fp,
+						  fp->comp_pos,
+						  (uintptr_t)(dst + done),
+						  block_size);
+			if (result == 0)
+				result = lz4_read_payload(backend_handle, fp,
+						fp->comp_pos + block_size,
+						(uintptr_t)&fp->block_word,
+						sizeof(fp->block_word));
+			if (result != 0)
+				break;
+
+			fp->comp_pos += block_size + sizeof(uint32_t);
+			done += block_size;
+			fp->file_pos += block_size;
+			continue;
+		}
+
+		/* Read the block along with the size word of the next one */
+		result = lz4_read_payload(backend_handle, fp, fp->comp_pos,
+					  (uintptr_t)lz4_in_buf,
+					  block_size + sizeof(uint32_t));
+		if (result != 0)
+			break;
+
+		out = (left >= FIP_LZ4_BLOCK_SIZE) ? (dst + done) : lz4_out_buf;
+		if ((fp->block_word & LZ4_BLOCK_UNCOMPRESSED) != 0) {
+			memcpy(out, lz4_in_buf, block_size);
+			n = block_size;
+		} else {
+			result = lz4_decompress_block(lz4_in_buf, block_size,
+						      out, FIP_LZ4_BLOCK_SIZE,
+						      &n);
+			if (result != 0)
+				break;
+		}
+
+		fp->comp_pos += block_size + sizeof(uint32_t);
+		memcpy(&fp->block_word, lz4_in_buf + block_size,
+		       sizeof(fp->block_word));
+
+		if (out == lz4_out_buf) {
+			fp->cache_pos = fp->file_pos;
+			fp->cache_len = n;
+		} else {
+			done += n;
+			fp->file_pos += n;
+		}
+	}
+
+	fip_backend_close(backend_handle);
+
+	if (result != 0) {
+		WARN("Failed to decompress payload (%i)\n", result);
+		return -ENOENT;
+	}
+
+	*length_read = done;
+	return 0;
+}
+#endif /* FIP_COMPRESS_LZ4 */
+
+
+/* Fold a UUID into a slot number of the ToC hash table */
+static unsigned int uuid_hash(const uuid_t *uuid)
+{
+	const uint8_t *p = (const uint8_t *)uuid;
+	unsigned int hash = 0;
+	unsigned int i;
+
+	for (i = 0; i < sizeof(uuid_t); i++)
+		hash = (hash * 31) + p[i];
+
+	return hash % FIP_TOC_HASH_SLOTS;
+}
+
+
+/*
+ * Read the ToC from the backend, which must be positioned just past the FIP
+ * header, and index its entries by UUID. The index is only marked complete if
+ * the end-of-ToC marker was reached without running out of entries.
+ */
+static int toc_index_build(uintptr_t backend_handle)
+{
+	int result;
+	size_t fip_size;
+	size_t length;
+	size_t bytes_read;
+	unsigned int i, slot;
+	fip_toc_entry_t *entry;
+
+	zeromem(toc_index, sizeof(*toc_index));
+
+	/*
+	 * Read as much of the ToC as fits in the index in a single request,
+	 * without going past the end of the backend when its size is known.
+	 */
+	length = sizeof(toc_index->entries);
+	if (io_size(backend_handle, &fip_size) == 0) {
+		if (fip_size < sizeof(fip_toc_header_t))
+			return -ENOENT;
+		if (length > (fip_size - sizeof(fip_toc_header_t)))
+			length = fip_size - sizeof(fip_toc_header_t);
+	}
+
+	result = io_read(backend_handle, (uintptr_t)toc_index->entries, length,
+			 &bytes_read);
+	if (result != 0) {
+		WARN("Failed to read FIP ToC (%i)\n", result);
+		return result;
+	}
+
+	for (i = 0; i < (bytes_read / sizeof(fip_toc_entry_t)); i++) {
+		entry = &toc_index->entries[i];
+		if (compare_uuids(&entry->uuid, &uuid_null) == 0) {
+			toc_index->complete = 1;
+			break;
+		}
+
+		/* Keep the first occurrence, as the linear scan would */
+		slot = uuid_hash(&entry->uuid);
+		while (toc_index->slots[slot] != 0) {
+			if (compare_uuids(&toc_index->entries[
+					toc_index->slots[slot] - 1].uuid,
+					  &entry->uuid) == 0)
+				break;
+			slot = (slot + 1) % FIP_TOC_HASH_SLOTS;
+		}
+		if (toc_index->slots[slot] == 0)
+			toc_index->slots[slot] = i + 1;
+	}
+
+	if (toc_index->complete == 0)
+		VERBOSE("FIP ToC exceeds index, using linear lookups\n");
+
+	return 0;
+}
+
+
+/* Look up a UUID in the ToC index. Return NULL if it is not in the package */
+static const fip_toc_entry_t *toc_index_lookup(const uuid_t *uuid)
+{
+	unsigned int slot = uuid_hash(uuid);
+	const fip_toc_entry_t *entry;
+
+	while (toc_index->slots[slot] != 0) {
+		entry = &toc_index->entries[toc_index->slots[slot] - 1];
+		if (compare_uuids(&entry->uuid, uuid) == 0)
+			return entry;
+		slot = (slot + 1) % FIP_TOC_HASH_SLOTS;
+	}
+
+	return NULL;
+}
+
+
 /* TODO: We could check version numbers or do a package checksum? */
 static inline int is_valid_header(fip_toc_header_t *header)
 {
@@ -90,6 +473,9 @@ static const io_dev_funcs_t fip_dev_funcs = {
 	.seek = NULL,
 	.size = fip_file_len,
 	.read = fip_file_read,
+	.read_start = fip_file_read_start,
+	.read_wait = fip_file_read_wait,
+	.map = fip_file_map,
 	.write = NULL,
 	.close = fip_file_close,
 	.dev_init = fip_dev_init,
@@ -121,12 +507,13 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 	int result;
 	unsigned int image_id = (unsigned int)init_params;
 	uintptr_t backend_handle;
+	uintptr_t dev_handle;
+	uintptr_t image_spec;
 	fip_toc_header_t header;
 	size_t bytes_read;
 
 	/* Obtain a reference to the image by querying the platform layer */
-	result = plat_get_image_source(image_id, &backend_dev_handle,
-				       &backend_image_spec);
+	result = plat_get_image_source(image_id, &dev_handle, &image_spec);
 	if (result != 0) {
 		WARN("Failed to obtain reference to image id=%u (%i)\n",
 			image_id, result);
@@ -134,6 +521,57 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 		goto fip_dev_init_exit;
 	}
 
+	/*
+	 * The platform layer re-initialises the FIP device before each image
+	 * is loaded. There is nothing to do if the package has already been
+	 * checked and indexed, otherwise release any backend state left over
+	 * from a previous package.
+	 */
+	if ((fip_dev_ready != 0) && (dev_handle == backend_dev_handle) &&
+	    (image_spec == backend_image_spec)) {
+#if FIP_PERSISTENT_BACKEND
+		/* Reopen the backend closed by fip_dev_close() */
+		if ((backend_handle_cache == (uintptr_t)NULL) &&
+		    (io_open(backend_dev_handle, backend_image_spec,
+			     &backend_handle) == 0))
+			backend_handle_cache = backend_handle;
+#endif
+		return 0;
+	}
+
+#if defined(PLAT_FIP_TOC_INDEX_BASE) && !defined(IMAGE_BL1)
+	/*
+	 * The first time this image initialises the device, reuse the index
+	 * of the package left in memory by an earlier boot stage instead of
+	 * reading the FIP header and ToC again. BL1 always builds the index,
+	 * as the memory may hold the index of a previous boot.
+	 */
+	if ((backend_dev_handle == (uintptr_t)NULL) &&
+	    (toc_index->magic == FIP_TOC_INDEX_MAGIC) &&
+	    (toc_index->image_id == image_id)) {
+		backend_dev_handle = dev_handle;
+		backend_image_spec = image_spec;
+		fip_dev_ready = 1;
+#if FIP_PERSISTENT_BACKEND
+		if (io_open(backend_dev_handle, backend_image_spec,
+			    &backend_handle) == 0)
+			backend_handle_cache = backend_handle;
+#endif
+		return 0;
+	}
+#endif
+
+	fip_dev_ready = 0;
+#if FIP_PERSISTENT_BACKEND
+	if (backend_handle_cache != (uintptr_t)NULL) {
+		io_close(backend_handle_cache);
+		backend_handle_cache = (uintptr_t)NULL;
+	}
+#endif
+
+	backend_dev_handle = dev_handle;
+	backend_image_spec = image_spec;
+
 	/* Attempt to access the FIP image */
 	result = io_open(backend_dev_handle, backend_image_spec,
 			 &backend_handle);
@@ -151,9 +589,23 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 			result = -ENOENT;
 		} else {
 			VERBOSE("FIP header looks OK.\n");
+			result = toc_index_build(backend_handle);
 		}
 	}
 
+	if (result == 0) {
+		toc_index->image_id = image_id;
+		toc_index->magic = FIP_TOC_INDEX_MAGIC;
+#ifdef PLAT_FIP_TOC_INDEX_BASE
+		/* Later boot stages may read the index with their caches off */
+		flush_dcache_range((uintptr_t)toc_index, sizeof(*toc_index));
+#endif
+		fip_dev_ready = 1;
+#if FIP_PERSISTENT_BACKEND
+		backend_handle_cache = backend_handle;
+		return 0;
+#endif
+	}
 	io_close(backend_handle);
 
  fip_dev_init_exit:
@@ -165,10 +617,17 @@ static int fip_dev_close(io_dev_info_t *dev_info)
 {
 	/* TODO: Consider tracking open files and cleaning them up here */
 
-	/* Clear the backend. */
-	backend_dev_handle = (uintptr_t)NULL;
-	backend_image_spec = (uintptr_t)NULL;
+#if FIP_PERSISTENT_BACKEND
+	if (backend_handle_cache != (uintptr_t)NULL) {
+		io_close(backend_handle_cache);
+		backend_handle_cache = (uintptr_t)NULL;
+	}
+#endif
 
+	/*
+	 * Keep the ToC index. The package does not change while the images are
+	 * loaded, and the device is closed after each of them.
+	 */
 	return 0;
 }
 
@@ -180,6 +639,7 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 	int result;
 	uintptr_t backend_handle;
 	const io_uuid_spec_t *uuid_spec = (io_uuid_spec_t *)spec;
+	const fip_toc_entry_t *toc_entry;
 	size_t bytes_read;
 	int found_file = 0;
 
@@ -197,9 +657,29 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 		return -ENOMEM;
 	}
 
+	/* Resolve the file from the ToC index when it covers the package */
+	if (toc_index->complete != 0) {
+		toc_entry = toc_index_lookup(&uuid_spec->uuid);
+		if (toc_entry == NULL)
+			return -ENOENT;
+
+		current_file.entry = *toc_entry;
+		current_file.file_pos = 0;
+#if FIP_COMPRESS_LZ4
+		if ((current_file.entry.flags & TOC_ENTRY_FLAG_LZ4) != 0) {
+			result = lz4_file_open(&current_file);
+			if (result != 0) {
+				current_file.entry.offset_address = 0;
+				return result;
+			}
+		}
+#endif
+		entity->info = (uintptr_t)&current_file;
+		return 0;
+	}
+
 	/* Attempt to access the FIP image */
-	result = io_open(backend_dev_handle, backend_image_spec,
-			 &backend_handle);
+	result = fip_backend_open(&backend_handle);
 	if (result != 0) {
 		WARN("Failed to open Firmware Image Package (%i)\n", result);
 		result = -ENOENT;
@@ -246,7 +726,16 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 	}
 
  fip_file_open_close:
-	io_close(backend_handle);
+	fip_backend_close(backend_handle);
+
+#if FIP_COMPRESS_LZ4
+	if ((result == 0) &&
+	    ((current_file.entry.flags & TOC_ENTRY_FLAG_LZ4) != 0)) {
+		result = lz4_file_open(&current_file);
+		if (result != 0)
+			current_file.entry.offset_address = 0;
+	}
+#endif
 
  fip_file_open_exit:
 	return result;
@@ -259,6 +748,15 @@ static int fip_file_len(io_entity_t *entity, size_t *length)
 	assert(entity != NULL);
 	assert(length != NULL);
 
+#if FIP_COMPRESS_LZ4
+	/* Report the size of the decompressed image */
+	if ((((file_state_t *)entity->info)->entry.flags &
+	     TOC_ENTRY_FLAG_LZ4) != 0) {
+		*length = ((file_state_t *)entity->info)->image_size;
+		return 0;
+	}
+#endif
+
 	*length =  ((file_state_t *)entity->info)->entry.size;
 
 	return 0;
@@ -280,9 +778,14 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	assert(length_read != NULL);
 	assert(entity->info != (uintptr_t)NULL);
 
+#if FIP_COMPRESS_LZ4
+	fp = (file_state_t *)entity->info;
+	if ((fp->entry.flags & TOC_ENTRY_FLAG_LZ4) != 0)
+		return lz4_file_read(fp, buffer, length, length_read);
+#endif
+
 	/* Open the backend, attempt to access the blob image */
-	result = io_open(backend_dev_handle, backend_image_spec,
-			 &backend_handle);
+	result = fip_backend_open(&backend_handle);
 	if (result != 0) {
 		WARN("Failed to open FIP (%i)\n", result);
 		result = -ENOENT;
@@ -314,13 +817,156 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 
 /* Close the backend. */
  fip_file_read_close:
-	io_close(backend_handle);
+	fip_backend_close(backend_handle);
 
  fip_file_read_exit:
 	return result;
 }
 
 
+/*
+ * Start reading data from a file in package. The backend is left open, with
+ * the transfer possibly still in progress, until fip_file_read_wait().
+ */
+static int fip_file_read_start(io_entity_t *entity, uintptr_t buffer,
+			       size_t length)
+{
+	int result;
+	file_state_t *fp;
+	uintptr_t backend_handle;
+
+	assert(entity != NULL);
+	assert(buffer != (uintptr_t)NULL);
+	assert(entity->info != (uintptr_t)NULL);
+
+	fp = (file_state_t *)entity->info;
+	assert(fp->pending_handle == (uintptr_t)NULL);
+
+#if FIP_COMPRESS_LZ4
+	/*
+	 * The blocks are decompressed by the CPU as they are read, so the read
+	 * is done synchronously and only its outcome kept for
+	 * fip_file_read_wait().
+	 */
+	if ((fp->entry.flags & TOC_ENTRY_FLAG_LZ4) != 0) {
+		fp->pending_result = lz4_file_read(fp, buffer, length,
+						   &fp->pending_length);
+		/* Mark the read as pending, no backend handle is kept */
+		fp->pending_handle = (uintptr_t)&current_file;
+		return 0;
+	}
+#endif
+
+	result = fip_backend_open(&backend_handle);
+	if (result != 0) {
+		WARN("Failed to open FIP (%i)\n", result);
+		return -ENOENT;
+	}
+
+	result = io_seek(backend_handle, IO_SEEK_SET,
+			 fp->entry.offset_address + fp->file_pos);
+	if (result != 0) {
+		WARN("fip_file_read_start: failed to seek\n");
+		fip_backend_close(backend_handle);
+		return -ENOENT;
+	}
+
+	result = io_read_start(backend_handle, buffer, length);
+	if (result != 0) {
+		WARN("Failed to read payload (%i)\n", result);
+		fip_backend_close(backend_handle);
+		return -ENOENT;
+	}
+
+	fp->pending_handle = backend_handle;
+	return 0;
+}
+
+
+/* Wait for the read started by fip_file_read_start() */
+static int fip_file_read_wait(io_entity_t *entity, size_t *length_read)
+{
+	int result;
+	file_state_t *fp;
+	size_t bytes_read;
+
+	assert(entity != NULL);
+	assert(length_read != NULL);
+	assert(entity->info != (uintptr_t)NULL);
+
+	fp = (file_state_t *)entity->info;
+	assert(fp->pending_handle != (uintptr_t)NULL);
+
+#if FIP_COMPRESS_LZ4
+	if ((fp->entry.flags & TOC_ENTRY_FLAG_LZ4) != 0) {
+		fp->pending_handle = (uintptr_t)NULL;
+		if (fp->pending_result == 0)
+			*length_read = fp->pending_length;
+		return fp->pending_result;
+	}
+#endif
+
+	result = io_read_wait(fp->pending_handle, &bytes_read);
+	if (result != 0) {
+		WARN("Failed to read payload (%i)\n", result);
+		result = -ENOENT;
+	} else {
+		*length_read = bytes_read;
+		fp->file_pos += bytes_read;
+	}
+
+	fip_backend_close(fp->pending_handle);
+	fp->pending_handle = (uintptr_t)NULL;
+
+	return result;
+}
+
+
+/*
+ * Return the address of data in a file in package, when the backend holding
+ * the package is memory-mapped.
+ */
+static int fip_file_map(io_entity_t *entity, size_t length, uintptr_t *addr)
+{
+	int result;
+	file_state_t *fp;
+	uintptr_t backend_handle;
+
+	assert(entity != NULL);
+	assert(addr != NULL);
+	assert(entity->info != (uintptr_t)NULL);
+
+	fp = (file_state_t *)entity->info;
+
+#if FIP_COMPRESS_LZ4
+	/* Compressed files must be decompressed by fip_file_read() */
+	if ((fp->entry.flags & TOC_ENTRY_FLAG_LZ4) != 0)
+		return -ENODEV;
+#endif
+
+	if ((fp->file_pos > fp->entry.size) ||
+	    (length > (fp->entry.size - fp->file_pos)))
+		return -EINVAL;
+
+	result = fip_backend_open(&backend_handle);
+	if (result != 0) {
+		WARN("Failed to open FIP (%i)\n", result);
+		return -ENOENT;
+	}
+
+	result = io_seek(backend_handle, IO_SEEK_SET,
+			 fp->entry.offset_address + fp->file_pos);
+	if (result == 0)
+		result = io_map(backend_handle, length, addr);
+	if (result == 0)
+		fp->file_pos += length;
+
+	fip_backend_close(backend_handle);
+
+	return result;
+}
+
+
 /* Close a file in package */
 static int fip_file_close(io_entity_t *entity)
 {
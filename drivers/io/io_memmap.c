@@ -4,10 +4,13 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <arch_helpers.h>
 #include <assert.h>
 #include <debug.h>
 #include <io_driver.h>
+#include <io_memmap.h>
 #include <io_storage.h>
+#include <platform_def.h>
 #include <string.h>
 #include <utils.h>
 
@@ -27,6 +30,9 @@ typedef struct {
 
 static file_state_t current_file = {0};
 
+/* Optional DMA engine used to copy the data of the reads */
+static const io_memmap_dev_spec_t *memmap_dev_spec;
+
 /* Identify the device type as memmap */
 io_type_t device_type_memmap(void)
 {
@@ -44,6 +50,8 @@ static int memmap_block_read(io_entity_t *entity, uintptr_t buffer,
 			     size_t length, size_t *length_read);
 static int memmap_block_write(io_entity_t *entity, const uintptr_t buffer,
 			      size_t length, size_t *length_written);
+static int memmap_block_map(io_entity_t *entity, size_t length,
+			    uintptr_t *addr);
 static int memmap_block_close(io_entity_t *entity);
 static int memmap_dev_close(io_dev_info_t *dev_info);
 
@@ -60,6 +68,7 @@ static const io_dev_funcs_t memmap_dev_funcs = {
 	.size = memmap_block_len,
 	.read = memmap_block_read,
 	.write = memmap_block_write,
+	.map = memmap_block_map,
 	.close = memmap_block_close,
 	.dev_init = NULL,
 	.dev_close = memmap_dev_close,
@@ -74,12 +83,17 @@ static const io_dev_info_t memmap_dev_info = {
 
 
 /* Open a connection to the memmap device */
-static int memmap_dev_open(const uintptr_t dev_spec __unused,
+static int memmap_dev_open(const uintptr_t dev_spec,
 			   io_dev_info_t **dev_info)
 {
 	assert(dev_info != NULL);
 	*dev_info = (io_dev_info_t *)&memmap_dev_info; /* cast away const */
 
+	memmap_dev_spec = (const io_memmap_dev_spec_t *)dev_spec;
+	assert((memmap_dev_spec == NULL) || (memmap_dev_spec->copy != NULL));
+	assert((memmap_dev_spec == NULL) ||
+	       ((memmap_dev_spec->align & (memmap_dev_spec->align - 1)) == 0));
+
 	return 0;
 }
 
@@ -160,6 +174,53 @@ static int memmap_block_len(io_entity_t *entity, size_t *length)
 }
 
 
+/*
+ * Copy the data of a read, using the DMA engine of the device specification if
+ * there is one and the read is large enough.
+ */
+static void memmap_copy(uintptr_t dst, uintptr_t src, size_t length)
+{
+	size_t align, head, body;
+
+	if ((memmap_dev_spec == NULL) ||
+	    (length < memmap_dev_spec->min_length)) {
+		memcpy((void *)dst, (void *)src, length);
+		return;
+	}
+
+	/*
+	 * The part copied by the engine covers whole cache lines so that
+	 * invalidating them doesn't discard data around the buffer. This needs
+	 * the source and destination to be equally aligned.
+	 */
+	align = MAX(memmap_dev_spec->align, (size_t)CACHE_WRITEBACK_GRANULE);
+	head = round_up(dst, align) - dst;
+	if ((((dst - src) & (align - 1)) != 0) || (length - head < align)) {
+		memcpy((void *)dst, (void *)src, length);
+		return;
+	}
+	body = round_down(length - head, align);
+
+	/*
+	 * Clean the source so that the engine reads the data last written by
+	 * the CPU, and clean and invalidate the destination so that no dirty
+	 * line is evicted over the data written by the engine.
+	 */
+	flush_dcache_range(src + head, body);
+	flush_dcache_range(dst + head, body);
+	if (memmap_dev_spec->copy(dst + head, src + head, body) == 0) {
+		/* Discard the lines speculatively fetched during the copy */
+		inv_dcache_range(dst + head, body);
+	} else {
+		memcpy((void *)(dst + head), (void *)(src + head), body);
+	}
+
+	memcpy((void *)dst, (void *)src, head);
+	memcpy((void *)(dst + head + body), (void *)(src + head + body),
+	       length - head - body);
+}
+
+
 /* Read data from a file on the memmap device */
 static int memmap_block_read(io_entity_t *entity, uintptr_t buffer,
 			     size_t length, size_t *length_read)
@@ -177,7 +238,7 @@ static int memmap_block_read(io_entity_t *entity, uintptr_t buffer,
 	pos_after = fp->file_pos + length;
 	assert((pos_after >= fp->file_pos) && (pos_after <= fp->size));
 
-	memcpy((void *)buffer, (void *)(fp->base + fp->file_pos), length);
+	memmap_copy(buffer, fp->base + fp->file_pos, length);
 
 	*length_read = length;
 
@@ -188,6 +249,31 @@ static int memmap_block_read(io_entity_t *entity, uintptr_t buffer,
 }
 
 
+/* Return the address of data in a file on the memmap device */
+static int memmap_block_map(io_entity_t *entity, size_t length,
+			    uintptr_t *addr)
+{
+	file_state_t *fp;
+	size_t pos_after;
+
+	assert(entity != NULL);
+	assert(addr != NULL);
+
+	fp = (file_state_t *) entity->info;
+
+	/* Assert that file position is valid for this operation */
+	pos_after = fp->file_pos + length;
+	assert((pos_after >= fp->file_pos) && (pos_after <= fp->size));
+
+	*addr = fp->base + fp->file_pos;
+
+	/* Set file position after the mapped data */
+	fp->file_pos = pos_after;
+
+	return 0;
+}
+
+
 /* Write data to a file on the memmap device */
 static int memmap_block_write(io_entity_t *entity, const uintptr_t buffer,
 			      size_t length, size_t *length_written)
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2017, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,8 +7,20 @@
 #include <assert.h>
 #include <io_driver.h>
 #include <io_storage.h>
+#include <platform_def.h>
 #include <semihosting.h>
 
+/*
+ * Semihosting handle and position of each open file, so that the seeks to the
+ * current position, e.g. between consecutive reads of a FIP, don't cost a
+ * semihosting call. A zero handle marks a free entry.
+ */
+typedef struct {
+	long	handle;
+	size_t	pos;
+} sh_file_state_t;
+
+static sh_file_state_t sh_files[MAX_IO_HANDLES];
 
 
 /* Identify the device type as semihosting */
@@ -73,14 +85,24 @@ static int sh_file_open(io_dev_info_t *dev_info __unused,
 	int result = -ENOENT;
 	long sh_result;
 	const io_file_spec_t *file_spec = (const io_file_spec_t *)spec;
+	int i;
 
 	assert(file_spec != NULL);
 	assert(entity != NULL);
 
+	for (i = 0; i < MAX_IO_HANDLES; i++) {
+		if (sh_files[i].handle == 0)
+			break;
+	}
+	if (i == MAX_IO_HANDLES)
+		return -ENOMEM;
+
 	sh_result = semihosting_file_open(file_spec->path, file_spec->mode);
 
 	if (sh_result > 0) {
-		entity->info = (uintptr_t)sh_result;
+		sh_files[i].handle = sh_result;
+		sh_files[i].pos = 0;
+		entity->info = (uintptr_t)&sh_files[i];
 		result = 0;
 	}
 	return result;
@@ -90,15 +112,33 @@ static int sh_file_open(io_dev_info_t *dev_info __unused,
 /* Seek to a particular file offset on the semi-hosting device */
 static int sh_file_seek(io_entity_t *entity, int mode, ssize_t offset)
 {
-	long file_handle, sh_result;
+	sh_file_state_t *file;
+	long sh_result;
+	size_t pos;
 
 	assert(entity != NULL);
 
-	file_handle = (long)entity->info;
+	file = (sh_file_state_t *)entity->info;
+
+	switch (mode) {
+	case IO_SEEK_SET:
+		pos = offset;
+		break;
+	case IO_SEEK_CUR:
+		pos = file->pos + offset;
+		break;
+	default:
+		return -EINVAL;
+	}
+	if (pos == file->pos)
+		return 0;
 
-	sh_result = semihosting_file_seek(file_handle, offset);
+	sh_result = semihosting_file_seek(file->handle, pos);
+	if (sh_result != 0)
+		return -ENOENT;
 
-	return (sh_result == 0) ? 0 : -ENOENT;
+	file->pos = pos;
+	return 0;
 }
 
 
@@ -110,7 +150,7 @@ static int sh_file_len(io_entity_t *entity, size_t *length)
 	assert(entity != NULL);
 	assert(length != NULL);
 
-	long sh_handle = (long)entity->info;
+	long sh_handle = ((sh_file_state_t *)entity->info)->handle;
 	long sh_result = semihosting_file_length(sh_handle);
 
 	if (sh_result >= 0) {
@@ -129,18 +169,20 @@ static int sh_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	int result = -ENOENT;
 	long sh_result;
 	size_t bytes = length;
-	long file_handle;
+	sh_file_state_t *file;
 
 	assert(entity != NULL);
 	assert(buffer != (uintptr_t)NULL);
 	assert(length_read != NULL);
 
-	file_handle = (long)entity->info;
+	file = (sh_file_state_t *)entity->info;
 
-	sh_result = semihosting_file_read(file_handle, &bytes, buffer);
+	/* A single semihosting call reads the whole length into the buffer */
+	sh_result = semihosting_file_read(file->handle, &bytes, buffer);
 
 	if (sh_result >= 0) {
 		*length_read = (bytes != length) ? bytes : length;
+		file->pos += *length_read;
 		result = 0;
 	}
 
@@ -153,18 +195,19 @@ static int sh_file_write(io_entity_t *entity, const uintptr_t buffer,
 		size_t length, size_t *length_written)
 {
 	long sh_result;
-	long file_handle;
+	sh_file_state_t *file;
 	size_t bytes = length;
 
 	assert(entity != NULL);
 	assert(buffer != (uintptr_t)NULL);
 	assert(length_written != NULL);
 
-	file_handle = (long)entity->info;
+	file = (sh_file_state_t *)entity->info;
 
-	sh_result = semihosting_file_write(file_handle, &bytes, buffer);
+	sh_result = semihosting_file_write(file->handle, &bytes, buffer);
 
 	*length_written = length - bytes;
+	file->pos += *length_written;
 
 	return (sh_result == 0) ? 0 : -ENOENT;
 }
@@ -174,13 +217,14 @@ static int sh_file_write(io_entity_t *entity, const uintptr_t buffer,
 static int sh_file_close(io_entity_t *entity)
 {
 	long sh_result;
-	long file_handle;
+	sh_file_state_t *file;
 
 	assert(entity != NULL);
 
-	file_handle = (long)entity->info;
+	file = (sh_file_state_t *)entity->info;
 
-	sh_result = semihosting_file_close(file_handle);
+	sh_result = semihosting_file_close(file->handle);
+	file->handle = 0;
 
 	return (sh_result >= 0) ? 0 : -ENOENT;
 }
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <arch_helpers.h>
 #include <assert.h>
 #include <io_driver.h>
 #include <io_storage.h>
@@ -14,12 +15,52 @@
 /* Storage for a fixed maximum number of IO entities, definable by platform */
 static io_entity_t entity_pool[MAX_IO_HANDLES];
 
-/* Simple way of tracking used storage - each entry is NULL or a pointer to an
- * entity */
-static io_entity_t *entity_map[MAX_IO_HANDLES];
+/*
+ * Free entities are chained by index through entity_next, -1 ending the list.
+ * Entities past entity_high have never been used and are not on the list.
+ */
+#define ENTITY_IN_USE		-2
+static int entity_next[MAX_IO_HANDLES];
+static int entity_free = -1;
+static unsigned int entity_high;
 
-/* Track number of allocated entities */
-static unsigned int entity_count;
+/*
+ * Maximum number of entities open at once on the devices of each type,
+ * definable by platform, e.g. to keep handles for the backend of FIP entities.
+ */
+#ifndef MAX_IO_SEMIHOSTING_HANDLES
+#define MAX_IO_SEMIHOSTING_HANDLES	MAX_IO_HANDLES
+#endif
+#ifndef MAX_IO_MEMMAP_HANDLES
+#define MAX_IO_MEMMAP_HANDLES		MAX_IO_HANDLES
+#endif
+#ifndef MAX_IO_DUMMY_HANDLES
+#define MAX_IO_DUMMY_HANDLES		MAX_IO_HANDLES
+#endif
+#ifndef MAX_IO_FIP_HANDLES
+#define MAX_IO_FIP_HANDLES		MAX_IO_HANDLES
+#endif
+#ifndef MAX_IO_BLOCK_HANDLES
+#define MAX_IO_BLOCK_HANDLES		MAX_IO_HANDLES
+#endif
+
+static const unsigned int type_max_handles[IO_TYPE_MAX] = {
+	[IO_TYPE_SEMIHOSTING]		= MAX_IO_SEMIHOSTING_HANDLES,
+	[IO_TYPE_MEMMAP]		= MAX_IO_MEMMAP_HANDLES,
+	[IO_TYPE_DUMMY]			= MAX_IO_DUMMY_HANDLES,
+	[IO_TYPE_FIRMWARE_IMAGE_PACKAGE] = MAX_IO_FIP_HANDLES,
+	[IO_TYPE_BLOCK]			= MAX_IO_BLOCK_HANDLES,
+};
+
+/* Number of entities open on the devices of each type, and of each entity */
+static unsigned int type_handles[IO_TYPE_MAX];
+static io_type_t entity_type[MAX_IO_HANDLES];
+
+/*
+ * Length read by io_read_start() on behalf of devices which cannot split a
+ * read, returned by the matching io_read_wait()
+ */
+static size_t sync_read_length[MAX_IO_HANDLES];
 
 /* Array of fixed maximum of registered devices, definable by platform */
 static const io_dev_info_t *devices[MAX_IO_DEVICES];
@@ -27,6 +68,49 @@ static const io_dev_info_t *devices[MAX_IO_DEVICES];
 /* Number of currently registered devices */
 static unsigned int dev_count;
 
+#if IO_STORAGE_STATS
+/* Statistics of the reads from each device, by device handle */
+static struct {
+	const io_dev_info_t *dev;
+	io_dev_stats_t stats;
+} dev_stats[MAX_IO_DEVICES];
+
+static unsigned long long stats_timestamp(void)
+{
+	return read_cntpct_el0();
+}
+
+/*
+ * Account a read of 'length' bytes from a device started at 'start'. Reads from
+ * more devices than the platform registers are not accounted.
+ */
+static void stats_account_read(const io_dev_info_t *dev,
+			       unsigned long long start, size_t length)
+{
+	unsigned int i;
+
+	for (i = 0; i < MAX_IO_DEVICES; i++) {
+		if (dev_stats[i].dev == NULL)
+			dev_stats[i].dev = dev;
+		if (dev_stats[i].dev == dev) {
+			dev_stats[i].stats.bytes += length;
+			dev_stats[i].stats.ticks += stats_timestamp() - start;
+			return;
+		}
+	}
+}
+#else
+static inline unsigned long long stats_timestamp(void)
+{
+	return 0;
+}
+
+static inline void stats_account_read(const io_dev_info_t *dev,
+				      unsigned long long start, size_t length)
+{
+}
+#endif /* IO_STORAGE_STATS */
+
 /* Extra validation functions only used when asserts are enabled */
 #if ENABLE_ASSERTIONS
 
@@ -90,53 +174,50 @@ static void set_handle(uintptr_t *handle, io_entity_t *entity)
 }
 
 
-/* Locate an entity in the pool, specified by address */
-static int find_first_entity(const io_entity_t *entity, unsigned int *index_out)
-{
-	int result = -ENOENT;
-	for (int index = 0; index < MAX_IO_HANDLES; ++index) {
-		if (entity_map[index] == entity) {
-			result = 0;
-			*index_out = index;
-			break;
-		}
-	}
-	return result;
-}
-
-
-/* Allocate an entity from the pool and return a pointer to it */
-static int allocate_entity(io_entity_t **entity)
+/*
+ * Allocate an entity from the pool for a device of the given type and return a
+ * pointer to it
+ */
+static int allocate_entity(io_type_t type, io_entity_t **entity)
 {
-	int result = -ENOMEM;
-	assert(entity != NULL);
-
-	if (entity_count < MAX_IO_HANDLES) {
-		unsigned int index = 0;
-		result = find_first_entity(NULL, &index);
-		assert(result == 0);
-		*entity = entity_map[index] = &entity_pool[index];
-		++entity_count;
+	int index;
+	assert((entity != NULL) && (type < IO_TYPE_MAX));
+
+	if (type_handles[type] >= type_max_handles[type])
+		return -ENOMEM;
+
+	if (entity_free >= 0) {
+		index = entity_free;
+		entity_free = entity_next[index];
+	} else if (entity_high < MAX_IO_HANDLES) {
+		index = entity_high++;
+	} else {
+		return -ENOMEM;
 	}
 
-	return result;
+	entity_next[index] = ENTITY_IN_USE;
+	entity_type[index] = type;
+	type_handles[type]++;
+	*entity = &entity_pool[index];
+	return 0;
 }
 
 
 /* Release an entity back to the pool */
 static int free_entity(const io_entity_t *entity)
 {
-	int result;
-	unsigned int index = 0;
+	int index;
 	assert(entity != NULL);
 
-	result = find_first_entity(entity, &index);
-	if (result ==  0) {
-		entity_map[index] = NULL;
-		--entity_count;
-	}
+	index = entity - entity_pool;
+	if ((index < 0) || (index >= (int)entity_high) ||
+	    (entity_next[index] != ENTITY_IN_USE))
+		return -ENOENT;
 
-	return result;
+	type_handles[entity_type[index]]--;
+	entity_next[index] = entity_free;
+	entity_free = index;
+	return 0;
 }
 
 
@@ -222,7 +303,7 @@ int io_open(uintptr_t dev_handle, const uintptr_t spec, uintptr_t *handle)
 	io_dev_info_t *dev = (io_dev_info_t *)dev_handle;
 	io_entity_t *entity;
 
-	result = allocate_entity(&entity);
+	result = allocate_entity(dev->funcs->type(), &entity);
 
 	if (result == 0) {
 		assert(dev->funcs->open != NULL);
@@ -284,10 +365,109 @@ int io_read(uintptr_t handle,
 	io_entity_t *entity = (io_entity_t *)handle;
 
 	io_dev_info_t *dev = entity->dev_handle;
+	unsigned long long start = stats_timestamp();
 
 	if (dev->funcs->read != NULL)
 		result = dev->funcs->read(entity, buffer, length, length_read);
 
+	if (result == 0)
+		stats_account_read(dev, start, *length_read);
+
+	return result;
+}
+
+
+/*
+ * Start reading data from an IO entity. The buffer must not be accessed until
+ * io_read_wait() has returned. Devices without asynchronous support perform
+ * the read here and io_read_wait() only returns its result.
+ */
+int io_read_start(uintptr_t handle, uintptr_t buffer, size_t length)
+{
+	int result = -ENODEV;
+	assert(is_valid_entity(handle) && (buffer != (uintptr_t)NULL));
+
+	io_entity_t *entity = (io_entity_t *)handle;
+
+	io_dev_info_t *dev = entity->dev_handle;
+	unsigned long long start = stats_timestamp();
+
+	if ((dev->funcs->read_start != NULL) &&
+	    (dev->funcs->read_wait != NULL)) {
+		result = dev->funcs->read_start(entity, buffer, length);
+	} else if (dev->funcs->read != NULL) {
+		result = dev->funcs->read(entity, buffer, length,
+			&sync_read_length[entity - entity_pool]);
+	}
+
+	/* The length read is accounted by io_read_wait() */
+	if (result == 0)
+		stats_account_read(dev, start, 0);
+
+	return result;
+}
+
+
+/* Wait for the read started by io_read_start() to complete */
+int io_read_wait(uintptr_t handle, size_t *length_read)
+{
+	assert(is_valid_entity(handle) && (length_read != NULL));
+
+	io_entity_t *entity = (io_entity_t *)handle;
+
+	io_dev_info_t *dev = entity->dev_handle;
+	unsigned long long start = stats_timestamp();
+	int result = 0;
+
+	if ((dev->funcs->read_start != NULL) &&
+	    (dev->funcs->read_wait != NULL))
+		result = dev->funcs->read_wait(entity, length_read);
+	else
+		*length_read = sync_read_length[entity - entity_pool];
+
+	if (result == 0)
+		stats_account_read(dev, start, *length_read);
+
+	return result;
+}
+
+
+/*
+ * Return whether the device of an IO entity can leave a read started by
+ * io_read_start() in flight, i.e. whether splitting a read in several ones
+ * lets it overlap with other work. If not, a single read is faster.
+ */
+int io_read_is_async(uintptr_t handle)
+{
+	assert(is_valid_entity(handle));
+
+	io_entity_t *entity = (io_entity_t *)handle;
+
+	io_dev_info_t *dev = entity->dev_handle;
+
+	return (dev->funcs->read_start != NULL) &&
+	       (dev->funcs->read_wait != NULL);
+}
+
+
+/*
+ * Get the address at which the 'length' bytes from the current position of an
+ * IO entity can be accessed without copying them, and move the position past
+ * them. This fails with -ENODEV if the device does not map its storage, in
+ * which case the data must be read with io_read().
+ */
+int io_map(uintptr_t handle, size_t length, uintptr_t *addr)
+{
+	int result = -ENODEV;
+	assert(is_valid_entity(handle) && (addr != NULL));
+
+	io_entity_t *entity = (io_entity_t *)handle;
+
+	io_dev_info_t *dev = entity->dev_handle;
+
+	if (dev->funcs->map != NULL)
+		result = dev->funcs->map(entity, length, addr);
+
 	return result;
 }
 
@@ -333,3 +513,25 @@ int io_close(uintptr_t handle)
 
 	return result;
 }
+
+
+#if IO_STORAGE_STATS
+/*
+ * Get the statistics of the reads from a device since boot. This fails with
+ * -ENOENT if nothing has been read from it yet.
+ */
+int io_dev_get_stats(uintptr_t dev_handle, io_dev_stats_t *stats)
+{
+	unsigned int i;
+	assert(is_valid_dev(dev_handle) && (stats != NULL));
+
+	for (i = 0; (i < MAX_IO_DEVICES) && (dev_stats[i].dev != NULL); i++) {
+		if (dev_stats[i].dev == (io_dev_info_t *)dev_handle) {
+			*stats = dev_stats[i].stats;
+			return 0;
+		}
+	}
+
+	return -ENOENT;
+}
+#endif /* IO_STORAGE_STATS */
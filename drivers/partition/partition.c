@@ -1,9 +1,10 @@
 /*
- * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <arch_helpers.h>
 #include <assert.h>
 #include <debug.h>
 #include <io_storage.h>
@@ -11,10 +12,26 @@
 #include <mbr.h>
 #include <partition.h>
 #include <platform.h>
+#include <platform_def.h>
 #include <string.h>
+#include <utils.h>
 
-static uint8_t mbr_sector[PARTITION_BLOCK_SIZE];
-partition_entry_list_t list;
+/*
+ * Holds the MBR sector, then the whole array of GPT entries read with a single
+ * transfer. Block aligned so that the block driver can read it in place.
+ */
+static union {
+	uint8_t		mbr_sector[PARTITION_BLOCK_SIZE];
+	gpt_entry_t	gpt_entries[PLAT_PARTITION_MAX_ENTRIES];
+} partition_buf __aligned(PARTITION_BLOCK_SIZE);
+
+#ifdef PLAT_PARTITION_TABLE_BASE
+static partition_entry_list_t *const list =
+	(partition_entry_list_t *)PLAT_PARTITION_TABLE_BASE;
+#else
+static partition_entry_list_t partition_list;
+static partition_entry_list_t *const list = &partition_list;
+#endif
 
 #if LOG_LEVEL >= LOG_LEVEL_VERBOSE
 static void dump_entries(int num)
@@ -24,13 +41,13 @@ static void dump_entries(int num)
 
 	VERBOSE("Partition table with %d entries:\n", num);
 	for (i = 0; i < num; i++) {
-		len = snprintf(name, EFI_NAMELEN, "%s", list.list[i].name);
+		len = snprintf(name, EFI_NAMELEN, "%s", list->list[i].name);
 		for (j = 0; j < EFI_NAMELEN - len - 1; j++) {
 			name[len + j] = ' ';
 		}
 		name[EFI_NAMELEN - 1] = '\0';
-		VERBOSE("%d: %s %lx-%lx\n", i + 1, name, list.list[i].start,
-			list.list[i].start + list.list[i].length - 4);
+		VERBOSE("%d: %s %lx-%lx\n", i + 1, name, list->list[i].start,
+			list->list[i].start + list->list[i].length - 4);
 	}
 }
 #else
@@ -43,6 +60,7 @@ static void dump_entries(int num)
  */
 static int load_mbr_header(uintptr_t image_handle, mbr_entry_t *mbr_entry)
 {
+	uint8_t *mbr_sector = partition_buf.mbr_sector;
 	size_t bytes_read;
 	uintptr_t offset;
 	int result;
@@ -54,7 +72,7 @@ static int load_mbr_header(uintptr_t image_handle, mbr_entry_t *mbr_entry)
 		WARN("Failed to seek (%i)\n", result);
 		return result;
 	}
-	result = io_read(image_handle, (uintptr_t)&mbr_sector,
+	result = io_read(image_handle, (uintptr_t)mbr_sector,
 			 PARTITION_BLOCK_SIZE, &bytes_read);
 	if (result != 0) {
 		WARN("Failed to read data (%i)\n", result);
@@ -66,7 +84,7 @@ static int load_mbr_header(uintptr_t image_handle, mbr_entry_t *mbr_entry)
 	    (mbr_sector[PARTITION_BLOCK_SIZE - 1] != MBR_SIGNATURE_SECOND)) {
 		return -ENOENT;
 	}
-	offset = (uintptr_t)&mbr_sector + MBR_PRIMARY_ENTRY_OFFSET;
+	offset = (uintptr_t)mbr_sector + MBR_PRIMARY_ENTRY_OFFSET;
 	memcpy(mbr_entry, (void *)offset, sizeof(mbr_entry_t));
 	return 0;
 }
@@ -96,35 +114,64 @@ static int load_gpt_header(uintptr_t image_handle)
 	}
 
 	/* partition numbers can't exceed PLAT_PARTITION_MAX_ENTRIES */
-	list.entry_count = header.list_num;
-	if (list.entry_count > PLAT_PARTITION_MAX_ENTRIES) {
-		list.entry_count = PLAT_PARTITION_MAX_ENTRIES;
+	list->entry_count = header.list_num;
+	if (list->entry_count > PLAT_PARTITION_MAX_ENTRIES) {
+		list->entry_count = PLAT_PARTITION_MAX_ENTRIES;
 	}
 	return 0;
 }
 
-static int load_gpt_entry(uintptr_t image_handle, gpt_entry_t *entry)
+/* Read all the GPT entries with a single transfer */
+static int load_gpt_entries(uintptr_t image_handle)
 {
+	size_t length = list->entry_count * sizeof(gpt_entry_t);
 	size_t bytes_read;
 	int result;
 
-	assert(entry != NULL);
-	result = io_read(image_handle, (uintptr_t)entry, sizeof(gpt_entry_t),
-			 &bytes_read);
-	if (sizeof(gpt_entry_t) != bytes_read)
+	if (length == 0)
+		return -EINVAL;
+	result = io_read(image_handle, (uintptr_t)partition_buf.gpt_entries,
+			 length, &bytes_read);
+	if (length != bytes_read)
 		return -EINVAL;
 	return result;
 }
 
+/* FNV-1a hash of a partition name, reduced to a bucket index */
+static unsigned int partition_hash(const char *name)
+{
+	unsigned int hash = 2166136261U;
+
+	while (*name != '\0')
+		hash = (hash ^ (unsigned char)*name++) * 16777619U;
+	return hash % PARTITION_HASH_BUCKETS;
+}
+
+static void hash_entries(void)
+{
+	unsigned int bucket;
+	int i;
+
+	zeromem(list->hash_head, sizeof(list->hash_head));
+	/* Insert backwards so that the first entry of a name is found first */
+	for (i = list->entry_count - 1; i >= 0; i--) {
+		bucket = partition_hash(list->list[i].name);
+		list->hash_next[i] = list->hash_head[bucket];
+		list->hash_head[bucket] = i + 1;
+	}
+}
+
 static int verify_partition_gpt(uintptr_t image_handle)
 {
-	gpt_entry_t entry;
 	int result, i;
 
-	for (i = 0; i < list.entry_count; i++) {
-		result = load_gpt_entry(image_handle, &entry);
-		assert(result == 0);
-		result = parse_gpt_entry(&entry, &list.list[i]);
+	result = load_gpt_entries(image_handle);
+	if (result != 0) {
+		return result;
+	}
+	for (i = 0; i < list->entry_count; i++) {
+		result = parse_gpt_entry(&partition_buf.gpt_entries[i],
+					 &list->list[i]);
 		if (result != 0) {
 			break;
 		}
@@ -136,8 +183,14 @@ static int verify_partition_gpt(uintptr_t image_handle)
 	 * Only records the valid partition number that is loaded from
 	 * partition table.
 	 */
-	list.entry_count = i;
-	dump_entries(list.entry_count);
+	list->entry_count = i;
+	hash_entries();
+	list->magic = PARTITION_LIST_MAGIC;
+#ifdef PLAT_PARTITION_TABLE_BASE
+	/* Later boot stages may read the table with their caches disabled */
+	flush_dcache_range((uintptr_t)list, sizeof(partition_entry_list_t));
+#endif
+	dump_entries(list->entry_count);
 
 	return 0;
 }
@@ -148,6 +201,7 @@ int load_partition_table(unsigned int image_id)
 	mbr_entry_t mbr_entry;
 	int result;
 
+	list->magic = 0;
 	result = plat_get_image_source(image_id, &dev_handle, &image_spec);
 	if (result != 0) {
 		WARN("Failed to obtain reference to image id=%u (%i)\n",
@@ -184,19 +238,31 @@ exit:
 
 const partition_entry_t *get_partition_entry(const char *name)
 {
-	int i;
+	unsigned int index;
 
-	for (i = 0; i < list.entry_count; i++) {
-		if (strcmp(name, list.list[i].name) == 0) {
-			return &list.list[i];
+	if (list->magic != PARTITION_LIST_MAGIC) {
+		return NULL;
+	}
+	index = list->hash_head[partition_hash(name)];
+	while (index != 0) {
+		if (strcmp(name, list->list[index - 1].name) == 0) {
+			return &list->list[index - 1];
 		}
+		index = list->hash_next[index - 1];
 	}
 	return NULL;
 }
 
+/*
+ * Return the partition table loaded by this image, or by an earlier boot stage
+ * when PLAT_PARTITION_TABLE_BASE is defined. Return NULL if there is none.
+ */
 const partition_entry_list_t *get_partition_entry_list(void)
 {
-	return &list;
+	if (list->magic != PARTITION_LIST_MAGIC) {
+		return NULL;
+	}
+	return list;
 }
 
 void partition_init(unsigned int image_id)
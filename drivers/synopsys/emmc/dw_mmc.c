@@ -13,7 +13,9 @@
 #include <emmc.h>
 #include <errno.h>
 #include <mmio.h>
+#include <platform_def.h>
 #include <string.h>
+#include <utils_def.h>
 
 #define DWMMC_CTRL			(0x00)
 #define CTRL_IDMAC_EN			(1 << 25)
@@ -81,17 +83,23 @@
 #define FIFOTH_DMA_BURST_SIZE(x)	((x & 0x7) << 28)
 
 #define DWMMC_DEBNCE			(0x64)
+#define DWMMC_UHS_REG			(0x74)
+#define UHS_REG_DDR			(1 << 16)
+
 #define DWMMC_BMOD			(0x80)
 #define BMOD_ENABLE			(1 << 7)
 #define BMOD_FB				(1 << 1)
 #define BMOD_SWRESET			(1 << 0)
 
+#define DWMMC_PLDMND			(0x84)
 #define DWMMC_DBADDR			(0x88)
 #define DWMMC_IDSTS			(0x8c)
 #define DWMMC_IDINTEN			(0x90)
 #define DWMMC_CARDTHRCTL		(0x100)
 #define CARDTHRCTL_RD_THR(x)		((x & 0xfff) << 16)
 #define CARDTHRCTL_RD_THR_EN		(1 << 0)
+#define DWMMC_EMMC_DDR_REG		(0x10c)
+#define EMMC_DDR_REG_HS400		(1 << 31)
 
 #define IDMAC_DES0_DIC			(1 << 1)
 #define IDMAC_DES0_LD			(1 << 2)
@@ -104,10 +112,16 @@
 #define IDMAC_DES2_BS2(x)		(((x) & 0x1fff) << 13)
 
 #define DWMMC_DMA_MAX_BUFFER_SIZE	(512 * 8)
+/* Descriptors sharing a cache line are handed back to the IDMAC together */
+#define DWMMC_DESC_GROUP		(CACHE_WRITEBACK_GRANULE / \
+					 sizeof(struct dw_idmac_desc))
 
 #define DWMMC_8BIT_MODE			(1 << 6)
 
-#define TIMEOUT				100000
+/* Time given to the controller or the card to complete an operation */
+#define DWMMC_TIMEOUT_US		1000000
+
+#define DWMMC_TUNING_BLOCK_SIZE		128
 
 struct dw_idmac_desc {
 	unsigned int	des0;
@@ -122,6 +136,9 @@ static int dw_set_ios(int clk, int width);
 static int dw_prepare(int lba, uintptr_t buf, size_t size);
 static int dw_read(int lba, uintptr_t buf, size_t size);
 static int dw_write(int lba, uintptr_t buf, size_t size);
+static void dw_setup_dma(uintptr_t buf, size_t size);
+static int dw_set_timing(int timing);
+static int dw_execute_tuning(int width);
 
 static const emmc_ops_t dw_mmc_ops = {
 	.init		= dw_init,
@@ -130,9 +147,55 @@ static const emmc_ops_t dw_mmc_ops = {
 	.prepare	= dw_prepare,
 	.read		= dw_read,
 	.write		= dw_write,
+	.set_timing	= dw_set_timing,
+	.execute_tuning	= dw_execute_tuning,
 };
 
 static dw_mmc_params_t dw_params;
+static int dw_timing = EMMC_TIMING_LEGACY;
+/* Number of descriptors fitting in desc_size */
+static unsigned int dw_desc_cnt;
+/* Transfer set up by dw_setup_dma(), split in chunks of one descriptor */
+static uintptr_t dw_xfer_buf;
+static size_t dw_xfer_size;
+static unsigned int dw_xfer_chunks;
+static unsigned int dw_xfer_next;
+/* The hold register must not be used by the HS200 and HS400 timings */
+static unsigned int dw_cmd_hold = CMD_USE_HOLD_REG;
+
+/* Tuning block patterns defined by the eMMC specification */
+static const unsigned char dw_tuning_pattern_4bit[64] = {
+	0xff, 0x0f, 0xff, 0x00, 0xff, 0xcc, 0xc3, 0xcc,
+	0xc3, 0x3c, 0xcc, 0xff, 0xfe, 0xff, 0xfe, 0xef,
+	0xff, 0xdf, 0xff, 0xdd, 0xff, 0xfb, 0xff, 0xfb,
+	0xbf, 0xff, 0x7f, 0xff, 0x77, 0xf7, 0xbd, 0xef,
+	0xff, 0xf0, 0xff, 0xf0, 0x0f, 0xfc, 0xcc, 0x3c,
+	0xcc, 0x33, 0xcc, 0xcf, 0xff, 0xef, 0xff, 0xee,
+	0xff, 0xfd, 0xff, 0xfd, 0xdf, 0xff, 0xbf, 0xff,
+	0xbb, 0xff, 0xf7, 0xff, 0xf7, 0x7f, 0x7b, 0xde,
+};
+
+static const unsigned char dw_tuning_pattern_8bit[128] = {
+	0xff, 0xff, 0x00, 0xff, 0xff, 0xff, 0x00, 0x00,
+	0xff, 0xff, 0xcc, 0xcc, 0xcc, 0x33, 0xcc, 0xcc,
+	0xcc, 0x33, 0x33, 0xcc, 0xcc, 0xcc, 0xff, 0xff,
+	0xff, 0xee, 0xff, 0xff, 0xff, 0xee, 0xee, 0xff,
+	0xff, 0xff, 0xdd, 0xff, 0xff, 0xff, 0xdd, 0xdd,
+	0xff, 0xff, 0xff, 0xbb, 0xff, 0xff, 0xff, 0xbb,
+	0xbb, 0xff, 0xff, 0xff, 0x77, 0xff, 0xff, 0xff,
+	0x77, 0x77, 0xff, 0x77, 0xbb, 0xdd, 0xee, 0xff,
+	0xff, 0xff, 0xff, 0x00, 0xff, 0xff, 0xff, 0x00,
+	0x00, 0xff, 0xff, 0xcc, 0xcc, 0xcc, 0x33, 0xcc,
+	0xcc, 0xcc, 0x33, 0x33, 0xcc, 0xcc, 0xcc, 0xff,
+	0xff, 0xff, 0xee, 0xff, 0xff, 0xff, 0xee, 0xee,
+	0xff, 0xff, 0xff, 0xdd, 0xff, 0xff, 0xff, 0xdd,
+	0xdd, 0xff, 0xff, 0xff, 0xbb, 0xff, 0xff, 0xff,
+	0xbb, 0xbb, 0xff, 0xff, 0xff, 0x77, 0xff, 0xff,
+	0xff, 0x77, 0x77, 0xff, 0x77, 0xbb, 0xdd, 0xee,
+};
+
+static unsigned char dw_tuning_buf[DWMMC_TUNING_BLOCK_SIZE]
+	__aligned(DWMMC_TUNING_BLOCK_SIZE);
 
 static void dw_update_clk(void)
 {
@@ -157,12 +220,23 @@ static void dw_set_clk(int clk)
 
 	assert(clk > 0);
 
-	for (div = 1; div < 256; div++) {
-		if ((dw_params.clk_rate / (2 * div)) <= clk) {
-			break;
+	/*
+	 * Bypass the divider for rates above the source clock, except in 8-bit
+	 * DDR mode where the controller requires it.
+	 */
+	if ((clk > dw_params.clk_rate) &&
+	    !(((dw_timing == EMMC_TIMING_DDR52) ||
+	       (dw_timing == EMMC_TIMING_HS400)) &&
+	      (mmio_read_32(dw_params.reg_base + DWMMC_CTYPE) & CTYPE_8BIT))) {
+		div = 0;
+	} else {
+		for (div = 1; div < 256; div++) {
+			if ((dw_params.clk_rate / (2 * div)) <= clk) {
+				break;
+			}
 		}
+		assert(div < 256);
 	}
-	assert(div < 256);
 
 	/* wait until controller is idle */
 	do {
@@ -223,7 +297,7 @@ static int dw_send_cmd(emmc_cmd_t *cmd)
 {
 	unsigned int op, data, err_mask;
 	uintptr_t base;
-	int timeout;
+	timeout_t timeout;
 
 	assert(cmd);
 
@@ -242,6 +316,7 @@ static int dw_send_cmd(emmc_cmd_t *cmd)
 	case EMMC_CMD8:
 	case EMMC_CMD17:
 	case EMMC_CMD18:
+	case EMMC_CMD21:
 		op = CMD_DATA_TRANS_EXPECT | CMD_WAIT_PRVDATA_COMPLETE;
 		break;
 	case EMMC_CMD24:
@@ -253,7 +328,7 @@ static int dw_send_cmd(emmc_cmd_t *cmd)
 		op = 0;
 		break;
 	}
-	op |= CMD_USE_HOLD_REG | CMD_START;
+	op |= dw_cmd_hold | CMD_START;
 	switch (cmd->resp_type) {
 	case 0:
 		break;
@@ -268,12 +343,9 @@ static int dw_send_cmd(emmc_cmd_t *cmd)
 		op |= CMD_RESP_EXPECT | CMD_CHECK_RESP_CRC;
 		break;
 	}
-	timeout = TIMEOUT;
-	do {
-		data = mmio_read_32(base + DWMMC_STATUS);
-		if (--timeout <= 0)
-			panic();
-	} while (data & STATUS_DATA_BUSY);
+	if (mmio_poll_timeout_32(base + DWMMC_STATUS, STATUS_DATA_BUSY, 0,
+				 DWMMC_TIMEOUT_US) != 0)
+		panic();
 
 	mmio_write_32(base + DWMMC_RINTSTS, ~0);
 	mmio_write_32(base + DWMMC_CMDARG, cmd->cmd_arg);
@@ -281,16 +353,15 @@ static int dw_send_cmd(emmc_cmd_t *cmd)
 
 	err_mask = INT_EBE | INT_HLE | INT_RTO | INT_RCRC | INT_RE |
 		   INT_DCRC | INT_DRT | INT_SBE;
-	timeout = TIMEOUT;
+	timeout_init_us(&timeout, DWMMC_TIMEOUT_US);
 	do {
-		udelay(500);
 		data = mmio_read_32(base + DWMMC_RINTSTS);
 
 		if (data & err_mask)
 			return -EIO;
 		if (data & INT_DTO)
 			break;
-		if (--timeout == 0) {
+		if (!(data & INT_CMD_DONE) && timeout_elapsed(&timeout)) {
 			ERROR("%s, RINTSTS:0x%x\n", __func__, data);
 			panic();
 		}
@@ -328,10 +399,6 @@ static int dw_set_ios(int clk, int width)
 
 static int dw_prepare(int lba, uintptr_t buf, size_t size)
 {
-	struct dw_idmac_desc *desc;
-	int desc_cnt, i, last;
-	uintptr_t base;
-
 	assert(((buf & EMMC_BLOCK_MASK) == 0) &&
 	       ((size % EMMC_BLOCK_SIZE) == 0) &&
 	       (dw_params.desc_size > 0) &&
@@ -339,46 +406,259 @@ static int dw_prepare(int lba, uintptr_t buf, size_t size)
 	       ((dw_params.desc_base & EMMC_BLOCK_MASK) == 0) &&
 	       ((dw_params.desc_size & EMMC_BLOCK_MASK) == 0));
 
-	desc_cnt = (size + DWMMC_DMA_MAX_BUFFER_SIZE - 1) /
-		   DWMMC_DMA_MAX_BUFFER_SIZE;
-	assert(desc_cnt * sizeof(struct dw_idmac_desc) < dw_params.desc_size);
+	dw_setup_dma(buf, size);
+	return 0;
+}
 
-	base = dw_params.reg_base;
-	desc = (struct dw_idmac_desc *)dw_params.desc_base;
-	mmio_write_32(base + DWMMC_BYTCNT, size);
-	mmio_write_32(base + DWMMC_RINTSTS, ~0);
-	for (i = 0; i < desc_cnt; i++) {
-		desc[i].des0 = IDMAC_DES0_OWN | IDMAC_DES0_CH | IDMAC_DES0_DIC;
-		desc[i].des1 = IDMAC_DES1_BS1(DWMMC_DMA_MAX_BUFFER_SIZE);
-		desc[i].des2 = buf + DWMMC_DMA_MAX_BUFFER_SIZE * i;
-		desc[i].des3 = dw_params.desc_base +
-			       (sizeof(struct dw_idmac_desc)) * (i + 1);
-	}
+/* Fill the descriptor of a chunk of the transfer set up by dw_setup_dma() */
+static void dw_set_desc(unsigned int chunk)
+{
+	struct dw_idmac_desc *desc;
+	unsigned int slot = chunk % dw_desc_cnt;
+	size_t offset = (size_t)chunk * DWMMC_DMA_MAX_BUFFER_SIZE;
+
+	desc = (struct dw_idmac_desc *)dw_params.desc_base + slot;
+	desc->des0 = IDMAC_DES0_OWN | IDMAC_DES0_CH | IDMAC_DES0_DIC;
+	desc->des1 = IDMAC_DES1_BS1(DWMMC_DMA_MAX_BUFFER_SIZE);
+	desc->des2 = dw_xfer_buf + offset;
+	desc->des3 = dw_params.desc_base +
+		     sizeof(struct dw_idmac_desc) * ((slot + 1) % dw_desc_cnt);
 	/* first descriptor */
-	desc->des0 |= IDMAC_DES0_FS;
+	if (chunk == 0)
+		desc->des0 |= IDMAC_DES0_FS;
 	/* last descriptor */
-	last = desc_cnt - 1;
-	(desc + last)->des0 |= IDMAC_DES0_LD;
-	(desc + last)->des0 &= ~(IDMAC_DES0_DIC | IDMAC_DES0_CH);
-	(desc + last)->des1 = IDMAC_DES1_BS1(size - (last *
-				  DWMMC_DMA_MAX_BUFFER_SIZE));
-	/* set next descriptor address as 0 */
-	(desc + last)->des3 = 0;
+	if (chunk == dw_xfer_chunks - 1) {
+		desc->des0 |= IDMAC_DES0_LD;
+		desc->des0 &= ~(IDMAC_DES0_DIC | IDMAC_DES0_CH);
+		desc->des1 = IDMAC_DES1_BS1(dw_xfer_size - offset);
+		/* set next descriptor address as 0 */
+		desc->des3 = 0;
+	}
+}
+
+/*
+ * Transfers needing more descriptors than desc_size holds use the descriptor
+ * list as a ring, see dw_refill_desc(). Only the first descriptors are filled
+ * here.
+ */
+static void dw_setup_dma(uintptr_t buf, size_t size)
+{
+	uintptr_t base = dw_params.reg_base;
+	unsigned int i;
+
+	dw_xfer_buf = buf;
+	dw_xfer_size = size;
+	dw_xfer_chunks = (size + DWMMC_DMA_MAX_BUFFER_SIZE - 1) /
+			 DWMMC_DMA_MAX_BUFFER_SIZE;
+	dw_xfer_next = MIN(dw_xfer_chunks, dw_desc_cnt);
+
+	mmio_write_32(base + DWMMC_BYTCNT, size);
+	mmio_write_32(base + DWMMC_RINTSTS, ~0);
+	for (i = 0; i < dw_xfer_next; i++)
+		dw_set_desc(i);
 
 	mmio_write_32(base + DWMMC_DBADDR, dw_params.desc_base);
 	clean_dcache_range(dw_params.desc_base,
-			   desc_cnt * DWMMC_DMA_MAX_BUFFER_SIZE);
+			   dw_xfer_next * sizeof(struct dw_idmac_desc));
+}
 
+/*
+ * Hand the rest of a transfer larger than the descriptor list to the IDMAC:
+ * wait for each group of descriptors sharing a cache line to be consumed,
+ * refill it with the next chunks of the buffer and resume the IDMAC in case
+ * it suspended on a descriptor it did not own yet.
+ */
+static int dw_refill_desc(void)
+{
+	struct dw_idmac_desc *desc;
+	uintptr_t base = dw_params.reg_base;
+	uintptr_t group;
+	unsigned int i, data;
+	timeout_t timeout;
+
+	while (dw_xfer_next < dw_xfer_chunks) {
+		desc = (struct dw_idmac_desc *)dw_params.desc_base +
+		       (dw_xfer_next % dw_desc_cnt);
+		group = (uintptr_t)desc;
+
+		timeout_init_us(&timeout, DWMMC_TIMEOUT_US);
+		do {
+			inv_dcache_range(group, CACHE_WRITEBACK_GRANULE);
+			for (i = 0; i < DWMMC_DESC_GROUP; i++) {
+				if (desc[i].des0 & IDMAC_DES0_OWN)
+					break;
+			}
+			if (i == DWMMC_DESC_GROUP)
+				break;
+			data = mmio_read_32(base + DWMMC_RINTSTS);
+			if (data & (INT_EBE | INT_SBE | INT_HLE | INT_FRUN |
+				    INT_DCRC | INT_DRT))
+				return -EIO;
+			if (timeout_elapsed(&timeout))
+				return -ETIMEDOUT;
+			udelay(10);
+		} while (1);
+
+		for (i = 0; (i < DWMMC_DESC_GROUP) &&
+			    (dw_xfer_next < dw_xfer_chunks); i++)
+			dw_set_desc(dw_xfer_next++);
+		clean_dcache_range(group, CACHE_WRITEBACK_GRANULE);
+		mmio_write_32(base + DWMMC_PLDMND, 1);
+	}
 	return 0;
 }
 
 static int dw_read(int lba, uintptr_t buf, size_t size)
 {
-	return 0;
+	return dw_refill_desc();
 }
 
 static int dw_write(int lba, uintptr_t buf, size_t size)
 {
+	return dw_refill_desc();
+}
+
+static int dw_set_timing(int timing)
+{
+	uintptr_t base = dw_params.reg_base;
+	unsigned int uhs, ddr;
+
+	uhs = mmio_read_32(base + DWMMC_UHS_REG) & ~UHS_REG_DDR;
+	switch (timing) {
+	case EMMC_TIMING_LEGACY:
+	case EMMC_TIMING_HS:
+		dw_cmd_hold = CMD_USE_HOLD_REG;
+		break;
+	case EMMC_TIMING_DDR52:
+		uhs |= UHS_REG_DDR;
+		dw_cmd_hold = CMD_USE_HOLD_REG;
+		break;
+	case EMMC_TIMING_HS200:
+		dw_cmd_hold = 0;
+		break;
+	case EMMC_TIMING_HS400:
+		uhs |= UHS_REG_DDR;
+		dw_cmd_hold = 0;
+		break;
+	default:
+		return -EINVAL;
+	}
+	mmio_write_32(base + DWMMC_UHS_REG, uhs);
+
+	/* Only controllers supporting HS400 implement EMMC_DDR_REG */
+	if ((timing == EMMC_TIMING_HS400) || (dw_timing == EMMC_TIMING_HS400)) {
+		ddr = mmio_read_32(base + DWMMC_EMMC_DDR_REG) &
+		      ~EMMC_DDR_REG_HS400;
+		if (timing == EMMC_TIMING_HS400)
+			ddr |= EMMC_DDR_REG_HS400;
+		mmio_write_32(base + DWMMC_EMMC_DDR_REG, ddr);
+	}
+	dw_timing = timing;
+	return 0;
+}
+
+/* Reset the FIFO and the internal DMA after a failed data transfer */
+static void dw_reset_data(void)
+{
+	uintptr_t base = dw_params.reg_base;
+	unsigned int data;
+
+	data = mmio_read_32(base + DWMMC_CTRL);
+	mmio_write_32(base + DWMMC_CTRL,
+		      data | CTRL_FIFO_RESET | CTRL_DMA_RESET);
+	do {
+		data = mmio_read_32(base + DWMMC_CTRL);
+	} while (data & (CTRL_FIFO_RESET | CTRL_DMA_RESET));
+
+	data = mmio_read_32(base + DWMMC_BMOD);
+	mmio_write_32(base + DWMMC_BMOD, data | BMOD_SWRESET);
+	do {
+		data = mmio_read_32(base + DWMMC_BMOD);
+	} while (data & BMOD_SWRESET);
+}
+
+/* Read the tuning block with CMD21 and compare it with the expected pattern */
+static int dw_send_tuning(const unsigned char *pattern, size_t size)
+{
+	uintptr_t base = dw_params.reg_base;
+	uintptr_t buf = (uintptr_t)dw_tuning_buf;
+	emmc_cmd_t cmd;
+	unsigned int data;
+	timeout_t timeout;
+	int ret;
+
+	inv_dcache_range(buf, size);
+	mmio_write_32(base + DWMMC_BLKSIZ, size);
+	dw_setup_dma(buf, size);
+
+	memset(&cmd, 0, sizeof(emmc_cmd_t));
+	cmd.cmd_idx = EMMC_CMD21;
+	cmd.resp_type = EMMC_RESPONSE_R1;
+	ret = dw_send_cmd(&cmd);
+
+	/* the command may complete before the data */
+	timeout_init_us(&timeout, DWMMC_TIMEOUT_US);
+	while (ret == 0) {
+		data = mmio_read_32(base + DWMMC_RINTSTS);
+		if (data & (INT_EBE | INT_SBE | INT_HLE | INT_DCRC | INT_DRT))
+			ret = -EIO;
+		else if (data & INT_DTO)
+			break;
+		else if (timeout_elapsed(&timeout))
+			ret = -ETIMEDOUT;
+	}
+
+	mmio_write_32(base + DWMMC_BLKSIZ, EMMC_BLOCK_SIZE);
+	if (ret != 0) {
+		dw_reset_data();
+		return ret;
+	}
+
+	inv_dcache_range(buf, size);
+	return memcmp(dw_tuning_buf, pattern, size) ? -EIO : 0;
+}
+
+/*
+ * Try each sample phase offered by the platform and keep the middle of the
+ * longest run of phases reading the tuning block correctly.
+ */
+static int dw_execute_tuning(int width)
+{
+	const unsigned char *pattern;
+	unsigned int phase, start, run, best_start, best_run;
+	size_t size;
+
+	if ((dw_params.set_sample_phase == 0) || (dw_params.num_phases == 0))
+		return -ENOTSUP;
+
+	if (width == EMMC_BUS_WIDTH_8) {
+		pattern = dw_tuning_pattern_8bit;
+		size = sizeof(dw_tuning_pattern_8bit);
+	} else {
+		pattern = dw_tuning_pattern_4bit;
+		size = sizeof(dw_tuning_pattern_4bit);
+	}
+
+	start = run = best_start = best_run = 0;
+	for (phase = 0; phase < dw_params.num_phases; phase++) {
+		dw_params.set_sample_phase(phase);
+		if (dw_send_tuning(pattern, size) != 0) {
+			run = 0;
+			continue;
+		}
+		if (run++ == 0)
+			start = phase;
+		if (run > best_run) {
+			best_run = run;
+			best_start = start;
+		}
+	}
+	if (best_run == 0)
+		return -EIO;
+
+	dw_params.set_sample_phase(best_start + best_run / 2);
+	VERBOSE("dw_mmc: sample phase %u of %u\n", best_start + best_run / 2,
+		dw_params.num_phases);
 	return 0;
 }
 
@@ -395,6 +675,10 @@ void dw_mmc_init(dw_mmc_params_t *params)
 		(params->bus_width == EMMC_BUS_WIDTH_8)));
 
 	memcpy(&dw_params, params, sizeof(dw_mmc_params_t));
+	dw_desc_cnt = params->desc_size / sizeof(struct dw_idmac_desc);
+	dw_desc_cnt -= dw_desc_cnt % DWMMC_DESC_GROUP;
+	/* a ring needs one group in use by the IDMAC while another is filled */
+	assert(dw_desc_cnt >= 2 * DWMMC_DESC_GROUP);
 	emmc_init(&dw_mmc_ops, params->clk_rate, params->bus_width,
 		  params->flags);
 }
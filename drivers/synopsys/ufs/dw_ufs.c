@@ -176,15 +176,33 @@ const ufs_ops_t dw_ufs_ops = {
 	.phy_set_pwr_mode	= dwufs_phy_set_pwr_mode,
 };
 
+static void dw_ufs_get_params(const dw_ufs_params_t *params,
+			      ufs_params_t *ufs_params)
+{
+	memset(ufs_params, 0, sizeof(*ufs_params));
+	ufs_params->reg_base = params->reg_base;
+	ufs_params->desc_base = params->desc_base;
+	ufs_params->desc_size = params->desc_size;
+	ufs_params->flags = params->flags;
+}
+
 int dw_ufs_init(dw_ufs_params_t *params)
 {
 	ufs_params_t ufs_params;
 
-	memset(&ufs_params, 0, sizeof(ufs_params));
-	ufs_params.reg_base = params->reg_base;
-	ufs_params.desc_base = params->desc_base;
-	ufs_params.desc_size = params->desc_size;
-	ufs_params.flags = params->flags;
+	dw_ufs_get_params(params, &ufs_params);
 	ufs_init(&dw_ufs_ops, &ufs_params);
 	return 0;
 }
+
+/*
+ * Start the initialisation of the UFS device, to be completed by
+ * ufs_init_wait() or by the first access to the device.
+ */
+int dw_ufs_init_start(dw_ufs_params_t *params)
+{
+	ufs_params_t ufs_params;
+
+	dw_ufs_get_params(params, &ufs_params);
+	return ufs_init_start(&dw_ufs_ops, &ufs_params);
+}
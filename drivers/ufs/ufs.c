@@ -22,11 +22,49 @@
 
 #define UFS_DESC_SIZE			0x400
 #define MAX_UFS_DESC_SIZE		0x8000		/* 32 descriptors */
+/* The UTRD list and the command descriptor of one slot */
+#define MIN_UFS_DESC_SIZE		(2 * UFS_DESC_SIZE)
 
 #define MAX_PRDT_SIZE			0x40000		/* 256KB */
+#define UFS_MAX_SLOTS			(CAP_NUTRS_MASK + 1)
+
+/* Queued reads are split in commands of one PRDT entry each */
+#define UFS_QUEUE_CHUNK_SIZE		MAX_PRDT_SIZE
+
+/* Time given to the host controller or the device to answer a request */
+#define UFS_TIMEOUT_US			1000000
+/* Time given to the device to clear fDeviceInit once the host has set it */
+#define UFS_DEVICE_INIT_TIMEOUT_US	1500000
+
+/*
+ * UTRDs are smaller than a cache line, so only one slot of each cache line is
+ * used. Otherwise cleaning the UTRD being prepared for a slot could overwrite
+ * the status written by the host controller to the UTRD of another slot.
+ */
+#if CACHE_WRITEBACK_GRANULE > UTP_TRD_SIZE
+#define UTRD_SLOT_STRIDE		(CACHE_WRITEBACK_GRANULE / UTP_TRD_SIZE)
+#else
+#define UTRD_SLOT_STRIDE		1
+#endif
 
 static ufs_params_t ufs_params;
 static int nutrs;	/* Number of UTP Transfer Request Slots */
+static unsigned int ufs_slots_busy;	/* Slots allocated by get_utrd() */
+/* Set from ufs_init_start() until the device has been initialised */
+static int ufs_init_pending;
+static timeout_t ufs_device_init_timeout;
+
+/* Read queued by ufs_read_blocks_start(), split over several slots */
+static struct {
+	utp_utrd_t	utrd[UFS_MAX_SLOTS];
+	unsigned int	head;		/* Oldest command in flight */
+	unsigned int	count;		/* Number of commands in flight */
+	int		lun;
+	int		lba;		/* Next block to read */
+	uintptr_t	buf;		/* Destination of the next block */
+	size_t		size;		/* Size left to queue */
+	size_t		done;		/* Size read by the completed commands */
+} ufs_queue;
 
 int ufshc_send_uic_cmd(uintptr_t base, uic_cmd_t *cmd)
 {
@@ -41,9 +79,9 @@ int ufshc_send_uic_cmd(uintptr_t base, uic_cmd_t *cmd)
 	mmio_write_32(base + UCMDARG3, cmd->arg3);
 	mmio_write_32(base + UICCMD, cmd->op);
 
-	do {
-		data = mmio_read_32(base + IS);
-	} while ((data & UFS_INT_UCCS) == 0);
+	if (mmio_poll_timeout_32(base + IS, UFS_INT_UCCS, UFS_INT_UCCS,
+				 UFS_TIMEOUT_US) != 0)
+		return -ETIMEDOUT;
 	mmio_write_32(base + IS, UFS_INT_UCCS);
 	return mmio_read_32(base + UCMDARG2) && CONFIG_RESULT_CODE_MASK;
 }
@@ -52,6 +90,7 @@ int ufshc_dme_get(unsigned int attr, unsigned int idx, unsigned int *val)
 {
 	uintptr_t base;
 	unsigned int data;
+	timeout_t timeout;
 	int retries;
 
 	assert((ufs_params.reg_base != 0) && (val != NULL));
@@ -71,10 +110,13 @@ int ufshc_dme_get(unsigned int attr, unsigned int idx, unsigned int *val)
 	mmio_write_32(base + UCMDARG2, 0);
 	mmio_write_32(base + UCMDARG3, 0);
 	mmio_write_32(base + UICCMD, DME_GET);
+	timeout_init_us(&timeout, UFS_TIMEOUT_US);
 	do {
 		data = mmio_read_32(base + IS);
 		if (data & UFS_INT_UE)
 			return -EINVAL;
+		if (((data & UFS_INT_UCCS) == 0) && timeout_elapsed(&timeout))
+			return -ETIMEDOUT;
 	} while ((data & UFS_INT_UCCS) == 0);
 	mmio_write_32(base + IS, UFS_INT_UCCS);
 	data = mmio_read_32(base + UCMDARG2) && CONFIG_RESULT_CODE_MASK;
@@ -88,6 +130,7 @@ int ufshc_dme_set(unsigned int attr, unsigned int idx, unsigned int val)
 {
 	uintptr_t base;
 	unsigned int data;
+	timeout_t timeout;
 
 	assert((ufs_params.reg_base != 0));
 
@@ -100,10 +143,13 @@ int ufshc_dme_set(unsigned int attr, unsigned int idx, unsigned int val)
 	mmio_write_32(base + UCMDARG2, 0);
 	mmio_write_32(base + UCMDARG3, val);
 	mmio_write_32(base + UICCMD, DME_SET);
+	timeout_init_us(&timeout, UFS_TIMEOUT_US);
 	do {
 		data = mmio_read_32(base + IS);
 		if (data & UFS_INT_UE)
 			return -EINVAL;
+		if (((data & UFS_INT_UCCS) == 0) && timeout_elapsed(&timeout))
+			return -ETIMEDOUT;
 	} while ((data & UFS_INT_UCCS) == 0);
 	mmio_write_32(base + IS, UFS_INT_UCCS);
 	data = mmio_read_32(base + UCMDARG2) && CONFIG_RESULT_CODE_MASK;
@@ -111,21 +157,22 @@ int ufshc_dme_set(unsigned int attr, unsigned int idx, unsigned int val)
 	return 0;
 }
 
-static void ufshc_reset(uintptr_t base)
+static int ufshc_reset(uintptr_t base)
 {
 	unsigned int data;
 
 	/* Enable Host Controller */
 	mmio_write_32(base + HCE, HCE_ENABLE);
 	/* Wait until basic initialization sequence completed */
-	do {
-		data = mmio_read_32(base + HCE);
-	} while ((data & HCE_ENABLE) == 0);
+	if (mmio_poll_timeout_32(base + HCE, HCE_ENABLE, HCE_ENABLE,
+				 UFS_TIMEOUT_US) != 0)
+		return -ETIMEDOUT;
 
 	/* Enable Interrupts */
 	data = UFS_INT_UCCS | UFS_INT_ULSS | UFS_INT_UE | UFS_INT_UTPES |
 	       UFS_INT_DFES | UFS_INT_HCFES | UFS_INT_SBFES;
 	mmio_write_32(base + IE, data);
+	return 0;
 }
 
 static int ufshc_link_startup(uintptr_t base)
@@ -140,8 +187,9 @@ static int ufshc_link_startup(uintptr_t base)
 		result = ufshc_send_uic_cmd(base, &cmd);
 		if (result != 0)
 			continue;
-		while ((mmio_read_32(base + HCS) & HCS_DP) == 0)
-			;
+		if (mmio_poll_timeout_32(base + HCS, HCS_DP, HCS_DP,
+					 UFS_TIMEOUT_US) != 0)
+			continue;
 		data = mmio_read_32(base + IS);
 		if (data & UFS_INT_ULSS)
 			mmio_write_32(base + IS, UFS_INT_ULSS);
@@ -150,17 +198,16 @@ static int ufshc_link_startup(uintptr_t base)
 	return -EIO;
 }
 
-/* Check Door Bell register to get an empty slot */
+/* Check Door Bell register and the slots in use to get an empty slot */
 static int get_empty_slot(int *slot)
 {
 	unsigned int data;
 	int i;
 
-	data = mmio_read_32(ufs_params.reg_base + UTRLDBR);
-	for (i = 0; i < nutrs; i++) {
-		if ((data & 1) == 0)
+	data = mmio_read_32(ufs_params.reg_base + UTRLDBR) | ufs_slots_busy;
+	for (i = 0; i < nutrs; i += UTRD_SLOT_STRIDE) {
+		if ((data & (1 << i)) == 0)
 			break;
-		data = data >> 1;
 	}
 	if (i >= nutrs)
 		return -EBUSY;
@@ -168,6 +215,16 @@ static int get_empty_slot(int *slot)
 	return 0;
 }
 
+/*
+ * The UTRD list takes the first descriptor of the region, followed by the
+ * command descriptors of the slots in use.
+ */
+static uintptr_t get_ucd_base(int slot)
+{
+	return ufs_params.desc_base +
+	       ((1 + (slot / UTRD_SLOT_STRIDE)) * UFS_DESC_SIZE);
+}
+
 static void get_utrd(utp_utrd_t *utrd)
 {
 	uintptr_t base;
@@ -178,16 +235,19 @@ static void get_utrd(utp_utrd_t *utrd)
 	result = get_empty_slot(&slot);
 	assert(result == 0);
 
+	ufs_slots_busy |= 1 << slot;
+
 	/* clear utrd */
 	memset((void *)utrd, 0, sizeof(utp_utrd_t));
-	base = ufs_params.desc_base + (slot * UFS_DESC_SIZE);
-	/* clear the descriptor */
-	memset((void *)base, 0, UFS_DESC_SIZE);
+	base = ufs_params.desc_base + (slot * UTP_TRD_SIZE);
+	memset((void *)base, 0, UTP_TRD_SIZE);
+	/* clear the command descriptor */
+	memset((void *)get_ucd_base(slot), 0, UFS_DESC_SIZE);
 
 	utrd->header = base;
 	utrd->task_tag = slot + 1;
 	/* CDB address should be aligned with 128 bytes */
-	utrd->upiu = ALIGN_CDB(utrd->header + sizeof(utrd_header_t));
+	utrd->upiu = ALIGN_CDB(get_ucd_base(slot));
 	utrd->resp_upiu = ALIGN_8(utrd->upiu + sizeof(cmd_upiu_t));
 	utrd->size_upiu = utrd->resp_upiu - utrd->upiu;
 	utrd->size_resp_upiu = ALIGN_8(sizeof(resp_upiu_t));
@@ -215,12 +275,6 @@ static int ufs_prepare_cmd(utp_utrd_t *utrd, uint8_t op, uint8_t lun,
 	unsigned int lba_cnt;
 	int prdt_size;
 
-
-	mmio_write_32(ufs_params.reg_base + UTRLBA,
-		      utrd->header & UINT32_MAX);
-	mmio_write_32(ufs_params.reg_base + UTRLBAU,
-		      (utrd->upiu >> 32) & UINT32_MAX);
-
 	hd = (utrd_header_t *)utrd->header;
 	upiu = (cmd_upiu_t *)utrd->upiu;
 
@@ -303,7 +357,8 @@ static int ufs_prepare_cmd(utp_utrd_t *utrd, uint8_t op, uint8_t lun,
 	}
 
 	flush_dcache_range((uintptr_t)utrd, sizeof(utp_utrd_t));
-	flush_dcache_range((uintptr_t)utrd->header, UFS_DESC_SIZE);
+	flush_dcache_range((uintptr_t)utrd->header, UTP_TRD_SIZE);
+	flush_dcache_range((uintptr_t)utrd->upiu, UFS_DESC_SIZE);
 	return 0;
 }
 
@@ -318,12 +373,6 @@ static int ufs_prepare_query(utp_utrd_t *utrd, uint8_t op, uint8_t idn,
 	hd = (utrd_header_t *)utrd->header;
 	query_upiu = (query_upiu_t *)utrd->upiu;
 
-	mmio_write_32(ufs_params.reg_base + UTRLBA,
-		      utrd->header & UINT32_MAX);
-	mmio_write_32(ufs_params.reg_base + UTRLBAU,
-		      (utrd->header >> 32) & UINT32_MAX);
-
-
 	hd->i = 1;
 	hd->ct = CT_UFS_STORAGE;
 	hd->ocs = OCS_MASK;
@@ -361,7 +410,8 @@ static int ufs_prepare_query(utp_utrd_t *utrd, uint8_t op, uint8_t idn,
 		assert(0);
 	}
 	flush_dcache_range((uintptr_t)utrd, sizeof(utp_utrd_t));
-	flush_dcache_range((uintptr_t)utrd->header, UFS_DESC_SIZE);
+	flush_dcache_range((uintptr_t)utrd->header, UTP_TRD_SIZE);
+	flush_dcache_range((uintptr_t)utrd->upiu, UFS_DESC_SIZE);
 	return 0;
 }
 
@@ -370,11 +420,6 @@ static void ufs_prepare_nop_out(utp_utrd_t *utrd)
 	utrd_header_t *hd;
 	nop_out_upiu_t *nop_out;
 
-	mmio_write_32(ufs_params.reg_base + UTRLBA,
-		      utrd->header & UINT32_MAX);
-	mmio_write_32(ufs_params.reg_base + UTRLBAU,
-		      (utrd->header >> 32) & UINT32_MAX);
-
 	hd = (utrd_header_t *)utrd->header;
 	nop_out = (nop_out_upiu_t *)utrd->upiu;
 
@@ -385,7 +430,8 @@ static void ufs_prepare_nop_out(utp_utrd_t *utrd)
 	nop_out->trans_type = 0;
 	nop_out->task_tag = utrd->task_tag;
 	flush_dcache_range((uintptr_t)utrd, sizeof(utp_utrd_t));
-	flush_dcache_range((uintptr_t)utrd->header, UFS_DESC_SIZE);
+	flush_dcache_range((uintptr_t)utrd->header, UTP_TRD_SIZE);
+	flush_dcache_range((uintptr_t)utrd->upiu, UFS_DESC_SIZE);
 }
 
 static void ufs_send_request(int task_tag)
@@ -397,11 +443,6 @@ static void ufs_send_request(int task_tag)
 	/* clear all interrupts */
 	mmio_write_32(ufs_params.reg_base + IS, ~0);
 
-	mmio_write_32(ufs_params.reg_base + UTRLRSR, 1);
-	do {
-		data = mmio_read_32(ufs_params.reg_base + UTRLRSR);
-	} while (data == 0);
-
 	data = UTRIACR_IAEN | UTRIACR_CTR | UTRIACR_IACTH(0x1F) |
 	       UTRIACR_IATOVAL(0xFF);
 	mmio_write_32(ufs_params.reg_base + UTRIACR, data);
@@ -414,21 +455,31 @@ static int ufs_check_resp(utp_utrd_t *utrd, int trans_type)
 	utrd_header_t *hd;
 	resp_upiu_t *resp;
 	unsigned int data;
+	timeout_t timeout;
 	int slot;
 
 	hd = (utrd_header_t *)utrd->header;
 	resp = (resp_upiu_t *)utrd->resp_upiu;
-	inv_dcache_range((uintptr_t)hd, UFS_DESC_SIZE);
-	inv_dcache_range((uintptr_t)utrd, sizeof(utp_utrd_t));
+	slot = utrd->task_tag - 1;
+
+	/*
+	 * Other slots may complete first, so wait for the Door Bell of this
+	 * one to be cleared. On a timeout the slot stays allocated, as the
+	 * host controller may still complete the request.
+	 */
+	timeout_init_us(&timeout, UFS_TIMEOUT_US);
 	do {
 		data = mmio_read_32(ufs_params.reg_base + IS);
 		if ((data & ~(UFS_INT_UCCS | UFS_INT_UTRCS)) != 0)
 			return -EIO;
-	} while ((data & UFS_INT_UTRCS) == 0);
-	slot = utrd->task_tag - 1;
-
-	data = mmio_read_32(ufs_params.reg_base + UTRLDBR);
-	assert((data & (1 << slot)) == 0);
+		data = mmio_read_32(ufs_params.reg_base + UTRLDBR);
+		if (((data & (1 << slot)) != 0) && timeout_elapsed(&timeout))
+			return -ETIMEDOUT;
+	} while ((data & (1 << slot)) != 0);
+	ufs_slots_busy &= ~(1 << slot);
+
+	inv_dcache_range((uintptr_t)hd, UTP_TRD_SIZE);
+	inv_dcache_range((uintptr_t)utrd->upiu, UFS_DESC_SIZE);
 	assert(hd->ocs == OCS_SUCCESS);
 	assert((resp->trans_type & TRANS_TYPE_CODE_MASK) == trans_type);
 	(void)resp;
@@ -591,9 +642,12 @@ void ufs_read_capacity(int lun, unsigned int *num, unsigned int *size)
 	int result;
 	int retry;
 
+	if (ufs_init_pending)
+		ufs_init_wait();
+
 	assert((ufs_params.reg_base != 0) &&
 	       (ufs_params.desc_base != 0) &&
-	       (ufs_params.desc_size >= UFS_DESC_SIZE) &&
+	       (ufs_params.desc_size >= MIN_UFS_DESC_SIZE) &&
 	       (num != NULL) && (size != NULL));
 
 	/* align buf address */
@@ -632,28 +686,97 @@ void ufs_read_capacity(int lun, unsigned int *num, unsigned int *size)
 	(void)result;
 }
 
-size_t ufs_read_blocks(int lun, int lba, uintptr_t buf, size_t size)
+/* Queue the next part of the read started by ufs_read_blocks_start() */
+static void ufs_queue_read(void)
 {
-	utp_utrd_t utrd;
-	resp_upiu_t *resp;
-	int result;
+	utp_utrd_t *utrd;
+	size_t size;
+
+	utrd = &ufs_queue.utrd[(ufs_queue.head + ufs_queue.count) %
+			       UFS_MAX_SLOTS];
+	size = ufs_queue.size;
+	if (size > UFS_QUEUE_CHUNK_SIZE)
+		size = UFS_QUEUE_CHUNK_SIZE;
+
+	get_utrd(utrd);
+	ufs_prepare_cmd(utrd, CDBCMD_READ_10, ufs_queue.lun, ufs_queue.lba,
+			ufs_queue.buf, size);
+	ufs_send_request(utrd->task_tag);
+
+	ufs_queue.count++;
+	ufs_queue.lba += size >> UFS_BLOCK_SHIFT;
+	ufs_queue.buf += size;
+	ufs_queue.size -= size;
+}
+
+/*
+ * Start a read of whole blocks, split in commands queued in as many slots as
+ * the host controller provides so that they are processed back to back. It
+ * must be completed with ufs_read_blocks_wait() before any other UFS access.
+ */
+int ufs_read_blocks_start(int lun, int lba, uintptr_t buf, size_t size)
+{
+	unsigned int depth;
+
+	if (ufs_init_pending)
+		ufs_init_wait();
 
 	assert((ufs_params.reg_base != 0) &&
 	       (ufs_params.desc_base != 0) &&
-	       (ufs_params.desc_size >= UFS_DESC_SIZE));
+	       (ufs_params.desc_size >= MIN_UFS_DESC_SIZE) &&
+	       ((size & UFS_BLOCK_MASK) == 0) &&
+	       (ufs_queue.count == 0));
+
+	ufs_queue.head = 0;
+	ufs_queue.lun = lun;
+	ufs_queue.lba = lba;
+	ufs_queue.buf = buf;
+	ufs_queue.size = size;
+	ufs_queue.done = 0;
+
+	/* Number of slots used */
+	depth = (nutrs + UTRD_SLOT_STRIDE - 1) / UTRD_SLOT_STRIDE;
+	while ((ufs_queue.size > 0) && (ufs_queue.count < depth))
+		ufs_queue_read();
+	return 0;
+}
 
-	memset((void *)buf, 0, size);
-	get_utrd(&utrd);
-	ufs_prepare_cmd(&utrd, CDBCMD_READ_10, lun, lba, buf, size);
-	ufs_send_request(utrd.task_tag);
-	result = ufs_check_resp(&utrd, RESPONSE_UPIU);
-	assert(result == 0);
+/*
+ * Wait for the read issued by ufs_read_blocks_start() to complete, reusing
+ * the slots of the completed commands for the rest of the read.
+ */
+size_t ufs_read_blocks_wait(void)
+{
+	utp_utrd_t *utrd;
+	cmd_upiu_t *upiu;
+	resp_upiu_t *resp;
+	int result;
+
+	while (ufs_queue.count > 0) {
+		utrd = &ufs_queue.utrd[ufs_queue.head];
+		result = ufs_check_resp(utrd, RESPONSE_UPIU);
+		assert(result == 0);
 #ifdef UFS_RESP_DEBUG
-	dump_upiu(&utrd);
+		dump_upiu(utrd);
 #endif
-	resp = (resp_upiu_t *)utrd.resp_upiu;
+		upiu = (cmd_upiu_t *)utrd->upiu;
+		resp = (resp_upiu_t *)utrd->resp_upiu;
+		ufs_queue.done += be32toh(upiu->exp_data_trans_len) -
+				  be32toh(resp->res_trans_cnt);
+		ufs_queue.head = (ufs_queue.head + 1) % UFS_MAX_SLOTS;
+		ufs_queue.count--;
+
+		if (ufs_queue.size > 0)
+			ufs_queue_read();
+	}
 	(void)result;
-	return size - resp->res_trans_cnt;
+	return ufs_queue.done;
+}
+
+size_t ufs_read_blocks(int lun, int lba, uintptr_t buf, size_t size)
+{
+	ufs_read_blocks_start(lun, lba, buf, size);
+	return ufs_read_blocks_wait();
 }
 
 size_t ufs_write_blocks(int lun, int lba, const uintptr_t buf, size_t size)
@@ -662,11 +785,14 @@ size_t ufs_write_blocks(int lun, int lba, const uintptr_t buf, size_t size)
 	resp_upiu_t *resp;
 	int result;
 
+	if (ufs_init_pending)
+		ufs_init_wait();
+
 	assert((ufs_params.reg_base != 0) &&
 	       (ufs_params.desc_base != 0) &&
-	       (ufs_params.desc_size >= UFS_DESC_SIZE));
+	       (ufs_params.desc_size >= MIN_UFS_DESC_SIZE) &&
+	       (ufs_queue.count == 0));
 
-	memset((void *)buf, 0, size);
 	get_utrd(&utrd);
 	ufs_prepare_cmd(&utrd, CDBCMD_WRITE_10, lun, lba, buf, size);
 	ufs_send_request(utrd.task_tag);
@@ -677,24 +803,60 @@ size_t ufs_write_blocks(int lun, int lba, const uintptr_t buf, size_t size)
 #endif
 	resp = (resp_upiu_t *)utrd.resp_upiu;
 	(void)result;
-	return size - resp->res_trans_cnt;
+	return size - be32toh(resp->res_trans_cnt);
 }
 
 static void ufs_enum(void)
 {
-	unsigned int blk_num, blk_size;
-	int i;
+	uintptr_t base = ufs_params.reg_base;
+	int result;
 
 	/* 0 means 1 slot */
-	nutrs = (mmio_read_32(ufs_params.reg_base + CAP) & CAP_NUTRS_MASK) + 1;
-	if (nutrs > (ufs_params.desc_size / UFS_DESC_SIZE))
-		nutrs = ufs_params.desc_size / UFS_DESC_SIZE;
+	nutrs = (mmio_read_32(base + CAP) & CAP_NUTRS_MASK) + 1;
+	/* Only use the slots which have a command descriptor */
+	if (nutrs > ((ufs_params.desc_size / UFS_DESC_SIZE) - 1) *
+		    UTRD_SLOT_STRIDE)
+		nutrs = ((ufs_params.desc_size / UFS_DESC_SIZE) - 1) *
+			UTRD_SLOT_STRIDE;
+
+	/* The UTRD list is at the start of the descriptor region */
+	mmio_write_32(base + UTRLBA, ufs_params.desc_base & UINT32_MAX);
+	mmio_write_32(base + UTRLBAU,
+		      (ufs_params.desc_base >> 32) & UINT32_MAX);
+	mmio_write_32(base + UTRLRSR, 1);
+	result = mmio_poll_timeout_32(base + UTRLRSR, 1, 1, UFS_TIMEOUT_US);
+	assert(result == 0);
+	(void)result;
 
 	ufs_verify_init();
 	ufs_verify_ready();
 
+	/* The device clears the flag once its initialisation is complete */
 	ufs_set_flag(FLAG_DEVICE_INIT);
-	mdelay(100);
+	timeout_init_us(&ufs_device_init_timeout, UFS_DEVICE_INIT_TIMEOUT_US);
+	ufs_init_pending = 1;
+}
+
+/*
+ * Wait for the device initialisation started by ufs_init_start() to complete.
+ * It is called by the first read or write if the platform has not done it.
+ */
+void ufs_init_wait(void)
+{
+	unsigned int blk_num, blk_size;
+	int i;
+
+	if (!ufs_init_pending)
+		return;
+
+	while (ufs_read_flag(FLAG_DEVICE_INIT) != 0) {
+		if (timeout_elapsed(&ufs_device_init_timeout)) {
+			ERROR("UFS: device initialisation timeout\n");
+			panic();
+		}
+	}
+	ufs_init_pending = 0;
+
 	/* dump available LUNs */
 	for (i = 0; i < UFS_MAX_LUNS; i++) {
 		ufs_read_capacity(i, &blk_num, &blk_size);
@@ -705,7 +867,13 @@ static void ufs_enum(void)
 	}
 }
 
-int ufs_init(const ufs_ops_t *ops, ufs_params_t *params)
+/*
+ * Bring up the link and start the initialisation of the device, without
+ * waiting for it to complete. The platform can carry on with its setup and
+ * call ufs_init_wait() later, or let the first read or write do it. The delay
+ * timer must be set up already.
+ */
+int ufs_init_start(const ufs_ops_t *ops, ufs_params_t *params)
 {
 	int result;
 	unsigned int data;
@@ -714,7 +882,8 @@ int ufs_init(const ufs_ops_t *ops, ufs_params_t *params)
 	assert((params != NULL) &&
 	       (params->reg_base != 0) &&
 	       (params->desc_base != 0) &&
-	       (params->desc_size >= UFS_DESC_SIZE));
+	       ((params->desc_base & (UFS_DESC_SIZE - 1)) == 0) &&
+	       (params->desc_size >= MIN_UFS_DESC_SIZE));
 
 	memcpy(&ufs_params, params, sizeof(ufs_params_t));
 
@@ -732,9 +901,11 @@ int ufs_init(const ufs_ops_t *ops, ufs_params_t *params)
 			assert(result == 0);
 			data = mmio_read_32(ufs_params.reg_base + UCMDARG2);
 			assert(data == 0);
-			do {
-				data = mmio_read_32(ufs_params.reg_base + IS);
-			} while ((data & UFS_INT_UHXS) == 0);
+			result = mmio_poll_timeout_32(ufs_params.reg_base + IS,
+						      UFS_INT_UHXS,
+						      UFS_INT_UHXS,
+						      UFS_TIMEOUT_US);
+			assert(result == 0);
 			mmio_write_32(ufs_params.reg_base + IS, UFS_INT_UHXS);
 			data = mmio_read_32(ufs_params.reg_base + HCS);
 			assert((data & HCS_UPMCRS_MASK) == HCS_PWR_LOCAL);
@@ -746,7 +917,8 @@ int ufs_init(const ufs_ops_t *ops, ufs_params_t *params)
 		assert((ops != NULL) && (ops->phy_init != NULL) &&
 		       (ops->phy_set_pwr_mode != NULL));
 
-		ufshc_reset(ufs_params.reg_base);
+		result = ufshc_reset(ufs_params.reg_base);
+		assert(result == 0);
 		ops->phy_init(&ufs_params);
 		result = ufshc_link_startup(ufs_params.reg_base);
 		assert(result == 0);
@@ -757,3 +929,13 @@ int ufs_init(const ufs_ops_t *ops, ufs_params_t *params)
 	(void)result;
 	return 0;
 }
+
+int ufs_init(const ufs_ops_t *ops, ufs_params_t *params)
+{
+	int result;
+
+	result = ufs_init_start(ops, params);
+	if (result == 0)
+		ufs_init_wait();
+	return result;
+}
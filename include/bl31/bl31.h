@@ -18,5 +18,8 @@ uint32_t bl31_get_next_image_type(void);
 void bl31_prepare_next_image_entry(void);
 void bl31_register_bl32_init(int32_t (*)(void));
 void bl31_warm_entrypoint(void);
+void bl31_dcsw_op_benchmark(void);
+void bl31_stack_watermark_init(void);
+unsigned int bl31_stack_watermark_get(unsigned int cpu_idx);
 
 #endif /* __BL31_H__ */
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __CRASH_DUMP_H__
+#define __CRASH_DUMP_H__
+
+#include <cpu_data.h>
+#include <trace_event.h>
+
+/*
+ * Binary record of the state of a CPU when BL31 crashed, written by each CPU
+ * in its own slot of the retained memory at PLAT_CRASH_DUMP_BASE. The magic
+ * word is written last, so a record is only valid once complete.
+ */
+#define CRASH_DUMP_MAGIC		0x48535243	/* "CRSH" */
+#define CRASH_DUMP_VERSION		1
+
+#define CRASH_DUMP_SLOT_SHIFT		11
+#define CRASH_DUMP_SLOT_SIZE		(1 << CRASH_DUMP_SLOT_SHIFT)
+
+/* Size of the retained memory the platform must reserve for the records */
+#define CRASH_DUMP_SIZE			(PLATFORM_CORE_COUNT *		\
+					 CRASH_DUMP_SLOT_SIZE)
+
+/* Reasons of the crash */
+#define CRASH_DUMP_PANIC		0	/* panic() called */
+#define CRASH_DUMP_EXCEPTION		1	/* Unhandled exception */
+#define CRASH_DUMP_INTERRUPT		2	/* Unhandled interrupt */
+
+/* Number of the last trace events of the CPU copied in its record */
+#define CRASH_DUMP_TRACE_EVENTS		16
+
+#define CRASH_DUMP_CPU_DATA_SIZE	(1 << CPU_DATA_LOG2SIZE)
+
+/* Offsets of the fields of a record */
+#define CD_MAGIC			0x0
+#define CD_VERSION			0x4
+#define CD_REASON			0x8
+#define CD_TIMESTAMP			0x10
+#define CD_GPREGS			0x18	/* x0 to x30 */
+#define CD_EL3_REGS			0x110
+#define CD_EL1_REGS			0x168
+#define CD_CPU_DATA			0x1a8
+#define CD_TRACE_HEAD			(CD_CPU_DATA + CRASH_DUMP_CPU_DATA_SIZE)
+#define CD_TRACE_EVENTS			(CD_TRACE_HEAD + 0x8)
+#define CD_SIZE				(CD_TRACE_EVENTS +		\
+					 (CRASH_DUMP_TRACE_EVENTS *	\
+					  TRACE_EVENT_SIZE))
+
+/* Number of the EL3 and lower EL system registers of a record */
+#define CRASH_DUMP_EL3_REGS		11
+#define CRASH_DUMP_EL1_REGS		8
+
+#ifndef __ASSEMBLY__
+
+#include <cassert.h>
+#include <types.h>
+
+typedef struct crash_dump {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t reason;
+	uint64_t timestamp;
+	uint64_t gpregs[31];
+	/*
+	 * SCR, SCTLR, CPTR, TCR, DAIF, MAIR, SPSR, ELR, TTBR0, ESR and FAR of
+	 * EL3.
+	 */
+	uint64_t el3_regs[CRASH_DUMP_EL3_REGS];
+	/*
+	 * SPSR_EL1, ELR_EL1, ESR_EL1, FAR_EL1, SCTLR_EL1, SP_EL1, SP_EL0 and
+	 * MPIDR_EL1.
+	 */
+	uint64_t el1_regs[CRASH_DUMP_EL1_REGS];
+	uint8_t cpu_data[CRASH_DUMP_CPU_DATA_SIZE];
+	/* Events recorded by the CPU, ending with the event 'trace_head' - 1 */
+	uint64_t trace_head;
+	trace_event_t trace_events[CRASH_DUMP_TRACE_EVENTS];
+} crash_dump_t;
+
+/* Verify that the offsets used by the assembly code match the record */
+CASSERT(__builtin_offsetof(crash_dump_t, reason) == CD_REASON,
+	assert_crash_dump_reason_offset_mismatch);
+CASSERT(__builtin_offsetof(crash_dump_t, gpregs) == CD_GPREGS,
+	assert_crash_dump_gpregs_offset_mismatch);
+CASSERT(__builtin_offsetof(crash_dump_t, el3_regs) == CD_EL3_REGS,
+	assert_crash_dump_el3_regs_offset_mismatch);
+CASSERT(__builtin_offsetof(crash_dump_t, el1_regs) == CD_EL1_REGS,
+	assert_crash_dump_el1_regs_offset_mismatch);
+CASSERT(__builtin_offsetof(crash_dump_t, cpu_data) == CD_CPU_DATA,
+	assert_crash_dump_cpu_data_offset_mismatch);
+CASSERT(__builtin_offsetof(crash_dump_t, trace_events) == CD_TRACE_EVENTS,
+	assert_crash_dump_trace_events_offset_mismatch);
+CASSERT(sizeof(crash_dump_t) == CD_SIZE, assert_crash_dump_size_mismatch);
+CASSERT(sizeof(crash_dump_t) <= CRASH_DUMP_SLOT_SIZE,
+	assert_crash_dump_slot_size);
+
+/*******************************************************************************
+ * Function prototypes
+ ******************************************************************************/
+void crash_dump_init(void);
+int crash_dump_read(unsigned int cpu_idx, unsigned int offset,
+		    uint64_t *data, unsigned int count);
+int crash_dump_clear(unsigned int cpu_idx);
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* __CRASH_DUMP_H__ */
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __EHF_H__
+#define __EHF_H__
+
+#ifndef __ASSEMBLY__
+
+#include <stdint.h>
+
+/*******************************************************************************
+ * The EL3 exception handling framework dispatches the EL3 interrupts to the
+ * handler registered for their priority. Only the Secure priorities, from 0x00
+ * to 0x7f, can be used by the EL3 interrupts. The platform chooses how many of
+ * the most significant bits of a priority are significant to the framework,
+ * from 1 to EHF_MAX_PRI_BITS, which divides the Secure priorities in as many
+ * priority levels.
+ ******************************************************************************/
+#define EHF_MAX_PRI_BITS	5
+
+/* Index of the level of 'pri' in the table of priorities of the platform */
+#define EHF_PRI_TO_IDX(pri, plat_bits)	\
+	(((pri) & 0x7f) >> (7 - (plat_bits)))
+
+/* Highest priority, i.e. lowest value, of the level 'idx' */
+#define EHF_IDX_TO_PRI(idx, plat_bits)	\
+	(((idx) << (7 - (plat_bits))) & 0x7f)
+
+/* Prototype of the handler of the EL3 interrupts of a priority level */
+typedef int (*ehf_handler_t)(uint32_t intr_raw, uint32_t flags, void *handle,
+			     void *cookie);
+
+/* Descriptor of a priority level */
+typedef struct ehf_pri_desc {
+	ehf_handler_t handler;
+	uint8_t valid;
+} ehf_pri_desc_t;
+
+/* Table of the priority levels of the platform */
+typedef struct ehf_priorities {
+	ehf_pri_desc_t *ehf_priorities;
+	unsigned int num_priorities;
+	unsigned int pri_bits;
+} ehf_priorities_t;
+
+/*
+ * Entry of the table of priority levels of the platform for the priority
+ * 'priority', to which a handler can then be registered.
+ */
+#define EHF_PRI_DESC(plat_bits, priority)			\
+	[EHF_PRI_TO_IDX(priority, plat_bits)] = {		\
+		.handler = 0,					\
+		.valid = 1,					\
+	}
+
+/*
+ * Macro for the platform to declare its table of priority levels, '_total'
+ * being an array of '_num' ehf_pri_desc_t and '_bits' the number of
+ * significant bits of the priorities.
+ */
+#define EHF_REGISTER_PRIORITIES(_total, _num, _bits)		\
+	const ehf_priorities_t exception_data = {		\
+		.ehf_priorities = (_total),			\
+		.num_priorities = (_num),			\
+		.pri_bits = (_bits),				\
+	}
+
+extern const ehf_priorities_t exception_data;
+
+/*******************************************************************************
+ * Function prototypes
+ ******************************************************************************/
+void ehf_init(void);
+int ehf_register_priority_handler(unsigned int pri, ehf_handler_t handler);
+void ehf_activate_priority(unsigned int priority);
+void ehf_deactivate_priority(unsigned int priority);
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* __EHF_H__ */
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __SMP_CALL_H__
+#define __SMP_CALL_H__
+
+#ifndef __ASSEMBLY__
+
+#include <types.h>
+
+/* Prototype of a function called at EL3 on another CPU */
+typedef void (*smp_call_func_t)(void *arg);
+
+/*******************************************************************************
+ * Function prototypes
+ ******************************************************************************/
+void smp_call_init(void);
+int smp_call_cpu(u_register_t mpidr, smp_call_func_t func, void *arg);
+int smp_call_cpus(u_register_t target_group, unsigned int aff0_mask,
+		  smp_call_func_t func, void *arg);
+void smp_call_poll(void);
+int smp_call_zero_mem(void *mem, u_register_t length);
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* __SMP_CALL_H__ */
@@ -37,6 +37,12 @@
 #define TLK_RESUME_DONE		(0x32000006 | (ULL(1) << 31))
 #define TLK_SYSTEM_OFF_DONE	(0x32000007 | (ULL(1) << 31))
 
+/*
+ * SMC function ID that TLK uses to notify the normal world asynchronously,
+ * which returns to TLK.
+ */
+#define TLK_NOTIFY_NS		(0x32000008 | (ULL(1) << 31))
+
 /*
  * Trusted Application specific function IDs
  */
@@ -41,6 +41,10 @@
 #define TSP_MUL		0x2002
 #define TSP_DIV		0x2003
 #define TSP_HANDLE_SEL1_INTR_AND_RETURN	0x2004
+#define TSP_RING_SETUP	0x2005
+#define TSP_RING_DRAIN	0x2006
+/* Returns at once, so that clients can time SMC round trips to the TSP */
+#define TSP_NOP		0x2007
 
 /*
  * Identify a TSP service from function ID filtering the last 16 bits from the
@@ -68,7 +72,11 @@
  * Total number of function IDs implemented for services offered to NS clients.
  * The function IDs are defined above
  */
-#define TSP_NUM_FID		0x5
+#if TSP_RING_BUFFER
+#define TSP_NUM_FID		0x9
+#else
+#define TSP_NUM_FID		0x7
+#endif
 
 /* TSP implementation version numbers */
 #define TSP_VERSION_MAJOR	0x0 /* Major version */
@@ -104,6 +112,29 @@ typedef struct tsp_vectors {
 	tsp_vector_isn_t abort_yield_smc_entry;
 } tsp_vectors_t;
 
+/*
+ * Command ring that the normal world registers with the TSP through the
+ * TSP_RING_SETUP fast SMC, with its physical address in x1 and its size in
+ * bytes in x2, both page aligned. The normal world fills the descriptors with
+ * arithmetic requests and advances 'prod', after which a single TSP_RING_DRAIN
+ * fast SMC services all the new descriptors, advances 'cons' past them and
+ * returns their number in x1. 'num_desc' must be a power of 2.
+ */
+typedef struct tsp_ring_desc {
+	uint64_t func;		/* TSP_ADD, TSP_SUB, TSP_MUL or TSP_DIV */
+	uint64_t args[2];
+	uint64_t results[2];
+	int64_t status;		/* 0 or -EINVAL, written by the TSP */
+} tsp_ring_desc_t;
+
+typedef struct tsp_ring {
+	volatile uint32_t prod;	/* Written by the normal world */
+	volatile uint32_t cons;	/* Written by the TSP */
+	uint32_t num_desc;
+	uint32_t reserved;
+	tsp_ring_desc_t desc[];
+} tsp_ring_t;
+
 
 #endif /* __ASSEMBLY__ */
 
@@ -83,6 +83,13 @@ extern uintptr_t __BL2_END__;
 extern uintptr_t __BL2U_END__;
 #elif defined(IMAGE_BL31)
 extern uintptr_t __BL31_END__;
+extern uintptr_t __HOT_TEXT_START__;
+extern uintptr_t __HOT_TEXT_END__;
+extern uintptr_t __HOT_RAM_END__;
+#if RECLAIM_INIT_CODE
+extern uintptr_t __INIT_CODE_START__;
+extern uintptr_t __INIT_CODE_END__;
+#endif
 #elif defined(IMAGE_BL32)
 extern uintptr_t __BL32_END__;
 #endif /* IMAGE_BLX */
@@ -207,6 +214,9 @@ int is_mem_free(uintptr_t free_base, size_t free_size,
 
 int load_image(unsigned int image_id, image_info_t *image_data);
 int load_auth_image(unsigned int image_id, image_info_t *image_data);
+#if LOAD_IMAGE_PIPELINE
+void load_image_set_next(unsigned int image_id, image_info_t *image_data);
+#endif
 
 #else
 
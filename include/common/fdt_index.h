@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef __FDT_INDEX_H__
+#define __FDT_INDEX_H__
+
+#include <stdint.h>
+
+/*
+ * Index of the nodes of a DT blob, built in one pass over the structure block,
+ * that saves the lookups by path, compatible string or phandle from scanning
+ * the blob each time.
+ *
+ * The offsets of the index are only valid as long as the blob is not modified.
+ * fdt_index_invalidate() must be called once the blob is edited with the
+ * fdt_rw or fdt_wip functions. As a safeguard, the index is also ignored when
+ * the size of the structure block has changed. The lookups fall back to the
+ * libfdt functions when the index is invalid, so using it is always optional.
+ */
+typedef struct fdt_index_node {
+	int offset;
+	/* Positions in the index of the first child and next sibling, or -1 */
+	int first_child;
+	int next_sibling;
+	uint32_t phandle;
+} fdt_index_node_t;
+
+typedef struct fdt_index {
+	const void *fdt;
+	uint32_t size_dt_struct;
+	/* Nodes in the order of their offsets, the root node first */
+	fdt_index_node_t *nodes;
+	unsigned int max_nodes;
+	unsigned int num_nodes;
+} fdt_index_t;
+
+int fdt_index_init(fdt_index_t *index, const void *fdt,
+		   fdt_index_node_t *nodes, unsigned int max_nodes);
+void fdt_index_invalidate(fdt_index_t *index);
+int fdt_index_valid(const fdt_index_t *index);
+
+int fdt_index_path_offset(const fdt_index_t *index, const char *path);
+int fdt_index_node_offset_by_compatible(const fdt_index_t *index,
+					int startoffset,
+					const char *compatible);
+int fdt_index_node_offset_by_phandle(const fdt_index_t *index,
+				     uint32_t phandle);
+int fdt_index_first_subnode(const fdt_index_t *index, int offset);
+int fdt_index_next_subnode(const fdt_index_t *index, int offset);
+
+/* Same as fdt_for_each_subnode() of libfdt, using the index */
+#define fdt_index_for_each_subnode(node, index, parent)		\
+	for (node = fdt_index_first_subnode(index, parent);	\
+	     node >= 0;						\
+	     node = fdt_index_next_subnode(index, node))
+
+#endif /* __FDT_INDEX_H__ */
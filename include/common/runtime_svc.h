@@ -27,8 +27,24 @@
 #define RT_SVC_SIZE_LOG2	5
 #define RT_SVC_DESC_INIT	16
 #define RT_SVC_DESC_HANDLE	24
+
+/*
+ * Constants to allow the assembler access a leaf service descriptor. Leaf
+ * services are only dispatched by the AArch64 BL31 exception vectors.
+ */
+#define RT_SVC_LEAF_SIZE_LOG2	4
+#define RT_SVC_LEAF_DESC_FID	0
+#define RT_SVC_LEAF_DESC_HANDLE	8
 #endif /* AARCH32 */
+
+/*
+ * Number of buckets of the SMC latency histograms. Bucket 'n' counts the SMCs
+ * that took between 2^n and 2^(n+1) - 1 system counter ticks, the last one
+ * also counting all the slower ones.
+ */
+#define SMC_STATS_BUCKETS	32
 #define SIZEOF_RT_SVC_DESC	(1 << RT_SVC_SIZE_LOG2)
+#define SIZEOF_RT_SVC_LEAF_DESC	(1 << RT_SVC_LEAF_SIZE_LOG2)
 
 
 /*
@@ -79,6 +95,35 @@ typedef struct rt_svc_desc {
 			.init = _setup, \
 			.handle = _smch }
 
+/*
+ * Prototype for a leaf SMC handler. x0 (SMC Function ID) to x3 are as passed
+ * by the caller and 'ret' points to the values returned in x0-x3, initialised
+ * with the arguments. A leaf handler runs on the EL3 runtime stack without the
+ * caller's context having been saved, so it must not switch worlds, power down
+ * the CPU or access the context through the cm_*() functions.
+ */
+typedef void (*rt_svc_leaf_handle_t)(uint32_t smc_fid,
+				     u_register_t x1,
+				     u_register_t x2,
+				     u_register_t x3,
+				     u_register_t *ret,
+				     u_register_t flags);
+typedef struct rt_svc_leaf_desc {
+	uint32_t smc_fid;
+	rt_svc_leaf_handle_t handle;
+} rt_svc_leaf_desc_t;
+
+/*
+ * Convenience macro to declare a leaf handler for a single SMC Function ID.
+ * Every SMC64 from AArch64 is looked up in the leaf descriptors before the
+ * regular dispatch, so only short, frequently issued calls belong there.
+ */
+#define DECLARE_RT_LEAF_SVC(_name, _fid, _leafh) \
+	static const rt_svc_leaf_desc_t __svc_leaf_desc_ ## _name \
+		__section("rt_svc_leaf_descs") __used = { \
+			.smc_fid = _fid, \
+			.handle = _leafh }
+
 /*
  * Compile time assertions related to the 'rt_svc_desc' structure to:
  * 1. ensure that the assembler and the compiler view of the size
@@ -95,6 +140,17 @@ CASSERT(RT_SVC_DESC_INIT == __builtin_offsetof(rt_svc_desc_t, init), \
 CASSERT(RT_SVC_DESC_HANDLE == __builtin_offsetof(rt_svc_desc_t, handle), \
 	assert_rt_svc_desc_handle_offset_mismatch);
 
+#ifndef AARCH32
+CASSERT((sizeof(rt_svc_leaf_desc_t) == SIZEOF_RT_SVC_LEAF_DESC), \
+	assert_sizeof_rt_svc_leaf_desc_mismatch);
+CASSERT(RT_SVC_LEAF_DESC_FID == \
+	__builtin_offsetof(rt_svc_leaf_desc_t, smc_fid), \
+	assert_rt_svc_leaf_desc_fid_offset_mismatch);
+CASSERT(RT_SVC_LEAF_DESC_HANDLE == \
+	__builtin_offsetof(rt_svc_leaf_desc_t, handle), \
+	assert_rt_svc_leaf_desc_handle_offset_mismatch);
+#endif
+
 
 /*
  * This macro combines the call type and the owning entity number corresponding
@@ -122,6 +178,11 @@ CASSERT(RT_SVC_DESC_HANDLE == __builtin_offsetof(rt_svc_desc_t, handle), \
 void runtime_svc_init(void);
 uintptr_t handle_runtime_svc(uint32_t smc_fid, void *cookie, void *handle,
 						unsigned int flags);
+#if ENABLE_SMC_LATENCY_STATS
+void smc_stats_record(uint32_t smc_fid, unsigned long long ticks);
+unsigned int smc_stats_get(unsigned int cpu_idx, unsigned int oen,
+			   unsigned int bucket);
+#endif
 extern uintptr_t __RT_SVC_DESCS_START__;
 extern uintptr_t __RT_SVC_DESCS_END__;
 void init_crash_reporting(void);
@@ -129,5 +129,12 @@ void cci_init(uintptr_t cci_base,
 void cci_enable_snoop_dvm_reqs(unsigned int master_id);
 void cci_disable_snoop_dvm_reqs(unsigned int master_id);
 
+/*
+ * Same as above for several masters at once, given as a mask of their ids,
+ * waiting once for the CCI to apply the changes to all of them.
+ */
+void cci_enable_snoop_dvm_reqs_mask(unsigned int master_mask);
+void cci_disable_snoop_dvm_reqs_mask(unsigned int master_mask);
+
 #endif /* __ASSEMBLY__ */
 #endif /* __CCI_H__ */
@@ -14,6 +14,7 @@
 #define MIN_SGI_ID		0
 #define MIN_PPI_ID		16
 #define MIN_SPI_ID		32
+#define MAX_SPI_ID		1019
 
 /* Mask for the priority field common to all GIC interfaces */
 #define GIC_PRI_MASK			0xff
@@ -83,4 +84,11 @@
 	(GIC_HIGHEST_NS_PRIORITY << 16)	|	\
 	(GIC_HIGHEST_NS_PRIORITY << 24))
 
+/* Value used to initialize Secure interrupt priorities four at a time */
+#define GICD_IPRIORITYR_SEC_VAL			\
+	(GIC_HIGHEST_SEC_PRIORITY	|	\
+	(GIC_HIGHEST_SEC_PRIORITY << 8)	|	\
+	(GIC_HIGHEST_SEC_PRIORITY << 16)	|	\
+	(GIC_HIGHEST_SEC_PRIORITY << 24))
+
 #endif /* __GIC_COMMON_H__ */
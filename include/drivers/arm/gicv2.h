@@ -28,6 +28,12 @@
 #define CPENDSGIR_SHIFT		2
 #define SPENDSGIR_SHIFT		CPENDSGIR_SHIFT
 
+/* GICD_SGIR bit definitions */
+#define SGIR_TGT_FILTER_SHIFT	24
+#define SGIR_TGT_FILTER_SELF	0x2
+#define SGIR_NSATT_BIT		(1 << 15)
+#define SGIR_INTID_MASK		0xf
+
 /*******************************************************************************
  * GICv2 specific CPU interface register offsets and constants.
  ******************************************************************************/
@@ -136,6 +142,8 @@ unsigned int gicv2_get_pending_interrupt_id(void);
 unsigned int gicv2_acknowledge_interrupt(void);
 void gicv2_end_of_interrupt(unsigned int id);
 unsigned int gicv2_get_interrupt_group(unsigned int id);
+void gicv2_raise_ns_sgi(unsigned int sgi_num);
+void gicv2_set_spi_targets(unsigned int id, unsigned int target);
 
 #endif /* __ASSEMBLY__ */
 #endif /* __GICV2_H__ */
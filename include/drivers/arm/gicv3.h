@@ -80,10 +80,13 @@
 #define GICR_IGROUPR0		(GICR_SGIBASE_OFFSET + 0x80)
 #define GICR_ISENABLER0		(GICR_SGIBASE_OFFSET + 0x100)
 #define GICR_ICENABLER0		(GICR_SGIBASE_OFFSET + 0x180)
+#define GICR_ISPENDR0		(GICR_SGIBASE_OFFSET + 0x200)
+#define GICR_ISACTIVER0		(GICR_SGIBASE_OFFSET + 0x300)
 #define GICR_IPRIORITYR		(GICR_SGIBASE_OFFSET + 0x400)
 #define GICR_ICFGR0		(GICR_SGIBASE_OFFSET + 0xc00)
 #define GICR_ICFGR1		(GICR_SGIBASE_OFFSET + 0xc04)
 #define GICR_IGRPMODR0		(GICR_SGIBASE_OFFSET + 0xd00)
+#define GICR_NSACR		(GICR_SGIBASE_OFFSET + 0xe00)
 
 /* GICR_CTLR bit definitions */
 #define GICR_CTLR_RWP_SHIFT	3
@@ -147,8 +150,17 @@
 #define IAR1_EL1_INTID_SHIFT		0
 #define IAR1_EL1_INTID_MASK		0xffffff
 
+/* ICC_SGI0R_EL1 bit definitions */
+#define SGIR_TGT_MASK			0xffff
+#define SGIR_AFF1_SHIFT			16
+#define SGIR_INTID_SHIFT		24
+#define SGIR_INTID_MASK			0xf
+#define SGIR_AFF2_SHIFT			32
+#define SGIR_AFF3_SHIFT			48
+
 #ifndef __ASSEMBLY__
 
+#include <gic_common.h>
 #include <stdint.h>
 #include <types.h>
 
@@ -214,6 +226,14 @@
  *    specific information. If this not the case, the platform port must provide
  *    a hash function. Otherwise, the "Processor Number" field will be used to
  *    access the array elements.
+ *
+ * 10. The 'rdistif_base_addrs_provided' field indicates, when non-zero, that
+ *    the platform has filled the 'rdistif_base_addrs' array itself, e.g. from
+ *    static values or from the device tree, before initialising the driver.
+ *    The driver then does not probe all the Redistributor frames. Instead,
+ *    each entry is checked when the corresponding CPU initialises its
+ *    Redistributor interface, and the frame of the CPU is only looked for if
+ *    the entry is 0 or does not match. This is an optional field.
  ******************************************************************************/
 typedef unsigned int (*mpidr_hash_fn)(u_register_t mpidr);
 
@@ -227,8 +247,52 @@ typedef struct gicv3_driver_data {
 	unsigned int rdistif_num;
 	uintptr_t *rdistif_base_addrs;
 	mpidr_hash_fn mpidr_to_core_pos;
+	unsigned int rdistif_base_addrs_provided;
 } gicv3_driver_data_t;
 
+/*******************************************************************************
+ * Number of SPIs that the GIC can implement, and number of registers needed to
+ * hold the 'REG' field of all of them, given the REG_SHIFT number of SPIs per
+ * register.
+ ******************************************************************************/
+#define TOTAL_SPI_INTR_NUM	(MAX_SPI_ID - MIN_SPI_ID + 1)
+#define GICD_NUM_REGS(REG)	\
+	((TOTAL_SPI_INTR_NUM + (1 << REG##_SHIFT) - 1) >> REG##_SHIFT)
+
+/*******************************************************************************
+ * These structures hold the state of the GIC Distributor and of a GIC
+ * Redistributor saved by gicv3_distif_save() and gicv3_rdistif_save(). They
+ * are provided by the platform, which must keep them in memory that is retained
+ * during the system suspend. The SPI registers are stored in order of interrupt
+ * ID, starting from MIN_SPI_ID. LPIs are not supported by the driver, so the
+ * LPI configuration of the Redistributors is not saved.
+ ******************************************************************************/
+typedef struct gicv3_dist_ctx {
+	uint64_t gicd_irouter[TOTAL_SPI_INTR_NUM];
+	uint32_t gicd_ctlr;
+	uint32_t gicd_igroupr[GICD_NUM_REGS(IGROUPR)];
+	uint32_t gicd_isenabler[GICD_NUM_REGS(ISENABLER)];
+	uint32_t gicd_ispendr[GICD_NUM_REGS(ISPENDR)];
+	uint32_t gicd_isactiver[GICD_NUM_REGS(ISACTIVER)];
+	uint32_t gicd_ipriorityr[GICD_NUM_REGS(IPRIORITYR)];
+	uint32_t gicd_icfgr[GICD_NUM_REGS(ICFGR)];
+	uint32_t gicd_igrpmodr[GICD_NUM_REGS(IGRPMODR)];
+	uint32_t gicd_nsacr[GICD_NUM_REGS(NSACR)];
+} gicv3_dist_ctx_t;
+
+typedef struct gicv3_redist_ctx {
+	uint32_t gicr_ctlr;
+	uint32_t gicr_igroupr0;
+	uint32_t gicr_isenabler0;
+	uint32_t gicr_ispendr0;
+	uint32_t gicr_isactiver0;
+	uint32_t gicr_ipriorityr[MIN_SPI_ID >> IPRIORITYR_SHIFT];
+	uint32_t gicr_icfgr0;
+	uint32_t gicr_icfgr1;
+	uint32_t gicr_igrpmodr0;
+	uint32_t gicr_nsacr;
+} gicv3_redist_ctx_t;
+
 /*******************************************************************************
  * GICv3 EL3 driver API
  ******************************************************************************/
@@ -243,6 +307,19 @@ unsigned int gicv3_get_pending_interrupt_type(void);
 unsigned int gicv3_get_pending_interrupt_id(void);
 unsigned int gicv3_get_interrupt_type(unsigned int id,
 					  unsigned int proc_num);
+unsigned int gicv3_get_running_priority(void);
+unsigned int gicv3_set_pmr(unsigned int mask);
+void gicv3_set_interrupt_priority(unsigned int id, unsigned int proc_num,
+				  unsigned int priority);
+void gicv3_raise_secure_g0_sgi(unsigned int sgi_num, u_register_t target_group,
+			       unsigned int aff0_mask);
+void gicv3_raise_ns_g1_sgi(unsigned int sgi_num, u_register_t target_group,
+			   unsigned int aff0_mask);
+void gicv3_distif_save(gicv3_dist_ctx_t *dist_ctx);
+void gicv3_distif_restore(const gicv3_dist_ctx_t *dist_ctx);
+void gicv3_rdistif_save(unsigned int proc_num, gicv3_redist_ctx_t *rdist_ctx);
+void gicv3_rdistif_restore(unsigned int proc_num,
+			   const gicv3_redist_ctx_t *rdist_ctx);
 
 
 #endif /* __ASSEMBLY__ */
@@ -49,6 +49,10 @@
 #define PL011_UARTFR_RXFE_BIT	4	/* Receive FIFO empty bit in UARTFR register */
 #define PL011_UARTFR_BUSY_BIT	3	/* UART busy bit in UARTFR register */
 
+/* Interrupt mask and clear reg bits */
+#define PL011_UARTIMSC_TXIM       (1 << 5)	/* Transmit interrupt mask */
+#define PL011_UARTICR_TXIC        (1 << 5)	/* Transmit interrupt clear */
+
 /* Control reg bits */
 #if !PL011_GENERIC_UART
 #define PL011_UARTCR_CTSEN        (1 << 15)	/* CTS hardware flow control enable */
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __PL330_H__
+#define __PL330_H__
+
+/* PL330 register offsets */
+#define PL330_DSR_OFF			0x000
+#define PL330_FSRD_OFF			0x030
+#define PL330_FSRC_OFF			0x034
+#define PL330_CSR_OFF(ch)		(0x100 + ((ch) << 3))
+#define PL330_DBGSTATUS_OFF		0xd00
+#define PL330_DBGCMD_OFF		0xd04
+#define PL330_DBGINST0_OFF		0xd08
+#define PL330_DBGINST1_OFF		0xd0c
+#define PL330_CR0_OFF			0xe00
+#define PL330_CRD_OFF			0xe14
+
+/* Register field definitions */
+#define PL330_DSR_DNS			(1 << 9)
+#define PL330_CSR_STATE_MASK		0xf
+#define PL330_CSR_STOPPED		0x0
+#define PL330_CSR_FAULT_COMPLETING	0xe
+#define PL330_CSR_FAULTING		0xf
+#define PL330_DBGSTATUS_BUSY		(1 << 0)
+#define PL330_CR0_NUM_CHNLS_SHIFT	4
+#define PL330_CR0_NUM_CHNLS_MASK	0x7
+#define PL330_CRD_DATA_WIDTH_MASK	0x7
+#define PL330_CRD_DATA_BUFFER_DEP_SHIFT	20
+#define PL330_CRD_DATA_BUFFER_DEP_MASK	0x3ff
+
+/* Size of the buffer holding the channel program */
+#define PL330_PROG_SIZE			64
+
+#ifndef __ASSEMBLY__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Public high level API */
+
+/*
+ * Use the DMA channel 'channel' of the PL330 at 'base' for memory copies, with
+ * Non-secure transfers if 'ns' is not 0. The channel program is written at
+ * 'prog_base', in PL330_PROG_SIZE bytes the PL330 can read with the security
+ * of the transfers.
+ */
+void pl330_init(uintptr_t base, unsigned int channel, uintptr_t prog_base,
+		int ns);
+size_t pl330_get_copy_align(void);
+int pl330_copy(uintptr_t dst, uintptr_t src, size_t length);
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* __PL330_H__ */
@@ -107,6 +107,19 @@
 #include <cdefs.h>
 #include <stdint.h>
 
+/*
+ * A region reprogrammed by tzc400_update_regions(). The fields match the
+ * arguments of tzc400_configure_region().
+ */
+typedef struct tzc400_region_info {
+	unsigned int filters;
+	int region;
+	unsigned long long region_base;
+	unsigned long long region_top;
+	tzc_region_attributes_t sec_attr;
+	unsigned int nsaid_permissions;
+} tzc400_region_info_t;
+
 /*******************************************************************************
  * Function & variable prototypes
  ******************************************************************************/
@@ -122,6 +135,8 @@ void tzc400_configure_region(unsigned int filters,
 void tzc400_set_action(tzc_action_t action);
 void tzc400_enable_filters(void);
 void tzc400_disable_filters(void);
+void tzc400_update_regions(const tzc400_region_info_t *regions,
+			   unsigned int count);
 
 /*
  * Deprecated APIs
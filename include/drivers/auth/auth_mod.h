@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -12,6 +12,7 @@
 #include <auth_common.h>
 #include <cot_def.h>
 #include <img_parser_mod.h>
+#include <stdint.h>
 
 /*
  * Image flags
@@ -36,12 +37,22 @@ int auth_mod_get_parent_id(unsigned int img_id, unsigned int *parent_id);
 int auth_mod_verify_img(unsigned int img_id,
 			void *img_ptr,
 			unsigned int img_len);
+int auth_mod_hash_start(unsigned int img_id);
+int auth_mod_hash_update(void *data_ptr, unsigned int data_len);
+void auth_mod_hash_abort(void);
 
-/* Macro to register a CoT defined as an array of auth_img_desc_t */
+/*
+ * Macro to register a CoT defined as an array of auth_img_desc_t. It also
+ * allocates the flags of the images and the slots of the parent data used by
+ * their authentication methods, which auth_mod_init() resolves.
+ */
 #define REGISTER_COT(_cot) \
 	const auth_img_desc_t *const cot_desc_ptr = \
 			(const auth_img_desc_t *const)&_cot[0]; \
-	unsigned int auth_img_flags[sizeof(_cot)/sizeof(_cot[0])]
+	const unsigned int cot_desc_size = sizeof(_cot)/sizeof(_cot[0]); \
+	unsigned int auth_img_flags[sizeof(_cot)/sizeof(_cot[0])]; \
+	uint8_t auth_img_param_slots[sizeof(_cot)/sizeof(_cot[0])] \
+				    [AUTH_METHOD_NUM]
 
 #endif /* TRUSTED_BOARD_BOOT */
 
@@ -37,6 +37,22 @@ typedef struct crypto_lib_desc_s {
 	/* Verify a hash. Return one of the 'enum crypto_ret_value' options */
 	int (*verify_hash)(void *data_ptr, unsigned int data_len,
 			   void *digest_info_ptr, unsigned int digest_info_len);
+
+	/* Optional incremental hash verification. hash_init starts a hash
+	 * using the algorithm of the given digest info, hash_update adds data
+	 * to it and hash_final compares the result with the digest info. A
+	 * NULL digest info passed to hash_final discards the hash. These
+	 * return one of the 'enum crypto_ret_value' options. The data passed
+	 * to hash_update stays in place until hash_final returns, so a
+	 * hardware engine may only queue it and wait for it in hash_final */
+	int (*hash_init)(void *digest_info_ptr, unsigned int digest_info_len);
+	int (*hash_update)(void *data_ptr, unsigned int data_len);
+	int (*hash_final)(void *digest_info_ptr, unsigned int digest_info_len);
+
+	/* Optional function called once an image has been authenticated. The
+	 * data allocated by the library until then is not used anymore, so
+	 * its memory can be reclaimed */
+	void (*release)(void);
 } crypto_lib_desc_t;
 
 /* Public functions */
@@ -47,6 +63,10 @@ int crypto_mod_verify_signature(void *data_ptr, unsigned int data_len,
 				void *pk_ptr, unsigned int pk_len);
 int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 			   void *digest_info_ptr, unsigned int digest_info_len);
+int crypto_mod_hash_init(void *digest_info_ptr, unsigned int digest_info_len);
+int crypto_mod_hash_update(void *data_ptr, unsigned int data_len);
+int crypto_mod_hash_final(void *digest_info_ptr, unsigned int digest_info_len);
+void crypto_mod_release(void);
 
 /* Macro to register a cryptographic library */
 #define REGISTER_CRYPTO_LIB(_name, _init, _verify_signature, _verify_hash) \
@@ -57,4 +77,38 @@ int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 		.verify_hash = _verify_hash \
 	}
 
+/* Macro to register a cryptographic library with incremental hashing */
+#define REGISTER_CRYPTO_LIB_HASH(_name, _init, _verify_signature, \
+				 _verify_hash, _hash_init, _hash_update, \
+				 _hash_final, _release) \
+	const crypto_lib_desc_t crypto_lib_desc = { \
+		.name = _name, \
+		.init = _init, \
+		.verify_signature = _verify_signature, \
+		.verify_hash = _verify_hash, \
+		.hash_init = _hash_init, \
+		.hash_update = _hash_update, \
+		.hash_final = _hash_final, \
+		.release = _release \
+	}
+
+/*
+ * Macro to register a platform crypto accelerator. Its functions have the same
+ * prototypes as the ones of a library and may be NULL, except for 'init'. They
+ * are tried before the ones of the library, which are used instead when they
+ * return CRYPTO_ERR_UNKNOWN.
+ */
+#define REGISTER_CRYPTO_ACCEL(_name, _init, _verify_signature, \
+			      _verify_hash, _hash_init, _hash_update, \
+			      _hash_final) \
+	const crypto_lib_desc_t crypto_accel_desc = { \
+		.name = _name, \
+		.init = _init, \
+		.verify_signature = _verify_signature, \
+		.verify_hash = _verify_hash, \
+		.hash_init = _hash_init, \
+		.hash_update = _hash_update, \
+		.hash_final = _hash_final \
+	}
+
 #endif /* __CRYPTO_MOD_H__ */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -8,5 +8,7 @@
 #define __MBEDTLS_COMMON_H__
 
 void mbedtls_init(void);
+void mbedtls_heap_release(void);
+void mbedtls_sha256_ce_init(void);
 
 #endif /* __MBEDTLS_COMMON_H__ */
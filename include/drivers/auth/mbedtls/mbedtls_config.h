@@ -54,11 +54,15 @@
 #define MBEDTLS_ECDSA_C
 #define MBEDTLS_ECP_C
 #define MBEDTLS_ECP_DP_SECP256R1_ENABLED
+#define MBEDTLS_ECP_NIST_OPTIM
 #elif (TF_MBEDTLS_KEY_ALG_ID == TF_MBEDTLS_RSA)
 #define MBEDTLS_RSA_C
 #endif
 
 #define MBEDTLS_SHA256_C
+#if TF_MBEDTLS_SHA256_CE
+#define MBEDTLS_SHA256_PROCESS_ALT
+#endif
 
 #define MBEDTLS_VERSION_C
 
@@ -69,6 +73,11 @@
 #define MBEDTLS_MPI_WINDOW_SIZE              2
 #define MBEDTLS_MPI_MAX_SIZE               256
 
+#if (TF_MBEDTLS_KEY_ALG_ID == TF_MBEDTLS_ECDSA)
+/* ECP options: only the SECP256R1 curve is used */
+#define MBEDTLS_ECP_MAX_BITS               256
+#endif
+
 /* Memory buffer allocator options */
 #define MBEDTLS_MEMORY_ALIGN_MULTIPLE        8
 
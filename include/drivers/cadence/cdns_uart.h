@@ -16,6 +16,11 @@
 #define R_UART_CR_RX_EN	(1 << 2) /* RX enabled */
 #define R_UART_CR_TX_EN	(1 << 4) /* TX enabled */
 
+#define R_UART_IER	0x08	/* Interrupt enable */
+#define R_UART_IDR	0x0C	/* Interrupt disable */
+#define R_UART_ISR	0x14	/* Interrupt status, write 1 to clear */
+#define UART_INTR_TEMPTY	(1 << 3) /* TX FIFO empty */
+
 #define R_UART_SR		0x2C
 #define UART_SR_INTR_REMPTY_BIT	1
 #define UART_SR_INTR_TFUL_BIT	4
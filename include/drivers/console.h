@@ -16,5 +16,38 @@ int console_putc(int c);
 int console_getc(void);
 int console_flush(void);
 
+/* Non-blocking output, which drains the console buffers on interrupts */
+#if CONSOLE_BUFFER_TX_IRQ && defined(IMAGE_BL31)
+int console_putc_nowait(int c);
+void console_set_tx_irq(int enable);
+#endif
+
+/*
+ * Per-CPU buffering of the characters printed by BL31 at runtime, output to the
+ * console when the CPU goes idle or on a panic, or from the transmit interrupt
+ * of the console with CONSOLE_BUFFER_TX_IRQ.
+ */
+#if ENABLE_CONSOLE_BUFFER && defined(IMAGE_BL31)
+void console_buffer_start(void);
+int console_buffer_putc(int c);
+void console_buffer_flush(void);
+void console_buffer_flush_all(void);
+void console_buffer_panic_flush(void);
+int console_buffer_read(unsigned int cpu_idx, unsigned long long *pos,
+			char *dst, unsigned int len);
+#else
+static inline void console_buffer_start(void)
+{
+}
+
+static inline void console_buffer_flush(void)
+{
+}
+
+static inline void console_buffer_flush_all(void)
+{
+}
+#endif
+
 #endif /* __CONSOLE_H__ */
 
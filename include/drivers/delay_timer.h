@@ -23,9 +23,23 @@ typedef struct timer_ops {
 	uint32_t clk_div;
 } timer_ops_t;
 
+/*
+ * A timeout measured with the delay timer: it is started with
+ * timeout_init_us() and expires once the given number of microseconds has
+ * elapsed, as reported by timeout_elapsed().
+ */
+typedef struct timeout {
+	uint32_t start;
+	uint32_t ticks;
+} timeout_t;
+
 void mdelay(uint32_t msec);
 void udelay(uint32_t usec);
 void timer_init(const timer_ops_t *ops);
+void timeout_init_us(timeout_t *timeout, uint32_t usec);
+int timeout_elapsed(const timeout_t *timeout);
+int mmio_poll_timeout_32(uintptr_t addr, uint32_t mask, uint32_t val,
+			 uint32_t usec);
 
 
 #endif /* __DELAY_TIMER_H__ */
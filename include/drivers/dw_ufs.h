@@ -106,5 +106,6 @@ typedef struct dw_ufs_params {
 } dw_ufs_params_t;
 
 int dw_ufs_init(dw_ufs_params_t *params);
+int dw_ufs_init_start(dw_ufs_params_t *params);
 
 #endif /* __DW_UFS_H__ */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -12,6 +12,8 @@
 #define EMMC_BLOCK_SIZE			512
 #define EMMC_BLOCK_MASK			(EMMC_BLOCK_SIZE - 1)
 #define EMMC_BOOT_CLK_RATE		(400 * 1000)
+#define EMMC_HS_CLK_RATE		(52 * 1000 * 1000)
+#define EMMC_HS200_CLK_RATE		(200 * 1000 * 1000)
 
 #define EMMC_CMD0			0
 #define EMMC_CMD1			1
@@ -25,6 +27,7 @@
 #define EMMC_CMD13			13
 #define EMMC_CMD17			17
 #define EMMC_CMD18			18
+#define EMMC_CMD21			21
 #define EMMC_CMD23			23
 #define EMMC_CMD24			24
 #define EMMC_CMD25			25
@@ -53,17 +56,39 @@
 #define CMD_EXTCSD_PARTITION_CONFIG	179
 #define CMD_EXTCSD_BUS_WIDTH		183
 #define CMD_EXTCSD_HS_TIMING		185
+#define CMD_EXTCSD_DEVICE_TYPE		196
+#define CMD_EXTCSD_SEC_CNT		212	/* 4 bytes, LSB first */
 
 #define PART_CFG_BOOT_PARTITION1_ENABLE	(1 << 3)
 #define PART_CFG_PARTITION1_ACCESS	(1 << 0)
+#define PART_CFG_PARTITION_ACCESS_MASK	0x7
+
+/* Partitions selected with emmc_select_partition() */
+#define EMMC_PART_USER			0
+#define EMMC_PART_BOOT1			1
+#define EMMC_PART_BOOT2			2
+#define EMMC_PART_RPMB			3
+
+/* Largest device, in blocks, using the byte access mode */
+#define EMMC_BYTE_MODE_MAX_SECTORS	(0x80000000ULL / EMMC_BLOCK_SIZE)
 
 /* values in EXT CSD register */
 #define EMMC_BUS_WIDTH_1		0
 #define EMMC_BUS_WIDTH_4		1
 #define EMMC_BUS_WIDTH_8		2
+#define EMMC_BUS_WIDTH_DDR_4		5
+#define EMMC_BUS_WIDTH_DDR_8		6
 #define EMMC_BOOT_MODE_BACKWARD		(0 << 3)
 #define EMMC_BOOT_MODE_HS_TIMING	(1 << 3)
 #define EMMC_BOOT_MODE_DDR		(2 << 3)
+#define EMMC_HS_TIMING_LEGACY		0
+#define EMMC_HS_TIMING_HS		1
+#define EMMC_HS_TIMING_HS200		2
+#define EMMC_HS_TIMING_HS400		3
+#define EMMC_DEVICE_TYPE_HS_52		(1 << 1)
+#define EMMC_DEVICE_TYPE_DDR_52_1V8	(1 << 2)
+#define EMMC_DEVICE_TYPE_HS200_1V8	(1 << 4)
+#define EMMC_DEVICE_TYPE_HS400_1V8	(1 << 6)
 
 #define EXTCSD_SET_CMD			(0 << 24)
 #define EXTCSD_SET_BITS			(1 << 24)
@@ -89,6 +114,28 @@
 #define EMMC_STATE_SLP			10
 
 #define EMMC_FLAG_CMD23			(1 << 0)
+/*
+ * Bus timings supported by the host and the board, used when the device
+ * supports them too. HS200 and HS400 need 1.8V signalling on the bus.
+ */
+#define EMMC_FLAG_HS			(1 << 1)
+#define EMMC_FLAG_DDR52			(1 << 2)
+#define EMMC_FLAG_HS200			(1 << 3)
+#define EMMC_FLAG_HS400			(1 << 4)
+/*
+ * The device may have been left in transfer state, with the relative address
+ * EMMC_FIX_RCA, by an earlier boot stage. Its identification is then skipped,
+ * falling back to a full enumeration if it does not answer at that address.
+ * Only for eMMC 4.0 and later devices.
+ */
+#define EMMC_FLAG_PREINIT		(1 << 5)
+
+/* Timings passed to the set_timing() operation of the host driver */
+#define EMMC_TIMING_LEGACY		0
+#define EMMC_TIMING_HS			1
+#define EMMC_TIMING_DDR52		2
+#define EMMC_TIMING_HS200		3
+#define EMMC_TIMING_HS400		4
 
 typedef struct emmc_cmd {
 	unsigned int	cmd_idx;
@@ -104,6 +151,13 @@ typedef struct emmc_ops {
 	int (*prepare)(int lba, uintptr_t buf, size_t size);
 	int (*read)(int lba, uintptr_t buf, size_t size);
 	int (*write)(int lba, const uintptr_t buf, size_t size);
+	/* Optional, required by the DDR52, HS200 and HS400 timings */
+	int (*set_timing)(int timing);
+	/*
+	 * Optional, required by the HS200 and HS400 timings. Select the sample
+	 * point using CMD21 on a bus of the given width, return 0 on success.
+	 */
+	int (*execute_tuning)(int width);
 } emmc_ops_t;
 
 typedef struct emmc_csd {
@@ -151,11 +205,14 @@ typedef struct emmc_csd {
 } emmc_csd_t;
 
 size_t emmc_read_blocks(int lba, uintptr_t buf, size_t size);
+int emmc_read_blocks_start(int lba, uintptr_t buf, size_t size);
+size_t emmc_read_blocks_wait(void);
 size_t emmc_write_blocks(int lba, const uintptr_t buf, size_t size);
 size_t emmc_erase_blocks(int lba, size_t size);
 size_t emmc_rpmb_read_blocks(int lba, uintptr_t buf, size_t size);
 size_t emmc_rpmb_write_blocks(int lba, const uintptr_t buf, size_t size);
 size_t emmc_rpmb_erase_blocks(int lba, size_t size);
+void emmc_select_partition(unsigned int part);
 void emmc_init(const emmc_ops_t *ops, int clk, int bus_width,
 	       unsigned int flags);
 
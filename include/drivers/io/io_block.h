@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -9,16 +9,39 @@
 
 #include <io_storage.h>
 
-/* block devices ops */
+/*
+ * block devices ops
+ * read may be asked for any number of whole blocks, up to the size of the
+ * largest image read from the device.
+ * read_start and read_wait are optional. When provided, read_start issues a
+ * block aligned read and returns while the transfer is in progress, and
+ * read_wait waits for it to complete and returns the number of bytes read.
+ */
 typedef struct io_block_ops {
 	size_t	(*read)(int lba, uintptr_t buf, size_t size);
 	size_t	(*write)(int lba, const uintptr_t buf, size_t size);
+	int	(*read_start)(int lba, uintptr_t buf, size_t size);
+	size_t	(*read_wait)(void);
 } io_block_ops_t;
 
+/*
+ * cache is optional. When its length isn't zero, blocks read one at a time are
+ * kept in this region and the least recently used one is replaced on a miss.
+ * Blocks written to the device are updated in the cache if cache_write_through
+ * is set, and dropped from it otherwise.
+ *
+ * readahead is optional too and needs the read_start and read_wait ops. When
+ * its length isn't zero, a read following the previous one on the device
+ * starts the read of the blocks after it into this region, to be copied from
+ * there by the next read. The region must not overlap the buffer or the cache.
+ */
 typedef struct io_block_dev_spec {
 	io_block_spec_t	buffer;
 	io_block_ops_t	ops;
 	size_t		block_size;
+	io_block_spec_t	cache;
+	int		cache_write_through;
+	io_block_spec_t	readahead;
 } io_block_dev_spec_t;
 
 struct io_dev_connector;
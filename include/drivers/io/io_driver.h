@@ -43,6 +43,18 @@ typedef struct io_dev_funcs {
 	int (*size)(io_entity_t *entity, size_t *length);
 	int (*read)(io_entity_t *entity, uintptr_t buffer, size_t length,
 			size_t *length_read);
+	/*
+	 * Optional split read: read_start() queues the transfer and returns
+	 * while it is in progress, read_wait() blocks until it completes.
+	 */
+	int (*read_start)(io_entity_t *entity, uintptr_t buffer,
+			size_t length);
+	int (*read_wait)(io_entity_t *entity, size_t *length_read);
+	/*
+	 * Optional: return the address at which the next 'length' bytes of a
+	 * memory-mapped entity can be accessed in place, and move past them.
+	 */
+	int (*map)(io_entity_t *entity, size_t length, uintptr_t *addr);
 	int (*write)(io_entity_t *entity, const uintptr_t buffer,
 			size_t length, size_t *length_written);
 	int (*close)(io_entity_t *entity);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2017, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,8 +7,25 @@
 #ifndef __IO_MEMMAP_H__
 #define __IO_MEMMAP_H__
 
+#include <stddef.h>
+#include <stdint.h>
+
 struct io_dev_connector;
 
+/*
+ * Optional device specification passed to io_dev_open() for the memmap device.
+ * It lets the reads of at least 'min_length' bytes be copied by a DMA engine
+ * through 'copy'. The engine copies the part of the data aligned to 'align'
+ * (a power of 2) at both ends, the rest is copied by the CPU. 'copy' returns 0
+ * once the data is in memory, or an error code if the engine can't do the copy,
+ * in which case the CPU copies the data instead.
+ */
+typedef struct io_memmap_dev_spec {
+	int (*copy)(uintptr_t dst, uintptr_t src, size_t length);
+	size_t align;
+	size_t min_length;
+} io_memmap_dev_spec_t;
+
 int register_io_dev_memmap(const struct io_dev_connector **dev_con);
 
 #endif /* __IO_MEMMAP_H__ */
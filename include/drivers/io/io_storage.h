@@ -61,6 +61,18 @@ typedef struct io_block_spec {
 } io_block_spec_t;
 
 
+/*
+ * Statistics of the reads from a device, including the reads from its backend
+ * devices, kept with IO_STORAGE_STATS. 'ticks' is the time spent in the read
+ * functions, in system counter ticks, so the time a read started by
+ * io_read_start() spends in flight is not accounted.
+ */
+typedef struct io_dev_stats {
+	unsigned long long bytes;
+	unsigned long long ticks;
+} io_dev_stats_t;
+
+
 /* Access modes used when accessing data on a device */
 #define IO_MODE_INVALID (0)
 #define IO_MODE_RO	(1 << 0)
@@ -99,4 +111,20 @@ int io_write(uintptr_t handle, const uintptr_t buffer, size_t length,
 int io_close(uintptr_t handle);
 
 
+/* Asynchronous operations */
+int io_read_start(uintptr_t handle, uintptr_t buffer, size_t length);
+
+int io_read_wait(uintptr_t handle, size_t *length_read);
+
+int io_read_is_async(uintptr_t handle);
+
+
+/* Zero-copy access to memory-mapped storage */
+int io_map(uintptr_t handle, size_t length, uintptr_t *addr);
+
+
+/* Statistics of the reads */
+int io_dev_get_stats(uintptr_t dev_handle, io_dev_stats_t *stats);
+
+
 #endif /* __IO_H__ */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -20,15 +20,29 @@ CASSERT(PLAT_PARTITION_MAX_ENTRIES <= 128, assert_plat_partition_max_entries);
 
 #define EFI_NAMELEN			36
 
+/* Value of the magic field once the partition table has been loaded */
+#define PARTITION_LIST_MAGIC		0x50544142	/* "PTAB" */
+#define PARTITION_HASH_BUCKETS		16
+
 typedef struct partition_entry {
 	uint64_t		start;
 	uint64_t		length;
 	char			name[EFI_NAMELEN];
 } partition_entry_t;
 
+/*
+ * The entries are chained by the hash of their name: hash_head holds, for
+ * each bucket, one plus the index of the first entry in the bucket and
+ * hash_next the same for the entry following each entry, 0 ending the chain.
+ * When PLAT_PARTITION_TABLE_BASE is defined, the list is kept at that address
+ * so that later boot stages can use it without parsing the table again.
+ */
 typedef struct partition_entry_list {
 	partition_entry_t	list[PLAT_PARTITION_MAX_ENTRIES];
 	int			entry_count;
+	unsigned int		magic;
+	uint8_t			hash_head[PARTITION_HASH_BUCKETS];
+	uint8_t			hash_next[PLAT_PARTITION_MAX_ENTRIES];
 } partition_entry_list_t;
 
 int load_partition_table(unsigned int image_id);
@@ -14,6 +14,12 @@ typedef struct dw_mmc_params {
 	int		clk_rate;
 	int		bus_width;
 	unsigned int	flags;
+	/*
+	 * Optional, needed by the HS200 and HS400 timings: select the sample
+	 * phase of the card clock among num_phases equally spaced phases.
+	 */
+	void		(*set_sample_phase)(unsigned int phase);
+	unsigned int	num_phases;
 } dw_mmc_params_t;
 
 void dw_mmc_init(dw_mmc_params_t *params);
@@ -499,6 +499,12 @@ typedef struct uic_cmd {
 	uint32_t	arg3;
 } uic_cmd_t;
 
+/*
+ * desc_base must be aligned to 1KB. The region holds the UTP Transfer Request
+ * List in its first 1KB, followed by a 1KB command descriptor for each slot
+ * used, so desc_size must be at least 2KB. Larger regions let more commands be
+ * queued.
+ */
 typedef struct ufs_params {
 	uintptr_t	reg_base;
 	uintptr_t	desc_base;
@@ -523,7 +529,11 @@ void ufs_clear_flag(int idn);
 void ufs_read_desc(int idn, int index, uintptr_t buf, size_t size);
 void ufs_write_desc(int idn, int index, uintptr_t buf, size_t size);
 size_t ufs_read_blocks(int lun, int lba, uintptr_t buf, size_t size);
+int ufs_read_blocks_start(int lun, int lba, uintptr_t buf, size_t size);
+size_t ufs_read_blocks_wait(void);
 size_t ufs_write_blocks(int lun, int lba, const uintptr_t buf, size_t size);
 int ufs_init(const ufs_ops_t *ops, ufs_params_t *params);
+int ufs_init_start(const ufs_ops_t *ops, ufs_params_t *params);
+void ufs_init_wait(void);
 
 #endif /* __UFS_H__ */
@@ -68,6 +68,7 @@
 #define ICC_CTLR_EL1    S3_0_C12_C12_4
 #define ICC_CTLR_EL3    S3_6_C12_C12_4
 #define ICC_PMR_EL1     S3_0_C4_C6_0
+#define ICC_RPR_EL1     S3_0_C12_C11_3
 #define ICC_IGRPEN1_EL3 S3_6_c12_c12_7
 #define ICC_IGRPEN0_EL1 S3_0_c12_c12_6
 #define ICC_HPPIR0_EL1  S3_0_c12_c8_2
@@ -76,6 +77,23 @@
 #define ICC_IAR1_EL1    S3_0_c12_c12_0
 #define ICC_EOIR0_EL1   S3_0_c12_c8_1
 #define ICC_EOIR1_EL1   S3_0_c12_c12_1
+#define ICC_SGI1R_EL1   S3_0_c12_c11_5
+#define ICC_ASGI1R_EL1  S3_0_c12_c11_6
+#define ICC_SGI0R_EL1   S3_0_c12_c11_7
+
+/*******************************************************************************
+ * Definitions for the system register interface to the RAS error records
+ ******************************************************************************/
+#define ERRIDR_EL1	S3_0_C5_C3_0
+#define ERRSELR_EL1	S3_0_C5_C3_1
+#define ERXFR_EL1	S3_0_C5_C4_0
+#define ERXCTLR_EL1	S3_0_C5_C4_1
+#define ERXSTATUS_EL1	S3_0_C5_C4_2
+#define ERXADDR_EL1	S3_0_C5_C4_3
+#define ERXMISC0_EL1	S3_0_C5_C5_0
+#define ERXMISC1_EL1	S3_0_C5_C5_1
+
+#define ERRIDR_NUM_MASK	0xffff
 
 /*******************************************************************************
  * Generic timer memory mapped registers & offsets
@@ -118,6 +136,14 @@
 #define ID_AA64PFR0_GIC_WIDTH	4
 #define ID_AA64PFR0_GIC_MASK	((1 << ID_AA64PFR0_GIC_WIDTH) - 1)
 
+/* ID_AA64ISAR0_EL1 definitions */
+#define ID_AA64ISAR0_ATOMIC_SHIFT	20
+#define ID_AA64ISAR0_ATOMIC_WIDTH	4
+#define ID_AA64ISAR0_ATOMIC_LSE		2
+#define ID_AA64ISAR0_SHA2_SHIFT		12
+#define ID_AA64ISAR0_SHA2_MASK		0xf
+#define ID_AA64ISAR0_SHA2_SHA256	1
+
 /* ID_AA64MMFR0_EL1 definitions */
 #define ID_AA64MMFR0_EL1_PARANGE_MASK	0xf
 
@@ -189,6 +215,7 @@
 /* HCR definitions */
 #define HCR_RW_SHIFT		31
 #define HCR_RW_BIT		(1ull << HCR_RW_SHIFT)
+#define HCR_TGE_BIT		(1 << 27)
 #define HCR_AMO_BIT		(1 << 5)
 #define HCR_IMO_BIT		(1 << 4)
 #define HCR_FMO_BIT		(1 << 3)
@@ -292,6 +319,12 @@
 #define TCR_SH_OUTER_SHAREABLE	(0x2 << 12)
 #define TCR_SH_INNER_SHAREABLE	(0x3 << 12)
 
+#define TCR_TG0_SHIFT		14
+#define TCR_TG0_MASK		(0x3 << TCR_TG0_SHIFT)
+#define TCR_TG0_4K		(0x0 << TCR_TG0_SHIFT)
+#define TCR_TG0_64K		(0x1 << TCR_TG0_SHIFT)
+#define TCR_TG0_16K		(0x2 << TCR_TG0_SHIFT)
+
 #define MODE_SP_SHIFT		0x0
 #define MODE_SP_MASK		0x1
 #define MODE_SP_EL0		0x0
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __BOOT_PROF_H__
+#define __BOOT_PROF_H__
+
+/*
+ * Boot milestones recorded for each image. The PMF time-stamp id of a
+ * milestone is BOOT_PROF_TID(image_id, event).
+ */
+#define BOOT_PROF_OPEN		0
+#define BOOT_PROF_LOAD_END	1
+#define BOOT_PROF_AUTH_END	2
+#define BOOT_PROF_FLUSH_END	3
+#define BOOT_PROF_HANDOFF	4
+#define BOOT_PROF_EVENTS	5
+
+/* Milestones of images with a higher ID are not recorded */
+#define BOOT_PROF_MAX_IMAGES	32
+
+#define BOOT_PROF_TID(_image_id, _event)	\
+	(((_image_id) * BOOT_PROF_EVENTS) + (_event))
+#define BOOT_PROF_TOTAL_IDS	(BOOT_PROF_MAX_IMAGES * BOOT_PROF_EVENTS)
+
+/* Size of the platform memory holding the time-stamps */
+#define BOOT_PROF_SIZE		(BOOT_PROF_TOTAL_IDS * 8)
+
+#ifndef __ASSEMBLY__
+#if ENABLE_BOOT_PROFILE
+void boot_prof_init(void);
+void boot_prof_capture(unsigned int image_id, unsigned int event);
+
+#define BOOT_PROF_CAPTURE(_image_id, _event)	\
+	boot_prof_capture((_image_id), (_event))
+#else
+#define BOOT_PROF_CAPTURE(_image_id, _event)
+#endif /* ENABLE_BOOT_PROFILE */
+#endif /* __ASSEMBLY__ */
+
+#endif /* __BOOT_PROF_H__ */
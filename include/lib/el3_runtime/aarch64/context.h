@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2017, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -56,7 +56,12 @@
 #define CTX_RUNTIME_SP		0x8
 #define CTX_SPSR_EL3		0x10
 #define CTX_ELR_EL3		0x18
+#if CTX_LAZY_FPREGS
+#define CTX_FPREGS_LIVE		0x20
+#define CTX_EL3STATE_END	0x30 /* Align to the next 16 byte boundary */
+#else
 #define CTX_EL3STATE_END	0x20
+#endif
 
 /*******************************************************************************
  * Constants that allow assembler code to access members of and the
@@ -309,6 +314,9 @@ CASSERT(CTX_EL3STATE_OFFSET == __builtin_offsetof(cpu_context_t, el3state_ctx),
  ******************************************************************************/
 void el1_sysregs_context_save(el1_sys_regs_t *regs);
 void el1_sysregs_context_restore(el1_sys_regs_t *regs);
+#if CTX_SKIP_SP_UNUSED_SYSREGS
+void el1_sysregs_context_restore_all(el1_sys_regs_t *regs);
+#endif
 #if CTX_INCLUDE_FPREGS
 void fpregs_context_save(fp_regs_t *regs);
 void fpregs_context_restore(fp_regs_t *regs);
@@ -27,6 +27,8 @@ void *cm_get_context_by_index(unsigned int cpu_idx,
 void cm_set_context_by_index(unsigned int cpu_idx,
 			     void *context,
 			     unsigned int security_state);
+void *cm_get_context_slot_by_index(unsigned int cpu_idx,
+				   unsigned int security_state);
 void *cm_get_context(uint32_t security_state);
 void cm_set_context(void *context, uint32_t security_state);
 void cm_init_my_context(const struct entry_point_info *ep);
@@ -35,6 +37,7 @@ void cm_init_context_by_index(unsigned int cpu_idx,
 void cm_prepare_el3_exit(uint32_t security_state);
 
 #ifndef AARCH32
+void cm_prepare_el3_exit_state_switch(void);
 void cm_el1_sysregs_context_save(uint32_t security_state);
 void cm_el1_sysregs_context_restore(uint32_t security_state);
 void cm_set_elr_el3(uint32_t security_state, uintptr_t entrypoint);
@@ -45,6 +48,9 @@ void cm_write_scr_el3_bit(uint32_t security_state,
 			  uint32_t value);
 void cm_set_next_eret_context(uint32_t security_state);
 uint32_t cm_get_scr_el3(uint32_t security_state);
+#if CTX_LAZY_FPREGS
+void cm_handle_fpregs_trap(void);
+#endif
 
 
 void cm_init_context(uint64_t mpidr,
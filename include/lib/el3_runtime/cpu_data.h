@@ -17,26 +17,27 @@
 #else /* AARCH32 */
 
 /* Offsets for the cpu_data structure */
-#define CPU_DATA_CRASH_BUF_OFFSET	0x18
+#define CPU_DATA_CPU_OPS_PTR		0x10
+#define CPU_DATA_PMF_TS0_OFFSET		0x18
+/*
+ * The crash buffer is only used on a crash, so it starts on the second cache
+ * line, leaving the first one to the fields used on every exception.
+ */
+#define CPU_DATA_CRASH_BUF_OFFSET	0x40
 /* need enough space in crash buffer to save 8 registers */
 #define CPU_DATA_CRASH_BUF_SIZE		64
-#define CPU_DATA_CPU_OPS_PTR		0x10
 
 #endif /* AARCH32 */
 
 #if CRASH_REPORTING
 #define CPU_DATA_LOG2SIZE		7
-#define CPU_DATA_CRASH_BUF_END		(CPU_DATA_CRASH_BUF_OFFSET + \
-						CPU_DATA_CRASH_BUF_SIZE)
 #else
 #define CPU_DATA_LOG2SIZE		6
-#define CPU_DATA_CRASH_BUF_END		CPU_DATA_CRASH_BUF_OFFSET
 #endif
 
 #if ENABLE_RUNTIME_INSTRUMENTATION
 /* Temporary space to store PMF timestamps from assembly code */
 #define CPU_DATA_PMF_TS_COUNT		1
-#define CPU_DATA_PMF_TS0_OFFSET		CPU_DATA_CRASH_BUF_END
 #define CPU_DATA_PMF_TS0_IDX		0
 #endif
 
@@ -66,7 +67,9 @@
  *   Pointers to non-secure and secure security state contexts
  *   Address of the crash stack
  * It is aligned to the cache line boundary to allow efficient concurrent
- * manipulation of these pointers on different cpus
+ * manipulation of these pointers on different cpus. The fields used on the
+ * SMC and PSCI paths are kept in the first cache line, ahead of the crash
+ * buffer.
  *
  * TODO: Add other commonly used variables to this (tf_issues#90)
  *
@@ -79,13 +82,14 @@ typedef struct cpu_data {
 	void *cpu_context[2];
 #endif
 	uintptr_t cpu_ops_ptr;
-#if CRASH_REPORTING
-	u_register_t crash_buf[CPU_DATA_CRASH_BUF_SIZE >> 3];
-#endif
 #if ENABLE_RUNTIME_INSTRUMENTATION
 	uint64_t cpu_data_pmf_ts[CPU_DATA_PMF_TS_COUNT];
 #endif
 	struct psci_cpu_data psci_svc_cpu_data;
+#if CRASH_REPORTING
+	u_register_t crash_buf[CPU_DATA_CRASH_BUF_SIZE >> 3]
+		__aligned(CPU_DATA_CRASH_BUF_OFFSET);
+#endif
 #if PLAT_PCPU_DATA_SIZE
 	uint8_t platform_cpu_data[PLAT_PCPU_DATA_SIZE];
 #endif
@@ -98,6 +102,11 @@ CASSERT(CPU_DATA_CRASH_BUF_OFFSET == __builtin_offsetof
 	assert_cpu_data_crash_stack_offset_mismatch);
 #endif
 
+/* The fields used on every exception must fit in the first cache line */
+CASSERT(__builtin_offsetof(cpu_data_t, psci_svc_cpu_data) +
+	sizeof(psci_cpu_data_t) <= CACHE_WRITEBACK_GRANULE,
+	assert_cpu_data_hot_fields_size);
+
 CASSERT((1 << CPU_DATA_LOG2SIZE) == sizeof(cpu_data_t),
 	assert_cpu_data_log2size_mismatch);
 
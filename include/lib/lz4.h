@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __LZ4_H__
+#define __LZ4_H__
+
+/* LZ4 frame format, as described in the lz4_Frame_format.md of the LZ4 C lib */
+#define LZ4_FRAME_MAGIC			0x184D2204
+
+/* Frame descriptor flags (FLG) */
+#define LZ4_FLG_VERSION_MASK		(3 << 6)
+#define LZ4_FLG_VERSION			(1 << 6)
+#define LZ4_FLG_BLOCK_INDEP		(1 << 5)
+#define LZ4_FLG_BLOCK_CHECKSUM		(1 << 4)
+#define LZ4_FLG_CONTENT_SIZE		(1 << 3)
+#define LZ4_FLG_CONTENT_CHECKSUM	(1 << 2)
+#define LZ4_FLG_DICT_ID			(1 << 0)
+
+/* Block size word, the data of a block being stored as is with this bit set */
+#define LZ4_BLOCK_UNCOMPRESSED		(1U << 31)
+#define LZ4_BLOCK_SIZE_MASK		(~LZ4_BLOCK_UNCOMPRESSED)
+
+/*
+ * Size of the frame header holding the content size: magic number, FLG and BD
+ * bytes, content size and header checksum.
+ */
+#define LZ4_FRAME_HEADER_SIZE		15
+
+#ifndef __ASSEMBLY__
+
+#include <stddef.h>
+
+int lz4_decompress_block(const void *src, size_t src_len, void *dst,
+			 size_t dst_len, size_t *out_len);
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* __LZ4_H__ */
@@ -49,6 +49,28 @@ static inline uint64_t mmio_read_64(uintptr_t addr)
 	return *(volatile uint64_t*)addr;
 }
 
+/*
+ * Save and restore a block of 'count' consecutive 32-bit registers starting at
+ * 'addr', such as the context of a peripheral across a power down.
+ */
+static inline void mmio_read_32_range(uintptr_t addr, uint32_t *buf,
+				      unsigned int count)
+{
+	unsigned int i;
+
+	for (i = 0; i < count; i++)
+		buf[i] = mmio_read_32(addr + (i * sizeof(uint32_t)));
+}
+
+static inline void mmio_write_32_range(uintptr_t addr, const uint32_t *buf,
+				       unsigned int count)
+{
+	unsigned int i;
+
+	for (i = 0; i < count; i++)
+		mmio_write_32(addr + (i * sizeof(uint32_t)), buf[i]);
+}
+
 static inline void mmio_clrbits_32(uintptr_t addr, uint32_t clear)
 {
 	mmio_write_32(addr, mmio_read_32(addr) & ~clear);
@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __NS_RANGE_H__
+#define __NS_RANGE_H__
+
+/* Security attributes of the memory described to the index */
+#define NS_RANGE_SECURE		0
+#define NS_RANGE_NS		1
+
+#ifndef __ASSEMBLY__
+
+/*******************************************************************************
+ * Function prototypes
+ ******************************************************************************/
+void ns_range_add(unsigned long long base, unsigned long long size,
+		  unsigned int attr);
+int is_ns_range(unsigned long long base, unsigned long long size);
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* __NS_RANGE_H__ */
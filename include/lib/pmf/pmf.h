@@ -39,7 +39,13 @@
  */
 #define PMF_SMC_GET_TIMESTAMP_32	0x82000010
 #define PMF_SMC_GET_TIMESTAMP_64	0xC2000010
+#define PMF_SMC_SET_NS_BUFFER_64	0xC2000011
+#define PMF_SMC_COPY_TIMESTAMPS_64	0xC2000012
+#if PMF_NS_BUFFER
+#define PMF_NUM_SMC_CALLS		4
+#else
 #define PMF_NUM_SMC_CALLS		2
+#endif
 
 /*
  * The macros below are used to identify
@@ -52,6 +58,7 @@
 /* Following are the supported PMF service IDs */
 #define PMF_PSCI_STAT_SVC_ID	0
 #define PMF_RT_INSTR_SVC_ID	1
+#define PMF_BOOT_PROF_SVC_ID	2
 
 #if ENABLE_PMF
 /*
@@ -130,7 +137,8 @@
 	PMF_REGISTER_SERVICE(_name, _svcid, _totalid, _flags)	\
 	PMF_DEFINE_SERVICE_DESC(_name, PMF_ARM_TIF_IMPL_ID,	\
 			_svcid, _totalid, NULL,			\
-			pmf_get_timestamp_by_mpidr_ ## _name)
+			pmf_get_timestamp_by_mpidr_ ## _name,	\
+			pmf_ts_mem_ ## _name)
 
 /*
  * This macro is used to register a PMF service that has an SMC interface
@@ -139,7 +147,7 @@
 #define PMF_REGISTER_SERVICE_SMC_OWN(_name, _implid, _svcid, _totalid,	\
 		 _init, _getts)						\
 	PMF_DEFINE_SERVICE_DESC(_name, _implid, _svcid, _totalid,	\
-		 _init, _getts)
+		 _init, _getts, NULL)
 
 #else
 
@@ -164,6 +172,12 @@ int pmf_get_timestamp_smc(unsigned int tid,
 		unsigned int flags,
 		unsigned long long *ts);
 int pmf_setup(void);
+#if PMF_NS_BUFFER
+int pmf_set_ns_buffer_smc(uintptr_t base, size_t size);
+int pmf_copy_timestamps_smc(unsigned int tid,
+		unsigned int flags,
+		size_t *copied);
+#endif
 uintptr_t pmf_smc_handler(unsigned int smc_fid,
 		u_register_t x1,
 		u_register_t x2,
@@ -41,6 +41,9 @@ typedef struct pmf_svc_desc {
 
 	/* PMF service time-stamp retrieval handler */
 	pmf_svc_get_ts_t get_ts;
+
+	/* Time-stamp memory allocated by PMF, NULL for own services */
+	unsigned long long *ts_mem;
 } pmf_svc_desc_t;
 
 /*
@@ -112,7 +115,7 @@ typedef struct pmf_svc_desc {
  * This is needed for services that require SMC handling.
  */
 #define PMF_DEFINE_SERVICE_DESC(_name, _implid, _svcid, _totalid,	\
-		_init, _getts_by_mpidr) 				\
+		_init, _getts_by_mpidr, _ts_mem)			\
 	static const pmf_svc_desc_t __pmf_desc_ ## _name 		\
 	__section("pmf_svc_descs") __used = {		 		\
 		.h.type = PARAM_EP, 					\
@@ -127,7 +130,8 @@ typedef struct pmf_svc_desc {
 				(((_totalid) << PMF_TID_SHIFT) &	\
 						PMF_TID_MASK)),		\
 		.init = _init,						\
-		.get_ts = _getts_by_mpidr				\
+		.get_ts = _getts_by_mpidr,				\
+		.ts_mem = _ts_mem					\
 	};
 
 /* PMF internal functions */
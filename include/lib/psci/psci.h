@@ -60,10 +60,17 @@
 #define PSCI_NODE_HW_STATE_AARCH64	0xc400000d
 #define PSCI_SYSTEM_SUSPEND_AARCH32	0x8400000E
 #define PSCI_SYSTEM_SUSPEND_AARCH64	0xc400000E
+#define PSCI_SET_SUSPEND_MODE		0x8400000F
 #define PSCI_STAT_RESIDENCY_AARCH32	0x84000010
 #define PSCI_STAT_RESIDENCY_AARCH64	0xc4000010
 #define PSCI_STAT_COUNT_AARCH32		0x84000011
 #define PSCI_STAT_COUNT_AARCH64		0xc4000011
+#define PSCI_SYSTEM_RESET2_AARCH32	0x84000012
+#define PSCI_SYSTEM_RESET2_AARCH64	0xc4000012
+#define PSCI_MEM_PROTECT		0x84000013
+#define PSCI_MEM_CHK_RANGE_AARCH32	0x84000014
+#define PSCI_MEM_CHK_RANGE_AARCH64	0xc4000014
+#define PSCI_CPU_FREEZE			0x84000015
 
 /* Macro to help build the psci capabilities bitfield */
 #define define_psci_cap(x)		(1 << (x & 0x1f))
@@ -72,11 +79,27 @@
  * Number of PSCI calls (above) implemented
  */
 #if ENABLE_PSCI_STAT
-#define PSCI_NUM_CALLS			22
+#define PSCI_STAT_NUM_CALLS		4
 #else
-#define PSCI_NUM_CALLS			18
+#define PSCI_STAT_NUM_CALLS		0
 #endif
 
+#if PSCI_OS_INIT_MODE
+#define PSCI_OS_INIT_NUM_CALLS		1
+#else
+#define PSCI_OS_INIT_NUM_CALLS		0
+#endif
+
+#if ENABLE_PSCI_CPU_FREEZE
+#define PSCI_FREEZE_NUM_CALLS		1
+#else
+#define PSCI_FREEZE_NUM_CALLS		0
+#endif
+
+#define PSCI_NUM_CALLS			(23 + PSCI_STAT_NUM_CALLS +	\
+					 PSCI_OS_INIT_NUM_CALLS +	\
+					 PSCI_FREEZE_NUM_CALLS)
+
 /* The macros below are used to identify PSCI calls from the SMC function ID */
 #define PSCI_FID_MASK			0xffe0u
 #define PSCI_FID_VALUE			0u
@@ -90,6 +113,16 @@
 #define PSCI_TOS_NOT_UP_MIG_CAP	1
 #define PSCI_TOS_NOT_PRESENT_MP	2
 
+/*******************************************************************************
+ * PSCI SYSTEM_RESET2 'reset_type' parameter specific defines
+ ******************************************************************************/
+#define PSCI_RESET2_TYPE_VENDOR_SHIFT	31
+#define PSCI_RESET2_TYPE_VENDOR		(1U << PSCI_RESET2_TYPE_VENDOR_SHIFT)
+#define PSCI_RESET2_TYPE_ARCH		(0U << PSCI_RESET2_TYPE_VENDOR_SHIFT)
+
+/* Warm reset of the system, which preserves the content of the memory */
+#define PSCI_RESET2_SYSTEM_WARM_RESET	(PSCI_RESET2_TYPE_ARCH | 0)
+
 /*******************************************************************************
  * PSCI CPU_SUSPEND 'power_state' parameter specific defines
  ******************************************************************************/
@@ -179,6 +212,16 @@ typedef enum {
 	AFF_STATE_ON_PENDING = 2
 } aff_info_state_t;
 
+/*
+ * These are the suspend modes that can be selected with the
+ * PSCI_SET_SUSPEND_MODE API. The definitions of these modes can be found in
+ * Section 5.20 of the PSCI specification (ARM DEN 0022C).
+ */
+typedef enum {
+	PLAT_COORD = 0,
+	OS_INIT = 1
+} suspend_mode_t;
+
 /*
  * These are the power states reported by PSCI_NODE_HW_STATE API for the
  * specified CPU. The definitions of these states can be found in Section 5.15.3
@@ -237,8 +280,37 @@ typedef struct psci_power_state {
 	 * for the CPU.
 	 */
 	plat_local_state_t pwr_domain_state[PLAT_MAX_PWR_LVL + 1];
+
+	/*
+	 * For CPU_SUSPEND and SYSTEM_SUSPEND, the number of system counter
+	 * ticks until the first timer of the CPU is due to fire, or
+	 * PSCI_WAKE_TIME_NONE if none is armed. The platform can use it in
+	 * pwr_domain_suspend() to choose the depth of its idle states.
+	 */
+	unsigned long long wake_time;
 } psci_power_state_t;
 
+#define PSCI_WAKE_TIME_NONE	(~0ULL)
+
+/*******************************************************************************
+ * Structure used by the platform to describe the cost of a local power state
+ * at a power level to the PSCI suspend governor and to the normal world. Times
+ * are in microseconds.
+ ******************************************************************************/
+typedef struct plat_psci_idle_state {
+	unsigned int pwrlvl;
+	plat_local_state_t local_state;
+
+	/* Minimum residency for which entering this state saves energy */
+	u_register_t target_residency;
+
+	/* Time taken to enter this state */
+	u_register_t entry_latency;
+
+	/* Time taken to resume from this state */
+	u_register_t exit_latency;
+} plat_psci_idle_state_t;
+
 /*******************************************************************************
  * Structure used to store per-cpu information relevant to the PSCI service.
  * It is populated in the per-cpu data array. In return we get a guarantee that
@@ -256,6 +328,19 @@ typedef struct psci_cpu_data {
 
 	/* The local power state of this CPU */
 	plat_local_state_t local_state;
+
+#if ENABLE_PSCI_CPU_FREEZE
+	/* Set while the CPU waits in CPU_FREEZE with AFF_STATE_OFF */
+	unsigned char frozen;
+#endif
+
+#if PSCI_CACHE_ALIGNED_STATE
+	/*
+	 * The local power states requested by this CPU for each of its
+	 * ancestor power domains, indexed by power level - 1.
+	 */
+	plat_local_state_t req_local_pwr_states[PLAT_MAX_PWR_LVL];
+#endif
 } psci_cpu_data_t;
 
 /*******************************************************************************
@@ -285,8 +370,62 @@ typedef struct plat_psci_ops {
 				    unsigned int power_state,
 				    psci_power_state_t *output_state);
 	int (*get_node_hw_state)(u_register_t mpidr, unsigned int power_level);
+	const plat_psci_idle_state_t *(*get_idle_states)(
+				    unsigned int *num_states);
+	int (*mem_protect_chk)(uintptr_t base, u_register_t length);
+	int (*read_mem_protect)(int *val);
+	int (*write_mem_protect)(int val);
+	int (*system_reset2)(int is_vendor,
+				int reset_type,
+				u_register_t cookie);
 } plat_psci_ops_t;
 
+#if PSCI_PD_SNAPSHOT
+/*******************************************************************************
+ * Layout of the snapshot of the power domain tree copied by psci_pd_snapshot().
+ * The header is followed by 'num_nodes' nodes of 'node_size' bytes each: the
+ * non CPU power domains first, in the order of psci_non_cpu_pd_nodes[], then
+ * the CPUs in the order of their core position. 'parent' is the index in this
+ * array of the parent node, or PSCI_PD_SNAPSHOT_NO_PARENT for the root.
+ *
+ * The lock fields of a non CPU power domain hold the number of times its lock
+ * was taken for a state coordination, the time it was held overall and the
+ * longest time it was held, in ticks of the system counter. They are zero for
+ * the CPUs. 'stat' holds the PSCI_STAT_RESIDENCY and PSCI_STAT_COUNT values of
+ * the 'num_stat_states' local states of the power domain, indexed as for
+ * get_pwr_lvl_state_idx(), and is empty unless ENABLE_PSCI_STAT is enabled.
+ ******************************************************************************/
+#define PSCI_PD_SNAPSHOT_VERSION	1
+#define PSCI_PD_SNAPSHOT_NO_PARENT	~0U
+
+typedef struct psci_pd_snapshot_hdr {
+	uint32_t version;
+	uint32_t size;
+	uint32_t num_nodes;
+	uint32_t node_size;
+	uint32_t num_stat_states;
+	uint32_t cnt_freq;
+	uint64_t timestamp;
+} psci_pd_snapshot_hdr_t;
+
+typedef struct psci_pd_snapshot_stat {
+	uint64_t residency;
+	uint64_t count;
+} psci_pd_snapshot_stat_t;
+
+typedef struct psci_pd_snapshot_node {
+	uint64_t mpidr;
+	uint32_t parent;
+	uint32_t level;
+	uint32_t local_state;
+	uint32_t reserved;
+	uint64_t lock_count;
+	uint64_t lock_hold;
+	uint64_t lock_hold_max;
+	psci_pd_snapshot_stat_t stat[];
+} psci_pd_snapshot_node_t;
+#endif
+
 /*******************************************************************************
  * Function & Data prototypes
  ******************************************************************************/
@@ -307,6 +446,23 @@ long psci_migrate_info_up_cpu(void);
 int psci_node_hw_state(u_register_t target_cpu,
 		       unsigned int power_level);
 int psci_features(unsigned int psci_fid);
+const plat_psci_idle_state_t *psci_get_idle_state(unsigned int index);
+int psci_mem_protect(unsigned int enable);
+int psci_mem_chk_range(uintptr_t base, u_register_t length);
+u_register_t psci_get_on_cpu_mpidr(unsigned int cpu_idx);
+#if PSCI_CPU_ON_MULTI
+int psci_cpu_on_multi(u_register_t target_group,
+		      u_register_t aff0_mask,
+		      uintptr_t entrypoint,
+		      u_register_t context_id,
+		      u_register_t *cpus_on);
+#endif
+#if PSCI_OS_INIT_MODE
+int psci_set_suspend_mode(unsigned int mode);
+#endif
+#if PSCI_PD_SNAPSHOT
+size_t psci_pd_snapshot(void *buf, size_t size);
+#endif
 void __dead2 psci_power_down_wfi(void);
 void psci_arch_setup(void);
 
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __RAS_H__
+#define __RAS_H__
+
+/* Offsets of the registers of a memory-mapped error record */
+#define ERR_RECORD_SIZE		0x40
+#define ERR_FR_OFF		0x00
+#define ERR_CTLR_OFF		0x08
+#define ERR_STATUS_OFF		0x10
+#define ERR_ADDR_OFF		0x18
+#define ERR_MISC0_OFF		0x20
+#define ERR_MISC1_OFF		0x28
+
+/* Fields of the ERR<n>STATUS registers */
+#define ERR_STATUS_AV_BIT	(1ULL << 31)
+#define ERR_STATUS_V_BIT	(1ULL << 30)
+#define ERR_STATUS_UE_BIT	(1ULL << 29)
+#define ERR_STATUS_ER_BIT	(1ULL << 28)
+#define ERR_STATUS_OF_BIT	(1ULL << 27)
+#define ERR_STATUS_MV_BIT	(1ULL << 26)
+#define ERR_STATUS_CE_SHIFT	24
+#define ERR_STATUS_CE_MASK	0x3ULL
+#define ERR_STATUS_DE_BIT	(1ULL << 23)
+#define ERR_STATUS_PN_BIT	(1ULL << 22)
+#define ERR_STATUS_UET_SHIFT	20
+#define ERR_STATUS_UET_MASK	0x3ULL
+
+/* Types of the uncorrected errors, in ERR<n>STATUS.UET */
+#define ERR_UET_UC		0	/* Uncontainable */
+#define ERR_UET_UEU		1	/* Unrecoverable */
+#define ERR_UET_UEO		2	/* Restartable */
+#define ERR_UET_UER		3	/* Recoverable */
+
+/* Bits of ERR<n>STATUS cleared by writing them back as read */
+#define ERR_STATUS_CLEAR_MASK	(ERR_STATUS_AV_BIT | ERR_STATUS_V_BIT |	\
+				 ERR_STATUS_UE_BIT | ERR_STATUS_ER_BIT |	\
+				 ERR_STATUS_OF_BIT | ERR_STATUS_MV_BIT |	\
+				 (ERR_STATUS_CE_MASK << ERR_STATUS_CE_SHIFT) | \
+				 ERR_STATUS_DE_BIT | ERR_STATUS_PN_BIT |	\
+				 (ERR_STATUS_UET_MASK << ERR_STATUS_UET_SHIFT))
+
+/* Flags of a group of error records */
+#define RAS_RECORDS_SHARED	(1 << 0)	/* Also scanned by other PEs */
+
+#ifndef __ASSEMBLY__
+#include <stdint.h>
+#include <utils_def.h>
+
+/*******************************************************************************
+ * The platform declares the groups of error records that BL31 scans when an
+ * error is signalled, either accessed through the system registers of the PE
+ * or memory-mapped:
+ *
+ *   static const ras_err_records_t plat_ras_records[] = {
+ *	RAS_SYSREG_RECORDS(0, 2, 0),
+ *	RAS_MMAP_RECORDS(PLAT_INTERCONNECT_RAS_BASE, 4, RAS_RECORDS_SHARED),
+ *   };
+ *   REGISTER_RAS_ERR_RECORDS(plat_ras_records);
+ *
+ * The groups of records that several PEs can scan at once must be flagged with
+ * RAS_RECORDS_SHARED, so that each error is recorded once.
+ ******************************************************************************/
+typedef struct ras_err_records {
+	uintptr_t base;		/* 0 for the records of the system registers */
+	unsigned int first;	/* Index of the first record of the group */
+	unsigned int num;
+	unsigned int flags;
+} ras_err_records_t;
+
+#define RAS_SYSREG_RECORDS(_first, _num, _flags)			\
+	{ .base = 0, .first = (_first), .num = (_num), .flags = (_flags) }
+
+#define RAS_MMAP_RECORDS(_base, _num, _flags)				\
+	{ .base = (_base), .first = 0, .num = (_num), .flags = (_flags) }
+
+#define REGISTER_RAS_ERR_RECORDS(_records)				\
+	const ras_err_records_t *const ras_err_records = (_records);	\
+	const unsigned int ras_num_err_records = ARRAY_SIZE(_records)
+
+extern const ras_err_records_t *const ras_err_records;
+extern const unsigned int ras_num_err_records;
+
+/*
+ * Error recorded by a PE, with the registers of the record that reported it.
+ * 'record' holds the index of the group of records in its upper 16 bits and
+ * the index of the record in the group in its lower 16 bits.
+ */
+typedef struct ras_error {
+	unsigned long long	timestamp;
+	uint64_t		status;
+	uint64_t		addr;
+	uint64_t		misc0;
+	uint32_t		record;
+	uint32_t		reserved;
+} ras_error_t;
+
+void ras_init(void);
+void ras_handle_serror(uint64_t esr, unsigned int ns);
+int ras_error_read(unsigned int cpu_idx, unsigned long long *seq,
+		   ras_error_t *error);
+
+/* Called on a PE when it records its first error since the last read */
+void plat_ras_notify(void);
+#endif /* __ASSEMBLY__ */
+
+#endif /* __RAS_H__ */
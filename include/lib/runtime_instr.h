@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -13,11 +13,33 @@
 #define RT_INSTR_EXIT_HW_LOW_PWR	3
 #define RT_INSTR_ENTER_CFLUSH		4
 #define RT_INSTR_EXIT_CFLUSH		5
-#define RT_INSTR_TOTAL_IDS		6
+#define RT_INSTR_ENTER_MEM_ZERO		6
+#define RT_INSTR_EXIT_MEM_ZERO		7
+#define RT_INSTR_ENTER_STATE_SWITCH	8
+#define RT_INSTR_EXIT_STATE_SWITCH	9
+#define RT_INSTR_ENTER_CCI_SNOOP	10
+#define RT_INSTR_EXIT_CCI_SNOOP		11
+#define RT_INSTR_TOTAL_IDS		12
+
+/*
+ * Phases of the PSCI calls that enter a low power state, accounted for in the
+ * latency histograms: from the PSCI entry to the low power state, the time
+ * spent in that state, and from the wake up to the return to the caller.
+ */
+#define RT_INSTR_PHASE_ENTRY		0
+#define RT_INSTR_PHASE_LOW_PWR		1
+#define RT_INSTR_PHASE_EXIT		2
+#define RT_INSTR_TOTAL_PHASES		3
+
+/* Number of buckets of the histograms, the last one being for 2^31 ticks+ */
+#define RT_INSTR_STATS_BUCKETS		32
 
 #ifndef __ASSEMBLY__
 PMF_DECLARE_CAPTURE_TIMESTAMP(rt_instr_svc)
 PMF_DECLARE_GET_TIMESTAMP(rt_instr_svc)
+
+unsigned int rt_instr_psci_stats_get(unsigned int cpu_idx, unsigned int phase,
+				     unsigned int bucket);
 #endif /* __ASSEMBLY__ */
 
 #endif /* __RUNTIME_INSTR_H__ */
@@ -42,6 +42,18 @@
 #endif
 #define SMC_TYPE_YIELD			0
 #define SMC_PREEMPTED		0xfffffffe
+
+/* Version of the SMC Calling Convention implemented, as per SMCCC_VERSION */
+#define SMCCC_MAJOR_VERSION		1
+#define SMCCC_MINOR_VERSION		1
+
+#define SMCCC_MAJOR_VER_SHIFT		16
+#define SMCCC_MAJOR_VER_MASK		0x7fff
+#define SMCCC_MINOR_VER_SHIFT		0
+#define SMCCC_MINOR_VER_MASK		0xffff
+#define MAKE_SMCCC_VERSION(_major, _minor)				\
+	((((_major) & SMCCC_MAJOR_VER_MASK) << SMCCC_MAJOR_VER_SHIFT) |	\
+	 (((_minor) & SMCCC_MINOR_VER_MASK) << SMCCC_MINOR_VER_SHIFT))
 /*******************************************************************************
  * Owning entity number definitions inside the function id as per the SMC
  * calling convention
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __TICKET_LOCK_H__
+#define __TICKET_LOCK_H__
+
+#ifndef __ASSEMBLY__
+
+#include <types.h>
+
+/*
+ * Ticket lock: contenders take the next ticket and are granted the lock in
+ * order. Both halves are accessed as a single 32-bit word by ticket_lock(), so
+ * they must stay in this order.
+ */
+typedef struct ticket_lock {
+	volatile uint16_t owner;
+	volatile uint16_t next;
+} ticket_lock_t;
+
+void ticket_lock(ticket_lock_t *lock);
+void ticket_unlock(ticket_lock_t *lock);
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* __TICKET_LOCK_H__ */
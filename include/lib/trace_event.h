@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __TRACE_EVENT_H__
+#define __TRACE_EVENT_H__
+
+/*
+ * IDs of the events traced by BL31. Platforms can define their own events
+ * from TRACE_EV_PLAT_BASE onwards.
+ */
+#define TRACE_EV_SMC		1	/* fid, x1, x2, x3 */
+#define TRACE_EV_INTR		2	/* type, SCR_EL3.NS */
+#define TRACE_EV_PSCI_CPU_ON	3	/* target mpidr, entrypoint */
+#define TRACE_EV_PSCI_CPU_OFF	4	/* end power level */
+#define TRACE_EV_PSCI_SUSPEND	5	/* end power level, power down state */
+#define TRACE_EV_PSCI_WAKEUP	6	/* end power level */
+#define TRACE_EV_PLAT_BASE	0x100
+
+#include <platform_def.h>
+
+/* Number of events kept for each CPU */
+#ifndef PLAT_TRACE_EVENTS
+#define PLAT_TRACE_EVENTS	256
+#endif
+
+/* Layout of the ring of a CPU, for the crash dump */
+#define TRACE_EVENT_SIZE	48
+#define TRACE_RING_HEAD_OFF	0x0
+#define TRACE_RING_EVENTS_OFF	0x8
+#define TRACE_RING_SIZE		((TRACE_RING_EVENTS_OFF +		\
+				  (TRACE_EVENT_SIZE * PLAT_TRACE_EVENTS) + \
+				  CACHE_WRITEBACK_GRANULE - 1) &	\
+				 ~(CACHE_WRITEBACK_GRANULE - 1))
+
+#ifndef __ASSEMBLY__
+#include <stdint.h>
+
+/* Binary record of an event */
+typedef struct trace_event {
+	unsigned long long	timestamp;
+	uint64_t		args[4];
+	uint32_t		id;
+	uint32_t		reserved;
+} trace_event_t;
+
+#if ENABLE_TRACE_EVENTS
+void trace_event_record(uint32_t id, uint64_t arg0, uint64_t arg1,
+			uint64_t arg2, uint64_t arg3);
+int trace_event_read(unsigned int cpu_idx, unsigned long long *seq,
+		     trace_event_t *event);
+
+#define TRACE_EVENT(_id, _a0, _a1, _a2, _a3)				\
+	trace_event_record((_id), (uint64_t)(_a0), (uint64_t)(_a1),	\
+			   (uint64_t)(_a2), (uint64_t)(_a3))
+#else
+#define TRACE_EVENT(_id, _a0, _a1, _a2, _a3)
+#endif /* ENABLE_TRACE_EVENTS */
+#endif /* __ASSEMBLY__ */
+
+#endif /* __TRACE_EVENT_H__ */
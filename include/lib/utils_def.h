@@ -56,6 +56,35 @@
 #define check_uptr_overflow(ptr, inc)		\
 	(((ptr) > UINTPTR_MAX - (inc)) ? 1 : 0)
 
+/*
+ * Mark functions run on most SMCs and power state changes, or only once at
+ * boot. The compiler places them in the .text.hot and .text.unlikely sections,
+ * which the BL31 linker script groups together to improve I-cache locality.
+ */
+#define __hot		__attribute__((__hot__))
+#define __cold		__attribute__((__cold__))
+
+/*
+ * Mark zero-initialised data accessed on most SMCs and power state changes.
+ * BL31 places it in the same memory as its hot code, if there is one.
+ */
+#define __hot_bss	__attribute__((__section__(".bss.hot")))
+
+/*
+ * Mark functions only run during the BL31 cold boot, and zero-initialised data
+ * only used once it is over. When RECLAIM_INIT_CODE is set, BL31 reuses the
+ * memory of the former for the latter, so an __init function must not be
+ * called after the cold boot and __runtime_bss data must not be accessed
+ * before the end of it.
+ */
+#if defined(IMAGE_BL31) && RECLAIM_INIT_CODE
+#define __init		__attribute__((__cold__, __section__("init_text")))
+#define __runtime_bss	__attribute__((__section__(".bss.runtime")))
+#else
+#define __init		__cold
+#define __runtime_bss
+#endif
+
 /*
  * For those constants to be shared between C and other sources, apply a 'ull'
  * suffix to the argument only in C, to avoid undefined or unintended behaviour.
@@ -7,6 +7,18 @@
 #ifndef __XLAT_MMU_HELPERS_H__
 #define __XLAT_MMU_HELPERS_H__
 
+/*
+ * Indices of the values of the MMU configuration registers in the array
+ * mmu_cfg_params, computed by enable_mmu_el1() and enable_mmu_el3() of the
+ * version 2 of the translation table library.
+ */
+#define MMU_CFG_MAIR0		0
+#define MMU_CFG_TCR		1
+#define MMU_CFG_TTBR0		2
+#define MMU_CFG_PARAM_MAX	3
+
+#ifndef __ASSEMBLY__
+
 #ifdef AARCH32
 /* AArch32 specific translation table API */
 void enable_mmu_secure(uint32_t flags);
@@ -14,6 +26,17 @@ void enable_mmu_secure(uint32_t flags);
 /* AArch64 specific translation table APIs */
 void enable_mmu_el1(unsigned int flags);
 void enable_mmu_el3(unsigned int flags);
+
+/*
+ * Enable the MMU using the values of mmu_cfg_params computed by a previous
+ * call to enable_mmu_el1() or enable_mmu_el3() on any CPU. These functions
+ * only use the registers x0 to x7 and no stack, so they can be called from
+ * assembly before the C runtime of the CPU is set up.
+ */
+void enable_mmu_direct_el1(unsigned int flags);
+void enable_mmu_direct_el3(unsigned int flags);
 #endif /* AARCH32 */
 
+#endif /* __ASSEMBLY__ */
+
 #endif /* __XLAT_MMU_HELPERS_H__ */
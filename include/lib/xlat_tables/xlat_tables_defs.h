@@ -17,6 +17,20 @@
 #define TWO_MB_SHIFT		21
 #define ONE_GB_SHIFT		30
 #define FOUR_KB_SHIFT		12
+#define SIXTEEN_KB_SHIFT	14
+#define SIXTY_FOUR_KB_SHIFT	16
+
+/*
+ * Translation granule, 4 KB unless XLAT_GRANULE_SIZE selects 16 or 64 KB,
+ * which only the AArch64 xlat_tables_v2 library supports.
+ */
+#if defined(XLAT_GRANULE_SIZE) && (XLAT_GRANULE_SIZE == (64 * 1024))
+#define PAGE_SIZE_SHIFT		SIXTY_FOUR_KB_SHIFT
+#elif defined(XLAT_GRANULE_SIZE) && (XLAT_GRANULE_SIZE == (16 * 1024))
+#define PAGE_SIZE_SHIFT		SIXTEEN_KB_SHIFT
+#else
+#define PAGE_SIZE_SHIFT		FOUR_KB_SHIFT
+#endif
 
 #define ONE_GB_INDEX(x)		((x) >> ONE_GB_SHIFT)
 #define TWO_MB_INDEX(x)		((x) >> TWO_MB_SHIFT)
@@ -39,6 +53,15 @@
 #define PXN			(ULL(1) << 1)
 #define CONT_HINT		(ULL(1) << 0)
 #define UPPER_ATTRS(x)		(((x) & ULL(0x7)) << 52)
+/* Number of adjacent entries of a level that the contiguous hint applies to */
+#if PAGE_SIZE_SHIFT == SIXTEEN_KB_SHIFT
+#define CONT_HINT_ENTRIES(level)	\
+	(((level) == XLAT_TABLE_LEVEL_MAX) ? 128 : 32)
+#elif PAGE_SIZE_SHIFT == SIXTY_FOUR_KB_SHIFT
+#define CONT_HINT_ENTRIES(level)	32
+#else
+#define CONT_HINT_ENTRIES(level)	16
+#endif
 
 #define NON_GLOBAL		(1 << 9)
 #define ACCESS_FLAG		(1 << 8)
@@ -48,7 +71,6 @@
 
 #define TABLE_ADDR_MASK		ULL(0x0000FFFFFFFFF000)
 
-#define PAGE_SIZE_SHIFT		FOUR_KB_SHIFT /* 4, 16 or 64 KB */
 #define PAGE_SIZE		(1 << PAGE_SIZE_SHIFT)
 #define PAGE_SIZE_MASK		(PAGE_SIZE - 1)
 #define IS_PAGE_ALIGNED(addr)	(((addr) & PAGE_SIZE_MASK) == 0)
@@ -132,5 +132,71 @@ void mmap_add(const mmap_region_t *mm);
  */
 int mmap_remove_dynamic_region(uintptr_t base_va, size_t size);
 
+/*
+ * Start and end a batch of dynamic region additions and removals. The barriers
+ * and TLB invalidations needed by the updates of the batch are only done once,
+ * by mmap_dynamic_batch_end(). In between, the regions added in the batch must
+ * not be accessed and the memory of the regions removed in the batch must not
+ * be reused. Batches can't be nested.
+ */
+void mmap_dynamic_batch_start(void);
+void mmap_dynamic_batch_end(void);
+
+/*
+ * Returns the maximum number of translation tables, out of MAX_XLAT_TABLES,
+ * that have been in use at the same time since the translation tables were
+ * initialized. The tables freed when removing dynamic regions are reused, so
+ * this is the smallest value of MAX_XLAT_TABLES that would have been enough.
+ */
+int xlat_tables_get_max_used(void);
+
+/*
+ * Change the access permissions and executability of the pages of a range that
+ * is already mapped. Every page of the range must be mapped by a page
+ * descriptor without the contiguous hint, and the memory type and security
+ * state must stay the same. The list of regions isn't updated, only the
+ * translation tables.
+ *
+ * Returns:
+ *        0: Success.
+ *   EINVAL: Invalid values were used as arguments, or a page of the range
+ *           isn't mapped by a suitable page descriptor.
+ *    EPERM: The attributes would change the memory type or security state.
+ */
+int change_mem_attributes(uintptr_t base_va, size_t size, mmap_attr_t attr);
+
+#if XLAT_TABLES_HANDOFF
+/*
+ * Description of the translation tables of an image, handed to the next image
+ * so that it doesn't have to rebuild the mappings that they have in common.
+ */
+typedef struct xlat_tables_handoff {
+	/* Regions mapped by the tables, terminated by an entry with size 0. */
+	const mmap_region_t *mmap;
+	const uint64_t *base_table;
+	unsigned int base_table_entries;
+	unsigned int base_level;
+	/* Execute-never bits used in the descriptors of the tables. */
+	uint64_t execute_never_mask;
+} xlat_tables_handoff_t;
+
+/*
+ * Describe the translation tables of the current image in 'handoff' and flush
+ * them, the regions and 'handoff' itself to memory. This function can only be
+ * used after initializing the translation tables, and all of them must be left
+ * untouched until the next image has imported them.
+ */
+void xlat_tables_export(xlat_tables_handoff_t *handoff);
+
+/*
+ * Use the translation tables described by 'handoff' when initializing the
+ * translation tables of the current image. This function must be called
+ * before init_xlat_tables(). The entries of the tables that map the same set of
+ * regions as the ones added to the current image are then copied into its own
+ * tables, and only the other entries are built.
+ */
+void xlat_tables_import(const xlat_tables_handoff_t *handoff);
+#endif /* XLAT_TABLES_HANDOFF */
+
 #endif /*__ASSEMBLY__*/
 #endif /* __XLAT_TABLES_V2_H__ */
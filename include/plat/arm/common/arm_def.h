@@ -55,6 +55,13 @@
 #define ARM_SHARED_RAM_BASE		ARM_TRUSTED_SRAM_BASE
 #define ARM_SHARED_RAM_SIZE		0x00001000	/* 4 KB */
 
+/*
+ * Flag in the shared memory, after the trusted mailbox, which records that the
+ * last reset was a warm reset requested with PSCI SYSTEM_RESET2
+ */
+#define ARM_WARM_RESET_FLAG_BASE	(ARM_SHARED_RAM_BASE + 0x8)
+#define ARM_WARM_RESET_MAGIC		ULL(0x57524d5253543200)
+
 /* The remaining Trusted SRAM is used to load the BL images */
 #define ARM_BL_RAM_BASE			(ARM_SHARED_RAM_BASE +	\
 					 ARM_SHARED_RAM_SIZE)
@@ -17,8 +17,43 @@
 /* Function ID for requesting state switch of lower EL */
 #define ARM_SIP_SVC_EXE_STATE_SWITCH	0x82000020
 
+/* Function ID for reading the SMC latency histograms */
+#define ARM_SIP_SVC_SMC_STATS		0x82000021
+
+/* Function ID for turning on several CPUs of an affinity group at once */
+#define ARM_SIP_SVC_CPU_ON_MULTI	0x82000022
+
+/* Function ID for reading the console log buffered by a CPU */
+#define ARM_SIP_SVC_CONSOLE_LOG		0xc2000023
+
+/* Function ID for reading the events traced by a CPU */
+#define ARM_SIP_SVC_TRACE_READ		0xc2000024
+
+/* Function IDs for setting and getting the level of a performance domain */
+#define ARM_SIP_SVC_PERF_LEVEL_SET	0x82000025
+#define ARM_SIP_SVC_PERF_LEVEL_GET	0x82000026
+
+/* Function ID for reading the latency histograms of the PSCI power states */
+#define ARM_SIP_SVC_PSCI_STATS		0x82000027
+
+/* Function ID for reading the stack usage of a CPU */
+#define ARM_SIP_SVC_STACK_WATERMARK	0x82000028
+
+/* Function ID for reading the idle state table of the platform */
+#define ARM_SIP_SVC_IDLE_STATE		0x82000029
+
+/* Function ID for reading the RAS errors recorded by a CPU */
+#define ARM_SIP_SVC_RAS_READ		0xc200002a
+
+/* Function IDs for reading and clearing the crash record of a CPU */
+#define ARM_SIP_SVC_CRASH_DUMP_READ	0xc200002b
+#define ARM_SIP_SVC_CRASH_DUMP_CLEAR	0x8200002c
+
+/* Function ID for copying the snapshot of the power domain tree */
+#define ARM_SIP_SVC_PD_SNAPSHOT		0xc200002d
+
 /* ARM SiP Service Calls version numbers */
 #define ARM_SIP_SVC_VERSION_MAJOR		0x0
-#define ARM_SIP_SVC_VERSION_MINOR		0x2
+#define ARM_SIP_SVC_VERSION_MINOR		0xb
 
 #endif /* __ARM_SIP_SVC_H__ */
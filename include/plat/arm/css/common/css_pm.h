@@ -33,4 +33,9 @@ void css_cpu_standby(plat_local_state_t cpu_state);
 void css_get_sys_suspend_power_state(psci_power_state_t *req_state);
 int css_node_hw_state(u_register_t mpidr, unsigned int power_level);
 
+#if CSS_USE_SCMI_PERF
+int css_scp_perf_level_set(unsigned int domain_id, unsigned int level);
+int css_scp_perf_level_get(unsigned int domain_id, unsigned int *level);
+#endif
+
 #endif /* __CSS_PM_H__ */
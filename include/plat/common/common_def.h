@@ -103,4 +103,13 @@
 #define BL_COHERENT_RAM_BASE	(unsigned long)(&__COHERENT_RAM_START__)
 #define BL_COHERENT_RAM_END	(unsigned long)(&__COHERENT_RAM_END__)
 
+/*
+ * The extents of the BL31 hot code when PLAT_BL31_HOT_RAM_BASE places it in a
+ * separate memory. The linker script ensures that they are page-aligned. The
+ * hot data follows it up to BL31_HOT_RAM_END.
+ */
+#define BL31_HOT_TEXT_BASE	(unsigned long)(&__HOT_TEXT_START__)
+#define BL31_HOT_TEXT_END	(unsigned long)(&__HOT_TEXT_END__)
+#define BL31_HOT_RAM_END	(unsigned long)(&__HOT_RAM_END__)
+
 #endif /* __COMMON_DEF_H__ */
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef __PLAT_CORE_POS_H__
+#define __PLAT_CORE_POS_H__
+
+#include <arch.h>
+#include <platform_def.h>
+
+/*
+ * Generic conversion of the MPIDRs of the CPUs to linear indices, for the
+ * platforms whose MPIDRs are sparse or differ between clusters.
+ *
+ * The platform defines in platform_def.h the number of significant bits of
+ * each affinity field of its MPIDRs, PLAT_CORE_POS_AFF<n>_BITS, and lists the
+ * index of each CPU with PLAT_CORE_POS_ENTRY() in PLAT_CORE_POS_ENTRIES, e.g.
+ * for a cluster of 4 CPUs and a cluster of 2 CPUs:
+ *
+ *   #define PLAT_CORE_POS_AFF0_BITS	2
+ *   #define PLAT_CORE_POS_AFF1_BITS	1
+ *   #define PLAT_CORE_POS_ENTRIES			\
+ *	PLAT_CORE_POS_ENTRY(0x000, 0),			\
+ *	PLAT_CORE_POS_ENTRY(0x001, 1),			\
+ *	...						\
+ *	PLAT_CORE_POS_ENTRY(0x101, 5)
+ *
+ * The significant bits of the affinity fields are concatenated into a key,
+ * that indexes a table of 2^(sum of the bits) bytes built at compile time.
+ * A conversion is then a mask test and a byte load, whatever the topology.
+ */
+#ifndef PLAT_CORE_POS_AFF1_BITS
+#define PLAT_CORE_POS_AFF1_BITS		0
+#endif
+#ifndef PLAT_CORE_POS_AFF2_BITS
+#define PLAT_CORE_POS_AFF2_BITS		0
+#endif
+#ifndef PLAT_CORE_POS_AFF3_BITS
+#define PLAT_CORE_POS_AFF3_BITS		0
+#endif
+
+/* Position of the bits of each affinity field in the key */
+#define PLAT_CORE_POS_AFF0_KEY_SHIFT	0
+#define PLAT_CORE_POS_AFF1_KEY_SHIFT	PLAT_CORE_POS_AFF0_BITS
+#define PLAT_CORE_POS_AFF2_KEY_SHIFT	(PLAT_CORE_POS_AFF1_KEY_SHIFT + \
+					 PLAT_CORE_POS_AFF1_BITS)
+#define PLAT_CORE_POS_AFF3_KEY_SHIFT	(PLAT_CORE_POS_AFF2_KEY_SHIFT + \
+					 PLAT_CORE_POS_AFF2_BITS)
+#define PLAT_CORE_POS_KEY_BITS		(PLAT_CORE_POS_AFF3_KEY_SHIFT + \
+					 PLAT_CORE_POS_AFF3_BITS)
+
+#define PLAT_CORE_POS_TABLE_SIZE	(1 << PLAT_CORE_POS_KEY_BITS)
+
+#ifndef __ASSEMBLY__
+
+#include <types.h>
+
+#define _PLAT_CORE_POS_AFF_MASK(_n)					\
+	((((u_register_t)1 << PLAT_CORE_POS_AFF##_n##_BITS) - 1) <<	\
+	 MPIDR_AFF##_n##_SHIFT)
+
+#define _PLAT_CORE_POS_AFF_KEY(_mpidr, _n)				\
+	((((_mpidr) & _PLAT_CORE_POS_AFF_MASK(_n)) >>			\
+	  MPIDR_AFF##_n##_SHIFT) << PLAT_CORE_POS_AFF##_n##_KEY_SHIFT)
+
+/* Bits of the MPIDRs that can be set for a CPU of the platform */
+#ifdef AARCH32
+#define PLAT_CORE_POS_MPIDR_MASK	(_PLAT_CORE_POS_AFF_MASK(0) |	\
+					 _PLAT_CORE_POS_AFF_MASK(1) |	\
+					 _PLAT_CORE_POS_AFF_MASK(2))
+#define PLAT_CORE_POS_KEY(_mpidr)	(_PLAT_CORE_POS_AFF_KEY(_mpidr, 0) | \
+					 _PLAT_CORE_POS_AFF_KEY(_mpidr, 1) | \
+					 _PLAT_CORE_POS_AFF_KEY(_mpidr, 2))
+#else
+#define PLAT_CORE_POS_MPIDR_MASK	(_PLAT_CORE_POS_AFF_MASK(0) |	\
+					 _PLAT_CORE_POS_AFF_MASK(1) |	\
+					 _PLAT_CORE_POS_AFF_MASK(2) |	\
+					 _PLAT_CORE_POS_AFF_MASK(3))
+#define PLAT_CORE_POS_KEY(_mpidr)	(_PLAT_CORE_POS_AFF_KEY(_mpidr, 0) | \
+					 _PLAT_CORE_POS_AFF_KEY(_mpidr, 1) | \
+					 _PLAT_CORE_POS_AFF_KEY(_mpidr, 2) | \
+					 _PLAT_CORE_POS_AFF_KEY(_mpidr, 3))
+#endif
+
+/* The table holds the index plus one, so that its empty entries are invalid */
+#define PLAT_CORE_POS_ENTRY(_mpidr, _pos)				\
+	[PLAT_CORE_POS_KEY((u_register_t)(_mpidr))] = (_pos) + 1
+
+extern const uint8_t plat_core_pos_table[PLAT_CORE_POS_TABLE_SIZE];
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* __PLAT_CORE_POS_H__ */
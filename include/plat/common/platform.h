@@ -58,6 +58,14 @@ int plat_core_pos_by_mpidr(u_register_t mpidr);
 u_register_t plat_get_stack_protector_canary(void);
 #endif /* STACK_PROTECTOR_ENABLED */
 
+#if REUSE_PRESERVED_IMAGES
+/*
+ * Return 1 if the memory of the image 'image_id' may still hold the copy
+ * loaded by the previous boot, 0 otherwise.
+ */
+int plat_is_image_preserved(unsigned int image_id);
+#endif /* REUSE_PRESERVED_IMAGES */
+
 /*******************************************************************************
  * Mandatory interrupt management functions
  ******************************************************************************/
@@ -69,6 +77,18 @@ void plat_ic_end_of_interrupt(uint32_t id);
 uint32_t plat_interrupt_type_to_line(uint32_t type,
 				     uint32_t security_state);
 
+/*******************************************************************************
+ * Optional interrupt management functions, mandatory when
+ * EL3_EXCEPTION_HANDLING is enabled
+ ******************************************************************************/
+unsigned int plat_ic_is_spurious(unsigned int id);
+unsigned int plat_ic_get_running_priority(void);
+unsigned int plat_ic_set_priority_mask(unsigned int mask);
+void plat_ic_set_interrupt_priority(unsigned int id, unsigned int priority);
+void plat_ic_raise_el3_sgi(unsigned int sgi_num, u_register_t target_group,
+			   unsigned int aff0_mask);
+void plat_ic_raise_ns_sgi(unsigned int sgi_num);
+
 /*******************************************************************************
  * Optional common functions (may be overridden)
  ******************************************************************************/
@@ -128,6 +148,21 @@ void bl2_plat_arch_setup(void);
 void bl2_platform_setup(void);
 struct meminfo *bl2_plat_sec_mem_layout(void);
 
+/*
+ * The following functions are mandatory when BL2 is the reset image and runs
+ * at EL3 (BL2_AT_EL3). They replace bl2_early_platform_setup() and
+ * bl2_plat_arch_setup(), and also do the platform setup of BL1.
+ */
+void bl2_el3_early_platform_setup(u_register_t arg0, u_register_t arg1,
+				  u_register_t arg2, u_register_t arg3);
+void bl2_el3_plat_arch_setup(void);
+
+/*
+ * The following function is used when BL2_AT_EL3 is set and may optionally be
+ * overridden.
+ */
+void bl2_el3_plat_prepare_exit(const struct entry_point_info *ep_info);
+
 #if LOAD_IMAGE_V2
 /*
  * This function can be used by the platforms to update/use image
@@ -0,0 +1,14 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __ARM_ARCH_SVC_H__
+#define __ARM_ARCH_SVC_H__
+
+/* SMC function IDs for the Arm Architecture Service */
+#define SMCCC_VERSION			0x80000000
+#define SMCCC_ARCH_FEATURES		0x80000001
+
+#endif /* __ARM_ARCH_SVC_H__ */
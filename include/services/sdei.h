@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __SDEI_H__
+#define __SDEI_H__
+
+/* SMC function IDs of the Software Delegated Exception Interface */
+#define SDEI_VERSION			0xc4000020
+#define SDEI_EVENT_REGISTER		0xc4000021
+#define SDEI_EVENT_ENABLE		0xc4000022
+#define SDEI_EVENT_DISABLE		0xc4000023
+#define SDEI_EVENT_CONTEXT		0xc4000024
+#define SDEI_EVENT_COMPLETE		0xc4000025
+#define SDEI_EVENT_COMPLETE_AND_RESUME	0xc4000026
+#define SDEI_EVENT_UNREGISTER		0xc4000027
+#define SDEI_EVENT_STATUS		0xc4000028
+#define SDEI_EVENT_GET_INFO		0xc4000029
+#define SDEI_EVENT_ROUTING_SET		0xc400002a
+#define SDEI_PE_MASK			0xc400002b
+#define SDEI_PE_UNMASK			0xc400002c
+#define SDEI_INTERRUPT_BIND		0xc400002d
+#define SDEI_INTERRUPT_RELEASE		0xc400002e
+#define SDEI_EVENT_SIGNAL		0xc400002f
+#define SDEI_FEATURES			0xc4000030
+#define SDEI_PRIVATE_RESET		0xc4000031
+#define SDEI_SHARED_RESET		0xc4000032
+
+#define is_sdei_fid(_fid) \
+	(((_fid) >= SDEI_VERSION) && ((_fid) <= SDEI_SHARED_RESET))
+
+/* Version 1.0 of the interface, without vendor-defined version */
+#define SDEI_VERSION_MAJOR		1
+#define SDEI_VERSION_MINOR		0
+#define MAKE_SDEI_VERSION(_major, _minor)	\
+	(((uint64_t)(_major) << 48) | ((uint64_t)(_minor) << 32))
+
+/* Error codes */
+#define SDEI_SUCCESS			0
+#define SDEI_ENOTSUP			-1
+#define SDEI_EINVAL			-2
+#define SDEI_EDENY			-3
+#define SDEI_EPEND			-5
+#define SDEI_ENOMEM			-10
+
+/* Routing modes of the shared events, for SDEI_EVENT_REGISTER */
+#define SDEI_REGF_RM_ANY		0
+#define SDEI_REGF_RM_PE			1
+
+/* Bits of the status returned by SDEI_EVENT_STATUS */
+#define SDEI_STATF_REGISTERED		(1 << 0)
+#define SDEI_STATF_ENABLED		(1 << 1)
+#define SDEI_STATF_RUNNING		(1 << 2)
+
+/* Information that SDEI_EVENT_GET_INFO returns */
+#define SDEI_INFO_EV_TYPE		0
+#define SDEI_INFO_EV_SIGNALED		1
+#define SDEI_INFO_EV_PRIORITY		2
+#define SDEI_INFO_EV_ROUTING_MODE	3
+#define SDEI_INFO_EV_ROUTING_AFF	4
+
+/* Features that SDEI_FEATURES reports */
+#define SDEI_FEATURE_BIND_SLOTS		0
+
+/* Number of the interrupted general purpose registers, x0 to x17, saved */
+#define SDEI_SAVED_GPREGS		18
+
+/* Flags of the events declared by the platform */
+#define SDEI_MAPF_CRITICAL		(1 << 0)
+#define SDEI_MAPF_SIGNALABLE		(1 << 1)
+
+#ifndef __ASSEMBLY__
+
+#include <cassert.h>
+#include <platform_def.h>
+#include <types.h>
+#include <utils_def.h>
+
+/*******************************************************************************
+ * The platform declares its events, each bound to an EL3 interrupt, in a table
+ * of private events, which each PE registers and dispatches separately, and a
+ * table of shared events:
+ *
+ *   static sdei_ev_map_t plat_private_sdei[] = {
+ *	SDEI_DEFINE_EVENT_0(PLAT_SDEI_SGI),
+ *	SDEI_PRIVATE_EVENT(100, PLAT_PMU_PPI, SDEI_MAPF_CRITICAL),
+ *   };
+ *   static sdei_ev_map_t plat_shared_sdei[] = {
+ *	SDEI_SHARED_EVENT(200, PLAT_WDOG_SPI, 0),
+ *   };
+ *   REGISTER_SDEI_MAP(plat_private_sdei, plat_shared_sdei);
+ *
+ * The event 0 is the private event signalled by software with
+ * SDEI_EVENT_SIGNAL, which raises its SGI on the target PE.
+ ******************************************************************************/
+typedef struct sdei_ev_map {
+	int32_t ev_num;
+	unsigned int intr;
+	unsigned int map_flags;
+} sdei_ev_map_t;
+
+/* State of an event, per PE for the private events */
+typedef struct sdei_entry {
+	uintptr_t ep;
+	u_register_t arg;
+	unsigned int client_el;
+	unsigned int state;
+} sdei_entry_t;
+
+typedef struct sdei_mapping {
+	const sdei_ev_map_t *map;
+	unsigned int num_maps;
+	sdei_entry_t *entries;
+} sdei_mapping_t;
+
+#define SDEI_MAP_IDX_PRIV	0
+#define SDEI_MAP_IDX_SHRD	1
+#define SDEI_MAP_IDX_MAX	2
+
+#define SDEI_EVENT_0_NUM	0
+
+#define SDEI_DEFINE_EVENT_0(_sgi)					\
+	SDEI_PRIVATE_EVENT(SDEI_EVENT_0_NUM, _sgi, SDEI_MAPF_SIGNALABLE)
+
+#define SDEI_PRIVATE_EVENT(_event, _intr, _flags)			\
+	{ .ev_num = (_event), .intr = (_intr), .map_flags = (_flags) }
+
+#define SDEI_SHARED_EVENT(_event, _intr, _flags)			\
+	{ .ev_num = (_event), .intr = (_intr), .map_flags = (_flags) }
+
+#define REGISTER_SDEI_MAP(_private, _shared)				\
+	CASSERT(ARRAY_SIZE(_private) > 0, assert_sdei_private_map);	\
+	static sdei_entry_t sdei_private_entries[PLATFORM_CORE_COUNT]	\
+						[ARRAY_SIZE(_private)];	\
+	static sdei_entry_t sdei_shared_entries[ARRAY_SIZE(_shared)];	\
+	const sdei_mapping_t sdei_global_mappings[SDEI_MAP_IDX_MAX] = {	\
+		[SDEI_MAP_IDX_PRIV] = {					\
+			.map = (_private),				\
+			.num_maps = ARRAY_SIZE(_private),		\
+			.entries = &sdei_private_entries[0][0],		\
+		},							\
+		[SDEI_MAP_IDX_SHRD] = {					\
+			.map = (_shared),				\
+			.num_maps = ARRAY_SIZE(_shared),		\
+			.entries = sdei_shared_entries,			\
+		},							\
+	}
+
+extern const sdei_mapping_t sdei_global_mappings[SDEI_MAP_IDX_MAX];
+
+/*******************************************************************************
+ * Function prototypes
+ ******************************************************************************/
+void sdei_init(void);
+uint64_t sdei_smc_handler(uint32_t smc_fid,
+			  uint64_t x1,
+			  uint64_t x2,
+			  uint64_t x3,
+			  uint64_t x4,
+			  void *cookie,
+			  void *handle,
+			  uint64_t flags);
+
+/* Called when an event triggers while it cannot be dispatched */
+void plat_sdei_handle_masked_trigger(uint64_t mpidr, unsigned int intr);
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* __SDEI_H__ */
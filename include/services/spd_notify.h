@@ -0,0 +1,15 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __SPD_NOTIFY_H__
+#define __SPD_NOTIFY_H__
+
+/*******************************************************************************
+ * Function prototypes
+ ******************************************************************************/
+void spd_notify_ns(void);
+
+#endif /* __SPD_NOTIFY_H__ */
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __SPD_YIELD_H__
+#define __SPD_YIELD_H__
+
+/*******************************************************************************
+ * States of the yielding SMC of the calling CPU, as tracked by the Secure
+ * Payload Dispatchers through the spd_yield helpers:
+ *
+ * SPD_YIELD_IDLE          - No yielding SMC is in progress.
+ * SPD_YIELD_RUNNING       - The SP is executing a yielding SMC.
+ * SPD_YIELD_SP_PREEMPTED  - The SP gave up the CPU in the middle of a yielding
+ *                           SMC and expects the normal world to ask for it to
+ *                           be resumed.
+ * SPD_YIELD_EL3_PREEMPTED - A non-secure interrupt routed to EL3 preempted the
+ *                           SP in the middle of a yielding SMC. The SP must be
+ *                           resumed where it was interrupted.
+ ******************************************************************************/
+#define SPD_YIELD_IDLE			0
+#define SPD_YIELD_RUNNING		1
+#define SPD_YIELD_SP_PREEMPTED		2
+#define SPD_YIELD_EL3_PREEMPTED		3
+
+#ifndef __ASSEMBLY__
+
+#include <stdint.h>
+
+/*
+ * Handler called when a non-secure interrupt preempts the SP, which programs
+ * the return values of the preempted SMC in the non-secure context 'handle'
+ * and returns it.
+ */
+typedef uint64_t (*spd_yield_preempted_t)(void *handle);
+
+/*
+ * Handler called when SPD_NS_INTR_INJECT=1 lets the normal world take the
+ * non-secure interrupt straight away, which programs in the non-secure context
+ * 'handle' the arguments of the SMC that resumes the preempted SMC, and
+ * returns it.
+ */
+typedef uint64_t (*spd_yield_resume_call_t)(void *handle);
+
+/*******************************************************************************
+ * Function prototypes
+ ******************************************************************************/
+int spd_yield_init(spd_yield_preempted_t preempted,
+		   spd_yield_resume_call_t resume_call);
+int spd_yield_get_state(void);
+int spd_yield_start(void);
+int spd_yield_resume(void);
+void spd_yield_done(void);
+void *spd_yield_preempt(void);
+void spd_yield_abort(void);
+void spd_yield_ctx_save(void);
+void spd_yield_ctx_restore(void);
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* __SPD_YIELD_H__ */
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __SPM_SVC_H__
+#define __SPM_SVC_H__
+
+/*
+ * SMC function IDs of the Secure Partition Manager. SPM_PARTITION_CALL is
+ * issued by the normal world, SPM_PARTITION_RETURN and SPM_PARTITION_ABORT by
+ * the partitions, and SPM_VERSION by either.
+ */
+#define SPM_VERSION			0xc4000060
+#define SPM_PARTITION_CALL		0xc4000061
+#define SPM_PARTITION_RETURN		0xc4000062
+#define SPM_PARTITION_ABORT		0xc4000063
+
+#define is_spm_fid(_fid) \
+	(((_fid) >= SPM_VERSION) && ((_fid) <= SPM_PARTITION_ABORT))
+
+#define SPM_VERSION_MAJOR		0
+#define SPM_VERSION_MINOR		1
+#define SPM_VERSION_COMPILED		((SPM_VERSION_MAJOR << 16) |	\
+					 SPM_VERSION_MINOR)
+
+/* Error codes */
+#define SPM_SUCCESS			0
+#define SPM_NOT_SUPPORTED		-1
+#define SPM_INVALID_PARAMETER		-2
+#define SPM_DENIED			-3
+#define SPM_ABORTED			-4
+
+/* Number of the arguments and results passed to and from a partition */
+#define SPM_PARTITION_ARGS		6
+#define SPM_PARTITION_RESULTS		4
+
+#ifndef __ASSEMBLY__
+
+#include <context.h>
+#include <platform_def.h>
+#include <types.h>
+#include <utils_def.h>
+
+/*******************************************************************************
+ * The platform declares the partitions that BL31 runs at S-EL0, each loaded at
+ * its entry point before BL31 runs:
+ *
+ *   static const spm_partition_desc_t plat_partitions[] = {
+ *	{
+ *		.entrypoint = PLAT_CRYPTO_SP_BASE,
+ *		.stack_base = PLAT_CRYPTO_SP_STACKS_BASE,
+ *		.stack_size = PLAT_CRYPTO_SP_STACK_SIZE,
+ *		.ttbr0_el1 = PLAT_CRYPTO_SP_TTBR0,
+ *		.tcr_el1 = PLAT_SP_TCR,
+ *		.mair_el1 = PLAT_SP_MAIR,
+ *	},
+ *   };
+ *   REGISTER_SPM_PARTITIONS(plat_partitions);
+ *
+ * The index of a partition in the table is its ID. Each CPU runs a partition
+ * in its own context, on its own stack, so that the partitions serve calls on
+ * several CPUs at once. A partition must therefore protect the data it
+ * shares between CPUs. A null 'ttbr0_el1' leaves the MMU off for the
+ * partition.
+ ******************************************************************************/
+typedef struct spm_partition_desc {
+	uintptr_t entrypoint;
+	/* The stack of the CPU N is at 'stack_base' + N * 'stack_size' */
+	uintptr_t stack_base;
+	size_t stack_size;
+	/* S-EL1&0 translation regime of the partition */
+	uint64_t ttbr0_el1;
+	uint64_t tcr_el1;
+	uint64_t mair_el1;
+} spm_partition_desc_t;
+
+typedef struct spm_partitions {
+	const spm_partition_desc_t *desc;
+	unsigned int num;
+	/* Context of each partition on each CPU, by CPU first */
+	cpu_context_t *cpu_ctx;
+} spm_partitions_t;
+
+#define REGISTER_SPM_PARTITIONS(_partitions)				\
+	static cpu_context_t spm_partition_ctx[PLATFORM_CORE_COUNT]	\
+					      [ARRAY_SIZE(_partitions)];\
+	const spm_partitions_t spm_partitions = {			\
+		.desc = (_partitions),					\
+		.num = ARRAY_SIZE(_partitions),				\
+		.cpu_ctx = &spm_partition_ctx[0][0],			\
+	}
+
+extern const spm_partitions_t spm_partitions;
+
+/* Exception vectors of S-EL1 while a partition runs, in the code of BL31 */
+extern uintptr_t spm_shim_exceptions_ptr;
+
+/*******************************************************************************
+ * Function prototypes
+ ******************************************************************************/
+void spm_init(void);
+uint64_t spm_smc_handler(uint32_t smc_fid,
+			 uint64_t x1,
+			 uint64_t x2,
+			 uint64_t x3,
+			 uint64_t x4,
+			 void *cookie,
+			 void *handle,
+			 uint64_t flags);
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* __SPM_SVC_H__ */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2017, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -60,6 +60,16 @@
 #define UUID_NON_TRUSTED_FW_CONTENT_CERT \
 	{0xf3c1c48e, 0x635d, 0x11e4, 0xa7, 0xa9, {0x87, 0xee, 0x40, 0xb2, 0x3f, 0xa7} }
 
+/* ToC entry flags */
+#define TOC_ENTRY_FLAG_LZ4	(1ULL << 0)
+
+/*
+ * The payload of an entry flagged with TOC_ENTRY_FLAG_LZ4 is an LZ4 frame
+ * holding the size of the image, without dictionary or block checksums, made
+ * of independent blocks of at most FIP_LZ4_BLOCK_SIZE bytes of image data.
+ */
+#define FIP_LZ4_BLOCK_SIZE	0x4000
+
 typedef struct fip_toc_header {
 	uint32_t	name;
 	uint32_t	serial_number;
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __XLAT_GEN_H__
+#define __XLAT_GEN_H__
+
+#include <stdint.h>
+
+/*
+ * Sections of the object file read by the xlat_gen tool. The first one holds a
+ * xlat_gen_params_t and the second one the array of mmap_region_t to map,
+ * terminated by an entry with size 0.
+ */
+#define XLAT_GEN_PARAMS_SECTION		".xlat_gen_params"
+#define XLAT_GEN_MMAP_SECTION		".xlat_gen_mmap"
+
+/*
+ * Properties of the translation context of a BL image, as computed by the
+ * translation table library when building it.
+ */
+typedef struct xlat_gen_params {
+	uint64_t va_max_address;
+	uint64_t pa_max_address;
+	uint64_t max_tables;
+	uint64_t base_level;
+	uint64_t base_table_entries;
+	uint64_t min_block_level;
+	uint64_t execute_never_mask;
+} xlat_gen_params_t;
+
+#endif /* __XLAT_GEN_H__ */
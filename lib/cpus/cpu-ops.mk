@@ -8,6 +8,12 @@
 # cluster is powered down.
 SKIP_A57_L1_FLUSH_PWR_DWN	?=0
 
+# Cortex A57 and A72 specific optimisations to only flush the firmware data by
+# VA, instead of the caches by set/way, when the core or the cluster is powered
+# down. The platform must write the other dirty cache lines back in hardware.
+A57_PWR_DWN_FLUSH_BY_VA		?=0
+A72_PWR_DWN_FLUSH_BY_VA		?=0
+
 # Flag to disable the cache non-temporal hint.
 # It is enabled by default.
 A53_DISABLE_NON_TEMPORAL_HINT	?=1
@@ -20,6 +26,14 @@ A57_DISABLE_NON_TEMPORAL_HINT	?=1
 $(eval $(call assert_boolean,SKIP_A57_L1_FLUSH_PWR_DWN))
 $(eval $(call add_define,SKIP_A57_L1_FLUSH_PWR_DWN))
 
+# Process A57_PWR_DWN_FLUSH_BY_VA flag
+$(eval $(call assert_boolean,A57_PWR_DWN_FLUSH_BY_VA))
+$(eval $(call add_define,A57_PWR_DWN_FLUSH_BY_VA))
+
+# Process A72_PWR_DWN_FLUSH_BY_VA flag
+$(eval $(call assert_boolean,A72_PWR_DWN_FLUSH_BY_VA))
+$(eval $(call add_define,A72_PWR_DWN_FLUSH_BY_VA))
+
 # Process A53_DISABLE_NON_TEMPORAL_HINT flag
 $(eval $(call assert_boolean,A53_DISABLE_NON_TEMPORAL_HINT))
 $(eval $(call add_define,A53_DISABLE_NON_TEMPORAL_HINT))
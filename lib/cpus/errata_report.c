@@ -16,6 +16,8 @@
 
 #ifdef IMAGE_BL1
 # define BL_STRING	"BL1"
+#elif defined(AARCH64) && defined(IMAGE_BL2) && BL2_AT_EL3
+# define BL_STRING	"BL2"
 #elif defined(AARCH64) && defined(IMAGE_BL31)
 # define BL_STRING	"BL31"
 #elif defined(AARCH32) && defined(IMAGE_BL32)
@@ -88,7 +88,7 @@ static void cm_init_context_common(cpu_context_t *ctx, const entry_point_info_t
 	if (EP_GET_ST(ep->h.attr))
 		scr_el3 |= SCR_ST_BIT;
 
-#ifndef HANDLE_EA_EL3_FIRST
+#if !HANDLE_EA_EL3_FIRST
 	/* Explicitly stop to trap aborts from lower exception levels. */
 	scr_el3 &= ~SCR_EA_BIT;
 #endif
@@ -181,6 +181,79 @@ void cm_init_my_context(const entry_point_info_t *ep)
 	cm_init_context_common(ctx, ep);
 }
 
+#if CTX_LAZY_FPREGS
+/*******************************************************************************
+ * The FP/SIMD registers of a CPU hold the state of at most one of its two
+ * contexts, the one marked with CTX_FPREGS_LIVE. Before returning to a lower
+ * EL, trap its FP/SIMD accesses to EL3 unless its own state is the live one.
+ ******************************************************************************/
+static void cm_fpregs_prepare_el3_exit(cpu_context_t *ctx)
+{
+	uint32_t cptr_el3 = read_cptr_el3();
+
+	if (read_ctx_reg(get_el3state_ctx(ctx), CTX_FPREGS_LIVE))
+		cptr_el3 &= ~TFP_BIT;
+	else
+		cptr_el3 |= TFP_BIT;
+
+	write_cptr_el3(cptr_el3);
+}
+
+/*******************************************************************************
+ * Handle the first FP/SIMD access of a lower EL since it has been entered with
+ * its FP/SIMD state not live. The state of the other security state is saved
+ * to its context if it was live, the state of the caller is loaded from its
+ * context and the trap is disabled so that the access can be re-executed.
+ ******************************************************************************/
+void cm_handle_fpregs_trap(void)
+{
+	uint32_t security_state, other_state;
+	cpu_context_t *ctx, *other_ctx;
+
+	security_state = (read_scr_el3() & SCR_NS_BIT) ? NON_SECURE : SECURE;
+	other_state = (security_state == SECURE) ? NON_SECURE : SECURE;
+
+	ctx = cm_get_context(security_state);
+	assert(ctx);
+	other_ctx = cm_get_context(other_state);
+
+	/* Stop trapping the FP/SIMD accesses, including the ones from EL3 */
+	write_cptr_el3(read_cptr_el3() & ~TFP_BIT);
+	isb();
+
+	if (other_ctx &&
+	    read_ctx_reg(get_el3state_ctx(other_ctx), CTX_FPREGS_LIVE)) {
+		fpregs_context_save(get_fpregs_ctx(other_ctx));
+		write_ctx_reg(get_el3state_ctx(other_ctx), CTX_FPREGS_LIVE, 0);
+	}
+
+	fpregs_context_restore(get_fpregs_ctx(ctx));
+	write_ctx_reg(get_el3state_ctx(ctx), CTX_FPREGS_LIVE, 1);
+}
+#endif /* CTX_LAZY_FPREGS */
+
+/*******************************************************************************
+ * Load the EL1 system registers of a freshly initialised context and make it
+ * the one used for the next exception return.
+ ******************************************************************************/
+static void cm_el1_prepare_el3_exit(cpu_context_t *ctx)
+{
+	/*
+	 * The registers skipped by the world switches must be loaded with the
+	 * freshly initialised values of this context.
+	 */
+#if CTX_SKIP_SP_UNUSED_SYSREGS
+	el1_sysregs_context_restore_all(get_sysregs_ctx(ctx));
+#else
+	el1_sysregs_context_restore(get_sysregs_ctx(ctx));
+#endif
+
+#if CTX_LAZY_FPREGS
+	cm_fpregs_prepare_el3_exit(ctx);
+#endif
+	cm_set_next_context(ctx);
+}
+
 /*******************************************************************************
  * Prepare the CPU system registers for first entry into secure or normal world
  *
@@ -206,7 +279,13 @@ void cm_prepare_el3_exit(uint32_t security_state)
 			sctlr_elx |= SCTLR_EL2_RES1;
 			write_sctlr_el2(sctlr_elx);
 		} else if (EL_IMPLEMENTED(2)) {
-			/* EL2 present but unused, need to disable safely */
+			/*
+			 * EL2 present but unused, need to disable safely.
+			 * This is done on every warm boot too: the EL2
+			 * registers are not retained when the core powers
+			 * down, so their values cannot be kept from an earlier
+			 * entry into the normal world.
+			 */
 
 			/* HCR_EL2 = 0, except RW bit set to match SCR_EL3 */
 			write_hcr_el2((scr_el3 & SCR_RW_BIT) ? HCR_RW_BIT : 0);
@@ -260,9 +339,35 @@ void cm_prepare_el3_exit(uint32_t security_state)
 		}
 	}
 
-	el1_sysregs_context_restore(get_sysregs_ctx(ctx));
+	cm_el1_prepare_el3_exit(ctx);
+}
 
-	cm_set_next_context(ctx);
+/*******************************************************************************
+ * Prepare the CPU system registers to re-enter the normal world at the EL that
+ * switched its execution state, once its context has been re-initialised with
+ * SCR_EL3.RW flipped. The EL2 registers programmed by cm_prepare_el3_exit()
+ * when the normal world was last entered cannot have been changed since by a
+ * caller running below EL2, so only HCR_EL2.RW is updated for it. A caller at
+ * EL2 gets SCTLR_EL2 reset as on its first entry.
+ ******************************************************************************/
+void cm_prepare_el3_exit_state_switch(void)
+{
+	uint32_t sctlr_elx, scr_el3;
+	cpu_context_t *ctx = cm_get_context(NON_SECURE);
+
+	assert(ctx);
+
+	scr_el3 = read_ctx_reg(get_el3state_ctx(ctx), CTX_SCR_EL3);
+	if (scr_el3 & SCR_HCE_BIT) {
+		sctlr_elx = read_ctx_reg(get_sysregs_ctx(ctx), CTX_SCTLR_EL1);
+		sctlr_elx &= ~SCTLR_EE_BIT;
+		sctlr_elx |= SCTLR_EL2_RES1;
+		write_sctlr_el2(sctlr_elx);
+	} else if (EL_IMPLEMENTED(2)) {
+		write_hcr_el2((scr_el3 & SCR_RW_BIT) ? HCR_RW_BIT : 0);
+	}
+
+	cm_el1_prepare_el3_exit(ctx);
 }
 
 /*******************************************************************************
@@ -270,7 +375,7 @@ void cm_prepare_el3_exit(uint32_t security_state)
  * EL1 context on the 'cpu_context' structure for the specified security
  * state.
  ******************************************************************************/
-void cm_el1_sysregs_context_save(uint32_t security_state)
+void __hot cm_el1_sysregs_context_save(uint32_t security_state)
 {
 	cpu_context_t *ctx;
 
@@ -280,7 +385,7 @@ void cm_el1_sysregs_context_save(uint32_t security_state)
 	el1_sysregs_context_save(get_sysregs_ctx(ctx));
 }
 
-void cm_el1_sysregs_context_restore(uint32_t security_state)
+void __hot cm_el1_sysregs_context_restore(uint32_t security_state)
 {
 	cpu_context_t *ctx;
 
@@ -381,12 +486,15 @@ uint32_t cm_get_scr_el3(uint32_t security_state)
  * return. This initializes the SP_EL3 to a pointer to a 'cpu_context' set for
  * the required security state
  ******************************************************************************/
-void cm_set_next_eret_context(uint32_t security_state)
+void __hot cm_set_next_eret_context(uint32_t security_state)
 {
 	cpu_context_t *ctx;
 
 	ctx = cm_get_context(security_state);
 	assert(ctx);
 
+#if CTX_LAZY_FPREGS
+	cm_fpregs_prepare_el3_exit(ctx);
+#endif
 	cm_set_next_context(ctx);
 }
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <bl_common.h>
+#include <context.h>
+#include <context_mgmt.h>
+#include <platform_def.h>
+#include <utils_def.h>
+
+/*
+ * Each context starts on a cache line of its own, so that the contexts of two
+ * CPUs never share a line.
+ */
+typedef struct cpu_context_slot {
+	cpu_context_t ctx;
+} __aligned(CACHE_WRITEBACK_GRANULE) cpu_context_slot_t;
+
+/*
+ * The secure and non-secure contexts of a CPU are next to each other, so that
+ * a world switch saves and restores neighbouring memory.
+ */
+static cpu_context_slot_t cpu_context_array[PLATFORM_CORE_COUNT][2];
+
+/*******************************************************************************
+ * This function returns the 'cpu_context' structure reserved for the specified
+ * security state of the CPU identified by CPU index. The PSCI library uses the
+ * non-secure ones, and the Secure Payload Dispatchers with a context per CPU
+ * the secure ones. The caller registers the context with
+ * cm_set_context_by_index() before it is used.
+ ******************************************************************************/
+void *cm_get_context_slot_by_index(unsigned int cpu_idx,
+				   unsigned int security_state)
+{
+	assert(cpu_idx < PLATFORM_CORE_COUNT);
+	assert(sec_state_is_valid(security_state));
+
+	return &cpu_context_array[cpu_idx][security_state].ctx;
+}
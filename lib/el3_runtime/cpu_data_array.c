@@ -7,6 +7,7 @@
 #include <cassert.h>
 #include <cpu_data.h>
 #include <platform_def.h>
+#include <utils_def.h>
 
 /* The per_cpu_ptr_cache_t space allocation */
-cpu_data_t percpu_data[PLATFORM_CORE_COUNT];
+cpu_data_t percpu_data[PLATFORM_CORE_COUNT] __hot_bss;
@@ -56,6 +56,20 @@ extern void *__PERCPU_BAKERY_LOCK_SIZE__;
 #define get_bakery_info(cpu_ix, lock)	\
 	(bakery_info_t *)((uintptr_t)lock + cpu_ix * PERCPU_BAKERY_LOCK_SIZE)
 
+#if HW_ASSISTED_COHERENCY
+/*
+ * All the contenders access the lock with their data cache enabled and are
+ * coherent, so no cache maintenance is required. The barrier still makes the
+ * updates of the bakery information visible to the other contenders.
+ */
+#define write_cache_op(addr, cached)	\
+				do {	\
+					(void)(cached);	\
+					dsbish();	\
+				} while (0)
+
+#define read_cache_op(addr, cached)	(void)(cached)
+#else
 #define write_cache_op(addr, cached)	\
 				do {	\
 					(cached ? dccvac((uintptr_t)addr) :\
@@ -65,6 +79,7 @@ extern void *__PERCPU_BAKERY_LOCK_SIZE__;
 
 #define read_cache_op(addr, cached)	if (cached) \
 					    dccivac((uintptr_t)addr)
+#endif
 
 /* Helper function to check if the lock is acquired */
 static inline int is_lock_acquired(const bakery_info_t *my_bakery_info,
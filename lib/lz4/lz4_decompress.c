@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <errno.h>
+#include <lz4.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Minimum length of a match, added to the length stored in the token */
+#define LZ4_MIN_MATCH		4
+
+/*
+ * Add the extra bytes of a literal or match length, which is encoded as a
+ * sequence of bytes terminated by a byte other than 255.
+ */
+static int read_length(const uint8_t **ip, const uint8_t *iend, size_t *len)
+{
+	uint8_t b;
+
+	do {
+		if (*ip >= iend)
+			return -EINVAL;
+		b = *(*ip)++;
+		*len += b;
+	} while (b == 255);
+
+	return 0;
+}
+
+/*******************************************************************************
+ * Decompress the LZ4 block of 'src_len' bytes at 'src' into the 'dst_len'
+ * bytes at 'dst'. The block must not reference data outside of itself, which
+ * is the case of the blocks of a frame with independent blocks. The data is
+ * not trusted: any sequence reading or writing out of the buffers makes this
+ * fail with -EINVAL. On success, 'out_len' is set to the decompressed size.
+ ******************************************************************************/
+int lz4_decompress_block(const void *src, size_t src_len, void *dst,
+			 size_t dst_len, size_t *out_len)
+{
+	const uint8_t *ip = src;
+	const uint8_t *iend = ip + src_len;
+	uint8_t *op = dst;
+	uint8_t *oend = op + dst_len;
+	const uint8_t *match;
+	size_t len, offset;
+	uint8_t token;
+
+	for (;;) {
+		if (ip >= iend)
+			return -EINVAL;
+		token = *ip++;
+
+		/* Copy the literals */
+		len = token >> 4;
+		if ((len == 15) && (read_length(&ip, iend, &len) != 0))
+			return -EINVAL;
+		if ((len > (size_t)(iend - ip)) || (len > (size_t)(oend - op)))
+			return -EINVAL;
+		memcpy(op, ip, len);
+		op += len;
+		ip += len;
+
+		/* The last sequence of the block only holds literals */
+		if (ip == iend)
+			break;
+
+		/* Copy the match, which may overlap with the output */
+		if ((iend - ip) < 2)
+			return -EINVAL;
+		offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		if ((offset == 0) || (offset > (size_t)(op - (uint8_t *)dst)))
+			return -EINVAL;
+
+		len = token & 0xf;
+		if ((len == 15) && (read_length(&ip, iend, &len) != 0))
+			return -EINVAL;
+		len += LZ4_MIN_MATCH;
+		if (len > (size_t)(oend - op))
+			return -EINVAL;
+
+		match = op - offset;
+		if (offset >= len) {
+			memcpy(op, match, len);
+			op += len;
+		} else {
+			while (len--)
+				*op++ = *match++;
+		}
+	}
+
+	*out_len = op - (uint8_t *)dst;
+	return 0;
+}
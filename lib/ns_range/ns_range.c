@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Index of the physical memory by security attribute, used to check the
+ * buffers passed by the normal world to the SMC handlers.
+ */
+
+#include <assert.h>
+#include <debug.h>
+#include <ns_range.h>
+#include <platform_def.h>
+#include <utils_def.h>
+
+/* Maximum number of disjoint ranges of each security attribute */
+#ifndef PLAT_NS_RANGE_MAX
+#define PLAT_NS_RANGE_MAX	16
+#endif
+
+/* Range of memory, 'end' being the address of its last byte */
+typedef struct ns_range {
+	unsigned long long base;
+	unsigned long long end;
+} ns_range_t;
+
+/*
+ * Ranges of a security attribute, sorted by address. Overlapping and adjacent
+ * ranges are merged when they are added.
+ */
+typedef struct ns_range_table {
+	ns_range_t ranges[PLAT_NS_RANGE_MAX];
+	unsigned int num;
+} ns_range_table_t;
+
+static ns_range_table_t ns_range_tables[2];
+
+/* Return whether the range 'r' ends before the byte preceding 'base' */
+static int range_is_before(const ns_range_t *r, unsigned long long base)
+{
+	return (base != 0) && (r->end < base - 1);
+}
+
+/* Return whether the range 'r' starts after the byte following 'end' */
+static int range_is_after(const ns_range_t *r, unsigned long long end)
+{
+	return (end != ~0ULL) && (r->base > end + 1);
+}
+
+/*******************************************************************************
+ * Add the 'size' bytes at 'base' to the memory of the security attribute
+ * 'attr'. The secure memory takes precedence over the overlapping non-secure
+ * one. The index is meant to be built during the cold boot, before the SMC
+ * handlers can use it.
+ ******************************************************************************/
+void ns_range_add(unsigned long long base, unsigned long long size,
+		  unsigned int attr)
+{
+	ns_range_table_t *table;
+	unsigned long long end;
+	unsigned int first, last, i;
+
+	assert((attr == NS_RANGE_SECURE) || (attr == NS_RANGE_NS));
+	assert(size != 0);
+	assert(base + size - 1 >= base);
+
+	table = &ns_range_tables[attr];
+	end = base + size - 1;
+
+	/* Find the ranges overlapping or adjacent to the new one */
+	for (first = 0; first < table->num; first++) {
+		if (!range_is_before(&table->ranges[first], base))
+			break;
+	}
+	for (last = first; last < table->num; last++) {
+		if (range_is_after(&table->ranges[last], end))
+			break;
+	}
+
+	if (first == last) {
+		if (table->num == PLAT_NS_RANGE_MAX) {
+			ERROR("NS range: No space for 0x%llx-0x%llx\n",
+			      base, end);
+			panic();
+		}
+
+		for (i = table->num; i > first; i--)
+			table->ranges[i] = table->ranges[i - 1];
+		table->num++;
+	} else {
+		base = MIN(base, table->ranges[first].base);
+		end = MAX(end, table->ranges[last - 1].end);
+
+		for (i = last; i < table->num; i++)
+			table->ranges[first + 1 + i - last] = table->ranges[i];
+		table->num -= last - first - 1;
+	}
+
+	table->ranges[first].base = base;
+	table->ranges[first].end = end;
+}
+
+/*
+ * Return the index of the first range of 'table' that does not end before
+ * 'addr', or the number of ranges if there is none.
+ */
+static unsigned int ns_range_search(const ns_range_table_t *table,
+				    unsigned long long addr)
+{
+	unsigned int lo = 0, hi = table->num, mid;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (table->ranges[mid].end < addr)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
+/*******************************************************************************
+ * Return 1 if the 'size' bytes at 'base' are all in the non-secure memory and
+ * do not overlap the secure memory, or 0 otherwise.
+ ******************************************************************************/
+int is_ns_range(unsigned long long base, unsigned long long size)
+{
+	const ns_range_table_t *table;
+	unsigned long long end = base + size - 1;
+	unsigned int i;
+
+	if ((size == 0) || (end < base))
+		return 0;
+
+	/* The non-secure ranges are merged, so a single one must contain it */
+	table = &ns_range_tables[NS_RANGE_NS];
+	i = ns_range_search(table, base);
+	if ((i == table->num) || (table->ranges[i].base > base) ||
+	    (table->ranges[i].end < end))
+		return 0;
+
+	table = &ns_range_tables[NS_RANGE_SECURE];
+	i = ns_range_search(table, base);
+	if ((i < table->num) && (table->ranges[i].base <= end))
+		return 0;
+
+	return 1;
+}
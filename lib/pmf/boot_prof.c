@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <boot_prof.h>
+#include <cassert.h>
+#include <platform_def.h>
+#include <pmf.h>
+#include <utils.h>
+
+/*
+ * The boot profile time-stamps are kept in the platform memory starting at
+ * PLAT_BOOT_PROF_BASE, which must be mapped by every BL image and keep its
+ * content until the end of the cold boot. BL1 clears it and each BL image
+ * then records the milestones of the images it loads and runs, so that BL31
+ * can report all of them through the PMF time-stamp SMC.
+ */
+CASSERT(BOOT_PROF_SIZE <= PLAT_BOOT_PROF_SIZE, assert_boot_prof_size);
+CASSERT(BOOT_PROF_TOTAL_IDS <= (PMF_TID_MASK >> PMF_TID_SHIFT) + 1,
+	assert_boot_prof_total_ids);
+
+#define boot_prof_ts	((unsigned long long *)PLAT_BOOT_PROF_BASE)
+
+/* Clear the time-stamps at the start of the cold boot */
+void boot_prof_init(void)
+{
+	zeromem(boot_prof_ts, BOOT_PROF_SIZE);
+	flush_dcache_range(PLAT_BOOT_PROF_BASE, BOOT_PROF_SIZE);
+}
+
+/* Record the current time for a milestone of the given image */
+void boot_prof_capture(unsigned int image_id, unsigned int event)
+{
+	unsigned long long *ts_addr;
+
+	assert(event < BOOT_PROF_EVENTS);
+	if (image_id >= BOOT_PROF_MAX_IMAGES)
+		return;
+
+	ts_addr = &boot_prof_ts[BOOT_PROF_TID(image_id, event)];
+	*ts_addr = read_cntpct_el0();
+	flush_dcache_range((uintptr_t)ts_addr, sizeof(unsigned long long));
+}
+
+#ifdef IMAGE_BL31
+/*
+ * Return a boot milestone. The boot is profiled on the primary CPU only, so
+ * `mpidr` is ignored.
+ */
+static unsigned long long boot_prof_get_ts(unsigned int tid,
+					   u_register_t mpidr,
+					   unsigned int flags)
+{
+	unsigned long long *ts_addr;
+
+	ts_addr = &boot_prof_ts[tid & PMF_TID_MASK];
+	if (flags & PMF_CACHE_MAINT)
+		inv_dcache_range((uintptr_t)ts_addr,
+				 sizeof(unsigned long long));
+
+	return *ts_addr;
+}
+
+PMF_REGISTER_SERVICE_SMC_OWN(boot_prof, PMF_ARM_TIF_IMPL_ID,
+	PMF_BOOT_PROF_SVC_ID, BOOT_PROF_TOTAL_IDS, NULL, boot_prof_get_ts)
+#endif /* IMAGE_BL31 */
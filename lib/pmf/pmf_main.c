@@ -10,7 +10,12 @@
 #include <errno.h>
 #include <platform.h>
 #include <pmf.h>
+#include <spinlock.h>
 #include <string.h>
+#if PMF_NS_BUFFER
+#include <ns_range.h>
+#include <xlat_tables_v2.h>
+#endif
 
 /*******************************************************************************
  * The 'pmf_svc_descs' array holds the PMF service descriptors exported by
@@ -223,7 +228,8 @@ void __pmf_store_timestamp(uintptr_t base_addr,
 /*
  * This is the cached version of `pmf_store_my_timestamp`
  * Note: The timestamp addresses are cache line aligned per cpu
- * and only the owning CPU would ever write into it.
+ * and only the owning CPU would ever write into it. With USE_COHERENT_MEM,
+ * the time-stamps are in coherent memory and need no cache maintenance.
  */
 void __pmf_store_timestamp_with_cache_maint(uintptr_t base_addr,
 			unsigned int tid,
@@ -232,7 +238,9 @@ void __pmf_store_timestamp_with_cache_maint(uintptr_t base_addr,
 	unsigned long long *ts_addr = (unsigned long long *)calc_ts_addr(base_addr,
 				 tid, plat_my_core_pos());
 	*ts_addr = ts;
+#if !USE_COHERENT_MEM
 	flush_dcache_range((uintptr_t)ts_addr, sizeof(unsigned long long));
+#endif
 }
 
 /*
@@ -249,8 +257,107 @@ unsigned long long __pmf_get_timestamp(uintptr_t base_addr,
 	unsigned long long *ts_addr = (unsigned long long *)calc_ts_addr(base_addr,
 				tid, cpuid);
 
+#if !USE_COHERENT_MEM
 	if (flags & PMF_CACHE_MAINT)
 		inv_dcache_range((uintptr_t)ts_addr, sizeof(unsigned long long));
+#endif
 
 	return *ts_addr;
 }
+
+#if PMF_NS_BUFFER
+/*
+ * Normal world buffer into which PMF_SMC_COPY_TIMESTAMPS_64 copies the
+ * time-stamps of a service for all the CPUs at once. It is mapped when it is
+ * registered, so that a copy doesn't have to update the translation tables.
+ */
+static uintptr_t pmf_ns_buf;
+static size_t pmf_ns_buf_size;
+static spinlock_t pmf_ns_buf_lock;
+
+/*
+ * This function maps the normal world buffer of `size` bytes at `base`, which
+ * must be in the non-secure memory described with ns_range_add(). The buffer
+ * can be registered only once.
+ */
+int pmf_set_ns_buffer_smc(uintptr_t base, size_t size)
+{
+	int rc;
+
+	if (!base || !size || !IS_PAGE_ALIGNED(base) || !IS_PAGE_ALIGNED(size))
+		return -EINVAL;
+
+	if (!is_ns_range(base, size))
+		return -EINVAL;
+
+	spin_lock(&pmf_ns_buf_lock);
+
+	if (pmf_ns_buf) {
+		rc = -EALREADY;
+	} else {
+		rc = mmap_add_dynamic_region(base, base, size,
+					     MT_MEMORY | MT_RW | MT_NS |
+					     MT_EXECUTE_NEVER);
+		if (rc == 0) {
+			pmf_ns_buf = base;
+			pmf_ns_buf_size = size;
+		}
+	}
+
+	spin_unlock(&pmf_ns_buf_lock);
+
+	return rc;
+}
+
+/*
+ * This function copies the time-stamps of the service identified by `tid` for
+ * all the CPUs to the normal world buffer. The time-stamps of a CPU are copied
+ * in the order of their ids, followed by the ones of the next CPU. `copied`
+ * returns the number of bytes copied.
+ */
+int pmf_copy_timestamps_smc(unsigned int tid,
+		unsigned int flags,
+		size_t *copied)
+{
+	pmf_svc_desc_t *svc_desc;
+	uintptr_t ts_addr;
+	size_t cpu_size;
+	unsigned int cpuid;
+	int rc = 0;
+
+	assert(copied);
+	*copied = 0;
+
+	/* Only the services whose time-stamps are allocated by PMF are known */
+	svc_desc = get_service(tid & ~PMF_TID_MASK);
+	if ((svc_desc == NULL) || (svc_desc->ts_mem == NULL))
+		return -EINVAL;
+
+	cpu_size = (svc_desc->svc_config & PMF_TID_MASK) *
+		sizeof(unsigned long long);
+
+	spin_lock(&pmf_ns_buf_lock);
+
+	if (!pmf_ns_buf) {
+		rc = -EPERM;
+	} else if ((cpu_size * PLATFORM_CORE_COUNT) > pmf_ns_buf_size) {
+		rc = -ENOMEM;
+	} else {
+		for (cpuid = 0; cpuid < PLATFORM_CORE_COUNT; cpuid++) {
+			ts_addr = calc_ts_addr((uintptr_t)svc_desc->ts_mem, 0,
+					       cpuid);
+#if !USE_COHERENT_MEM
+			if (flags & PMF_CACHE_MAINT)
+				inv_dcache_range(ts_addr, cpu_size);
+#endif
+			memcpy((void *)(pmf_ns_buf + (cpuid * cpu_size)),
+			       (void *)ts_addr, cpu_size);
+		}
+		*copied = cpu_size * PLATFORM_CORE_COUNT;
+	}
+
+	spin_unlock(&pmf_ns_buf_lock);
+
+	return rc;
+}
+#endif /* PMF_NS_BUFFER */
@@ -7,6 +7,7 @@
 #include <debug.h>
 #include <platform.h>
 #include <pmf.h>
+#include <runtime_svc.h>
 #include <smcc_helpers.h>
 
 /*
@@ -57,6 +58,29 @@ uintptr_t pmf_smc_handler(unsigned int smc_fid,
 			rc = pmf_get_timestamp_smc(x1, x2, x3, &ts_value);
 			SMC_RET2(handle, rc, ts_value);
 
+#if PMF_NS_BUFFER
+		case PMF_SMC_SET_NS_BUFFER_64:
+			/*
+			 * Register the normal world buffer of x2 bytes at x1.
+			 * x0 --> error code.
+			 */
+			SMC_RET1(handle, pmf_set_ns_buffer_smc(x1, x2));
+
+		case PMF_SMC_COPY_TIMESTAMPS_64:
+		{
+			size_t copied;
+
+			/*
+			 * Copy the time-stamps of the service identified by
+			 * x1 for all the CPUs to the registered buffer.
+			 * x0 --> error code.
+			 * x1 --> number of bytes copied.
+			 */
+			rc = pmf_copy_timestamps_smc(x1, x2, &copied);
+			SMC_RET2(handle, rc, copied);
+		}
+#endif
+
 		default:
 			break;
 		}
@@ -65,3 +89,33 @@ uintptr_t pmf_smc_handler(unsigned int smc_fid,
 	WARN("Unimplemented PMF Call: 0x%x \n", smc_fid);
 	SMC_RET1(handle, SMC_UNK);
 }
+
+#if ENABLE_SMC_LEAF_HANDLERS
+/*
+ * Leaf handler for the PMF time-stamp SMCs, which only read the PMF memory.
+ */
+static void pmf_smc_leaf_handler(uint32_t smc_fid,
+				 u_register_t x1,
+				 u_register_t x2,
+				 u_register_t x3,
+				 u_register_t *ret,
+				 u_register_t flags)
+{
+	unsigned long long ts_value;
+
+	if (smc_fid == PMF_SMC_GET_TIMESTAMP_32) {
+		ret[0] = pmf_get_timestamp_smc((uint32_t)x1, (uint32_t)x2,
+				(uint32_t)x3, &ts_value);
+		ret[1] = (uint32_t)ts_value;
+		ret[2] = (uint32_t)(ts_value >> 32);
+	} else {
+		ret[0] = pmf_get_timestamp_smc(x1, x2, x3, &ts_value);
+		ret[1] = ts_value;
+	}
+}
+
+DECLARE_RT_LEAF_SVC(pmf_get_ts_32, PMF_SMC_GET_TIMESTAMP_32,
+		    pmf_smc_leaf_handler);
+DECLARE_RT_LEAF_SVC(pmf_get_ts_64, PMF_SMC_GET_TIMESTAMP_64,
+		    pmf_smc_leaf_handler);
+#endif
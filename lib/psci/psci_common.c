@@ -33,13 +33,15 @@ const spd_pm_ops_t *psci_spd_pm;
  * local states requested for a particular non cpu power domain by each cpu
  * within the domain.
  *
- * TODO: Dense packing of the requested states will cause cache thrashing
- * when multiple power domains write to it. If we allocate the requested
- * states at each power level in a cache-line aligned per-domain memory,
- * the cache thrashing can be avoided.
+ * Dense packing of the requested states causes cache thrashing when multiple
+ * power domains write to it. With PSCI_CACHE_ALIGNED_STATE the requested
+ * states are instead kept in the cache-line aligned per-cpu data of each cpu
+ * and gathered into a local array for the platform during coordination.
  */
+#if !PSCI_CACHE_ALIGNED_STATE
 static plat_local_state_t
 	psci_req_local_pwr_states[PLAT_MAX_PWR_LVL][PLATFORM_CORE_COUNT];
+#endif
 
 
 /*******************************************************************************
@@ -58,13 +60,29 @@ __section("tzfw_coherent_mem")
 /* Lock for PSCI state coordination */
 DEFINE_PSCI_LOCK(psci_locks[PSCI_NUM_NON_CPU_PWR_DOMAINS]);
 
-cpu_pd_node_t psci_cpu_pd_nodes[PLATFORM_CORE_COUNT];
+cpu_pd_node_t psci_cpu_pd_nodes[PLATFORM_CORE_COUNT] __hot_bss;
+
+/*
+ * Index of the ancestor power domain node of each CPU at each power level
+ * above the CPU level, precomputed by psci_setup() so that the walks up the
+ * power domain tree on the power management paths do not need to chase the
+ * 'parent_node' links.
+ */
+unsigned int psci_cpu_parent_nodes[PLATFORM_CORE_COUNT][PLAT_MAX_PWR_LVL]
+	__aligned(CACHE_WRITEBACK_GRANULE);
 
 /*******************************************************************************
  * Pointer to functions exported by the platform to complete power mgmt. ops
  ******************************************************************************/
 const plat_psci_ops_t *psci_plat_pm_ops;
 
+#if PSCI_OS_INIT_MODE
+/*******************************************************************************
+ * The CPU_SUSPEND mode selected by the OS through PSCI_SET_SUSPEND_MODE
+ ******************************************************************************/
+suspend_mode_t psci_suspend_mode = PLAT_COORD;
+#endif
+
 /******************************************************************************
  * Check that the maximum power level supported by the platform makes sense
  *****************************************************************************/
@@ -159,11 +177,53 @@ unsigned int psci_is_last_on_cpu(void)
 
 		if (psci_get_aff_info_state_by_idx(cpu_idx) != AFF_STATE_OFF)
 			return 0;
+
+#if ENABLE_PSCI_CPU_FREEZE
+		/* A frozen CPU keeps running in BL31 */
+		if (psci_get_cpu_frozen_by_idx(cpu_idx))
+			return 0;
+#endif
 	}
 
 	return 1;
 }
 
+/*******************************************************************************
+ * Return the MPIDR of the CPU 'cpu_idx' if it is on, or PSCI_INVALID_MPIDR if
+ * it is off or being turned on. A CPU in a suspend state is on.
+ ******************************************************************************/
+u_register_t psci_get_on_cpu_mpidr(unsigned int cpu_idx)
+{
+	assert(cpu_idx < PLATFORM_CORE_COUNT);
+
+	if (psci_get_aff_info_state_by_idx(cpu_idx) != AFF_STATE_ON)
+		return PSCI_INVALID_MPIDR;
+
+	return psci_cpu_pd_nodes[cpu_idx].mpidr;
+}
+
+#if PSCI_OS_INIT_MODE
+/*******************************************************************************
+ * This function verifies that all the cores in the system are ON and running,
+ * that is none of them is suspended, turned OFF or being turned ON.
+ * Returns 1 (true) if all the cores are running or 0 (false) otherwise.
+ ******************************************************************************/
+unsigned int psci_are_all_cpus_on(void)
+{
+	unsigned int cpu_idx;
+	plat_local_state_t cpu_state;
+
+	for (cpu_idx = 0; cpu_idx < PLATFORM_CORE_COUNT; cpu_idx++) {
+		cpu_state = psci_get_cpu_local_state_by_idx(cpu_idx);
+		if ((psci_get_aff_info_state_by_idx(cpu_idx) != AFF_STATE_ON) ||
+		    !is_local_state_run(cpu_state))
+			return 0;
+	}
+
+	return 1;
+}
+#endif
+
 /*******************************************************************************
  * Routine to return the maximum power level to traverse to after a cpu has
  * been physically powered up. It is expected to be called immediately after
@@ -189,23 +249,67 @@ static unsigned int get_power_on_target_pwrlvl(void)
  * Helper function to update the requested local power state array. This array
  * does not store the requested state for the CPU power level. Hence an
  * assertion is added to prevent us from accessing the wrong index.
+ *
+ * With PSCI_RUN_CPU_COUNTS, it also counts the CPUs requesting the RUN state
+ * in the power domain node at 'pwrlvl', whose lock must be held.
  *****************************************************************************/
 static void psci_set_req_local_pwr_state(unsigned int pwrlvl,
 					 unsigned int cpu_idx,
 					 plat_local_state_t req_pwr_state)
 {
+#if PSCI_RUN_CPU_COUNTS
+	non_cpu_pd_node_t *node;
+	plat_local_state_t old_state;
+#endif
+
 	assert(pwrlvl > PSCI_CPU_PWR_LVL);
+
+#if PSCI_RUN_CPU_COUNTS
+	node = &psci_non_cpu_pd_nodes[psci_get_parent_node(cpu_idx, pwrlvl)];
+#if PSCI_CACHE_ALIGNED_STATE
+	old_state = get_cpu_data_by_index(cpu_idx,
+			psci_svc_cpu_data.req_local_pwr_states[pwrlvl - 1]);
+#else
+	old_state = psci_req_local_pwr_states[pwrlvl - 1][cpu_idx];
+#endif
+
+	if (is_local_state_run(old_state) && !is_local_state_run(req_pwr_state))
+		node->run_cpus--;
+	else if (!is_local_state_run(old_state) &&
+		 is_local_state_run(req_pwr_state))
+		node->run_cpus++;
+#endif
+
+#if PSCI_CACHE_ALIGNED_STATE
+	set_cpu_data_by_index(cpu_idx,
+			psci_svc_cpu_data.req_local_pwr_states[pwrlvl - 1],
+			req_pwr_state);
+#else
 	psci_req_local_pwr_states[pwrlvl - 1][cpu_idx] = req_pwr_state;
+#endif
 }
 
 /******************************************************************************
- * This function initializes the psci_req_local_pwr_states.
+ * This function initializes the psci_req_local_pwr_states. When they are kept
+ * in the per-cpu data, the caller flushes them.
  *****************************************************************************/
 void psci_init_req_local_pwr_states(void)
 {
+#if PSCI_CACHE_ALIGNED_STATE
+	psci_cpu_data_t *svc_cpu_data;
+	unsigned int cpu_idx;
+
+	/* Initialize the requested state of all non CPU power domains as OFF */
+	for (cpu_idx = 0; cpu_idx < PLATFORM_CORE_COUNT; cpu_idx++) {
+		svc_cpu_data = &_cpu_data_by_index(cpu_idx)->psci_svc_cpu_data;
+		memset(svc_cpu_data->req_local_pwr_states, PLAT_MAX_OFF_STATE,
+				sizeof(svc_cpu_data->req_local_pwr_states));
+	}
+#else
 	/* Initialize the requested state of all non CPU power domains as OFF */
 	memset(&psci_req_local_pwr_states, PLAT_MAX_OFF_STATE,
 			sizeof(psci_req_local_pwr_states));
+#endif
 }
 
 /******************************************************************************
@@ -215,15 +319,46 @@ void psci_init_req_local_pwr_states(void)
  * an ancestor. These requested states will be used to determine a suitable
  * target state for this power domain during psci state coordination. An
  * assertion is added to prevent us from accessing the CPU power level.
+ *
+ * With PSCI_CACHE_ALIGNED_STATE, the states requested by the 'ncpus' cpus
+ * starting at 'cpu_idx' are copied to 'buf', which is returned instead.
  *****************************************************************************/
 static plat_local_state_t *psci_get_req_local_pwr_states(unsigned int pwrlvl,
-							 unsigned int cpu_idx)
+						unsigned int cpu_idx,
+						unsigned int ncpus,
+						plat_local_state_t *buf)
 {
 	assert(pwrlvl > PSCI_CPU_PWR_LVL);
 
+#if PSCI_CACHE_ALIGNED_STATE
+	unsigned int i;
+
+	assert(cpu_idx + ncpus <= PLATFORM_CORE_COUNT);
+
+	for (i = 0; i < ncpus; i++)
+		buf[i] = get_cpu_data_by_index(cpu_idx + i,
+			psci_svc_cpu_data.req_local_pwr_states[pwrlvl - 1]);
+
+	return buf;
+#else
 	return &psci_req_local_pwr_states[pwrlvl - 1][cpu_idx];
+#endif
 }
 
+#if PSCI_OS_INIT_MODE
+/******************************************************************************
+ * Helper function to return the local power state requested by the cpu at
+ * 'cpu_idx' for its ancestor at 'pwrlvl'.
+ *****************************************************************************/
+static plat_local_state_t psci_get_req_local_pwr_state(unsigned int pwrlvl,
+						       unsigned int cpu_idx)
+{
+	plat_local_state_t req_state;
+
+	return *psci_get_req_local_pwr_states(pwrlvl, cpu_idx, 1, &req_state);
+}
+#endif
+
 /*
  * psci_non_cpu_pd_nodes can be placed either in normal memory or coherent
  * memory.
@@ -245,7 +380,7 @@ static plat_local_state_t *psci_get_req_local_pwr_states(unsigned int pwrlvl,
 static plat_local_state_t get_non_cpu_pd_node_local_state(
 		unsigned int parent_idx)
 {
-#if !USE_COHERENT_MEM || !HW_ASSISTED_COHERENCY
+#if !(USE_COHERENT_MEM || HW_ASSISTED_COHERENCY)
 	flush_dcache_range(
 			(uintptr_t) &psci_non_cpu_pd_nodes[parent_idx],
 			sizeof(psci_non_cpu_pd_nodes[parent_idx]));
@@ -261,7 +396,7 @@ static void set_non_cpu_pd_node_local_state(unsigned int parent_idx,
 		plat_local_state_t state)
 {
 	psci_non_cpu_pd_nodes[parent_idx].local_state = state;
-#if !USE_COHERENT_MEM || !HW_ASSISTED_COHERENCY
+#if !(USE_COHERENT_MEM || HW_ASSISTED_COHERENCY)
 	flush_dcache_range(
 			(uintptr_t) &psci_non_cpu_pd_nodes[parent_idx],
 			sizeof(psci_non_cpu_pd_nodes[parent_idx]));
@@ -277,16 +412,15 @@ static void set_non_cpu_pd_node_local_state(unsigned int parent_idx,
 void psci_get_target_local_pwr_states(unsigned int end_pwrlvl,
 				      psci_power_state_t *target_state)
 {
-	unsigned int parent_idx, lvl;
+	unsigned int parent_idx, lvl, cpu_idx = plat_my_core_pos();
 	plat_local_state_t *pd_state = target_state->pwr_domain_state;
 
 	pd_state[PSCI_CPU_PWR_LVL] = psci_get_cpu_local_state();
-	parent_idx = psci_cpu_pd_nodes[plat_my_core_pos()].parent_node;
 
 	/* Copy the local power state from node to state_info */
 	for (lvl = PSCI_CPU_PWR_LVL + 1; lvl <= end_pwrlvl; lvl++) {
+		parent_idx = psci_get_parent_node(cpu_idx, lvl);
 		pd_state[lvl] = get_non_cpu_pd_node_local_state(parent_idx);
-		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
 	}
 
 	/* Set the the higher levels to RUN */
@@ -303,7 +437,7 @@ void psci_get_target_local_pwr_states(unsigned int end_pwrlvl,
 static void psci_set_target_local_pwr_states(unsigned int end_pwrlvl,
 					const psci_power_state_t *target_state)
 {
-	unsigned int parent_idx, lvl;
+	unsigned int parent_idx, lvl, cpu_idx = plat_my_core_pos();
 	const plat_local_state_t *pd_state = target_state->pwr_domain_state;
 
 	psci_set_cpu_local_state(pd_state[PSCI_CPU_PWR_LVL]);
@@ -314,12 +448,10 @@ static void psci_set_target_local_pwr_states(unsigned int end_pwrlvl,
 	 */
 	psci_flush_cpu_data(psci_svc_cpu_data.local_state);
 
-	parent_idx = psci_cpu_pd_nodes[plat_my_core_pos()].parent_node;
-
 	/* Copy the local_state from state_info */
 	for (lvl = 1; lvl <= end_pwrlvl; lvl++) {
+		parent_idx = psci_get_parent_node(cpu_idx, lvl);
 		set_non_cpu_pd_node_local_state(parent_idx, pd_state[lvl]);
-		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
 	}
 }
 
@@ -331,13 +463,10 @@ void psci_get_parent_pwr_domain_nodes(unsigned int cpu_idx,
 				      unsigned int end_lvl,
 				      unsigned int node_index[])
 {
-	unsigned int parent_node = psci_cpu_pd_nodes[cpu_idx].parent_node;
 	int i;
 
-	for (i = PSCI_CPU_PWR_LVL + 1; i <= end_lvl; i++) {
-		*node_index++ = parent_node;
-		parent_node = psci_non_cpu_pd_nodes[parent_node].parent_node;
-	}
+	for (i = PSCI_CPU_PWR_LVL + 1; i <= end_lvl; i++)
+		*node_index++ = psci_get_parent_node(cpu_idx, i);
 }
 
 /******************************************************************************
@@ -348,16 +477,15 @@ void psci_get_parent_pwr_domain_nodes(unsigned int cpu_idx,
 void psci_set_pwr_domains_to_run(unsigned int end_pwrlvl)
 {
 	unsigned int parent_idx, cpu_idx = plat_my_core_pos(), lvl;
-	parent_idx = psci_cpu_pd_nodes[cpu_idx].parent_node;
 
 	/* Reset the local_state to RUN for the non cpu power domains. */
 	for (lvl = PSCI_CPU_PWR_LVL + 1; lvl <= end_pwrlvl; lvl++) {
+		parent_idx = psci_get_parent_node(cpu_idx, lvl);
 		set_non_cpu_pd_node_local_state(parent_idx,
 				PSCI_LOCAL_STATE_RUN);
 		psci_set_req_local_pwr_state(lvl,
 					     cpu_idx,
 					     PSCI_LOCAL_STATE_RUN);
-		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
 	}
 
 	/* Set the affinity info state to ON */
@@ -390,30 +518,50 @@ void psci_set_pwr_domains_to_run(unsigned int end_pwrlvl)
 void psci_do_state_coordination(unsigned int end_pwrlvl,
 				psci_power_state_t *state_info)
 {
-	unsigned int lvl, parent_idx, cpu_idx = plat_my_core_pos();
+	unsigned int lvl, run_lvl, parent_idx, cpu_idx = plat_my_core_pos();
 	unsigned int start_idx, ncpus;
 	plat_local_state_t target_state, *req_states;
+#if PSCI_CACHE_ALIGNED_STATE
+	plat_local_state_t req_states_buf[PLATFORM_CORE_COUNT];
+#else
+	plat_local_state_t *req_states_buf = NULL;
+#endif
 
 	assert(end_pwrlvl <= PLAT_MAX_PWR_LVL);
-	parent_idx = psci_cpu_pd_nodes[cpu_idx].parent_node;
 
 	/* For level 0, the requested state will be equivalent
 	   to target state */
 	for (lvl = PSCI_CPU_PWR_LVL + 1; lvl <= end_pwrlvl; lvl++) {
+		parent_idx = psci_get_parent_node(cpu_idx, lvl);
 
 		/* First update the requested power state */
 		psci_set_req_local_pwr_state(lvl, cpu_idx,
 					     state_info->pwr_domain_state[lvl]);
 
+#if PSCI_RUN_CPU_COUNTS
+		/*
+		 * The target state cannot be deeper than a request, so it is
+		 * RUN as long as a CPU requests RUN, without looking at the
+		 * requests of all the CPUs.
+		 */
+		if (psci_non_cpu_pd_nodes[parent_idx].run_cpus != 0U) {
+			state_info->pwr_domain_state[lvl] =
+				PSCI_LOCAL_STATE_RUN;
+			break;
+		}
+#endif
+
 		/* Get the requested power states for this power level */
 		start_idx = psci_non_cpu_pd_nodes[parent_idx].cpu_start_idx;
-		req_states = psci_get_req_local_pwr_states(lvl, start_idx);
+		ncpus = psci_non_cpu_pd_nodes[parent_idx].ncpus;
+		req_states = psci_get_req_local_pwr_states(lvl, start_idx,
+							   ncpus,
+							   req_states_buf);
 
 		/*
 		 * Let the platform coordinate amongst the requested states at
 		 * this power level and return the target local power state.
 		 */
-		ncpus = psci_non_cpu_pd_nodes[parent_idx].ncpus;
 		target_state = plat_get_target_pwr_state(lvl,
 							 req_states,
 							 ncpus);
@@ -423,8 +571,6 @@ void psci_do_state_coordination(unsigned int end_pwrlvl,
 		/* Break early if the negotiated target power state is RUN */
 		if (is_local_state_run(state_info->pwr_domain_state[lvl]))
 			break;
-
-		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
 	}
 
 	/*
@@ -433,6 +579,7 @@ void psci_do_state_coordination(unsigned int end_pwrlvl,
 	 * We update the requested power state from state_info and then
 	 * set the target state as RUN.
 	 */
+	run_lvl = lvl;
 	for (lvl = lvl + 1; lvl <= end_pwrlvl; lvl++) {
 		psci_set_req_local_pwr_state(lvl, cpu_idx,
 					     state_info->pwr_domain_state[lvl]);
@@ -440,9 +587,88 @@ void psci_do_state_coordination(unsigned int end_pwrlvl,
 
 	}
 
+	/*
+	 * Update the target state in the power domain nodes. The ones above
+	 * the level kept running are already in the RUN state, and their locks
+	 * are not held with PSCI_SUSPEND_LOCK_ELISION.
+	 */
+	psci_set_target_local_pwr_states(MIN(run_lvl, end_pwrlvl), state_info);
+}
+
+#if PSCI_OS_INIT_MODE
+/******************************************************************************
+ * This function replaces psci_do_state_coordination() in OS-initiated mode,
+ * where the OS coordinates the states of the power domains and the calling
+ * CPU requests them in the composite state passed in 'state_info'. It must
+ * be called with the locks of all the power levels held.
+ *
+ * The CPU records the state it requests for each power level up to
+ * 'req_pwrlvl'. It does not constrain the levels above, so it records the
+ * deepest possible state for them. The platform coordination of the recorded
+ * states must then yield the requested state at each level up to
+ * 'req_pwrlvl': a RUN result means that another CPU in the power domain is
+ * still running and PSCI_E_DENIED is returned, any other mismatch means that
+ * the request is deeper than allowed by another CPU and PSCI_E_INVALID_PARAMS
+ * is returned. The previously recorded states are restored on error.
+ *****************************************************************************/
+int psci_validate_state_coordination(unsigned int req_pwrlvl,
+				     psci_power_state_t *state_info)
+{
+	unsigned int lvl, parent_idx, cpu_idx = plat_my_core_pos();
+	unsigned int start_idx, ncpus;
+	plat_local_state_t target_state, req_state, *req_states;
+	plat_local_state_t prev_states[PLAT_MAX_PWR_LVL];
+#if PSCI_CACHE_ALIGNED_STATE
+	plat_local_state_t req_states_buf[PLATFORM_CORE_COUNT];
+#else
+	plat_local_state_t *req_states_buf = NULL;
+#endif
+	int rc = PSCI_E_SUCCESS;
+
+	assert(req_pwrlvl <= PLAT_MAX_PWR_LVL);
+
+	for (lvl = PSCI_CPU_PWR_LVL + 1; lvl <= PLAT_MAX_PWR_LVL; lvl++) {
+		prev_states[lvl - 1] = psci_get_req_local_pwr_state(lvl,
+								    cpu_idx);
+
+		req_state = (lvl <= req_pwrlvl) ?
+			state_info->pwr_domain_state[lvl] : PLAT_MAX_OFF_STATE;
+		psci_set_req_local_pwr_state(lvl, cpu_idx, req_state);
+	}
+
+	for (lvl = PSCI_CPU_PWR_LVL + 1; lvl <= req_pwrlvl; lvl++) {
+		parent_idx = psci_get_parent_node(cpu_idx, lvl);
+
+		start_idx = psci_non_cpu_pd_nodes[parent_idx].cpu_start_idx;
+		ncpus = psci_non_cpu_pd_nodes[parent_idx].ncpus;
+		req_states = psci_get_req_local_pwr_states(lvl, start_idx,
+							   ncpus,
+							   req_states_buf);
+
+		target_state = plat_get_target_pwr_state(lvl,
+							 req_states,
+							 ncpus);
+
+		if (target_state != state_info->pwr_domain_state[lvl]) {
+			rc = is_local_state_run(target_state) ?
+				PSCI_E_DENIED : PSCI_E_INVALID_PARAMS;
+			break;
+		}
+	}
+
+	if (rc != PSCI_E_SUCCESS) {
+		for (lvl = PSCI_CPU_PWR_LVL + 1; lvl <= PLAT_MAX_PWR_LVL; lvl++)
+			psci_set_req_local_pwr_state(lvl, cpu_idx,
+						     prev_states[lvl - 1]);
+		return rc;
+	}
+
 	/* Update the target state in the power domain nodes */
-	psci_set_target_local_pwr_states(end_pwrlvl, state_info);
+	psci_set_target_local_pwr_states(PLAT_MAX_PWR_LVL, state_info);
+
+	return PSCI_E_SUCCESS;
 }
+#endif
 
 /******************************************************************************
  * This function validates a suspend request by making sure that if a standby
@@ -547,15 +773,75 @@ unsigned int psci_find_target_suspend_lvl(const psci_power_state_t *state_info)
 void psci_acquire_pwr_domain_locks(unsigned int end_pwrlvl,
 				   unsigned int cpu_idx)
 {
-	unsigned int parent_idx = psci_cpu_pd_nodes[cpu_idx].parent_node;
-	unsigned int level;
+	unsigned int parent_idx, level;
 
 	/* No locking required for level 0. Hence start locking from level 1 */
 	for (level = PSCI_CPU_PWR_LVL + 1; level <= end_pwrlvl; level++) {
+		parent_idx = psci_get_parent_node(cpu_idx, level);
 		psci_lock_get(&psci_non_cpu_pd_nodes[parent_idx]);
-		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
+		psci_lock_stat_acquired(cpu_idx, level);
+	}
+}
+
+#if PSCI_SUSPEND_LOCK_ELISION
+/*******************************************************************************
+ * This function replaces psci_acquire_pwr_domain_locks() for CPU_SUSPEND. It
+ * picks up the locks of the calling CPU in order of increasing power domain
+ * level until 'end_pwrlvl', but stops at the first level where another CPU
+ * requests the RUN state, and returns the level of the last lock taken.
+ *
+ * The coordinated state of that power domain is then RUN, as it cannot be
+ * deeper than any of the requests, and so is the state of the power domains
+ * above it. A CPU requesting RUN for a power domain requests it for all the
+ * domains above as well, so their coordination does not depend on the
+ * requests of the calling CPU, which it can update without their locks. This
+ * saves taking the locks of the higher levels, shared with the other clusters,
+ * when a CPU suspends while the rest of its cluster is running.
+ *
+ * All the locks are taken in OS-initiated mode.
+ ******************************************************************************/
+unsigned int psci_acquire_suspend_locks(unsigned int end_pwrlvl,
+					unsigned int cpu_idx)
+{
+	unsigned int parent_idx, level, start_idx, ncpus, i;
+	const plat_local_state_t *req_states;
+#if PSCI_CACHE_ALIGNED_STATE
+	plat_local_state_t req_states_buf[PLATFORM_CORE_COUNT];
+#else
+	plat_local_state_t *req_states_buf = NULL;
+#endif
+
+#if PSCI_OS_INIT_MODE
+	if (psci_suspend_mode == OS_INIT) {
+		psci_acquire_pwr_domain_locks(end_pwrlvl, cpu_idx);
+		return end_pwrlvl;
+	}
+#endif
+
+	for (level = PSCI_CPU_PWR_LVL + 1; level <= end_pwrlvl; level++) {
+		parent_idx = psci_get_parent_node(cpu_idx, level);
+		psci_lock_get(&psci_non_cpu_pd_nodes[parent_idx]);
+		psci_lock_stat_acquired(cpu_idx, level);
+
+		if (level == end_pwrlvl)
+			break;
+
+		start_idx = psci_non_cpu_pd_nodes[parent_idx].cpu_start_idx;
+		ncpus = psci_non_cpu_pd_nodes[parent_idx].ncpus;
+		req_states = psci_get_req_local_pwr_states(level, start_idx,
+							   ncpus,
+							   req_states_buf);
+
+		for (i = 0; i < ncpus; i++) {
+			if ((start_idx + i != cpu_idx) &&
+			    is_local_state_run(req_states[i]))
+				return level;
+		}
 	}
+
+	return end_pwrlvl;
 }
+#endif
 
 /*******************************************************************************
  * This function is passed a cpu_index and the highest level in the topology
@@ -565,15 +851,13 @@ void psci_acquire_pwr_domain_locks(unsigned int end_pwrlvl,
 void psci_release_pwr_domain_locks(unsigned int end_pwrlvl,
 				   unsigned int cpu_idx)
 {
-	unsigned int parent_idx, parent_nodes[PLAT_MAX_PWR_LVL] = {0};
+	unsigned int parent_idx;
 	int level;
 
-	/* Get the parent nodes */
-	psci_get_parent_pwr_domain_nodes(cpu_idx, end_pwrlvl, parent_nodes);
-
 	/* Unlock top down. No unlocking required for level 0. */
 	for (level = end_pwrlvl; level >= PSCI_CPU_PWR_LVL + 1; level--) {
-		parent_idx = parent_nodes[level - 1];
+		parent_idx = psci_get_parent_node(cpu_idx, level);
+		psci_lock_stat_released(cpu_idx, level);
 		psci_lock_release(&psci_non_cpu_pd_nodes[parent_idx]);
 	}
 }
@@ -732,7 +1016,7 @@ int psci_validate_entry_point(entry_point_info_t *ep,
  * code to enable the gic cpu interface and for a cluster it will enable
  * coherency at the interconnect level in addition to gic cpu interface.
  ******************************************************************************/
-void psci_warmboot_entrypoint(void)
+void __hot psci_warmboot_entrypoint(void)
 {
 	unsigned int end_pwrlvl, cpu_idx = plat_my_core_pos();
 	psci_power_state_t state_info = { {PSCI_LOCAL_STATE_RUN} };
@@ -789,22 +1073,20 @@ void psci_warmboot_entrypoint(void)
 	 */
 	psci_set_pwr_domains_to_run(end_pwrlvl);
 
-#if ENABLE_PSCI_STAT
-	/*
-	 * Update PSCI stats.
-	 * Caches are off when writing stats data on the power down path.
-	 * Since caches are now enabled, it's necessary to do cache
-	 * maintenance before reading that same data.
-	 */
-	psci_stats_update_pwr_up(end_pwrlvl, &state_info);
-#endif
-
 	/*
 	 * This loop releases the lock corresponding to each power level
 	 * in the reverse order to which they were acquired.
 	 */
 	psci_release_pwr_domain_locks(end_pwrlvl,
 				      cpu_idx);
+
+#if ENABLE_PSCI_STAT
+	/*
+	 * Update PSCI stats. Only the entry of this CPU is written, so this is
+	 * done outside of the power domain locks.
+	 */
+	psci_stats_update_pwr_up(end_pwrlvl, &state_info);
+#endif
 }
 
 /*******************************************************************************
@@ -991,6 +1273,80 @@ int psci_get_suspend_afflvl(void)
 
 #endif
 
+/*******************************************************************************
+ * This function returns the entry `index` of the idle state table of the
+ * platform, or NULL if there is no such entry. It lets the platform export the
+ * cost of its local power states to the normal world.
+ ******************************************************************************/
+const plat_psci_idle_state_t *psci_get_idle_state(unsigned int index)
+{
+	const plat_psci_idle_state_t *states;
+	unsigned int num_states = 0;
+
+	if (psci_plat_pm_ops->get_idle_states == NULL)
+		return NULL;
+
+	states = psci_plat_pm_ops->get_idle_states(&num_states);
+	if ((states == NULL) || (index >= num_states))
+		return NULL;
+
+	return &states[index];
+}
+
+#ifndef AARCH32
+/*
+ * Return the minimum of 'wake_time' and the number of ticks until the timer
+ * with the control register 'ctl' and the compare value 'cval' fires, with
+ * its counter at 'now'.
+ */
+static unsigned long long psci_timer_wake_time(u_register_t ctl, uint64_t cval,
+					       uint64_t now,
+					       unsigned long long wake_time)
+{
+	if (!get_cntp_ctl_enable(ctl) || get_cntp_ctl_imask(ctl))
+		return wake_time;
+
+	if (get_cntp_ctl_istatus(ctl) || (cval <= now))
+		return 0;
+
+	return ((cval - now) < wake_time) ? (cval - now) : wake_time;
+}
+#endif
+
+/*******************************************************************************
+ * This function returns the number of system counter ticks until the first of
+ * the timers of the calling CPU that is enabled and not masked fires, or
+ * PSCI_WAKE_TIME_NONE if there is none. The timers cannot be reprogrammed while
+ * the CPU is at EL3, so this is the time by which it will be woken up from a
+ * suspend unless another interrupt comes first. It is not derived on AArch32,
+ * where the timer registers seen from Monitor mode depend on SCR.NS.
+ ******************************************************************************/
+unsigned long long psci_get_wake_time(void)
+{
+	unsigned long long wake_time = PSCI_WAKE_TIME_NONE;
+#ifndef AARCH32
+	uint64_t now = read_cntpct_el0();
+	uint64_t voff = 0;
+
+	wake_time = psci_timer_wake_time(read_cntp_ctl_el0(),
+					 read_cntp_cval_el0(), now, wake_time);
+	wake_time = psci_timer_wake_time(read_cntps_ctl_el1(),
+					 read_cntps_cval_el1(), now, wake_time);
+
+	if (EL_IMPLEMENTED(2)) {
+		voff = read_cntvoff_el2();
+		wake_time = psci_timer_wake_time(read_cnthp_ctl_el2(),
+						 read_cnthp_cval_el2(), now,
+						 wake_time);
+	}
+
+	wake_time = psci_timer_wake_time(read_cntv_ctl_el0(),
+					 read_cntv_cval_el0(), now - voff,
+					 wake_time);
+#endif
+	return wake_time;
+}
+
 /*******************************************************************************
  * Initiate power down sequence, by calling power down operations registered for
  * this CPU.
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <assert.h>
+#include <context.h>
+#include <context_mgmt.h>
+#include <platform.h>
+#include "psci_private.h"
+
+/*******************************************************************************
+ * A frozen CPU is seen as OFF by the normal world but it never leaves BL31: it
+ * waits for events with its caches and coherency enabled, and without telling
+ * the platform or the Secure Payload Dispatcher, until a CPU_ON wakes it up.
+ * Its power domain and those above it stay in the run state meanwhile.
+ ******************************************************************************/
+
+/* Read the affinity info state of a CPU afresh at each call */
+static aff_info_state_t psci_read_aff_info_state(unsigned int cpu_idx)
+{
+	return *(volatile aff_info_state_t *)
+		&_cpu_data_by_index(cpu_idx)->psci_svc_cpu_data.aff_info_state;
+}
+
+/*
+ * Return 1 if a CPU other than 'my_idx' runs or is being turned on, and can
+ * therefore issue the CPU_ON which wakes up a frozen CPU.
+ */
+static unsigned int psci_is_other_cpu_running(unsigned int my_idx)
+{
+	unsigned int cpu_idx;
+
+	for (cpu_idx = 0; cpu_idx < PLATFORM_CORE_COUNT; cpu_idx++) {
+		if ((cpu_idx != my_idx) &&
+		    (psci_get_aff_info_state_by_idx(cpu_idx) != AFF_STATE_OFF))
+			return 1;
+	}
+
+	return 0;
+}
+
+/*******************************************************************************
+ * Handler of CPU_FREEZE. It returns PSCI_E_DENIED if the CPU is the last one
+ * running or is the one where a uniprocessor Trusted OS resides. Otherwise it
+ * returns the context ID of the CPU_ON which woke up the CPU, after the
+ * non-secure context has been initialised to enter its entry point.
+ ******************************************************************************/
+u_register_t psci_cpu_freeze(void)
+{
+	unsigned int idx = plat_my_core_pos();
+	u_register_t resident_cpu_mpidr;
+	int rc;
+
+	if (!psci_is_other_cpu_running(idx))
+		return PSCI_E_DENIED;
+
+	rc = psci_spd_migrate_info(&resident_cpu_mpidr);
+	if (((rc == PSCI_TOS_UP_MIG_CAP) || (rc == PSCI_TOS_NOT_UP_MIG_CAP)) &&
+	    (resident_cpu_mpidr == read_mpidr_el1()))
+		return PSCI_E_DENIED;
+
+	psci_spin_lock_cpu(idx);
+	psci_set_cpu_frozen_by_idx(idx, 1);
+	psci_set_aff_info_state(AFF_STATE_OFF);
+	psci_spin_unlock_cpu(idx);
+
+	/* psci_cpu_thaw() sets the state to ON_PENDING and sends an event */
+	while (psci_read_aff_info_state(idx) != AFF_STATE_ON_PENDING)
+		wfe();
+
+	/* Wait for psci_cpu_on_start() to release the lock of the CPU */
+	psci_spin_lock_cpu(idx);
+	psci_spin_unlock_cpu(idx);
+
+	assert(psci_get_cpu_frozen_by_idx(idx) == 0);
+	psci_set_aff_info_state(AFF_STATE_ON);
+
+	/* Enter the entry point of the CPU_ON with its EL1 state reset */
+	cm_prepare_el3_exit(NON_SECURE);
+
+	return read_ctx_reg(get_gpregs_ctx(cm_get_context(NON_SECURE)),
+			    CTX_GPREG_X0);
+}
+
+/*******************************************************************************
+ * Wake up the frozen CPU 'target_idx' to enter the non-secure entry point 'ep'.
+ * This is called by psci_cpu_on_start() with the lock of the target CPU held,
+ * in place of powering it on.
+ ******************************************************************************/
+void psci_cpu_thaw(unsigned int target_idx, entry_point_info_t *ep)
+{
+	assert(psci_get_cpu_frozen_by_idx(target_idx) != 0);
+	assert(psci_get_aff_info_state_by_idx(target_idx) == AFF_STATE_OFF);
+
+	cm_init_context_by_index(target_idx, ep);
+
+	psci_set_cpu_frozen_by_idx(target_idx, 0);
+	psci_set_aff_info_state_by_idx(target_idx, AFF_STATE_ON_PENDING);
+
+	/* Make the new state visible before the event wakes up the CPU */
+	dsbish();
+	sev();
+}
@@ -4,7 +4,8 @@
 # SPDX-License-Identifier: BSD-3-Clause
 #
 
-PSCI_LIB_SOURCES	:=	lib/el3_runtime/cpu_data_array.c	\
+PSCI_LIB_SOURCES	:=	lib/el3_runtime/cpu_context_array.c	\
+				lib/el3_runtime/cpu_data_array.c	\
 				lib/el3_runtime/${ARCH}/cpu_data.S	\
 				lib/el3_runtime/${ARCH}/context_mgmt.c	\
 				lib/cpus/${ARCH}/cpu_helpers.S		\
@@ -29,6 +30,18 @@ else
 PSCI_LIB_SOURCES		+=	lib/locks/bakery/bakery_lock_normal.c
 endif
 
+ifeq (${PSCI_TICKET_LOCKS}, 1)
+PSCI_LIB_SOURCES		+=	lib/locks/exclusive/${ARCH}/ticket_lock.S
+endif
+
+ifeq (${ENABLE_PSCI_CPU_FREEZE}, 1)
+PSCI_LIB_SOURCES		+=	lib/psci/psci_freeze.c
+endif
+
 ifeq (${ENABLE_PSCI_STAT}, 1)
 PSCI_LIB_SOURCES		+=	lib/psci/psci_stat.c
 endif
+
+ifeq (${PSCI_PD_SNAPSHOT}, 1)
+PSCI_LIB_SOURCES		+=	lib/psci/psci_snapshot.c
+endif
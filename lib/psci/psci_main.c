@@ -6,6 +6,7 @@
 
 #include <arch.h>
 #include <arch_helpers.h>
+#include <arm_arch_svc.h>
 #include <assert.h>
 #include <debug.h>
 #include <platform.h>
@@ -43,20 +44,131 @@ int psci_cpu_on(u_register_t target_cpu,
 	return psci_cpu_on_start(target_cpu, &ep);
 }
 
+#if PSCI_CPU_ON_MULTI
+/*******************************************************************************
+ * Turn on several cpus with a single call, all of them starting at the same
+ * entrypoint with the same context id. The cpus are the ones whose MPIDR is
+ * 'target_group' with Aff0 set to the position of each bit set in 'aff0_mask'.
+ * All the targets are validated before any of them is turned on. The bits of
+ * the cpus that have been turned on are returned in 'cpus_on' along with the
+ * first error encountered, if any. The remaining cpus are still turned on
+ * after an error.
+ ******************************************************************************/
+int psci_cpu_on_multi(u_register_t target_group,
+		      u_register_t aff0_mask,
+		      uintptr_t entrypoint,
+		      u_register_t context_id,
+		      u_register_t *cpus_on)
+{
+	int rc, ret = PSCI_E_SUCCESS;
+	unsigned int aff0;
+	u_register_t target_cpu;
+	entry_point_info_t ep;
+
+	assert(cpus_on != NULL);
+	*cpus_on = 0;
+
+	if ((aff0_mask == 0) || (target_group & MPIDR_CPU_MASK))
+		return PSCI_E_INVALID_PARAMS;
+
+	/* Determine if all the cpus exist */
+	for (aff0 = 0; aff0 < (sizeof(aff0_mask) * 8); aff0++) {
+		if (!(aff0_mask & ((u_register_t)1 << aff0)))
+			continue;
+
+		if (psci_validate_mpidr(target_group | aff0) != PSCI_E_SUCCESS)
+			return PSCI_E_INVALID_PARAMS;
+	}
+
+	/* Validate the entry point and get the entry_point_info once */
+	rc = psci_validate_entry_point(&ep, entrypoint, context_id);
+	if (rc != PSCI_E_SUCCESS)
+		return rc;
+
+	for (aff0 = 0; aff0 < (sizeof(aff0_mask) * 8); aff0++) {
+		if (!(aff0_mask & ((u_register_t)1 << aff0)))
+			continue;
+
+		/*
+		 * psci_cpu_on_start() only reads the entry point information,
+		 * so it can be shared by all the targets.
+		 */
+		target_cpu = target_group | aff0;
+		rc = psci_cpu_on_start(target_cpu, &ep);
+		if (rc == PSCI_E_SUCCESS)
+			*cpus_on |= (u_register_t)1 << aff0;
+		else if (ret == PSCI_E_SUCCESS)
+			ret = rc;
+	}
+
+	return ret;
+}
+#endif
+
 unsigned int psci_version(void)
 {
 	return PSCI_MAJOR_VER | PSCI_MINOR_VER;
 }
 
-int psci_cpu_suspend(unsigned int power_state,
-		     uintptr_t entrypoint,
-		     u_register_t context_id)
+/*******************************************************************************
+ * Enter the standby state requested for the CPU power domain in 'state_info',
+ * all the power domains above it being left running. This takes no lock and
+ * only updates the state and statistics of the calling CPU, so that shallow
+ * idle states are entered and exited with a minimal latency.
+ ******************************************************************************/
+static int psci_cpu_standby(const psci_power_state_t *state_info)
+{
+	plat_local_state_t cpu_pd_state;
+
+	if  (!psci_plat_pm_ops->cpu_standby)
+		return PSCI_E_INVALID_PARAMS;
+
+	/*
+	 * Set the state of the CPU power domain to the platform specific
+	 * retention state and enter the standby state.
+	 */
+	cpu_pd_state = state_info->pwr_domain_state[PSCI_CPU_PWR_LVL];
+	psci_set_cpu_local_state(cpu_pd_state);
+
+#if ENABLE_PSCI_STAT
+	plat_psci_stat_accounting_start(state_info);
+#endif
+
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
+	    RT_INSTR_ENTER_HW_LOW_PWR,
+	    PMF_NO_CACHE_MAINT);
+#endif
+
+	psci_plat_pm_ops->cpu_standby(cpu_pd_state);
+
+	/* Upon exit from standby, set the state back to RUN. */
+	psci_set_cpu_local_state(PSCI_LOCAL_STATE_RUN);
+
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
+	    RT_INSTR_EXIT_HW_LOW_PWR,
+	    PMF_NO_CACHE_MAINT);
+#endif
+
+#if ENABLE_PSCI_STAT
+	plat_psci_stat_accounting_stop(state_info);
+
+	/* Update PSCI stats */
+	psci_stats_update_pwr_up(PSCI_CPU_PWR_LVL, state_info);
+#endif
+
+	return PSCI_E_SUCCESS;
+}
+
+int __hot psci_cpu_suspend(unsigned int power_state,
+			   uintptr_t entrypoint,
+			   u_register_t context_id)
 {
 	int rc;
 	unsigned int target_pwrlvl, is_power_down_state;
 	entry_point_info_t ep;
 	psci_power_state_t state_info = { {PSCI_LOCAL_STATE_RUN} };
-	plat_local_state_t cpu_pd_state;
 
 	/* Validate the power_state parameter */
 	rc = psci_validate_power_state(power_state, &state_info);
@@ -81,47 +193,27 @@ int psci_cpu_suspend(unsigned int power_state,
 	}
 
 	/* Fast path for CPU standby.*/
-	if (is_cpu_standby_req(is_power_down_state, target_pwrlvl)) {
-		if  (!psci_plat_pm_ops->cpu_standby)
-			return PSCI_E_INVALID_PARAMS;
-
-		/*
-		 * Set the state of the CPU power domain to the platform
-		 * specific retention state and enter the standby state.
-		 */
-		cpu_pd_state = state_info.pwr_domain_state[PSCI_CPU_PWR_LVL];
-		psci_set_cpu_local_state(cpu_pd_state);
-
-#if ENABLE_PSCI_STAT
-		plat_psci_stat_accounting_start(&state_info);
-#endif
-
-#if ENABLE_RUNTIME_INSTRUMENTATION
-		PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
-		    RT_INSTR_ENTER_HW_LOW_PWR,
-		    PMF_NO_CACHE_MAINT);
-#endif
+	if (is_cpu_standby_req(is_power_down_state, target_pwrlvl))
+		return psci_cpu_standby(&state_info);
 
-		psci_plat_pm_ops->cpu_standby(cpu_pd_state);
-
-		/* Upon exit from standby, set the state back to RUN. */
-		psci_set_cpu_local_state(PSCI_LOCAL_STATE_RUN);
-
-#if ENABLE_RUNTIME_INSTRUMENTATION
-		PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
-		    RT_INSTR_EXIT_HW_LOW_PWR,
-		    PMF_NO_CACHE_MAINT);
-#endif
-
-#if ENABLE_PSCI_STAT
-		plat_psci_stat_accounting_stop(&state_info);
-
-		/* Update PSCI stats */
-		psci_stats_update_pwr_up(PSCI_CPU_PWR_LVL, &state_info);
+#if PSCI_SUSPEND_GOVERNOR
+	/*
+	 * Demote the requested states of the power domains above the CPU that
+	 * this CPU is not expected to stay long enough in. The OS coordinates
+	 * these states itself in OS-initiated mode. A CPU standby request
+	 * leaves these power domains running and has been served above.
+	 */
+#if PSCI_OS_INIT_MODE
+	if (psci_suspend_mode == PLAT_COORD)
 #endif
+	{
+		psci_stat_govern_suspend(&state_info);
 
-		return PSCI_E_SUCCESS;
+		target_pwrlvl = psci_find_target_suspend_lvl(&state_info);
+		if (is_cpu_standby_req(is_power_down_state, target_pwrlvl))
+			return psci_cpu_standby(&state_info);
 	}
+#endif
 
 	/*
 	 * If a power down state has been requested, we need to verify entry
@@ -139,12 +231,10 @@ int psci_cpu_suspend(unsigned int power_state,
 	 * might return if the power down was abandoned for any reason, e.g.
 	 * arrival of an interrupt
 	 */
-	psci_cpu_suspend_start(&ep,
-			    target_pwrlvl,
-			    &state_info,
-			    is_power_down_state);
-
-	return PSCI_E_SUCCESS;
+	return psci_cpu_suspend_start(&ep,
+				      target_pwrlvl,
+				      &state_info,
+				      is_power_down_state);
 }
 
 
@@ -177,12 +267,10 @@ int psci_system_suspend(uintptr_t entrypoint, u_register_t context_id)
 	 * might return if the power down was abandoned for any reason, e.g.
 	 * arrival of an interrupt
 	 */
-	psci_cpu_suspend_start(&ep,
-			    PLAT_MAX_PWR_LVL,
-			    &state_info,
-			    PSTATE_TYPE_POWERDOWN);
-
-	return PSCI_E_SUCCESS;
+	return psci_cpu_suspend_start(&ep,
+				      PLAT_MAX_PWR_LVL,
+				      &state_info,
+				      PSTATE_TYPE_POWERDOWN);
 }
 
 int psci_cpu_off(void)
@@ -301,10 +389,50 @@ int psci_node_hw_state(u_register_t target_cpu,
 	return rc;
 }
 
+/*******************************************************************************
+ * Enable or disable the protection of the memory on reset as requested by
+ * 'enable', and return its previous state.
+ ******************************************************************************/
+int psci_mem_protect(unsigned int enable)
+{
+	int val;
+
+	assert(psci_plat_pm_ops->read_mem_protect);
+	assert(psci_plat_pm_ops->write_mem_protect);
+
+	if (psci_plat_pm_ops->read_mem_protect(&val) < 0)
+		return PSCI_E_NOT_SUPPORTED;
+	if (psci_plat_pm_ops->write_mem_protect(enable != 0) < 0)
+		return PSCI_E_NOT_SUPPORTED;
+
+	return val != 0;
+}
+
+/*******************************************************************************
+ * Check that the range of 'length' bytes at 'base' is protected by
+ * MEM_PROTECT.
+ ******************************************************************************/
+int psci_mem_chk_range(uintptr_t base, u_register_t length)
+{
+	assert(psci_plat_pm_ops->mem_protect_chk);
+
+	if ((length == 0) || check_uptr_overflow(base, length - 1))
+		return PSCI_E_DENIED;
+
+	if (psci_plat_pm_ops->mem_protect_chk(base, length) < 0)
+		return PSCI_E_DENIED;
+
+	return PSCI_E_SUCCESS;
+}
+
 int psci_features(unsigned int psci_fid)
 {
 	unsigned int local_caps = psci_caps;
 
+	/* SMCCC_VERSION is discovered through PSCI_FEATURES */
+	if (psci_fid == SMCCC_VERSION)
+		return PSCI_E_SUCCESS;
+
 	/* Check if it is a 64 bit function */
 	if (((psci_fid >> FUNCID_CC_SHIFT) & FUNCID_CC_MASK) == SMC_64)
 		local_caps &= PSCI_CAP_64BIT_MASK;
@@ -322,28 +450,62 @@ int psci_features(unsigned int psci_fid)
 	/* Format the feature flags */
 	if (psci_fid == PSCI_CPU_SUSPEND_AARCH32 ||
 			psci_fid == PSCI_CPU_SUSPEND_AARCH64) {
+#if PSCI_OS_INIT_MODE
+		return (FF_PSTATE << FF_PSTATE_SHIFT) |
+			(FF_SUPPORTS_OS_INIT_MODE << FF_MODE_SUPPORT_SHIFT);
+#else
 		/*
 		 * The trusted firmware does not support OS Initiated Mode.
 		 */
 		return (FF_PSTATE << FF_PSTATE_SHIFT) |
 			((!FF_SUPPORTS_OS_INIT_MODE) << FF_MODE_SUPPORT_SHIFT);
+#endif
 	}
 
 	/* Return 0 for all other fid's */
 	return PSCI_E_SUCCESS;
 }
 
+#if PSCI_OS_INIT_MODE
+int psci_set_suspend_mode(unsigned int mode)
+{
+	if (psci_suspend_mode == mode)
+		return PSCI_E_SUCCESS;
+
+	if (mode == PLAT_COORD) {
+		/* Check if the current CPU is the last ON CPU in the system */
+		if (!psci_is_last_on_cpu())
+			return PSCI_E_DENIED;
+	} else if (mode == OS_INIT) {
+		/*
+		 * Check if all the CPUs in the system are running or if the
+		 * current CPU is the last ON CPU in the system.
+		 */
+		if (!psci_are_all_cpus_on() && !psci_is_last_on_cpu())
+			return PSCI_E_DENIED;
+	} else {
+		return PSCI_E_INVALID_PARAMS;
+	}
+
+	psci_suspend_mode = mode;
+	psci_flush_dcache_range((uintptr_t)&psci_suspend_mode,
+				sizeof(psci_suspend_mode));
+
+	return PSCI_E_SUCCESS;
+}
+#endif
+
 /*******************************************************************************
  * PSCI top level handler for servicing SMCs.
  ******************************************************************************/
-u_register_t psci_smc_handler(uint32_t smc_fid,
-			  u_register_t x1,
-			  u_register_t x2,
-			  u_register_t x3,
-			  u_register_t x4,
-			  void *cookie,
-			  void *handle,
-			  u_register_t flags)
+u_register_t __hot psci_smc_handler(uint32_t smc_fid,
+				    u_register_t x1,
+				    u_register_t x2,
+				    u_register_t x3,
+				    u_register_t x4,
+				    void *cookie,
+				    void *handle,
+				    u_register_t flags)
 {
 	if (is_caller_secure(flags))
 		return SMC_UNK;
@@ -401,6 +563,11 @@ u_register_t psci_smc_handler(uint32_t smc_fid,
 		case PSCI_FEATURES:
 			return psci_features(x1);
 
+#if PSCI_OS_INIT_MODE
+		case PSCI_SET_SUSPEND_MODE:
+			return psci_set_suspend_mode(x1);
+#endif
+
 #if ENABLE_PSCI_STAT
 		case PSCI_STAT_RESIDENCY_AARCH32:
 			return psci_stat_residency(x1, x2);
@@ -409,6 +576,20 @@ u_register_t psci_smc_handler(uint32_t smc_fid,
 			return psci_stat_count(x1, x2);
 #endif
 
+		case PSCI_SYSTEM_RESET2_AARCH32:
+			return psci_system_reset2(x1, x2);
+
+		case PSCI_MEM_PROTECT:
+			return psci_mem_protect(x1);
+
+		case PSCI_MEM_CHK_RANGE_AARCH32:
+			return psci_mem_chk_range(x1, x2);
+
+#if ENABLE_PSCI_CPU_FREEZE
+		case PSCI_CPU_FREEZE:
+			return psci_cpu_freeze();
+#endif
+
 		default:
 			break;
 		}
@@ -445,6 +626,12 @@ u_register_t psci_smc_handler(uint32_t smc_fid,
 			return psci_stat_count(x1, x2);
 #endif
 
+		case PSCI_SYSTEM_RESET2_AARCH64:
+			return psci_system_reset2(x1, x2);
+
+		case PSCI_MEM_CHK_RANGE_AARCH64:
+			return psci_mem_chk_range(x1, x2);
+
 		default:
 			break;
 		}
@@ -7,11 +7,13 @@
 #include <arch.h>
 #include <arch_helpers.h>
 #include <assert.h>
+#include <console.h>
 #include <debug.h>
 #include <platform.h>
 #include <pmf.h>
 #include <runtime_instr.h>
 #include <string.h>
+#include <trace_event.h>
 #include "psci_private.h"
 
 /******************************************************************************
@@ -49,6 +51,11 @@ int psci_do_cpu_off(unsigned int end_pwrlvl)
 	 */
 	assert(psci_plat_pm_ops->pwr_domain_off);
 
+	TRACE_EVENT(TRACE_EV_PSCI_CPU_OFF, end_pwrlvl, 0, 0, 0);
+
+	/* Output what this CPU printed while its caches are still on */
+	console_buffer_flush();
+
 	/*
 	 * This function acquires the lock corresponding to each power
 	 * level so that by the time all locks are taken, the system topology
@@ -12,6 +12,7 @@
 #include <context_mgmt.h>
 #include <platform.h>
 #include <stddef.h>
+#include <trace_event.h>
 #include "psci_private.h"
 
 /*******************************************************************************
@@ -51,6 +52,8 @@ int psci_cpu_on_start(u_register_t target_cpu,
 	assert((int) target_idx >= 0);
 	assert(ep != NULL);
 
+	TRACE_EVENT(TRACE_EV_PSCI_CPU_ON, target_cpu, ep->pc, 0, 0);
+
 	/*
 	 * This function must only be called on platforms where the
 	 * CPU_ON platform hooks have been implemented.
@@ -69,6 +72,17 @@ int psci_cpu_on_start(u_register_t target_cpu,
 	if (rc != PSCI_E_SUCCESS)
 		goto exit;
 
+#if ENABLE_PSCI_CPU_FREEZE
+	/*
+	 * A frozen cpu has neither been powered down nor gone through the
+	 * Secure Payload Dispatcher, so it only needs to be woken up.
+	 */
+	if (psci_get_cpu_frozen_by_idx(target_idx)) {
+		psci_cpu_thaw(target_idx, ep);
+		goto exit;
+	}
+#endif
+
 	/*
 	 * Call the cpu on handler registered by the Secure Payload Dispatcher
 	 * to let it do any bookeeping. If the handler encounters an error, it's
@@ -83,7 +97,8 @@ int psci_cpu_on_start(u_register_t target_cpu,
 	 * turned OFF.
 	 */
 	psci_set_aff_info_state_by_idx(target_idx, AFF_STATE_ON_PENDING);
-	flush_cpu_data_by_index(target_idx, psci_svc_cpu_data.aff_info_state);
+	psci_flush_cpu_data_by_index(target_idx,
+				     psci_svc_cpu_data.aff_info_state);
 
 	/*
 	 * The cache line invalidation by the target CPU after setting the
@@ -95,7 +110,8 @@ int psci_cpu_on_start(u_register_t target_cpu,
 	if (target_aff_state != AFF_STATE_ON_PENDING) {
 		assert(target_aff_state == AFF_STATE_OFF);
 		psci_set_aff_info_state_by_idx(target_idx, AFF_STATE_ON_PENDING);
-		flush_cpu_data_by_index(target_idx, psci_svc_cpu_data.aff_info_state);
+		psci_flush_cpu_data_by_index(target_idx,
+					     psci_svc_cpu_data.aff_info_state);
 
 		assert(psci_get_aff_info_state_by_idx(target_idx) == AFF_STATE_ON_PENDING);
 	}
@@ -117,7 +133,8 @@ int psci_cpu_on_start(u_register_t target_cpu,
 	else {
 		/* Restore the state on error. */
 		psci_set_aff_info_state_by_idx(target_idx, AFF_STATE_OFF);
-		flush_cpu_data_by_index(target_idx, psci_svc_cpu_data.aff_info_state);
+		psci_flush_cpu_data_by_index(target_idx,
+					     psci_svc_cpu_data.aff_info_state);
 	}
 
 exit:
@@ -13,6 +13,12 @@
 #include <cpu_data.h>
 #include <psci.h>
 #include <spinlock.h>
+#include <ticket_lock.h>
+
+/* Number of local states per power level accounted by PSCI_STAT */
+#ifndef PLAT_MAX_PWR_LVL_STATES
+#define PLAT_MAX_PWR_LVL_STATES 2
+#endif
 
 #if HW_ASSISTED_COHERENCY
 
@@ -23,14 +29,25 @@
  */
 #define psci_flush_dcache_range(addr, size)
 #define psci_flush_cpu_data(member)
+#define psci_flush_cpu_data_by_index(idx, member)
 #define psci_inv_cpu_data(member)
 
 #define psci_dsbish()
 
 /*
  * On systems where participant CPUs are cache-coherent, we can use spinlocks
- * instead of bakery locks.
+ * instead of bakery locks. Ticket locks can be selected instead, to grant the
+ * locks in order and bound the wait under contention.
  */
+#if PSCI_TICKET_LOCKS
+#define DEFINE_PSCI_LOCK(_name)		ticket_lock_t _name
+#define DECLARE_PSCI_LOCK(_name)	extern DEFINE_PSCI_LOCK(_name)
+
+#define psci_lock_get(non_cpu_pd_node)				\
+	ticket_lock(&psci_locks[(non_cpu_pd_node)->lock_index])
+#define psci_lock_release(non_cpu_pd_node)			\
+	ticket_unlock(&psci_locks[(non_cpu_pd_node)->lock_index])
+#else
 #define DEFINE_PSCI_LOCK(_name)		spinlock_t _name
 #define DECLARE_PSCI_LOCK(_name)	extern DEFINE_PSCI_LOCK(_name)
 
@@ -38,6 +55,7 @@
 	spin_lock(&psci_locks[(non_cpu_pd_node)->lock_index])
 #define psci_lock_release(non_cpu_pd_node)			\
 	spin_unlock(&psci_locks[(non_cpu_pd_node)->lock_index])
+#endif
 
 #else
 
@@ -47,6 +65,8 @@
  */
 #define psci_flush_dcache_range(addr, size)	flush_dcache_range(addr, size)
 #define psci_flush_cpu_data(member)		flush_cpu_data(member)
+#define psci_flush_cpu_data_by_index(idx, member)	\
+	flush_cpu_data_by_index(idx, member)
 #define psci_inv_cpu_data(member)		inv_cpu_data(member)
 
 #define psci_dsbish()				dsbish()
@@ -68,6 +88,18 @@
 #define psci_lock_init(non_cpu_pd_node, idx)			\
 	((non_cpu_pd_node)[(idx)].lock_index = (idx))
 
+/*
+ * Account for the power domain locks taken and released by a CPU, for the
+ * snapshot of the power domain tree.
+ */
+#if PSCI_PD_SNAPSHOT
+void psci_lock_stat_acquired(unsigned int cpu_idx, unsigned int lvl);
+void psci_lock_stat_released(unsigned int cpu_idx, unsigned int lvl);
+#else
+#define psci_lock_stat_acquired(cpu_idx, lvl)
+#define psci_lock_stat_released(cpu_idx, lvl)
+#endif
+
 /*
  * The PSCI capability which are provided by the generic code but does not
  * depend on the platform or spd capabilities.
@@ -89,7 +121,9 @@
 			define_psci_cap(PSCI_NODE_HW_STATE_AARCH64) |	\
 			define_psci_cap(PSCI_SYSTEM_SUSPEND_AARCH64) |	\
 			define_psci_cap(PSCI_STAT_RESIDENCY_AARCH64) |	\
-			define_psci_cap(PSCI_STAT_COUNT_AARCH64))
+			define_psci_cap(PSCI_STAT_COUNT_AARCH64) |	\
+			define_psci_cap(PSCI_SYSTEM_RESET2_AARCH64) |	\
+			define_psci_cap(PSCI_MEM_CHK_RANGE_AARCH64))
 
 /*
  * Helper macros to get/set the fields of PSCI per-cpu data.
@@ -113,6 +147,20 @@
 		get_cpu_data(psci_svc_cpu_data.local_state)
 #define psci_get_cpu_local_state_by_idx(idx) \
 		get_cpu_data_by_index(idx, psci_svc_cpu_data.local_state)
+#if ENABLE_PSCI_CPU_FREEZE
+#define psci_get_cpu_frozen_by_idx(idx) \
+		get_cpu_data_by_index(idx, psci_svc_cpu_data.frozen)
+#define psci_set_cpu_frozen_by_idx(idx, frozen_state) \
+		set_cpu_data_by_index(idx, psci_svc_cpu_data.frozen,\
+					frozen_state)
+#endif
+
+/*
+ * Helper macro to get the index of the ancestor power domain node of a CPU at
+ * a power level above the CPU level
+ */
+#define psci_get_parent_node(cpu_idx, lvl)	\
+	psci_cpu_parent_nodes[(cpu_idx)][(lvl) - 1]
 
 /*
  * Helper macros for the CPU level spinlocks
@@ -157,6 +205,14 @@ typedef struct non_cpu_pwr_domain_node {
 
 	/* For indexing the psci_lock array*/
 	unsigned char lock_index;
+
+#if PSCI_RUN_CPU_COUNTS
+	/*
+	 * Number of CPUs requesting the RUN state for this node, updated with
+	 * the lock of the node held.
+	 */
+	unsigned int run_cpus;
+#endif
 } non_cpu_pd_node_t;
 
 typedef struct cpu_pwr_domain_node {
@@ -175,7 +231,11 @@ typedef struct cpu_pwr_domain_node {
 	 * when multiple CPUs try to turn ON the same target CPU.
 	 */
 	spinlock_t cpu_lock;
+#if PSCI_CACHE_ALIGNED_STATE
+} __aligned(CACHE_WRITEBACK_GRANULE) cpu_pd_node_t;
+#else
 } cpu_pd_node_t;
+#endif
 
 /*******************************************************************************
  * Data prototypes
@@ -183,7 +243,12 @@ typedef struct cpu_pwr_domain_node {
 extern const plat_psci_ops_t *psci_plat_pm_ops;
 extern non_cpu_pd_node_t psci_non_cpu_pd_nodes[PSCI_NUM_NON_CPU_PWR_DOMAINS];
 extern cpu_pd_node_t psci_cpu_pd_nodes[PLATFORM_CORE_COUNT];
+extern unsigned int psci_cpu_parent_nodes[PLATFORM_CORE_COUNT]
+					 [PLAT_MAX_PWR_LVL];
 extern unsigned int psci_caps;
+#if PSCI_OS_INIT_MODE
+extern suspend_mode_t psci_suspend_mode;
+#endif
 
 /* One lock is required per non-CPU power domain node */
 DECLARE_PSCI_LOCK(psci_locks[PSCI_NUM_NON_CPU_PWR_DOMAINS]);
@@ -211,10 +276,18 @@ void psci_get_parent_pwr_domain_nodes(unsigned int cpu_idx,
 				      unsigned int node_index[]);
 void psci_do_state_coordination(unsigned int end_pwrlvl,
 				psci_power_state_t *state_info);
+#if PSCI_OS_INIT_MODE
+int psci_validate_state_coordination(unsigned int req_pwrlvl,
+				     psci_power_state_t *state_info);
+#endif
 void psci_acquire_pwr_domain_locks(unsigned int end_pwrlvl,
 				   unsigned int cpu_idx);
 void psci_release_pwr_domain_locks(unsigned int end_pwrlvl,
 				   unsigned int cpu_idx);
+#if PSCI_SUSPEND_LOCK_ELISION
+unsigned int psci_acquire_suspend_locks(unsigned int end_pwrlvl,
+					unsigned int cpu_idx);
+#endif
 int psci_validate_suspend_req(const psci_power_state_t *state_info,
 			      unsigned int is_power_down_state_req);
 unsigned int psci_find_max_off_lvl(const psci_power_state_t *state_info);
@@ -222,6 +295,10 @@ unsigned int psci_find_target_suspend_lvl(const psci_power_state_t *state_info);
 void psci_set_pwr_domains_to_run(unsigned int end_pwrlvl);
 void psci_print_power_domain_map(void);
 unsigned int psci_is_last_on_cpu(void);
+unsigned long long psci_get_wake_time(void);
+#if PSCI_OS_INIT_MODE
+unsigned int psci_are_all_cpus_on(void);
+#endif
 int psci_spd_migrate_info(u_register_t *mpidr);
 void psci_do_pwrdown_sequence(unsigned int power_level);
 
@@ -239,11 +316,15 @@ int psci_cpu_on_start(u_register_t target_cpu,
 void psci_cpu_on_finish(unsigned int cpu_idx,
 			psci_power_state_t *state_info);
 
+/* Private exported functions from psci_freeze.c */
+u_register_t psci_cpu_freeze(void);
+void psci_cpu_thaw(unsigned int target_idx, entry_point_info_t *ep);
+
 /* Private exported functions from psci_off.c */
 int psci_do_cpu_off(unsigned int end_pwrlvl);
 
 /* Private exported functions from psci_suspend.c */
-void psci_cpu_suspend_start(entry_point_info_t *ep,
+int psci_cpu_suspend_start(entry_point_info_t *ep,
 			unsigned int end_pwrlvl,
 			psci_power_state_t *state_info,
 			unsigned int is_power_down_state_req);
@@ -258,6 +339,7 @@ void psci_do_pwrup_cache_maintenance(void);
 /* Private exported functions from psci_system_off.c */
 void __dead2 psci_system_off(void);
 void __dead2 psci_system_reset(void);
+int psci_system_reset2(uint32_t reset_type, u_register_t cookie);
 
 /* Private exported functions from psci_stat.c */
 void psci_stats_update_pwr_down(unsigned int end_pwrlvl,
@@ -268,5 +350,11 @@ u_register_t psci_stat_residency(u_register_t target_cpu,
 			unsigned int power_state);
 u_register_t psci_stat_count(u_register_t target_cpu,
 			unsigned int power_state);
+void psci_stat_read(unsigned int pwrlvl, unsigned int node_idx,
+			unsigned int stat_idx, u_register_t *residency,
+			u_register_t *count);
+#if PSCI_SUSPEND_GOVERNOR
+void psci_stat_govern_suspend(psci_power_state_t *state_info);
+#endif
 
 #endif /* __PSCI_PRIVATE_H__ */
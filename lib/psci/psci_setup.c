@@ -15,14 +15,6 @@
 #include <stddef.h>
 #include "psci_private.h"
 
-/*******************************************************************************
- * Per cpu non-secure contexts used to program the architectural state prior
- * return to the normal world.
- * TODO: Use the memory allocator to set aside memory for the contexts instead
- * of relying on platform defined constants.
- ******************************************************************************/
-static cpu_context_t psci_ns_context[PLATFORM_CORE_COUNT];
-
 /******************************************************************************
  * Define the psci capability variable.
  *****************************************************************************/
@@ -32,9 +24,9 @@ unsigned int psci_caps;
  * Function which initializes the 'psci_non_cpu_pd_nodes' or the
  * 'psci_cpu_pd_nodes' corresponding to the power level.
  ******************************************************************************/
-static void psci_init_pwr_domain_node(unsigned int node_idx,
-					unsigned int parent_idx,
-					unsigned int level)
+static void __init psci_init_pwr_domain_node(unsigned int node_idx,
+					     unsigned int parent_idx,
+					     unsigned int level)
 {
 	if (level > PSCI_CPU_PWR_LVL) {
 		psci_non_cpu_pd_nodes[node_idx].level = level;
@@ -44,6 +36,7 @@ static void psci_init_pwr_domain_node(unsigned int node_idx,
 							 PLAT_MAX_OFF_STATE;
 	} else {
 		psci_cpu_data_t *svc_cpu_data;
+		void *ns_ctx;
 
 		psci_cpu_pd_nodes[node_idx].parent_node = parent_idx;
 
@@ -59,16 +52,51 @@ static void psci_init_pwr_domain_node(unsigned int node_idx,
 		/* Invalidate the suspend level for the cpu */
 		svc_cpu_data->target_pwrlvl = PSCI_INVALID_PWR_LVL;
 
-		/* Set the power state to OFF state */
+		/*
+		 * Set the power state to OFF state. The PSCI data of all the
+		 * cpus is flushed at once by psci_flush_cpu_data_array().
+		 */
 		svc_cpu_data->local_state = PLAT_MAX_OFF_STATE;
 
-		psci_flush_dcache_range((uintptr_t)svc_cpu_data,
-						 sizeof(*svc_cpu_data));
+		/* Use the non-secure context set aside for the cpu */
+		ns_ctx = cm_get_context_slot_by_index(node_idx, NON_SECURE);
+		cm_set_context_by_index(node_idx, ns_ctx, NON_SECURE);
+	}
+}
+
+/*******************************************************************************
+ * Flush the per-cpu data of all the cpus, initialised by the primary cpu during
+ * the cold boot, as the secondary cpus access their PSCI data during warm boot
+ * possibly before data cache is enabled. The per-cpu data being contiguous,
+ * this is done in a single operation rather than cpu by cpu.
+ ******************************************************************************/
+static void __init psci_flush_cpu_data_array(void)
+{
+	psci_flush_dcache_range((uintptr_t)_cpu_data_by_index(0),
+				PLATFORM_CORE_COUNT * sizeof(cpu_data_t));
+}
+
+/*******************************************************************************
+ * This function fills psci_cpu_parent_nodes[] by walking up the power domain
+ * tree from each CPU once. The array is flushed as it is used by secondary CPUs
+ * during warm boot, possibly before data cache is enabled.
+ ******************************************************************************/
+static void __init psci_init_cpu_parent_nodes(void)
+{
+	unsigned int cpu_idx, lvl, parent_idx;
 
-		cm_set_context_by_index(node_idx,
-					(void *) &psci_ns_context[node_idx],
-					NON_SECURE);
+	for (cpu_idx = 0; cpu_idx < PLATFORM_CORE_COUNT; cpu_idx++) {
+		parent_idx = psci_cpu_pd_nodes[cpu_idx].parent_node;
+		for (lvl = PSCI_CPU_PWR_LVL + 1; lvl <= PLAT_MAX_PWR_LVL;
+		     lvl++) {
+			psci_get_parent_node(cpu_idx, lvl) = parent_idx;
+			parent_idx =
+				psci_non_cpu_pd_nodes[parent_idx].parent_node;
+		}
 	}
+
+	psci_flush_dcache_range((uintptr_t)psci_cpu_parent_nodes,
+				sizeof(psci_cpu_parent_nodes));
 }
 
 /*******************************************************************************
@@ -80,7 +108,7 @@ static void psci_init_pwr_domain_node(unsigned int node_idx,
  * mapping of the CPUs to indices via plat_core_pos_by_mpidr() and
  * plat_my_core_pos() APIs.
  *******************************************************************************/
-static void psci_update_pwrlvl_limits(void)
+static void __init psci_update_pwrlvl_limits(void)
 {
 	int j;
 	unsigned int nodes_idx[PLAT_MAX_PWR_LVL] = {0};
@@ -107,7 +135,7 @@ static void psci_update_pwrlvl_limits(void)
  * informs the number of root power domains. The parent nodes of the root nodes
  * will point to an invalid entry(-1).
  ******************************************************************************/
-static void populate_power_domain_tree(const unsigned char *topology)
+static void __init populate_power_domain_tree(const unsigned char *topology)
 {
 	unsigned int i, j = 0, num_nodes_at_lvl = 1, num_nodes_at_next_lvl;
 	unsigned int node_index = 0, parent_node_index = 0, num_children;
@@ -183,7 +211,7 @@ static void populate_power_domain_tree(const unsigned char *topology)
  * |   CPU 0   |   CPU 1   |   CPU 2   |   CPU 3  |
  * ------------------------------------------------
  ******************************************************************************/
-int psci_setup(const psci_lib_args_t *lib_args)
+int __init psci_setup(const psci_lib_args_t *lib_args)
 {
 	const unsigned char *topology_tree;
 
@@ -198,6 +226,9 @@ int psci_setup(const psci_lib_args_t *lib_args)
 	/* Populate the power domain arrays using the platform topology map */
 	populate_power_domain_tree(topology_tree);
 
+	/* Cache the ancestors of each CPU for the power domain tree walks */
+	psci_init_cpu_parent_nodes();
+
 	/* Update the CPU limits for each node in psci_non_cpu_pd_nodes */
 	psci_update_pwrlvl_limits();
 
@@ -207,6 +238,8 @@ int psci_setup(const psci_lib_args_t *lib_args)
 
 	psci_init_req_local_pwr_states();
 
+	psci_flush_cpu_data_array();
+
 	/*
 	 * Set the requested and target state of this CPU and all the higher
 	 * power domain levels for this CPU to run.
@@ -236,13 +269,29 @@ int psci_setup(const psci_lib_args_t *lib_args)
 		psci_caps |=  define_psci_cap(PSCI_CPU_SUSPEND_AARCH64);
 		if (psci_plat_pm_ops->get_sys_suspend_power_state)
 			psci_caps |=  define_psci_cap(PSCI_SYSTEM_SUSPEND_AARCH64);
+#if PSCI_OS_INIT_MODE
+		psci_caps |=  define_psci_cap(PSCI_SET_SUSPEND_MODE);
+#endif
 	}
 	if (psci_plat_pm_ops->system_off)
 		psci_caps |=  define_psci_cap(PSCI_SYSTEM_OFF);
 	if (psci_plat_pm_ops->system_reset)
 		psci_caps |=  define_psci_cap(PSCI_SYSTEM_RESET);
+	if (psci_plat_pm_ops->system_reset2)
+		psci_caps |=  define_psci_cap(PSCI_SYSTEM_RESET2_AARCH64);
 	if (psci_plat_pm_ops->get_node_hw_state)
 		psci_caps |= define_psci_cap(PSCI_NODE_HW_STATE_AARCH64);
+	if (psci_plat_pm_ops->read_mem_protect &&
+			psci_plat_pm_ops->write_mem_protect)
+		psci_caps |= define_psci_cap(PSCI_MEM_PROTECT);
+	if (psci_plat_pm_ops->mem_protect_chk)
+		psci_caps |= define_psci_cap(PSCI_MEM_CHK_RANGE_AARCH64);
+
+#if ENABLE_PSCI_CPU_FREEZE
+	if (psci_plat_pm_ops->pwr_domain_on &&
+			psci_plat_pm_ops->pwr_domain_on_finish)
+		psci_caps |=  define_psci_cap(PSCI_CPU_FREEZE);
+#endif
 
 #if ENABLE_PSCI_STAT
 	psci_caps |=  define_psci_cap(PSCI_STAT_RESIDENCY_AARCH64);
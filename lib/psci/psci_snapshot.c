@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <platform_def.h>
+#include <utils_def.h>
+#include "psci_private.h"
+
+/*
+ * Accounting of the lock of a power domain by a CPU: the time it was last
+ * taken, the number of times it was taken, the time it was held overall and
+ * the longest time it was held, in ticks of the system counter.
+ */
+typedef struct psci_lock_stat {
+	unsigned long long start;
+	unsigned long long count;
+	unsigned long long hold;
+	unsigned long long hold_max;
+} psci_lock_stat_t;
+
+/*
+ * Each CPU only updates its own entry, which holds the accounting of the locks
+ * of its ancestors indexed by power level - 1, so that this requires neither
+ * locks nor cache line transfers between CPUs. The accounting of a power
+ * domain is the sum of the ones of all the CPUs below it.
+ */
+typedef struct psci_cpu_lock_stats {
+	psci_lock_stat_t lvl[PLAT_MAX_PWR_LVL];
+} __aligned(CACHE_WRITEBACK_GRANULE) psci_cpu_lock_stats_t;
+
+static psci_cpu_lock_stats_t psci_lock_stats[PLATFORM_CORE_COUNT]
+							__runtime_bss;
+
+#if ENABLE_PSCI_STAT
+#define PSCI_SNAPSHOT_STAT_STATES	PLAT_MAX_PWR_LVL_STATES
+#else
+#define PSCI_SNAPSHOT_STAT_STATES	0
+#endif
+
+#define PSCI_SNAPSHOT_NODE_SIZE	(sizeof(psci_pd_snapshot_node_t) +	\
+	(PSCI_SNAPSHOT_STAT_STATES * sizeof(psci_pd_snapshot_stat_t)))
+
+#define PSCI_SNAPSHOT_SIZE	(sizeof(psci_pd_snapshot_hdr_t) +	\
+	(PSCI_NUM_PWR_DOMAINS * PSCI_SNAPSHOT_NODE_SIZE))
+
+/*
+ * When not all the CPUs are cache coherent, the power down and power up
+ * sequences take and release the locks with the data cache disabled. The
+ * entry is then invalidated from the caches after being written to memory,
+ * and it is cleaned to memory after being written with the data cache
+ * enabled, so that it is always read afresh with the data cache disabled.
+ */
+static void psci_lock_stat_sync(psci_lock_stat_t *stat)
+{
+#if !HW_ASSISTED_COHERENCY
+	if ((read_sctlr_el3() & SCTLR_C_BIT) != 0U) {
+		flush_dcache_range((uintptr_t)stat, sizeof(*stat));
+	} else {
+		dsbish();
+		inv_dcache_range((uintptr_t)stat, sizeof(*stat));
+	}
+#endif
+}
+
+/*******************************************************************************
+ * Called with the lock of the ancestor of the CPU 'cpu_idx' at 'lvl' just
+ * taken, and just before it is released.
+ ******************************************************************************/
+void psci_lock_stat_acquired(unsigned int cpu_idx, unsigned int lvl)
+{
+	psci_lock_stat_t *stat = &psci_lock_stats[cpu_idx].lvl[lvl - 1];
+
+	stat->start = read_cntpct_el0();
+	stat->count++;
+	psci_lock_stat_sync(stat);
+}
+
+void psci_lock_stat_released(unsigned int cpu_idx, unsigned int lvl)
+{
+	psci_lock_stat_t *stat = &psci_lock_stats[cpu_idx].lvl[lvl - 1];
+	unsigned long long hold = read_cntpct_el0() - stat->start;
+
+	stat->hold += hold;
+	if (hold > stat->hold_max)
+		stat->hold_max = hold;
+	psci_lock_stat_sync(stat);
+}
+
+/* Fill in the PSCI_STAT values of the power domain 'idx' at 'lvl' */
+static void psci_snapshot_stats(psci_pd_snapshot_node_t *node,
+				unsigned int lvl, unsigned int idx)
+{
+#if ENABLE_PSCI_STAT
+	u_register_t residency, count;
+	unsigned int i;
+
+	for (i = 0; i < PSCI_SNAPSHOT_STAT_STATES; i++) {
+		psci_stat_read(lvl, idx, i, &residency, &count);
+		node->stat[i].residency = residency;
+		node->stat[i].count = count;
+	}
+#endif
+}
+
+static void psci_snapshot_non_cpu_node(psci_pd_snapshot_node_t *node,
+				       unsigned int idx)
+{
+	const non_cpu_pd_node_t *pd = &psci_non_cpu_pd_nodes[idx];
+	const psci_lock_stat_t *stat;
+	unsigned int cpu_idx;
+
+	node->mpidr = PSCI_INVALID_MPIDR;
+	/* The parent of the root is PSCI_PD_SNAPSHOT_NO_PARENT */
+	node->parent = pd->parent_node;
+	node->level = pd->level;
+	node->local_state = pd->local_state;
+	node->reserved = 0;
+	node->lock_count = 0;
+	node->lock_hold = 0;
+	node->lock_hold_max = 0;
+
+	for (cpu_idx = pd->cpu_start_idx;
+	     cpu_idx < pd->cpu_start_idx + pd->ncpus; cpu_idx++) {
+		stat = &psci_lock_stats[cpu_idx].lvl[pd->level - 1];
+		node->lock_count += stat->count;
+		node->lock_hold += stat->hold;
+		if (stat->hold_max > node->lock_hold_max)
+			node->lock_hold_max = stat->hold_max;
+	}
+
+	psci_snapshot_stats(node, pd->level, idx);
+}
+
+static void psci_snapshot_cpu_node(psci_pd_snapshot_node_t *node,
+				   unsigned int idx)
+{
+	const cpu_pd_node_t *pd = &psci_cpu_pd_nodes[idx];
+
+	node->mpidr = pd->mpidr;
+	node->parent = pd->parent_node;
+	node->level = PSCI_CPU_PWR_LVL;
+	node->local_state = psci_get_cpu_local_state_by_idx(idx);
+	node->reserved = 0;
+	node->lock_count = 0;
+	node->lock_hold = 0;
+	node->lock_hold_max = 0;
+
+	psci_snapshot_stats(node, PSCI_CPU_PWR_LVL, idx);
+}
+
+/*******************************************************************************
+ * Copy a snapshot of the power domain tree, laid out as described in psci.h, to
+ * the buffer 'buf' of 'size' bytes, aligned to 8 bytes. The values are read
+ * without taking the power domain locks, so a power domain changing state
+ * meanwhile may be seen partially updated. This returns the size of the
+ * snapshot, which is only copied if it does not exceed 'size'.
+ ******************************************************************************/
+size_t psci_pd_snapshot(void *buf, size_t size)
+{
+	psci_pd_snapshot_hdr_t *hdr = buf;
+	uintptr_t node = (uintptr_t)(hdr + 1);
+	unsigned int idx;
+
+	if (size < PSCI_SNAPSHOT_SIZE)
+		return PSCI_SNAPSHOT_SIZE;
+
+	hdr->version = PSCI_PD_SNAPSHOT_VERSION;
+	hdr->size = PSCI_SNAPSHOT_SIZE;
+	hdr->num_nodes = PSCI_NUM_PWR_DOMAINS;
+	hdr->node_size = PSCI_SNAPSHOT_NODE_SIZE;
+	hdr->num_stat_states = PSCI_SNAPSHOT_STAT_STATES;
+	hdr->cnt_freq = read_cntfrq_el0();
+	hdr->timestamp = read_cntpct_el0();
+
+	for (idx = 0; idx < PSCI_NUM_NON_CPU_PWR_DOMAINS; idx++) {
+		psci_snapshot_non_cpu_node((void *)node, idx);
+		node += PSCI_SNAPSHOT_NODE_SIZE;
+	}
+
+	for (idx = 0; idx < PLATFORM_CORE_COUNT; idx++) {
+		psci_snapshot_cpu_node((void *)node, idx);
+		node += PSCI_SNAPSHOT_NODE_SIZE;
+	}
+
+	return PSCI_SNAPSHOT_SIZE;
+}
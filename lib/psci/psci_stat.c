@@ -8,12 +8,9 @@
 #include <debug.h>
 #include <platform.h>
 #include <platform_def.h>
+#include <utils_def.h>
 #include "psci_private.h"
 
-#ifndef PLAT_MAX_PWR_LVL_STATES
-#define PLAT_MAX_PWR_LVL_STATES 2
-#endif
-
 /* Following structure is used for PSCI STAT */
 typedef struct psci_stat {
 	u_register_t residency;
@@ -27,13 +24,35 @@ typedef struct psci_stat {
 static int last_cpu_in_non_cpu_pd[PSCI_NUM_NON_CPU_PWR_DOMAINS] = {-1};
 
 /*
- * Following are used to store PSCI STAT values for
- * CPU and non CPU power domains.
+ * Following are used to store PSCI STAT values. Each CPU only updates its own
+ * entry, which holds the stats of its CPU power domain and, for each level
+ * above, the stats of its ancestor that it accounted when waking it up. The
+ * stats of a non CPU power domain are the sum of the ones accounted by all
+ * the CPUs below it. The entries are cache line aligned so that updating them
+ * requires neither locks nor cache line transfers between CPUs.
+ */
+typedef struct psci_cpu_stats {
+	psci_stat_t cpu[PLAT_MAX_PWR_LVL_STATES];
+	psci_stat_t non_cpu[PLAT_MAX_PWR_LVL][PLAT_MAX_PWR_LVL_STATES];
+#if PSCI_SUSPEND_GOVERNOR
+	/*
+	 * Running average of the time this CPU stayed in a low power state,
+	 * used to predict the length of its next suspend.
+	 */
+	u_register_t avg_residency;
+	unsigned int has_history;
+#endif
+} __aligned(CACHE_WRITEBACK_GRANULE) psci_cpu_stats_t;
+
+static psci_cpu_stats_t psci_cpu_stats[PLATFORM_CORE_COUNT] __runtime_bss;
+
+#if PSCI_SUSPEND_GOVERNOR
+/*
+ * Weight of the latest residency in the running average, as a power of two
+ * fraction: avg += (sample - avg) / 2^PSCI_GOVERNOR_AVG_SHIFT.
  */
-static psci_stat_t psci_cpu_stat[PLATFORM_CORE_COUNT]
-				[PLAT_MAX_PWR_LVL_STATES];
-static psci_stat_t psci_non_cpu_stat[PSCI_NUM_NON_CPU_PWR_DOMAINS]
-				[PLAT_MAX_PWR_LVL_STATES];
+#define PSCI_GOVERNOR_AVG_SHIFT		3
+#endif
 
 /*
  * This functions returns the index into the `psci_stat_t` array given the
@@ -77,8 +96,6 @@ void psci_stats_update_pwr_down(unsigned int end_pwrlvl,
 	assert(end_pwrlvl <= PLAT_MAX_PWR_LVL);
 	assert(state_info);
 
-	parent_idx = psci_cpu_pd_nodes[cpu_idx].parent_node;
-
 	for (lvl = PSCI_CPU_PWR_LVL + 1; lvl <= end_pwrlvl; lvl++) {
 
 		/* Break early if the target power state is RUN */
@@ -89,17 +106,19 @@ void psci_stats_update_pwr_down(unsigned int end_pwrlvl,
 		 * The power domain is entering a low power state, so this is
 		 * the last CPU for this power domain
 		 */
+		parent_idx = psci_get_parent_node(cpu_idx, lvl);
 		last_cpu_in_non_cpu_pd[parent_idx] = cpu_idx;
-
-		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
 	}
 
 }
 
 /*******************************************************************************
  * This function updates the PSCI STATS(residency time and count) for CPU
- * and NON-CPU power domains.
- * It is called with caches enabled and locks acquired(for NON-CPU domain)
+ * and NON-CPU power domains in the entry of the calling CPU.
+ * It is called with caches enabled, after the power domain locks have been
+ * released: the `state_info` snapshot taken under the locks marks the non CPU
+ * power domains this CPU is the first to wake up from, and none of them can
+ * power down again while this CPU is running.
  ******************************************************************************/
 void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 			const psci_power_state_t *state_info)
@@ -108,6 +127,10 @@ void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 	int lvl, stat_idx;
 	plat_local_state_t local_state;
 	u_register_t residency;
+#if PSCI_SUSPEND_GOVERNOR
+	u_register_t avg;
+#endif
+	psci_cpu_stats_t *stats;
 
 	assert(end_pwrlvl <= PLAT_MAX_PWR_LVL);
 	assert(state_info);
@@ -121,14 +144,28 @@ void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 	    state_info, cpu_idx);
 
 	/* Update CPU stats. */
-	psci_cpu_stat[cpu_idx][stat_idx].residency += residency;
-	psci_cpu_stat[cpu_idx][stat_idx].count++;
+	stats = &psci_cpu_stats[cpu_idx];
+	stats->cpu[stat_idx].residency += residency;
+	stats->cpu[stat_idx].count++;
+
+#if PSCI_SUSPEND_GOVERNOR
+	if (stats->has_history) {
+		avg = stats->avg_residency;
+		if (residency >= avg)
+			avg += (residency - avg) >> PSCI_GOVERNOR_AVG_SHIFT;
+		else
+			avg -= (avg - residency) >> PSCI_GOVERNOR_AVG_SHIFT;
+		stats->avg_residency = avg;
+	} else {
+		stats->avg_residency = residency;
+		stats->has_history = 1;
+	}
+#endif
 
 	/*
 	 * Check what power domains above CPU were off
 	 * prior to this CPU powering on.
 	 */
-	parent_idx = psci_cpu_pd_nodes[cpu_idx].parent_node;
 	for (lvl = PSCI_CPU_PWR_LVL + 1; lvl <= end_pwrlvl; lvl++) {
 		local_state = state_info->pwr_domain_state[lvl];
 		if (is_local_state_run(local_state)) {
@@ -136,6 +173,7 @@ void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 			break;
 		}
 
+		parent_idx = psci_get_parent_node(cpu_idx, lvl);
 		assert(last_cpu_in_non_cpu_pd[parent_idx] != -1);
 
 		/* Call into platform interface to calculate residency. */
@@ -149,12 +187,144 @@ void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 		stat_idx = get_stat_idx(local_state, lvl);
 
 		/* Update non cpu stats */
-		psci_non_cpu_stat[parent_idx][stat_idx].residency += residency;
-		psci_non_cpu_stat[parent_idx][stat_idx].count++;
+		stats->non_cpu[lvl - 1][stat_idx].residency += residency;
+		stats->non_cpu[lvl - 1][stat_idx].count++;
+	}
+
+}
+
+#if PSCI_SUSPEND_GOVERNOR
+/*******************************************************************************
+ * This function looks up the entry of the platform idle state table which
+ * describes `local_state` at `pwrlvl`. It returns NULL if there is none.
+ ******************************************************************************/
+static const plat_psci_idle_state_t *psci_find_idle_state(
+		const plat_psci_idle_state_t *states, unsigned int num_states,
+		unsigned int pwrlvl, plat_local_state_t local_state)
+{
+	unsigned int i;
 
-		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
+	for (i = 0; i < num_states; i++) {
+		if ((states[i].pwrlvl == pwrlvl) &&
+		    (states[i].local_state == local_state))
+			return &states[i];
 	}
 
+	return NULL;
+}
+
+/*******************************************************************************
+ * This function is called by CPU_SUSPEND with the validated states requested
+ * by the calling CPU. It predicts the length of the suspend from the running
+ * average of the past residencies of the CPU and, for every power level above
+ * the CPU, replaces the requested state with the deepest state described in
+ * the platform idle state table that is not deeper than the requested one and
+ * whose target residency and entry and exit latencies fit in the prediction.
+ * The power domain is kept running if there is no such state.
+ *
+ * Requested states that the table does not describe are left unchanged. The
+ * type of the state of a level is never made deeper than the one of the level
+ * below, so the result still satisfies psci_validate_suspend_req().
+ ******************************************************************************/
+void psci_stat_govern_suspend(psci_power_state_t *state_info)
+{
+	const plat_psci_idle_state_t *states, *idle_state;
+	const psci_cpu_stats_t *stats;
+	unsigned int lvl, i, num_states = 0;
+	plat_local_state_t req_state, best_state;
+	u_register_t predicted;
+
+	assert(state_info);
+
+	if (psci_plat_pm_ops->get_idle_states == NULL)
+		return;
+
+	stats = &psci_cpu_stats[plat_my_core_pos()];
+	if (!stats->has_history)
+		return;
+
+	states = psci_plat_pm_ops->get_idle_states(&num_states);
+	if ((states == NULL) || (num_states == 0))
+		return;
+
+	predicted = stats->avg_residency;
+
+	for (lvl = PSCI_CPU_PWR_LVL + 1; lvl <= PLAT_MAX_PWR_LVL; lvl++) {
+		req_state = state_info->pwr_domain_state[lvl];
+
+		/* Honour the request if it is not described by the platform */
+		if ((!is_local_state_run(req_state)) &&
+		    (psci_find_idle_state(states, num_states, lvl,
+					  req_state) != NULL)) {
+			best_state = PSCI_LOCAL_STATE_RUN;
+
+			for (i = 0; i < num_states; i++) {
+				idle_state = &states[i];
+				if ((idle_state->pwrlvl != lvl) ||
+				    (idle_state->local_state > req_state) ||
+				    (idle_state->local_state <= best_state))
+					continue;
+
+				if (predicted >= (idle_state->target_residency +
+						  idle_state->entry_latency +
+						  idle_state->exit_latency))
+					best_state = idle_state->local_state;
+			}
+
+			state_info->pwr_domain_state[lvl] = best_state;
+		}
+
+		/*
+		 * Keep the domain running if the level below has been demoted
+		 * to a shallower type of state than the one kept here.
+		 */
+		req_state = state_info->pwr_domain_state[lvl - 1];
+		best_state = state_info->pwr_domain_state[lvl];
+		if ((is_local_state_off(best_state) &&
+		     !is_local_state_off(req_state)) ||
+		    (is_local_state_retn(best_state) &&
+		     is_local_state_run(req_state)))
+			state_info->pwr_domain_state[lvl] =
+				PSCI_LOCAL_STATE_RUN;
+	}
+}
+#endif
+
+/*******************************************************************************
+ * This function returns the count and residency time of the local state of
+ * index `stat_idx` of the power domain `node_idx` at `pwrlvl`, which is a CPU
+ * index at the CPU level and an index into psci_non_cpu_pd_nodes[] above.
+ ******************************************************************************/
+void psci_stat_read(unsigned int pwrlvl, unsigned int node_idx,
+			unsigned int stat_idx, u_register_t *residency,
+			u_register_t *count)
+{
+	unsigned int cpu_idx, end_idx;
+	const psci_stat_t *stat;
+
+	assert(stat_idx < PLAT_MAX_PWR_LVL_STATES);
+
+	if (pwrlvl == PSCI_CPU_PWR_LVL) {
+		/* Get the cpu power domain stats */
+		stat = &psci_cpu_stats[node_idx].cpu[stat_idx];
+		*residency = stat->residency;
+		*count = stat->count;
+		return;
+	}
+
+	/*
+	 * Sum the non cpu power domain stats accounted by all the CPUs below
+	 * it.
+	 */
+	*residency = 0;
+	*count = 0;
+	cpu_idx = psci_non_cpu_pd_nodes[node_idx].cpu_start_idx;
+	end_idx = cpu_idx + psci_non_cpu_pd_nodes[node_idx].ncpus;
+	for (; cpu_idx < end_idx; cpu_idx++) {
+		stat = &psci_cpu_stats[cpu_idx].non_cpu[pwrlvl - 1][stat_idx];
+		*residency += stat->residency;
+		*count += stat->count;
+	}
 }
 
 /*******************************************************************************
@@ -165,7 +335,7 @@ void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 int psci_get_stat(u_register_t target_cpu, unsigned int power_state,
 			 psci_stat_t *psci_stat)
 {
-	int rc, pwrlvl, lvl, parent_idx, stat_idx, target_idx;
+	int rc, pwrlvl, node_idx, stat_idx, target_idx;
 	psci_power_state_t state_info = { {PSCI_LOCAL_STATE_RUN} };
 	plat_local_state_t local_state;
 
@@ -195,18 +365,14 @@ int psci_get_stat(u_register_t target_cpu, unsigned int power_state,
 	local_state = state_info.pwr_domain_state[pwrlvl];
 	stat_idx = get_stat_idx(local_state, pwrlvl);
 
-	if (pwrlvl > PSCI_CPU_PWR_LVL) {
-		/* Get the power domain index */
-		parent_idx = psci_cpu_pd_nodes[target_idx].parent_node;
-		for (lvl = PSCI_CPU_PWR_LVL + 1; lvl < pwrlvl; lvl++)
-			parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
+	/* Get the power domain index */
+	if (pwrlvl > PSCI_CPU_PWR_LVL)
+		node_idx = psci_get_parent_node(target_idx, pwrlvl);
+	else
+		node_idx = target_idx;
 
-		/* Get the non cpu power domain stats */
-		*psci_stat = psci_non_cpu_stat[parent_idx][stat_idx];
-	} else {
-		/* Get the cpu power domain stats */
-		*psci_stat = psci_cpu_stat[target_idx][stat_idx];
-	}
+	psci_stat_read(pwrlvl, node_idx, stat_idx, &psci_stat->residency,
+		       &psci_stat->count);
 
 	return PSCI_E_SUCCESS;
 }
@@ -9,6 +9,7 @@
 #include <arch.h>
 #include <arch_helpers.h>
 #include <context.h>
+#include <console.h>
 #include <context_mgmt.h>
 #include <cpu_data.h>
 #include <debug.h>
@@ -16,6 +17,7 @@
 #include <pmf.h>
 #include <runtime_instr.h>
 #include <stddef.h>
+#include <trace_event.h>
 #include "psci_private.h"
 
 /*******************************************************************************
@@ -57,9 +59,9 @@ static void psci_suspend_to_standby_finisher(unsigned int cpu_idx,
  * This function does generic and platform specific suspend to power down
  * operations.
  ******************************************************************************/
-static void psci_suspend_to_pwrdown_start(unsigned int end_pwrlvl,
-					  entry_point_info_t *ep,
-					  psci_power_state_t *state_info)
+static void __hot psci_suspend_to_pwrdown_start(unsigned int end_pwrlvl,
+						entry_point_info_t *ep,
+						psci_power_state_t *state_info)
 {
 	unsigned int max_off_lvl = psci_find_max_off_lvl(state_info);
 
@@ -127,14 +129,26 @@ static void psci_suspend_to_pwrdown_start(unsigned int end_pwrlvl,
  * All the required parameter checks are performed at the beginning and after
  * the state transition has been done, no further error is expected and it is
  * not possible to undo any of the actions taken beyond that point.
+ *
+ * In OS-initiated mode, the states requested by the OS are validated instead
+ * of coordinated, and an error is returned if the calling CPU is not allowed
+ * to enter them. The locks of all the power levels are taken in this mode as
+ * the CPU updates its requested state at each of them.
  ******************************************************************************/
-void psci_cpu_suspend_start(entry_point_info_t *ep,
-			    unsigned int end_pwrlvl,
-			    psci_power_state_t *state_info,
-			    unsigned int is_power_down_state)
+int __hot psci_cpu_suspend_start(entry_point_info_t *ep,
+				 unsigned int end_pwrlvl,
+				 psci_power_state_t *state_info,
+				 unsigned int is_power_down_state)
 {
-	int skip_wfi = 0;
+	int skip_wfi = 0, rc = PSCI_E_SUCCESS;
 	unsigned int idx = plat_my_core_pos();
+	unsigned int lock_pwrlvl = end_pwrlvl;
+#if PSCI_OS_INIT_MODE
+	unsigned int req_pwrlvl = end_pwrlvl;
+
+	if (psci_suspend_mode == OS_INIT)
+		end_pwrlvl = PLAT_MAX_PWR_LVL;
+#endif
 
 	/*
 	 * This function must only be called on platforms where the
@@ -143,13 +157,23 @@ void psci_cpu_suspend_start(entry_point_info_t *ep,
 	assert(psci_plat_pm_ops->pwr_domain_suspend &&
 			psci_plat_pm_ops->pwr_domain_suspend_finish);
 
+	TRACE_EVENT(TRACE_EV_PSCI_SUSPEND, end_pwrlvl, is_power_down_state,
+		    0, 0);
+
+	/* Output what this CPU printed while its caches are still on */
+	console_buffer_flush();
+
 	/*
 	 * This function acquires the lock corresponding to each power
 	 * level so that by the time all locks are taken, the system topology
 	 * is snapshot and state management can be done safely.
 	 */
+#if PSCI_SUSPEND_LOCK_ELISION
+	lock_pwrlvl = psci_acquire_suspend_locks(end_pwrlvl, idx);
+#else
 	psci_acquire_pwr_domain_locks(end_pwrlvl,
 				      idx);
+#endif
 
 	/*
 	 * We check if there are any pending interrupts after the delay
@@ -161,6 +185,18 @@ void psci_cpu_suspend_start(entry_point_info_t *ep,
 		goto exit;
 	}
 
+	/* Let the platform choose its idle states given the next timer */
+	state_info->wake_time = psci_get_wake_time();
+
+#if PSCI_OS_INIT_MODE
+	if (psci_suspend_mode == OS_INIT) {
+		rc = psci_validate_state_coordination(req_pwrlvl, state_info);
+		if (rc != PSCI_E_SUCCESS) {
+			skip_wfi = 1;
+			goto exit;
+		}
+	} else
+#endif
 	/*
 	 * This function is passed the requested state info and
 	 * it returns the negotiated state info for each power level upto
@@ -193,10 +229,10 @@ exit:
 	 * Release the locks corresponding to each power level in the
 	 * reverse order to which they were acquired.
 	 */
-	psci_release_pwr_domain_locks(end_pwrlvl,
+	psci_release_pwr_domain_locks(lock_pwrlvl,
 				  idx);
 	if (skip_wfi)
-		return;
+		return rc;
 
 	if (is_power_down_state) {
 #if ENABLE_RUNTIME_INSTRUMENTATION
@@ -252,6 +288,8 @@ exit:
 	 * context retaining suspend finisher.
 	 */
 	psci_suspend_to_standby_finisher(idx, end_pwrlvl);
+
+	return PSCI_E_SUCCESS;
 }
 
 /*******************************************************************************
@@ -259,8 +297,8 @@ exit:
  * are called by the common finisher routine in psci_common.c. The `state_info`
  * is the psci_power_state from which this CPU has woken up from.
  ******************************************************************************/
-void psci_cpu_suspend_finish(unsigned int cpu_idx,
-			     psci_power_state_t *state_info)
+void __hot psci_cpu_suspend_finish(unsigned int cpu_idx,
+				   psci_power_state_t *state_info)
 {
 	unsigned int counter_freq;
 	unsigned int max_off_lvl;
@@ -287,6 +325,9 @@ void psci_cpu_suspend_finish(unsigned int cpu_idx,
 	counter_freq = plat_get_syscnt_freq2();
 	write_cntfrq_el0(counter_freq);
 
+	TRACE_EVENT(TRACE_EV_PSCI_WAKEUP, psci_find_max_off_lvl(state_info),
+		    0, 0, 0);
+
 	/*
 	 * Call the cpu suspend finish handler registered by the Secure Payload
 	 * Dispatcher to let it do any bookeeping. If the handler encounters an
@@ -23,6 +23,7 @@ void psci_system_off(void)
 		psci_spd_pm->svc_system_off();
 	}
 
+	console_buffer_flush_all();
 	console_flush();
 
 	/* Call the platform specific hook */
@@ -42,6 +43,7 @@ void psci_system_reset(void)
 		psci_spd_pm->svc_system_reset();
 	}
 
+	console_buffer_flush_all();
 	console_flush();
 
 	/* Call the platform specific hook */
@@ -49,3 +51,31 @@ void psci_system_reset(void)
 
 	/* This function does not return. We should never get here */
 }
+
+int psci_system_reset2(uint32_t reset_type, u_register_t cookie)
+{
+	int is_vendor;
+
+	if (!psci_plat_pm_ops->system_reset2)
+		return PSCI_E_NOT_SUPPORTED;
+
+	is_vendor = (reset_type >> PSCI_RESET2_TYPE_VENDOR_SHIFT) & 1;
+	if (!is_vendor && (reset_type != PSCI_RESET2_SYSTEM_WARM_RESET))
+		return PSCI_E_INVALID_PARAMS;
+
+	psci_print_power_domain_map();
+
+	/* Notify the Secure Payload Dispatcher */
+	if (psci_spd_pm && psci_spd_pm->svc_system_reset) {
+		psci_spd_pm->svc_system_reset();
+	}
+
+	console_buffer_flush_all();
+	console_flush();
+
+	/*
+	 * Call the platform specific hook, which only returns if it does not
+	 * support the vendor specific reset type.
+	 */
+	return psci_plat_pm_ops->system_reset2(is_vendor, reset_type, cookie);
+}
@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <cassert.h>
+#include <debug.h>
+#include <ehf.h>
+#include <mmio.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <ras.h>
+#include <spinlock.h>
+
+#pragma weak plat_ras_notify
+
+/* Number of errors kept for each CPU */
+#ifndef PLAT_RAS_ERRORS
+#define PLAT_RAS_ERRORS		32
+#endif
+
+CASSERT((PLAT_RAS_ERRORS & (PLAT_RAS_ERRORS - 1)) == 0,
+	assert_ras_errors_power_of_2);
+
+/*
+ * Ring of the last errors recorded by a CPU. Only the owning CPU records
+ * errors, so no locking is needed. 'head' counts the errors ever recorded, so
+ * the sequence number of an error is its value when it was recorded.
+ * 'pending' is set when the CPU notifies the normal world of its errors, and
+ * cleared when a reader has read them all.
+ */
+typedef struct ras_ring {
+	volatile unsigned long long	head;
+	volatile unsigned int		pending;
+	ras_error_t			errors[PLAT_RAS_ERRORS];
+} __aligned(CACHE_WRITEBACK_GRANULE) ras_ring_t;
+
+static ras_ring_t ras_rings[PLATFORM_CORE_COUNT];
+
+/* Lock of the scan of the groups of records flagged with RAS_RECORDS_SHARED */
+static spinlock_t ras_shared_lock;
+
+/* The default notification does nothing, the normal world polls the rings */
+void plat_ras_notify(void)
+{
+}
+
+/*
+ * Read the record 'idx' of the group 'records' and, if it holds an error,
+ * clear it. Return 1 if an error was read, 0 otherwise.
+ */
+static int ras_read_record(const ras_err_records_t *records, unsigned int idx,
+			   ras_error_t *error)
+{
+	uintptr_t base;
+	uint64_t status;
+
+	error->addr = 0;
+	error->misc0 = 0;
+
+	if (records->base == 0) {
+		write_errselr_el1(records->first + idx);
+		isb();
+
+		status = read_erxstatus_el1();
+		if (!(status & ERR_STATUS_V_BIT))
+			return 0;
+
+		if (status & ERR_STATUS_AV_BIT)
+			error->addr = read_erxaddr_el1();
+		if (status & ERR_STATUS_MV_BIT)
+			error->misc0 = read_erxmisc0_el1();
+		write_erxstatus_el1(status & ERR_STATUS_CLEAR_MASK);
+	} else {
+		base = records->base + (ERR_RECORD_SIZE * idx);
+
+		status = mmio_read_64(base + ERR_STATUS_OFF);
+		if (!(status & ERR_STATUS_V_BIT))
+			return 0;
+
+		if (status & ERR_STATUS_AV_BIT)
+			error->addr = mmio_read_64(base + ERR_ADDR_OFF);
+		if (status & ERR_STATUS_MV_BIT)
+			error->misc0 = mmio_read_64(base + ERR_MISC0_OFF);
+		mmio_write_64(base + ERR_STATUS_OFF,
+			      status & ERR_STATUS_CLEAR_MASK);
+	}
+
+	error->status = status;
+	return 1;
+}
+
+/*******************************************************************************
+ * Scan the error records declared by the platform and record their errors in
+ * the ring of the calling CPU. The normal world is notified once for all the
+ * errors recorded until it reads them. An uncorrected error is fatal. Return
+ * the number of errors found.
+ ******************************************************************************/
+static unsigned int ras_scan(void)
+{
+	ras_ring_t *ring = &ras_rings[plat_my_core_pos()];
+	const ras_err_records_t *records;
+	ras_error_t error;
+	unsigned int grp, idx, found = 0, fatal = 0;
+
+	for (grp = 0; grp < ras_num_err_records; grp++) {
+		records = &ras_err_records[grp];
+
+		if (records->flags & RAS_RECORDS_SHARED)
+			spin_lock(&ras_shared_lock);
+
+		for (idx = 0; idx < records->num; idx++) {
+			if (!ras_read_record(records, idx, &error))
+				continue;
+
+			error.timestamp = read_cntpct_el0();
+			error.record = (grp << 16) | idx;
+			error.reserved = 0;
+			ring->errors[ring->head % PLAT_RAS_ERRORS] = error;
+
+			/* Make the error visible before accounting for it */
+			dmbish();
+			ring->head++;
+			found++;
+
+			if (error.status & ERR_STATUS_UE_BIT) {
+				ERROR("RAS: Uncorrected error in record 0x%x,"
+				      " status 0x%llx\n", error.record,
+				      (unsigned long long)error.status);
+				fatal = 1;
+			}
+		}
+
+		if (records->flags & RAS_RECORDS_SHARED)
+			spin_unlock(&ras_shared_lock);
+	}
+
+	if (fatal)
+		panic();
+
+	if (found == 0)
+		return 0;
+
+	/*
+	 * Check whether a notification is pending after counting the errors,
+	 * while the reader clears it before checking for new errors. Either
+	 * side sees the update of the other, so no error is left unnotified.
+	 */
+	dmbish();
+	if (!ring->pending) {
+		ring->pending = 1;
+		plat_ras_notify();
+	}
+
+	return found;
+}
+
+/*
+ * Handler of the priority level of the fault handling and error recovery
+ * interrupts of the error records.
+ */
+static int ras_intr_handler(uint32_t intr_raw, uint32_t flags, void *handle,
+			    void *cookie)
+{
+	if (ras_scan() == 0)
+		VERBOSE("RAS: No error found for interrupt %u\n", intr_raw);
+
+	plat_ic_end_of_interrupt(intr_raw);
+	return 0;
+}
+
+/*******************************************************************************
+ * Handler of the SError interrupts taken from the lower ELs, called from the
+ * exception vectors with SError masked. The interrupted context resumes if the
+ * errors that caused the SError have been corrected or deferred.
+ ******************************************************************************/
+void ras_handle_serror(uint64_t esr, unsigned int ns)
+{
+	if (ras_scan() != 0)
+		return;
+
+	ERROR("RAS: Unhandled SError from the %s world, ESR_EL3 0x%llx\n",
+	      ns ? "non-secure" : "secure", (unsigned long long)esr);
+	panic();
+}
+
+/*
+ * Copy the error of a CPU with the sequence number '*seq' or, if it has been
+ * overwritten, its oldest error still in the ring. Return 0 and update '*seq'
+ * to the sequence number of the error copied, -1 if 'cpu_idx' is invalid or
+ * if no error with this sequence number has been recorded yet. In that case,
+ * the CPU notifies the normal world again of its next error.
+ */
+int ras_error_read(unsigned int cpu_idx, unsigned long long *seq,
+		   ras_error_t *error)
+{
+	ras_ring_t *ring;
+	unsigned long long head, start;
+
+	if (cpu_idx >= PLATFORM_CORE_COUNT)
+		return -1;
+
+	ring = &ras_rings[cpu_idx];
+	do {
+		head = ring->head;
+		if (*seq >= head) {
+			ring->pending = 0;
+			dmbish();
+
+			head = ring->head;
+			if (*seq >= head)
+				return -1;
+		}
+		dmbish();
+
+		start = *seq;
+		if (head - start > PLAT_RAS_ERRORS)
+			start = head - PLAT_RAS_ERRORS;
+		*error = ring->errors[start % PLAT_RAS_ERRORS];
+
+		/* Retry if the owning CPU overwrote the error meanwhile */
+		dmbish();
+	} while (ring->head - start > PLAT_RAS_ERRORS);
+
+	*seq = start;
+	return 0;
+}
+
+void ras_init(void)
+{
+	unsigned int grp, num_sysreg = 0;
+
+	for (grp = 0; grp < ras_num_err_records; grp++) {
+		if (ras_err_records[grp].base != 0)
+			continue;
+
+		if (num_sysreg == 0)
+			num_sysreg = read_erridr_el1() & ERRIDR_NUM_MASK;
+
+		if ((ras_err_records[grp].first + ras_err_records[grp].num) >
+		    num_sysreg) {
+			ERROR("RAS: Invalid group of records %u\n", grp);
+			panic();
+		}
+	}
+
+	if (ehf_register_priority_handler(PLAT_RAS_PRI,
+					  ras_intr_handler) != 0) {
+		ERROR("RAS: Failed to register the interrupt handler\n");
+		panic();
+	}
+}
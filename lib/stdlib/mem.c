@@ -6,6 +6,14 @@
 
 #include <stddef.h> /* size_t */
 
+/*
+ * memset, memcmp and memcpy are weak so that the optimised versions in
+ * lib/stdlib/${ARCH}/mem.S can replace them.
+ */
+#pragma weak memset
+#pragma weak memcmp
+#pragma weak memcpy
+
 /*
  * Fill @count bytes of memory pointed to by @dst with @val
  */
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch_helpers.h>
+#include <cassert.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <trace_event.h>
+
+CASSERT((PLAT_TRACE_EVENTS & (PLAT_TRACE_EVENTS - 1)) == 0,
+	assert_trace_events_power_of_2);
+
+/*
+ * Ring of the last events recorded by a CPU. Only the owning CPU records
+ * events, so no locking is needed. 'head' counts the events ever recorded,
+ * so the sequence number of an event is its value when it was recorded.
+ */
+typedef struct trace_ring {
+	volatile unsigned long long	head;
+	trace_event_t			events[PLAT_TRACE_EVENTS];
+} __aligned(CACHE_WRITEBACK_GRANULE) trace_ring_t;
+
+/* Also read by the crash dump, from assembly */
+trace_ring_t trace_rings[PLATFORM_CORE_COUNT];
+
+CASSERT(sizeof(trace_event_t) == TRACE_EVENT_SIZE,
+	assert_trace_event_size_mismatch);
+CASSERT(__builtin_offsetof(trace_ring_t, head) == TRACE_RING_HEAD_OFF,
+	assert_trace_ring_head_offset_mismatch);
+CASSERT(__builtin_offsetof(trace_ring_t, events) == TRACE_RING_EVENTS_OFF,
+	assert_trace_ring_events_offset_mismatch);
+CASSERT(sizeof(trace_ring_t) == TRACE_RING_SIZE,
+	assert_trace_ring_size_mismatch);
+
+/* Record an event on the calling CPU, overwriting its oldest one if needed */
+void trace_event_record(uint32_t id, uint64_t arg0, uint64_t arg1,
+			uint64_t arg2, uint64_t arg3)
+{
+	trace_ring_t *ring = &trace_rings[plat_my_core_pos()];
+	trace_event_t *event;
+
+	event = &ring->events[ring->head % PLAT_TRACE_EVENTS];
+	event->timestamp = read_cntpct_el0();
+	event->args[0] = arg0;
+	event->args[1] = arg1;
+	event->args[2] = arg2;
+	event->args[3] = arg3;
+	event->id = id;
+
+	/* Make the event visible to readers before accounting for it */
+	dmbish();
+	ring->head++;
+}
+
+/*
+ * Copy the event of a CPU with the sequence number '*seq' or, if it has been
+ * overwritten, its oldest event still in the ring. Return 0 and update '*seq'
+ * to the sequence number of the event copied, -1 if 'cpu_idx' is invalid or
+ * if no event with this sequence number has been recorded yet.
+ */
+int trace_event_read(unsigned int cpu_idx, unsigned long long *seq,
+		     trace_event_t *event)
+{
+	const trace_ring_t *ring;
+	unsigned long long head, start;
+
+	if (cpu_idx >= PLATFORM_CORE_COUNT)
+		return -1;
+
+	ring = &trace_rings[cpu_idx];
+	do {
+		head = ring->head;
+		if (*seq >= head)
+			return -1;
+		dmbish();
+
+		start = *seq;
+		if (head - start > PLAT_TRACE_EVENTS)
+			start = head - PLAT_TRACE_EVENTS;
+		*event = ring->events[start % PLAT_TRACE_EVENTS];
+
+		/* Retry if the owning CPU overwrote the event meanwhile */
+		dmbish();
+	} while (ring->head - start > PLAT_TRACE_EVENTS);
+
+	*seq = start;
+	return 0;
+}
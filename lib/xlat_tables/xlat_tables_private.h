@@ -50,6 +50,10 @@ CASSERT(IS_POWER_OF_TWO(PLAT_PHY_ADDR_SPACE_SIZE),
  * descriptors.
  */
 
+#if PAGE_SIZE != (4*1024)
+# error "The xlat_tables library only supports the 4KB granule."
+#endif
+
 #ifdef AARCH32
 
 # define XLAT_BLOCK_LEVEL_MIN 1
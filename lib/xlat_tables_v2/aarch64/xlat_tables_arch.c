@@ -16,12 +16,22 @@
 #include <xlat_tables_v2.h>
 #include "../xlat_tables_private.h"
 
-#if defined(IMAGE_BL1) || defined(IMAGE_BL31)
+#if defined(IMAGE_BL1) || defined(IMAGE_BL31) || \
+    (defined(IMAGE_BL2) && BL2_AT_EL3)
 # define IMAGE_EL	3
 #else
 # define IMAGE_EL	1
 #endif
 
+/* Value of TCR.TG0 for the granule of the translation tables */
+#if PAGE_SIZE == (4*1024)
+# define TCR_TG0_BITS	TCR_TG0_4K
+#elif PAGE_SIZE == (16*1024)
+# define TCR_TG0_BITS	TCR_TG0_16K
+#else
+# define TCR_TG0_BITS	TCR_TG0_64K
+#endif
+
 static unsigned long long tcr_ps_bits;
 
 static unsigned long long calc_physical_addr_size_bits(
@@ -83,16 +93,8 @@ int is_mmu_enabled(void)
 #endif
 }
 
-#if PLAT_XLAT_TABLES_DYNAMIC
-
 void xlat_arch_tlbi_va(uintptr_t va)
 {
-	/*
-	 * Ensure the translation table write has drained into memory before
-	 * invalidating the TLB entry.
-	 */
-	dsbishst();
-
 #if IMAGE_EL == 1
 	assert(IS_IN_EL(1));
 	tlbivaae1is(TLBI_ADDR(va));
@@ -102,6 +104,17 @@ void xlat_arch_tlbi_va(uintptr_t va)
 #endif
 }
 
+void xlat_arch_tlbi_all(void)
+{
+#if IMAGE_EL == 1
+	assert(IS_IN_EL(1));
+	tlbivmalle1is();
+#elif IMAGE_EL == 3
+	assert(IS_IN_EL(3));
+	tlbialle3is();
+#endif
+}
+
 void xlat_arch_tlbi_va_sync(void)
 {
 	/*
@@ -125,8 +138,6 @@ void xlat_arch_tlbi_va_sync(void)
 	isb();
 }
 
-#endif /* PLAT_XLAT_TABLES_DYNAMIC */
-
 int xlat_arch_current_el(void)
 {
 	int el = GET_EL(read_CurrentEl());
@@ -164,96 +175,65 @@ void init_xlat_tables_arch(unsigned long long max_pa)
 #endif
 }
 
-/*******************************************************************************
- * Macro generating the code for the function enabling the MMU in the given
- * exception level, assuming that the pagetables have already been created.
- *
- *   _el:		Exception level at which the function will run
- *   _tcr_extra:	Extra bits to set in the TCR register. This mask will
- *			be OR'ed with the default TCR value.
- *   _tlbi_fct:		Function to invalidate the TLBs at the current
- *			exception level
- ******************************************************************************/
-#define DEFINE_ENABLE_MMU_EL(_el, _tcr_extra, _tlbi_fct)		\
-	void enable_mmu_internal_el##_el(unsigned int flags,		\
-					 uint64_t *base_table)		\
-	{								\
-		uint64_t mair, tcr, ttbr;				\
-		uint32_t sctlr;						\
-									\
-		assert(IS_IN_EL(_el));					\
-		assert((read_sctlr_el##_el() & SCTLR_M_BIT) == 0);	\
-									\
-		/* Invalidate TLBs at the current exception level */	\
-		_tlbi_fct();						\
-									\
-		/* Set attributes in the right indices of the MAIR */	\
-		mair = MAIR_ATTR_SET(ATTR_DEVICE, ATTR_DEVICE_INDEX);	\
-		mair |= MAIR_ATTR_SET(ATTR_IWBWA_OWBWA_NTR,		\
-				ATTR_IWBWA_OWBWA_NTR_INDEX);		\
-		mair |= MAIR_ATTR_SET(ATTR_NON_CACHEABLE,		\
-				ATTR_NON_CACHEABLE_INDEX);		\
-		write_mair_el##_el(mair);				\
-									\
-		/* Set TCR bits as well. */				\
-		/* Set T0SZ to (64 - width of virtual address space) */	\
-		if (flags & XLAT_TABLE_NC) {				\
-			/* Inner & outer non-cacheable non-shareable. */\
-			tcr = TCR_SH_NON_SHAREABLE |			\
-				TCR_RGN_OUTER_NC | TCR_RGN_INNER_NC |	\
-				(64 - __builtin_ctzl(PLAT_VIRT_ADDR_SPACE_SIZE));\
-		} else {						\
-			/* Inner & outer WBWA & shareable. */		\
-			tcr = TCR_SH_INNER_SHAREABLE |			\
-				TCR_RGN_OUTER_WBA | TCR_RGN_INNER_WBA |	\
-				(64 - __builtin_ctzl(PLAT_VIRT_ADDR_SPACE_SIZE));\
-		}							\
-		tcr |= _tcr_extra;					\
-		write_tcr_el##_el(tcr);					\
-									\
-		/* Set TTBR bits as well */				\
-		ttbr = (uint64_t) base_table;				\
-		write_ttbr0_el##_el(ttbr);				\
-									\
-		/* Ensure all translation table writes have drained */	\
-		/* into memory, the TLB invalidation is complete, */	\
-		/* and translation register writes are committed */	\
-		/* before enabling the MMU */				\
-		dsbish();						\
-		isb();							\
-									\
-		sctlr = read_sctlr_el##_el();				\
-		sctlr |= SCTLR_WXN_BIT | SCTLR_M_BIT;			\
-									\
-		if (flags & DISABLE_DCACHE)				\
-			sctlr &= ~SCTLR_C_BIT;				\
-		else							\
-			sctlr |= SCTLR_C_BIT;				\
-									\
-		write_sctlr_el##_el(sctlr);				\
-									\
-		/* Ensure the MMU enable takes effect immediately */	\
-		isb();							\
+/*
+ * Values of the MMU configuration registers, shared by all the CPUs. They are
+ * computed once on the cold boot path and cleaned to memory so that the CPUs
+ * booting later can enable their MMU straight away with enable_mmu_direct_el1()
+ * or enable_mmu_direct_el3(), even with their data cache disabled.
+ */
+uint64_t mmu_cfg_params[MMU_CFG_PARAM_MAX];
+
+/*
+ * Computes the values of the MMU configuration registers for the given
+ * exception level and translation tables.
+ */
+static void setup_mmu_cfg(unsigned int flags, const uint64_t *base_table)
+{
+	uint64_t mair, tcr;
+
+	/* Set attributes in the right indices of the MAIR */
+	mair = MAIR_ATTR_SET(ATTR_DEVICE, ATTR_DEVICE_INDEX);
+	mair |= MAIR_ATTR_SET(ATTR_IWBWA_OWBWA_NTR, ATTR_IWBWA_OWBWA_NTR_INDEX);
+	mair |= MAIR_ATTR_SET(ATTR_NON_CACHEABLE, ATTR_NON_CACHEABLE_INDEX);
+
+	/* Set T0SZ to (64 - width of virtual address space) */
+	if (flags & XLAT_TABLE_NC) {
+		/* Inner & outer non-cacheable non-shareable. */
+		tcr = TCR_SH_NON_SHAREABLE |
+			TCR_RGN_OUTER_NC | TCR_RGN_INNER_NC |
+			(64 - __builtin_ctzl(PLAT_VIRT_ADDR_SPACE_SIZE));
+	} else {
+		/* Inner & outer WBWA & shareable. */
+		tcr = TCR_SH_INNER_SHAREABLE |
+			TCR_RGN_OUTER_WBA | TCR_RGN_INNER_WBA |
+			(64 - __builtin_ctzl(PLAT_VIRT_ADDR_SPACE_SIZE));
 	}
 
-/* Define EL1 and EL3 variants of the function enabling the MMU */
 #if IMAGE_EL == 1
-DEFINE_ENABLE_MMU_EL(1,
-		(tcr_ps_bits << TCR_EL1_IPS_SHIFT),
-		tlbivmalle1)
+	tcr |= tcr_ps_bits << TCR_EL1_IPS_SHIFT;
 #elif IMAGE_EL == 3
-DEFINE_ENABLE_MMU_EL(3,
-		TCR_EL3_RES1 | (tcr_ps_bits << TCR_EL3_PS_SHIFT),
-		tlbialle3)
+	tcr |= TCR_EL3_RES1 | (tcr_ps_bits << TCR_EL3_PS_SHIFT);
 #endif
 
+	/* Select the translation granule of the tables */
+	tcr |= TCR_TG0_BITS;
+
+	mmu_cfg_params[MMU_CFG_MAIR0] = mair;
+	mmu_cfg_params[MMU_CFG_TCR] = tcr;
+	mmu_cfg_params[MMU_CFG_TTBR0] = (uint64_t) base_table;
+
+	flush_dcache_range((uintptr_t)mmu_cfg_params, sizeof(mmu_cfg_params));
+}
+
 void enable_mmu_arch(unsigned int flags, uint64_t *base_table)
 {
+	setup_mmu_cfg(flags, base_table);
+
 #if IMAGE_EL == 1
 	assert(IS_IN_EL(1));
-	enable_mmu_internal_el1(flags, base_table);
+	enable_mmu_direct_el1(flags);
 #elif IMAGE_EL == 3
 	assert(IS_IN_EL(3));
-	enable_mmu_internal_el3(flags, base_table);
+	enable_mmu_direct_el3(flags);
 #endif
 }
@@ -43,6 +43,11 @@
  * result, level 3 cannot be used as initial lookup level with 4 KB
  * granularity. [2]
  *
+ * With the larger granules, each level resolves more bits and level 3 can be
+ * the initial lookup level of the narrowest address spaces: up to 25 bits for
+ * 16 KB and 29 bits for 64 KB. With 64 KB, level 0 is never used, so a 48-bit
+ * address space starts at level 1 and takes one walk step less than with 4 KB.
+ *
  * For example, for a 35-bit address space (i.e. PLAT_VIRT_ADDR_SPACE_SIZE ==
  * 1 << 35), TCR.TxSZ will be programmed to (64 - 35) = 29. According to Table
  * D4-11 in the ARM ARM, the initial lookup level for an address space like
@@ -64,13 +69,17 @@
 # define NUM_BASE_LEVEL_ENTRIES	\
 		(PLAT_VIRT_ADDR_SPACE_SIZE >> L0_XLAT_ADDRESS_SHIFT)
 
-#elif PLAT_VIRT_ADDR_SPACE_SIZE > (1 << L1_XLAT_ADDRESS_SHIFT)
+#elif PLAT_VIRT_ADDR_SPACE_SIZE > (1ULL << L1_XLAT_ADDRESS_SHIFT)
 
 # define XLAT_TABLE_LEVEL_BASE	1
 # define NUM_BASE_LEVEL_ENTRIES	\
 		(PLAT_VIRT_ADDR_SPACE_SIZE >> L1_XLAT_ADDRESS_SHIFT)
 
-#elif PLAT_VIRT_ADDR_SPACE_SIZE >= (1 << (64 - TCR_TxSZ_MAX))
+#elif PLAT_VIRT_ADDR_SPACE_SIZE < (1ULL << (64 - TCR_TxSZ_MAX))
+
+# error "PLAT_VIRT_ADDR_SPACE_SIZE is too small."
+
+#elif PLAT_VIRT_ADDR_SPACE_SIZE > (1ULL << L2_XLAT_ADDRESS_SHIFT)
 
 # define XLAT_TABLE_LEVEL_BASE	2
 # define NUM_BASE_LEVEL_ENTRIES	\
@@ -78,7 +87,9 @@
 
 #else
 
-# error "PLAT_VIRT_ADDR_SPACE_SIZE is too small."
+# define XLAT_TABLE_LEVEL_BASE	3
+# define NUM_BASE_LEVEL_ENTRIES	\
+		(PLAT_VIRT_ADDR_SPACE_SIZE >> L3_XLAT_ADDRESS_SHIFT)
 
 #endif
 
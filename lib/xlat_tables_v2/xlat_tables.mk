@@ -8,3 +8,7 @@ XLAT_TABLES_LIB_SRCS	:=	$(addprefix lib/xlat_tables_v2/,	\
 				${ARCH}/xlat_tables_arch.c		\
 				xlat_tables_common.c			\
 				xlat_tables_internal.c)
+
+ifeq (${ARCH},aarch64)
+XLAT_TABLES_LIB_SRCS	+=	lib/xlat_tables_v2/aarch64/enable_mmu.S
+endif
@@ -23,6 +23,86 @@
 #endif
 #include "xlat_tables_private.h"
 
+#if XLAT_TABLES_PREBUILT
+
+/*
+ * The translation tables are generated at build time. The regions that they
+ * map are fixed, so there is no need for an mmap array or for tables to fill.
+ */
+xlat_ctx_t tf_xlat_ctx = {
+
+	.pa_max_address = PLAT_PHY_ADDR_SPACE_SIZE - 1,
+	.va_max_address = PLAT_VIRT_ADDR_SPACE_SIZE - 1,
+
+	.mmap = (mmap_region_t *)xlat_prebuilt_regions,
+	.mmap_num = 0,
+
+	.tables = xlat_prebuilt_tables,
+	.tables_num = 0,
+
+	.base_table = xlat_prebuilt_base_table,
+	.base_table_entries = NUM_BASE_LEVEL_ENTRIES,
+
+	.max_pa = 0,
+	.max_va = 0,
+
+	.next_table = 0,
+
+	.base_level = XLAT_TABLE_LEVEL_BASE,
+
+	.initialized = 0
+};
+
+/*
+ * Regions can't be added to the prebuilt translation tables. Only check that
+ * the regions that the image expects to be mapped are part of them.
+ */
+static void mmap_check_prebuilt_region(const mmap_region_t *mm)
+{
+#if ENABLE_ASSERTIONS
+	const mmap_region_t *cur;
+	uintptr_t end_va = mm->base_va + mm->size - 1;
+
+	for (cur = xlat_prebuilt_regions; cur->size; cur++) {
+		if ((mm->base_va >= cur->base_va) &&
+		    (end_va <= cur->base_va + cur->size - 1) &&
+		    ((mm->base_va - mm->base_pa) ==
+		     (cur->base_va - cur->base_pa)) &&
+		    (mm->attr == cur->attr))
+			return;
+	}
+
+	ERROR("Region not in the prebuilt translation tables:\n"
+	      " VA:%p  PA:0x%llx  size:0x%zx  attr:0x%x\n",
+	      (void *)mm->base_va, mm->base_pa, mm->size, mm->attr);
+	assert(0);
+#endif /* ENABLE_ASSERTIONS */
+}
+
+void mmap_add_region(unsigned long long base_pa, uintptr_t base_va,
+			size_t size, mmap_attr_t attr)
+{
+	mmap_region_t mm = {
+		.base_va = base_va,
+		.base_pa = base_pa,
+		.size = size,
+		.attr = attr,
+	};
+
+	if (size != 0)
+		mmap_check_prebuilt_region(&mm);
+}
+
+void mmap_add(const mmap_region_t *mm)
+{
+	while (mm->size) {
+		mmap_check_prebuilt_region(mm);
+		mm++;
+	}
+}
+
+#else /* XLAT_TABLES_PREBUILT */
+
 /*
  * Private variables used by the TF
  */
@@ -85,6 +165,8 @@ void mmap_add(const mmap_region_t *mm)
 	}
 }
 
+#endif /* XLAT_TABLES_PREBUILT */
+
 #if PLAT_XLAT_TABLES_DYNAMIC
 
 int mmap_add_dynamic_region(unsigned long long base_pa,
@@ -104,8 +186,43 @@ int mmap_remove_dynamic_region(uintptr_t base_va, size_t size)
 	return mmap_remove_dynamic_region_ctx(&tf_xlat_ctx, base_va, size);
 }
 
+void mmap_dynamic_batch_start(void)
+{
+	mmap_dynamic_batch_start_ctx(&tf_xlat_ctx);
+}
+
+void mmap_dynamic_batch_end(void)
+{
+	mmap_dynamic_batch_end_ctx(&tf_xlat_ctx);
+}
+
 #endif /* PLAT_XLAT_TABLES_DYNAMIC */
 
+int xlat_tables_get_max_used(void)
+{
+	return xlat_tables_get_max_used_ctx(&tf_xlat_ctx);
+}
+
+int change_mem_attributes(uintptr_t base_va, size_t size, mmap_attr_t attr)
+{
+	return change_mem_attributes_ctx(&tf_xlat_ctx, base_va, size, attr);
+}
+
+#if XLAT_TABLES_HANDOFF
+
+void xlat_tables_export(xlat_tables_handoff_t *handoff)
+{
+	xlat_tables_export_ctx(&tf_xlat_ctx, handoff);
+}
+
+void xlat_tables_import(const xlat_tables_handoff_t *handoff)
+{
+	assert(!tf_xlat_ctx.initialized);
+	tf_xlat_ctx.handoff = handoff;
+}
+
+#endif /* XLAT_TABLES_HANDOFF */
+
 void init_xlat_tables(void)
 {
 	assert(!is_mmu_enabled());
@@ -113,7 +230,15 @@ void init_xlat_tables(void)
 	print_mmap(tf_xlat_ctx.mmap);
 	tf_xlat_ctx.execute_never_mask =
 			xlat_arch_get_xn_desc(xlat_arch_current_el());
+#if XLAT_TABLES_PREBUILT
+	tf_xlat_ctx.tables_num = xlat_prebuilt_tables_num;
+	tf_xlat_ctx.next_table = xlat_prebuilt_tables_num;
+	tf_xlat_ctx.max_pa = xlat_prebuilt_max_pa;
+	tf_xlat_ctx.max_va = xlat_prebuilt_max_va;
+	tf_xlat_ctx.initialized = 1;
+#else
 	init_xlation_table(&tf_xlat_ctx);
+#endif
 	xlat_tables_print(&tf_xlat_ctx);
 
 	assert(tf_xlat_ctx.max_va <= PLAT_VIRT_ADDR_SPACE_SIZE - 1);
@@ -37,25 +37,83 @@
  */
 static int xlat_table_get_index(xlat_ctx_t *ctx, const uint64_t *table)
 {
-	for (int i = 0; i < ctx->tables_num; i++)
-		if (ctx->tables[i] == table)
-			return i;
+	uintptr_t offset = (uintptr_t)table - (uintptr_t)ctx->tables;
 
 	/*
 	 * Maybe we were asked to get the index of the base level table, which
 	 * should never happen.
 	 */
-	assert(0);
+	assert((offset % XLAT_TABLE_SIZE) == 0);
+	assert(offset < (uintptr_t)ctx->tables_num * XLAT_TABLE_SIZE);
 
-	return -1;
+	return offset / XLAT_TABLE_SIZE;
 }
 
-/* Returns a pointer to an empty translation table. */
+/*
+ * Records that the TLB entries of the specified virtual address have to be
+ * invalidated by the next call to xlat_tables_flush_tlbi().
+ */
+static void xlat_tables_defer_tlbi_va(xlat_ctx_t *ctx, uintptr_t va)
+{
+	if (ctx->tlbi_pending_num < XLAT_TLBI_PENDING_MAX)
+		ctx->tlbi_pending_va[ctx->tlbi_pending_num] = va;
+
+	/* Past the maximum, only remember that the whole TLB is stale */
+	if (ctx->tlbi_pending_num <= XLAT_TLBI_PENDING_MAX)
+		ctx->tlbi_pending_num++;
+}
+
+/*
+ * Makes the translation table updates done so far visible: waits for the
+ * writes to the tables to complete, then issues all the deferred TLB
+ * invalidations and waits for them to complete.
+ */
+static void xlat_tables_flush_tlbi(xlat_ctx_t *ctx)
+{
+	/*
+	 * Ensure the translation table writes have drained into memory before
+	 * invalidating the TLB entries.
+	 */
+	dsbishst();
+
+	if (ctx->tlbi_pending_num == 0)
+		return;
+
+	if (ctx->tlbi_pending_num > XLAT_TLBI_PENDING_MAX) {
+		xlat_arch_tlbi_all();
+	} else {
+		for (int i = 0; i < ctx->tlbi_pending_num; i++)
+			xlat_arch_tlbi_va(ctx->tlbi_pending_va[i]);
+	}
+
+	xlat_arch_tlbi_va_sync();
+
+	ctx->tlbi_pending_num = 0;
+}
+
+/*
+ * Returns a pointer to an empty translation table. All the tables below
+ * `next_table` are in use, so the search starts there. The table returned is
+ * always used straight away, as xlat_tables_map_region() increments its region
+ * count before doing anything else.
+ */
 static uint64_t *xlat_table_get_empty(xlat_ctx_t *ctx)
 {
-	for (int i = 0; i < ctx->tables_num; i++)
-		if (ctx->tables_mapped_regions[i] == 0)
+	for (int i = ctx->next_table; i < ctx->tables_num; i++) {
+		if (ctx->tables_mapped_regions[i] == 0) {
+			/*
+			 * The table may have been unlinked in the current
+			 * batch. Make sure that no TLB entry still refers to
+			 * it before reusing it.
+			 */
+			if (ctx->tlbi_pending_num != 0)
+				xlat_tables_flush_tlbi(ctx);
+
+			ctx->next_table = i + 1;
+
 			return ctx->tables[i];
+		}
+	}
 
 	return NULL;
 }
@@ -63,13 +121,30 @@ static uint64_t *xlat_table_get_empty(xlat_ctx_t *ctx)
 /* Increments region count for a given table. */
 static void xlat_table_inc_regions_count(xlat_ctx_t *ctx, const uint64_t *table)
 {
-	ctx->tables_mapped_regions[xlat_table_get_index(ctx, table)]++;
+	int index = xlat_table_get_index(ctx, table);
+
+	if (ctx->tables_mapped_regions[index]++ == 0) {
+		ctx->tables_used++;
+		if (ctx->tables_used > ctx->tables_max_used)
+			ctx->tables_max_used = ctx->tables_used;
+	}
 }
 
-/* Decrements region count for a given table. */
+/*
+ * Decrements region count for a given table. When it reaches 0 the table is
+ * given back to the pool, and the caller must remove its table descriptor.
+ */
 static void xlat_table_dec_regions_count(xlat_ctx_t *ctx, const uint64_t *table)
 {
-	ctx->tables_mapped_regions[xlat_table_get_index(ctx, table)]--;
+	int index = xlat_table_get_index(ctx, table);
+
+	assert(ctx->tables_mapped_regions[index] > 0);
+
+	if (--ctx->tables_mapped_regions[index] == 0) {
+		ctx->tables_used--;
+		if (index < ctx->next_table)
+			ctx->next_table = index;
+	}
 }
 
 /* Returns 0 if the speficied table isn't empty, otherwise 1. */
@@ -78,6 +153,16 @@ static int xlat_table_is_empty(xlat_ctx_t *ctx, const uint64_t *table)
 	return !ctx->tables_mapped_regions[xlat_table_get_index(ctx, table)];
 }
 
+/* Returns 1 if all the entries of the specified table are invalid, else 0. */
+static int xlat_table_has_no_entries(const uint64_t *table)
+{
+	for (int i = 0; i < XLAT_TABLE_ENTRIES; i++)
+		if ((table[i] & DESC_MASK) != INVALID_DESC)
+			return 0;
+
+	return 1;
+}
+
 #else /* PLAT_XLAT_TABLES_DYNAMIC */
 
 /* Returns a pointer to the first empty translation table. */
@@ -292,7 +377,7 @@ static void xlat_tables_unmap_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 		if (action == ACTION_WRITE_BLOCK_ENTRY) {
 
 			table_base[table_idx] = INVALID_DESC;
-			xlat_arch_tlbi_va(table_idx_va);
+			xlat_tables_defer_tlbi_va(ctx, table_idx_va);
 
 		} else if (action == ACTION_RECURSE_INTO_TABLE) {
 
@@ -308,7 +393,7 @@ static void xlat_tables_unmap_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 			 */
 			if (xlat_table_is_empty(ctx, subtable)) {
 				table_base[table_idx] = INVALID_DESC;
-				xlat_arch_tlbi_va(table_idx_va);
+				xlat_tables_defer_tlbi_va(ctx, table_idx_va);
 			}
 
 		} else {
@@ -531,8 +616,22 @@ static uintptr_t xlat_tables_map_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 			uintptr_t end_va = xlat_tables_map_region(ctx, mm, table_idx_va,
 					       subtable, XLAT_TABLE_ENTRIES,
 					       level + 1);
-			if (end_va != table_idx_va + XLAT_BLOCK_SIZE(level) - 1)
+			if (end_va != table_idx_va + XLAT_BLOCK_SIZE(level) - 1) {
+#if PLAT_XLAT_TABLES_DYNAMIC
+				/*
+				 * If nothing could be mapped in the new
+				 * subtable, give it back to the pool now. The
+				 * caller only unmaps the VA range mapped before
+				 * 'end_va', which doesn't include it.
+				 */
+				if (xlat_table_has_no_entries(subtable)) {
+					table_base[table_idx] = INVALID_DESC;
+					xlat_table_dec_regions_count(ctx,
+								     subtable);
+				}
+#endif
 				return end_va;
+			}
 
 		} else if (action == ACTION_RECURSE_INTO_TABLE) {
 
@@ -666,12 +765,77 @@ static int mmap_add_region_check(xlat_ctx_t *ctx, unsigned long long base_pa,
 	return 0;
 }
 
+#if PLAT_XLAT_TABLES_COALESCE
+
+/*
+ * Looks for a region in the mmap array that is adjacent to the specified one,
+ * both in VA and PA, and that has the same attributes. If there is one and no
+ * other region overlaps the union of both, it is removed from the array and
+ * the specified region is extended to cover it. This lets the regions that are
+ * described as several consecutive ones be mapped with larger blocks.
+ * Returns 1 if a region has been merged, 0 otherwise.
+ */
+static int mmap_coalesce_region(xlat_ctx_t *ctx, mmap_region_t *mm)
+{
+	mmap_region_t *mm_last = ctx->mmap + ctx->mmap_num;
+	mmap_region_t *mm_cursor, *mm_other;
+
+	for (mm_cursor = ctx->mmap; mm_cursor->size; ++mm_cursor) {
+		unsigned long long base_pa;
+		uintptr_t base_va, end_va;
+
+		if (mm_cursor->attr != mm->attr)
+			continue;
+
+		if ((mm_cursor->base_va + mm_cursor->size == mm->base_va) &&
+		    (mm_cursor->base_pa + mm_cursor->size == mm->base_pa)) {
+			base_va = mm_cursor->base_va;
+			base_pa = mm_cursor->base_pa;
+		} else if ((mm->base_va + mm->size == mm_cursor->base_va) &&
+			   (mm->base_pa + mm->size == mm_cursor->base_pa)) {
+			base_va = mm->base_va;
+			base_pa = mm->base_pa;
+		} else {
+			continue;
+		}
+
+		end_va = base_va + mm->size + mm_cursor->size - 1;
+
+		/* The merged region mustn't overlap any other region. */
+		for (mm_other = ctx->mmap; mm_other->size; ++mm_other) {
+			if (mm_other == mm_cursor)
+				continue;
+
+			if ((mm_other->base_va <= end_va) &&
+			    (mm_other->base_va + mm_other->size - 1 >= base_va))
+				break;
+		}
+
+		if (mm_other->size)
+			continue;
+
+		mm->base_va = base_va;
+		mm->base_pa = base_pa;
+		mm->size += mm_cursor->size;
+
+		/* Remove the merged region by moving the next ones down. */
+		memmove(mm_cursor, mm_cursor + 1,
+			(uintptr_t)mm_last - (uintptr_t)mm_cursor);
+
+		return 1;
+	}
+
+	return 0;
+}
+
+#endif /* PLAT_XLAT_TABLES_COALESCE */
+
 void mmap_add_region_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
 {
 	mmap_region_t *mm_cursor = ctx->mmap;
 	mmap_region_t *mm_last = mm_cursor + ctx->mmap_num;
-	unsigned long long end_pa = mm->base_pa + mm->size - 1;
-	uintptr_t end_va = mm->base_va + mm->size - 1;
+	unsigned long long end_pa;
+	uintptr_t end_va;
 	int ret;
 
 	/* Ignore empty regions */
@@ -689,6 +853,22 @@ void mmap_add_region_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
 		return;
 	}
 
+#if PLAT_XLAT_TABLES_COALESCE
+	/*
+	 * Merge the neighbouring static regions with the same attributes into
+	 * the new one. The region passed by the caller is left untouched.
+	 */
+	mmap_region_t merged = *mm;
+
+	while (mmap_coalesce_region(ctx, &merged))
+		;
+
+	mm = &merged;
+#endif
+
+	end_pa = mm->base_pa + mm->size - 1;
+	end_va = mm->base_va + mm->size - 1;
+
 	/*
 	 * Find correct place in mmap to insert new region.
 	 *
@@ -803,7 +983,7 @@ int mmap_add_dynamic_region_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
 			 * Check if the mapping function actually managed to map
 			 * anything. If not, just return now.
 			 */
-			if (mm_cursor->base_va >= end_va)
+			if (mm->base_va >= end_va)
 				return -ENOMEM;
 
 			/*
@@ -819,16 +999,21 @@ int mmap_add_dynamic_region_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
 			xlat_tables_unmap_region(ctx, &unmap_mm, 0, ctx->base_table,
 							ctx->base_table_entries, ctx->base_level);
 
+			if (!ctx->batch_in_progress)
+				xlat_tables_flush_tlbi(ctx);
+
 			return -ENOMEM;
 		}
 
 		/*
-		 * Make sure that all entries are written to the memory. There
-		 * is no need to invalidate entries when mapping dynamic regions
-		 * because new table/block/page descriptors only replace old
-		 * invalid descriptors, that aren't TLB cached.
+		 * Make sure that all entries are written to the memory, unless
+		 * this is deferred to the end of the batch. There is no need to
+		 * invalidate entries when mapping dynamic regions because new
+		 * table/block/page descriptors only replace old invalid
+		 * descriptors, that aren't TLB cached.
 		 */
-		dsbishst();
+		if (!ctx->batch_in_progress)
+			xlat_tables_flush_tlbi(ctx);
 	}
 
 	if (end_pa > ctx->max_pa)
@@ -884,7 +1069,9 @@ int mmap_remove_dynamic_region_ctx(xlat_ctx_t *ctx, uintptr_t base_va,
 		xlat_tables_unmap_region(ctx, mm, 0, ctx->base_table,
 					 ctx->base_table_entries,
 					 ctx->base_level);
-		xlat_arch_tlbi_va_sync();
+
+		if (!ctx->batch_in_progress)
+			xlat_tables_flush_tlbi(ctx);
 	}
 
 	/* Remove this region by moving the rest down by one place. */
@@ -914,6 +1101,34 @@ int mmap_remove_dynamic_region_ctx(xlat_ctx_t *ctx, uintptr_t base_va,
 	return 0;
 }
 
+/*
+ * Starts a batch of dynamic region updates. Until the matching call to
+ * mmap_dynamic_batch_end_ctx(), the regions added to the context must not be
+ * accessed and the memory of the regions removed from it must not be reused,
+ * as the barriers and TLB invalidations are deferred to the end of the batch.
+ * Batches can't be nested.
+ */
+void mmap_dynamic_batch_start_ctx(xlat_ctx_t *ctx)
+{
+	assert(!ctx->batch_in_progress);
+
+	ctx->batch_in_progress = 1;
+}
+
+/*
+ * Ends a batch of dynamic region updates, making all of them visible with a
+ * single barrier before the TLB invalidations and a single one after them.
+ */
+void mmap_dynamic_batch_end_ctx(xlat_ctx_t *ctx)
+{
+	assert(ctx->batch_in_progress);
+
+	ctx->batch_in_progress = 0;
+
+	if (ctx->initialized)
+		xlat_tables_flush_tlbi(ctx);
+}
+
 #endif /* PLAT_XLAT_TABLES_DYNAMIC */
 
 #if LOG_LEVEL >= LOG_LEVEL_VERBOSE
@@ -935,6 +1150,7 @@ static void xlat_desc_print(uint64_t desc, uint64_t execute_never_mask)
 	tf_printf(LOWER_ATTRS(AP_RO) & desc ? "-RO" : "-RW");
 	tf_printf(LOWER_ATTRS(NS) & desc ? "-NS" : "-S");
 	tf_printf(execute_never_mask & desc ? "-XN" : "-EXEC");
+	tf_printf(UPPER_ATTRS(CONT_HINT) & desc ? "-CONT" : "");
 }
 
 static const char * const level_spacers[] = {
@@ -1045,8 +1261,411 @@ void xlat_tables_print(xlat_ctx_t *ctx)
 	xlat_tables_print_internal(0, ctx->base_table, ctx->base_table_entries,
 				   ctx->base_level, ctx->execute_never_mask);
 #endif /* LOG_LEVEL >= LOG_LEVEL_VERBOSE */
+	VERBOSE("Translation tables used: %d of %d\n",
+		xlat_tables_get_max_used_ctx(ctx), ctx->tables_num);
+}
+
+int xlat_tables_get_max_used_ctx(xlat_ctx_t *ctx)
+{
+#if PLAT_XLAT_TABLES_DYNAMIC
+	return ctx->tables_max_used;
+#else
+	/* Tables are never given back to the pool of static contexts. */
+	return ctx->next_table;
+#endif
+}
+
+/*
+ * Returns a pointer to the level 3 descriptor that maps the page at the
+ * specified virtual address, or NULL if the page isn't mapped by a page
+ * descriptor without the contiguous hint.
+ */
+static uint64_t *xlat_get_page_entry(xlat_ctx_t *ctx, uintptr_t va)
+{
+	uint64_t *table = ctx->base_table;
+	int table_entries = ctx->base_table_entries;
+	unsigned int idx;
+	uint64_t desc;
+
+	for (int level = ctx->base_level; ; level++) {
+		idx = va >> XLAT_ADDR_SHIFT(level);
+		if (level != ctx->base_level)
+			idx &= XLAT_TABLE_ENTRIES_MASK;
+		if (idx >= (unsigned int)table_entries)
+			return NULL;
+
+		desc = table[idx];
+		if ((desc & DESC_MASK) != TABLE_DESC)
+			return NULL;
+
+		/* DESC_PAGE has the same value as DESC_TABLE */
+		if (level == XLAT_TABLE_LEVEL_MAX)
+			break;
+
+		table = (uint64_t *)(uintptr_t)(desc & TABLE_ADDR_MASK);
+		table_entries = XLAT_TABLE_ENTRIES;
+	}
+
+	if ((desc & UPPER_ATTRS(CONT_HINT)) != 0)
+		return NULL;
+
+	return &table[idx];
+}
+
+/* Descriptor fields that change_mem_attributes_ctx() can't modify */
+#define XLAT_DESC_TYPE_MASK	(TABLE_ADDR_MASK | \
+				 LOWER_ATTRS(ATTR_INDEX_MASK | NS | ISH))
+
+int change_mem_attributes_ctx(xlat_ctx_t *ctx, uintptr_t base_va, size_t size,
+			      mmap_attr_t attr)
+{
+	uintptr_t end_va = base_va + size - 1;
+	uintptr_t va;
+	uint64_t *entry;
+	uint64_t desc;
+
+	if (!ctx->initialized)
+		return -EINVAL;
+	if ((size == 0) || !IS_PAGE_ALIGNED(base_va) ||
+	    !IS_PAGE_ALIGNED(size) || check_uptr_overflow(base_va, size - 1))
+		return -EINVAL;
+
+	/* Check all the pages first, so that no change is done on error */
+	for (va = base_va; va <= end_va; va += PAGE_SIZE) {
+		entry = xlat_get_page_entry(ctx, va);
+		if (entry == NULL)
+			return -EINVAL;
+
+		desc = xlat_desc(attr, *entry & TABLE_ADDR_MASK,
+				 XLAT_TABLE_LEVEL_MAX, ctx->execute_never_mask);
+		if (((desc ^ *entry) & XLAT_DESC_TYPE_MASK) != 0)
+			return -EPERM;
+	}
+
+	/*
+	 * Only the access permissions and the executability change, so the
+	 * entries can be updated in place without a break-before-make
+	 * sequence.
+	 */
+	for (va = base_va; va <= end_va; va += PAGE_SIZE) {
+		entry = xlat_get_page_entry(ctx, va);
+		*entry = xlat_desc(attr, *entry & TABLE_ADDR_MASK,
+				   XLAT_TABLE_LEVEL_MAX,
+				   ctx->execute_never_mask);
+	}
+
+	dsbishst();
+	for (va = base_va; va <= end_va; va += PAGE_SIZE)
+		xlat_arch_tlbi_va(va);
+	xlat_arch_tlbi_va_sync();
+
+	return 0;
+}
+
+#if PLAT_XLAT_TABLES_CONTIG_HINT
+
+/*
+ * Returns 1 if the specified VA range can't be covered by a contiguous group of
+ * entries because a dynamic region is mapped in it, 0 otherwise. Dynamic
+ * regions must be kept out of these groups so that they can later be removed
+ * without having to rewrite the descriptors of their static neighbours.
+ */
+static int xlat_tables_contig_range_is_dynamic(xlat_ctx_t *ctx,
+					       uintptr_t base_va,
+					       uintptr_t end_va)
+{
+#if PLAT_XLAT_TABLES_DYNAMIC
+	for (mmap_region_t *mm = ctx->mmap; mm->size; ++mm) {
+		uintptr_t mm_end_va = mm->base_va + mm->size - 1;
+
+		if ((mm->attr & MT_DYNAMIC) &&
+		    (mm->base_va <= end_va) && (mm_end_va >= base_va))
+			return 1;
+	}
+#endif /* PLAT_XLAT_TABLES_DYNAMIC */
+
+	return 0;
+}
+
+/*
+ * Recursive function that walks the translation tables passed as an argument
+ * and sets the contiguous hint in every aligned group of CONT_HINT_ENTRIES()
+ * block or page descriptors that map a contiguous and equally aligned range of
+ * physical memory with the same attributes. The TLB can then cache the whole
+ * group with a single entry.
+ */
+static void xlat_tables_set_contig_hint(xlat_ctx_t *ctx,
+					const uintptr_t table_base_va,
+					uint64_t *const table_base,
+					const int table_entries,
+					const int level)
+{
+	assert(level <= XLAT_TABLE_LEVEL_MAX);
+
+	uint64_t block_type = (level == XLAT_TABLE_LEVEL_MAX) ?
+			      PAGE_DESC : BLOCK_DESC;
+	size_t level_size = XLAT_BLOCK_SIZE(level);
+	const int cont_entries = CONT_HINT_ENTRIES(level);
+	unsigned long long group_size =
+		(unsigned long long)level_size * cont_entries;
+
+	for (int i = 0; i < table_entries; i++) {
+		uint64_t desc = table_base[i];
+
+		if (((desc & DESC_MASK) == TABLE_DESC) &&
+		    (level < XLAT_TABLE_LEVEL_MAX)) {
+			xlat_tables_set_contig_hint(ctx,
+				table_base_va + i * level_size,
+				(uint64_t *)(uintptr_t)(desc & TABLE_ADDR_MASK),
+				XLAT_TABLE_ENTRIES, level + 1);
+		}
+	}
+
+	for (int i = 0; i + cont_entries <= table_entries;
+	     i += cont_entries) {
+		uint64_t first = table_base[i];
+		uint64_t attr = first & ~TABLE_ADDR_MASK;
+		unsigned long long pa = first & TABLE_ADDR_MASK;
+		uintptr_t va = table_base_va + i * level_size;
+		int j;
+
+		if (((first & DESC_MASK) != block_type) ||
+		    ((pa & (group_size - 1)) != 0))
+			continue;
+
+		for (j = 1; j < cont_entries; j++) {
+			uint64_t desc = table_base[i + j];
+
+			if (((desc & ~TABLE_ADDR_MASK) != attr) ||
+			    ((desc & TABLE_ADDR_MASK) !=
+			     pa + (unsigned long long)j * level_size))
+				break;
+		}
+
+		if (j != cont_entries)
+			continue;
+
+		if (xlat_tables_contig_range_is_dynamic(ctx, va,
+				va + (uintptr_t)group_size - 1))
+			continue;
+
+		for (j = 0; j < cont_entries; j++)
+			table_base[i + j] |= UPPER_ATTRS(CONT_HINT);
+	}
+}
+
+#endif /* PLAT_XLAT_TABLES_CONTIG_HINT */
+
+#if XLAT_TABLES_HANDOFF
+
+/*
+ * Returns the first region of the array 'mm' that intersects the specified VA
+ * range, or its terminating entry if there is none.
+ */
+static const mmap_region_t *mmap_next_region_in_range(const mmap_region_t *mm,
+						      uintptr_t base_va,
+						      uintptr_t end_va)
+{
+	while (mm->size && ((mm->base_va > end_va) ||
+			    (mm->base_va + mm->size - 1 < base_va)))
+		mm++;
+
+	return mm;
 }
 
+/*
+ * Returns 1 if the same regions intersect the specified VA range in both mmap
+ * arrays, 0 otherwise. Both arrays are sorted the same way, so the regions have
+ * to appear in the same order.
+ */
+static int mmap_regions_match_in_range(const mmap_region_t *mm_a,
+				       const mmap_region_t *mm_b,
+				       uintptr_t base_va, uintptr_t end_va)
+{
+	for (;;) {
+		mm_a = mmap_next_region_in_range(mm_a, base_va, end_va);
+		mm_b = mmap_next_region_in_range(mm_b, base_va, end_va);
+
+		if (!mm_a->size || !mm_b->size)
+			return !mm_a->size && !mm_b->size;
+
+		if ((mm_a->base_pa != mm_b->base_pa) ||
+		    (mm_a->base_va != mm_b->base_va) ||
+		    (mm_a->size != mm_b->size) ||
+		    (mm_a->attr != mm_b->attr))
+			return 0;
+
+		mm_a++;
+		mm_b++;
+	}
+}
+
+/*
+ * Returns 1 if xlat_tables_map_region() creates a subtable in the specified
+ * table entry when mapping the regions of the context, 0 if it writes a block
+ * descriptor or nothing. The first region that intersects the entry decides
+ * it, as the regions mapped after it never replace a block descriptor.
+ */
+static int xlat_entry_needs_subtable(xlat_ctx_t *ctx, uintptr_t base_va,
+				     int level)
+{
+	uintptr_t end_va = base_va + XLAT_BLOCK_SIZE(level) - 1;
+	const mmap_region_t *mm;
+	unsigned long long pa;
+
+	if (level == XLAT_TABLE_LEVEL_MAX)
+		return 0;
+
+	mm = mmap_next_region_in_range(ctx->mmap, base_va, end_va);
+	if (!mm->size)
+		return 0;
+
+	pa = mm->base_pa + base_va - mm->base_va;
+
+	return (mm->base_va > base_va) ||
+	       (mm->base_va + mm->size - 1 < end_va) ||
+	       (pa & XLAT_BLOCK_MASK(level)) ||
+	       (level < MIN_LVL_BLOCK_DESC);
+}
+
+/* Records that the entries of the specified VA range have been imported. */
+static void xlat_tables_record_imported(xlat_ctx_t *ctx, uintptr_t base_va,
+					uintptr_t end_va)
+{
+	int n = ctx->imported_num;
+
+	/* The entries are imported in ascending VA order. */
+	if ((n > 0) && (ctx->imported_end_va[n - 1] + 1 == base_va)) {
+		ctx->imported_end_va[n - 1] = end_va;
+	} else if (n < XLAT_IMPORTED_RANGES_MAX) {
+		ctx->imported_base_va[n] = base_va;
+		ctx->imported_end_va[n] = end_va;
+		ctx->imported_num++;
+	}
+}
+
+/* Returns 1 if all the entries of the region have been imported, else 0. */
+static int xlat_tables_region_is_imported(xlat_ctx_t *ctx,
+					  const mmap_region_t *mm)
+{
+	uintptr_t end_va = mm->base_va + mm->size - 1;
+
+	for (int i = 0; i < ctx->imported_num; i++) {
+		if ((mm->base_va >= ctx->imported_base_va[i]) &&
+		    (end_va <= ctx->imported_end_va[i]))
+			return 1;
+	}
+
+	return 0;
+}
+
+/*
+ * Converts a block or page descriptor of the previous image to the translation
+ * regime of the current one. Only the execute-never bits may differ.
+ */
+static uint64_t xlat_import_desc(xlat_ctx_t *ctx, uint64_t desc)
+{
+	uint64_t src_xn = ctx->handoff->execute_never_mask;
+
+	if (((desc & DESC_MASK) != INVALID_DESC) && (desc & src_xn))
+		desc = (desc & ~src_xn) | ctx->execute_never_mask;
+
+	return desc;
+}
+
+/*
+ * Copies a whole table of the previous image, and the subtables it points to,
+ * into new tables of the context.
+ */
+static void xlat_tables_import_subtree(xlat_ctx_t *ctx, const uint64_t *src,
+				       uint64_t *dst, int level)
+{
+	for (int i = 0; i < XLAT_TABLE_ENTRIES; i++) {
+		uint64_t desc = src[i];
+
+		if ((level < XLAT_TABLE_LEVEL_MAX) &&
+		    ((desc & DESC_MASK) == TABLE_DESC)) {
+			uint64_t *subtable = xlat_table_get_empty(ctx);
+
+			dst[i] = TABLE_DESC | (unsigned long)subtable;
+			xlat_tables_import_subtree(ctx,
+				(uint64_t *)(uintptr_t)(desc & TABLE_ADDR_MASK),
+				subtable, level + 1);
+		} else {
+			dst[i] = xlat_import_desc(ctx, desc);
+		}
+	}
+}
+
+/*
+ * Recursive function that copies the entries of the tables of the previous
+ * image whose VA range is covered by the same regions in both images. When the
+ * regions differ, it only recurses into the subtables that the current image
+ * would create anyway. The entries left invalid are built afterwards by
+ * mapping the regions of the context as usual.
+ */
+static void xlat_tables_import_table(xlat_ctx_t *ctx, const uint64_t *src,
+				     uint64_t *dst, const int table_entries,
+				     const int level,
+				     const uintptr_t table_base_va)
+{
+	for (int i = 0; i < table_entries; i++) {
+		uintptr_t base_va = table_base_va + i * XLAT_BLOCK_SIZE(level);
+		uintptr_t end_va = base_va + XLAT_BLOCK_SIZE(level) - 1;
+		uint64_t desc = src[i];
+		int src_is_table = (level < XLAT_TABLE_LEVEL_MAX) &&
+				   ((desc & DESC_MASK) == TABLE_DESC);
+		uint64_t *subtable;
+
+		if (mmap_regions_match_in_range(ctx->mmap, ctx->handoff->mmap,
+						base_va, end_va)) {
+			if (src_is_table) {
+				subtable = xlat_table_get_empty(ctx);
+				dst[i] = TABLE_DESC | (unsigned long)subtable;
+				xlat_tables_import_subtree(ctx,
+					(uint64_t *)(uintptr_t)
+						(desc & TABLE_ADDR_MASK),
+					subtable, level + 1);
+			} else {
+				dst[i] = xlat_import_desc(ctx, desc);
+			}
+
+			xlat_tables_record_imported(ctx, base_va, end_va);
+
+		} else if (src_is_table &&
+			   xlat_entry_needs_subtable(ctx, base_va, level)) {
+			subtable = xlat_table_get_empty(ctx);
+			dst[i] = TABLE_DESC | (unsigned long)subtable;
+			xlat_tables_import_table(ctx,
+				(uint64_t *)(uintptr_t)(desc & TABLE_ADDR_MASK),
+				subtable, XLAT_TABLE_ENTRIES, level + 1,
+				base_va);
+		}
+	}
+}
+
+void xlat_tables_export_ctx(xlat_ctx_t *ctx, xlat_tables_handoff_t *handoff)
+{
+	assert(ctx->initialized);
+
+	handoff->mmap = ctx->mmap;
+	handoff->base_table = ctx->base_table;
+	handoff->base_table_entries = ctx->base_table_entries;
+	handoff->base_level = ctx->base_level;
+	handoff->execute_never_mask = ctx->execute_never_mask;
+
+	/* The next image reads all of them with the MMU disabled. */
+	flush_dcache_range((uintptr_t)ctx->mmap,
+			   (ctx->mmap_num + 1) * sizeof(mmap_region_t));
+	flush_dcache_range((uintptr_t)ctx->base_table,
+			   ctx->base_table_entries * sizeof(uint64_t));
+	flush_dcache_range((uintptr_t)ctx->tables,
+			   ctx->next_table * XLAT_TABLE_SIZE);
+	flush_dcache_range((uintptr_t)handoff, sizeof(*handoff));
+}
+
+#endif /* XLAT_TABLES_HANDOFF */
+
 void init_xlation_table(xlat_ctx_t *ctx)
 {
 	mmap_region_t *mm = ctx->mmap;
@@ -1064,7 +1683,34 @@ void init_xlation_table(xlat_ctx_t *ctx)
 			ctx->tables[j][i] = INVALID_DESC;
 	}
 
+	ctx->next_table = 0;
+#if PLAT_XLAT_TABLES_DYNAMIC
+	ctx->tables_used = 0;
+	ctx->tables_max_used = 0;
+#endif
+
+#if XLAT_TABLES_HANDOFF
+	if (ctx->handoff != NULL) {
+		if ((ctx->handoff->base_level != ctx->base_level) ||
+		    (ctx->handoff->base_table_entries !=
+		     ctx->base_table_entries)) {
+			WARN("Ignored translation tables of previous image\n");
+		} else {
+			xlat_tables_import_table(ctx, ctx->handoff->base_table,
+						 ctx->base_table,
+						 ctx->base_table_entries,
+						 ctx->base_level, 0);
+		}
+	}
+#endif
+
 	while (mm->size) {
+#if XLAT_TABLES_HANDOFF
+		if (xlat_tables_region_is_imported(ctx, mm)) {
+			mm++;
+			continue;
+		}
+#endif
 		uintptr_t end_va = xlat_tables_map_region(ctx, mm, 0, ctx->base_table,
 				ctx->base_table_entries, ctx->base_level);
 
@@ -1078,5 +1724,10 @@ void init_xlation_table(xlat_ctx_t *ctx)
 		mm++;
 	}
 
+#if PLAT_XLAT_TABLES_CONTIG_HINT
+	xlat_tables_set_contig_hint(ctx, 0, ctx->base_table,
+				    ctx->base_table_entries, ctx->base_level);
+#endif
+
 	ctx->initialized = 1;
 }
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <platform_def.h>
+#include <utils_def.h>
+#include <xlat_gen.h>
+#include <xlat_tables_v2.h>
+#ifdef AARCH32
+# include "aarch32/xlat_tables_arch.h"
+#else
+# include "aarch64/xlat_tables_arch.h"
+#endif
+#include "xlat_tables_private.h"
+
+/*
+ * This file isn't linked in any image. It is built together with the platform
+ * file pointed to by PLAT_XLAT_PREBUILT_SOURCE and read by the xlat_gen tool to
+ * build the translation tables of the image when XLAT_TABLES_PREBUILT is set.
+ */
+
+/* Must match the value returned by xlat_arch_get_xn_desc() at runtime. */
+#if defined(AARCH32) || defined(IMAGE_BL1) || defined(IMAGE_BL31) || \
+    (defined(IMAGE_BL2) && BL2_AT_EL3)
+# define XLAT_PREBUILT_XN_DESC	UPPER_ATTRS(XN)
+#else
+# define XLAT_PREBUILT_XN_DESC	UPPER_ATTRS(PXN)
+#endif
+
+const xlat_gen_params_t xlat_gen_params __section(XLAT_GEN_PARAMS_SECTION) = {
+	.va_max_address = PLAT_VIRT_ADDR_SPACE_SIZE - 1,
+	.pa_max_address = PLAT_PHY_ADDR_SPACE_SIZE - 1,
+	.max_tables = MAX_XLAT_TABLES,
+	.base_level = XLAT_TABLE_LEVEL_BASE,
+	.base_table_entries = NUM_BASE_LEVEL_ENTRIES,
+	.min_block_level = MIN_LVL_BLOCK_DESC,
+	.execute_never_mask = XLAT_PREBUILT_XN_DESC,
+};
@@ -34,6 +34,22 @@ CASSERT(IS_POWER_OF_TWO(PLAT_VIRT_ADDR_SPACE_SIZE),
 CASSERT(IS_POWER_OF_TWO(PLAT_PHY_ADDR_SPACE_SIZE),
 	assert_valid_phy_addr_space_size);
 
+#if PLAT_XLAT_TABLES_DYNAMIC
+/*
+ * Maximum number of TLB invalidations by VA that are deferred to the end of an
+ * update of the translation tables.
+ */
+#define XLAT_TLBI_PENDING_MAX	16
+#endif /* PLAT_XLAT_TABLES_DYNAMIC */
+
+#if XLAT_TABLES_HANDOFF
+/*
+ * Maximum number of VA ranges whose entries are recorded as copied from the
+ * tables of the previous image.
+ */
+#define XLAT_IMPORTED_RANGES_MAX	16
+#endif /* XLAT_TABLES_HANDOFF */
+
 /* Struct that holds all information about the translation tables. */
 typedef struct {
 
@@ -67,8 +83,37 @@ typedef struct {
 	 */
 #if PLAT_XLAT_TABLES_DYNAMIC
 	int *tables_mapped_regions;
+
+	/*
+	 * Set between mmap_dynamic_batch_start_ctx() and
+	 * mmap_dynamic_batch_end_ctx(). The barriers and TLB invalidations
+	 * needed by the dynamic region updates are then deferred to the end of
+	 * the batch.
+	 */
+	int batch_in_progress;
+
+	/*
+	 * Virtual addresses whose TLB entries have to be invalidated. When
+	 * more than XLAT_TLBI_PENDING_MAX are pending, all the TLB entries of
+	 * the translation regime are invalidated instead.
+	 */
+	uintptr_t tlbi_pending_va[XLAT_TLBI_PENDING_MAX];
+	int tlbi_pending_num;
+
+	/*
+	 * Number of subtables currently mapping at least one region, and
+	 * maximum number of them in use at the same time since the tables
+	 * were initialized.
+	 */
+	int tables_used;
+	int tables_max_used;
 #endif /* PLAT_XLAT_TABLES_DYNAMIC */
 
+	/*
+	 * Static contexts take the subtables in order and never give them
+	 * back, so this is the number of subtables used. Dynamic contexts
+	 * keep here the index of the first subtable that may be free.
+	 */
 	int next_table;
 
 	/*
@@ -92,6 +137,23 @@ typedef struct {
 	/* Set to 1 when the translation tables are initialized. */
 	int initialized;
 
+#if XLAT_TABLES_HANDOFF
+	/*
+	 * Translation tables of the previous image to copy entries from when
+	 * initializing the tables, or NULL.
+	 */
+	const xlat_tables_handoff_t *handoff;
+
+	/*
+	 * VA ranges whose entries have been copied from the tables of the
+	 * previous image. The regions that are fully inside one of them don't
+	 * have to be mapped again.
+	 */
+	uintptr_t imported_base_va[XLAT_IMPORTED_RANGES_MAX];
+	uintptr_t imported_end_va[XLAT_IMPORTED_RANGES_MAX];
+	int imported_num;
+#endif /* XLAT_TABLES_HANDOFF */
+
 	/*
 	 * Bit mask that has to be ORed to the rest of a translation table
 	 * descriptor in order to prohibit execution of code at the exception
@@ -101,6 +163,29 @@ typedef struct {
 
 } xlat_ctx_t;
 
+/*
+ * Function used to invalidate all levels of the translation walk for a given
+ * virtual address. It must be called for every translation table entry that is
+ * modified, after a dsbishst() ensuring that the entry has been written.
+ */
+void xlat_arch_tlbi_va(uintptr_t va);
+
+/*
+ * Function used to invalidate all the TLB entries of the translation regime,
+ * instead of calling xlat_arch_tlbi_va() for a large number of entries.
+ */
+void xlat_arch_tlbi_all(void);
+
+/*
+ * This function has to be called at the end of any code that uses the function
+ * xlat_arch_tlbi_va().
+ */
+void xlat_arch_tlbi_va_sync(void);
+
+/* Change the attributes of pages mapped by the specified context. */
+int change_mem_attributes_ctx(xlat_ctx_t *ctx, uintptr_t base_va, size_t size,
+			      mmap_attr_t attr);
+
 #if PLAT_XLAT_TABLES_DYNAMIC
 /*
  * Shifts and masks to access fields of an mmap_attr_t
@@ -125,19 +210,6 @@ typedef enum  {
 	MT_DYNAMIC	= 1 << MT_DYN_SHIFT
 } mmap_priv_attr_t;
 
-/*
- * Function used to invalidate all levels of the translation walk for a given
- * virtual address. It must be called for every translation table entry that is
- * modified.
- */
-void xlat_arch_tlbi_va(uintptr_t va);
-
-/*
- * This function has to be called at the end of any code that uses the function
- * xlat_arch_tlbi_va().
- */
-void xlat_arch_tlbi_va_sync(void);
-
 /* Add a dynamic region to the specified context. */
 int mmap_add_dynamic_region_ctx(xlat_ctx_t *ctx, mmap_region_t *mm);
 
@@ -145,8 +217,43 @@ int mmap_add_dynamic_region_ctx(xlat_ctx_t *ctx, mmap_region_t *mm);
 int mmap_remove_dynamic_region_ctx(xlat_ctx_t *ctx, uintptr_t base_va,
 			size_t size);
 
+/* Start and end a batch of dynamic region updates in the specified context. */
+void mmap_dynamic_batch_start_ctx(xlat_ctx_t *ctx);
+void mmap_dynamic_batch_end_ctx(xlat_ctx_t *ctx);
+
 #endif /* PLAT_XLAT_TABLES_DYNAMIC */
 
+#if XLAT_TABLES_PREBUILT
+
+#if PLAT_XLAT_TABLES_DYNAMIC
+# error "XLAT_TABLES_PREBUILT can't be used with PLAT_XLAT_TABLES_DYNAMIC"
+#endif
+
+/*
+ * Translation tables of the image and regions mapped by them, generated at
+ * build time by the xlat_gen tool from the regions listed in the file pointed
+ * to by PLAT_XLAT_PREBUILT_SOURCE.
+ */
+extern uint64_t xlat_prebuilt_tables[][XLAT_TABLE_ENTRIES];
+extern uint64_t xlat_prebuilt_base_table[];
+extern const int xlat_prebuilt_tables_num;
+extern const unsigned long long xlat_prebuilt_max_pa;
+extern const unsigned long long xlat_prebuilt_max_va;
+extern const mmap_region_t xlat_prebuilt_regions[];
+
+#endif /* XLAT_TABLES_PREBUILT */
+
+#if XLAT_TABLES_HANDOFF
+
+#if PLAT_XLAT_TABLES_DYNAMIC || XLAT_TABLES_PREBUILT
+# error "XLAT_TABLES_HANDOFF only supports tables built at runtime statically"
+#endif
+
+/* Describe the tables of the specified context in 'handoff'. */
+void xlat_tables_export_ctx(xlat_ctx_t *ctx, xlat_tables_handoff_t *handoff);
+
+#endif /* XLAT_TABLES_HANDOFF */
+
 /* Print VA, PA, size and attributes of all regions in the mmap array. */
 void print_mmap(mmap_region_t *const mmap);
 
@@ -156,6 +263,12 @@ void print_mmap(mmap_region_t *const mmap);
  */
 void xlat_tables_print(xlat_ctx_t *ctx);
 
+/*
+ * Returns the maximum number of subtables of the specified context in use at
+ * the same time since its tables were initialized.
+ */
+int xlat_tables_get_max_used_ctx(xlat_ctx_t *ctx);
+
 /*
  * Initialize the translation tables by mapping all regions added to the
  * specified context.
@@ -244,6 +244,32 @@ define MAKE_OBJS
 endef
 
 
+# MAKE_XLAT_PREBUILT generates the translation tables of a BL image with the
+# xlat_gen tool and builds them. The object read by the tool is made of the
+# platform regions and of the parameters of the translation context.
+#   $(1) = output directory
+#   $(2) = BL stage (2, 2u, 30, 31, 32, 33)
+define MAKE_XLAT_PREBUILT
+
+$(eval XLAT_IN  := $(1)/xlat_tables_prebuilt_in.o)
+$(eval XLAT_ASM := $(1)/xlat_tables_prebuilt.S)
+$(eval IMAGE := IMAGE_BL$(call uppercase,$(2)))
+
+$(XLAT_IN): $(PLAT_XLAT_PREBUILT_SOURCE) lib/xlat_tables_v2/xlat_tables_prebuilt_params.c | bl$(2)_dirs
+	@echo "  CC      $(PLAT_XLAT_PREBUILT_SOURCE)"
+	$$(Q)$$(CC) $$(TF_CFLAGS) $$(CFLAGS) -D$(IMAGE) -c $(PLAT_XLAT_PREBUILT_SOURCE) -o $(1)/xlat_prebuilt_mmap.o
+	$$(Q)$$(CC) $$(TF_CFLAGS) $$(CFLAGS) -D$(IMAGE) -c lib/xlat_tables_v2/xlat_tables_prebuilt_params.c -o $(1)/xlat_prebuilt_params.o
+	$$(Q)$$(LD) -r $(1)/xlat_prebuilt_mmap.o $(1)/xlat_prebuilt_params.o -o $$@
+
+$(XLAT_ASM): $(XLAT_IN) $(XLAT_GEN)
+	@echo "  XLATGEN $$@"
+	$$(Q)$(XLAT_GEN) $$< $$@
+
+$(eval $(call MAKE_S,$(1),$(XLAT_ASM),$(2)))
+
+endef
+
+
 # NOTE: The line continuation '\' is required in the next define otherwise we
 # end up with a line-feed characer at the end of the last c filename.
 # Also bear this issue in mind if extending the list of supported filetypes.
@@ -276,6 +302,7 @@ define MAKE_BL
         $(eval BL_SOURCES := $(BL$(call uppercase,$(1))_SOURCES))
         $(eval SOURCES    := $(BL_SOURCES) $(BL_COMMON_SOURCES) $(PLAT_BL_COMMON_SOURCES))
         $(eval OBJS       := $(addprefix $(BUILD_DIR)/,$(call SOURCES_TO_OBJS,$(SOURCES))))
+        $(eval OBJS       += $(if $(filter 1,$(XLAT_TABLES_PREBUILT)),$(BUILD_DIR)/xlat_tables_prebuilt.o))
         $(eval LINKERFILE := $(call IMG_LINKERFILE,$(1)))
         $(eval MAPFILE    := $(call IMG_MAPFILE,$(1)))
         $(eval ELF        := $(call IMG_ELF,$(1)))
@@ -302,6 +329,7 @@ $(eval $(foreach objd,${OBJ_DIRS},$(call MAKE_PREREQ_DIR,${objd},${BUILD_DIR})))
 bl${1}_dirs: | ${OBJ_DIRS}
 
 $(eval $(call MAKE_OBJS,$(BUILD_DIR),$(SOURCES),$(1)))
+$(if $(filter 1,$(XLAT_TABLES_PREBUILT)),$(eval $(call MAKE_XLAT_PREBUILT,$(BUILD_DIR),$(1))))
 $(eval $(call MAKE_LD,$(LINKERFILE),$(BL_LINKERFILE),$(1)))
 
 $(ELF): $(OBJS) $(LINKERFILE) | bl$(1)_dirs
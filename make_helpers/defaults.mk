@@ -31,13 +31,26 @@ ARM_GIC_ARCH			:= 2
 # Flag used to indicate if ASM_ASSERTION should be enabled for the build.
 ASM_ASSERTION			:= 0
 
+# Use the assembly versions of memcpy, memset and memcmp in all BL images
+ASM_MEM_FUNCS			:= 0
+
 # Base commit to perform code check on
 BASE_COMMIT			:= origin/master
 
+# Make BL2 the reset image, running at EL3 in place of BL1
+BL2_AT_EL3			:= 0
+
 # By default, consider that the platform may release several CPUs out of reset.
 # The platform Makefile is free to override this value.
 COLD_BOOT_SINGLE_CPU		:= 0
 
+# Flag to output the console buffers of the CPUs from the transmit interrupt of
+# the console instead of when they are full or the CPUs go idle
+CONSOLE_BUFFER_TX_IRQ		:= 0
+
+# Flag to write a binary record of the CPU state to retained memory on a crash
+CRASH_DUMP_BUFFER		:= 0
+
 # For Chain of Trust
 CREATE_KEYS			:= 1
 
@@ -48,43 +61,112 @@ CTX_INCLUDE_AARCH32_REGS	:= 1
 # Include FP registers in cpu context
 CTX_INCLUDE_FPREGS		:= 0
 
+# Switch the FP registers between the security states on first use only
+CTX_LAZY_FPREGS			:= 0
+
+# Leave the registers that the Secure Payload does not write out of the EL1
+# system register context switches. The SPD makefile sets this when its SP
+# qualifies.
+CTX_SKIP_SP_UNUSED_SYSREGS	:= 0
+
 # Debug build
 DEBUG				:= 0
 
 # Build platform
 DEFAULT_PLAT			:= fvp
 
+# Flag to dispatch the EL3 interrupts by priority level through the EL3
+# exception handling framework
+EL3_EXCEPTION_HANDLING		:= 0
+
+# Flag to let BL31 call functions on other CPUs through a Secure SGI
+EL3_SMP_CALL			:= 0
+
+# Flag to record the boot milestones of every image using PMF
+ENABLE_BOOT_PROFILE		:= 0
+
+# Flag to buffer the console output of each CPU in BL31 at runtime
+ENABLE_CONSOLE_BUFFER		:= 0
+
+# Flag to report the time taken by the data cache maintenance by set/way of
+# each cache level during the BL31 cold boot
+ENABLE_DCSW_BENCHMARK		:= 0
+
 # Flag to enable Performance Measurement Framework
 ENABLE_PMF			:= 0
 
+# Flag to enable the PSCI CPU_FREEZE API
+ENABLE_PSCI_CPU_FREEZE		:= 0
+
 # Flag to enable PSCI STATs functionality
 ENABLE_PSCI_STAT		:= 0
 
 # Flag to enable runtime instrumentation using PMF
 ENABLE_RUNTIME_INSTRUMENTATION	:= 0
 
+# Flag to enable the per-CPU SMC latency histograms
+ENABLE_SMC_LATENCY_STATS	:= 0
+
+# Flag to service the leaf SMCs without the full context save and restore
+ENABLE_SMC_LEAF_HANDLERS	:= 0
+
+# Flag to run the secure partitions declared by the platform at S-EL0
+ENABLE_SPM			:= 0
+
 # Flag to enable stack corruption protection
 ENABLE_STACK_PROTECTOR		:= 0
 
+# Flag to enable the run-time measurement of the BL31 stack usage of each CPU
+ENABLE_STACK_WATERMARK		:= 0
+
+# Flag to record the trace events of BL31 in per-CPU binary rings
+ENABLE_TRACE_EVENTS		:= 0
+
 # Build flag to treat usage of deprecated platform and framework APIs as error.
 ERROR_DEPRECATED		:= 0
 
 # Byte alignment that each component in FIP is aligned to
 FIP_ALIGN			:= 0
 
+# Compress the images in the FIP with LZ4 and let the FIP driver decompress
+# them while they are read
+FIP_COMPRESS_LZ4		:= 0
+
 # Default FIP file name
 FIP_NAME			:= fip.bin
 
+# Keep the FIP backend open across image loads instead of reopening it for
+# every read
+FIP_PERSISTENT_BACKEND		:= 0
+
 # Default FWU_FIP file name
 FWU_FIP_NAME			:= fwu_fip.bin
 
 # For Chain of Trust
 GENERATE_COT			:= 0
 
+# Flag to let the GICv3 driver classify the SGIs, PPIs and SPIs from bitmaps
+# built out of the platform interrupt arrays instead of reading the GIC
+GICV3_INTR_TYPE_CACHE		:= 0
+
+# Flag to route the External Aborts and SError interrupts to EL3
+HANDLE_EA_EL3_FIRST		:= 0
+
 # Whether system coherency is managed in hardware, without explicit software
 # operations.
 HW_ASSISTED_COHERENCY		:= 0
 
+# Flag to keep the statistics of the reads from each IO device
+IO_STORAGE_STATS		:= 0
+
+# Flag to authenticate the certificates where they sit in memory-mapped storage
+# instead of copying them
+LOAD_CERT_IN_PLACE		:= 0
+
+# Flag to read the next image from storage while BL2 authenticates the
+# current one
+LOAD_IMAGE_PIPELINE		:= 0
+
 # Flag to enable new version of image loading
 LOAD_IMAGE_V2			:= 0
 
@@ -94,20 +176,70 @@ NS_TIMER_SWITCH			:= 0
 # Build PL011 UART driver in minimal generic UART mode
 PL011_GENERIC_UART		:= 0
 
+# Flag to let the normal world register a buffer into which the PMF time-stamps
+# of a service are copied for all the CPUs by a single SMC
+PMF_NS_BUFFER			:= 0
+
 # By default, consider that the platform's reset address is not programmable.
 # The platform Makefile is free to override this value.
 PROGRAMMABLE_RESET_ADDRESS	:= 0
 
+# Keep the per-CPU PSCI state, including the requested local power states, in
+# per-CPU cache lines
+PSCI_CACHE_ALIGNED_STATE	:= 0
+
+# Flag to provide a generic PSCI function turning on several CPUs at once,
+# exposed by the ARM platforms as a SiP call
+PSCI_CPU_ON_MULTI		:= 0
+
 # Flag used to choose the power state format viz Extended State-ID or the
 # Original format.
 PSCI_EXTENDED_STATE_ID		:= 0
 
+# Flag to enable support for the OS-initiated mode of CPU_SUSPEND and the
+# PSCI_SET_SUSPEND_MODE API
+PSCI_OS_INIT_MODE		:= 0
+
+# Flag to let the normal world copy a snapshot of the power domain tree, with
+# the lock and residency statistics of each power domain, with one SiP call
+PSCI_PD_SNAPSHOT		:= 0
+
+# Count the CPUs requesting the run state in each power domain to shorten the
+# state coordination
+PSCI_RUN_CPU_COUNTS		:= 0
+
+# Let the PSCI implementation demote the CPU_SUSPEND requests for the power
+# domains above the CPU using the past residencies of the CPU
+PSCI_SUSPEND_GOVERNOR		:= 0
+
+# Let CPU_SUSPEND skip the locks of the power domains that are kept running by
+# the other CPUs
+PSCI_SUSPEND_LOCK_ELISION	:= 0
+
+# Use ticket locks instead of spinlocks for the PSCI power domain locks on
+# systems with hardware assisted coherency
+PSCI_TICKET_LOCKS		:= 0
+
+# Flag to record the errors of the RAS error records of the platform in BL31
+RAS_EXTENSION			:= 0
+
+# Reuse the memory of the BL31 code only run during the cold boot for the data
+# only used at runtime
+RECLAIM_INIT_CODE		:= 0
+
 # By default, BL1 acts as the reset handler, not BL31
 RESET_TO_BL31			:= 0
 
+# Flag to authenticate the copy of an image left in memory by the previous boot
+# instead of loading it again, when the platform reports it as preserved
+REUSE_PRESERVED_IMAGES		:= 0
+
 # For Chain of Trust
 SAVE_KEYS			:= 0
 
+# Software Delegated Exception Interface support
+SDEI_SUPPORT			:= 0
+
 # Whether code and read-only data should be put on separate memory pages. The
 # platform Makefile is free to override this value.
 SEPARATE_CODE_AND_RODATA	:= 0
@@ -115,10 +247,23 @@ SEPARATE_CODE_AND_RODATA	:= 0
 # SPD choice
 SPD				:= none
 
+# Flag to let the SP notify the normal world asynchronously with the SGI
+# PLAT_SPD_NOTIFY_SGI, through the SPDs that support it.
+SPD_NS_NOTIFY			:= 0
+
+# Flag to inject the non-secure interrupts that preempt the SP into the normal
+# world, which replays the preempted SMC to resume the SP once it has handled
+# them. Only used by the SPDs that let these interrupts preempt the SP at EL3.
+SPD_NS_INTR_INJECT		:= 0
+
 # Flag to introduce an infinite loop in BL1 just before it exits into the next
 # image. This is meant to help debugging the post-BL2 phase.
 SPIN_ON_BL1_EXIT		:= 0
 
+# Flag to let spin_lock() use the LSE atomics on the CPUs that implement them
+# when compiling for ARMv8.0
+SPINLOCK_DETECT_LSE		:= 0
+
 # Flags to build TF with Trusted Boot support
 TRUSTED_BOARD_BOOT		:= 0
 
@@ -136,3 +281,18 @@ V				:= 0
 # required to enable cache coherency after warm reset (eg: single cluster
 # platforms).
 WARMBOOT_ENABLE_DCACHE_EARLY	:= 0
+
+# Let BL31 enable the MMU on warm boot straight from the register values
+# computed on cold boot, instead of calling bl31_plat_enable_mmu()
+WARMBOOT_ENABLE_MMU_DIRECT	:= 0
+
+# Size in bytes of the translation granule: 4096, 16384 or 65536
+XLAT_GRANULE_SIZE		:= 4096
+
+# Let BL2 hand its translation tables over to BL31, which reuses the parts that
+# map the same regions instead of building them again
+XLAT_TABLES_HANDOFF		:= 0
+
+# Build the translation tables of the BL images at build time from the static
+# regions listed in PLAT_XLAT_PREBUILT_SOURCE instead of at runtime
+XLAT_TABLES_PREBUILT		:= 0
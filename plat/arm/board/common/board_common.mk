@@ -22,6 +22,11 @@ ifneq (${TRUSTED_BOARD_BOOT},0)
         ARM_ROTPK_LOCATION_ID = ARM_ROTPK_REGS_ID
     else ifeq (${ARM_ROTPK_LOCATION}, devel_rsa)
         ARM_ROTPK_LOCATION_ID = ARM_ROTPK_DEVEL_RSA_ID
+    else ifeq (${ARM_ROTPK_LOCATION}, devel_ecdsa)
+        ifneq (${KEY_ALG},ecdsa)
+            $(error "ARM_ROTPK_LOCATION=devel_ecdsa requires KEY_ALG=ecdsa")
+        endif
+        ARM_ROTPK_LOCATION_ID = ARM_ROTPK_DEVEL_ECDSA_ID
     else
         $(error "Unsupported ARM_ROTPK_LOCATION value")
     endif
@@ -77,6 +77,10 @@
 /* Mailbox base address */
 #define PLAT_ARM_TRUSTED_MAILBOX_BASE	ARM_TRUSTED_SRAM_BASE
 
+/* Boot profile time-stamps, in the upper half of the shared RAM */
+#define PLAT_BOOT_PROF_BASE		(ARM_SHARED_RAM_BASE + 0x800)
+#define PLAT_BOOT_PROF_SIZE		0x800
+
 
 /* TrustZone controller related constants
  *
@@ -67,6 +67,11 @@
 #define MMU401_SSD_OFFSET		0x4000
 #define MMU401_DMA330_BASE		0x7fb00000
 
+/*******************************************************************************
+ * DMA-330 related constants
+ ******************************************************************************/
+#define DMA330_BASE			0x7ff00000
+
 /*******************************************************************************
  * Interrupt handling constants
  ******************************************************************************/
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arm_def.h>
+#include <errno.h>
+#include <io_memmap.h>
+#include <pl330.h>
+#include <plat_arm.h>
+#include "juno_def.h"
+
+/* DMA-330 channel used to copy the images */
+#define JUNO_DMA330_CHANNEL		0
+
+/*
+ * The DMA-330 is used for the reads of at least this size. Smaller reads, such
+ * as the FIP ToC and the certificates, are faster to copy with the CPU.
+ */
+#define JUNO_DMA_COPY_MIN_LENGTH	0x10000
+
+/*
+ * The channel program is written at the end of the Non-secure DRAM, which is
+ * not used by the images loaded by BL2.
+ */
+#define JUNO_DMA330_PROG_BASE		(ARM_NS_DRAM1_END + 1 - PL330_PROG_SIZE)
+
+static int juno_dma_copy(uintptr_t dst, uintptr_t src, size_t length)
+{
+	/*
+	 * The MMU-401 makes all the transfers of the DMA-330 Non-secure, so it
+	 * can only copy the images loaded in Non-secure DRAM, such as BL33.
+	 */
+	if ((dst < ARM_NS_DRAM1_BASE) || (dst + length - 1 > ARM_NS_DRAM1_END))
+		return -EPERM;
+
+	return pl330_copy(dst, src, length);
+}
+
+static io_memmap_dev_spec_t juno_memmap_dev_spec = {
+	.copy = juno_dma_copy,
+	.min_length = JUNO_DMA_COPY_MIN_LENGTH,
+};
+
+/* Copy the large images read from the NOR flash with the DMA-330 */
+uintptr_t plat_arm_get_memmap_dev_spec(void)
+{
+	pl330_init(DMA330_BASE, JUNO_DMA330_CHANNEL, JUNO_DMA330_PROG_BASE, 1);
+	juno_memmap_dev_spec.align = pl330_get_copy_align();
+
+	return (uintptr_t)&juno_memmap_dev_spec;
+}
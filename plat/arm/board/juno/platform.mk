@@ -31,6 +31,10 @@ JUNO_AARCH32_EL3_RUNTIME	:=	0
 $(eval $(call assert_boolean,JUNO_AARCH32_EL3_RUNTIME))
 $(eval $(call add_define,JUNO_AARCH32_EL3_RUNTIME))
 
+# Flag to copy the images read from the NOR flash with the DMA-330 in BL2
+JUNO_DMA_COPY			:=	0
+$(eval $(call assert_boolean,JUNO_DMA_COPY))
+
 ifeq (${ARCH},aarch64)
 BL1_SOURCES		+=	lib/cpus/aarch64/cortex_a53.S		\
 				lib/cpus/aarch64/cortex_a57.S		\
@@ -44,6 +48,11 @@ BL2_SOURCES		+=	plat/arm/board/juno/juno_err.c		\
 				plat/arm/board/juno/juno_bl2_setup.c	\
 				${JUNO_SECURITY_SOURCES}
 
+ifeq (${JUNO_DMA_COPY},1)
+BL2_SOURCES		+=	drivers/arm/pl330/pl330.c		\
+				plat/arm/board/juno/juno_dma.c
+endif
+
 BL2U_SOURCES		+=	${JUNO_SECURITY_SOURCES}
 
 BL31_SOURCES		+=	lib/cpus/aarch64/cortex_a53.S		\
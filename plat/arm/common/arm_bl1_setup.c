@@ -9,6 +9,7 @@
 #include <arm_xlat_tables.h>
 #include <bl_common.h>
 #include <console.h>
+#include <mmio.h>
 #include <platform_def.h>
 #include <plat_arm.h>
 #include <sp805.h>
@@ -113,6 +114,15 @@ void bl1_plat_arch_setup(void)
  */
 void arm_bl1_platform_setup(void)
 {
+#if ENABLE_BOOT_PROFILE
+	/*
+	 * Enable the system counter now rather than in BL31 so that the
+	 * milestones of BL1 and BL2 are time-stamped.
+	 */
+	mmio_write_32(ARM_SYS_CNTCTL_BASE + CNTCR_OFF,
+			CNTCR_FCREQ(0) | CNTCR_EN);
+#endif
+
 	/* Initialise the IO layer and register platform IO devices */
 	plat_arm_io_setup();
 }
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch.h>
+#include <arm_def.h>
+#include <bl_common.h>
+#include <console.h>
+#include <mmio.h>
+#include <plat_arm.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <sp805.h>
+
+/* Weak definitions may be overridden in specific ARM standard platform */
+#pragma weak bl2_el3_early_platform_setup
+#pragma weak bl2_el3_plat_arch_setup
+#pragma weak bl2_el3_plat_prepare_exit
+
+/*******************************************************************************
+ * Perform the early platform setup of BL1 and BL2 shared between ARM standard
+ * platforms when BL2 is the reset image. There is no BL1 to pass the extents of
+ * the trusted SRAM, so BL2 sees the whole of it.
+ ******************************************************************************/
+void arm_bl2_el3_early_platform_setup(void)
+{
+	meminfo_t mem_layout = {
+		.total_base = ARM_BL_RAM_BASE,
+		.total_size = ARM_BL_RAM_SIZE
+	};
+
+#if !ARM_DISABLE_TRUSTED_WDOG
+	/* Enable watchdog */
+	sp805_start(ARM_SP805_TWDG_BASE, ARM_TWDG_LOAD_VAL);
+#endif
+
+#if ENABLE_BOOT_PROFILE
+	/*
+	 * Enable the system counter now rather than in BL31 so that the
+	 * milestones of BL2 are time-stamped.
+	 */
+	mmio_write_32(ARM_SYS_CNTCTL_BASE + CNTCR_OFF,
+			CNTCR_FCREQ(0) | CNTCR_EN);
+#endif
+
+	/* Initialise the console and the IO layer, and save the layout */
+	arm_bl2_early_platform_setup(&mem_layout);
+}
+
+void bl2_el3_early_platform_setup(u_register_t arg0, u_register_t arg1,
+				  u_register_t arg2, u_register_t arg3)
+{
+	arm_bl2_el3_early_platform_setup();
+
+	/*
+	 * Initialize Interconnect for this cluster during cold boot.
+	 * No need for locks as no other CPU is active.
+	 */
+	plat_arm_interconnect_init();
+	/*
+	 * Enable Interconnect coherency for the primary CPU's cluster.
+	 */
+	plat_arm_interconnect_enter_coherency();
+}
+
+/*******************************************************************************
+ * Set up the translation tables of BL2 and enable the MMU at EL3.
+ ******************************************************************************/
+void arm_bl2_el3_plat_arch_setup(void)
+{
+	arm_bl2_plat_arch_setup();
+}
+
+void bl2_el3_plat_arch_setup(void)
+{
+	arm_bl2_el3_plat_arch_setup();
+}
+
+void bl2_el3_plat_prepare_exit(const entry_point_info_t *ep_info)
+{
+#if !ARM_DISABLE_TRUSTED_WDOG
+	/* Disable watchdog before leaving BL2 */
+	sp805_stop(ARM_SP805_TWDG_BASE);
+#endif
+}
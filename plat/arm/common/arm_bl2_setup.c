@@ -20,6 +20,11 @@
 /* Data structure which holds the extents of the trusted SRAM for BL2 */
 static meminfo_t bl2_tzram_layout __aligned(CACHE_WRITEBACK_GRANULE);
 
+#if XLAT_TABLES_HANDOFF
+/* Description of the translation tables of BL2, reused by BL31 */
+static xlat_tables_handoff_t bl2_xlat_handoff;
+#endif
+
 /* Weak definitions may be overridden in specific ARM standard platform */
 #pragma weak bl2_early_platform_setup
 #pragma weak bl2_platform_setup
@@ -150,7 +155,9 @@ void bl2_plat_flush_bl31_params(void)
  ******************************************************************************/
 struct entry_point_info *bl2_plat_get_bl31_ep_info(void)
 {
-#if DEBUG
+#if XLAT_TABLES_HANDOFF
+	bl31_params_mem.bl31_ep_info.args.arg1 = (uintptr_t)&bl2_xlat_handoff;
+#elif DEBUG
 	bl31_params_mem.bl31_ep_info.args.arg1 = ARM_BL31_PLAT_PARAM_VAL;
 #endif
 
@@ -188,6 +195,10 @@ void arm_bl2_platform_setup(void)
 {
 	/* Initialize the secure environment */
 	plat_arm_security_setup();
+
+	/* The DRAM is intact after a warm reset requested by the OS */
+	if (arm_get_and_clear_warm_reset_flag())
+		INFO("BL2: Warm reset, DRAM content preserved\n");
 }
 
 void bl2_platform_setup(void)
@@ -213,8 +224,14 @@ void arm_bl2_plat_arch_setup(void)
 #endif
 			      );
 
+#if XLAT_TABLES_HANDOFF
+	xlat_tables_export(&bl2_xlat_handoff);
+#endif
+
 #ifdef AARCH32
 	enable_mmu_secure(0);
+#elif BL2_AT_EL3
+	enable_mmu_el3(0);
 #else
 	enable_mmu_el1(0);
 #endif
@@ -233,6 +250,13 @@ int arm_bl2_handle_post_image_load(unsigned int image_id)
 	assert(bl_mem_params);
 
 	switch (image_id) {
+#if XLAT_TABLES_HANDOFF
+	case BL31_IMAGE_ID:
+		/* BL31 reuses the translation tables of BL2 */
+		bl_mem_params->ep_info.args.arg1 = (uintptr_t)&bl2_xlat_handoff;
+		break;
+#endif
+
 #ifdef AARCH64
 	case BL32_IMAGE_ID:
 		bl_mem_params->ep_info.spsr = arm_get_spsr_for_bl32_entry();
@@ -12,6 +12,7 @@
 #include <console.h>
 #include <debug.h>
 #include <mmio.h>
+#include <ns_range.h>
 #include <plat_arm.h>
 #include <platform.h>
 
@@ -64,11 +65,11 @@ entry_point_info_t *bl31_plat_get_next_image_ep_info(uint32_t type)
  * we are guaranteed to pick up good data.
  ******************************************************************************/
 #if LOAD_IMAGE_V2
-void arm_bl31_early_platform_setup(void *from_bl2,
-				void *plat_params_from_bl2)
+void __init arm_bl31_early_platform_setup(void *from_bl2,
+					  void *plat_params_from_bl2)
 #else
-void arm_bl31_early_platform_setup(bl31_params_t *from_bl2,
-				void *plat_params_from_bl2)
+void __init arm_bl31_early_platform_setup(bl31_params_t *from_bl2,
+					  void *plat_params_from_bl2)
 #endif
 {
 	/* Initialize the console to provide early debug support */
@@ -107,6 +108,14 @@ void arm_bl31_early_platform_setup(bl31_params_t *from_bl2,
 
 #else /* RESET_TO_BL31 */
 
+#if XLAT_TABLES_HANDOFF
+	/*
+	 * BL2 passes the description of its translation tables in
+	 * 'plat_params_from_bl2' so that BL31 can reuse them.
+	 */
+	assert(plat_params_from_bl2 != NULL);
+	xlat_tables_import(plat_params_from_bl2);
+#else
 	/*
 	 * In debug builds, we pass a special value in 'plat_params_from_bl2'
 	 * to verify platform parameters from BL2 to BL31.
@@ -114,6 +123,7 @@ void arm_bl31_early_platform_setup(bl31_params_t *from_bl2,
 	 */
 	assert(((unsigned long long)plat_params_from_bl2) ==
 		ARM_BL31_PLAT_PARAM_VAL);
+#endif
 
 # if LOAD_IMAGE_V2
 	/*
@@ -165,11 +175,11 @@ void arm_bl31_early_platform_setup(bl31_params_t *from_bl2,
 }
 
 #if LOAD_IMAGE_V2
-void bl31_early_platform_setup(void *from_bl2,
-				void *plat_params_from_bl2)
+void __init bl31_early_platform_setup(void *from_bl2,
+				      void *plat_params_from_bl2)
 #else
-void bl31_early_platform_setup(bl31_params_t *from_bl2,
-				void *plat_params_from_bl2)
+void __init bl31_early_platform_setup(bl31_params_t *from_bl2,
+				      void *plat_params_from_bl2)
 #endif
 {
 	arm_bl31_early_platform_setup(from_bl2, plat_params_from_bl2);
@@ -194,7 +204,7 @@ void bl31_early_platform_setup(bl31_params_t *from_bl2,
 /*******************************************************************************
  * Perform any BL31 platform setup common to ARM standard platforms
  ******************************************************************************/
-void arm_bl31_platform_setup(void)
+void __init arm_bl31_platform_setup(void)
 {
 	/* Initialize the GIC driver, cpu and distributor interfaces */
 	plat_arm_gic_driver_init();
@@ -224,31 +234,62 @@ void arm_bl31_platform_setup(void)
  * Perform any BL31 platform runtime setup prior to BL31 exit common to ARM
  * standard platforms
  ******************************************************************************/
-void arm_bl31_plat_runtime_setup(void)
+void __init arm_bl31_plat_runtime_setup(void)
 {
 	/* Initialize the runtime console */
 	console_init(PLAT_ARM_BL31_RUN_UART_BASE, PLAT_ARM_BL31_RUN_UART_CLK_IN_HZ,
 			ARM_CONSOLE_BAUDRATE);
 }
 
-void bl31_platform_setup(void)
+void __init bl31_platform_setup(void)
 {
 	arm_bl31_platform_setup();
 }
 
-void bl31_plat_runtime_setup(void)
+void __init bl31_plat_runtime_setup(void)
 {
 	arm_bl31_plat_runtime_setup();
 }
 
+/*******************************************************************************
+ * Describe the memory to the index used to check the buffers passed by the
+ * normal world: the DRAM ranges configured by arm_tzc400_setup() and the
+ * regions mapped by BL31, according to their security attribute.
+ ******************************************************************************/
+static void __init arm_ns_range_setup(void)
+{
+	const mmap_region_t *mm = plat_arm_get_mmap();
+
+	ns_range_add(ARM_NS_DRAM1_BASE, ARM_NS_DRAM1_SIZE, NS_RANGE_NS);
+	ns_range_add(ARM_DRAM2_BASE, ARM_DRAM2_SIZE, NS_RANGE_NS);
+	ns_range_add(ARM_AP_TZC_DRAM1_BASE, ARM_AP_TZC_DRAM1_SIZE,
+		     NS_RANGE_SECURE);
+	ns_range_add(ARM_BL_RAM_BASE, ARM_BL_RAM_SIZE, NS_RANGE_SECURE);
+
+	for (; mm->size != 0; mm++) {
+		ns_range_add(mm->base_pa, mm->size,
+			     (mm->attr & MT_NS) ? NS_RANGE_NS :
+						  NS_RANGE_SECURE);
+	}
+}
+
 /*******************************************************************************
  * Perform the very early platform specific architectural setup shared between
  * ARM standard platforms. This only does basic initialization. Later
  * architectural setup (bl31_arch_setup()) does not do anything platform
  * specific.
  ******************************************************************************/
-void arm_bl31_plat_arch_setup(void)
+void __init arm_bl31_plat_arch_setup(void)
 {
+#ifdef PLAT_BL31_HOT_RAM_BASE
+	mmap_add_region(BL31_HOT_TEXT_BASE, BL31_HOT_TEXT_BASE,
+			BL31_HOT_TEXT_END - BL31_HOT_TEXT_BASE,
+			MT_CODE | MT_SECURE);
+	mmap_add_region(BL31_HOT_TEXT_END, BL31_HOT_TEXT_END,
+			round_up(BL31_HOT_RAM_END, PAGE_SIZE) -
+			BL31_HOT_TEXT_END,
+			MT_MEMORY | MT_RW | MT_SECURE);
+#endif
 	arm_setup_page_tables(BL31_BASE,
 			      BL31_END - BL31_BASE,
 			      BL_CODE_BASE,
@@ -261,9 +302,11 @@ void arm_bl31_plat_arch_setup(void)
 #endif
 			      );
 	enable_mmu_el3(0);
+
+	arm_ns_range_setup();
 }
 
-void bl31_plat_arch_setup(void)
+void __init bl31_plat_arch_setup(void)
 {
 	arm_bl31_plat_arch_setup();
 }
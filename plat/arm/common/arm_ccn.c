@@ -25,6 +25,15 @@ CASSERT(PLAT_ARM_CLUSTER_COUNT == ARRAY_SIZE(master_to_rn_id_map),
 /******************************************************************************
  * The following functions are defined as weak to allow a platform to override
  * the way ARM CCN driver is initialised and used.
+ *
+ * The L3 run mode is left to its reset value. None of the idle states of the
+ * ARM platforms using the CCN is a system level retention state, which is the
+ * only case where all the clusters are known to be idle while the L3 keeps
+ * its contents. A platform adding such a state can lower the run mode with
+ * ccn_set_l3_run_mode() from its suspend handler, once PSCI has selected that
+ * state for the system level, and restore it from its suspend finisher. The
+ * HN-Fs flush the L3 when its run mode is lowered, so this lengthens entry into
+ * the state.
  *****************************************************************************/
 #pragma weak plat_arm_interconnect_init
 #pragma weak plat_arm_interconnect_enter_coherency
@@ -195,3 +195,24 @@ unsigned int plat_get_syscnt_freq2(void)
 }
 
 #endif /* ARM_SYS_CNTCTL_BASE */
+
+/*******************************************************************************
+ * The warm reset flag is set by BL31 just before a PSCI SYSTEM_RESET2 warm
+ * reset, and read and cleared by BL2 on the next boot. It tells the boot flow
+ * that the content of the DRAM has been preserved through the reset.
+ ******************************************************************************/
+void arm_set_warm_reset_flag(void)
+{
+	mmio_write_64(ARM_WARM_RESET_FLAG_BASE, ARM_WARM_RESET_MAGIC);
+}
+
+int arm_get_and_clear_warm_reset_flag(void)
+{
+	int is_warm_reset;
+
+	is_warm_reset = (mmio_read_64(ARM_WARM_RESET_FLAG_BASE) ==
+			 ARM_WARM_RESET_MAGIC);
+	mmio_write_64(ARM_WARM_RESET_FLAG_BASE, 0);
+
+	return is_warm_reset;
+}
@@ -71,6 +71,14 @@ ARM_PLAT_MT			:=	0
 $(eval $(call assert_boolean,ARM_PLAT_MT))
 $(eval $(call add_define,ARM_PLAT_MT))
 
+# Process ARM_IO_SOURCE_BY_COST flag, which needs the statistics of the reads
+ARM_IO_SOURCE_BY_COST		:=	0
+$(eval $(call assert_boolean,ARM_IO_SOURCE_BY_COST))
+$(eval $(call add_define,ARM_IO_SOURCE_BY_COST))
+ifeq (${ARM_IO_SOURCE_BY_COST},1)
+  IO_STORAGE_STATS		:=	1
+endif
+
 # Use translation tables library v2 by default
 ARM_XLAT_TABLES_LIB_V1		:=	0
 $(eval $(call assert_boolean,ARM_XLAT_TABLES_LIB_V1))
@@ -105,6 +113,15 @@ PLAT_BL_COMMON_SOURCES	+=	plat/arm/common/${ARCH}/arm_helpers.S		\
 				plat/arm/common/arm_common.c
 
 ifeq (${ARM_XLAT_TABLES_LIB_V1}, 1)
+ifeq (${XLAT_TABLES_HANDOFF}, 1)
+$(error "XLAT_TABLES_HANDOFF requires the version 2 of the translation table library")
+endif
+ifeq (${WARMBOOT_ENABLE_MMU_DIRECT}, 1)
+$(error "WARMBOOT_ENABLE_MMU_DIRECT requires the version 2 of the translation table library")
+endif
+ifeq (${RECLAIM_INIT_CODE}, 1)
+$(error "RECLAIM_INIT_CODE requires the version 2 of the translation table library")
+endif
 PLAT_BL_COMMON_SOURCES	+=	lib/xlat_tables/xlat_tables_common.c		\
 				lib/xlat_tables/${ARCH}/xlat_tables.c
 else
@@ -142,12 +159,18 @@ BL2_SOURCES		+=	plat/arm/common/arm_image_load.c		\
 				common/desc_image_load.c
 endif
 
+ifeq (${BL2_AT_EL3},1)
+BL2_SOURCES		+=	drivers/arm/sp805/sp805.c			\
+				plat/arm/common/arm_bl2_el3_setup.c
+endif
+
 BL2U_SOURCES		+=	plat/arm/common/arm_bl2u_setup.c
 
 BL31_SOURCES		+=	plat/arm/common/arm_bl31_setup.c		\
 				plat/arm/common/arm_pm.c			\
 				plat/arm/common/arm_topology.c			\
 				plat/arm/common/execution_state_switch.c	\
+				lib/ns_range/ns_range.c				\
 				plat/common/plat_psci_common.c
 
 ifeq (${ENABLE_PMF}, 1)
@@ -10,6 +10,7 @@
 #include <io_fip.h>
 #include <io_memmap.h>
 #include <io_storage.h>
+#include <plat_arm.h>
 #include <platform_def.h>
 #include <string.h>
 #include <utils.h>
@@ -187,6 +188,7 @@ static const struct plat_io_policy policies[] = {
 /* Weak definitions may be overridden in specific ARM standard platform */
 #pragma weak plat_arm_io_setup
 #pragma weak plat_arm_get_alt_image_source
+#pragma weak plat_arm_get_memmap_dev_spec
 
 
 static int open_fip(const uintptr_t spec)
@@ -239,7 +241,7 @@ void arm_io_setup(void)
 				&fip_dev_handle);
 	assert(io_result == 0);
 
-	io_result = io_dev_open(memmap_dev_con, (uintptr_t)NULL,
+	io_result = io_dev_open(memmap_dev_con, plat_arm_get_memmap_dev_spec(),
 				&memmap_dev_handle);
 	assert(io_result == 0);
 
@@ -261,6 +263,46 @@ int plat_arm_get_alt_image_source(
 	return -ENOENT;
 }
 
+uintptr_t plat_arm_get_memmap_dev_spec(void)
+{
+	/* By default the data is copied by the CPU */
+	return (uintptr_t)NULL;
+}
+
+#if ARM_IO_SOURCE_BY_COST
+/*
+ * Replace the FIP by the alternative source of an image if the reads from the
+ * alternative source have cost less per byte so far. The alternative source is
+ * tried once the cost of the reads from the FIP is known, so that its own cost
+ * gets measured.
+ */
+static void arm_io_select_source(unsigned int image_id, uintptr_t *dev_handle,
+				 uintptr_t *image_spec)
+{
+	io_dev_stats_t fip_stats, alt_stats;
+	uintptr_t alt_dev_handle, alt_image_spec;
+
+	if ((*dev_handle != fip_dev_handle) ||
+	    (io_dev_get_stats(fip_dev_handle, &fip_stats) != 0) ||
+	    (fip_stats.bytes == 0))
+		return;
+
+	if (plat_arm_get_alt_image_source(image_id, &alt_dev_handle,
+					  &alt_image_spec) != 0)
+		return;
+
+	if ((io_dev_get_stats(alt_dev_handle, &alt_stats) == 0) &&
+	    (alt_stats.bytes != 0) &&
+	    ((alt_stats.ticks * fip_stats.bytes) >=
+	     (fip_stats.ticks * alt_stats.bytes)))
+		return;
+
+	VERBOSE("Using alternative IO for image id=%u\n", image_id);
+	*dev_handle = alt_dev_handle;
+	*image_spec = alt_image_spec;
+}
+#endif /* ARM_IO_SOURCE_BY_COST */
+
 /* Return an IO device handle and specification which can be used to access
  * an image. Use this to enforce platform load policy */
 int plat_get_image_source(unsigned int image_id, uintptr_t *dev_handle,
@@ -276,6 +318,9 @@ int plat_get_image_source(unsigned int image_id, uintptr_t *dev_handle,
 	if (result == 0) {
 		*image_spec = policy->image_spec;
 		*dev_handle = *(policy->dev_handle);
+#if ARM_IO_SOURCE_BY_COST
+		arm_io_select_source(image_id, dev_handle, image_spec);
+#endif
 	} else {
 		VERBOSE("Trying alternative IO\n");
 		result = plat_arm_get_alt_image_source(image_id, dev_handle,
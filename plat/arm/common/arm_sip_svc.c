@@ -5,11 +5,28 @@
  */
 
 #include <arm_sip_svc.h>
+#include <assert.h>
+#include <bl31.h>
+#include <console.h>
+#include <crash_dump.h>
+#if CSS_USE_SCMI_PERF
+#include <css_pm.h>
+#endif
 #include <debug.h>
+#include <errno.h>
+#if PSCI_PD_SNAPSHOT
+#include <ns_range.h>
+#endif
 #include <plat_arm.h>
 #include <pmf.h>
+#include <psci.h>
+#include <ras.h>
+#include <runtime_instr.h>
 #include <runtime_svc.h>
+#include <spinlock.h>
 #include <stdint.h>
+#include <string.h>
+#include <trace_event.h>
 #include <uuid.h>
 
 
@@ -18,6 +35,48 @@ DEFINE_SVC_UUID(arm_sip_svc_uid,
 		0xe2756d55, 0x3360, 0x4bb5, 0xbf, 0xf3,
 		0x62, 0x79, 0xfd, 0x11, 0x37, 0xff);
 
+#if PSCI_PD_SNAPSHOT
+static spinlock_t arm_pd_snapshot_lock;
+
+/*
+ * Copy the snapshot of the power domain tree to the normal world buffer of
+ * `size` bytes at `base`, which must be page aligned and in the non-secure
+ * memory. The buffer is only mapped during the copy, and the copies are
+ * serialised as their regions could overlap. The size of the snapshot is
+ * returned in `snap_size`, also when the buffer is too small.
+ */
+static int arm_sip_pd_snapshot(uintptr_t base, size_t size, size_t *snap_size)
+{
+	int rc;
+
+	*snap_size = psci_pd_snapshot(NULL, 0);
+
+	if (!base || !size || !IS_PAGE_ALIGNED(base) || !IS_PAGE_ALIGNED(size))
+		return -EINVAL;
+
+	if (!is_ns_range(base, size))
+		return -EINVAL;
+
+	if (*snap_size > size)
+		return -ENOMEM;
+
+	spin_lock(&arm_pd_snapshot_lock);
+
+	rc = mmap_add_dynamic_region(base, base, size,
+				     MT_MEMORY | MT_RW | MT_NS |
+				     MT_EXECUTE_NEVER);
+	if (rc == 0) {
+		psci_pd_snapshot((void *)base, size);
+		rc = mmap_remove_dynamic_region(base, size);
+		assert(rc == 0);
+	}
+
+	spin_unlock(&arm_pd_snapshot_lock);
+
+	return rc;
+}
+#endif
+
 static int arm_sip_setup(void)
 {
 	if (pmf_setup() != 0)
@@ -69,6 +128,241 @@ static uintptr_t arm_sip_handler(unsigned int smc_fid,
 				handle);
 		}
 
+#if ENABLE_SMC_LATENCY_STATS
+	case ARM_SIP_SVC_SMC_STATS: {
+		int cpu_idx;
+
+		/*
+		 * x1 --> MPIDR of the CPU, x2 --> owning entity number,
+		 * x3 --> latency bucket.
+		 * Return the error code and the number of SMCs in the bucket.
+		 */
+		cpu_idx = plat_core_pos_by_mpidr(x1);
+		if ((cpu_idx < 0) || (x2 >= OEN_LIMIT) ||
+		    (x3 >= SMC_STATS_BUCKETS))
+			SMC_RET2(handle, -EINVAL, 0);
+
+		SMC_RET2(handle, 0, smc_stats_get(cpu_idx, x2, x3));
+		}
+#endif
+
+#if PSCI_CPU_ON_MULTI
+	case ARM_SIP_SVC_CPU_ON_MULTI: {
+		u_register_t cpus_on;
+		int rc;
+
+		/* Allow calls from non-secure only */
+		if (!is_caller_non_secure(flags))
+			SMC_RET1(handle, SMC_UNK);
+
+		/*
+		 * x1 --> MPIDR of the affinity group with Aff0 cleared,
+		 * x2 --> mask of the Aff0 values of the CPUs to turn on,
+		 * x3 --> entrypoint, x4 --> context id.
+		 * Return the PSCI error code and the mask of the CPUs that have
+		 * been turned on.
+		 */
+		rc = psci_cpu_on_multi(x1, x2, x3, x4, &cpus_on);
+		SMC_RET2(handle, rc, cpus_on);
+		}
+#endif
+
+#if ENABLE_CONSOLE_BUFFER
+	case ARM_SIP_SVC_CONSOLE_LOG: {
+		unsigned long long pos = x2;
+		uint64_t data[2] = { 0, 0 };
+		int cpu_idx, count;
+
+		/*
+		 * x1 --> MPIDR of the CPU, x2 --> position in its log.
+		 * Return the number of characters read, the position of the
+		 * first one and up to 16 characters in x2-x3.
+		 */
+		cpu_idx = plat_core_pos_by_mpidr(x1);
+		if (cpu_idx < 0)
+			SMC_RET1(handle, -EINVAL);
+
+		count = console_buffer_read(cpu_idx, &pos, (char *)data,
+					    sizeof(data));
+		SMC_RET4(handle, count, pos, data[0], data[1]);
+		}
+#endif
+
+#if ENABLE_TRACE_EVENTS
+	case ARM_SIP_SVC_TRACE_READ: {
+		unsigned long long seq = x2;
+		trace_event_t event;
+		int cpu_idx;
+
+		/*
+		 * x1 --> MPIDR of the CPU, x2 --> sequence number of the event.
+		 * Return the error code, the sequence number of the event read,
+		 * its time-stamp, its ID and its four arguments.
+		 */
+		cpu_idx = plat_core_pos_by_mpidr(x1);
+		if ((cpu_idx < 0) || (trace_event_read(cpu_idx, &seq, &event)))
+			SMC_RET1(handle, -ENOENT);
+
+		SMC_RET8(handle, 0, seq, event.timestamp, event.id,
+			 event.args[0], event.args[1], event.args[2],
+			 event.args[3]);
+		}
+#endif
+
+#if CSS_USE_SCMI_PERF
+	case ARM_SIP_SVC_PERF_LEVEL_SET:
+		/* Allow calls from non-secure only */
+		if (!is_caller_non_secure(flags))
+			SMC_RET1(handle, SMC_UNK);
+
+		/*
+		 * x1 --> SCMI performance domain, x2 --> performance level.
+		 * Return the SCMI error code.
+		 */
+		SMC_RET1(handle, css_scp_perf_level_set(x1, x2));
+
+	case ARM_SIP_SVC_PERF_LEVEL_GET: {
+		unsigned int level = 0;
+		int ret;
+
+		/* Allow calls from non-secure only */
+		if (!is_caller_non_secure(flags))
+			SMC_RET1(handle, SMC_UNK);
+
+		/*
+		 * x1 --> SCMI performance domain.
+		 * Return the SCMI error code and the performance level.
+		 */
+		ret = css_scp_perf_level_get(x1, &level);
+		SMC_RET2(handle, ret, level);
+		}
+#endif
+
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	case ARM_SIP_SVC_PSCI_STATS: {
+		int cpu_idx;
+
+		/*
+		 * x1 --> MPIDR of the CPU, x2 --> phase, x3 --> latency bucket.
+		 * Return the error code and the number of PSCI calls in the
+		 * bucket.
+		 */
+		cpu_idx = plat_core_pos_by_mpidr(x1);
+		if ((cpu_idx < 0) || (x2 >= RT_INSTR_TOTAL_PHASES) ||
+		    (x3 >= RT_INSTR_STATS_BUCKETS))
+			SMC_RET2(handle, -EINVAL, 0);
+
+		SMC_RET2(handle, 0, rt_instr_psci_stats_get(cpu_idx, x2, x3));
+		}
+#endif
+
+#if ENABLE_STACK_WATERMARK
+	case ARM_SIP_SVC_STACK_WATERMARK: {
+		int cpu_idx;
+
+		/*
+		 * x1 --> MPIDR of the CPU. Return the error code and the
+		 * largest number of bytes of its stack used by the CPU.
+		 */
+		cpu_idx = plat_core_pos_by_mpidr(x1);
+		if (cpu_idx < 0)
+			SMC_RET2(handle, -EINVAL, 0);
+
+		SMC_RET2(handle, 0, bl31_stack_watermark_get(cpu_idx));
+		}
+#endif
+
+#if RAS_EXTENSION
+	case ARM_SIP_SVC_RAS_READ: {
+		unsigned long long seq = x2;
+		ras_error_t error;
+		int cpu_idx;
+
+		/*
+		 * x1 --> MPIDR of the CPU, x2 --> sequence number of the error.
+		 * Return the error code, the sequence number of the error read,
+		 * its time-stamp, the index of its record and the status,
+		 * address and miscellaneous registers of the record.
+		 */
+		cpu_idx = plat_core_pos_by_mpidr(x1);
+		if ((cpu_idx < 0) || (ras_error_read(cpu_idx, &seq, &error)))
+			SMC_RET1(handle, -ENOENT);
+
+		SMC_RET7(handle, 0, seq, error.timestamp, error.record,
+			 error.status, error.addr, error.misc0);
+		}
+#endif
+
+#if CRASH_DUMP_BUFFER
+	case ARM_SIP_SVC_CRASH_DUMP_READ: {
+		uint64_t data[7];
+		int cpu_idx, size;
+
+		/*
+		 * x1 --> MPIDR of the CPU, x2 --> byte offset in its record.
+		 * Return the size of the record and its seven double words
+		 * from the offset.
+		 */
+		cpu_idx = plat_core_pos_by_mpidr(x1);
+		if (cpu_idx < 0)
+			SMC_RET1(handle, -EINVAL);
+
+		size = crash_dump_read(cpu_idx, x2, data, ARRAY_SIZE(data));
+		if (size < 0)
+			SMC_RET1(handle, -ENOENT);
+
+		SMC_RET8(handle, size, data[0], data[1], data[2], data[3],
+			 data[4], data[5], data[6]);
+		}
+
+	case ARM_SIP_SVC_CRASH_DUMP_CLEAR: {
+		int cpu_idx;
+
+		/* x1 --> MPIDR of the CPU. Return the error code. */
+		cpu_idx = plat_core_pos_by_mpidr(x1);
+		if ((cpu_idx < 0) || (crash_dump_clear(cpu_idx)))
+			SMC_RET1(handle, -EINVAL);
+
+		SMC_RET1(handle, 0);
+		}
+#endif
+
+#if PSCI_PD_SNAPSHOT
+	case ARM_SIP_SVC_PD_SNAPSHOT: {
+		size_t snap_size;
+		int rc;
+
+		/* Allow calls from non-secure only */
+		if (!is_caller_non_secure(flags))
+			SMC_RET1(handle, SMC_UNK);
+
+		/*
+		 * x1 --> base address of the buffer, x2 --> size of the buffer.
+		 * Return the error code and the size of the snapshot.
+		 */
+		rc = arm_sip_pd_snapshot(x1, x2, &snap_size);
+		SMC_RET2(handle, rc, snap_size);
+		}
+#endif
+
+	case ARM_SIP_SVC_IDLE_STATE: {
+		const plat_psci_idle_state_t *idle_state;
+
+		/*
+		 * x1 --> index of the entry of the table. Return the error
+		 * code, the power level and the local state of the entry, its
+		 * target residency and its entry and exit latencies.
+		 */
+		idle_state = psci_get_idle_state(x1);
+		if (idle_state == NULL)
+			SMC_RET1(handle, -ENOENT);
+
+		SMC_RET6(handle, 0, idle_state->pwrlvl,
+			 idle_state->local_state,
+			 idle_state->target_residency,
+			 idle_state->entry_latency, idle_state->exit_latency);
+		}
+
 	case ARM_SIP_SVC_CALL_COUNT:
 		/* PMF calls */
 		call_count += PMF_NUM_SMC_CALLS;
@@ -76,6 +370,59 @@ static uintptr_t arm_sip_handler(unsigned int smc_fid,
 		/* State switch call */
 		call_count += 1;
 
+		/* Idle state table call */
+		call_count += 1;
+
+#if ENABLE_SMC_LATENCY_STATS
+		/* SMC latency histogram call */
+		call_count += 1;
+#endif
+
+#if PSCI_CPU_ON_MULTI
+		/* Multiple CPU_ON call */
+		call_count += 1;
+#endif
+
+#if ENABLE_CONSOLE_BUFFER
+		/* Console log call */
+		call_count += 1;
+#endif
+
+#if ENABLE_TRACE_EVENTS
+		/* Trace event call */
+		call_count += 1;
+#endif
+
+#if CSS_USE_SCMI_PERF
+		/* Performance level calls */
+		call_count += 2;
+#endif
+
+#if ENABLE_RUNTIME_INSTRUMENTATION
+		/* PSCI latency histogram call */
+		call_count += 1;
+#endif
+
+#if ENABLE_STACK_WATERMARK
+		/* Stack usage call */
+		call_count += 1;
+#endif
+
+#if RAS_EXTENSION
+		/* RAS error call */
+		call_count += 1;
+#endif
+
+#if CRASH_DUMP_BUFFER
+		/* Crash record calls */
+		call_count += 2;
+#endif
+
+#if PSCI_PD_SNAPSHOT
+		/* Power domain snapshot call */
+		call_count += 1;
+#endif
+
 		SMC_RET1(handle, call_count);
 
 	case ARM_SIP_SVC_UID:
@@ -9,11 +9,30 @@
 #include <context.h>
 #include <context_mgmt.h>
 #include <plat_arm.h>
+#include <pmf.h>
 #include <psci.h>
+#include <runtime_instr.h>
 #include <smcc_helpers.h>
 #include <string.h>
 #include <utils.h>
 
+#ifdef AARCH64
+/*
+ * Normal world context produced by the context management library for the
+ * first switch to each execution state, AArch32 then AArch64. Since the switch
+ * is a soft reset of the calling EL, the context it produces only differs from
+ * one switch to the next by the entry point, the endianness and the SCR_EL3
+ * bits inherited from the current context, so the later switches to the same
+ * execution state copy the template and apply these instead. Only the primary
+ * CPU can switch before the secondaries are up, so the templates are global.
+ */
+#define STATE_SW_AARCH32	0
+#define STATE_SW_AARCH64	1
+
+static cpu_context_t state_sw_templates[2];
+static int state_sw_template_valid[2];
+#endif
+
 /*
  * Handle SMC from a lower exception level to switch its execution state
  * (either from AArch64 to AArch32, or vice versa).
@@ -39,7 +58,7 @@ int arm_execution_state_switch(unsigned int smc_fid,
 {
 	/* Execution state can be switched only if EL3 is AArch64 */
 #ifdef AARCH64
-	int caller_64, from_el2, el, endianness, thumb = 0;
+	int caller_64, from_el2, el, endianness, target, thumb = 0;
 	u_register_t spsr, pc, scr, sctlr;
 	entry_point_info_t ep;
 	cpu_context_t *ctx = (cpu_context_t *) handle;
@@ -133,28 +152,69 @@ int arm_execution_state_switch(unsigned int smc_fid,
 		spsr = SPSR_64(el, MODE_SP_ELX, DISABLE_ALL_EXCEPTIONS);
 	}
 
-	/*
-	 * Use the context management library to re-initialize the existing
-	 * context with the execution state flipped. Since the library takes
-	 * entry_point_info_t pointer as the argument, construct a dummy one
-	 * with PC, state width, endianness, security etc. appropriately set.
-	 * Other entries in the entry point structure are irrelevant for
-	 * purpose.
-	 */
-	zeromem(&ep, sizeof(ep));
-	ep.pc = pc;
-	ep.spsr = spsr;
-	SET_PARAM_HEAD(&ep, PARAM_EP, VERSION_1,
-			((endianness ? EP_EE_BIG : EP_EE_LITTLE) | NON_SECURE |
-			 EP_ST_DISABLE));
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc, RT_INSTR_ENTER_STATE_SWITCH,
+			      PMF_NO_CACHE_MAINT);
+#endif
 
-	/*
-	 * Re-initialize the system register context, and exit EL3 as if for the
-	 * first time. State switch is effectively a soft reset of the
-	 * calling EL.
-	 */
-	cm_init_my_context(&ep);
-	cm_prepare_el3_exit(NON_SECURE);
+	target = caller_64 ? STATE_SW_AARCH32 : STATE_SW_AARCH64;
+	if (state_sw_template_valid[target]) {
+		/*
+		 * Copy the template of the target execution state, then apply
+		 * the entry point, the endianness and the SCR_EL3 of the
+		 * current context with only its register width flipped.
+		 */
+		scr &= ~(SCR_RW_BIT | SCR_ST_BIT);
+		if (!caller_64)
+			scr |= SCR_RW_BIT;
+
+		memcpy(ctx, &state_sw_templates[target], sizeof(*ctx));
+
+		sctlr = read_ctx_reg(get_sysregs_ctx(ctx), CTX_SCTLR_EL1);
+		sctlr &= ~SCTLR_EE_BIT;
+		if (endianness)
+			sctlr |= SCTLR_EE_BIT;
+		write_ctx_reg(get_sysregs_ctx(ctx), CTX_SCTLR_EL1, sctlr);
+
+		write_ctx_reg(el3_ctx, CTX_SCR_EL3, scr);
+		write_ctx_reg(el3_ctx, CTX_ELR_EL3, pc);
+		write_ctx_reg(el3_ctx, CTX_SPSR_EL3, spsr);
+
+		/* Only the EL2 registers depending on the state are updated */
+		cm_prepare_el3_exit_state_switch();
+	} else {
+		/*
+		 * Use the context management library to re-initialize the
+		 * existing context with the execution state flipped. Since the
+		 * library takes entry_point_info_t pointer as the argument,
+		 * construct a dummy one with PC, state width, endianness,
+		 * security etc. appropriately set. Other entries in the entry
+		 * point structure are irrelevant for purpose.
+		 */
+		zeromem(&ep, sizeof(ep));
+		ep.pc = pc;
+		ep.spsr = spsr;
+		SET_PARAM_HEAD(&ep, PARAM_EP, VERSION_1,
+				((endianness ? EP_EE_BIG : EP_EE_LITTLE) |
+				 NON_SECURE | EP_ST_DISABLE));
+
+		/*
+		 * Re-initialize the system register context, and exit EL3 as
+		 * if for the first time. State switch is effectively a soft
+		 * reset of the calling EL.
+		 */
+		cm_init_my_context(&ep);
+
+		memcpy(&state_sw_templates[target], ctx, sizeof(*ctx));
+		state_sw_template_valid[target] = 1;
+
+		cm_prepare_el3_exit(NON_SECURE);
+	}
+
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc, RT_INSTR_EXIT_STATE_SWITCH,
+			      PMF_NO_CACHE_MAINT);
+#endif
 
 	/*
 	 * State switch success. The caller of SMC wouldn't see the SMC
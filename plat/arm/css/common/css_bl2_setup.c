@@ -7,8 +7,10 @@
 #include <bl_common.h>
 #include <css_def.h>
 #include <debug.h>
+#include <desc_image_load.h>
 #include <mmio.h>
 #include <plat_arm.h>
+#include <platform.h>
 #include <string.h>
 #include <utils.h>
 #include "css_scp_bootloader.h"
@@ -20,6 +22,11 @@
 #pragma weak bl2_plat_handle_scp_bl2
 #endif
 
+#if CSS_DEFER_SCP_READY
+/* Set once SCP_BL2 is transferred, until the SCP signals it is ready */
+static int scp_ready_pending;
+#endif
+
 /*******************************************************************************
  * Transfer SCP_BL2 from Trusted RAM using the SCP Download protocol.
  * Return 0 on success, -1 otherwise.
@@ -42,9 +49,38 @@ int bl2_plat_handle_scp_bl2(image_info_t *scp_bl2_image_info)
 	else
 		ERROR("BL2: SCP_BL2 transfer failure\n");
 
+#if CSS_DEFER_SCP_READY
+	scp_ready_pending = (ret == 0);
+#endif
+
 	return ret;
 }
 
+#if CSS_DEFER_SCP_READY
+/*******************************************************************************
+ * The SCP boots SCP_BL2 while BL2 loads the next images. Wait for it to be
+ * ready before the data structures are flushed for the next image, which is
+ * the last step before the handoff.
+ ******************************************************************************/
+void plat_flush_next_bl_params(void)
+{
+	int ret;
+
+	if (scp_ready_pending != 0) {
+		ret = scp_bootloader_wait_ready();
+		if (ret != 0) {
+			ERROR("BL2: SCP_BL2 failed to signal it is ready\n");
+			plat_error_handler(ret);
+		}
+
+		INFO("BL2: SCP_BL2 is ready\n");
+		scp_ready_pending = 0;
+	}
+
+	flush_bl_params_desc();
+}
+#endif /* CSS_DEFER_SCP_READY */
+
 #ifdef EL3_PAYLOAD_BASE
 /*
  * We need to override some of the platform functions when booting an EL3
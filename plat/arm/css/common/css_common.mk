@@ -8,9 +8,18 @@
 # By default, SCP images are needed by CSS platforms.
 CSS_LOAD_SCP_IMAGES	?=	1
 
+# By default, BL2 waits for SCP_BL2 to be ready as soon as it is transferred
+CSS_DEFER_SCP_READY	?=	0
+
 # By default, SCMI driver is disabled for CSS platforms
 CSS_USE_SCMI_DRIVER	?=	0
 
+# By default, the SCMI driver waits for the response to the power down requests
+CSS_SCMI_PWR_DOWN_NOWAIT	?=	0
+
+# By default, the SCMI performance protocol is not used
+CSS_USE_SCMI_PERF	?=	0
+
 PLAT_INCLUDES		+=	-Iinclude/plat/arm/css/common			\
 				-Iinclude/plat/arm/css/common/aarch64
 
@@ -39,6 +48,15 @@ BL31_SOURCES		+=	plat/arm/css/drivers/scp/css_pm_scmi.c		\
 				plat/arm/css/drivers/scmi/scmi_common.c		\
 				plat/arm/css/drivers/scmi/scmi_pwr_dmn_proto.c	\
 				plat/arm/css/drivers/scmi/scmi_sys_pwr_proto.c
+ifeq (${CSS_USE_SCMI_PERF},1)
+BL31_SOURCES		+=	plat/arm/css/drivers/scmi/scmi_perf_proto.c
+endif
+endif
+
+ifeq (${CSS_USE_SCMI_PERF},1)
+  ifeq (${CSS_USE_SCMI_DRIVER},0)
+    $(error "CSS_USE_SCMI_PERF requires CSS_USE_SCMI_DRIVER to be enabled")
+  endif
 endif
 
 ifneq (${RESET_TO_BL31},0)
@@ -60,6 +78,19 @@ ifeq (${CSS_LOAD_SCP_IMAGES},1)
   BL2_SOURCES		+=	plat/arm/css/common/css_scp_bootloader.c
 endif
 
+# Process CSS_DEFER_SCP_READY flag
+$(eval $(call assert_boolean,CSS_DEFER_SCP_READY))
+$(eval $(call add_define,CSS_DEFER_SCP_READY))
+
+ifeq (${CSS_DEFER_SCP_READY},1)
+  ifneq (${LOAD_IMAGE_V2},1)
+    $(error "CSS_DEFER_SCP_READY requires LOAD_IMAGE_V2=1")
+  endif
+  ifneq (${CSS_LOAD_SCP_IMAGES},1)
+    $(error "CSS_DEFER_SCP_READY requires CSS_LOAD_SCP_IMAGES=1")
+  endif
+endif
+
 # Enable option to detect whether the SCP ROM firmware in use predates version
 # 1.7.0 and therefore, is incompatible.
 CSS_DETECT_PRE_1_7_0_SCP	:=	1
@@ -72,3 +103,11 @@ $(eval $(call add_define,CSS_DETECT_PRE_1_7_0_SCP))
 $(eval $(call assert_boolean,CSS_USE_SCMI_DRIVER))
 $(eval $(call add_define,CSS_USE_SCMI_DRIVER))
 
+# Process CSS_SCMI_PWR_DOWN_NOWAIT flag
+$(eval $(call assert_boolean,CSS_SCMI_PWR_DOWN_NOWAIT))
+$(eval $(call add_define,CSS_SCMI_PWR_DOWN_NOWAIT))
+
+# Process CSS_USE_SCMI_PERF flag
+$(eval $(call assert_boolean,CSS_USE_SCMI_PERF))
+$(eval $(call add_define,CSS_USE_SCMI_PERF))
+
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014-2016, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2017, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -170,6 +170,21 @@ int scp_bootloader_transfer(void *image, unsigned int image_size)
 		return -1;
 	}
 
+#if CSS_DEFER_SCP_READY
+	/*
+	 * SCP_BL2 has been copied to the SCP RAM, so BL2 can load the next
+	 * images over it while the SCP boots. scp_bootloader_wait_ready() is
+	 * called before handing off to the next image.
+	 */
+	return 0;
+#else
+	return scp_bootloader_wait_ready();
+#endif
+}
+
+/* Wait for the SCP to signal that the transferred SCP_BL2 is running */
+int scp_bootloader_wait_ready(void)
+{
 	VERBOSE("Waiting for SCP to signal it is ready to go on\n");
 
 	/* Wait for SCP to signal it's ready */
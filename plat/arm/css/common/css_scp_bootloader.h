@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2017, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -8,5 +8,6 @@
 #define __CSS_SCP_BOOTLOADER_H__
 
 int scp_bootloader_transfer(void *image, unsigned int image_size);
+int scp_bootloader_wait_ready(void);
 
 #endif /* __CSS_SCP_BOOTLOADER_H__ */
@@ -14,6 +14,10 @@
 /* Supported SCMI Protocol Versions */
 #define SCMI_PWR_DMN_PROTO_VER			MAKE_SCMI_VERSION(1, 0)
 #define SCMI_SYS_PWR_PROTO_VER			MAKE_SCMI_VERSION(1, 0)
+#define SCMI_PERF_PROTO_VER			MAKE_SCMI_VERSION(1, 0)
+
+/* Performance protocol version from which fast channels are described */
+#define SCMI_PERF_FASTCHAN_PROTO_VER		MAKE_SCMI_VERSION(2, 0)
 
 #define GET_SCMI_MAJOR_VER(ver)			(((ver) >> 16) & 0xffff)
 #define GET_SCMI_MINOR_VER(ver)			((ver) & 0xffff)
@@ -29,6 +33,7 @@
 /* SCMI Protocol identifiers */
 #define SCMI_PWR_DMN_PROTO_ID			0x11
 #define SCMI_SYS_PWR_PROTO_ID			0x12
+#define SCMI_PERF_PROTO_ID			0x13
 
 /* Mandatory messages IDs for all SCMI protocols */
 #define SCMI_PROTO_VERSION_MSG			0x0
@@ -43,6 +48,11 @@
 #define SCMI_SYS_PWR_STATE_SET_MSG		0x3
 #define SCMI_SYS_PWR_STATE_GET_MSG		0x4
 
+/* SCMI performance domain management protocol message IDs */
+#define SCMI_PERF_LEVEL_SET_MSG			0x7
+#define SCMI_PERF_LEVEL_GET_MSG			0x8
+#define SCMI_PERF_DESCRIBE_FASTCHAN_MSG		0xB
+
 /* Helper macros for system power management protocol commands */
 
 /*
@@ -73,6 +83,13 @@
 #define SCMI_SYS_PWR_POWER_UP			0x3
 #define SCMI_SYS_PWR_SUSPEND			0x4
 
+/*
+ * Macros to describe the bit-fields of the `attributes` of performance
+ * protocol PROTOCOL_ATTRIBUTES and PERFORMANCE_DESCRIBE_FASTCHANNEL messages.
+ */
+#define SCMI_PERF_ATTR_NUM_DOMAINS_MASK		0xffff
+#define SCMI_PERF_FASTCHAN_DOORBELL		(1 << 0)
+
 /* SCMI Error code definitions */
 #define SCMI_E_QUEUED			1
 #define SCMI_E_SUCCESS			0
@@ -120,6 +137,8 @@ int scmi_proto_version(void *p, uint32_t proto_id, uint32_t *version);
  * details on these commands.
  */
 int scmi_pwr_state_set(void *p, uint32_t domain_id, uint32_t scmi_pwr_state);
+void scmi_pwr_state_set_nowait(void *p, uint32_t domain_id,
+			       uint32_t scmi_pwr_state);
 int scmi_pwr_state_get(void *p, uint32_t domain_id, uint32_t *scmi_pwr_state);
 
 /*
@@ -129,4 +148,15 @@ int scmi_pwr_state_get(void *p, uint32_t domain_id, uint32_t *scmi_pwr_state);
 int scmi_sys_pwr_state_set(void *p, uint32_t flags, uint32_t system_state);
 int scmi_sys_pwr_state_get(void *p, uint32_t *system_state);
 
+/*
+ * Performance domain management protocol commands. Refer SCMI specification
+ * for more details on these commands.
+ */
+int scmi_perf_proto_attr(void *p, uint32_t *attr);
+int scmi_perf_level_set(void *p, uint32_t domain_id, uint32_t level);
+int scmi_perf_level_get(void *p, uint32_t domain_id, uint32_t *level);
+int scmi_perf_describe_fastchan(void *p, uint32_t domain_id,
+		uint32_t msg_id, uint32_t *attr, uint64_t *chan_addr,
+		uint32_t *chan_size);
+
 #endif	/* __CSS_SCMI_H__ */
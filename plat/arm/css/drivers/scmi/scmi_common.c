@@ -15,18 +15,27 @@
  */
 void scmi_get_channel(scmi_channel_t *ch)
 {
+	mailbox_mem_t *mbx_mem = (mailbox_mem_t *)(ch->info->scmi_mbx_mem);
+
 	assert(ch->lock);
 	bakery_lock_get(ch->lock);
 
-	/* Make sure any previous command has finished */
-	assert(SCMI_IS_CHANNEL_FREE(
-			((mailbox_mem_t *)(ch->info->scmi_mbx_mem))->status));
+	/*
+	 * Wait for the SCP to complete the previous command, which may have
+	 * been sent without waiting for its response.
+	 */
+	while (!SCMI_IS_CHANNEL_FREE(mbx_mem->status))
+		;
+
+	/* Ensure that the payload area is written after the channel is free */
+	dmbsy();
 }
 
 /*
- * Private helper function to transfer ownership of channel from AP to SCP.
+ * Private helper function to transfer ownership of channel from AP to SCP,
+ * without waiting for the SCP to respond.
  */
-void scmi_send_sync_command(scmi_channel_t *ch)
+void scmi_send_command(scmi_channel_t *ch)
 {
 	mailbox_mem_t *mbx_mem = (mailbox_mem_t *)(ch->info->scmi_mbx_mem);
 
@@ -41,6 +50,17 @@ void scmi_send_sync_command(scmi_channel_t *ch)
 
 	SCMI_RING_DOORBELL(ch->info->db_reg_addr, ch->info->db_modify_mask,
 					ch->info->db_preserve_mask);
+}
+
+/*
+ * Private helper function to transfer ownership of channel from AP to SCP and
+ * wait for the response.
+ */
+void scmi_send_sync_command(scmi_channel_t *ch)
+{
+	mailbox_mem_t *mbx_mem = (mailbox_mem_t *)(ch->info->scmi_mbx_mem);
+
+	scmi_send_command(ch);
 
 	/*
 	 * Ensure that the write to the doorbell register is ordered prior to
@@ -65,10 +85,6 @@ void scmi_send_sync_command(scmi_channel_t *ch)
  */
 void scmi_put_channel(scmi_channel_t *ch)
 {
-	/* Make sure any previous command has finished */
-	assert(SCMI_IS_CHANNEL_FREE(
-			((mailbox_mem_t *)(ch->info->scmi_mbx_mem))->status));
-
 	assert(ch->lock);
 	bakery_lock_release(ch->lock);
 }
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <debug.h>
+#include "scmi.h"
+#include "scmi_private.h"
+
+/*
+ * API to query the attributes of the SCMI performance protocol.
+ */
+int scmi_perf_proto_attr(void *p, uint32_t *attr)
+{
+	mailbox_mem_t *mbx_mem;
+	int token = 0, ret;
+	scmi_channel_t *ch = (scmi_channel_t *)p;
+
+	validate_scmi_channel(ch);
+
+	scmi_get_channel(ch);
+
+	mbx_mem = (mailbox_mem_t *)(ch->info->scmi_mbx_mem);
+	mbx_mem->msg_header = SCMI_MSG_CREATE(SCMI_PERF_PROTO_ID,
+			SCMI_PROTO_ATTR_MSG, token);
+	mbx_mem->len = SCMI_PROTO_ATTR_MSG_LEN;
+	mbx_mem->flags = SCMI_FLAG_RESP_POLL;
+
+	scmi_send_sync_command(ch);
+
+	/* Get the return values */
+	SCMI_PAYLOAD_RET_VAL2(mbx_mem->payload, ret, *attr);
+	assert(mbx_mem->len == SCMI_PERF_PROTO_ATTR_RESP_LEN);
+	assert(token == SCMI_MSG_GET_TOKEN(mbx_mem->msg_header));
+
+	scmi_put_channel(ch);
+
+	return ret;
+}
+
+/*
+ * API to set the performance level of a SCMI performance domain.
+ */
+int scmi_perf_level_set(void *p, uint32_t domain_id, uint32_t level)
+{
+	mailbox_mem_t *mbx_mem;
+	int token = 0, ret;
+	scmi_channel_t *ch = (scmi_channel_t *)p;
+
+	validate_scmi_channel(ch);
+
+	scmi_get_channel(ch);
+
+	mbx_mem = (mailbox_mem_t *)(ch->info->scmi_mbx_mem);
+	mbx_mem->msg_header = SCMI_MSG_CREATE(SCMI_PERF_PROTO_ID,
+			SCMI_PERF_LEVEL_SET_MSG, token);
+	mbx_mem->len = SCMI_PERF_LEVEL_SET_MSG_LEN;
+	mbx_mem->flags = SCMI_FLAG_RESP_POLL;
+	SCMI_PAYLOAD_ARG2(mbx_mem->payload, domain_id, level);
+
+	scmi_send_sync_command(ch);
+
+	/* Get the return values */
+	SCMI_PAYLOAD_RET_VAL1(mbx_mem->payload, ret);
+	assert(mbx_mem->len == SCMI_PERF_LEVEL_SET_RESP_LEN);
+	assert(token == SCMI_MSG_GET_TOKEN(mbx_mem->msg_header));
+
+	scmi_put_channel(ch);
+
+	return ret;
+}
+
+/*
+ * API to get the performance level of a SCMI performance domain.
+ */
+int scmi_perf_level_get(void *p, uint32_t domain_id, uint32_t *level)
+{
+	mailbox_mem_t *mbx_mem;
+	int token = 0, ret;
+	scmi_channel_t *ch = (scmi_channel_t *)p;
+
+	validate_scmi_channel(ch);
+
+	scmi_get_channel(ch);
+
+	mbx_mem = (mailbox_mem_t *)(ch->info->scmi_mbx_mem);
+	mbx_mem->msg_header = SCMI_MSG_CREATE(SCMI_PERF_PROTO_ID,
+			SCMI_PERF_LEVEL_GET_MSG, token);
+	mbx_mem->len = SCMI_PERF_LEVEL_GET_MSG_LEN;
+	mbx_mem->flags = SCMI_FLAG_RESP_POLL;
+	SCMI_PAYLOAD_ARG1(mbx_mem->payload, domain_id);
+
+	scmi_send_sync_command(ch);
+
+	/* Get the return values */
+	SCMI_PAYLOAD_RET_VAL2(mbx_mem->payload, ret, *level);
+	assert(mbx_mem->len == SCMI_PERF_LEVEL_GET_RESP_LEN);
+	assert(token == SCMI_MSG_GET_TOKEN(mbx_mem->msg_header));
+
+	scmi_put_channel(ch);
+
+	return ret;
+}
+
+/*
+ * API to query the fast channel of a SCMI performance domain for the given
+ * message. The doorbell of the channel, if any, is not described.
+ */
+int scmi_perf_describe_fastchan(void *p, uint32_t domain_id,
+		uint32_t msg_id, uint32_t *attr, uint64_t *chan_addr,
+		uint32_t *chan_size)
+{
+	mailbox_mem_t *mbx_mem;
+	int token = 0, ret;
+	uint32_t rate_limit __unused, addr_lo, addr_hi;
+	scmi_channel_t *ch = (scmi_channel_t *)p;
+
+	validate_scmi_channel(ch);
+
+	scmi_get_channel(ch);
+
+	mbx_mem = (mailbox_mem_t *)(ch->info->scmi_mbx_mem);
+	mbx_mem->msg_header = SCMI_MSG_CREATE(SCMI_PERF_PROTO_ID,
+			SCMI_PERF_DESCRIBE_FASTCHAN_MSG, token);
+	mbx_mem->len = SCMI_PERF_DESCRIBE_FASTCHAN_MSG_LEN;
+	mbx_mem->flags = SCMI_FLAG_RESP_POLL;
+	SCMI_PAYLOAD_ARG2(mbx_mem->payload, domain_id, msg_id);
+
+	scmi_send_sync_command(ch);
+
+	/* Get the return values */
+	SCMI_PAYLOAD_RET_VAL6(mbx_mem->payload, ret, *attr, rate_limit,
+			      addr_lo, addr_hi, *chan_size);
+	assert((ret != SCMI_E_SUCCESS) ||
+	       (mbx_mem->len >= SCMI_PERF_DESCRIBE_FASTCHAN_RESP_LEN));
+	assert(token == SCMI_MSG_GET_TOKEN(mbx_mem->msg_header));
+
+	scmi_put_channel(ch);
+
+	*chan_addr = ((uint64_t)addr_hi << 32) | addr_lo;
+	return ret;
+}
@@ -18,6 +18,8 @@
 #define SCMI_PROTO_MSG_ATTR_MSG_LEN		8
 #define SCMI_PROTO_MSG_ATTR_RESP_LEN		12
 
+#define SCMI_PROTO_ATTR_MSG_LEN			4
+
 #define SCMI_PWR_STATE_SET_MSG_LEN		16
 #define SCMI_PWR_STATE_SET_RESP_LEN		8
 
@@ -30,6 +32,18 @@
 #define SCMI_SYS_PWR_STATE_GET_MSG_LEN		4
 #define SCMI_SYS_PWR_STATE_GET_RESP_LEN		12
 
+#define SCMI_PERF_LEVEL_SET_MSG_LEN		12
+#define SCMI_PERF_LEVEL_SET_RESP_LEN		8
+
+#define SCMI_PERF_LEVEL_GET_MSG_LEN		8
+#define SCMI_PERF_LEVEL_GET_RESP_LEN		12
+
+#define SCMI_PERF_PROTO_ATTR_RESP_LEN		24
+
+#define SCMI_PERF_DESCRIBE_FASTCHAN_MSG_LEN	12
+/* The doorbell description that follows is omitted by some implementations */
+#define SCMI_PERF_DESCRIBE_FASTCHAN_RESP_LEN	28
+
 /* SCMI message header format bit field */
 #define SCMI_MSG_ID_SHIFT		0
 #define SCMI_MSG_ID_WIDTH		8
@@ -113,6 +127,14 @@
 		(val3) = mmio_read_32((uintptr_t)&payld_arr[2]);	\
 	} while (0)
 
+#define SCMI_PAYLOAD_RET_VAL6(payld_arr, val1, val2, val3, val4, val5,	\
+			      val6)	do {				\
+		SCMI_PAYLOAD_RET_VAL3(payld_arr, val1, val2, val3);	\
+		(val4) = mmio_read_32((uintptr_t)&payld_arr[3]);	\
+		(val5) = mmio_read_32((uintptr_t)&payld_arr[4]);	\
+		(val6) = mmio_read_32((uintptr_t)&payld_arr[5]);	\
+	} while (0)
+
 /* Helper macro to ring doorbell */
 #define SCMI_RING_DOORBELL(addr, modify_mask, preserve_mask)	do {	\
 		uint32_t db = mmio_read_32(addr) & (preserve_mask);	\
@@ -136,6 +158,7 @@ typedef struct mailbox_mem {
 
 /* Private APIs for use within SCMI driver */
 void scmi_get_channel(scmi_channel_t *ch);
+void scmi_send_command(scmi_channel_t *ch);
 void scmi_send_sync_command(scmi_channel_t *ch);
 void scmi_put_channel(scmi_channel_t *ch);
 
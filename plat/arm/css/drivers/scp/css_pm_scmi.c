@@ -9,9 +9,11 @@
 #include <css_def.h>
 #include <css_pm.h>
 #include <debug.h>
+#include <mmio.h>
 #include <plat_arm.h>
 #include <platform.h>
 #include <string.h>
+#include <utils_def.h>
 #include "../scmi/scmi.h"
 #include "css_scp.h"
 
@@ -68,15 +70,169 @@ typedef enum {
 extern uint32_t plat_css_core_pos_to_scmi_dmn_id_map[];
 
 /*
- * The global handle for invoking the SCMI driver APIs after the driver
- * has been initialized.
+ * Number of SCMI channels used by the AP. With several channels, the platform
+ * must export the description of each channel in `plat_css_scmi_plat_info` and
+ * the channel used by each core in `plat_css_core_pos_to_scmi_channel_map`, so
+ * that the CPUs using different channels do not serialise their requests.
  */
-void *scmi_handle;
+#ifndef PLAT_CSS_SCMI_CHANNELS
+#define PLAT_CSS_SCMI_CHANNELS		1
+#endif
+
+#if PLAT_CSS_SCMI_CHANNELS > 1
+extern scmi_channel_plat_info_t plat_css_scmi_plat_info[PLAT_CSS_SCMI_CHANNELS];
+extern unsigned int plat_css_core_pos_to_scmi_channel_map[];
+
+#define css_scmi_channel_id(cpu_idx)	\
+		plat_css_core_pos_to_scmi_channel_map[cpu_idx]
+#else
+scmi_channel_plat_info_t plat_css_scmi_plat_info[] = {
+	{
+		.scmi_mbx_mem = CSS_SCMI_PAYLOAD_BASE,
+		.db_reg_addr = PLAT_CSS_MHU_BASE + CSS_SCMI_MHU_DB_REG_OFF,
+		.db_preserve_mask = 0xfffffffd,
+		.db_modify_mask = 0x2,
+	},
+};
+
+#define css_scmi_channel_id(cpu_idx)	0
+#endif
+
+/*
+ * The handles for invoking the SCMI driver APIs on each channel after the
+ * driver has been initialized.
+ */
+static void *scmi_handles[PLAT_CSS_SCMI_CHANNELS];
+
+/* The SCMI channel global objects and their locks */
+static scmi_channel_t scmi_channels[PLAT_CSS_SCMI_CHANNELS];
+
+DEFINE_BAKERY_LOCK(scmi_locks[PLAT_CSS_SCMI_CHANNELS]);
+
+/* Return the handle of the SCMI channel of the calling CPU */
+static void *css_scmi_handle(void)
+{
+	return scmi_handles[css_scmi_channel_id(plat_my_core_pos())];
+}
+
+#if CSS_USE_SCMI_PERF
+/* Maximum number of performance domains that can be controlled */
+#ifndef PLAT_CSS_SCMI_PERF_MAX_DOMAINS
+#define PLAT_CSS_SCMI_PERF_MAX_DOMAINS	16
+#endif
+
+/*
+ * Memory mapped by BL31 in which the fast channels must lie to be used. The
+ * CSS platforms map the Non-secure SRAM holding the SCMI payload area.
+ */
+#ifndef PLAT_CSS_SCMI_FASTCHAN_BASE
+#define PLAT_CSS_SCMI_FASTCHAN_BASE	NSRAM_BASE
+#define PLAT_CSS_SCMI_FASTCHAN_SIZE	NSRAM_SIZE
+#endif
+
+static unsigned int css_perf_domains;
+
+/*
+ * Addresses of the PERFORMANCE_LEVEL_SET and PERFORMANCE_LEVEL_GET fast
+ * channels of each performance domain, or 0 if the mailbox is used instead.
+ */
+static uintptr_t css_perf_set_fastchan[PLAT_CSS_SCMI_PERF_MAX_DOMAINS];
+static uintptr_t css_perf_get_fastchan[PLAT_CSS_SCMI_PERF_MAX_DOMAINS];
+
+/* Return the address of a usable fast channel for a message, or 0 */
+static uintptr_t css_scmi_perf_fastchan(void *handle, uint32_t domain_id,
+					uint32_t msg_id)
+{
+	uint64_t addr;
+	uint32_t attr, size;
+
+	if (scmi_perf_describe_fastchan(handle, domain_id, msg_id, &attr,
+					&addr, &size) != SCMI_E_SUCCESS)
+		return 0;
+
+	/* A fast channel with a doorbell would not save the round trip */
+	if (attr & SCMI_PERF_FASTCHAN_DOORBELL)
+		return 0;
+
+	if ((size < sizeof(uint32_t)) || ((addr & 0x3) != 0) ||
+	    (addr < PLAT_CSS_SCMI_FASTCHAN_BASE) ||
+	    (addr - PLAT_CSS_SCMI_FASTCHAN_BASE >
+	     PLAT_CSS_SCMI_FASTCHAN_SIZE - size)) {
+		WARN("SCMI fast channel 0x%llx of domain %u is not mapped\n",
+			(unsigned long long)addr, domain_id);
+		return 0;
+	}
+
+	return (uintptr_t)addr;
+}
+
+/*
+ * Find the performance domains and their fast channels. The performance
+ * protocol is optional, so only warn if the SCP does not implement it.
+ */
+static void css_scmi_perf_setup(void *handle)
+{
+	uint32_t version, attr;
+	unsigned int i;
+
+	if ((scmi_proto_version(handle, SCMI_PERF_PROTO_ID, &version) !=
+	     SCMI_E_SUCCESS) ||
+	    (scmi_perf_proto_attr(handle, &attr) != SCMI_E_SUCCESS)) {
+		WARN("SCMI performance protocol is not supported\n");
+		return;
+	}
+
+	css_perf_domains = MIN(attr & SCMI_PERF_ATTR_NUM_DOMAINS_MASK,
+			       (uint32_t)PLAT_CSS_SCMI_PERF_MAX_DOMAINS);
+
+	if (version < SCMI_PERF_FASTCHAN_PROTO_VER)
+		return;
+
+	for (i = 0; i < css_perf_domains; i++) {
+		css_perf_set_fastchan[i] = css_scmi_perf_fastchan(handle, i,
+						SCMI_PERF_LEVEL_SET_MSG);
+		css_perf_get_fastchan[i] = css_scmi_perf_fastchan(handle, i,
+						SCMI_PERF_LEVEL_GET_MSG);
+	}
+
+	VERBOSE("SCMI performance protocol version 0x%x, %u domains\n",
+		version, css_perf_domains);
+}
+
+/*
+ * Helper function to set the performance level of a performance domain,
+ * through its fast channel if it has one. Returns a SCMI error code.
+ */
+int css_scp_perf_level_set(unsigned int domain_id, unsigned int level)
+{
+	if (domain_id >= css_perf_domains)
+		return SCMI_E_NOT_FOUND;
+
+	if (css_perf_set_fastchan[domain_id] != 0) {
+		mmio_write_32(css_perf_set_fastchan[domain_id], level);
+		return SCMI_E_SUCCESS;
+	}
+
+	return scmi_perf_level_set(css_scmi_handle(), domain_id, level);
+}
+
+/*
+ * Helper function to get the performance level of a performance domain,
+ * through its fast channel if it has one. Returns a SCMI error code.
+ */
+int css_scp_perf_level_get(unsigned int domain_id, unsigned int *level)
+{
+	if (domain_id >= css_perf_domains)
+		return SCMI_E_NOT_FOUND;
 
-/* The SCMI channel global object */
-static scmi_channel_t scmi_channel;
+	if (css_perf_get_fastchan[domain_id] != 0) {
+		*level = mmio_read_32(css_perf_get_fastchan[domain_id]);
+		return SCMI_E_SUCCESS;
+	}
 
-ARM_INSTANTIATE_LOCK
+	return scmi_perf_level_get(css_scmi_handle(), domain_id, level);
+}
+#endif /* CSS_USE_SCMI_PERF */
 
 /*
  * Helper function to suspend a CPU power domain and its parent power domains
@@ -94,7 +250,7 @@ void css_scp_suspend(const psci_power_state_t *target_state)
 	/* Check if power down at system power domain level is requested */
 	if (CSS_SYSTEM_PWR_STATE(target_state) == ARM_LOCAL_STATE_OFF) {
 		/* Issue SCMI command for SYSTEM_SUSPEND */
-		ret = scmi_sys_pwr_state_set(scmi_handle,
+		ret = scmi_sys_pwr_state_set(css_scmi_handle(),
 				SCMI_SYS_PWR_FORCEFUL_REQ,
 				SCMI_SYS_PWR_SUSPEND);
 		if (ret != SCMI_E_SUCCESS) {
@@ -132,7 +288,12 @@ void css_scp_suspend(const psci_power_state_t *target_state)
 
 	SCMI_SET_PWR_STATE_MAX_PWR_LVL(scmi_pwr_state, lvl - 1);
 
-	ret = scmi_pwr_state_set(scmi_handle,
+#if CSS_SCMI_PWR_DOWN_NOWAIT
+	scmi_pwr_state_set_nowait(css_scmi_handle(),
+		plat_css_core_pos_to_scmi_dmn_id_map[plat_my_core_pos()],
+		scmi_pwr_state);
+#else
+	ret = scmi_pwr_state_set(css_scmi_handle(),
 		plat_css_core_pos_to_scmi_dmn_id_map[plat_my_core_pos()],
 		scmi_pwr_state);
 
@@ -141,6 +302,7 @@ void css_scp_suspend(const psci_power_state_t *target_state)
 				ret);
 		panic();
 	}
+#endif
 }
 
 /*
@@ -149,7 +311,7 @@ void css_scp_suspend(const psci_power_state_t *target_state)
  */
 void css_scp_off(const psci_power_state_t *target_state)
 {
-	int lvl = 0, ret;
+	int lvl = 0, ret __unused;
 	uint32_t scmi_pwr_state = 0;
 
 	/* At-least the CPU level should be specified to be OFF */
@@ -172,7 +334,12 @@ void css_scp_off(const psci_power_state_t *target_state)
 
 	SCMI_SET_PWR_STATE_MAX_PWR_LVL(scmi_pwr_state, lvl - 1);
 
-	ret = scmi_pwr_state_set(scmi_handle,
+#if CSS_SCMI_PWR_DOWN_NOWAIT
+	scmi_pwr_state_set_nowait(css_scmi_handle(),
+		plat_css_core_pos_to_scmi_dmn_id_map[plat_my_core_pos()],
+		scmi_pwr_state);
+#else
+	ret = scmi_pwr_state_set(css_scmi_handle(),
 		plat_css_core_pos_to_scmi_dmn_id_map[plat_my_core_pos()],
 		scmi_pwr_state);
 
@@ -181,6 +348,7 @@ void css_scp_off(const psci_power_state_t *target_state)
 				ret);
 		panic();
 	}
+#endif
 }
 
 /*
@@ -198,7 +366,7 @@ void css_scp_on(u_register_t mpidr)
 
 	SCMI_SET_PWR_STATE_MAX_PWR_LVL(scmi_pwr_state, lvl - 1);
 
-	ret = scmi_pwr_state_set(scmi_handle,
+	ret = scmi_pwr_state_set(css_scmi_handle(),
 		plat_css_core_pos_to_scmi_dmn_id_map[plat_core_pos_by_mpidr(mpidr)],
 		scmi_pwr_state);
 
@@ -229,7 +397,7 @@ int css_scp_get_power_state(u_register_t mpidr, unsigned int power_level)
 	cpu_idx = plat_core_pos_by_mpidr(mpidr);
 	assert(cpu_idx > -1);
 
-	ret = scmi_pwr_state_get(scmi_handle,
+	ret = scmi_pwr_state_get(css_scmi_handle(),
 		plat_css_core_pos_to_scmi_dmn_id_map[cpu_idx],
 		&scmi_pwr_state);
 
@@ -273,7 +441,7 @@ void __dead2 css_scp_sys_shutdown(void)
 	 * Issue SCMI command for SYSTEM_SHUTDOWN. First issue a graceful
 	 * request and if that fails force the request.
 	 */
-	ret = scmi_sys_pwr_state_set(scmi_handle,
+	ret = scmi_sys_pwr_state_set(css_scmi_handle(),
 			SCMI_SYS_PWR_FORCEFUL_REQ,
 			SCMI_SYS_PWR_SHUTDOWN);
 	if (ret != SCMI_E_SUCCESS) {
@@ -304,7 +472,7 @@ void __dead2 css_scp_sys_reboot(void)
 	 * Issue SCMI command for SYSTEM_REBOOT. First issue a graceful
 	 * request and if that fails force the request.
 	 */
-	ret = scmi_sys_pwr_state_set(scmi_handle,
+	ret = scmi_sys_pwr_state_set(css_scmi_handle(),
 			SCMI_SYS_PWR_FORCEFUL_REQ,
 			SCMI_SYS_PWR_COLD_RESET);
 	if (ret != SCMI_E_SUCCESS) {
@@ -318,22 +486,60 @@ void __dead2 css_scp_sys_reboot(void)
 	panic();
 }
 
-scmi_channel_plat_info_t plat_css_scmi_plat_info = {
-		.scmi_mbx_mem = CSS_SCMI_PAYLOAD_BASE,
-		.db_reg_addr = PLAT_CSS_MHU_BASE + CSS_SCMI_MHU_DB_REG_OFF,
-		.db_preserve_mask = 0xfffffffd,
-		.db_modify_mask = 0x2,
-};
+/*
+ * Helper function to warm reset the system via SCMI, which keeps the DRAM in
+ * self-refresh. The warm reset flag tells the next boot about it. Only the
+ * architectural warm reset type is supported.
+ */
+static int css_system_reset2(int is_vendor, int reset_type,
+			     u_register_t cookie)
+{
+	int ret;
+
+	if (is_vendor)
+		return PSCI_E_NOT_SUPPORTED;
+
+	assert(reset_type == PSCI_RESET2_SYSTEM_WARM_RESET);
+
+	arm_set_warm_reset_flag();
+
+	/*
+	 * Disable GIC CPU interface to prevent pending interrupt from waking
+	 * up the AP from WFI.
+	 */
+	plat_arm_gic_cpuif_disable();
+
+	ret = scmi_sys_pwr_state_set(css_scmi_handle(),
+			SCMI_SYS_PWR_FORCEFUL_REQ,
+			SCMI_SYS_PWR_WARM_RESET);
+	if (ret != SCMI_E_SUCCESS) {
+		ERROR("SCMI system power domain warm reset return 0x%x"
+				" unexpected\n", ret);
+		panic();
+	}
+
+	wfi();
+	ERROR("CSS System Warm Reset: operation not handled.\n");
+	panic();
+}
 
 void plat_arm_pwrc_setup(void)
 {
-	scmi_channel.info = &plat_css_scmi_plat_info;
-	scmi_channel.lock = ARM_LOCK_GET_INSTANCE;
-	scmi_handle = scmi_init(&scmi_channel);
-	if (scmi_handle == NULL) {
-		ERROR("SCMI Initialization failed\n");
-		panic();
+	unsigned int i;
+
+	for (i = 0; i < PLAT_CSS_SCMI_CHANNELS; i++) {
+		scmi_channels[i].info = &plat_css_scmi_plat_info[i];
+		scmi_channels[i].lock = &scmi_locks[i];
+		scmi_handles[i] = scmi_init(&scmi_channels[i]);
+		if (scmi_handles[i] == NULL) {
+			ERROR("SCMI Initialization failed\n");
+			panic();
+		}
 	}
+
+#if CSS_USE_SCMI_PERF
+	css_scmi_perf_setup(scmi_handles[0]);
+#endif
 }
 
 /******************************************************************************
@@ -343,6 +549,7 @@ void plat_arm_pwrc_setup(void)
  *****************************************************************************/
 const plat_psci_ops_t *plat_arm_psci_override_pm_ops(plat_psci_ops_t *ops)
 {
+	void *scmi_handle = css_scmi_handle();
 	uint32_t msg_attr;
 	int ret;
 
@@ -373,12 +580,18 @@ const plat_psci_ops_t *plat_arm_psci_override_pm_ops(plat_psci_ops_t *ops)
 		ops->system_off = NULL;
 		ops->system_reset = NULL;
 		ops->get_sys_suspend_power_state = NULL;
-	} else if (!(msg_attr & SCMI_SYS_PWR_SUSPEND_SUPPORTED)) {
-		/*
-		 * System power management protocol is available, but it does
-		 * not support SYSTEM SUSPEND.
-		 */
-		ops->get_sys_suspend_power_state = NULL;
+	} else {
+		if (!(msg_attr & SCMI_SYS_PWR_SUSPEND_SUPPORTED)) {
+			/*
+			 * System power management protocol is available, but
+			 * it does not support SYSTEM SUSPEND.
+			 */
+			ops->get_sys_suspend_power_state = NULL;
+		}
+
+		/* PSCI SYSTEM_RESET2 relies on the SCMI warm reset */
+		if (msg_attr & SCMI_SYS_PWR_WARM_RESET_SUPPORTED)
+			ops->system_reset2 = css_system_reset2;
 	}
 
 	return ops;
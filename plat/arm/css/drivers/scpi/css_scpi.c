@@ -118,6 +118,17 @@ int scpi_wait_ready(void)
 	return status == SCP_OK ? 0 : -1;
 }
 
+/*
+ * Request a power state for a CPU and its parent power domains.
+ *
+ * The SET_CSS_POWER_STATE payload describes a single CPU, so the requests of
+ * several CPUs cannot be coalesced into one message. The SCP powers down the
+ * parent domains from the request of the last CPU to go down, which already
+ * carries their state. A CPU cannot leave its request to another CPU either:
+ * they may all be in WFI by then, and SCP would never power the CPU down. The
+ * only wait here is therefore for the SCP to consume the previous message, as
+ * this command gets no reply.
+ */
 void scpi_set_css_power_state(unsigned int mpidr,
 		scpi_power_state_t cpu_state, scpi_power_state_t cluster_state,
 		scpi_power_state_t css_state)
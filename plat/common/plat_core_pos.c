@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch.h>
+#include <cassert.h>
+#include <plat_core_pos.h>
+#include <platform.h>
+#include <platform_def.h>
+
+/* An index of 0xff would read as an invalid entry */
+CASSERT(PLATFORM_CORE_COUNT < 0xff, assert_plat_core_pos_count);
+
+/* Keep the table within a few cache lines */
+CASSERT(PLAT_CORE_POS_KEY_BITS <= 10, assert_plat_core_pos_key_bits);
+
+const uint8_t plat_core_pos_table[PLAT_CORE_POS_TABLE_SIZE] = {
+	PLAT_CORE_POS_ENTRIES
+};
+
+/*
+ * Convert an MPIDR to the linear index of the CPU, or -1 if no CPU of the
+ * platform has this MPIDR. plat_my_core_pos() does the same conversion, in
+ * assembly, for the calling CPU.
+ */
+int plat_core_pos_by_mpidr(u_register_t mpidr)
+{
+	mpidr &= MPIDR_AFFINITY_MASK;
+	if ((mpidr & ~PLAT_CORE_POS_MPIDR_MASK) != 0)
+		return -1;
+
+	return (int)plat_core_pos_table[PLAT_CORE_POS_KEY(mpidr)] - 1;
+}
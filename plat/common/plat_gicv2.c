@@ -19,6 +19,7 @@
 #pragma weak plat_ic_get_interrupt_type
 #pragma weak plat_ic_end_of_interrupt
 #pragma weak plat_interrupt_type_to_line
+#pragma weak plat_ic_raise_ns_sgi
 
 /*
  * This function returns the highest priority pending interrupt at
@@ -122,3 +123,11 @@ uint32_t plat_interrupt_type_to_line(uint32_t type,
 	return ((gicv2_is_fiq_enabled()) ? __builtin_ctz(SCR_FIQ_BIT) :
 						__builtin_ctz(SCR_IRQ_BIT));
 }
+
+/*
+ * This function raises the Non-secure SGI `sgi_num` on the calling CPU.
+ */
+void plat_ic_raise_ns_sgi(unsigned int sgi_num)
+{
+	gicv2_raise_ns_sgi(sgi_num);
+}
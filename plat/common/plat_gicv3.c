@@ -25,6 +25,11 @@
 #pragma weak plat_ic_get_interrupt_type
 #pragma weak plat_ic_end_of_interrupt
 #pragma weak plat_interrupt_type_to_line
+#pragma weak plat_ic_is_spurious
+#pragma weak plat_ic_get_running_priority
+#pragma weak plat_ic_set_priority_mask
+#pragma weak plat_ic_set_interrupt_priority
+#pragma weak plat_ic_raise_ns_sgi
 
 CASSERT((INTR_TYPE_S_EL1 == INTR_GROUP1S) &&
 	(INTR_TYPE_NS == INTR_GROUP1NS) &&
@@ -155,6 +160,69 @@ uint32_t plat_interrupt_type_to_line(uint32_t type,
 		return __builtin_ctz(SCR_FIQ_BIT);
 	}
 }
+
+/*
+ * This function returns whether the `id` returned by
+ * plat_ic_acknowledge_interrupt() does not correspond to an interrupt that
+ * has been activated, i.e. whether it is one of the special identifiers.
+ */
+unsigned int plat_ic_is_spurious(unsigned int id)
+{
+	return gicv3_is_intr_id_special_identifier(id);
+}
+
+/*
+ * This function returns the priority of the highest priority active interrupt
+ * of the calling CPU.
+ */
+unsigned int plat_ic_get_running_priority(void)
+{
+	assert(IS_IN_EL3());
+	return gicv3_get_running_priority();
+}
+
+/*
+ * This function sets the priority mask of the calling CPU, masking the
+ * interrupts whose priority is not higher than `mask`, and returns the
+ * previous mask.
+ */
+unsigned int plat_ic_set_priority_mask(unsigned int mask)
+{
+	assert(IS_IN_EL3());
+	return gicv3_set_pmr(mask);
+}
+
+/*
+ * This function sets the priority of the interrupt `id`. The SGIs and PPIs
+ * are those of the calling CPU.
+ */
+void plat_ic_set_interrupt_priority(unsigned int id, unsigned int priority)
+{
+	assert(IS_IN_EL3());
+	gicv3_set_interrupt_priority(id, plat_my_core_pos(), priority);
+}
+
+/*
+ * This function raises the EL3 SGI `sgi_num` on the CPUs whose MPIDR is
+ * `target_group` with Aff0 set to the position of each bit set in `aff0_mask`.
+ */
+void plat_ic_raise_el3_sgi(unsigned int sgi_num, u_register_t target_group,
+			   unsigned int aff0_mask)
+{
+	assert(IS_IN_EL3());
+	gicv3_raise_secure_g0_sgi(sgi_num, target_group, aff0_mask);
+}
+
+/*
+ * This function raises the Non-secure SGI `sgi_num` on the calling CPU.
+ */
+void plat_ic_raise_ns_sgi(unsigned int sgi_num)
+{
+	u_register_t mpidr = read_mpidr_el1();
+
+	assert(IS_IN_EL3());
+	gicv3_raise_ns_g1_sgi(sgi_num, mpidr, 1 << MPIDR_AFFLVL0_VAL(mpidr));
+}
 #endif
 #ifdef IMAGE_BL32
 
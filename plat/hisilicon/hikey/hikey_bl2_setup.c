@@ -294,7 +294,8 @@ void bl2_early_platform_setup(meminfo_t *mem_layout)
 	params.desc_size = 1 << 20;
 	params.clk_rate = 24 * 1000 * 1000;
 	params.bus_width = EMMC_BUS_WIDTH_8;
-	params.flags = EMMC_FLAG_CMD23;
+	/* BL1 has already enumerated the device to load BL2 */
+	params.flags = EMMC_FLAG_CMD23 | EMMC_FLAG_PREINIT;
 	dw_mmc_init(&params);
 
 	hikey_io_setup();
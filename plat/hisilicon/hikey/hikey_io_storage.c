@@ -59,8 +59,10 @@ static const io_block_dev_spec_t emmc_dev_spec = {
 	},
 #endif
 	.ops		= {
-		.read	= emmc_read_blocks,
-		.write	= emmc_write_blocks,
+		.read		= emmc_read_blocks,
+		.write		= emmc_write_blocks,
+		.read_start	= emmc_read_blocks_start,
+		.read_wait	= emmc_read_blocks_wait,
 	},
 	.block_size	= EMMC_BLOCK_SIZE,
 };
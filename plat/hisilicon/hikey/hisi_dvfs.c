@@ -182,6 +182,71 @@ static void acpu_dvfs_clk_div_cfg(unsigned int prof_id,
 	}
 }
 
+/* Configure the voltage detector (VD), used above 800MHz */
+static void acpu_dvfs_vd_cfg(void)
+{
+	write_reg_mask(ACPU_SC_VD_HPM_CTRL, HPM_OSC_DIV_VAL, HPM_OSC_DIV_MASK);
+
+	/*
+	 * - ACPU_SC_VD_HPM_CTRL.hpm_dly_exp = 0xC7A;
+	 * - ACPU_SC_VD_MASK_PATTERN_CTRL[12:0] = 0xCCB;
+	 */
+	write_reg_mask(ACPU_SC_VD_HPM_CTRL, HPM_DLY_EXP_VAL, HPM_DLY_EXP_MASK);
+	write_reg_mask(ACPU_SC_VD_MASK_PATTERN_CTRL,
+		ACPU_SC_VD_MASK_PATTERN_VAL,
+		ACPU_SC_VD_MASK_PATTERN_MASK);
+
+	/*
+	 * - ACPU_SC_VD_DLY_TABLE0_CTRL = 0x1FFF;
+	 * - ACPU_SC_VD_DLY_TABLE1_CTRL = 0x1FFFFFF;
+	 * - ACPU_SC_VD_DLY_TABLE2_CTRL = 0x7FFFFFFF;
+	 * - ACPU_SC_VD_DLY_FIXED_CTRL  = 0x1;
+	 */
+	mmio_write_32(ACPU_SC_VD_DLY_TABLE0_CTRL, 0x1FFF);
+	mmio_write_32(ACPU_SC_VD_DLY_TABLE1_CTRL, 0x1FFFFFF);
+	mmio_write_32(ACPU_SC_VD_DLY_TABLE2_CTRL, 0x7FFFFFFF);
+	mmio_write_32(ACPU_SC_VD_DLY_FIXED_CTRL, 0x1);
+
+	/*
+	 * - ACPU_SC_VD_CTRL.shift_table0 = 0x1;
+	 * - ACPU_SC_VD_CTRL.shift_table1 = 0x3;
+	 * - ACPU_SC_VD_CTRL.shift_table2 = 0x5;
+	 * - ACPU_SC_VD_CTRL.shift_table3 = 0x6;
+	 * - ACPU_SC_VD_CTRL.tune = 0x7;
+	 */
+	write_reg_mask(ACPU_SC_VD_CTRL,
+		ACPU_SC_VD_SHIFT_TABLE_TUNE_VAL,
+		ACPU_SC_VD_SHIFT_TABLE_TUNE_MASK);
+}
+
+/* Relock the ACPU PLL to the frequency of a profile */
+static void acpu_dvfs_pll_cfg(unsigned int prof_id)
+{
+	unsigned int count;
+
+	/* ACPUPLLCTRL.acpupll_en_cfg = 0x0 */
+	write_reg_mask(PMCTRL_ACPUPLLCTRL, 0x0,
+		0x1 << SOC_PMCTRL_ACPUPLLCTRL_acpupll_en_cfg_START);
+
+	/* set PMCTRL_ACPUPLLFREQ and PMCTRL_ACPUPLLFRAC */
+	mmio_write_32(PMCTRL_ACPUPLLFREQ,
+		acpu_dvfs_profile[prof_id].acpu_pll_freq);
+	mmio_write_32(PMCTRL_ACPUPLLFRAC,
+		acpu_dvfs_profile[prof_id].acpu_pll_frac);
+
+	/*
+	 * - wait for 1us;
+	 * - PMCTRL_ACPUPLLCTRL.acpupll_en_cfg = 0x1
+	 */
+	count = 0;
+	while (count < ACPU_WAIT_TIMEOUT)
+		count++;
+
+	write_reg_mask(PMCTRL_ACPUPLLCTRL,
+		0x1 << SOC_PMCTRL_ACPUPLLCTRL_acpupll_en_cfg_START,
+		0x1 << SOC_PMCTRL_ACPUPLLCTRL_acpupll_en_cfg_START);
+}
+
 static int acpu_dvfs_freq_ascend(unsigned int cur_prof, unsigned int tar_prof)
 {
 	unsigned int reg0 = 0;
@@ -227,72 +292,12 @@ static int acpu_dvfs_freq_ascend(unsigned int cur_prof, unsigned int tar_prof)
 		}
 	} while (reg0 != 0x1);
 
-	/* Enable VD functionality if > 800MHz */
-	if (acpu_dvfs_profile[tar_prof].freq > 800000) {
-
-		write_reg_mask(ACPU_SC_VD_HPM_CTRL,
-			HPM_OSC_DIV_VAL, HPM_OSC_DIV_MASK);
-
-		/*
-		 * step 5:
-		 *  - ACPU_SC_VD_HPM_CTRL.hpm_dly_exp = 0xC7A;
-		 *  - ACPU_SC_VD_MASK_PATTERN_CTRL[12:0] = 0xCCB;
-		 */
-		write_reg_mask(ACPU_SC_VD_HPM_CTRL,
-			HPM_DLY_EXP_VAL, HPM_DLY_EXP_MASK);
-		write_reg_mask(ACPU_SC_VD_MASK_PATTERN_CTRL,
-			ACPU_SC_VD_MASK_PATTERN_VAL,
-			ACPU_SC_VD_MASK_PATTERN_MASK);
-
-		/*
-		 * step 6:
-		 *  - ACPU_SC_VD_DLY_TABLE0_CTRL = 0x1FFF;
-		 *  - ACPU_SC_VD_DLY_TABLE1_CTRL = 0x1FFFFFF;
-		 *  - ACPU_SC_VD_DLY_TABLE2_CTRL = 0x7FFFFFFF;
-		 *  - ACPU_SC_VD_DLY_FIXED_CTRL  = 0x1;
-		 */
-		mmio_write_32(ACPU_SC_VD_DLY_TABLE0_CTRL, 0x1FFF);
-		mmio_write_32(ACPU_SC_VD_DLY_TABLE1_CTRL, 0x1FFFFFF);
-		mmio_write_32(ACPU_SC_VD_DLY_TABLE2_CTRL, 0x7FFFFFFF);
-		mmio_write_32(ACPU_SC_VD_DLY_FIXED_CTRL, 0x1);
-
-		/*
-		 * step 7:
-		 *  - ACPU_SC_VD_CTRL.shift_table0 = 0x1;
-		 *  - ACPU_SC_VD_CTRL.shift_table1 = 0x3;
-		 *  - ACPU_SC_VD_CTRL.shift_table2 = 0x5;
-		 *  - ACPU_SC_VD_CTRL.shift_table3 = 0x6;
-		 *
-		 * step 8:
-		 *  - ACPU_SC_VD_CTRL.tune = 0x7;
-		 */
-		write_reg_mask(ACPU_SC_VD_CTRL,
-			ACPU_SC_VD_SHIFT_TABLE_TUNE_VAL,
-			ACPU_SC_VD_SHIFT_TABLE_TUNE_MASK);
-	}
-
-	/* step 9: ACPUPLLCTRL.acpupll_en_cfg = 0x0 */
-	write_reg_mask(PMCTRL_ACPUPLLCTRL, 0x0,
-		0x1 << SOC_PMCTRL_ACPUPLLCTRL_acpupll_en_cfg_START);
-
-	/* step 10: set PMCTRL_ACPUPLLFREQ and PMCTRL_ACPUPLLFRAC */
-	mmio_write_32(PMCTRL_ACPUPLLFREQ,
-		acpu_dvfs_profile[tar_prof].acpu_pll_freq);
-	mmio_write_32(PMCTRL_ACPUPLLFRAC,
-		acpu_dvfs_profile[tar_prof].acpu_pll_frac);
-
-	/*
-	 * step 11:
-	 *  - wait for 1us;
-	 *  - PMCTRL_ACPUPLLCTRL.acpupll_en_cfg = 0x1
-	 */
-	count = 0;
-	while (count < ACPU_WAIT_TIMEOUT)
-		count++;
+	/* step 5 - 8: enable VD functionality if > 800MHz */
+	if (acpu_dvfs_profile[tar_prof].freq > 800000)
+		acpu_dvfs_vd_cfg();
 
-	write_reg_mask(PMCTRL_ACPUPLLCTRL,
-		0x1 << SOC_PMCTRL_ACPUPLLCTRL_acpupll_en_cfg_START,
-		0x1 << SOC_PMCTRL_ACPUPLLCTRL_acpupll_en_cfg_START);
+	/* step 9 - 11: program the ACPU PLL for the target profile */
+	acpu_dvfs_pll_cfg(tar_prof);
 
 	/* step 12: PMCTRL_ACPUVOLPMUADDR = 0x100da */
 	mmio_write_32(PMCTRL_ACPUVOLPMUADDR, 0x100da);
@@ -419,75 +424,12 @@ static int acpu_dvfs_freq_descend(unsigned int cur_prof, unsigned int tar_prof)
 		}
 	} while (reg0 != 0x1);
 
-	/*
-	 * Step 5:
-	 *  - PMCTRL_ACPUPLLCTRL.acpupll_en_cfg = 0x0
-	 */
-	write_reg_mask(PMCTRL_ACPUPLLCTRL, 0x0, 0x1 << 0);
+	/* step 5 - 7: program the ACPU PLL for the target profile */
+	acpu_dvfs_pll_cfg(tar_prof);
 
-	/*
-	 * step 6
-	 *  - Config PMCTRL_ACPUPLLFREQ and ACPUPLLFRAC
-	 */
-	mmio_write_32(PMCTRL_ACPUPLLFREQ, acpu_dvfs_profile[tar_prof].acpu_pll_freq);
-	mmio_write_32(PMCTRL_ACPUPLLFRAC, acpu_dvfs_profile[tar_prof].acpu_pll_frac);
-
-	/*
-	 * step 7:
-	 *  - Wait 1us;
-	 *  - Config PMCTRL_ACPUPLLCTRL.acpupll_en_cfg = 0x1
-	 */
-	count = 0;
-	while (count < ACPU_WAIT_TIMEOUT)
-		count++;
-
-	write_reg_mask(PMCTRL_ACPUPLLCTRL,
-		0x1 << SOC_PMCTRL_ACPUPLLCTRL_acpupll_en_cfg_START,
-		0x1 << SOC_PMCTRL_ACPUPLLCTRL_acpupll_en_cfg_START);
-
-	/* Enable VD functionality if > 800MHz */
-	if (acpu_dvfs_profile[tar_prof].freq > 800000) {
-
-		write_reg_mask(ACPU_SC_VD_HPM_CTRL,
-			HPM_OSC_DIV_VAL, HPM_OSC_DIV_MASK);
-
-		/*
-		 * step 9:
-		 *  - ACPU_SC_VD_HPM_CTRL.hpm_dly_exp = 0xC7A;
-		 *  - ACPU_SC_VD_MASK_PATTERN_CTRL[12:0] = 0xCCB;
-		 */
-		write_reg_mask(ACPU_SC_VD_HPM_CTRL,
-			HPM_DLY_EXP_VAL, HPM_DLY_EXP_MASK);
-		write_reg_mask(ACPU_SC_VD_MASK_PATTERN_CTRL,
-			ACPU_SC_VD_MASK_PATTERN_VAL,
-			ACPU_SC_VD_MASK_PATTERN_MASK);
-
-		/*
-		 * step 10:
-		 *  - ACPU_SC_VD_DLY_TABLE0_CTRL = 0x1FFF;
-		 *  - ACPU_SC_VD_DLY_TABLE1_CTRL = 0x1FFFFFF;
-		 *  - ACPU_SC_VD_DLY_TABLE2_CTRL = 0x7FFFFFFF;
-		 *  - ACPU_SC_VD_DLY_FIXED_CTRL  = 0x1;
-		 */
-		mmio_write_32(ACPU_SC_VD_DLY_TABLE0_CTRL, 0x1FFF);
-		mmio_write_32(ACPU_SC_VD_DLY_TABLE1_CTRL, 0x1FFFFFF);
-		mmio_write_32(ACPU_SC_VD_DLY_TABLE2_CTRL, 0x7FFFFFFF);
-		mmio_write_32(ACPU_SC_VD_DLY_FIXED_CTRL, 0x1);
-
-		/*
-		 * step 11:
-		 *  - ACPU_SC_VD_CTRL.shift_table0 = 0x1;
-		 *  - ACPU_SC_VD_CTRL.shift_table1 = 0x3;
-		 *  - ACPU_SC_VD_CTRL.shift_table2 = 0x5;
-		 *  - ACPU_SC_VD_CTRL.shift_table3 = 0x6;
-		 *
-		 * step 12:
-		 *  - ACPU_SC_VD_CTRL.tune = 0x7;
-		 */
-		write_reg_mask(ACPU_SC_VD_CTRL,
-			ACPU_SC_VD_SHIFT_TABLE_TUNE_VAL,
-			ACPU_SC_VD_SHIFT_TABLE_TUNE_MASK);
-	}
+	/* step 9 - 12: enable VD functionality if > 800MHz */
+	if (acpu_dvfs_profile[tar_prof].freq > 800000)
+		acpu_dvfs_vd_cfg();
 
 	/*
 	 * step 13:
@@ -90,6 +90,13 @@ void hisi_ipc_spin_unlock(unsigned int signal)
 	mmio_write_32(HISI_IPC_ACPU_CTRL(signal), 0);
 }
 
+/*
+ * ACPU_CORE_POWERDOWN_FLAGS_ADDR holds a request field for each CPU, which the
+ * MCU firmware scans on every IPI, and the semaphore is only held while the
+ * field of the calling CPU is updated. The firmware defines this protocol and
+ * has no request carrying a mask of CPUs: the IPI source tells it which CPU to
+ * act on.
+ */
 void hisi_ipc_cpu_on_off(unsigned int cpu, unsigned int cluster,
 			 unsigned int mode)
 {
@@ -6,11 +6,14 @@
 #include <assert.h>
 #include <console.h>
 #include <debug.h>
+#include <errno.h>
 #include <mmio.h>
 #include <mtk_plat_common.h>
 #include <mtk_sip_svc.h>
 #include <plat_sip_calls.h>
+#include <platform.h>
 #include <runtime_svc.h>
+#include <trace_event.h>
 #include <uuid.h>
 
 /* Mediatek SiP Service UUID */
@@ -70,6 +73,28 @@ uint64_t mediatek_sip_handler(uint32_t smc_fid,
 		case MTK_SIP_KERNEL_BOOT_AARCH32:
 			boot_to_kernel(x1, x2, x3, x4);
 			SMC_RET0(handle);
+#endif
+#if ENABLE_TRACE_EVENTS
+		case MTK_SIP_TRACE_READ_AARCH64: {
+			unsigned long long seq = x2;
+			trace_event_t event;
+			int cpu_idx;
+
+			/*
+			 * x1: MPIDR of the CPU, x2: sequence number of the
+			 * event. Return the error code, the sequence number
+			 * of the event read, its time-stamp, its ID and its
+			 * four arguments.
+			 */
+			cpu_idx = plat_core_pos_by_mpidr(x1);
+			if ((cpu_idx < 0) ||
+			    (trace_event_read(cpu_idx, &seq, &event)))
+				SMC_RET1(handle, -ENOENT);
+
+			SMC_RET8(handle, 0, seq, event.timestamp, event.id,
+				 event.args[0], event.args[1], event.args[2],
+				 event.args[3]);
+		}
 #endif
 		}
 	}
@@ -21,7 +21,11 @@
 #define SMC_AARCH64_BIT		0x40000000
 
 /* Number of Mediatek SiP Calls implemented */
+#if ENABLE_TRACE_EVENTS
+#define MTK_COMMON_SIP_NUM_CALLS	5
+#else
 #define MTK_COMMON_SIP_NUM_CALLS	4
+#endif
 
 /* Mediatek SiP Service Calls function IDs */
 #define MTK_SIP_SET_AUTHORIZED_SECURE_REG	0x82000001
@@ -31,6 +35,9 @@
 #define MTK_SIP_KERNEL_BOOT_AARCH32		0x82000200
 #define MTK_SIP_KERNEL_BOOT_AARCH64		0xC2000200
 
+/* Read an event of the binary trace ring of a CPU */
+#define MTK_SIP_TRACE_READ_AARCH64		0xC2000300
+
 /* Mediatek SiP Calls error code */
 enum {
 	MTK_SIP_E_SUCCESS = 0,
@@ -230,6 +230,27 @@ static const struct spm_lp_scen spm_mcdi = {
 	.pwrctrl = &mcdi_ctrl,
 };
 
+#define MCDI_LINEAR_ID(mpidr)	((((mpidr) & MPIDR_CLUSTER_MASK) >> 6) | \
+				 ((mpidr) & MPIDR_CPU_MASK))
+#define MCDI_CLUSTER_ID(mpidr)	(((mpidr) & MPIDR_CLUSTER_MASK) >> \
+				 MPIDR_AFFINITY_BITS)
+
+#define MCDI_REG_UNKNOWN	0
+#define MCDI_REG_CLEAR		1
+#define MCDI_REG_SET		2
+
+/*
+ * Last WFI select state programmed for each CPU and cluster power control
+ * state programmed for each cluster, to skip programming them again. Loading
+ * another SPM firmware reprograms these registers, so the states are only
+ * trusted while the MCDI firmware is loaded and are reset when it is loaded
+ * again. They are accessed with the data cache disabled on the way up.
+ */
+static unsigned char mcdi_wfi_sel[PLATFORM_CORE_COUNT]
+	__section("tzfw_coherent_mem");
+static unsigned char mcdi_cputop_pwrctrl[PLATFORM_CLUSTER_COUNT]
+	__section("tzfw_coherent_mem");
+
 void spm_mcdi_cpu_wake_up_event(int wake_up_event, int disable_dormant_power)
 {
 	if (((mmio_read_32(SPM_SLEEP_CPU_WAKEUP_EVENT) & 0x1) == 1)
@@ -298,106 +319,47 @@ void spm_mcdi_wakeup_all_cores(void)
 	clear_all_ready();
 }
 
+/*
+ * Program the WFI select of a CPU, unless it is known to be programmed
+ * already. This is the case for the second call made when the cluster goes
+ * off along with the CPU.
+ */
 static void spm_mcdi_wfi_sel_enter(unsigned long mpidr)
 {
-	int core_id_val = mpidr & MPIDR_CPU_MASK;
-	int cluster_id = (mpidr & MPIDR_CLUSTER_MASK) >> MPIDR_AFFINITY_BITS;
+	unsigned int cpu_id = mpidr & MPIDR_CPU_MASK;
+	unsigned int linear_id = MCDI_LINEAR_ID(mpidr);
+
+	if (mcdi_wfi_sel[linear_id] == MCDI_REG_SET)
+		return;
 
 	/* SPM WFI Select by core number */
-	if (cluster_id) {
-		switch (core_id_val) {
-		case 0:
-			mmio_write_32(SPM_CA15_CPU0_IRQ_MASK, 1);
-			mmio_write_32(SPM_SLEEP_CA15_WFI0_EN, 1);
-			break;
-		case 1:
-			mmio_write_32(SPM_CA15_CPU1_IRQ_MASK, 1);
-			mmio_write_32(SPM_SLEEP_CA15_WFI1_EN, 1);
-			break;
-		case 2:
-			mmio_write_32(SPM_CA15_CPU2_IRQ_MASK, 1);
-			mmio_write_32(SPM_SLEEP_CA15_WFI2_EN, 1);
-			break;
-		case 3:
-			mmio_write_32(SPM_CA15_CPU3_IRQ_MASK, 1);
-			mmio_write_32(SPM_SLEEP_CA15_WFI3_EN, 1);
-			break;
-		default:
-			break;
-		}
+	if (mpidr & MPIDR_CLUSTER_MASK) {
+		mmio_write_32(SPM_CA15_CPU0_IRQ_MASK + 4 * cpu_id, 1);
+		mmio_write_32(SPM_SLEEP_CA15_WFI0_EN + 4 * cpu_id, 1);
 	} else {
-		switch (core_id_val) {
-		case 0:
-			mmio_write_32(SPM_CA7_CPU0_IRQ_MASK, 1);
-			mmio_write_32(SPM_SLEEP_CA7_WFI0_EN, 1);
-			break;
-		case 1:
-			mmio_write_32(SPM_CA7_CPU1_IRQ_MASK, 1);
-			mmio_write_32(SPM_SLEEP_CA7_WFI1_EN, 1);
-			break;
-		case 2:
-			mmio_write_32(SPM_CA7_CPU2_IRQ_MASK, 1);
-			mmio_write_32(SPM_SLEEP_CA7_WFI2_EN, 1);
-			break;
-		case 3:
-			mmio_write_32(SPM_CA7_CPU3_IRQ_MASK, 1);
-			mmio_write_32(SPM_SLEEP_CA7_WFI3_EN, 1);
-			break;
-		default:
-			break;
-		}
+		mmio_write_32(SPM_CA7_CPU0_IRQ_MASK + 4 * cpu_id, 1);
+		mmio_write_32(SPM_SLEEP_CA7_WFI0_EN + 4 * cpu_id, 1);
 	}
+	mcdi_wfi_sel[linear_id] = MCDI_REG_SET;
 }
 
 static void spm_mcdi_wfi_sel_leave(unsigned long mpidr)
 {
-	int core_id_val = mpidr & MPIDR_CPU_MASK;
-	int cluster_id = (mpidr & MPIDR_CLUSTER_MASK) >> MPIDR_AFFINITY_BITS;
+	unsigned int cpu_id = mpidr & MPIDR_CPU_MASK;
+	unsigned int linear_id = MCDI_LINEAR_ID(mpidr);
+
+	if (is_mcdi_ready() && (mcdi_wfi_sel[linear_id] == MCDI_REG_CLEAR))
+		return;
 
 	/* SPM WFI Select by core number */
-	if (cluster_id) {
-		switch (core_id_val) {
-		case 0:
-			mmio_write_32(SPM_SLEEP_CA15_WFI0_EN, 0);
-			mmio_write_32(SPM_CA15_CPU0_IRQ_MASK, 0);
-			break;
-		case 1:
-			mmio_write_32(SPM_SLEEP_CA15_WFI1_EN, 0);
-			mmio_write_32(SPM_CA15_CPU1_IRQ_MASK, 0);
-			break;
-		case 2:
-			mmio_write_32(SPM_SLEEP_CA15_WFI2_EN, 0);
-			mmio_write_32(SPM_CA15_CPU2_IRQ_MASK, 0);
-			break;
-		case 3:
-			mmio_write_32(SPM_SLEEP_CA15_WFI3_EN, 0);
-			mmio_write_32(SPM_CA15_CPU3_IRQ_MASK, 0);
-			break;
-		default:
-			break;
-		}
+	if (mpidr & MPIDR_CLUSTER_MASK) {
+		mmio_write_32(SPM_SLEEP_CA15_WFI0_EN + 4 * cpu_id, 0);
+		mmio_write_32(SPM_CA15_CPU0_IRQ_MASK + 4 * cpu_id, 0);
 	} else {
-		switch (core_id_val) {
-		case 0:
-			mmio_write_32(SPM_SLEEP_CA7_WFI0_EN, 0);
-			mmio_write_32(SPM_CA7_CPU0_IRQ_MASK, 0);
-			break;
-		case 1:
-			mmio_write_32(SPM_SLEEP_CA7_WFI1_EN, 0);
-			mmio_write_32(SPM_CA7_CPU1_IRQ_MASK, 0);
-			break;
-		case 2:
-			mmio_write_32(SPM_SLEEP_CA7_WFI2_EN, 0);
-			mmio_write_32(SPM_CA7_CPU2_IRQ_MASK, 0);
-			break;
-		case 3:
-			mmio_write_32(SPM_SLEEP_CA7_WFI3_EN, 0);
-			mmio_write_32(SPM_CA7_CPU3_IRQ_MASK, 0);
-			break;
-		default:
-			break;
-		}
+		mmio_write_32(SPM_SLEEP_CA7_WFI0_EN + 4 * cpu_id, 0);
+		mmio_write_32(SPM_CA7_CPU0_IRQ_MASK + 4 * cpu_id, 0);
 	}
+	mcdi_wfi_sel[linear_id] = MCDI_REG_CLEAR;
 }
 
 static void spm_mcdi_set_cputop_pwrctrl_for_cluster_off(unsigned long mpidr)
@@ -416,9 +378,11 @@ static void spm_mcdi_set_cputop_pwrctrl_for_cluster_off(unsigned long mpidr)
 			shift = i + PCM_MCDI_CA72_PWRSTA_SHIFT;
 			flag |= (pwr_status & (1 << shift)) >> shift;
 		}
-		if (!flag)
+		if (!flag) {
 			mmio_setbits_32(SPM_PCM_RESERVE,
 					PCM_MCDI_CA72_CPUTOP_PWRCTL);
+			mcdi_cputop_pwrctrl[1] = MCDI_REG_SET;
+		}
 	} else {
 		for (i = 0; i < PLATFORM_CLUSTER0_CORE_COUNT; i++) {
 			if (i == cpu_id)
@@ -426,15 +390,21 @@ static void spm_mcdi_set_cputop_pwrctrl_for_cluster_off(unsigned long mpidr)
 			shift = i + PCM_MCDI_CA53_PWRSTA_SHIFT;
 			flag |= (pwr_status & (1 << shift)) >> shift;
 		}
-		if (!flag)
+		if (!flag) {
 			mmio_setbits_32(SPM_PCM_RESERVE,
 					PCM_MCDI_CA53_CPUTOP_PWRCTL);
+			mcdi_cputop_pwrctrl[0] = MCDI_REG_SET;
+		}
 	}
 }
 
 static void spm_mcdi_clear_cputop_pwrctrl_for_cluster_on(unsigned long mpidr)
 {
-	unsigned long cluster_id = mpidr & MPIDR_CLUSTER_MASK;
+	unsigned long cluster_id = MCDI_CLUSTER_ID(mpidr);
+
+	if (is_mcdi_ready() &&
+	    (mcdi_cputop_pwrctrl[cluster_id] == MCDI_REG_CLEAR))
+		return;
 
 	if (cluster_id)
 		mmio_clrbits_32(SPM_PCM_RESERVE,
@@ -442,12 +412,14 @@ static void spm_mcdi_clear_cputop_pwrctrl_for_cluster_on(unsigned long mpidr)
 	else
 		mmio_clrbits_32(SPM_PCM_RESERVE,
 				PCM_MCDI_CA53_CPUTOP_PWRCTL);
+	mcdi_cputop_pwrctrl[cluster_id] = MCDI_REG_CLEAR;
 }
 
-void spm_mcdi_prepare_for_mtcmos(void)
+static void spm_mcdi_load(void)
 {
 	const struct pcm_desc *pcmdesc = spm_mcdi.pcmdesc;
 	struct pwr_ctrl *pwrctrl = spm_mcdi.pwrctrl;
+	unsigned int i;
 
 	if (is_mcdi_ready() == 0) {
 		if (is_hotplug_ready() == 1)
@@ -459,26 +431,23 @@ void spm_mcdi_prepare_for_mtcmos(void)
 		spm_set_wakeup_event(pwrctrl);
 		spm_kick_pcm_to_run(pwrctrl);
 		set_mcdi_ready();
+
+		for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+			mcdi_wfi_sel[i] = MCDI_REG_UNKNOWN;
+		for (i = 0; i < PLATFORM_CLUSTER_COUNT; i++)
+			mcdi_cputop_pwrctrl[i] = MCDI_REG_UNKNOWN;
 	}
 }
 
-void spm_mcdi_prepare_for_off_state(unsigned long mpidr, unsigned int afflvl)
+void spm_mcdi_prepare_for_mtcmos(void)
 {
-	const struct pcm_desc *pcmdesc = spm_mcdi.pcmdesc;
-	struct pwr_ctrl *pwrctrl = spm_mcdi.pwrctrl;
+	spm_mcdi_load();
+}
 
+void spm_mcdi_prepare_for_off_state(unsigned long mpidr, unsigned int afflvl)
+{
 	spm_lock_get();
-	if (is_mcdi_ready() == 0) {
-		if (is_hotplug_ready() == 1)
-			spm_clear_hotplug();
-		set_pwrctrl_pcm_flags(pwrctrl, 0);
-		spm_reset_and_init_pcm();
-		spm_kick_im_to_fetch(pcmdesc);
-		spm_set_power_control(pwrctrl);
-		spm_set_wakeup_event(pwrctrl);
-		spm_kick_pcm_to_run(pwrctrl);
-		set_mcdi_ready();
-	}
+	spm_mcdi_load();
 	spm_mcdi_wfi_sel_enter(mpidr);
 	if (afflvl == MPIDR_AFFLVL1)
 		spm_mcdi_set_cputop_pwrctrl_for_cluster_off(mpidr);
@@ -487,10 +456,7 @@ void spm_mcdi_prepare_for_off_state(unsigned long mpidr, unsigned int afflvl)
 
 void spm_mcdi_finish_for_on_state(unsigned long mpidr, unsigned int afflvl)
 {
-	unsigned long linear_id;
-
-	linear_id = ((mpidr & MPIDR_CLUSTER_MASK) >> 6) |
-			(mpidr & MPIDR_CPU_MASK);
+	unsigned long linear_id = MCDI_LINEAR_ID(mpidr);
 
 	spm_lock_get();
 	spm_mcdi_clear_cputop_pwrctrl_for_cluster_on(mpidr);
@@ -7,6 +7,8 @@
 #ifndef __POWER_TRACER_H__
 #define __POWER_TRACER_H__
 
+#include <trace_event.h>
+
 #define CPU_UP		0
 #define CPU_DOWN	1
 #define CPU_SUSPEND	2
@@ -14,6 +16,9 @@
 #define CLUSTER_DOWN	4
 #define CLUSTER_SUSPEND	5
 
+/* Trace event of a power mode change: mpidr, mode */
+#define MTK_TRACE_EV_POWER_FLOW	TRACE_EV_PLAT_BASE
+
 void trace_power_flow(unsigned long mpidr, unsigned char mode);
 
 #endif
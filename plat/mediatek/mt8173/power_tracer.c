@@ -12,6 +12,14 @@
 
 void trace_power_flow(unsigned long mpidr, unsigned char mode)
 {
+#if ENABLE_TRACE_EVENTS
+	/*
+	 * Record the event in the binary trace ring of the CPU, which is
+	 * read with the MTK_SIP_TRACE_READ_AARCH64 SiP call, rather than
+	 * printing it on the console from the PSCI path.
+	 */
+	TRACE_EVENT(MTK_TRACE_EV_POWER_FLOW, mpidr, mode, 0, 0);
+#else
 	switch (mode) {
 	case CPU_UP:
 		trace_log("core %ld:%ld ON\n",
@@ -44,4 +52,5 @@ void trace_power_flow(unsigned long mpidr, unsigned char mode)
 		trace_log("unknown power mode\n");
 		break;
 	}
+#endif
 }
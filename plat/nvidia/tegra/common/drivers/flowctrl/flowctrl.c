@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -13,6 +13,7 @@
 #include <cortex_a53.h>
 #include <flowctrl.h>
 #include <tegra_def.h>
+#include <utils_def.h>
 
 #define CLK_RST_DEV_L_SET		0x300
 #define CLK_RST_DEV_L_CLR		0x304
@@ -41,36 +42,58 @@ static const uint64_t flowctrl_offset_cc4_ctrl[4] = {
 	(TEGRA_FLOWCTRL_BASE + FLOWCTRL_CC4_CORE0_CTRL + 12)
 };
 
-static inline void tegra_fc_cc4_ctrl(int cpu_id, uint32_t val)
+/*******************************************************************************
+ * Apply a power-down request to the flow controller registers of a CPU. All the
+ * registers are written first and only the last one is read back: the writes
+ * to the flow controller reach it in order, so this single read is enough to
+ * know that the whole request has been applied before the CPU enters WFI.
+ ******************************************************************************/
+void tegra_fc_pwrdn_apply(int cpu_id, const tegra_fc_pwrdn_req_t *req)
 {
-	mmio_write_32(flowctrl_offset_cc4_ctrl[cpu_id], val);
-	val = mmio_read_32(flowctrl_offset_cc4_ctrl[cpu_id]);
-}
+	unsigned int i;
 
-static inline void tegra_fc_cpu_csr(int cpu_id, uint32_t val)
-{
-	mmio_write_32(flowctrl_offset_cpu_csr[cpu_id], val);
-	val = mmio_read_32(flowctrl_offset_cpu_csr[cpu_id]);
+	assert(cpu_id < ARRAY_SIZE(flowctrl_offset_cpu_csr));
+
+	for (i = 0; i < ARRAY_SIZE(flowctrl_offset_cc4_ctrl); i++) {
+		if (req->cc4_cpus & (1U << i))
+			mmio_write_32(flowctrl_offset_cc4_ctrl[i], 0);
+	}
+
+	if (req->flags & FLOWCTRL_REQ_L2_FLUSH)
+		tegra_fc_write_32(FLOWCTRL_L2_FLUSH_CONTROL, req->l2_flush);
+
+	mmio_write_32(flowctrl_offset_halt_cpu[cpu_id], req->halt);
+	mmio_write_32(flowctrl_offset_cpu_csr[cpu_id], req->csr);
+	(void)mmio_read_32(flowctrl_offset_cpu_csr[cpu_id]);
 }
 
-static inline void tegra_fc_halt_cpu(int cpu_id, uint32_t val)
+/* Request to power down the CPU on WFI, in addition to 'csr' */
+static void tegra_fc_suspend_req(int cpu_id, uint32_t csr,
+				 tegra_fc_pwrdn_req_t *req)
 {
-	mmio_write_32(flowctrl_offset_halt_cpu[cpu_id], val);
-	val = mmio_read_32(flowctrl_offset_halt_cpu[cpu_id]);
+	req->halt = FLOWCTRL_HALT_GIC_IRQ | FLOWCTRL_HALT_GIC_FIQ |
+		    FLOWCTRL_HALT_LIC_IRQ | FLOWCTRL_HALT_LIC_FIQ |
+		    FLOWCTRL_WAITEVENT;
+	req->csr = FLOWCTRL_CSR_INTR_FLAG | FLOWCTRL_CSR_EVENT_FLAG |
+		   FLOWCTRL_CSR_ENABLE | (FLOWCTRL_WAIT_WFI_BITMAP << cpu_id) |
+		   csr;
+	req->cc4_cpus = 0;
+	req->flags = 0;
+	req->l2_flush = 0;
 }
 
-static void tegra_fc_prepare_suspend(int cpu_id, uint32_t csr)
+/*
+ * Request of the last CPU of a cluster to power it down in the state 'csr'.
+ * The other CPUs of the cluster are already down, so their CC4 is disabled
+ * along with the one of the calling CPU in the same request.
+ */
+static void tegra_fc_cluster_req(int cpu_id, uint32_t csr, uint32_t l2_flush,
+				 tegra_fc_pwrdn_req_t *req)
 {
-	uint32_t val;
-
-	val = FLOWCTRL_HALT_GIC_IRQ | FLOWCTRL_HALT_GIC_FIQ |
-	      FLOWCTRL_HALT_LIC_IRQ | FLOWCTRL_HALT_LIC_FIQ |
-	      FLOWCTRL_WAITEVENT;
-	tegra_fc_halt_cpu(cpu_id, val);
-
-	val = FLOWCTRL_CSR_INTR_FLAG | FLOWCTRL_CSR_EVENT_FLAG |
-	      FLOWCTRL_CSR_ENABLE | (FLOWCTRL_WAIT_WFI_BITMAP << cpu_id);
-	tegra_fc_cpu_csr(cpu_id, val | csr);
+	tegra_fc_suspend_req(cpu_id, csr, req);
+	req->cc4_cpus = FLOWCTRL_CLUSTER_CPUS;
+	req->flags = FLOWCTRL_REQ_L2_FLUSH;
+	req->l2_flush = l2_flush;
 }
 
 /*******************************************************************************
@@ -79,9 +102,11 @@ static void tegra_fc_prepare_suspend(int cpu_id, uint32_t csr)
 void tegra_fc_cpu_powerdn(uint32_t mpidr)
 {
 	int cpu = mpidr & MPIDR_CPU_MASK;
+	tegra_fc_pwrdn_req_t req;
 
 	VERBOSE("CPU%d powering down...\n", cpu);
-	tegra_fc_prepare_suspend(cpu, 0);
+	tegra_fc_suspend_req(cpu, 0, &req);
+	tegra_fc_pwrdn_apply(cpu, &req);
 }
 
 /*******************************************************************************
@@ -90,19 +115,17 @@ void tegra_fc_cpu_powerdn(uint32_t mpidr)
 void tegra_fc_cluster_idle(uint32_t mpidr)
 {
 	int cpu = mpidr & MPIDR_CPU_MASK;
-	uint32_t val;
+	tegra_fc_pwrdn_req_t req;
 
 	VERBOSE("Entering cluster idle state...\n");
 
-	tegra_fc_cc4_ctrl(cpu, 0);
-
-	/* hardware L2 flush is faster for A53 only */
-	tegra_fc_write_32(FLOWCTRL_L2_FLUSH_CONTROL,
-		!!MPIDR_AFFLVL1_VAL(mpidr));
-
-	/* suspend the CPU cluster */
-	val = FLOWCTRL_PG_CPU_NONCPU << FLOWCTRL_ENABLE_EXT;
-	tegra_fc_prepare_suspend(cpu, val);
+	/*
+	 * Suspend the CPU cluster. The hardware L2 flush is faster for A53
+	 * only.
+	 */
+	tegra_fc_cluster_req(cpu, FLOWCTRL_PG_CPU_NONCPU << FLOWCTRL_ENABLE_EXT,
+			     !!MPIDR_AFFLVL1_VAL(mpidr), &req);
+	tegra_fc_pwrdn_apply(cpu, &req);
 }
 
 /*******************************************************************************
@@ -111,19 +134,18 @@ void tegra_fc_cluster_idle(uint32_t mpidr)
 void tegra_fc_cluster_powerdn(uint32_t mpidr)
 {
 	int cpu = mpidr & MPIDR_CPU_MASK;
-	uint32_t val;
+	tegra_fc_pwrdn_req_t req;
 
 	VERBOSE("Entering cluster powerdn state...\n");
 
-	tegra_fc_cc4_ctrl(cpu, 0);
-
-	/* hardware L2 flush is faster for A53 only */
-	tegra_fc_write_32(FLOWCTRL_L2_FLUSH_CONTROL,
-		read_midr() == CORTEX_A53_MIDR);
-
-	/* power down the CPU cluster */
-	val = FLOWCTRL_TURNOFF_CPURAIL << FLOWCTRL_ENABLE_EXT;
-	tegra_fc_prepare_suspend(cpu, val);
+	/*
+	 * Power down the CPU cluster. The hardware L2 flush is faster for A53
+	 * only.
+	 */
+	tegra_fc_cluster_req(cpu,
+			     FLOWCTRL_TURNOFF_CPURAIL << FLOWCTRL_ENABLE_EXT,
+			     read_midr() == CORTEX_A53_MIDR, &req);
+	tegra_fc_pwrdn_apply(cpu, &req);
 }
 
 /*******************************************************************************
@@ -132,19 +154,17 @@ void tegra_fc_cluster_powerdn(uint32_t mpidr)
 void tegra_fc_soc_powerdn(uint32_t mpidr)
 {
 	int cpu = mpidr & MPIDR_CPU_MASK;
-	uint32_t val;
+	tegra_fc_pwrdn_req_t req;
 
 	VERBOSE("Entering SoC powerdn state...\n");
 
-	tegra_fc_cc4_ctrl(cpu, 0);
-
-	tegra_fc_write_32(FLOWCTRL_L2_FLUSH_CONTROL, 1);
+	tegra_fc_cluster_req(cpu,
+			     FLOWCTRL_TURNOFF_CPURAIL << FLOWCTRL_ENABLE_EXT,
+			     1, &req);
 
-	val = FLOWCTRL_TURNOFF_CPURAIL << FLOWCTRL_ENABLE_EXT;
-	tegra_fc_prepare_suspend(cpu, val);
-
-	/* overwrite HALT register */
-	tegra_fc_halt_cpu(cpu, FLOWCTRL_WAITEVENT);
+	/* Only wait for the events, the interrupts must not wake the CPU */
+	req.halt = FLOWCTRL_WAITEVENT;
+	tegra_fc_pwrdn_apply(cpu, &req);
 }
 
 /*******************************************************************************
@@ -152,8 +172,12 @@ void tegra_fc_soc_powerdn(uint32_t mpidr)
  ******************************************************************************/
 void tegra_fc_cpu_on(int cpu)
 {
-	tegra_fc_cpu_csr(cpu, FLOWCTRL_CSR_ENABLE);
-	tegra_fc_halt_cpu(cpu, FLOWCTRL_WAITEVENT | FLOWCTRL_HALT_SCLK);
+	tegra_fc_pwrdn_req_t req = {
+		.halt = FLOWCTRL_WAITEVENT | FLOWCTRL_HALT_SCLK,
+		.csr = FLOWCTRL_CSR_ENABLE,
+	};
+
+	tegra_fc_pwrdn_apply(cpu, &req);
 }
 
 /*******************************************************************************
@@ -161,17 +185,16 @@ void tegra_fc_cpu_on(int cpu)
  ******************************************************************************/
 void tegra_fc_cpu_off(int cpu)
 {
-	uint32_t val;
+	tegra_fc_pwrdn_req_t req;
 
 	/*
 	 * Flow controller powers down the CPU during wfi. The CPU would be
 	 * powered on when it receives any interrupt.
 	 */
-	val = FLOWCTRL_CSR_INTR_FLAG | FLOWCTRL_CSR_EVENT_FLAG |
-		FLOWCTRL_CSR_ENABLE | (FLOWCTRL_WAIT_WFI_BITMAP << cpu);
-	tegra_fc_cpu_csr(cpu, val);
-	tegra_fc_halt_cpu(cpu, FLOWCTRL_WAITEVENT);
-	tegra_fc_cc4_ctrl(cpu, 0);
+	tegra_fc_suspend_req(cpu, 0, &req);
+	req.halt = FLOWCTRL_WAITEVENT;
+	req.cc4_cpus = 1U << cpu;
+	tegra_fc_pwrdn_apply(cpu, &req);
 }
 
 /*******************************************************************************
@@ -22,10 +22,23 @@
 #define TEGRA_GPU_RESET_REG_OFFSET	0x30
 #define  GPU_RESET_BIT			(1 << 0)
 
+/* Maximum number of MC_TXN_OVERRIDE registers programmed at boot */
+#define MC_TXN_OVERRIDE_MAX_REGS	64
+
 /* Video Memory base and size (live values) */
 static uint64_t video_mem_base;
 static uint64_t video_mem_size_mb;
 
+/*
+ * Final values of the MC_TXN_OVERRIDE registers programmed at boot, written
+ * back as they are on exit from System Suspend.
+ */
+static struct {
+	uint32_t offset;
+	uint32_t val;
+} mc_txn_overrides[MC_TXN_OVERRIDE_MAX_REGS];
+static uint32_t num_mc_txn_overrides;
+
 static void tegra_memctrl_reconfig_mss_clients(void)
 {
 #if ENABLE_ROC_FOR_ORDERING_CLIENT_REQUESTS
@@ -283,17 +296,36 @@ static void tegra_memctrl_reconfig_mss_clients(void)
 #endif
 }
 
+/*
+ * Set the CGID tag of a MC_TXN_OVERRIDE register and record its final value
+ */
+static void tegra_memctrl_set_txn_override(uint32_t offset, uint32_t cgid_tag)
+{
+	uint32_t val;
+
+	assert(num_mc_txn_overrides < MC_TXN_OVERRIDE_MAX_REGS);
+
+	val = tegra_mc_read_32(offset);
+	val = (val & ~MC_TXN_OVERRIDE_CGID_TAG_MASK) | cgid_tag;
+	tegra_mc_write_32(offset, val);
+
+	mc_txn_overrides[num_mc_txn_overrides].offset = offset;
+	mc_txn_overrides[num_mc_txn_overrides].val = val;
+	num_mc_txn_overrides++;
+}
+
 static void tegra_memctrl_set_overrides(void)
 {
 	tegra_mc_settings_t *plat_mc_settings = tegra_get_mc_settings();
 	const mc_txn_override_cfg_t *mc_txn_override_cfgs;
 	uint32_t num_txn_override_cfgs;
-	uint32_t i, val;
+	uint32_t i;
 
 	/* Get the settings from the platform */
 	assert(plat_mc_settings);
 	mc_txn_override_cfgs = plat_mc_settings->txn_override_cfg;
 	num_txn_override_cfgs = plat_mc_settings->num_txn_override_cfgs;
+	num_mc_txn_overrides = 0;
 
 	/*
 	 * Set the MC_TXN_OVERRIDE registers for write clients.
@@ -306,35 +338,40 @@ static void tegra_memctrl_set_overrides(void)
 		 * GPU and NVENC settings for Tegra186 simulation and
 		 * Silicon rev. A01
 		 */
-		val = tegra_mc_read_32(MC_TXN_OVERRIDE_CONFIG_GPUSWR);
-		val &= ~MC_TXN_OVERRIDE_CGID_TAG_MASK;
-		tegra_mc_write_32(MC_TXN_OVERRIDE_CONFIG_GPUSWR,
-			val | MC_TXN_OVERRIDE_CGID_TAG_ZERO);
-
-		val = tegra_mc_read_32(MC_TXN_OVERRIDE_CONFIG_GPUSWR2);
-		val &= ~MC_TXN_OVERRIDE_CGID_TAG_MASK;
-		tegra_mc_write_32(MC_TXN_OVERRIDE_CONFIG_GPUSWR2,
-			val | MC_TXN_OVERRIDE_CGID_TAG_ZERO);
-
-		val = tegra_mc_read_32(MC_TXN_OVERRIDE_CONFIG_NVENCSWR);
-		val &= ~MC_TXN_OVERRIDE_CGID_TAG_MASK;
-		tegra_mc_write_32(MC_TXN_OVERRIDE_CONFIG_NVENCSWR,
-			val | MC_TXN_OVERRIDE_CGID_TAG_CLIENT_AXI_ID);
+		tegra_memctrl_set_txn_override(MC_TXN_OVERRIDE_CONFIG_GPUSWR,
+			MC_TXN_OVERRIDE_CGID_TAG_ZERO);
+		tegra_memctrl_set_txn_override(MC_TXN_OVERRIDE_CONFIG_GPUSWR2,
+			MC_TXN_OVERRIDE_CGID_TAG_ZERO);
+		tegra_memctrl_set_txn_override(MC_TXN_OVERRIDE_CONFIG_NVENCSWR,
+			MC_TXN_OVERRIDE_CGID_TAG_CLIENT_AXI_ID);
 
 	} else {
 
 		/*
 		 * Settings for Tegra186 silicon rev. A02 and onwards.
 		 */
-		for (i = 0; i < num_txn_override_cfgs; i++) {
-			val = tegra_mc_read_32(mc_txn_override_cfgs[i].offset);
-			val &= ~MC_TXN_OVERRIDE_CGID_TAG_MASK;
-			tegra_mc_write_32(mc_txn_override_cfgs[i].offset,
-				val | mc_txn_override_cfgs[i].cgid_tag);
-		}
+		for (i = 0; i < num_txn_override_cfgs; i++)
+			tegra_memctrl_set_txn_override(
+				mc_txn_override_cfgs[i].offset,
+				mc_txn_override_cfgs[i].cgid_tag);
 	}
 }
 
+/*
+ * Write back the MC_TXN_OVERRIDE values recorded at boot. The registers hold
+ * the same values as at boot before they are set, as the Memory Controller
+ * is reset during System Suspend and then goes through the same MSS client
+ * reconfiguration.
+ */
+static void tegra_memctrl_restore_overrides(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < num_mc_txn_overrides; i++)
+		tegra_mc_write_32(mc_txn_overrides[i].offset,
+				  mc_txn_overrides[i].val);
+}
+
 /*
  * Init Memory controller during boot.
  */
@@ -416,7 +453,7 @@ void tegra_memctrl_restore_settings(void)
 	tegra_memctrl_reconfig_mss_clients();
 
 	/* Program overrides for MC transactions */
-	tegra_memctrl_set_overrides();
+	tegra_memctrl_restore_overrides();
 
 	/* video memory carveout region */
 	if (video_mem_base) {
@@ -600,14 +637,19 @@ static void tegra_clear_videomem(uintptr_t non_overlap_area_start,
 {
 	/*
 	 * Map the NS memory first, clean it and then unmap it.
+	 *
+	 * The mapping is normal non-cacheable memory, so that DC ZVA writes
+	 * whole blocks of zeroes straight to memory. This leaves no dirty
+	 * lines to clean to the point of coherency afterwards, and does not
+	 * evict the contents of the caches.
 	 */
 	mmap_add_dynamic_region(non_overlap_area_start, /* PA */
 				non_overlap_area_start, /* VA */
 				non_overlap_area_size, /* size */
-				MT_NS | MT_RW | MT_EXECUTE_NEVER); /* attrs */
+				MT_NON_CACHEABLE | MT_NS | MT_RW |
+				MT_EXECUTE_NEVER); /* attrs */
 
 	zero_normalmem((void *)non_overlap_area_start, non_overlap_area_size);
-	flush_dcache_range(non_overlap_area_start, non_overlap_area_size);
 
 	mmap_remove_dynamic_region(non_overlap_area_start,
 		non_overlap_area_size);
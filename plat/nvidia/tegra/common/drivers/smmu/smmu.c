@@ -96,7 +96,14 @@ void tegra_smmu_save_context(uint64_t smmu_ctx_addr)
 	if (num_entries != smmu_ctx_regs[0].val)
 		panic();
 
-	/* save SMMU register values */
+	/*
+	 * save SMMU register values
+	 *
+	 * The table is the per-SoC list of registers, and the boot firmware
+	 * on SC7 exit restores it one (register, value) pair at a time, so
+	 * its layout cannot change into blocks of registers. Each register is
+	 * read on its own as the SMMU only supports 32-bit accesses.
+	 */
 	for (i = 1; i < num_entries; i++)
 		smmu_ctx_regs[i].val = mmio_read_32(smmu_ctx_regs[i].reg);
 
@@ -17,6 +17,7 @@
 #include <errno.h>
 #include <memctrl.h>
 #include <mmio.h>
+#include <ns_range.h>
 #include <platform.h>
 #include <platform_def.h>
 #include <stddef.h>
@@ -343,6 +344,15 @@ void bl31_plat_arch_setup(void)
 	else
 		WARN("MMIO map not available\n");
 
+	/*
+	 * describe the NS DRAM and the TZDRAM aperture, which contains the
+	 * BL31 and BL32 images, to the index used to check the NS buffers
+	 */
+	ns_range_add(TEGRA_DRAM_BASE, TEGRA_DRAM_END - TEGRA_DRAM_BASE,
+		     NS_RANGE_NS);
+	ns_range_add(tegra_bl31_phys_base, TZDRAM_END - tegra_bl31_phys_base,
+		     NS_RANGE_SECURE);
+
 	/* set up translation tables */
 	init_xlat_tables();
 
@@ -368,10 +378,10 @@ int bl31_check_ns_address(uint64_t base, uint64_t size_in_bytes)
 	}
 
 	/*
-	 * TZDRAM aperture contains the BL31 and BL32 images, so we need
-	 * to check if the NS DRAM range overlaps the TZDRAM aperture.
+	 * Check if the NS DRAM range overlaps the TZDRAM aperture or another
+	 * secure carveout.
 	 */
-	if ((base < TZDRAM_END) && (end > tegra_bl31_phys_base)) {
+	if (!is_ns_range(base, size_in_bytes)) {
 		ERROR("NS address overlaps TZDRAM!\n");
 		return -ENOTSUP;
 	}
@@ -39,6 +39,24 @@
 #define FLOWCTRL_PG_CPU_NONCPU		0x1U
 #define FLOWCTRL_TURNOFF_CPURAIL	0x2U
 
+/* Mask of the CPUs of a cluster, in tegra_fc_pwrdn_req_t.cc4_cpus */
+#define FLOWCTRL_CLUSTER_CPUS		0xfU
+
+/* Flags of a power-down request */
+#define FLOWCTRL_REQ_L2_FLUSH		(1U << 0)	/* Write l2_flush */
+
+/*
+ * Flow controller programming of a CPU power state change, applied at once by
+ * tegra_fc_pwrdn_apply().
+ */
+typedef struct tegra_fc_pwrdn_req {
+	uint32_t halt;		/* HALT_CPU<n>_EVENTS of the CPU */
+	uint32_t csr;		/* CPU<n>_CSR of the CPU */
+	uint32_t cc4_cpus;	/* CPUs of the cluster whose CC4 is disabled */
+	uint32_t flags;
+	uint32_t l2_flush;	/* Value of L2_FLUSH_CONTROL, if flagged */
+} tegra_fc_pwrdn_req_t;
+
 static inline uint32_t tegra_fc_read_32(uint32_t off)
 {
 	return mmio_read_32(TEGRA_FLOWCTRL_BASE + off);
@@ -56,6 +74,7 @@ void tegra_fc_soc_powerdn(uint32_t midr);
 void tegra_fc_cpu_on(int cpu);
 void tegra_fc_cpu_off(int cpu);
 void tegra_fc_lock_active_cluster(void);
+void tegra_fc_pwrdn_apply(int cpu_id, const tegra_fc_pwrdn_req_t *req);
 void tegra_fc_reset_bpmp(void);
 
 #endif /* __FLOWCTRL_H__ */
@@ -71,6 +71,8 @@ int mce_update_gsc_tzdram(void);
 int mce_update_gsc_tzram(void);
 __dead2 void mce_enter_ccplex_state(uint32_t state_idx);
 void mce_update_cstate_info(mce_cstate_info_t *cstate);
+void mce_reset_cstate_info(void);
+int mce_read_cstate_stats(uint32_t first, uint32_t num, uint64_t *stats);
 void mce_verify_firmware_version(void);
 
 #endif /* __MCE_H__ */
@@ -283,6 +283,7 @@ int ari_enter_cstate(uint32_t ari_base, uint32_t state, uint32_t wake_time);
 int ari_update_cstate_info(uint32_t ari_base, uint32_t cluster, uint32_t ccplex,
 	uint32_t system, uint8_t sys_state_force, uint32_t wake_mask,
 	uint8_t update_wake_mask);
+void ari_reset_cstate_info(void);
 int ari_update_crossover_time(uint32_t ari_base, uint32_t type, uint32_t time);
 uint64_t ari_read_cstate_stats(uint32_t ari_base, uint32_t state);
 int ari_write_cstate_stats(uint32_t ari_base, uint32_t state, uint32_t stats);
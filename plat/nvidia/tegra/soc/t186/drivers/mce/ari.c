@@ -13,6 +13,7 @@
 #include <mmio.h>
 #include <mce_private.h>
 #include <platform.h>
+#include <platform_def.h>
 #include <sys/errno.h>
 #include <t18x_ari.h>
 
@@ -36,6 +37,22 @@
 /* default timeout (ms) to wait for ARI completion */
 #define ARI_MAX_RETRY_COUNT		2000
 
+/*******************************************************************************
+ * Per-CPU ARI state. 'posted_req' is the request submitted last without waiting
+ * for its completion, which the next request of the CPU waits for instead.
+ * 'cstate_info' and 'wake_mask' hold the values last programmed through
+ * UPDATE_CSTATE_INFO, so that the request is skipped when they don't change.
+ ******************************************************************************/
+typedef struct ari_cpu_state {
+	uint32_t posted_req;
+	uint32_t cstate_info;
+	uint32_t wake_mask;
+	uint8_t req_posted;
+	uint8_t cstate_info_valid;
+} __aligned(CACHE_WRITEBACK_GRANULE) ari_cpu_state_t;
+
+static ari_cpu_state_t ari_cpu_state[PLATFORM_CORE_COUNT];
+
 /*******************************************************************************
  * ARI helper functions
  ******************************************************************************/
@@ -69,23 +86,87 @@ static inline uint32_t ari_get_response_high(uint32_t ari_base)
 	return ari_read_32(ari_base, ARI_RESPONSE_DATA_HI);
 }
 
+static void ari_wait_completion(uint32_t ari_base, uint32_t req)
+{
+	uint32_t retries = ARI_MAX_RETRY_COUNT;
+	uint32_t status;
+
+	/*
+	 * Wait for the command response for not more than the timeout
+	 */
+	while (retries != 0U) {
+
+		/* read the command status */
+		status = ari_read_32(ari_base, ARI_STATUS);
+		if ((status & (ARI_REQ_ONGOING | ARI_REQ_PENDING)) == 0U)
+			break;
+
+		/* delay 1 ms */
+		mdelay(1);
+
+		/* decrement the retry count */
+		retries--;
+	}
+
+	/* assert if the command timed out */
+	if (retries == 0U) {
+		ERROR("ARI request timed out: req %d on CPU %d\n",
+			req, plat_my_core_pos());
+		assert(retries != 0U);
+	}
+}
+
+/* Wait for the completion of the request posted last by this CPU, if any */
+static void ari_wait_posted_request(uint32_t ari_base)
+{
+	ari_cpu_state_t *state = &ari_cpu_state[plat_my_core_pos()];
+
+	if (state->req_posted != 0U) {
+		state->req_posted = 0U;
+		ari_wait_completion(ari_base, state->posted_req);
+	}
+}
+
 static inline void ari_clobber_response(uint32_t ari_base)
 {
+	/* the MCE must be done with the previous request */
+	ari_wait_posted_request(ari_base);
+
 	ari_write_32(ari_base, 0, ARI_RESPONSE_DATA_LO);
 	ari_write_32(ari_base, 0, ARI_RESPONSE_DATA_HI);
 }
 
-static int ari_request_wait(uint32_t ari_base, uint32_t evt_mask, uint32_t req,
-		uint32_t lo, uint32_t hi)
+static void ari_request_submit(uint32_t ari_base, uint32_t evt_mask,
+		uint32_t req, uint32_t lo, uint32_t hi)
 {
-	uint32_t retries = ARI_MAX_RETRY_COUNT;
-	uint32_t status;
+	ari_wait_posted_request(ari_base);
 
 	/* program the request, event_mask, hi and lo registers */
 	ari_write_32(ari_base, lo, ARI_REQUEST_DATA_LO);
 	ari_write_32(ari_base, hi, ARI_REQUEST_DATA_HI);
 	ari_write_32(ari_base, evt_mask, ARI_REQUEST_EVENT_MASK);
 	ari_write_32(ari_base, req | ARI_REQUEST_VALID_BIT, ARI_REQUEST);
+}
+
+/*
+ * Submit a request that returns no response without waiting for it to
+ * complete. The next request of the CPU waits for its completion first.
+ */
+static void ari_request_post(uint32_t ari_base, uint32_t req, uint32_t lo,
+		uint32_t hi)
+{
+	ari_cpu_state_t *state = &ari_cpu_state[plat_my_core_pos()];
+
+	ari_request_submit(ari_base, 0, req, lo, hi);
+
+	state->posted_req = req;
+	state->req_posted = 1U;
+}
+
+static int ari_request_wait(uint32_t ari_base, uint32_t evt_mask, uint32_t req,
+		uint32_t lo, uint32_t hi)
+{
+	ari_request_submit(ari_base, evt_mask, req, lo, hi);
 
 	/*
 	 * For commands that have an event trigger, we should bypass
@@ -102,29 +183,7 @@ static int ari_request_wait(uint32_t ari_base, uint32_t evt_mask, uint32_t req,
 			return 0;
 	}
 
-	/*
-	 * Wait for the command response for not more than the timeout
-	 */
-	while (retries != 0U) {
-
-		/* read the command status */
-		status = ari_read_32(ari_base, ARI_STATUS);
-		if ((status & (ARI_REQ_ONGOING | ARI_REQ_PENDING)) == 0U)
-			break;
-
-		/* delay 1 ms */
-		mdelay(1);
-
-		/* decrement the retry count */
-		retries--;
-	}
-
-	/* assert if the command timed out */
-	if (retries == 0U) {
-		ERROR("ARI request timed out: req %d on CPU %d\n",
-			req, plat_my_core_pos());
-		assert(retries != 0U);
-	}
+	ari_wait_completion(ari_base, req);
 
 	return 0;
 }
@@ -150,11 +209,9 @@ int ari_update_cstate_info(uint32_t ari_base, uint32_t cluster, uint32_t ccplex,
 	uint32_t system, uint8_t sys_state_force, uint32_t wake_mask,
 	uint8_t update_wake_mask)
 {
+	ari_cpu_state_t *state = &ari_cpu_state[plat_my_core_pos()];
 	uint32_t val = 0;
 
-	/* clean the previous response state */
-	ari_clobber_response(ari_base);
-
 	/* update CLUSTER_CSTATE? */
 	if (cluster)
 		val |= (cluster & CLUSTER_CSTATE_MASK) |
@@ -175,9 +232,34 @@ int ari_update_cstate_info(uint32_t ari_base, uint32_t cluster, uint32_t ccplex,
 	if (update_wake_mask)
 		val |= CSTATE_WAKE_MASK_UPDATE_BIT;
 
-	/* set the updated cstate info */
-	return ari_request_wait(ari_base, 0, TEGRA_ARI_UPDATE_CSTATE_INFO, val,
+	/* skip the request if the MCE already has this cstate info */
+	if ((state->cstate_info_valid != 0U) && (state->cstate_info == val) &&
+	    (state->wake_mask == wake_mask))
+		return 0;
+
+	/* clean the previous response state */
+	ari_clobber_response(ari_base);
+
+	state->cstate_info = val;
+	state->wake_mask = wake_mask;
+	state->cstate_info_valid = 1U;
+
+	/*
+	 * set the updated cstate info, the request has no response, so the
+	 * next request waits for its completion rather than this one
+	 */
+	ari_request_post(ari_base, TEGRA_ARI_UPDATE_CSTATE_INFO, val,
 			wake_mask);
+
+	return 0;
+}
+
+void ari_reset_cstate_info(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+		ari_cpu_state[i].cstate_info_valid = 0U;
 }
 
 int ari_update_crossover_time(uint32_t ari_base, uint32_t type, uint32_t time)
@@ -392,6 +474,9 @@ uint64_t ari_read_write_mca(uint32_t ari_base, mca_cmd_t cmd, uint64_t *data)
 	/* Set data (write) */
 	mca_arg.data = data ? *data : 0ull;
 
+	/* the MCE must be done with the previous request */
+	ari_wait_posted_request(ari_base);
+
 	/* Set command */
 	ari_write_32(ari_base, cmd.input.low, ARI_RESPONSE_DATA_LO);
 	ari_write_32(ari_base, cmd.input.high, ARI_RESPONSE_DATA_HI);
@@ -456,6 +456,39 @@ void mce_update_cstate_info(mce_cstate_info_t *cstate)
 		cstate->wake_mask, cstate->update_wake_mask);
 }
 
+/*******************************************************************************
+ * Handler to forget the cstate info last programmed by the CPUs, so that the
+ * next UPDATE_CSTATE_INFO request of each CPU is issued to the MCE
+ ******************************************************************************/
+void mce_reset_cstate_info(void)
+{
+	ari_reset_cstate_info();
+}
+
+/*******************************************************************************
+ * Handler to read 'num' consecutive cstate stats counters of the MCE, starting
+ * from the 'first' TEGRA_ARI_CSTATE_STATS_* type
+ ******************************************************************************/
+int mce_read_cstate_stats(uint32_t first, uint32_t num, uint64_t *stats)
+{
+	arch_mce_ops_t *ops = mce_get_curr_cpu_ops();
+	uint32_t cpu_ari_base = mce_get_curr_cpu_ari_base();
+	uint32_t last = TEGRA_ARI_CSTATE_STATS_LAST_CSTATE_ENTRY_A57_3;
+	uint32_t i;
+
+	assert(stats);
+
+	/* sanity check the range of counters */
+	if ((first == TEGRA_ARI_CSTATE_STATS_CLEAR) || (num == 0U) ||
+	    (first > last) || (num > (last - first + 1U)))
+		return -EINVAL;
+
+	for (i = 0; i < num; i++)
+		stats[i] = ops->read_cstate_stats(cpu_ari_base, first + i);
+
+	return 0;
+}
+
 /*******************************************************************************
  * Handler to read the MCE firmware version and check if it is compatible
  * with interface header the BL3-1 was compiled against
@@ -90,7 +90,7 @@ int tegra_soc_pwr_domain_suspend(const psci_power_state_t *target_state)
 	plat_params_from_bl2_t *params_from_bl2 = bl31_get_plat_params();
 	mce_cstate_info_t cstate_info = { 0 };
 	uint64_t smmu_ctx_base;
-	uint32_t val;
+	uint32_t val, wake_time;
 
 	/* get the state ID */
 	pwr_domain_state = target_state->pwr_domain_state;
@@ -105,8 +105,18 @@ int tegra_soc_pwr_domain_suspend(const psci_power_state_t *target_state)
 		/* Enter CPU idle/powerdown */
 		val = (stateid_afflvl0 == PSTATE_ID_CORE_IDLE) ?
 			TEGRA_ARI_CORE_C6 : TEGRA_ARI_CORE_C7;
+
+		/*
+		 * Wake up by the time requested by the OS or by the next timer
+		 * of the CPU, whichever comes first. The TSC ticks at the rate
+		 * of the system counter.
+		 */
+		wake_time = percpu_data[cpu].wake_time;
+		if (target_state->wake_time < wake_time)
+			wake_time = target_state->wake_time;
+
 		(void)mce_command_handler(MCE_CMD_ENTER_CSTATE, val,
-				percpu_data[cpu].wake_time, 0);
+				wake_time, 0);
 
 	} else if (stateid_afflvl2 == PSTATE_ID_SOC_POWERDN) {
 
@@ -279,6 +289,13 @@ int tegra_soc_pwr_domain_on_finish(const psci_power_state_t *target_state)
 	int stateid_afflvl0 = target_state->pwr_domain_state[MPIDR_AFFLVL0];
 	mce_cstate_info_t cstate_info = { 0 };
 
+	/*
+	 * The cstate info cached for the CPUs may not match the state of
+	 * the MCE after system suspend.
+	 */
+	if (stateid_afflvl2 == PSTATE_ID_SOC_POWERDN)
+		mce_reset_cstate_info();
+
 	/*
 	 * Reset power state info for CPUs when onlining, we set
 	 * deepest power when offlining a core but that may not be
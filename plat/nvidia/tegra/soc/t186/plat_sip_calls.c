@@ -30,6 +30,12 @@ extern uint32_t tegra186_system_powerdn_state;
  ******************************************************************************/
 #define TEGRA_SIP_SYSTEM_SHUTDOWN_STATE			0xC2FFFE01
 #define TEGRA_SIP_GET_ACTMON_CLK_COUNTERS		0xC2FFFE02
+#define TEGRA_SIP_READ_CSTATE_STATS			0xC2FFFE03
+
+/*******************************************************************************
+ * Maximum number of cstate stats counters returned by a single SiP call
+ ******************************************************************************/
+#define MAX_CSTATE_STATS_PER_CALL	7
 #define TEGRA_SIP_MCE_CMD_ENTER_CSTATE			0xC2FFFF00
 #define TEGRA_SIP_MCE_CMD_UPDATE_CSTATE_INFO		0xC2FFFF01
 #define TEGRA_SIP_MCE_CMD_UPDATE_CROSSOVER_TIME		0xC2FFFF02
@@ -63,8 +69,9 @@ int plat_sip_handler(uint32_t smc_fid,
 		     uint64_t flags)
 {
 	int mce_ret;
-	int impl, cpu;
+	int impl, cpu, i;
 	uint32_t base, core_clk_ctr, ref_clk_ctr;
+	uint64_t stats[MAX_CSTATE_STATS_PER_CALL];
 
 	if (((smc_fid >> FUNCID_CC_SHIFT) & FUNCID_CC_MASK) == SMC_32) {
 		/* 32-bit function, clear top parameter bits */
@@ -172,6 +179,30 @@ int plat_sip_handler(uint32_t smc_fid,
 
 		return 0;
 
+	/*
+	 * This function ID reads several cstate stats counters of the MCE
+	 * at once, rather than one per MCE_CMD_READ_CSTATE_STATS call.
+	 *
+	 * x1 = first TEGRA_ARI_CSTATE_STATS_* counter
+	 * x2 = number of consecutive counters, up to 7
+	 */
+	case TEGRA_SIP_READ_CSTATE_STATS:
+
+		if (x2 > MAX_CSTATE_STATS_PER_CALL)
+			return -EINVAL;
+
+		mce_ret = mce_read_cstate_stats((uint32_t)x1, (uint32_t)x2,
+						stats);
+		if (mce_ret != 0)
+			return mce_ret;
+
+		/* return the counter values in x1 - x7 */
+		for (i = 0; i < (int)x2; i++)
+			write_ctx_reg(get_gpregs_ctx(handle),
+				      (CTX_GPREG_X1 + (i * 8)), stats[i]);
+
+		return 0;
+
 	default:
 		break;
 	}
@@ -3,13 +3,39 @@
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
+#include <arch.h>
+#include <assert.h>
+#include <cassert.h>
 #include <console.h>
 #include <debug.h>
+#include <fdt_index.h>
 #include <libfdt.h>
+#include <platform_def.h>
 #include <psci.h>
 #include "qemu_private.h"
 #include <string.h>
 
+/* The QEMU DTs have a node per virtio-mmio transport and a few devices */
+#define DT_INDEX_MAX_NODES	256
+
+/* Index of the nodes of the DT, used for the lookups until it is modified */
+static fdt_index_node_t dt_index_nodes[DT_INDEX_MAX_NODES];
+static fdt_index_t dt_index;
+
+/*
+ * Index the nodes of the DT. The lookups fall back to scanning the DT if this
+ * fails, so the error is only reported.
+ */
+void dt_build_index(void *fdt)
+{
+	int ret;
+
+	ret = fdt_index_init(&dt_index, fdt, dt_index_nodes,
+			     DT_INDEX_MAX_NODES);
+	if (ret < 0)
+		WARN("Cannot index the Device Tree: error %d\n", ret);
+}
+
 static int append_psci_compatible(void *fdt, int offs, const char *str)
 {
 	return fdt_appendprop(fdt, offs, "compatible", str, strlen(str) + 1);
@@ -19,14 +45,18 @@ int dt_add_psci_node(void *fdt)
 {
 	int offs;
 
-	if (fdt_path_offset(fdt, "/psci") >= 0) {
+	assert(dt_index.fdt == fdt);
+
+	if (fdt_index_path_offset(&dt_index, "/psci") >= 0) {
 		WARN("PSCI Device Tree node already exists!\n");
 		return 0;
 	}
 
-	offs = fdt_path_offset(fdt, "/");
+	offs = fdt_index_path_offset(&dt_index, "/");
 	if (offs < 0)
 		return -1;
+	/* The offsets of all the nodes but the root change from here */
+	fdt_index_invalidate(&dt_index);
 	offs = fdt_add_subnode(fdt, offs, "psci");
 	if (offs < 0)
 		return -1;
@@ -86,10 +116,69 @@ int dt_add_psci_cpu_enable_methods(void *fdt)
 			continue; /* already set */
 		if (check_node_compat_prefix(fdt, offs, "arm,cortex-a"))
 			continue; /* no compatible */
+		/*
+		 * This only moves the nodes after this one, so the scan can
+		 * go on from 'offs' rather than restarting from the root.
+		 */
 		if (fdt_setprop_string(fdt, offs, "enable-method", "psci"))
 			return -1;
-		/* Need to restart scanning as offsets may have changed */
-		offs = 0;
 	}
 	return 0;
 }
+
+CASSERT(PLATFORM_CORE_COUNT <= 32, assert_qemu_cpu_present_fits_in_32_bits);
+
+/*
+ * Fill in the platform configuration passed to BL31 from the CPU nodes of the
+ * DT. The configuration is left invalid if no usable CPU node is found.
+ */
+int dt_get_plat_config(void *fdt, qemu_plat_config_t *config)
+{
+	const fdt32_t *reg;
+	unsigned int cluster_id, cpu_id;
+	uint64_t mpidr;
+	int cpus, offs, cells, len;
+	const char *type;
+
+	assert(dt_index.fdt == fdt);
+
+	config->version = 0;
+	config->cpu_present = 0;
+
+	cpus = fdt_index_path_offset(&dt_index, "/cpus");
+	if (cpus < 0)
+		return -1;
+	cells = fdt_address_cells(fdt, cpus);
+	if ((cells != 1) && (cells != 2))
+		return -1;
+
+	fdt_index_for_each_subnode(offs, &dt_index, cpus) {
+		type = fdt_getprop(fdt, offs, "device_type", NULL);
+		if ((type == NULL) || (strcmp(type, "cpu") != 0))
+			continue;
+		reg = fdt_getprop(fdt, offs, "reg", &len);
+		if ((reg == NULL) || (len != cells * (int)sizeof(*reg)))
+			continue;
+
+		mpidr = fdt32_to_cpu(reg[0]);
+		if (cells == 2)
+			mpidr = (mpidr << 32) | fdt32_to_cpu(reg[1]);
+
+		/* Skip the CPUs that BL31 cannot manage */
+		cluster_id = (mpidr >> MPIDR_AFF1_SHIFT) & MPIDR_AFFLVL_MASK;
+		cpu_id = (mpidr >> MPIDR_AFF0_SHIFT) & MPIDR_AFFLVL_MASK;
+		if ((mpidr & ~(MPIDR_CLUSTER_MASK | MPIDR_CPU_MASK)) ||
+		    (cluster_id >= PLATFORM_CLUSTER_COUNT) ||
+		    (cpu_id >= PLATFORM_MAX_CPUS_PER_CLUSTER)) {
+			WARN("Ignoring CPU 0x%llx of the Device Tree\n",
+			     (unsigned long long)mpidr);
+			continue;
+		}
+		config->cpu_present |= 1U << plat_qemu_calc_core_pos(mpidr);
+	}
+
+	if (config->cpu_present == 0)
+		return -1;
+	config->version = QEMU_PLAT_CONFIG_VERSION;
+	return 0;
+}
@@ -11,9 +11,6 @@
 #include <common_def.h>
 #include <tbbr_img_def.h>
 
-/* Special value used to verify platform parameters from BL2 to BL3-1 */
-#define QEMU_BL31_PLAT_PARAM_VAL	0x0f1e2d3c4b5a6978ULL
-
 #define PLATFORM_STACK_SIZE 0x1000
 
 #define PLATFORM_MAX_CPUS_PER_CLUSTER	4
@@ -40,6 +40,7 @@ BL2_SOURCES		+=	drivers/io/io_semihosting.c		\
 				plat/qemu/aarch64/plat_helpers.S	\
 				plat/qemu/qemu_bl2_setup.c		\
 				plat/qemu/dt.c				\
+				common/fdt_index.c			\
 				$(LIBFDT_SRCS)
 
 BL31_SOURCES		+=	lib/cpus/aarch64/aem_generic.S		\
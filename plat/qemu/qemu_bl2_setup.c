@@ -40,6 +40,8 @@ typedef struct bl2_to_bl31_params_mem {
 
 static bl2_to_bl31_params_mem_t bl31_params_mem;
 
+/* Platform configuration passed to BL31, built once from the DT */
+static qemu_plat_config_t plat_config;
 
 
 /* Data structure which holds the extents of the trusted SRAM for BL2 */
@@ -106,6 +108,8 @@ void bl2_plat_flush_bl31_params(void)
 {
 	flush_dcache_range((unsigned long)&bl31_params_mem,
 			sizeof(bl2_to_bl31_params_mem_t));
+	flush_dcache_range((unsigned long)&plat_config,
+			sizeof(plat_config));
 }
 
 /*******************************************************************************
@@ -114,9 +118,7 @@ void bl2_plat_flush_bl31_params(void)
  ******************************************************************************/
 struct entry_point_info *bl2_plat_get_bl31_ep_info(void)
 {
-#if DEBUG
-	bl31_params_mem.bl31_ep_info.args.arg1 = QEMU_BL31_PLAT_PARAM_VAL;
-#endif
+	bl31_params_mem.bl31_ep_info.args.arg1 = (uintptr_t)&plat_config;
 
 	return &bl31_params_mem.bl31_ep_info;
 }
@@ -154,6 +156,11 @@ static void update_dt(void)
 		return;
 	}
 
+	dt_build_index(fdt);
+
+	if (dt_get_plat_config(fdt, &plat_config))
+		WARN("No usable CPU node in the Device Tree\n");
+
 	if (dt_add_psci_node(fdt)) {
 		ERROR("Failed to add PSCI Device Tree node\n");
 		return;
@@ -7,6 +7,7 @@
 #include <assert.h>
 #include <bl_common.h>
 #include <console.h>
+#include <debug.h>
 #include <gicv2.h>
 #include <platform_def.h>
 #include "qemu_private.h"
@@ -40,6 +41,8 @@ static entry_point_info_t bl33_image_ep_info;
 void bl31_early_platform_setup(bl31_params_t *from_bl2,
 				void *plat_params_from_bl2)
 {
+	const qemu_plat_config_t *config = plat_params_from_bl2;
+
 	/* Initialize the console to provide early debug support */
 	console_init(PLAT_QEMU_BOOT_UART_BASE, PLAT_QEMU_BOOT_UART_CLK_IN_HZ,
 			PLAT_QEMU_CONSOLE_BAUDRATE);
@@ -50,13 +53,16 @@ void bl31_early_platform_setup(bl31_params_t *from_bl2,
 	assert(from_bl2 != NULL);
 	assert(from_bl2->h.type == PARAM_BL31);
 	assert(from_bl2->h.version >= VERSION_1);
+
 	/*
-	 * In debug builds, we pass a special value in 'plat_params_from_bl2'
-	 * to verify platform parameters from BL2 to BL3-1.
-	 * In release builds, it's not used.
+	 * 'plat_params_from_bl2' points to the platform configuration that BL2
+	 * built from the DT, in Secure RAM. Without a valid one, the topology
+	 * compiled in is used as it is.
 	 */
-	assert(((unsigned long long)plat_params_from_bl2) ==
-		QEMU_BL31_PLAT_PARAM_VAL);
+	if ((config != NULL) && (config->version == QEMU_PLAT_CONFIG_VERSION))
+		plat_qemu_topology_setup(config->cpu_present);
+	else
+		WARN("No platform configuration from BL2\n");
 
 	/*
 	 * Copy BL3-2 (if populated by BL2) and BL3-3 entry point information.
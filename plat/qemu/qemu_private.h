@@ -7,8 +7,21 @@
 #ifndef __QEMU_PRIVATE_H
 #define __QEMU_PRIVATE_H
 
+#include <stdint.h>
 #include <sys/types.h>
 
+/*
+ * Platform configuration built by BL2 from the Device Tree and passed to BL31,
+ * which only uses it if 'version' is QEMU_PLAT_CONFIG_VERSION.
+ */
+#define QEMU_PLAT_CONFIG_VERSION	1
+
+typedef struct qemu_plat_config {
+	uint32_t version;
+	/* Bit N is set if the CPU with core position N is in the DT */
+	uint32_t cpu_present;
+} qemu_plat_config_t;
+
 void qemu_configure_mmu_el1(unsigned long total_base, unsigned long total_size,
 			unsigned long ro_start, unsigned long ro_limit,
 			unsigned long coh_start, unsigned long coh_limit);
@@ -19,8 +32,11 @@ void qemu_configure_mmu_el3(unsigned long total_base, unsigned long total_size,
 
 void plat_qemu_io_setup(void);
 unsigned int plat_qemu_calc_core_pos(u_register_t mpidr);
+void plat_qemu_topology_setup(uint32_t cpu_present);
 
+void dt_build_index(void *fdt);
 int dt_add_psci_node(void *fdt);
 int dt_add_psci_cpu_enable_methods(void *fdt);
+int dt_get_plat_config(void *fdt, qemu_plat_config_t *config);
 
 #endif /*__QEMU_PRIVATE_H*/
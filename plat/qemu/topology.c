@@ -9,6 +9,9 @@
 #include "qemu_private.h"
 #include <sys/types.h>
 
+/* CPUs described in the DT, by core position. All of them by default. */
+static uint32_t qemu_cpu_present = (1U << PLATFORM_CORE_COUNT) - 1;
+
 /* The power domain tree descriptor */
 static unsigned char power_domain_tree_desc[] = {
 	/* Number of root nodes */
@@ -27,6 +30,15 @@ const unsigned char *plat_get_power_domain_tree_desc(void)
 	return power_domain_tree_desc;
 }
 
+/*******************************************************************************
+ * Record the CPUs found in the DT by BL2, so that PSCI requests targeting other
+ * CPUs are rejected. This must be called before PSCI is initialised.
+ ******************************************************************************/
+void plat_qemu_topology_setup(uint32_t cpu_present)
+{
+	qemu_cpu_present = cpu_present;
+}
+
 /*******************************************************************************
  * This function implements a part of the critical interface between the psci
  * generic layer and the platform that allows the former to query the platform
@@ -50,5 +62,8 @@ int plat_core_pos_by_mpidr(u_register_t mpidr)
 	if (cpu_id >= PLATFORM_MAX_CPUS_PER_CLUSTER)
 		return -1;
 
+	if ((qemu_cpu_present & (1U << plat_qemu_calc_core_pos(mpidr))) == 0)
+		return -1;
+
 	return plat_qemu_calc_core_pos(mpidr);
 }
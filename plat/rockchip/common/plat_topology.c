@@ -17,6 +17,12 @@ const unsigned char *plat_get_power_domain_tree_desc(void)
 	return rockchip_power_domain_tree_desc;
 }
 
+/*
+ * Default conversion of the MPIDRs of the Rockchip SoCs, which may be replaced
+ * by the generic one of plat/common/plat_core_pos.c.
+ */
+#pragma weak plat_core_pos_by_mpidr
+
 int plat_core_pos_by_mpidr(u_register_t mpidr)
 {
 	unsigned int cluster_id, cpu_id;
@@ -51,8 +51,34 @@ struct rk3399_saved_status {
 	uint32_t odt;
 };
 
+/*
+ * Spec timings of a rate of dpll_rates_table, as computed by
+ * dram_get_parameter(). They also depend on the ODT setting they were computed
+ * with, which only changes through dram_set_odt_pd() and system suspend.
+ */
+struct rk3399_dram_timing_cache {
+	uint32_t valid;
+	uint32_t odt;
+	struct dram_timing_t timing;
+};
+
 static struct rk3399_dram_status rk3399_dram_status;
+static struct rk3399_dram_timing_cache
+	rk3399_dram_timings[ARRAY_SIZE(dpll_rates_table)];
 static struct rk3399_saved_status rk3399_suspend_status;
+
+/*
+ * Frequency switch performed by the M0. The SiP call that starts it with
+ * DRAM_SET_RATE_ASYNC can return before the M0 is done, in which case the
+ * switch is completed by a later call.
+ */
+struct rk3399_dfs_job {
+	uint32_t pending;
+	uint32_t ddr_index;
+	uint32_t mhz;
+};
+
+static struct rk3399_dfs_job rk3399_dfs_job;
 static uint32_t wrdqs_delay_val[2][2][4];
 
 static struct rk3399_sdram_default_config ddr3_default_config = {
@@ -1827,9 +1853,40 @@ static void dram_low_power_config(void)
 	mmio_write_32(CIC_BASE + CIC_CTRL1, 0x00150014);
 }
 
+static void dram_set_timing_freq(uint32_t mhz)
+{
+	rk3399_dram_status.timing_config.freq = mhz;
+
+	if (mhz < 300)
+		rk3399_dram_status.timing_config.dllbp = 1;
+	else
+		rk3399_dram_status.timing_config.dllbp = 0;
+}
+
+/*
+ * Return the spec timings of the rate 'index' of dpll_rates_table, which must
+ * be the frequency of the timing configuration. They are only computed when
+ * they are not cached yet for the current ODT setting.
+ */
+static struct dram_timing_t *get_dram_timing(uint32_t index)
+{
+	struct rk3399_dram_timing_cache *cache = &rk3399_dram_timings[index];
+	uint32_t odt = rk3399_dram_status.timing_config.odt;
+
+	if (!cache->valid || (cache->odt != odt)) {
+		dram_get_parameter(&rk3399_dram_status.timing_config,
+				   &cache->timing);
+		cache->odt = odt;
+		cache->valid = 1;
+	}
+
+	return &cache->timing;
+}
+
 void dram_dfs_init(void)
 {
 	uint32_t trefi0, trefi1, boot_freq;
+	uint32_t i;
 
 	/* get sdram config for os reg */
 	get_dram_drv_odt_val(sdram_config.dramtype,
@@ -1858,6 +1915,14 @@ void dram_dfs_init(void)
 	rk3399_dram_status.index_freq[(rk3399_dram_status.current_index + 1) &
 				      0x1] = 0;
 	rk3399_dram_status.low_power_stat = 0;
+
+	/* Compute the timings of all the rates before the first DFS request */
+	for (i = 0; i < ARRAY_SIZE(dpll_rates_table); i++) {
+		dram_set_timing_freq(dpll_rates_table[i].mhz);
+		(void)get_dram_timing(i);
+	}
+	dram_set_timing_freq(boot_freq);
+
 	/*
 	 * following register decide if NOC stall the access request
 	 * or return error when NOC being idled. when doing ddr frequency
@@ -1890,6 +1955,8 @@ uint32_t dram_set_odt_pd(uint32_t arg0, uint32_t arg1, uint32_t arg2)
 	uint32_t *low_power = &rk3399_dram_status.low_power_stat;
 	uint32_t dram_type, ch_count, pd_tmp, sr_tmp, i;
 
+	ddr_wait_rate();
+
 	dram_type = rk3399_dram_status.timing_config.dram_type;
 	ch_count = rk3399_dram_status.timing_config.ch_cnt;
 
@@ -1954,14 +2021,9 @@ static void m0_configure_ddr(struct pll_div pll_div, uint32_t ddr_index)
 static uint32_t prepare_ddr_timing(uint32_t mhz)
 {
 	uint32_t index;
-	struct dram_timing_t dram_timing;
+	struct dram_timing_t *dram_timing;
 
-	rk3399_dram_status.timing_config.freq = mhz;
-
-	if (mhz < 300)
-		rk3399_dram_status.timing_config.dllbp = 1;
-	else
-		rk3399_dram_status.timing_config.dllbp = 0;
+	dram_set_timing_freq(mhz);
 
 	if (rk3399_dram_status.timing_config.odt == 1)
 		gen_rk3399_set_odt(1);
@@ -1972,22 +2034,27 @@ static uint32_t prepare_ddr_timing(uint32_t mhz)
 	 * checking if having available gate traiing timing for
 	 * target freq.
 	 */
-	dram_get_parameter(&rk3399_dram_status.timing_config, &dram_timing);
+	dram_timing = get_dram_timing(to_get_clk_index(mhz));
 	gen_rk3399_ctl_params(&rk3399_dram_status.timing_config,
-			      &dram_timing, index);
+			      dram_timing, index);
 	gen_rk3399_pi_params(&rk3399_dram_status.timing_config,
-			     &dram_timing, index);
+			     dram_timing, index);
 	gen_rk3399_phy_params(&rk3399_dram_status.timing_config,
 			      &rk3399_dram_status.drv_odt_lp_cfg,
-			      &dram_timing, index);
+			      dram_timing, index);
 	rk3399_dram_status.index_freq[index] = mhz;
 
 	return index;
 }
 
-uint32_t ddr_set_rate(uint32_t hz)
+/*
+ * Start switching the DRAM to the rate closest to 'hz'. Return the rate in MHz
+ * the DRAM is switched to. If the M0 was started, the switch is pending until
+ * ddr_finish_rate() is called.
+ */
+static uint32_t ddr_start_rate(uint32_t hz)
 {
-	uint32_t low_power, index, ddr_index;
+	uint32_t index, ddr_index;
 	uint32_t mhz = hz / (1000 * 1000);
 
 	if (mhz ==
@@ -2000,8 +2067,11 @@ uint32_t ddr_set_rate(uint32_t hz)
 	ddr_index = prepare_ddr_timing(mhz);
 	gen_rk3399_enable_training(rk3399_dram_status.timing_config.ch_cnt,
 				   mhz);
-	if (ddr_index > 1)
-		goto out;
+	if (ddr_index > 1) {
+		gen_rk3399_disable_training(
+			rk3399_dram_status.timing_config.ch_cnt);
+		return mhz;
+	}
 
 	/*
 	 * Make sure the clock is enabled. The M0 clocks should be on all of the
@@ -2009,20 +2079,75 @@ uint32_t ddr_set_rate(uint32_t hz)
 	 */
 	m0_configure_ddr(dpll_rates_table[index], ddr_index);
 	m0_start();
+
+	rk3399_dfs_job.ddr_index = ddr_index;
+	rk3399_dfs_job.mhz = mhz;
+	rk3399_dfs_job.pending = 1;
+
+	return mhz;
+}
+
+/* Wait for the M0 to complete the pending switch and finish it */
+static void ddr_finish_rate(void)
+{
 	m0_wait_done();
 	m0_stop();
 
 	if (rk3399_dram_status.timing_config.odt == 0)
 		gen_rk3399_set_odt(0);
 
-	rk3399_dram_status.current_index = ddr_index;
-	low_power = rk3399_dram_status.low_power_stat;
-	resume_low_power(low_power);
-out:
+	rk3399_dram_status.current_index = rk3399_dfs_job.ddr_index;
+	resume_low_power(rk3399_dram_status.low_power_stat);
 	gen_rk3399_disable_training(rk3399_dram_status.timing_config.ch_cnt);
+
+	rk3399_dfs_job.pending = 0;
+}
+
+/* Complete the switch started by ddr_set_rate_async(), if any */
+void ddr_wait_rate(void)
+{
+	if (rk3399_dfs_job.pending)
+		ddr_finish_rate();
+}
+
+uint32_t ddr_set_rate(uint32_t hz)
+{
+	uint32_t mhz;
+
+	ddr_wait_rate();
+
+	mhz = ddr_start_rate(hz);
+	ddr_wait_rate();
+
 	return mhz;
 }
 
+/*
+ * Start switching the DRAM to the rate closest to 'hz' without waiting for the
+ * M0. The caller polls ddr_poll_rate() to complete the switch.
+ */
+uint32_t ddr_set_rate_async(uint32_t hz)
+{
+	ddr_wait_rate();
+
+	return ddr_start_rate(hz);
+}
+
+/*
+ * Return 0 while the M0 is switching the DRAM rate, otherwise complete the
+ * switch if needed and return the current rate in MHz.
+ */
+uint32_t ddr_poll_rate(void)
+{
+	if (rk3399_dfs_job.pending) {
+		if (!m0_is_done())
+			return 0;
+		ddr_finish_rate();
+	}
+
+	return rk3399_dram_status.index_freq[rk3399_dram_status.current_index];
+}
+
 uint32_t ddr_round_rate(uint32_t hz)
 {
 	int index;
@@ -2035,8 +2160,10 @@ uint32_t ddr_round_rate(uint32_t hz)
 
 void ddr_prepare_for_sys_suspend(void)
 {
-	uint32_t mhz =
-		rk3399_dram_status.index_freq[rk3399_dram_status.current_index];
+	uint32_t mhz;
+
+	ddr_wait_rate();
+	mhz = rk3399_dram_status.index_freq[rk3399_dram_status.current_index];
 
 	/*
 	 * If we're not currently at the boot (assumed highest) frequency, we
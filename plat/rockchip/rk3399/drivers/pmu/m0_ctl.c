@@ -95,3 +95,10 @@ void m0_wait_done(void)
 	udelay(10);
 	dsb();
 }
+
+/* Return 1 if the M0 has completed its job, without waiting for it */
+int m0_is_done(void)
+{
+	dsb();
+	return mmio_read_32(M0_PARAM_ADDR + PARAM_M0_DONE) == M0_DONE_FLAG;
+}
@@ -84,135 +84,79 @@ static void pmu_bus_idle_req(uint32_t bus, uint32_t state)
 
 struct pmu_slpdata_s pmu_slpdata;
 
+/*
+ * The QoS registers of the NIUs in the power domains that are powered off
+ * during system suspend. Each block of CPU_AXI_QOS_NUM_REGS registers is only
+ * accessible when its power domain is on.
+ */
+#define QOS_DESC(_pd, _name, _regs)	\
+	{ (_pd), CPU_AXI_##_name##_QOS_BASE, pmu_slpdata._regs }
+
+static const struct rk3399_qos_desc {
+	uint32_t pd;
+	uintptr_t base;
+	uint32_t *regs;
+} rk3399_qos_descs[] = {
+	QOS_DESC(PD_GPU, GPU, gpu_qos),
+	QOS_DESC(PD_ISP0, ISP0_M0, isp0_m0_qos),
+	QOS_DESC(PD_ISP0, ISP0_M1, isp0_m1_qos),
+	QOS_DESC(PD_ISP1, ISP1_M0, isp1_m0_qos),
+	QOS_DESC(PD_ISP1, ISP1_M1, isp1_m1_qos),
+	QOS_DESC(PD_VO, VOP_BIG_R, vop_big_r),
+	QOS_DESC(PD_VO, VOP_BIG_W, vop_big_w),
+	QOS_DESC(PD_VO, VOP_LITTLE, vop_little),
+	QOS_DESC(PD_HDCP, HDCP, hdcp_qos),
+	QOS_DESC(PD_GMAC, GMAC, gmac_qos),
+	QOS_DESC(PD_CCI, CCI_M0, cci_m0_qos),
+	QOS_DESC(PD_CCI, CCI_M1, cci_m1_qos),
+	QOS_DESC(PD_SD, SDMMC, sdmmc_qos),
+	QOS_DESC(PD_EMMC, EMMC, emmc_qos),
+	QOS_DESC(PD_SDIOAUDIO, SDIO, sdio_qos),
+	QOS_DESC(PD_GIC, GIC, gic_qos),
+	QOS_DESC(PD_RGA, RGA_R, rga_r_qos),
+	QOS_DESC(PD_RGA, RGA_W, rga_w_qos),
+	QOS_DESC(PD_IEP, IEP, iep_qos),
+	QOS_DESC(PD_USB3, USB_OTG0, usb_otg0_qos),
+	QOS_DESC(PD_USB3, USB_OTG1, usb_otg1_qos),
+	QOS_DESC(PD_PERIHP, USB_HOST0, usb_host0_qos),
+	QOS_DESC(PD_PERIHP, USB_HOST1, usb_host1_qos),
+	QOS_DESC(PD_PERIHP, PERIHP_NSP, perihp_nsp_qos),
+	QOS_DESC(PD_PERILP, DMAC0, dmac0_qos),
+	QOS_DESC(PD_PERILP, DMAC1, dmac1_qos),
+	QOS_DESC(PD_PERILP, DCF, dcf_qos),
+	QOS_DESC(PD_PERILP, CRYPTO0, crypto0_qos),
+	QOS_DESC(PD_PERILP, CRYPTO1, crypto1_qos),
+	QOS_DESC(PD_PERILP, PERILP_NSP, perilp_nsp_qos),
+	QOS_DESC(PD_PERILP, PERILPSLV_NSP, perilpslv_nsp_qos),
+	QOS_DESC(PD_PERILP, PERI_CM1, peri_cm1_qos),
+	QOS_DESC(PD_VDU, VIDEO_M0, video_m0_qos),
+	QOS_DESC(PD_VCODEC, VIDEO_M1_R, video_m1_r_qos),
+	QOS_DESC(PD_VCODEC, VIDEO_M1_W, video_m1_w_qos),
+};
+
 static void qos_save(void)
 {
-	if (pmu_power_domain_st(PD_GPU) == pmu_pd_on)
-		RESTORE_QOS(pmu_slpdata.gpu_qos, GPU);
-	if (pmu_power_domain_st(PD_ISP0) == pmu_pd_on) {
-		RESTORE_QOS(pmu_slpdata.isp0_m0_qos, ISP0_M0);
-		RESTORE_QOS(pmu_slpdata.isp0_m1_qos, ISP0_M1);
-	}
-	if (pmu_power_domain_st(PD_ISP1) == pmu_pd_on) {
-		RESTORE_QOS(pmu_slpdata.isp1_m0_qos, ISP1_M0);
-		RESTORE_QOS(pmu_slpdata.isp1_m1_qos, ISP1_M1);
-	}
-	if (pmu_power_domain_st(PD_VO) == pmu_pd_on) {
-		RESTORE_QOS(pmu_slpdata.vop_big_r, VOP_BIG_R);
-		RESTORE_QOS(pmu_slpdata.vop_big_w, VOP_BIG_W);
-		RESTORE_QOS(pmu_slpdata.vop_little, VOP_LITTLE);
-	}
-	if (pmu_power_domain_st(PD_HDCP) == pmu_pd_on)
-		RESTORE_QOS(pmu_slpdata.hdcp_qos, HDCP);
-	if (pmu_power_domain_st(PD_GMAC) == pmu_pd_on)
-		RESTORE_QOS(pmu_slpdata.gmac_qos, GMAC);
-	if (pmu_power_domain_st(PD_CCI) == pmu_pd_on) {
-		RESTORE_QOS(pmu_slpdata.cci_m0_qos, CCI_M0);
-		RESTORE_QOS(pmu_slpdata.cci_m1_qos, CCI_M1);
-	}
-	if (pmu_power_domain_st(PD_SD) == pmu_pd_on)
-		RESTORE_QOS(pmu_slpdata.sdmmc_qos, SDMMC);
-	if (pmu_power_domain_st(PD_EMMC) == pmu_pd_on)
-		RESTORE_QOS(pmu_slpdata.emmc_qos, EMMC);
-	if (pmu_power_domain_st(PD_SDIOAUDIO) == pmu_pd_on)
-		RESTORE_QOS(pmu_slpdata.sdio_qos, SDIO);
-	if (pmu_power_domain_st(PD_GIC) == pmu_pd_on)
-		RESTORE_QOS(pmu_slpdata.gic_qos, GIC);
-	if (pmu_power_domain_st(PD_RGA) == pmu_pd_on) {
-		RESTORE_QOS(pmu_slpdata.rga_r_qos, RGA_R);
-		RESTORE_QOS(pmu_slpdata.rga_w_qos, RGA_W);
-	}
-	if (pmu_power_domain_st(PD_IEP) == pmu_pd_on)
-		RESTORE_QOS(pmu_slpdata.iep_qos, IEP);
-	if (pmu_power_domain_st(PD_USB3) == pmu_pd_on) {
-		RESTORE_QOS(pmu_slpdata.usb_otg0_qos, USB_OTG0);
-		RESTORE_QOS(pmu_slpdata.usb_otg1_qos, USB_OTG1);
-	}
-	if (pmu_power_domain_st(PD_PERIHP) == pmu_pd_on) {
-		RESTORE_QOS(pmu_slpdata.usb_host0_qos, USB_HOST0);
-		RESTORE_QOS(pmu_slpdata.usb_host1_qos, USB_HOST1);
-		RESTORE_QOS(pmu_slpdata.perihp_nsp_qos, PERIHP_NSP);
-	}
-	if (pmu_power_domain_st(PD_PERILP) == pmu_pd_on) {
-		RESTORE_QOS(pmu_slpdata.dmac0_qos, DMAC0);
-		RESTORE_QOS(pmu_slpdata.dmac1_qos, DMAC1);
-		RESTORE_QOS(pmu_slpdata.dcf_qos, DCF);
-		RESTORE_QOS(pmu_slpdata.crypto0_qos, CRYPTO0);
-		RESTORE_QOS(pmu_slpdata.crypto1_qos, CRYPTO1);
-		RESTORE_QOS(pmu_slpdata.perilp_nsp_qos, PERILP_NSP);
-		RESTORE_QOS(pmu_slpdata.perilpslv_nsp_qos, PERILPSLV_NSP);
-		RESTORE_QOS(pmu_slpdata.peri_cm1_qos, PERI_CM1);
-	}
-	if (pmu_power_domain_st(PD_VDU) == pmu_pd_on)
-		RESTORE_QOS(pmu_slpdata.video_m0_qos, VIDEO_M0);
-	if (pmu_power_domain_st(PD_VCODEC) == pmu_pd_on) {
-		RESTORE_QOS(pmu_slpdata.video_m1_r_qos, VIDEO_M1_R);
-		RESTORE_QOS(pmu_slpdata.video_m1_w_qos, VIDEO_M1_W);
+	const struct rk3399_qos_desc *desc;
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(rk3399_qos_descs); i++) {
+		desc = &rk3399_qos_descs[i];
+		if (pmu_power_domain_st(desc->pd) == pmu_pd_on)
+			mmio_read_32_range(desc->base, desc->regs,
+					   CPU_AXI_QOS_NUM_REGS);
 	}
 }
 
 static void qos_restore(void)
 {
-	if (pmu_power_domain_st(PD_GPU) == pmu_pd_on)
-		SAVE_QOS(pmu_slpdata.gpu_qos, GPU);
-	if (pmu_power_domain_st(PD_ISP0) == pmu_pd_on) {
-		SAVE_QOS(pmu_slpdata.isp0_m0_qos, ISP0_M0);
-		SAVE_QOS(pmu_slpdata.isp0_m1_qos, ISP0_M1);
-	}
-	if (pmu_power_domain_st(PD_ISP1) == pmu_pd_on) {
-		SAVE_QOS(pmu_slpdata.isp1_m0_qos, ISP1_M0);
-		SAVE_QOS(pmu_slpdata.isp1_m1_qos, ISP1_M1);
-	}
-	if (pmu_power_domain_st(PD_VO) == pmu_pd_on) {
-		SAVE_QOS(pmu_slpdata.vop_big_r, VOP_BIG_R);
-		SAVE_QOS(pmu_slpdata.vop_big_w, VOP_BIG_W);
-		SAVE_QOS(pmu_slpdata.vop_little, VOP_LITTLE);
-	}
-	if (pmu_power_domain_st(PD_HDCP) == pmu_pd_on)
-		SAVE_QOS(pmu_slpdata.hdcp_qos, HDCP);
-	if (pmu_power_domain_st(PD_GMAC) == pmu_pd_on)
-		SAVE_QOS(pmu_slpdata.gmac_qos, GMAC);
-	if (pmu_power_domain_st(PD_CCI) == pmu_pd_on) {
-		SAVE_QOS(pmu_slpdata.cci_m0_qos, CCI_M0);
-		SAVE_QOS(pmu_slpdata.cci_m1_qos, CCI_M1);
-	}
-	if (pmu_power_domain_st(PD_SD) == pmu_pd_on)
-		SAVE_QOS(pmu_slpdata.sdmmc_qos, SDMMC);
-	if (pmu_power_domain_st(PD_EMMC) == pmu_pd_on)
-		SAVE_QOS(pmu_slpdata.emmc_qos, EMMC);
-	if (pmu_power_domain_st(PD_SDIOAUDIO) == pmu_pd_on)
-		SAVE_QOS(pmu_slpdata.sdio_qos, SDIO);
-	if (pmu_power_domain_st(PD_GIC) == pmu_pd_on)
-		SAVE_QOS(pmu_slpdata.gic_qos, GIC);
-	if (pmu_power_domain_st(PD_RGA) == pmu_pd_on) {
-		SAVE_QOS(pmu_slpdata.rga_r_qos, RGA_R);
-		SAVE_QOS(pmu_slpdata.rga_w_qos, RGA_W);
-	}
-	if (pmu_power_domain_st(PD_IEP) == pmu_pd_on)
-		SAVE_QOS(pmu_slpdata.iep_qos, IEP);
-	if (pmu_power_domain_st(PD_USB3) == pmu_pd_on) {
-		SAVE_QOS(pmu_slpdata.usb_otg0_qos, USB_OTG0);
-		SAVE_QOS(pmu_slpdata.usb_otg1_qos, USB_OTG1);
-	}
-	if (pmu_power_domain_st(PD_PERIHP) == pmu_pd_on) {
-		SAVE_QOS(pmu_slpdata.usb_host0_qos, USB_HOST0);
-		SAVE_QOS(pmu_slpdata.usb_host1_qos, USB_HOST1);
-		SAVE_QOS(pmu_slpdata.perihp_nsp_qos, PERIHP_NSP);
-	}
-	if (pmu_power_domain_st(PD_PERILP) == pmu_pd_on) {
-		SAVE_QOS(pmu_slpdata.dmac0_qos, DMAC0);
-		SAVE_QOS(pmu_slpdata.dmac1_qos, DMAC1);
-		SAVE_QOS(pmu_slpdata.dcf_qos, DCF);
-		SAVE_QOS(pmu_slpdata.crypto0_qos, CRYPTO0);
-		SAVE_QOS(pmu_slpdata.crypto1_qos, CRYPTO1);
-		SAVE_QOS(pmu_slpdata.perilp_nsp_qos, PERILP_NSP);
-		SAVE_QOS(pmu_slpdata.perilpslv_nsp_qos, PERILPSLV_NSP);
-		SAVE_QOS(pmu_slpdata.peri_cm1_qos, PERI_CM1);
-	}
-	if (pmu_power_domain_st(PD_VDU) == pmu_pd_on)
-		SAVE_QOS(pmu_slpdata.video_m0_qos, VIDEO_M0);
-	if (pmu_power_domain_st(PD_VCODEC) == pmu_pd_on) {
-		SAVE_QOS(pmu_slpdata.video_m1_r_qos, VIDEO_M1_R);
-		SAVE_QOS(pmu_slpdata.video_m1_w_qos, VIDEO_M1_W);
+	const struct rk3399_qos_desc *desc;
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(rk3399_qos_descs); i++) {
+		desc = &rk3399_qos_descs[i];
+		if (pmu_power_domain_st(desc->pd) == pmu_pd_on)
+			mmio_write_32_range(desc->base, desc->regs,
+					    CPU_AXI_QOS_NUM_REGS);
 	}
 }
 
@@ -1044,6 +988,12 @@ static void resume_gpio(void)
 	}
 }
 
+/*
+ * The M0 runs M0_FUNC_SUSPEND from here until the resume, so it cannot take
+ * over the save and restore of the QoS, IO and GPIO state as well. These are
+ * left to the AP, which reads and writes the save areas in BL31 memory that
+ * the M0 cannot address anyway.
+ */
 static void m0_configure_suspend(void)
 {
 	/* set PARAM to M0_FUNC_SUSPEND */
@@ -69,31 +69,6 @@ enum pmu_core_pwrst_shift {
 #define IOMUX_CLK_32K		0x00030002
 #define NOC_AUTO_ENABLE		0x3fffffff
 
-#define SAVE_QOS(array, NAME) \
-	RK3399_CPU_AXI_SAVE_QOS(array, CPU_AXI_##NAME##_QOS_BASE)
-#define RESTORE_QOS(array, NAME) \
-	RK3399_CPU_AXI_RESTORE_QOS(array, CPU_AXI_##NAME##_QOS_BASE)
-
-#define RK3399_CPU_AXI_SAVE_QOS(array, base) do { \
-	array[0] = mmio_read_32(base + CPU_AXI_QOS_ID_COREID); \
-	array[1] = mmio_read_32(base + CPU_AXI_QOS_REVISIONID); \
-	array[2] = mmio_read_32(base + CPU_AXI_QOS_PRIORITY); \
-	array[3] = mmio_read_32(base + CPU_AXI_QOS_MODE); \
-	array[4] = mmio_read_32(base + CPU_AXI_QOS_BANDWIDTH); \
-	array[5] = mmio_read_32(base + CPU_AXI_QOS_SATURATION); \
-	array[6] = mmio_read_32(base + CPU_AXI_QOS_EXTCONTROL); \
-} while (0)
-
-#define RK3399_CPU_AXI_RESTORE_QOS(array, base) do { \
-	mmio_write_32(base + CPU_AXI_QOS_ID_COREID, array[0]); \
-	mmio_write_32(base + CPU_AXI_QOS_REVISIONID, array[1]); \
-	mmio_write_32(base + CPU_AXI_QOS_PRIORITY, array[2]); \
-	mmio_write_32(base + CPU_AXI_QOS_MODE, array[3]); \
-	mmio_write_32(base + CPU_AXI_QOS_BANDWIDTH, array[4]); \
-	mmio_write_32(base + CPU_AXI_QOS_SATURATION, array[5]); \
-	mmio_write_32(base + CPU_AXI_QOS_EXTCONTROL, array[6]); \
-} while (0)
-
 struct pmu_slpdata_s {
 	uint32_t cci_m0_qos[CPU_AXI_QOS_NUM_REGS];
 	uint32_t cci_m1_qos[CPU_AXI_QOS_NUM_REGS];
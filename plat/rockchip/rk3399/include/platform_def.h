@@ -53,6 +53,20 @@
 #define PLAT_RK_CLST_TO_CPUID_SHIFT	6
 #define PLAT_MAX_PWR_LVL		MPIDR_AFFLVL2
 
+/*
+ * Indices of the CPUs of the little and big clusters, converted from their
+ * MPIDRs with a table as the clusters do not have the same number of CPUs.
+ */
+#define PLAT_CORE_POS_AFF0_BITS		2
+#define PLAT_CORE_POS_AFF1_BITS		1
+#define PLAT_CORE_POS_ENTRIES				\
+	PLAT_CORE_POS_ENTRY(0x000, 0),			\
+	PLAT_CORE_POS_ENTRY(0x001, 1),			\
+	PLAT_CORE_POS_ENTRY(0x002, 2),			\
+	PLAT_CORE_POS_ENTRY(0x003, 3),			\
+	PLAT_CORE_POS_ENTRY(0x100, 4),			\
+	PLAT_CORE_POS_ENTRY(0x101, 5)
+
 /*
  * This macro defines the deepest retention state possible. A higher state
  * id will represent an invalid or a power down state.
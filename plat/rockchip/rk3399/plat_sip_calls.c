@@ -21,6 +21,8 @@
 #define DRAM_CLR_IRQ		0x06
 #define DRAM_SET_PARAM		0x07
 #define DRAM_SET_ODT_PD		0x08
+#define DRAM_SET_RATE_ASYNC	0x09
+#define DRAM_POLL_RATE		0x0a
 
 uint32_t ddr_smc_handler(uint64_t arg0, uint64_t arg1,
 			 uint64_t id, uint64_t arg2)
@@ -35,6 +37,14 @@ uint32_t ddr_smc_handler(uint64_t arg0, uint64_t arg1,
 	case DRAM_SET_ODT_PD:
 		dram_set_odt_pd(arg0, arg1, arg2);
 		break;
+	/*
+	 * DRAM_SET_RATE_ASYNC returns once the M0 is started, and the caller
+	 * polls DRAM_POLL_RATE until it returns the new rate rather than 0.
+	 */
+	case DRAM_SET_RATE_ASYNC:
+		return ddr_set_rate_async((uint32_t)arg0);
+	case DRAM_POLL_RATE:
+		return ddr_poll_rate();
 	default:
 		break;
 	}
@@ -40,6 +40,8 @@ BL31_SOURCES	+=	${RK_GIC_SOURCES}				\
 			drivers/gpio/gpio.c				\
 			lib/cpus/aarch64/cortex_a53.S			\
 			lib/cpus/aarch64/cortex_a72.S			\
+			plat/common/plat_core_pos.c			\
+			plat/common/aarch64/plat_core_pos.S		\
 			${RK_PLAT_COMMON}/aarch64/plat_helpers.S	\
 			${RK_PLAT_COMMON}/bl31_plat_setup.c		\
 			${RK_PLAT_COMMON}/params_setup.c		\
@@ -20,6 +20,10 @@ const mmap_region_t plat_arm_mmap[] = {
 	{ DEVICE0_BASE, DEVICE0_BASE, DEVICE0_SIZE, MT_DEVICE | MT_RW | MT_SECURE },
 	{ DEVICE1_BASE, DEVICE1_BASE, DEVICE1_SIZE, MT_DEVICE | MT_RW | MT_SECURE },
 	{ CRF_APB_BASE, CRF_APB_BASE, CRF_APB_SIZE, MT_DEVICE | MT_RW | MT_SECURE },
+#if ZYNQMP_PM_CALLB_QUEUE
+	{ ZYNQMP_PM_CALLB_QUEUE_BASE, ZYNQMP_PM_CALLB_QUEUE_BASE,
+	  ZYNQMP_PM_CALLB_QUEUE_SIZE, MT_MEMORY | MT_RW | MT_NS },
+#endif
 	{0}
 };
 
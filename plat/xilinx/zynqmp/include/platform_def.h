@@ -76,8 +76,14 @@
  ******************************************************************************/
 #define PLAT_PHY_ADDR_SPACE_SIZE	(1ull << 32)
 #define PLAT_VIRT_ADDR_SPACE_SIZE	(1ull << 32)
+#if ZYNQMP_PM_CALLB_QUEUE
+/* The shared page of the PMU callback queues needs its own tables */
+#define MAX_MMAP_REGIONS		8
+#define MAX_XLAT_TABLES			7
+#else
 #define MAX_MMAP_REGIONS		7
 #define MAX_XLAT_TABLES			5
+#endif
 
 #define CACHE_WRITEBACK_SHIFT   6
 #define CACHE_WRITEBACK_GRANULE (1 << CACHE_WRITEBACK_SHIFT)
@@ -99,6 +105,11 @@
 				ARM_IRQ_SEC_SGI_6,	\
 				ARM_IRQ_SEC_SGI_7
 
+#if ZYNQMP_PM_CALLB_QUEUE
+/* BL31 takes the IPI interrupt of the PMU callbacks */
+#define PLAT_ARM_G0_IRQS	ZYNQMP_IRQ_IPI_APU
+#else
 #define PLAT_ARM_G0_IRQS
+#endif
 
 #endif /* __PLATFORM_DEF_H__ */
@@ -33,6 +33,24 @@ ifdef ZYNQMP_BL32_MEM_BASE
     $(eval $(call add_define,ZYNQMP_BL32_MEM_SIZE))
 endif
 
+# Queue the PMU callbacks of each CPU in memory shared with the normal world,
+# taking the IPI interrupt of the PMU in BL31
+ZYNQMP_PM_CALLB_QUEUE	?=	0
+$(eval $(call assert_boolean,ZYNQMP_PM_CALLB_QUEUE))
+$(eval $(call add_define,ZYNQMP_PM_CALLB_QUEUE))
+
+ifeq (${ZYNQMP_PM_CALLB_QUEUE},1)
+    ifndef ZYNQMP_PM_CALLB_QUEUE_BASE
+        $(error "ZYNQMP_PM_CALLB_QUEUE requires ZYNQMP_PM_CALLB_QUEUE_BASE")
+    endif
+    $(eval $(call add_define,ZYNQMP_PM_CALLB_QUEUE_BASE))
+
+    # BL31 handles the secure interrupts in place of a Secure Payload
+    ifneq (${SPD},none)
+        $(error "ZYNQMP_PM_CALLB_QUEUE is not supported with SPD=${SPD}")
+    endif
+endif
+
 ZYNQMP_CONSOLE	?=	cadence
 $(eval $(call add_define_val,ZYNQMP_CONSOLE,ZYNQMP_CONSOLE_ID_${ZYNQMP_CONSOLE}))
 
@@ -72,3 +90,7 @@ BL31_SOURCES		+=	drivers/arm/cci/cci.c				\
 				plat/xilinx/zynqmp/pm_service/pm_api_sys.c	\
 				plat/xilinx/zynqmp/pm_service/pm_ipi.c		\
 				plat/xilinx/zynqmp/pm_service/pm_client.c
+
+ifeq (${ZYNQMP_PM_CALLB_QUEUE},1)
+BL31_SOURCES		+=	plat/xilinx/zynqmp/pm_service/pm_callb_queue.c
+endif
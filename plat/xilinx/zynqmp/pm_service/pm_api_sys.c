@@ -523,15 +523,37 @@ enum pm_ret_status pm_fpga_get_status(unsigned int *value)
  * @value       Buffer for return values. Must be large enough
  *		to hold 8 bytes.
  *
+ * The silicon ID never changes, so the PMU is only asked for it once and
+ * later calls return the cached registers.
+ *
  * @return      Returns silicon ID registers
  */
 enum pm_ret_status pm_get_chipid(uint32_t *value)
 {
+	static uint32_t chipid[2];
+	static volatile int chipid_valid;
 	uint32_t payload[PAYLOAD_ARG_CNT];
+	enum pm_ret_status ret;
+
+	if (chipid_valid) {
+		dmbish();
+		value[0] = chipid[0];
+		value[1] = chipid[1];
+		return PM_RET_SUCCESS;
+	}
 
 	/* Send request to the PMU */
 	PM_PACK_PAYLOAD1(payload, PM_GET_CHIPID);
-	return pm_ipi_send_sync(primary_proc, payload, value, 2);
+	ret = pm_ipi_send_sync(primary_proc, payload, value, 2);
+	if (ret == PM_RET_SUCCESS) {
+		chipid[0] = value[0];
+		chipid[1] = value[1];
+		/* Publish the registers before marking them valid */
+		dmbish();
+		chipid_valid = 1;
+	}
+
+	return ret;
 }
 
 /**
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Per-CPU queues of the PMU callbacks. BL31 takes the IPI interrupt of the
+ * PMU as a secure interrupt, moves the callback from the IPI buffer to the
+ * queue of the CPU that took the interrupt, and raises a non-secure SGI on
+ * this CPU. The NS driver drains all the callbacks queued for its CPU on an
+ * SGI, with no SMC for each of them.
+ */
+
+#include <arch_helpers.h>
+#include <cassert.h>
+#include <debug.h>
+#include <gic_common.h>
+#include <gicv2.h>
+#include <interrupt_mgmt.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <utils.h>
+#include "pm_api_sys.h"
+#include "pm_callb_queue.h"
+#include "pm_ipi.h"
+
+CASSERT((PLATFORM_CORE_COUNT * sizeof(pm_callb_queue_t)) <=
+	ZYNQMP_PM_CALLB_QUEUE_SIZE, assert_pm_callb_queue_size);
+
+/* No SGI is raised until the NS driver registers one */
+#define PM_CALLB_NO_SGI		~0U
+
+static unsigned int pm_callb_sgi = PM_CALLB_NO_SGI;
+
+static pm_callb_queue_t *pm_callb_get_queue(unsigned int cpu)
+{
+	return (pm_callb_queue_t *)ZYNQMP_PM_CALLB_QUEUE_BASE + cpu;
+}
+
+/**
+ * pm_callb_queue_push() - Move the pending callback to the queue of a CPU
+ * @q	Queue of the calling CPU
+ *
+ * The callback is read from the IPI buffer, which acknowledges it to the PMU.
+ * If the queue is full, the callback is left in the IPI buffer and the IPI
+ * interrupt disabled, until the NS driver reads it with PM_GET_CALLBACK_DATA.
+ */
+static void pm_callb_queue_push(pm_callb_queue_t *q)
+{
+	if (q->head - q->tail >= PM_CALLB_QUEUE_LEN) {
+		pm_ipi_irq_disable();
+		q->stalled = 1;
+		return;
+	}
+
+	pm_get_callbackdata(q->entry[q->head % PM_CALLB_QUEUE_LEN],
+			    PM_CALLB_WORDS);
+
+	/* Make the callback visible to the NS driver before accounting for it */
+	dmbish();
+	q->head++;
+}
+
+/**
+ * pm_callb_queue_irq_handler() - Handler of the secure interrupts
+ *
+ * @return	the context to return to, that of the interrupted world
+ */
+static uint64_t pm_callb_queue_irq_handler(uint32_t id, uint32_t flags,
+					   void *handle, void *cookie)
+{
+	unsigned int intr = plat_ic_acknowledge_interrupt() & INT_ID_MASK;
+
+	/* Another CPU took the interrupt first */
+	if (intr == GIC_SPURIOUS_INTERRUPT)
+		return (uint64_t)handle;
+
+	if (intr == ZYNQMP_IRQ_IPI_APU) {
+		pm_callb_queue_push(pm_callb_get_queue(plat_my_core_pos()));
+		if (pm_callb_sgi != PM_CALLB_NO_SGI)
+			plat_ic_raise_ns_sgi(pm_callb_sgi);
+	} else {
+		WARN("PM: Unexpected secure interrupt %u\n", intr);
+	}
+
+	plat_ic_end_of_interrupt(intr);
+
+	return (uint64_t)handle;
+}
+
+/**
+ * pm_callb_queue_init() - Set up the queues and take the IPI interrupt
+ *
+ * Called from pm_setup(), once the GIC is initialised. The IPI interrupt,
+ * configured as a secure interrupt by the platform, targets all the CPUs so
+ * that any running CPU takes it.
+ */
+void pm_callb_queue_init(void)
+{
+	unsigned int cpu;
+	uint32_t flags = 0;
+
+	for (cpu = 0; cpu < PLATFORM_CORE_COUNT; cpu++)
+		zeromem(pm_callb_get_queue(cpu), sizeof(pm_callb_queue_t));
+
+	gicv2_set_spi_targets(ZYNQMP_IRQ_IPI_APU,
+			      (1U << PLATFORM_CORE_COUNT) - 1);
+
+	set_interrupt_rm_flag(flags, NON_SECURE);
+	set_interrupt_rm_flag(flags, SECURE);
+	if (register_interrupt_type_handler(INTR_TYPE_S_EL1,
+					    pm_callb_queue_irq_handler,
+					    flags) != 0) {
+		ERROR("PM: Failed to register the IPI interrupt handler\n");
+		panic();
+	}
+}
+
+/**
+ * pm_callb_queue_register() - Register the SGI of the NS driver
+ * @sgi	Non-secure SGI raised when callbacks are queued for a CPU
+ *
+ * @return	PM_RET_SUCCESS, or PM_RET_ERROR_ARGS if @sgi is not an SGI
+ */
+enum pm_ret_status pm_callb_queue_register(uint32_t sgi)
+{
+	if (sgi >= MIN_PPI_ID)
+		return PM_RET_ERROR_ARGS;
+
+	pm_callb_sgi = sgi;
+
+	return PM_RET_SUCCESS;
+}
+
+/**
+ * pm_callb_queue_resume() - Queue the callbacks again after a stall
+ *
+ * Called once the NS driver has read the callback left in the IPI buffer.
+ */
+void pm_callb_queue_resume(void)
+{
+	unsigned int cpu;
+	pm_callb_queue_t *q;
+
+	for (cpu = 0; cpu < PLATFORM_CORE_COUNT; cpu++) {
+		q = pm_callb_get_queue(cpu);
+		if (q->stalled != 0) {
+			q->stalled = 0;
+			pm_ipi_irq_enable();
+		}
+	}
+}
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PM_CALLB_QUEUE_H_
+#define _PM_CALLB_QUEUE_H_
+
+#include <stdint.h>
+#include "pm_common.h"
+
+/* Callbacks held by the queue of each CPU, and words of each callback */
+#define PM_CALLB_QUEUE_LEN	15
+#define PM_CALLB_WORDS		4
+
+/*
+ * Queue of the PMU callbacks taken by a CPU, in the memory shared with the
+ * non-secure world at ZYNQMP_PM_CALLB_QUEUE_BASE. The queue of the CPU N lies
+ * at N * sizeof(pm_callb_queue_t). BL31 writes the callbacks and 'head', the
+ * NS driver reads them and advances 'tail'. 'stalled' is set when the queue
+ * was full and the callback was left in the IPI buffer, to be read with
+ * PM_GET_CALLBACK_DATA.
+ */
+typedef struct pm_callb_queue {
+	volatile uint32_t head;
+	volatile uint32_t tail;
+	volatile uint32_t stalled;
+	uint32_t reserved;
+	uint32_t entry[PM_CALLB_QUEUE_LEN][PM_CALLB_WORDS];
+} pm_callb_queue_t;
+
+void pm_callb_queue_init(void);
+enum pm_ret_status pm_callb_queue_register(uint32_t sgi);
+void pm_callb_queue_resume(void);
+
+#endif /* _PM_CALLB_QUEUE_H_ */
@@ -5,6 +5,7 @@
  */
 
 #include <bakery_lock.h>
+#include <delay_timer.h>
 #include <mmio.h>
 #include <platform.h>
 #include <arch_helpers.h>
@@ -59,6 +60,10 @@
 
 #define IPI_APU_MASK		1U
 
+/* Time given to the PMU to handle a request, and polling interval */
+#define PM_IPI_TIMEOUT_US	1000000U
+#define PM_IPI_POLL_US		1U
+
 DEFINE_BAKERY_LOCK(pm_secure_lock);
 
 const struct pm_ipi apu_ipi = {
@@ -90,20 +95,64 @@ int pm_ipi_init(void)
 /**
  * pm_ipi_wait() - wait for pmu to handle request
  * @proc	proc which is waiting for PMU to handle request
+ *
+ * @return	PM_RET_SUCCESS once the PMU has handled the request, or
+ *		PM_RET_ERROR_TIMEOUT if it did not within PM_IPI_TIMEOUT_US
  */
 static enum pm_ret_status pm_ipi_wait(const struct pm_proc *proc)
 {
-	int status;
+	unsigned int i;
 
 	/* Wait until previous interrupt is handled by PMU */
-	do {
-		status = mmio_read_32(proc->ipi->base + IPI_OBS_OFFSET) &
-					IPI_PMU_PM_INT_MASK;
-		/* TODO: 1) Use timer to add delay between read attempts */
-		/* TODO: 2) Return PM_RET_ERR_TIMEOUT if this times out */
-	} while (status);
+	for (i = 0; i < PM_IPI_TIMEOUT_US / PM_IPI_POLL_US; i++) {
+		if (!(mmio_read_32(proc->ipi->base + IPI_OBS_OFFSET) &
+		      IPI_PMU_PM_INT_MASK))
+			return PM_RET_SUCCESS;
+		udelay(PM_IPI_POLL_US);
+	}
 
-	return PM_RET_SUCCESS;
+	return PM_RET_ERROR_TIMEOUT;
+}
+
+/**
+ * pm_ipi_buff_write() - Copy words into an IPI buffer
+ * @base	Address of the IPI buffer, 64-bit aligned
+ * @buf	Words to copy
+ * @count	Number of words to copy
+ *
+ * The words are copied two at a time with 64-bit accesses, so that a whole
+ * request takes half as many transactions to the IPI buffer RAM.
+ */
+static void pm_ipi_buff_write(uintptr_t base, const uint32_t *buf,
+			      size_t count)
+{
+	size_t i;
+
+	for (i = 0; i + 1 < count; i += 2)
+		mmio_write_64(base + (i * PAYLOAD_ARG_SIZE),
+			      ((uint64_t)buf[i + 1] << 32) | buf[i]);
+	if (i < count)
+		mmio_write_32(base + (i * PAYLOAD_ARG_SIZE), buf[i]);
+}
+
+/**
+ * pm_ipi_buff_copy() - Copy words out of an IPI buffer
+ * @base	Address of the IPI buffer, 64-bit aligned
+ * @buf	Destination of the words
+ * @count	Number of words to copy
+ */
+static void pm_ipi_buff_copy(uintptr_t base, uint32_t *buf, size_t count)
+{
+	uint64_t val;
+	size_t i;
+
+	for (i = 0; i + 1 < count; i += 2) {
+		val = mmio_read_64(base + (i * PAYLOAD_ARG_SIZE));
+		buf[i] = (uint32_t)val;
+		buf[i + 1] = (uint32_t)(val >> 32);
+	}
+	if (i < count)
+		buf[i] = mmio_read_32(base + (i * PAYLOAD_ARG_SIZE));
 }
 
 /**
@@ -119,19 +168,18 @@ static enum pm_ret_status pm_ipi_wait(const struct pm_proc *proc)
 static enum pm_ret_status pm_ipi_send_common(const struct pm_proc *proc,
 					     uint32_t payload[PAYLOAD_ARG_CNT])
 {
-	unsigned int offset = 0;
 	uintptr_t buffer_base = proc->ipi->buffer_base +
 					IPI_BUFFER_TARGET_PMU_OFFSET +
 					IPI_BUFFER_REQ_OFFSET;
+	enum pm_ret_status ret;
 
 	/* Wait until previous interrupt is handled by PMU */
-	pm_ipi_wait(proc);
+	ret = pm_ipi_wait(proc);
+	if (ret != PM_RET_SUCCESS)
+		return ret;
 
 	/* Write payload into IPI buffer */
-	for (size_t i = 0; i < PAYLOAD_ARG_CNT; i++) {
-		mmio_write_32(buffer_base + offset, payload[i]);
-		offset += PAYLOAD_ARG_SIZE;
-	}
+	pm_ipi_buff_write(buffer_base, payload, PAYLOAD_ARG_CNT);
 	/* Generate IPI to PMU */
 	mmio_write_32(proc->ipi->base + IPI_TRIG_OFFSET, IPI_PMU_PM_INT_MASK);
 
@@ -173,12 +221,19 @@ enum pm_ret_status pm_ipi_send(const struct pm_proc *proc,
 static enum pm_ret_status pm_ipi_buff_read(const struct pm_proc *proc,
 					   unsigned int *value, size_t count)
 {
+	uint32_t resp[IPI_BUFFER_MAX_WORDS];
 	size_t i;
 	uintptr_t buffer_base = proc->ipi->buffer_base +
 				IPI_BUFFER_TARGET_PMU_OFFSET +
 				IPI_BUFFER_RESP_OFFSET;
+	enum pm_ret_status ret;
+
+	ret = pm_ipi_wait(proc);
+	if (ret != PM_RET_SUCCESS)
+		return ret;
 
-	pm_ipi_wait(proc);
+	if (count > IPI_BUFFER_MAX_WORDS - 1)
+		count = IPI_BUFFER_MAX_WORDS - 1;
 
 	/*
 	 * Read response from IPI buffer
@@ -187,24 +242,21 @@ static enum pm_ret_status pm_ipi_buff_read(const struct pm_proc *proc,
 	 * buf-2: unused
 	 * buf-3: unused
 	 */
-	for (i = 1; i <= count; i++) {
-		*value = mmio_read_32(buffer_base + (i * PAYLOAD_ARG_SIZE));
-		value++;
-	}
+	pm_ipi_buff_copy(buffer_base, resp, count + 1);
+	for (i = 1; i <= count; i++)
+		value[i - 1] = resp[i];
 
-	return mmio_read_32(buffer_base);
+	return resp[0];
 }
 
 /**
- * pm_ipi_buff_read_callb() - Reads IPI response after PMU has handled interrupt
- * @value	Used to return value from IPI buffer element (optional)
- * @count	Number of values to return in @value
- *
- * @return	Returns status, either success or error+reason
+ * pm_ipi_buff_read_callb() - Reads the callback request of the PMU
+ * @value	Used to return the words of the callback
+ * @count	Number of words to return in @value, at most
+ *		IPI_BUFFER_MAX_WORDS
  */
 void pm_ipi_buff_read_callb(unsigned int *value, size_t count)
 {
-	size_t i;
 	uintptr_t buffer_base = IPI_BUFFER_PMU_BASE +
 				IPI_BUFFER_TARGET_APU_OFFSET +
 				IPI_BUFFER_REQ_OFFSET;
@@ -212,10 +264,7 @@ void pm_ipi_buff_read_callb(unsigned int *value, size_t count)
 	if (count > IPI_BUFFER_MAX_WORDS)
 		count = IPI_BUFFER_MAX_WORDS;
 
-	for (i = 0; i <= count; i++) {
-		*value = mmio_read_32(buffer_base + (i * PAYLOAD_ARG_SIZE));
-		value++;
-	}
+	pm_ipi_buff_copy(buffer_base, value, count);
 }
 
 /**
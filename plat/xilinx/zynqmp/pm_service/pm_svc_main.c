@@ -13,12 +13,15 @@
 #include <gic_common.h>
 #include <runtime_svc.h>
 #include <string.h>
+#include <utils_def.h>
 #include "pm_api_sys.h"
+#include "pm_callb_queue.h"
 #include "pm_client.h"
 #include "pm_ipi.h"
 #include "../zynqmp_private.h"
 
 #define PM_GET_CALLBACK_DATA	0xa01
+#define PM_GET_CALLBACK_QUEUE	0xa02
 
 /* 0 - UP, !0 - DOWN */
 static int32_t pm_down = !0;
@@ -55,6 +58,10 @@ int pm_setup(void)
 		return -ENODEV;
 
 	status = pm_ipi_init();
+#if ZYNQMP_PM_CALLB_QUEUE
+	if (status == 0)
+		pm_callb_queue_init();
+#endif
 
 	if (status == 0)
 		INFO("BL31: PM Service Init Complete: API v%d.%d\n",
@@ -239,12 +246,28 @@ uint64_t pm_smc_handler(uint32_t smc_fid, uint64_t x1, uint64_t x2, uint64_t x3,
 	{
 		uint32_t result[4];
 
-		pm_get_callbackdata(result, sizeof(result));
+		pm_get_callbackdata(result, ARRAY_SIZE(result));
+#if ZYNQMP_PM_CALLB_QUEUE
+		/* The callback was left here as its queue was full */
+		pm_callb_queue_resume();
+#endif
 		SMC_RET2(handle,
 			 (uint64_t)result[0] | ((uint64_t)result[1] << 32),
 			 (uint64_t)result[2] | ((uint64_t)result[3] << 32));
 	}
 
+#if ZYNQMP_PM_CALLB_QUEUE
+	case PM_GET_CALLBACK_QUEUE:
+		/*
+		 * Register the SGI raised when callbacks are queued for a CPU,
+		 * and return the address of the queues and their length.
+		 */
+		ret = pm_callb_queue_register(pm_arg[0]);
+		SMC_RET2(handle, (uint64_t)ret |
+			 ((uint64_t)PM_CALLB_QUEUE_LEN << 32),
+			 ZYNQMP_PM_CALLB_QUEUE_BASE);
+#endif
+
 	default:
 		WARN("Unimplemented PM Service Call: 0x%x\n", smc_fid);
 		SMC_RET1(handle, SMC_UNK);
@@ -111,6 +111,15 @@
 
 #define MAX_INTR_EL3			128
 
+/* IPI interrupt of the APU, signalling the callbacks of the PMU */
+#define ZYNQMP_IRQ_IPI_APU		67
+
+/*******************************************************************************
+ * Memory shared with the non-secure world for the per-CPU queues of the PMU
+ * callbacks, at ZYNQMP_PM_CALLB_QUEUE_BASE
+ ******************************************************************************/
+#define ZYNQMP_PM_CALLB_QUEUE_SIZE	0x1000
+
 /*******************************************************************************
  * UART related constants
  ******************************************************************************/
@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*******************************************************************************
+ * Asynchronous notification of the normal world by the Secure Payload, e.g.
+ * when it completes a request that the normal world does not wait for in an
+ * SMC. The SPD raises the Non-secure SGI PLAT_SPD_NOTIFY_SGI on behalf of the
+ * SP, and the normal world driver finds out what happened through its own
+ * protocol with the SP, typically in shared memory.
+ ******************************************************************************/
+#include <cassert.h>
+#include <gic_common.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <spd_notify.h>
+
+CASSERT(PLAT_SPD_NOTIFY_SGI < MIN_PPI_ID, assert_spd_notify_sgi_is_sgi);
+
+/*******************************************************************************
+ * Raise the notification SGI on the calling CPU. The SGI is taken once the
+ * normal world runs with IRQs unmasked, or preempts the SP like any other
+ * non-secure interrupt when raised during a yielding SMC. The notifications
+ * raised before the normal world acknowledges the SGI are merged into one.
+ ******************************************************************************/
+void spd_notify_ns(void)
+{
+	plat_ic_raise_ns_sgi(PLAT_SPD_NOTIFY_SGI);
+}
@@ -0,0 +1,326 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*******************************************************************************
+ * Helpers shared by the Secure Payload Dispatchers to track the yielding SMCs
+ * of each CPU, and optionally let the non-secure interrupts preempt them.
+ *
+ * A yielding SMC is started on a CPU and must be resumed on the same CPU when
+ * it is preempted, as the state of the preempted SP lives in the secure
+ * context of this CPU. The normal world is responsible for not migrating the
+ * caller of a preempted SMC to another CPU.
+ *
+ * With SPD_NS_INTR_INJECT=1, a non-secure interrupt that preempts the SP is
+ * injected into the normal world, which enters its IRQ vector instead of
+ * returning from the preempted SMC. The saved registers of the SMC caller are
+ * changed into the arguments of the call that resumes the SP, and its return
+ * address is set back to the SMC instruction: once the interrupt is handled,
+ * the normal world issues the resuming SMC without being aware of the
+ * preemption.
+ ******************************************************************************/
+#include <arch.h>
+#include <arch_helpers.h>
+#include <assert.h>
+#include <context.h>
+#include <context_mgmt.h>
+#include <errno.h>
+#include <interrupt_mgmt.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <spd_yield.h>
+#include <string.h>
+
+/*
+ * Per-CPU state of the yielding SMCs. 'saved_gpregs', 'saved_elr_el3' and
+ * 'saved_spsr_el3' preserve the context of a preempted SP while the SPD enters
+ * it for another purpose, e.g. to handle a S-EL1 interrupt.
+ */
+typedef struct spd_yield_data {
+	gp_regs_t saved_gpregs;
+	uint64_t saved_elr_el3;
+	uint32_t saved_spsr_el3;
+	uint32_t state;
+} spd_yield_data_t;
+
+static spd_yield_data_t spd_yield_data[PLATFORM_CORE_COUNT];
+
+/* Handler of the SPD called on preemption by a non-secure interrupt */
+static spd_yield_preempted_t spd_yield_preempted;
+
+#if SPD_NS_INTR_INJECT
+/* Handler of the SPD programming the SMC that resumes the SP */
+static spd_yield_resume_call_t spd_yield_resume_call;
+
+/* Offsets of the IRQ vectors in the exception vector table of NS-EL1 */
+#define IRQ_VECTOR_SP_EL0	0x080
+#define IRQ_VECTOR_SP_ELX	0x280
+#endif
+
+static spd_yield_data_t *get_yield_data(void)
+{
+	return &spd_yield_data[plat_my_core_pos()];
+}
+
+/*
+ * Route the non-secure interrupts taken in the secure state to EL3 while the
+ * SP runs a yielding SMC, if the SPD asked for it.
+ */
+static void ns_intr_route_to_el3(int enable)
+{
+	if (!spd_yield_preempted)
+		return;
+
+	if (enable)
+		enable_intr_rm_local(INTR_TYPE_NS, SECURE);
+	else
+		disable_intr_rm_local(INTR_TYPE_NS, SECURE);
+}
+
+/*
+ * Switch from the SP, preempted during the yielding SMC of the calling CPU, to
+ * the normal world and return the non-secure context.
+ */
+static void *yield_preempt(spd_yield_data_t *data, uint32_t state)
+{
+	cpu_context_t *ns_cpu_context;
+
+	assert(data->state == SPD_YIELD_RUNNING);
+	data->state = state;
+	ns_intr_route_to_el3(0);
+
+	assert(cm_get_context(SECURE));
+	cm_el1_sysregs_context_save(SECURE);
+
+	/* Get a reference to the non-secure context */
+	ns_cpu_context = cm_get_context(NON_SECURE);
+	assert(ns_cpu_context);
+
+	cm_el1_sysregs_context_restore(NON_SECURE);
+	cm_set_next_eret_context(NON_SECURE);
+
+	return ns_cpu_context;
+}
+
+#if SPD_NS_INTR_INJECT
+/*******************************************************************************
+ * Make the next exception return to the non-secure context 'ns_ctx', which has
+ * been restored by yield_preempt(), enter the IRQ vector of NS-EL1 as if the
+ * interrupt had been taken on the SMC instruction of the preempted call. This
+ * is only possible when the SMC was issued from AArch64 EL1 with the IRQs
+ * unmasked, and the IRQs are not routed to EL2. Return 0 if the interrupt is
+ * injected, -1 otherwise.
+ ******************************************************************************/
+static int inject_ns_irq(cpu_context_t *ns_ctx)
+{
+	el3_state_t *state = get_el3state_ctx(ns_ctx);
+	uint64_t elr_el3 = read_ctx_reg(state, CTX_ELR_EL3);
+	uint32_t spsr_el3 = read_ctx_reg(state, CTX_SPSR_EL3);
+	uint64_t vector;
+
+	if ((GET_RW(spsr_el3) != MODE_RW_64) ||
+	    (GET_EL(spsr_el3) != MODE_EL1) ||
+	    (spsr_el3 & (DAIF_IRQ_BIT << SPSR_DAIF_SHIFT)))
+		return -1;
+
+	if (EL_IMPLEMENTED(2) &&
+	    (read_hcr_el2() & (HCR_IMO_BIT | HCR_TGE_BIT)))
+		return -1;
+
+	vector = read_vbar_el1();
+	vector += (GET_SP(spsr_el3) == MODE_SP_ELX) ? IRQ_VECTOR_SP_ELX :
+						       IRQ_VECTOR_SP_EL0;
+
+	/* The return address of an SMC is the next instruction */
+	write_elr_el1(elr_el3 - 4);
+	write_spsr_el1(spsr_el3);
+	cm_set_elr_spsr_el3(NON_SECURE, vector,
+			    SPSR_64(MODE_EL1, MODE_SP_ELX,
+				    DISABLE_ALL_EXCEPTIONS));
+
+	return 0;
+}
+#endif
+
+/*******************************************************************************
+ * Handler of the non-secure interrupts taken to EL3 while the SP runs a
+ * yielding SMC. The SP is preempted and the normal world resumed, which takes
+ * the interrupt once back in the non-secure state. With SPD_NS_INTR_INJECT=1,
+ * the normal world is resumed in its IRQ vector when possible, and replays the
+ * SMC as the resuming call on return from its IRQ handler.
+ ******************************************************************************/
+static uint64_t spd_yield_ns_interrupt_handler(uint32_t id,
+					       uint32_t flags,
+					       void *handle,
+					       void *cookie)
+{
+	void *ns_handle;
+
+	/* Check the security state when the exception was generated */
+	assert(get_interrupt_src_ss(flags) == SECURE);
+	assert(handle == cm_get_context(SECURE));
+
+	ns_handle = yield_preempt(get_yield_data(), SPD_YIELD_EL3_PREEMPTED);
+
+#if SPD_NS_INTR_INJECT
+	if (spd_yield_resume_call && (inject_ns_irq(ns_handle) == 0))
+		return spd_yield_resume_call(ns_handle);
+#endif
+
+	return spd_yield_preempted(ns_handle);
+}
+
+/*******************************************************************************
+ * Let the non-secure interrupts preempt the yielding SMCs, 'preempted' being
+ * called to program the value that the preempted SMC returns to the normal
+ * world. 'resume_call' is optional and programs the arguments of the SMC that
+ * resumes the SP, for the normal world to replay the SMC instead when the
+ * interrupt is injected into it. This is meant to be called once, after the SP
+ * has been initialised.
+ ******************************************************************************/
+int spd_yield_init(spd_yield_preempted_t preempted,
+		   spd_yield_resume_call_t resume_call)
+{
+	uint32_t flags = 0;
+	int rc;
+
+	assert(preempted);
+	assert(!spd_yield_preempted);
+
+	set_interrupt_rm_flag(flags, SECURE);
+	rc = register_interrupt_type_handler(INTR_TYPE_NS,
+					     spd_yield_ns_interrupt_handler,
+					     flags);
+	if (rc)
+		return rc;
+
+	spd_yield_preempted = preempted;
+#if SPD_NS_INTR_INJECT
+	spd_yield_resume_call = resume_call;
+#endif
+
+	/*
+	 * The non-secure interrupts are only routed to EL3 while the SP runs
+	 * a yielding SMC.
+	 */
+	ns_intr_route_to_el3(0);
+
+	return 0;
+}
+
+/* Return the state of the yielding SMC of the calling CPU */
+int spd_yield_get_state(void)
+{
+	return get_yield_data()->state;
+}
+
+/*******************************************************************************
+ * Mark the start of a yielding SMC on the calling CPU. This fails with -EBUSY
+ * when another yielding SMC is in progress on this CPU.
+ ******************************************************************************/
+int spd_yield_start(void)
+{
+	spd_yield_data_t *data = get_yield_data();
+
+	if (data->state != SPD_YIELD_IDLE)
+		return -EBUSY;
+
+	data->state = SPD_YIELD_RUNNING;
+	ns_intr_route_to_el3(1);
+
+	return 0;
+}
+
+/*******************************************************************************
+ * Mark the resumption of the preempted yielding SMC of the calling CPU. This
+ * fails with -EINVAL when no yielding SMC is preempted on this CPU. Otherwise
+ * this returns the state the SMC was preempted in, SPD_YIELD_EL3_PREEMPTED
+ * meaning that the SPD must enter the SP with its secure context untouched.
+ ******************************************************************************/
+int spd_yield_resume(void)
+{
+	spd_yield_data_t *data = get_yield_data();
+	int state = data->state;
+
+	if ((state != SPD_YIELD_SP_PREEMPTED) &&
+	    (state != SPD_YIELD_EL3_PREEMPTED))
+		return -EINVAL;
+
+	data->state = SPD_YIELD_RUNNING;
+	ns_intr_route_to_el3(1);
+
+	return state;
+}
+
+/*******************************************************************************
+ * Mark the completion of the yielding SMC of the calling CPU, if any.
+ ******************************************************************************/
+void spd_yield_done(void)
+{
+	spd_yield_data_t *data = get_yield_data();
+
+	if (data->state == SPD_YIELD_IDLE)
+		return;
+
+	assert(data->state == SPD_YIELD_RUNNING);
+	data->state = SPD_YIELD_IDLE;
+	ns_intr_route_to_el3(0);
+}
+
+/*******************************************************************************
+ * The SP asked to give up the CPU in the middle of the yielding SMC of the
+ * calling CPU. Save the secure state, switch to the normal world and return
+ * the non-secure context, in which the SPD programs the return values.
+ ******************************************************************************/
+void *spd_yield_preempt(void)
+{
+	return yield_preempt(get_yield_data(), SPD_YIELD_SP_PREEMPTED);
+}
+
+/*******************************************************************************
+ * Forget the yielding SMC of the calling CPU, e.g. as its secure context has
+ * been reinitialised when the CPU is turned on.
+ ******************************************************************************/
+void spd_yield_abort(void)
+{
+	get_yield_data()->state = SPD_YIELD_IDLE;
+	ns_intr_route_to_el3(0);
+}
+
+/*******************************************************************************
+ * Preserve the context of the SP preempted on the calling CPU, if any, before
+ * the SPD enters the SP for another purpose than resuming it, and restore it
+ * afterwards. The SP is expected to preserve its system registers.
+ ******************************************************************************/
+void spd_yield_ctx_save(void)
+{
+	spd_yield_data_t *data = get_yield_data();
+	cpu_context_t *ctx = cm_get_context(SECURE);
+
+	if ((data->state != SPD_YIELD_SP_PREEMPTED) &&
+	    (data->state != SPD_YIELD_EL3_PREEMPTED))
+		return;
+
+	assert(ctx);
+	memcpy(&data->saved_gpregs, get_gpregs_ctx(ctx), sizeof(gp_regs_t));
+	data->saved_elr_el3 = read_ctx_reg(get_el3state_ctx(ctx), CTX_ELR_EL3);
+	data->saved_spsr_el3 = read_ctx_reg(get_el3state_ctx(ctx),
+					    CTX_SPSR_EL3);
+}
+
+void spd_yield_ctx_restore(void)
+{
+	spd_yield_data_t *data = get_yield_data();
+	cpu_context_t *ctx = cm_get_context(SECURE);
+
+	if ((data->state != SPD_YIELD_SP_PREEMPTED) &&
+	    (data->state != SPD_YIELD_EL3_PREEMPTED))
+		return;
+
+	assert(ctx);
+	memcpy(get_gpregs_ctx(ctx), &data->saved_gpregs, sizeof(gp_regs_t));
+	cm_set_elr_spsr_el3(SECURE, data->saved_elr_el3,
+			    data->saved_spsr_el3);
+}
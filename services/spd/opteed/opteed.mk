@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2013-2014, ARM Limited and Contributors. All rights reserved.
+# Copyright (c) 2013-2017, ARM Limited and Contributors. All rights reserved.
 #
 # SPDX-License-Identifier: BSD-3-Clause
 #
@@ -7,9 +7,20 @@
 OPTEED_DIR		:=	services/spd/opteed
 SPD_INCLUDES		:=
 
-SPD_SOURCES		:=	services/spd/opteed/opteed_common.c	\
+SPD_SOURCES		:=	services/spd/common/spd_yield.c		\
+				services/spd/opteed/opteed_common.c	\
 				services/spd/opteed/opteed_helpers.S	\
 				services/spd/opteed/opteed_main.c	\
 				services/spd/opteed/opteed_pm.c
 
 NEED_BL32		:=	yes
+
+# Let the non-secure interrupts preempt the yielding SMCs serviced by OPTEE
+OPTEED_NS_INTR_ASYNC_PREEMPT	:=	0
+
+$(eval $(call assert_boolean,OPTEED_NS_INTR_ASYNC_PREEMPT))
+$(eval $(call add_define,OPTEED_NS_INTR_ASYNC_PREEMPT))
+
+ifeq (${SPD_NS_NOTIFY},1)
+SPD_SOURCES		+=	services/spd/common/spd_notify.c
+endif
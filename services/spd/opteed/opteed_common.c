@@ -33,7 +33,7 @@ void opteed_init_optee_ep_state(struct entry_point_info *optee_entry_point,
 	optee_ctx->state = 0;
 	set_optee_pstate(optee_ctx->state, OPTEE_PSTATE_OFF);
 
-	cm_set_context(&optee_ctx->cpu_ctx, SECURE);
+	cm_set_context(optee_ctx->cpu_ctx, SECURE);
 
 	/* initialise an entrypoint to set up the CPU context */
 	ep_attr = SECURE | EP_ST_ENABLE;
@@ -69,7 +69,7 @@ uint64_t opteed_synchronous_sp_entry(optee_context_t *optee_ctx)
 	assert(optee_ctx->c_rt_ctx == 0);
 
 	/* Apply the Secure EL1 system register context and switch to it */
-	assert(cm_get_context(SECURE) == &optee_ctx->cpu_ctx);
+	assert(cm_get_context(SECURE) == optee_ctx->cpu_ctx);
 	cm_el1_sysregs_context_restore(SECURE);
 	cm_set_next_eret_context(SECURE);
 
@@ -94,7 +94,7 @@ void opteed_synchronous_sp_exit(optee_context_t *optee_ctx, uint64_t ret)
 {
 	assert(optee_ctx != NULL);
 	/* Save the Secure EL1 system register context */
-	assert(cm_get_context(SECURE) == &optee_ctx->cpu_ctx);
+	assert(cm_get_context(SECURE) == optee_ctx->cpu_ctx);
 	cm_el1_sysregs_context_save(SECURE);
 
 	assert(optee_ctx->c_rt_ctx != 0);
@@ -23,6 +23,8 @@
 #include <errno.h>
 #include <platform.h>
 #include <runtime_svc.h>
+#include <spd_notify.h>
+#include <spd_yield.h>
 #include <stddef.h>
 #include <uuid.h>
 #include "opteed_private.h"
@@ -45,6 +47,29 @@ uint32_t opteed_rw;
 
 static int32_t opteed_init(void);
 
+#if OPTEED_NS_INTR_ASYNC_PREEMPT
+/*******************************************************************************
+ * Report a yielding SMC preempted by a non-secure interrupt as an RPC for a
+ * foreign interrupt of a dedicated thread, which the normal world resumes with
+ * OPTEE_SMC_CALL_RETURN_FROM_RPC once it has handled the interrupt.
+ ******************************************************************************/
+static uint64_t opteed_yield_preempted(void *handle)
+{
+	SMC_RET4(handle, OPTEE_SMC_RETURN_RPC_FOREIGN_INTR, 0, 0,
+		 OPTEED_PREEMPTED_THREAD_ID);
+}
+
+/*******************************************************************************
+ * Program the call that resumes the preempted yielding SMC, which the normal
+ * world replays on return from the non-secure interrupt injected into it.
+ ******************************************************************************/
+static uint64_t opteed_yield_resume_call(void *handle)
+{
+	SMC_RET4(handle, OPTEE_SMC_CALL_RETURN_FROM_RPC, 0, 0,
+		 OPTEED_PREEMPTED_THREAD_ID);
+}
+#endif
+
 /*******************************************************************************
  * This function is the handler registered for S-EL1 interrupts by the
  * OPTEED. It validates the interrupt and upon success arranges entry into
@@ -70,7 +95,10 @@ static uint64_t opteed_sel1_interrupt_handler(uint32_t id,
 	/* Get a reference to this cpu's OPTEE context */
 	linear_id = plat_my_core_pos();
 	optee_ctx = &opteed_sp_context[linear_id];
-	assert(&optee_ctx->cpu_ctx == cm_get_context(SECURE));
+	assert(optee_ctx->cpu_ctx == cm_get_context(SECURE));
+
+	/* Preserve the context of a preempted yielding SMC, if any */
+	spd_yield_ctx_save();
 
 	cm_set_elr_el3(SECURE, (uint64_t)&optee_vectors->fiq_entry);
 	cm_el1_sysregs_context_restore(SECURE);
@@ -83,7 +111,7 @@ static uint64_t opteed_sel1_interrupt_handler(uint32_t id,
 	 * retrieve this address from ELR_EL3 as the secure context will
 	 * not take effect until el3_exit().
 	 */
-	SMC_RET1(&optee_ctx->cpu_ctx, read_elr_el3());
+	SMC_RET1(optee_ctx->cpu_ctx, read_elr_el3());
 }
 
 /*******************************************************************************
@@ -95,9 +123,15 @@ int32_t opteed_setup(void)
 {
 	entry_point_info_t *optee_ep_info;
 	uint32_t linear_id;
+	unsigned int i;
 
 	linear_id = plat_my_core_pos();
 
+	/* The OPTEE context of a cpu sits next to its non-secure context */
+	for (i = 0; i < OPTEED_CORE_COUNT; i++)
+		opteed_sp_context[i].cpu_ctx =
+			cm_get_context_slot_by_index(i, SECURE);
+
 	/*
 	 * Get information about the Secure Payload (BL32) image. Its
 	 * absence is a critical failure.  TODO: Add support to
@@ -210,6 +244,31 @@ uint64_t opteed_smc_handler(uint32_t smc_fid,
 		 */
 		assert(handle == cm_get_context(NON_SECURE));
 
+#if OPTEED_NS_INTR_ASYNC_PREEMPT
+		/*
+		 * Resume the yielding SMC preempted on this cpu where it was
+		 * interrupted, and hold back any other call until then.
+		 */
+		if ((smc_fid == OPTEE_SMC_CALL_RETURN_FROM_RPC) &&
+		    (x3 == OPTEED_PREEMPTED_THREAD_ID)) {
+			if (spd_yield_resume() != SPD_YIELD_EL3_PREEMPTED)
+				SMC_RET1(handle, SMC_UNK);
+
+			cm_el1_sysregs_context_save(NON_SECURE);
+			cm_el1_sysregs_context_restore(SECURE);
+			cm_set_next_eret_context(SECURE);
+			SMC_RET0(optee_ctx->cpu_ctx);
+		}
+
+		if (GET_SMC_TYPE(smc_fid) == SMC_TYPE_YIELD) {
+			if (spd_yield_start())
+				SMC_RET1(handle,
+					 OPTEE_SMC_RETURN_ETHREAD_LIMIT);
+		} else if (spd_yield_get_state() != SPD_YIELD_IDLE) {
+			SMC_RET1(handle, SMC_UNK);
+		}
+#endif
+
 		cm_el1_sysregs_context_save(NON_SECURE);
 
 		/*
@@ -224,7 +283,7 @@ uint64_t opteed_smc_handler(uint32_t smc_fid,
 		 * payload. Entry into S-EL1 will take place upon exit
 		 * from this function.
 		 */
-		assert(&optee_ctx->cpu_ctx == cm_get_context(SECURE));
+		assert(optee_ctx->cpu_ctx == cm_get_context(SECURE));
 
 		/* Set appropriate entry for SMC.
 		 * We expect OPTEE to manage the PSTATE.I and PSTATE.F
@@ -241,25 +300,25 @@ uint64_t opteed_smc_handler(uint32_t smc_fid,
 		cm_el1_sysregs_context_restore(SECURE);
 		cm_set_next_eret_context(SECURE);
 
-		write_ctx_reg(get_gpregs_ctx(&optee_ctx->cpu_ctx),
+		write_ctx_reg(get_gpregs_ctx(optee_ctx->cpu_ctx),
 			      CTX_GPREG_X4,
 			      read_ctx_reg(get_gpregs_ctx(handle),
 					   CTX_GPREG_X4));
-		write_ctx_reg(get_gpregs_ctx(&optee_ctx->cpu_ctx),
+		write_ctx_reg(get_gpregs_ctx(optee_ctx->cpu_ctx),
 			      CTX_GPREG_X5,
 			      read_ctx_reg(get_gpregs_ctx(handle),
 					   CTX_GPREG_X5));
-		write_ctx_reg(get_gpregs_ctx(&optee_ctx->cpu_ctx),
+		write_ctx_reg(get_gpregs_ctx(optee_ctx->cpu_ctx),
 			      CTX_GPREG_X6,
 			      read_ctx_reg(get_gpregs_ctx(handle),
 					   CTX_GPREG_X6));
 		/* Propagate hypervisor client ID */
-		write_ctx_reg(get_gpregs_ctx(&optee_ctx->cpu_ctx),
+		write_ctx_reg(get_gpregs_ctx(optee_ctx->cpu_ctx),
 			      CTX_GPREG_X7,
 			      read_ctx_reg(get_gpregs_ctx(handle),
 					   CTX_GPREG_X7));
 
-		SMC_RET4(&optee_ctx->cpu_ctx, smc_fid, x1, x2, x3);
+		SMC_RET4(optee_ctx->cpu_ctx, smc_fid, x1, x2, x3);
 	}
 
 	/*
@@ -299,6 +358,16 @@ uint64_t opteed_smc_handler(uint32_t smc_fid,
 						flags);
 			if (rc)
 				panic();
+
+#if OPTEED_NS_INTR_ASYNC_PREEMPT
+			/*
+			 * Let the non-secure interrupts preempt the yielding
+			 * SMCs serviced by OPTEE.
+			 */
+			if (spd_yield_init(opteed_yield_preempted,
+					   opteed_yield_resume_call))
+				panic();
+#endif
 		}
 
 		/*
@@ -356,6 +425,11 @@ uint64_t opteed_smc_handler(uint32_t smc_fid,
 		assert(handle == cm_get_context(SECURE));
 		cm_el1_sysregs_context_save(SECURE);
 
+#if OPTEED_NS_INTR_ASYNC_PREEMPT
+		/* Mark the yielding SMC, if any, as completed */
+		spd_yield_done();
+#endif
+
 		/* Get a reference to the non-secure context */
 		ns_cpu_context = cm_get_context(NON_SECURE);
 		assert(ns_cpu_context);
@@ -375,6 +449,9 @@ uint64_t opteed_smc_handler(uint32_t smc_fid,
 		ns_cpu_context = cm_get_context(NON_SECURE);
 		assert(ns_cpu_context);
 
+		/* Restore the context of a preempted yielding SMC, if any */
+		spd_yield_ctx_restore();
+
 		/*
 		 * Restore non-secure state. There is no need to save the
 		 * secure system register context since OPTEE was supposed
@@ -385,6 +462,18 @@ uint64_t opteed_smc_handler(uint32_t smc_fid,
 
 		SMC_RET0((uint64_t) ns_cpu_context);
 
+	/*
+	 * OPTEE notifies the normal world asynchronously, e.g. of the
+	 * completion of a request, and carries on.
+	 */
+	case TEESMC_OPTEED_NOTIFY_NS:
+#if SPD_NS_NOTIFY
+		spd_notify_ns();
+		SMC_RET1(handle, 0);
+#else
+		SMC_RET1(handle, SMC_UNK);
+#endif
+
 	default:
 		panic();
 	}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2017, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -10,6 +10,7 @@
 #include <context_mgmt.h>
 #include <debug.h>
 #include <platform.h>
+#include <spd_yield.h>
 #include "opteed_private.h"
 
 /*******************************************************************************
@@ -66,6 +67,12 @@ static void opteed_cpu_suspend_handler(uint64_t max_off_pwrlvl)
 	assert(optee_vectors);
 	assert(get_optee_pstate(optee_ctx->state) == OPTEE_PSTATE_ON);
 
+	/*
+	 * Preserve the context of a preempted yielding SMC, if any, until this
+	 * cpu resumes.
+	 */
+	spd_yield_ctx_save();
+
 	/* Program the entry point and enter OPTEE */
 	cm_set_elr_el3(SECURE, (uint64_t) &optee_vectors->cpu_suspend_entry);
 	rc = opteed_synchronous_sp_entry(optee_ctx);
@@ -104,6 +111,13 @@ static void opteed_cpu_on_finish_handler(uint64_t unused)
 	/* Initialise this cpu's secure context */
 	cm_init_my_context(&optee_on_entrypoint);
 
+	/*
+	 * A yielding SMC preempted before this cpu was turned off is lost with
+	 * the previous secure context. This also stops the routing of the
+	 * non-secure interrupts to EL3 set up by the new context.
+	 */
+	spd_yield_abort();
+
 	/* Enter OPTEE */
 	rc = opteed_synchronous_sp_entry(optee_ctx);
 
@@ -133,7 +147,7 @@ static void opteed_cpu_suspend_finish_handler(uint64_t max_off_pwrlvl)
 	assert(get_optee_pstate(optee_ctx->state) == OPTEE_PSTATE_SUSPEND);
 
 	/* Program the entry point, max_off_pwrlvl and enter the SP */
-	write_ctx_reg(get_gpregs_ctx(&optee_ctx->cpu_ctx),
+	write_ctx_reg(get_gpregs_ctx(optee_ctx->cpu_ctx),
 		      CTX_GPREG_X0,
 		      max_off_pwrlvl);
 	cm_set_elr_el3(SECURE, (uint64_t) &optee_vectors->cpu_resume_entry);
@@ -146,6 +160,9 @@ static void opteed_cpu_suspend_finish_handler(uint64_t max_off_pwrlvl)
 	if (rc != 0)
 		panic();
 
+	/* Restore the context of a preempted yielding SMC, if any */
+	spd_yield_ctx_restore();
+
 	/* Update its context to reflect the state OPTEE is in */
 	set_optee_pstate(optee_ctx->state, OPTEE_PSTATE_ON);
 }
@@ -120,13 +120,13 @@ CASSERT(OPTEED_C_RT_CTX_SIZE == sizeof(c_rt_regs_t),	\
  * 'mpidr'          - mpidr to associate a context with a cpu
  * 'c_rt_ctx'       - stack address to restore C runtime context from after
  *                    returning from a synchronous entry into OPTEE.
- * 'cpu_ctx'        - space to maintain OPTEE architectural state
+ * 'cpu_ctx'        - OPTEE architectural state, in the context slot of the cpu
  ******************************************************************************/
 typedef struct optee_context {
 	uint32_t state;
 	uint64_t mpidr;
 	uint64_t c_rt_ctx;
-	cpu_context_t cpu_ctx;
+	cpu_context_t *cpu_ctx;
 } optee_context_t;
 
 /* OPTEED power management handlers */
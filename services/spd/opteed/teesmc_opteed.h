@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2017, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -120,4 +120,34 @@
 #define TEESMC_OPTEED_RETURN_SYSTEM_RESET_DONE \
 	TEESMC_OPTEED_RV(TEESMC_OPTEED_FUNCID_RETURN_SYSTEM_RESET_DONE)
 
+/*
+ * Issued to notify the normal world asynchronously with the SGI
+ * PLAT_SPD_NOTIFY_SGI on the calling CPU, when SPD_NS_NOTIFY=1. Unlike the
+ * calls above, this returns to OP-TEE.
+ *
+ * Register usage:
+ * r0/x0	SMC Function ID, TEESMC_OPTEED_NOTIFY_NS
+ *
+ * Return:
+ * r0/x0	0 on success, or SMC_UNK if the notifications are not
+ *		supported
+ */
+#define TEESMC_OPTEED_FUNCID_NOTIFY_NS			9
+#define TEESMC_OPTEED_NOTIFY_NS \
+	TEESMC_OPTEED_RV(TEESMC_OPTEED_FUNCID_NOTIFY_NS)
+
+/*
+ * Values of the normal world SMC interface of OP-TEE used by the OPTEED when a
+ * non-secure interrupt preempts a yielding SMC at EL3.
+ *
+ * The preempted SMC returns OPTEE_SMC_RETURN_RPC_FOREIGN_INTR, with the thread
+ * identifier OPTEED_PREEMPTED_THREAD_ID in x3, and is resumed by the normal
+ * world with OPTEE_SMC_CALL_RETURN_FROM_RPC and this identifier in x3. Other
+ * yielding SMCs return OPTEE_SMC_RETURN_ETHREAD_LIMIT in the meantime.
+ */
+#define OPTEE_SMC_CALL_RETURN_FROM_RPC		0x32000003
+#define OPTEE_SMC_RETURN_ETHREAD_LIMIT		0x1
+#define OPTEE_SMC_RETURN_RPC_FOREIGN_INTR	0xffff0004
+#define OPTEED_PREEMPTED_THREAD_ID		0xffffffff
+
 #endif /*TEESMC_OPTEED_H*/
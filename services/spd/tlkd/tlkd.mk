@@ -1,12 +1,23 @@
 #
-# Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+# Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
 #
 # SPDX-License-Identifier: BSD-3-Clause
 #
 
 SPD_INCLUDES		:=	-Iinclude/bl32/payloads
 
-SPD_SOURCES		:=	services/spd/tlkd/tlkd_common.c		\
+SPD_SOURCES		:=	services/spd/common/spd_yield.c		\
+				services/spd/tlkd/tlkd_common.c		\
 				services/spd/tlkd/tlkd_helpers.S	\
 				services/spd/tlkd/tlkd_main.c		\
 				services/spd/tlkd/tlkd_pm.c
+
+# Let the non-secure interrupts preempt the yielding SMCs serviced by TLK
+TLKD_NS_INTR_ASYNC_PREEMPT	:=	0
+
+$(eval $(call assert_boolean,TLKD_NS_INTR_ASYNC_PREEMPT))
+$(eval $(call add_define,TLKD_NS_INTR_ASYNC_PREEMPT))
+
+ifeq (${SPD_NS_NOTIFY},1)
+SPD_SOURCES		+=	services/spd/common/spd_notify.c
+endif
@@ -22,6 +22,8 @@
 #include <errno.h>
 #include <platform.h>
 #include <runtime_svc.h>
+#include <spd_notify.h>
+#include <spd_yield.h>
 #include <stddef.h>
 #include <tlk.h>
 #include <uuid.h>
@@ -46,6 +48,26 @@ DEFINE_SVC_UUID(tlk_uuid,
 
 int32_t tlkd_init(void);
 
+#if TLKD_NS_INTR_ASYNC_PREEMPT
+/*******************************************************************************
+ * Return SMC_PREEMPTED to the normal world when a non-secure interrupt preempts
+ * TLK. The normal world resumes the call with TLK_RESUME_FID.
+ ******************************************************************************/
+static uint64_t tlkd_yield_preempted(void *handle)
+{
+	SMC_RET1(handle, SMC_PREEMPTED);
+}
+
+/*******************************************************************************
+ * Program the call that resumes the preempted yielding SMC, which the normal
+ * world replays on return from the non-secure interrupt injected into it.
+ ******************************************************************************/
+static uint64_t tlkd_yield_resume_call(void *handle)
+{
+	SMC_RET1(handle, TLK_RESUME_FID);
+}
+#endif
+
 /*******************************************************************************
  * Secure Payload Dispatcher setup. The SPD finds out the SP entrypoint and type
  * (aarch32/aarch64) if not already known and initialises the context for entry
@@ -146,6 +168,7 @@ uint64_t tlkd_smc_handler(uint32_t smc_fid,
 	gp_regs_t *gp_regs;
 	uint32_t ns;
 	uint64_t par;
+	int rc;
 
 	/* Passing a NULL context is a critical programming error */
 	assert(handle);
@@ -169,19 +192,12 @@ uint64_t tlkd_smc_handler(uint32_t smc_fid,
 			SMC_RET1(handle, SMC_UNK);
 
 		assert(handle == cm_get_context(SECURE));
-		cm_el1_sysregs_context_save(SECURE);
-
-		/* Get a reference to the non-secure context */
-		ns_cpu_context = cm_get_context(NON_SECURE);
-		assert(ns_cpu_context);
 
 		/*
-		 * Restore non-secure state. There is no need to save the
-		 * secure system register context since the SP was supposed
-		 * to preserve it during S-EL1 interrupt handling.
+		 * Save the secure state and switch to the non-secure state,
+		 * which resumes the call later on with TLK_RESUME_FID.
 		 */
-		cm_el1_sysregs_context_restore(NON_SECURE);
-		cm_set_next_eret_context(NON_SECURE);
+		ns_cpu_context = spd_yield_preempt();
 
 		SMC_RET1(ns_cpu_context, x1);
 
@@ -219,15 +235,16 @@ uint64_t tlkd_smc_handler(uint32_t smc_fid,
 		/*
 		 * Check if we are already processing a yielding SMC
 		 * call. Of all the supported fids, only the "resume"
-		 * fid expects the flag to be set.
+		 * fid expects one to be preempted, and marks it as
+		 * running again.
 		 */
-		if (smc_fid == TLK_RESUME_FID) {
-			if (!get_yield_smc_active_flag(tlk_ctx.state))
-				SMC_RET1(handle, SMC_UNK);
-		} else {
-			if (get_yield_smc_active_flag(tlk_ctx.state))
-				SMC_RET1(handle, SMC_UNK);
-		}
+		if (smc_fid == TLK_RESUME_FID)
+			rc = spd_yield_resume();
+		else
+			rc = spd_yield_start();
+
+		if (rc < 0)
+			SMC_RET1(handle, SMC_UNK);
 
 		cm_el1_sysregs_context_save(NON_SECURE);
 
@@ -236,11 +253,6 @@ uint64_t tlkd_smc_handler(uint32_t smc_fid,
 		 */
 		assert(&tlk_ctx.cpu_ctx == cm_get_context(SECURE));
 
-		/*
-		 * Mark the SP state as active.
-		 */
-		set_yield_smc_active_flag(tlk_ctx.state);
-
 		/*
 		 * We are done stashing the non-secure context. Ask the
 		 * secure payload to do the work now.
@@ -248,6 +260,13 @@ uint64_t tlkd_smc_handler(uint32_t smc_fid,
 		cm_el1_sysregs_context_restore(SECURE);
 		cm_set_next_eret_context(SECURE);
 
+		/*
+		 * A call preempted by a non-secure interrupt resumes
+		 * where it was interrupted.
+		 */
+		if (rc == SPD_YIELD_EL3_PREEMPTED)
+			SMC_RET0(&tlk_ctx.cpu_ctx);
+
 		/*
 		 * TLK is a 32-bit Trusted OS and so expects the SMC
 		 * arguments via r0-r7. TLK expects the monitor frame
@@ -296,6 +315,24 @@ uint64_t tlkd_smc_handler(uint32_t smc_fid,
 		/* return physical address in r0-r1 */
 		SMC_RET4(handle, (uint32_t)par, (uint32_t)(par >> 32), 0, 0);
 
+	/*
+	 * This is a request from the SP to notify the normal world
+	 * asynchronously, e.g. of the completion of a request. The
+	 * notification SGI is raised on this CPU and the SP carries on.
+	 */
+	case TLK_NOTIFY_NS:
+
+		/* Should be invoked only by secure world */
+		if (ns)
+			SMC_RET1(handle, SMC_UNK);
+
+#if SPD_NS_NOTIFY
+		spd_notify_ns();
+		SMC_RET1(handle, 0);
+#else
+		SMC_RET1(handle, SMC_UNK);
+#endif
+
 	/*
 	 * This is a request from the SP to mark completion of
 	 * a yielding function ID.
@@ -305,9 +342,9 @@ uint64_t tlkd_smc_handler(uint32_t smc_fid,
 			SMC_RET1(handle, SMC_UNK);
 
 		/*
-		 * Mark the SP state as inactive.
+		 * Mark the yielding SMC as completed.
 		 */
-		clr_yield_smc_active_flag(tlk_ctx.state);
+		spd_yield_done();
 
 		/* Get a reference to the non-secure context */
 		ns_cpu_context = cm_get_context(NON_SECURE);
@@ -341,6 +378,16 @@ uint64_t tlkd_smc_handler(uint32_t smc_fid,
 		 */
 		psci_register_spd_pm_hook(&tlkd_pm_ops);
 
+#if TLKD_NS_INTR_ASYNC_PREEMPT
+		/*
+		 * Let the non-secure interrupts preempt the yielding SMCs
+		 * serviced by TLK.
+		 */
+		if (spd_yield_init(tlkd_yield_preempted,
+				   tlkd_yield_resume_call))
+			panic();
+#endif
+
 		/*
 		 * TLK reports completion. The SPD must have initiated
 		 * the original request through a synchronous entry
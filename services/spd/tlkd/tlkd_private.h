@@ -13,26 +13,6 @@
 #include <platform_def.h>
 #include <psci.h>
 
-/*
- * This flag is used by the TLKD to determine if the SP is servicing a yielding
- * SMC request prior to programming the next entry into the SP e.g. if SP
- * execution is preempted by a non-secure interrupt and handed control to the
- * normal world. If another request which is distinct from what the SP was
- * previously doing arrives, then this flag will be help the TLKD to either
- * reject the new request or service it while ensuring that the previous context
- * is not corrupted.
- */
-#define YIELD_SMC_ACTIVE_FLAG_SHIFT	2
-#define YIELD_SMC_ACTIVE_FLAG_MASK	1
-#define get_yield_smc_active_flag(state)				\
-			(((state) >> YIELD_SMC_ACTIVE_FLAG_SHIFT)	\
-			& YIELD_SMC_ACTIVE_FLAG_MASK)
-#define set_yield_smc_active_flag(state)	((state) |=		\
-					 (1 << YIELD_SMC_ACTIVE_FLAG_SHIFT))
-#define clr_yield_smc_active_flag(state)	((state) &=		\
-					 ~(YIELD_SMC_ACTIVE_FLAG_MASK	\
-					 << YIELD_SMC_ACTIVE_FLAG_SHIFT))
-
 /*******************************************************************************
  * Translate virtual address received from the NS world
  ******************************************************************************/
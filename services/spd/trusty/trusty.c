@@ -12,6 +12,7 @@
 #include <debug.h>
 #include <interrupt_mgmt.h>
 #include <platform.h>
+#include <platform_def.h>
 #include <runtime_svc.h>
 #include <string.h>
 
@@ -24,13 +25,21 @@
 /* length of Trusty's input parameters (in bytes) */
 #define TRUSTY_PARAMS_LEN_BYTES	(4096*2)
 
+/*
+ * Size of the stack that each cpu uses while running Trusty, which the
+ * platform can override.
+ */
+#ifndef PLAT_TRUSTY_STACK_SIZE
+#define PLAT_TRUSTY_STACK_SIZE	PLATFORM_STACK_SIZE
+#endif
+
 struct trusty_stack {
-	uint8_t space[PLATFORM_STACK_SIZE] __aligned(16);
+	uint8_t space[PLAT_TRUSTY_STACK_SIZE] __aligned(16);
 	uint32_t end;
 };
 
 struct trusty_cpu_ctx {
-	cpu_context_t	cpu_ctx;
+	cpu_context_t	*cpu_ctx;
 	void		*saved_sp;
 	uint32_t	saved_security_state;
 	int		fiq_handler_active;
@@ -42,7 +51,7 @@ struct trusty_cpu_ctx {
 	uint64_t	fiq_sp_el1;
 	gp_regs_t	fiq_gpregs;
 	struct trusty_stack	secure_stack;
-};
+} __aligned(CACHE_WRITEBACK_GRANULE);
 
 struct args {
 	uint64_t	r0;
@@ -55,6 +64,10 @@ struct args {
 	uint64_t	r7;
 };
 
+/*
+ * The context of each cpu starts on its own cache line, so that the FIQ and SMC
+ * paths of a cpu never touch the lines written by the other cpus.
+ */
 struct trusty_cpu_ctx trusty_cpu_ctx[PLATFORM_CORE_COUNT];
 
 struct args trusty_init_context_stack(void **sp, void *new_stack);
@@ -274,7 +287,7 @@ static int32_t trusty_init(void)
 	struct args zero_args = {0};
 	struct trusty_cpu_ctx *ctx = get_trusty_ctx();
 	uint32_t cpu = plat_my_core_pos();
-	int reg_width = GET_RW(read_ctx_reg(get_el3state_ctx(&ctx->cpu_ctx),
+	int reg_width = GET_RW(read_ctx_reg(get_el3state_ctx(ctx->cpu_ctx),
 			       CTX_SPSR_EL3));
 
 	/*
@@ -286,7 +299,7 @@ static int32_t trusty_init(void)
 
 	cm_el1_sysregs_context_save(NON_SECURE);
 
-	cm_set_context(&ctx->cpu_ctx, SECURE);
+	cm_set_context(ctx->cpu_ctx, SECURE);
 	cm_init_my_context(ep_info);
 
 	/*
@@ -374,8 +387,14 @@ static int32_t trusty_setup(void)
 {
 	entry_point_info_t *ep_info;
 	uint32_t flags;
+	unsigned int i;
 	int ret;
 
+	/* The Trusty context of a cpu sits next to its non-secure context */
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+		trusty_cpu_ctx[i].cpu_ctx =
+			cm_get_context_slot_by_index(i, SECURE);
+
 	/* Get trusty's entry point info */
 	ep_info = bl31_plat_get_next_image_ep_info(SECURE);
 	if (!ep_info) {
@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2013-2014, ARM Limited and Contributors. All rights reserved.
+# Copyright (c) 2013-2017, ARM Limited and Contributors. All rights reserved.
 #
 # SPDX-License-Identifier: BSD-3-Clause
 #
@@ -29,6 +29,10 @@ include ${BL32_ROOT}/tsp.mk
 # Let the top-level Makefile know that we intend to build the SP from source
 NEED_BL32		:=	yes
 
+# The TSP does not write the EL1 system registers that the world switches can
+# skip, see CTX_SKIP_SP_UNUSED_SYSREGS
+CTX_SKIP_SP_UNUSED_SYSREGS	:=	1
+
 # Flag used to enable routing of non-secure interrupts to EL3 when they are
 # generated while the code is executing in S-EL1/0.
 TSP_NS_INTR_ASYNC_PREEMPT	:=	0
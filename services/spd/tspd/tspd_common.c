@@ -43,7 +43,7 @@ void tspd_init_tsp_ep_state(struct entry_point_info *tsp_entry_point,
 	set_tsp_pstate(tsp_ctx->state, TSP_PSTATE_OFF);
 	clr_yield_smc_active_flag(tsp_ctx->state);
 
-	cm_set_context(&tsp_ctx->cpu_ctx, SECURE);
+	cm_set_context(tsp_ctx->cpu_ctx, SECURE);
 
 	/* initialise an entrypoint to set up the CPU context */
 	ep_attr = SECURE | EP_ST_ENABLE;
@@ -74,7 +74,7 @@ uint64_t tspd_synchronous_sp_entry(tsp_context_t *tsp_ctx)
 	assert(tsp_ctx->c_rt_ctx == 0);
 
 	/* Apply the Secure EL1 system register context and switch to it */
-	assert(cm_get_context(SECURE) == &tsp_ctx->cpu_ctx);
+	assert(cm_get_context(SECURE) == tsp_ctx->cpu_ctx);
 	cm_el1_sysregs_context_restore(SECURE);
 	cm_set_next_eret_context(SECURE);
 
@@ -99,7 +99,7 @@ void tspd_synchronous_sp_exit(tsp_context_t *tsp_ctx, uint64_t ret)
 {
 	assert(tsp_ctx != NULL);
 	/* Save the Secure EL1 system register context */
-	assert(cm_get_context(SECURE) == &tsp_ctx->cpu_ctx);
+	assert(cm_get_context(SECURE) == tsp_ctx->cpu_ctx);
 	cm_el1_sysregs_context_save(SECURE);
 
 	assert(tsp_ctx->c_rt_ctx != 0);
@@ -110,7 +110,7 @@ static uint64_t tspd_sel1_interrupt_handler(uint32_t id,
 	/* Get a reference to this cpu's TSP context */
 	linear_id = plat_my_core_pos();
 	tsp_ctx = &tspd_sp_context[linear_id];
-	assert(&tsp_ctx->cpu_ctx == cm_get_context(SECURE));
+	assert(tsp_ctx->cpu_ctx == cm_get_context(SECURE));
 
 	/*
 	 * Determine if the TSP was previously preempted. Its last known
@@ -123,13 +123,13 @@ static uint64_t tspd_sel1_interrupt_handler(uint32_t id,
 	 * interrupt handling.
 	 */
 	if (get_yield_smc_active_flag(tsp_ctx->state)) {
-		tsp_ctx->saved_spsr_el3 = SMC_GET_EL3(&tsp_ctx->cpu_ctx,
+		tsp_ctx->saved_spsr_el3 = SMC_GET_EL3(tsp_ctx->cpu_ctx,
 						      CTX_SPSR_EL3);
-		tsp_ctx->saved_elr_el3 = SMC_GET_EL3(&tsp_ctx->cpu_ctx,
+		tsp_ctx->saved_elr_el3 = SMC_GET_EL3(tsp_ctx->cpu_ctx,
 						     CTX_ELR_EL3);
 #if TSP_NS_INTR_ASYNC_PREEMPT
 		/*Need to save the previously interrupted secure context */
-		memcpy(&tsp_ctx->sp_ctx, &tsp_ctx->cpu_ctx, TSPD_SP_CTX_SIZE);
+		memcpy(&tsp_ctx->sp_ctx, tsp_ctx->cpu_ctx, TSPD_SP_CTX_SIZE);
 #endif
 	}
 
@@ -146,7 +146,7 @@ static uint64_t tspd_sel1_interrupt_handler(uint32_t id,
 	 * this address from ELR_EL3 as the secure context will not take effect
 	 * until el3_exit().
 	 */
-	SMC_RET2(&tsp_ctx->cpu_ctx, TSP_HANDLE_SEL1_INTR_AND_RETURN, read_elr_el3());
+	SMC_RET2(tsp_ctx->cpu_ctx, TSP_HANDLE_SEL1_INTR_AND_RETURN, read_elr_el3());
 }
 
 #if TSP_NS_INTR_ASYNC_PREEMPT
@@ -182,9 +182,15 @@ int32_t tspd_setup(void)
 {
 	entry_point_info_t *tsp_ep_info;
 	uint32_t linear_id;
+	unsigned int i;
 
 	linear_id = plat_my_core_pos();
 
+	/* The SP context of a cpu sits next to its non-secure context */
+	for (i = 0; i < TSPD_CORE_COUNT; i++)
+		tspd_sp_context[i].cpu_ctx =
+			cm_get_context_slot_by_index(i, SECURE);
+
 	/*
 	 * Get information about the Secure Payload (BL32) image. Its
 	 * absence is a critical failure.  TODO: Add support to
@@ -322,10 +328,10 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 		 * this SMC.
 		 */
 		if (get_yield_smc_active_flag(tsp_ctx->state)) {
-			SMC_SET_EL3(&tsp_ctx->cpu_ctx,
+			SMC_SET_EL3(tsp_ctx->cpu_ctx,
 				    CTX_SPSR_EL3,
 				    tsp_ctx->saved_spsr_el3);
-			SMC_SET_EL3(&tsp_ctx->cpu_ctx,
+			SMC_SET_EL3(tsp_ctx->cpu_ctx,
 				    CTX_ELR_EL3,
 				    tsp_ctx->saved_elr_el3);
 #if TSP_NS_INTR_ASYNC_PREEMPT
@@ -333,7 +339,7 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 			 * Need to restore the previously interrupted
 			 * secure context.
 			 */
-			memcpy(&tsp_ctx->cpu_ctx, &tsp_ctx->sp_ctx,
+			memcpy(tsp_ctx->cpu_ctx, &tsp_ctx->sp_ctx,
 				TSPD_SP_CTX_SIZE);
 #endif
 		}
@@ -414,7 +420,7 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 
 #if TSP_INIT_ASYNC
 		/* Save the Secure EL1 system register context */
-		assert(cm_get_context(SECURE) == &tsp_ctx->cpu_ctx);
+		assert(cm_get_context(SECURE) == tsp_ctx->cpu_ctx);
 		cm_el1_sysregs_context_save(SECURE);
 
 		/* Program EL3 registers to enable entry into the next EL */
@@ -484,11 +490,17 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 	case TSP_FAST_FID(TSP_SUB):
 	case TSP_FAST_FID(TSP_MUL):
 	case TSP_FAST_FID(TSP_DIV):
+	case TSP_FAST_FID(TSP_NOP):
+#if TSP_RING_BUFFER
+	case TSP_FAST_FID(TSP_RING_SETUP):
+	case TSP_FAST_FID(TSP_RING_DRAIN):
+#endif
 
 	case TSP_YIELD_FID(TSP_ADD):
 	case TSP_YIELD_FID(TSP_SUB):
 	case TSP_YIELD_FID(TSP_MUL):
 	case TSP_YIELD_FID(TSP_DIV):
+	case TSP_YIELD_FID(TSP_NOP):
 		if (ns) {
 			/*
 			 * This is a fresh request from the non-secure client.
@@ -519,7 +531,7 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 			 * payload. Entry into S-EL1 will take place upon exit
 			 * from this function.
 			 */
-			assert(&tsp_ctx->cpu_ctx == cm_get_context(SECURE));
+			assert(tsp_ctx->cpu_ctx == cm_get_context(SECURE));
 
 			/* Set appropriate entry for SMC.
 			 * We expect the TSP to manage the PSTATE.I and PSTATE.F
@@ -544,7 +556,7 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 
 			cm_el1_sysregs_context_restore(SECURE);
 			cm_set_next_eret_context(SECURE);
-			SMC_RET3(&tsp_ctx->cpu_ctx, smc_fid, x1, x2);
+			SMC_RET3(tsp_ctx->cpu_ctx, smc_fid, x1, x2);
 		} else {
 			/*
 			 * This is the result from the secure client of an
@@ -653,7 +665,7 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 		 */
 		cm_el1_sysregs_context_restore(SECURE);
 		cm_set_next_eret_context(SECURE);
-		SMC_RET0(&tsp_ctx->cpu_ctx);
+		SMC_RET0(tsp_ctx->cpu_ctx);
 
 		/*
 		 * This is a request from the secure payload for more arguments
@@ -155,7 +155,7 @@ static void tspd_cpu_suspend_finish_handler(uint64_t max_off_pwrlvl)
 	assert(get_tsp_pstate(tsp_ctx->state) == TSP_PSTATE_SUSPEND);
 
 	/* Program the entry point, max_off_pwrlvl and enter the SP */
-	write_ctx_reg(get_gpregs_ctx(&tsp_ctx->cpu_ctx),
+	write_ctx_reg(get_gpregs_ctx(tsp_ctx->cpu_ctx),
 		      CTX_GPREG_X0,
 		      max_off_pwrlvl);
 	cm_set_elr_el3(SECURE, (uint64_t) &tsp_vectors->cpu_resume_entry);
@@ -168,7 +168,7 @@ CASSERT(TSPD_SP_CTX_SIZE == sizeof(sp_ctx_regs_t),	\
  * 'mpidr'          - mpidr to associate a context with a cpu
  * 'c_rt_ctx'       - stack address to restore C runtime context from after
  *                    returning from a synchronous entry into the SP.
- * 'cpu_ctx'        - space to maintain SP architectural state
+ * 'cpu_ctx'        - SP architectural state, in the context slot of the cpu
  * 'saved_tsp_args' - space to store arguments for TSP arithmetic operations
  *                    which will queried using the TSP_GET_ARGS SMC by TSP.
  * 'sp_ctx'         - space to save the SEL1 Secure Payload(SP) caller saved
@@ -182,7 +182,7 @@ typedef struct tsp_context {
 	uint32_t state;
 	uint64_t mpidr;
 	uint64_t c_rt_ctx;
-	cpu_context_t cpu_ctx;
+	cpu_context_t *cpu_ctx;
 	uint64_t saved_tsp_args[TSP_NUM_ARGS];
 #if TSP_NS_INTR_ASYNC_PREEMPT
 	sp_ctx_regs_t sp_ctx;
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Dispatch of the SDEI events to their handlers in the normal world, and
+ * return to the interrupted context when a handler completes.
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <assert.h>
+#include <context.h>
+#include <context_mgmt.h>
+#include <debug.h>
+#include <ehf.h>
+#include <interrupt_mgmt.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <spinlock.h>
+#include "sdei_private.h"
+
+static sdei_cpu_state_t sdei_cpu_state[PLATFORM_CORE_COUNT];
+
+sdei_cpu_state_t *sdei_get_cpu_state(void)
+{
+	return &sdei_cpu_state[plat_my_core_pos()];
+}
+
+/* PSTATE of the client when it enters a handler or resumes from it */
+static uint32_t sdei_client_spsr(const sdei_entry_t *entry)
+{
+	return SPSR_64(entry->client_el, MODE_SP_ELX, DISABLE_ALL_EXCEPTIONS);
+}
+
+/*******************************************************************************
+ * Return 1 if the event of 'map' and 'entry' can be dispatched on the calling
+ * PE, which runs the non-secure context 'ns_ctx', 0 otherwise. The event must
+ * be registered and enabled and not already running, and the PE unmasked. A
+ * critical event can preempt the handler of a normal event. The interrupted
+ * EL must not be higher than the one of the client.
+ ******************************************************************************/
+static int sdei_can_dispatch(const sdei_cpu_state_t *cpu,
+			     const sdei_ev_map_t *map,
+			     const sdei_entry_t *entry,
+			     void *ns_ctx)
+{
+	uint32_t spsr = read_ctx_reg(get_el3state_ctx(ns_ctx), CTX_SPSR_EL3);
+
+	if (!cpu->pe_unmasked)
+		return 0;
+
+	if ((entry->state & (SDEI_STATE_REGISTERED | SDEI_STATE_ENABLED |
+			     SDEI_STATE_RUNNING |
+			     SDEI_STATE_UNREGISTER_PENDING)) !=
+	    (SDEI_STATE_REGISTERED | SDEI_STATE_ENABLED))
+		return 0;
+
+	if ((cpu->num_dispatch != 0) &&
+	    (!sdei_is_critical(map) ||
+	     sdei_is_critical(cpu->dispatch[cpu->num_dispatch - 1].map)))
+		return 0;
+
+	/* An AArch32 state is always below the EL of an AArch64 client */
+	if ((GET_RW(spsr) == MODE_RW_64) && (GET_EL(spsr) > entry->client_el))
+		return 0;
+
+	return 1;
+}
+
+/*******************************************************************************
+ * Handler of the priority levels of the SDEI events. The interrupt is left
+ * active and its priority level activated until the handler of the event
+ * completes, so that only a critical event can preempt a normal one. The
+ * non-secure context resumes in the handler, with the event number, its
+ * argument and the interrupted PC and PSTATE in x0 to x3.
+ *
+ * The events that trigger while they cannot be dispatched, including while the
+ * secure world runs, are reported to plat_sdei_handle_masked_trigger() and
+ * dropped.
+ ******************************************************************************/
+int sdei_intr_handler(uint32_t intr_raw, uint32_t flags, void *handle,
+		      void *cookie)
+{
+	sdei_cpu_state_t *cpu = sdei_get_cpu_state();
+	sdei_dispatch_context_t *disp;
+	const sdei_ev_map_t *map;
+	sdei_entry_t *entry;
+	gp_regs_t *gpregs;
+	el3_state_t *state;
+	unsigned int i;
+	int idx, ok;
+
+	idx = sdei_find_intr(intr_raw, &map, &entry);
+	if (idx < 0) {
+		ERROR("SDEI: No event bound to interrupt %u\n", intr_raw);
+		panic();
+	}
+
+	if (idx == SDEI_MAP_IDX_SHRD)
+		spin_lock(&sdei_shared_lock);
+
+	ok = (get_interrupt_src_ss(flags) == NON_SECURE) &&
+	     sdei_can_dispatch(cpu, map, entry, handle);
+	if (ok)
+		entry->state |= SDEI_STATE_RUNNING;
+
+	if (idx == SDEI_MAP_IDX_SHRD)
+		spin_unlock(&sdei_shared_lock);
+
+	if (!ok) {
+		plat_sdei_handle_masked_trigger(read_mpidr_el1(), intr_raw);
+		plat_ic_end_of_interrupt(intr_raw);
+		return 0;
+	}
+
+	assert(handle == cm_get_context(NON_SECURE));
+	assert(cpu->num_dispatch < SDEI_MAX_DISPATCH);
+
+	/* Save the part of the interrupted context the handler overwrites */
+	disp = &cpu->dispatch[cpu->num_dispatch++];
+	disp->map = map;
+	disp->entry = entry;
+	disp->map_idx = idx;
+	disp->intr_raw = intr_raw;
+
+	gpregs = get_gpregs_ctx(handle);
+	for (i = 0; i < SDEI_SAVED_GPREGS; i++)
+		disp->x[i] = read_ctx_reg(gpregs,
+					  (CTX_GPREG_X0 + (i << DWORD_SHIFT)));
+
+	state = get_el3state_ctx(handle);
+	disp->elr_el3 = read_ctx_reg(state, CTX_ELR_EL3);
+	disp->spsr_el3 = read_ctx_reg(state, CTX_SPSR_EL3);
+
+	ehf_activate_priority(sdei_map_pri(map));
+
+	/* Enter the handler of the client */
+	write_ctx_reg(gpregs, CTX_GPREG_X0, (u_register_t)map->ev_num);
+	write_ctx_reg(gpregs, CTX_GPREG_X1, entry->arg);
+	write_ctx_reg(gpregs, CTX_GPREG_X2, disp->elr_el3);
+	write_ctx_reg(gpregs, CTX_GPREG_X3, disp->spsr_el3);
+	cm_set_elr_spsr_el3(NON_SECURE, entry->ep, sdei_client_spsr(entry));
+
+	return 0;
+}
+
+/*******************************************************************************
+ * Complete the handler of the event dispatched last on the calling PE, from the
+ * call of the handler in the non-secure context 'handle'. The interrupted
+ * context is restored, or with 'resume' the client resumes at 'pc' as if it
+ * had taken an IRQ exception where the event interrupted it.
+ ******************************************************************************/
+int sdei_event_complete(void *handle, int resume, uintptr_t pc)
+{
+	sdei_cpu_state_t *cpu = sdei_get_cpu_state();
+	sdei_dispatch_context_t *disp;
+	sdei_entry_t *entry;
+	gp_regs_t *gpregs;
+	unsigned int i;
+	int shared;
+
+	if (cpu->num_dispatch == 0)
+		return SDEI_EDENY;
+
+	disp = &cpu->dispatch[cpu->num_dispatch - 1];
+	entry = disp->entry;
+
+	gpregs = get_gpregs_ctx(handle);
+	for (i = 0; i < SDEI_SAVED_GPREGS; i++)
+		write_ctx_reg(gpregs, (CTX_GPREG_X0 + (i << DWORD_SHIFT)),
+			      disp->x[i]);
+
+	if (resume) {
+		if (entry->client_el == MODE_EL2) {
+			write_elr_el2(disp->elr_el3);
+			write_spsr_el2(disp->spsr_el3);
+		} else {
+			write_elr_el1(disp->elr_el3);
+			write_spsr_el1(disp->spsr_el3);
+		}
+		cm_set_elr_spsr_el3(NON_SECURE, pc, sdei_client_spsr(entry));
+	} else {
+		cm_set_elr_spsr_el3(NON_SECURE, disp->elr_el3,
+				    disp->spsr_el3);
+	}
+
+	shared = (disp->map_idx == SDEI_MAP_IDX_SHRD);
+	if (shared)
+		spin_lock(&sdei_shared_lock);
+
+	if (entry->state & SDEI_STATE_UNREGISTER_PENDING)
+		entry->state = 0;
+	else
+		entry->state &= ~SDEI_STATE_RUNNING;
+
+	if (shared)
+		spin_unlock(&sdei_shared_lock);
+
+	plat_ic_end_of_interrupt(disp->intr_raw);
+	ehf_deactivate_priority(sdei_map_pri(disp->map));
+	cpu->num_dispatch--;
+
+	return SDEI_SUCCESS;
+}
+
+/*******************************************************************************
+ * Return in 'value' the register x<param> of the context interrupted by the
+ * event dispatched last on the calling PE.
+ ******************************************************************************/
+int sdei_event_context(unsigned int param, u_register_t *value)
+{
+	sdei_cpu_state_t *cpu = sdei_get_cpu_state();
+
+	if (cpu->num_dispatch == 0)
+		return SDEI_EDENY;
+
+	if (param >= SDEI_SAVED_GPREGS)
+		return SDEI_EINVAL;
+
+	*value = cpu->dispatch[cpu->num_dispatch - 1].x[param];
+	return SDEI_SUCCESS;
+}
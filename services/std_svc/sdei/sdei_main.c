@@ -0,0 +1,463 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Software Delegated Exception Interface: the events that the platform binds
+ * to EL3 interrupts are registered by the normal world and dispatched to its
+ * handlers at EL3 priority, whatever the interrupt masks of the normal world.
+ *
+ * This implements SDEI 1.0 with the events declared by the platform only, so
+ * SDEI_INTERRUPT_BIND has no slot to bind an interrupt to. The shared events
+ * are routed as the platform configures their SPI, with SDEI_REGF_RM_ANY.
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <assert.h>
+#include <context.h>
+#include <debug.h>
+#include <ehf.h>
+#include <gic_common.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <runtime_svc.h>
+#include <smcc_helpers.h>
+#include <spinlock.h>
+#include <string.h>
+#include "sdei_private.h"
+
+#pragma weak plat_sdei_handle_masked_trigger
+
+spinlock_t sdei_shared_lock;
+
+#define priv_mapping	(sdei_global_mappings[SDEI_MAP_IDX_PRIV])
+#define shrd_mapping	(sdei_global_mappings[SDEI_MAP_IDX_SHRD])
+
+/* Default handler of the events that cannot be dispatched: drop them */
+void plat_sdei_handle_masked_trigger(uint64_t mpidr, unsigned int intr)
+{
+	VERBOSE("SDEI: Dropped interrupt %u on 0x%llx\n", intr,
+		(unsigned long long)mpidr);
+}
+
+/*
+ * Return the entry of the event 'pos' of 'idx', of the calling PE for the
+ * private events.
+ */
+static sdei_entry_t *sdei_get_entry(int idx, unsigned int pos)
+{
+	const sdei_mapping_t *mapping = &sdei_global_mappings[idx];
+
+	if (idx == SDEI_MAP_IDX_PRIV)
+		return &mapping->entries[(plat_my_core_pos() *
+					  mapping->num_maps) + pos];
+
+	return &mapping->entries[pos];
+}
+
+/*******************************************************************************
+ * Find the event numbered 'ev_num', or bound to the interrupt 'intr', and
+ * return in 'map' and 'entry' its declaration and state. Return the index of
+ * its table, SDEI_MAP_IDX_PRIV or SDEI_MAP_IDX_SHRD, or -1 if not found.
+ ******************************************************************************/
+static int sdei_find(int by_intr, unsigned int key, const sdei_ev_map_t **map,
+		     sdei_entry_t **entry)
+{
+	const sdei_mapping_t *mapping;
+	unsigned int i;
+	int idx;
+
+	for (idx = 0; idx < SDEI_MAP_IDX_MAX; idx++) {
+		mapping = &sdei_global_mappings[idx];
+		for (i = 0; i < mapping->num_maps; i++) {
+			if ((by_intr ? mapping->map[i].intr :
+			     (unsigned int)mapping->map[i].ev_num) != key)
+				continue;
+
+			*map = &mapping->map[i];
+			*entry = sdei_get_entry(idx, i);
+			return idx;
+		}
+	}
+
+	return -1;
+}
+
+int sdei_find_event(int32_t ev_num, const sdei_ev_map_t **map,
+		    sdei_entry_t **entry)
+{
+	return sdei_find(0, (unsigned int)ev_num, map, entry);
+}
+
+int sdei_find_intr(unsigned int intr, const sdei_ev_map_t **map,
+		   sdei_entry_t **entry)
+{
+	return sdei_find(1, intr, map, entry);
+}
+
+static void sdei_lock(int idx)
+{
+	if (idx == SDEI_MAP_IDX_SHRD)
+		spin_lock(&sdei_shared_lock);
+}
+
+static void sdei_unlock(int idx)
+{
+	if (idx == SDEI_MAP_IDX_SHRD)
+		spin_unlock(&sdei_shared_lock);
+}
+
+static int64_t sdei_event_register(int32_t ev_num, uintptr_t ep,
+				   u_register_t arg, u_register_t flags,
+				   void *handle)
+{
+	uint32_t spsr = read_ctx_reg(get_el3state_ctx(handle), CTX_SPSR_EL3);
+	const sdei_ev_map_t *map;
+	sdei_entry_t *entry;
+	int64_t ret = SDEI_SUCCESS;
+	int idx;
+
+	idx = sdei_find_event(ev_num, &map, &entry);
+	if ((idx < 0) || (ep == 0))
+		return SDEI_EINVAL;
+
+	/* The handlers run at the EL of the client, which must be AArch64 */
+	if ((GET_RW(spsr) != MODE_RW_64) ||
+	    ((GET_EL(spsr) != MODE_EL1) && (GET_EL(spsr) != MODE_EL2)))
+		return SDEI_EDENY;
+
+	if ((idx == SDEI_MAP_IDX_SHRD) && (flags != SDEI_REGF_RM_ANY))
+		return SDEI_EINVAL;
+
+	sdei_lock(idx);
+	if (entry->state & SDEI_STATE_REGISTERED) {
+		ret = SDEI_EDENY;
+	} else {
+		entry->ep = ep;
+		entry->arg = arg;
+		entry->client_el = GET_EL(spsr);
+		entry->state = SDEI_STATE_REGISTERED;
+	}
+	sdei_unlock(idx);
+
+	return ret;
+}
+
+static int64_t sdei_event_enable(int32_t ev_num, int enable)
+{
+	const sdei_ev_map_t *map;
+	sdei_entry_t *entry;
+	int64_t ret = SDEI_SUCCESS;
+	int idx;
+
+	idx = sdei_find_event(ev_num, &map, &entry);
+	if (idx < 0)
+		return SDEI_EINVAL;
+
+	sdei_lock(idx);
+	if ((entry->state & (SDEI_STATE_REGISTERED |
+			     SDEI_STATE_UNREGISTER_PENDING)) !=
+	    SDEI_STATE_REGISTERED)
+		ret = SDEI_EDENY;
+	else if (enable)
+		entry->state |= SDEI_STATE_ENABLED;
+	else
+		entry->state &= ~SDEI_STATE_ENABLED;
+	sdei_unlock(idx);
+
+	return ret;
+}
+
+static int64_t sdei_event_unregister(int32_t ev_num)
+{
+	const sdei_ev_map_t *map;
+	sdei_entry_t *entry;
+	int64_t ret = SDEI_SUCCESS;
+	int idx;
+
+	idx = sdei_find_event(ev_num, &map, &entry);
+	if (idx < 0)
+		return SDEI_EINVAL;
+
+	sdei_lock(idx);
+	if (!(entry->state & SDEI_STATE_REGISTERED)) {
+		ret = SDEI_EDENY;
+	} else if (entry->state & SDEI_STATE_RUNNING) {
+		/* Completed when the handler completes */
+		entry->state |= SDEI_STATE_UNREGISTER_PENDING;
+		ret = SDEI_EPEND;
+	} else {
+		entry->state = 0;
+	}
+	sdei_unlock(idx);
+
+	return ret;
+}
+
+static int64_t sdei_event_status(int32_t ev_num)
+{
+	const sdei_ev_map_t *map;
+	sdei_entry_t *entry;
+	int idx;
+
+	idx = sdei_find_event(ev_num, &map, &entry);
+	if (idx < 0)
+		return SDEI_EINVAL;
+
+	return entry->state & SDEI_STATE_STATUS_MASK;
+}
+
+static int64_t sdei_event_get_info(int32_t ev_num, unsigned int info)
+{
+	const sdei_ev_map_t *map;
+	sdei_entry_t *entry;
+	int idx;
+
+	idx = sdei_find_event(ev_num, &map, &entry);
+	if (idx < 0)
+		return SDEI_EINVAL;
+
+	switch (info) {
+	case SDEI_INFO_EV_TYPE:
+		return idx == SDEI_MAP_IDX_PRIV;
+
+	case SDEI_INFO_EV_SIGNALED:
+		return (map->map_flags & SDEI_MAPF_SIGNALABLE) != 0;
+
+	case SDEI_INFO_EV_PRIORITY:
+		return sdei_is_critical(map);
+
+	case SDEI_INFO_EV_ROUTING_MODE:
+		if (idx == SDEI_MAP_IDX_PRIV)
+			return SDEI_EINVAL;
+		if (!(entry->state & SDEI_STATE_REGISTERED))
+			return SDEI_EDENY;
+		return SDEI_REGF_RM_ANY;
+
+	default:
+		/* No affinity is used with SDEI_REGF_RM_ANY */
+		return SDEI_EINVAL;
+	}
+}
+
+static int64_t sdei_event_routing_set(int32_t ev_num, u_register_t flags)
+{
+	const sdei_ev_map_t *map;
+	sdei_entry_t *entry;
+	int64_t ret = SDEI_SUCCESS;
+	int idx;
+
+	idx = sdei_find_event(ev_num, &map, &entry);
+	if ((idx != SDEI_MAP_IDX_SHRD) || (flags != SDEI_REGF_RM_ANY))
+		return SDEI_EINVAL;
+
+	sdei_lock(idx);
+	if ((entry->state & (SDEI_STATE_REGISTERED | SDEI_STATE_ENABLED |
+			     SDEI_STATE_RUNNING)) != SDEI_STATE_REGISTERED)
+		ret = SDEI_EDENY;
+	sdei_unlock(idx);
+
+	return ret;
+}
+
+/* Return 1 if this call masked the calling PE, 0 if it was already masked */
+static int64_t sdei_pe_mask(int mask)
+{
+	sdei_cpu_state_t *cpu = sdei_get_cpu_state();
+	int64_t ret = cpu->pe_unmasked && mask;
+
+	cpu->pe_unmasked = !mask;
+
+	return ret;
+}
+
+static int64_t sdei_event_signal(int32_t ev_num, u_register_t target_pe)
+{
+	const sdei_ev_map_t *map;
+	sdei_entry_t *entry;
+
+	if ((ev_num != SDEI_EVENT_0_NUM) ||
+	    (sdei_find_event(ev_num, &map, &entry) != SDEI_MAP_IDX_PRIV) ||
+	    (plat_core_pos_by_mpidr(target_pe) < 0))
+		return SDEI_EINVAL;
+
+	plat_ic_raise_el3_sgi(map->intr, target_pe,
+			      1 << MPIDR_AFFLVL0_VAL(target_pe));
+
+	return SDEI_SUCCESS;
+}
+
+/*
+ * Unregister all the events of 'idx', which fails if the handler of one of
+ * them runs.
+ */
+static int64_t sdei_reset(int idx)
+{
+	const sdei_mapping_t *mapping = &sdei_global_mappings[idx];
+	int64_t ret = SDEI_SUCCESS;
+	unsigned int i;
+
+	sdei_lock(idx);
+	for (i = 0; i < mapping->num_maps; i++) {
+		if (sdei_get_entry(idx, i)->state & SDEI_STATE_RUNNING)
+			ret = SDEI_EDENY;
+	}
+
+	if (ret == SDEI_SUCCESS) {
+		for (i = 0; i < mapping->num_maps; i++)
+			memset(sdei_get_entry(idx, i), 0,
+			       sizeof(sdei_entry_t));
+	}
+	sdei_unlock(idx);
+
+	return ret;
+}
+
+/*******************************************************************************
+ * Handler of the SDEI calls, which are only available to the normal world.
+ ******************************************************************************/
+uint64_t sdei_smc_handler(uint32_t smc_fid,
+			  uint64_t x1,
+			  uint64_t x2,
+			  uint64_t x3,
+			  uint64_t x4,
+			  void *cookie,
+			  void *handle,
+			  uint64_t flags)
+{
+	u_register_t value;
+	int ret;
+
+	if (!is_caller_non_secure(flags))
+		SMC_RET1(handle, SMC_UNK);
+
+	switch (smc_fid) {
+	case SDEI_VERSION:
+		SMC_RET1(handle, MAKE_SDEI_VERSION(SDEI_VERSION_MAJOR,
+						   SDEI_VERSION_MINOR));
+
+	case SDEI_EVENT_REGISTER:
+		/* x5 holds the affinity, unused with SDEI_REGF_RM_ANY */
+		SMC_RET1(handle, sdei_event_register((int32_t)x1, x2, x3, x4,
+						     handle));
+
+	case SDEI_EVENT_ENABLE:
+		SMC_RET1(handle, sdei_event_enable((int32_t)x1, 1));
+
+	case SDEI_EVENT_DISABLE:
+		SMC_RET1(handle, sdei_event_enable((int32_t)x1, 0));
+
+	case SDEI_EVENT_CONTEXT:
+		ret = sdei_event_context((unsigned int)x1, &value);
+		SMC_RET1(handle, (ret == SDEI_SUCCESS) ? value : (int64_t)ret);
+
+	case SDEI_EVENT_COMPLETE:
+	case SDEI_EVENT_COMPLETE_AND_RESUME:
+		ret = sdei_event_complete(handle,
+				smc_fid == SDEI_EVENT_COMPLETE_AND_RESUME, x1);
+		if (ret != SDEI_SUCCESS)
+			SMC_RET1(handle, (int64_t)ret);
+
+		/* Return to the restored context, keeping its registers */
+		SMC_RET0(handle);
+
+	case SDEI_EVENT_UNREGISTER:
+		SMC_RET1(handle, sdei_event_unregister((int32_t)x1));
+
+	case SDEI_EVENT_STATUS:
+		SMC_RET1(handle, sdei_event_status((int32_t)x1));
+
+	case SDEI_EVENT_GET_INFO:
+		SMC_RET1(handle, sdei_event_get_info((int32_t)x1,
+						     (unsigned int)x2));
+
+	case SDEI_EVENT_ROUTING_SET:
+		SMC_RET1(handle, sdei_event_routing_set((int32_t)x1, x2));
+
+	case SDEI_PE_MASK:
+		SMC_RET1(handle, sdei_pe_mask(1));
+
+	case SDEI_PE_UNMASK:
+		SMC_RET1(handle, sdei_pe_mask(0));
+
+	case SDEI_INTERRUPT_BIND:
+		SMC_RET1(handle, SDEI_ENOMEM);
+
+	case SDEI_INTERRUPT_RELEASE:
+		SMC_RET1(handle, SDEI_EINVAL);
+
+	case SDEI_EVENT_SIGNAL:
+		SMC_RET1(handle, sdei_event_signal((int32_t)x1, x2));
+
+	case SDEI_FEATURES:
+		SMC_RET1(handle, (x1 == SDEI_FEATURE_BIND_SLOTS) ?
+				 0 : SDEI_EINVAL);
+
+	case SDEI_PRIVATE_RESET:
+		SMC_RET1(handle, sdei_reset(SDEI_MAP_IDX_PRIV));
+
+	case SDEI_SHARED_RESET:
+		SMC_RET1(handle, sdei_reset(SDEI_MAP_IDX_SHRD));
+
+	default:
+		break;
+	}
+
+	WARN("Unimplemented SDEI Call: 0x%x\n", smc_fid);
+	SMC_RET1(handle, SMC_UNK);
+}
+
+/*******************************************************************************
+ * Check the events declared by the platform and register the handler of their
+ * priority levels. The event 0 must be the first private event, and the only
+ * one signalled by software. The private events must be bound to SGIs or PPIs,
+ * and the shared events to SPIs.
+ ******************************************************************************/
+static void sdei_check_mapping(int idx)
+{
+	const sdei_mapping_t *mapping = &sdei_global_mappings[idx];
+	const sdei_ev_map_t *map, *other;
+	sdei_entry_t *entry;
+	unsigned int i;
+
+	for (i = 0; i < mapping->num_maps; i++) {
+		map = &mapping->map[i];
+
+		if ((idx == SDEI_MAP_IDX_PRIV) != (map->intr < MIN_SPI_ID) ||
+		    ((map->ev_num == SDEI_EVENT_0_NUM) !=
+		     ((map->map_flags & SDEI_MAPF_SIGNALABLE) != 0)) ||
+		    (sdei_find_event(map->ev_num, &other, &entry) != idx) ||
+		    (other != map) ||
+		    (sdei_find_intr(map->intr, &other, &entry) != idx) ||
+		    (other != map)) {
+			ERROR("SDEI: Invalid event %d\n", map->ev_num);
+			panic();
+		}
+	}
+}
+
+void sdei_init(void)
+{
+	if ((priv_mapping.num_maps == 0) ||
+	    (priv_mapping.map[0].ev_num != SDEI_EVENT_0_NUM)) {
+		ERROR("SDEI: The event 0 must be the first private event\n");
+		panic();
+	}
+
+	sdei_check_mapping(SDEI_MAP_IDX_PRIV);
+	sdei_check_mapping(SDEI_MAP_IDX_SHRD);
+
+	if ((ehf_register_priority_handler(PLAT_SDEI_NORMAL_PRI,
+					   sdei_intr_handler) != 0) ||
+	    (ehf_register_priority_handler(PLAT_SDEI_CRITICAL_PRI,
+					   sdei_intr_handler) != 0)) {
+		ERROR("SDEI: Failed to register the event handlers\n");
+		panic();
+	}
+
+	INFO("SDEI: %u private and %u shared events\n", priv_mapping.num_maps,
+	     shrd_mapping.num_maps);
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __SDEI_PRIVATE_H__
+#define __SDEI_PRIVATE_H__
+
+#include <sdei.h>
+#include <spinlock.h>
+#include <types.h>
+
+/*
+ * State of an event. The first bits are the ones SDEI_EVENT_STATUS reports,
+ * and SDEI_STATE_UNREGISTER_PENDING is set when the event is unregistered
+ * while its handler runs.
+ */
+#define SDEI_STATE_REGISTERED		SDEI_STATF_REGISTERED
+#define SDEI_STATE_ENABLED		SDEI_STATF_ENABLED
+#define SDEI_STATE_RUNNING		SDEI_STATF_RUNNING
+#define SDEI_STATE_UNREGISTER_PENDING	(1 << 3)
+#define SDEI_STATE_STATUS_MASK		(SDEI_STATF_REGISTERED |	\
+					 SDEI_STATF_ENABLED |		\
+					 SDEI_STATF_RUNNING)
+
+/* A normal event and a critical event can be dispatched at once on a PE */
+#define SDEI_MAX_DISPATCH		2
+
+/*
+ * Dispatch of an event on a PE, with the part of the interrupted context that
+ * the handler entry overwrites.
+ */
+typedef struct sdei_dispatch_context {
+	const sdei_ev_map_t *map;
+	sdei_entry_t *entry;
+	int map_idx;
+	unsigned int intr_raw;
+	u_register_t x[SDEI_SAVED_GPREGS];
+	uint64_t elr_el3;
+	uint64_t spsr_el3;
+} sdei_dispatch_context_t;
+
+typedef struct sdei_cpu_state {
+	unsigned int pe_unmasked;
+	unsigned int num_dispatch;
+	sdei_dispatch_context_t dispatch[SDEI_MAX_DISPATCH];
+} sdei_cpu_state_t;
+
+/* Lock of the state of the shared events */
+extern spinlock_t sdei_shared_lock;
+
+#define sdei_is_critical(_map)	(((_map)->map_flags & SDEI_MAPF_CRITICAL) != 0)
+#define sdei_map_pri(_map)	(sdei_is_critical(_map) ?		\
+				 PLAT_SDEI_CRITICAL_PRI : PLAT_SDEI_NORMAL_PRI)
+
+sdei_cpu_state_t *sdei_get_cpu_state(void);
+int sdei_find_event(int32_t ev_num, const sdei_ev_map_t **map,
+		    sdei_entry_t **entry);
+int sdei_find_intr(unsigned int intr, const sdei_ev_map_t **map,
+		   sdei_entry_t **entry);
+int sdei_intr_handler(uint32_t intr_raw, uint32_t flags, void *handle,
+		      void *cookie);
+int sdei_event_complete(void *handle, int resume, uintptr_t pc);
+int sdei_event_context(unsigned int param, u_register_t *value);
+
+#endif /* __SDEI_PRIVATE_H__ */
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Secure Partition Manager: runs the S-EL0 partitions declared by the platform
+ * on behalf of the normal world. A call runs to completion in the context of
+ * the partition for the calling CPU, so the CPUs run partitions concurrently
+ * and independently of each other.
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <assert.h>
+#include <bl_common.h>
+#include <context.h>
+#include <context_mgmt.h>
+#include <debug.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <runtime_svc.h>
+#include <smcc_helpers.h>
+#include <string.h>
+#include <utils.h>
+#include "spm_private.h"
+
+static spm_cpu_state_t spm_cpu_state[PLATFORM_CORE_COUNT];
+
+/* PSTATE of a partition when it is entered */
+#define SPM_PARTITION_SPSR	SPSR_64(MODE_EL0, MODE_SP_EL0,		\
+					DISABLE_ALL_EXCEPTIONS)
+
+static cpu_context_t *spm_get_partition_ctx(unsigned int id, unsigned int pos)
+{
+	return &spm_partitions.cpu_ctx[(pos * spm_partitions.num) + id];
+}
+
+/*******************************************************************************
+ * Initialise the context of the partition 'id' for the calling CPU, which is
+ * the current secure context. The S-EL1 system registers set up the
+ * translation regime of the partition and the shim of exception vectors, and
+ * trap the FP/SIMD accesses, as the FP/SIMD registers of the normal world are
+ * not saved.
+ ******************************************************************************/
+static void spm_init_partition_ctx(const spm_partition_desc_t *desc,
+				   unsigned int pos)
+{
+	entry_point_info_t ep;
+	el1_sys_regs_t *sysregs;
+	uint64_t sctlr_el1;
+	uint32_t ep_attr;
+
+	ep_attr = SECURE | EP_ST_ENABLE;
+	if (read_sctlr_el3() & SCTLR_EE_BIT)
+		ep_attr |= EP_EE_BIG;
+	SET_PARAM_HEAD(&ep, PARAM_EP, VERSION_1, ep_attr);
+	ep.pc = desc->entrypoint;
+	ep.spsr = SPM_PARTITION_SPSR;
+	zeromem(&ep.args, sizeof(ep.args));
+
+	cm_init_my_context(&ep);
+
+	sysregs = get_sysregs_ctx(cm_get_context(SECURE));
+	sctlr_el1 = read_ctx_reg(sysregs, CTX_SCTLR_EL1);
+	if (desc->ttbr0_el1 != 0) {
+		sctlr_el1 |= SCTLR_M_BIT | SCTLR_C_BIT | SCTLR_I_BIT;
+		write_ctx_reg(sysregs, CTX_TTBR0_EL1, desc->ttbr0_el1);
+		write_ctx_reg(sysregs, CTX_TCR_EL1, desc->tcr_el1);
+		write_ctx_reg(sysregs, CTX_MAIR_EL1, desc->mair_el1);
+	}
+	write_ctx_reg(sysregs, CTX_SCTLR_EL1, sctlr_el1);
+	write_ctx_reg(sysregs, CTX_CPACR_EL1, 0);
+	write_ctx_reg(sysregs, CTX_VBAR_EL1,
+		      (uint64_t)&spm_shim_exceptions_ptr);
+
+	/* Let the partition find the position of the CPU it runs on */
+	write_ctx_reg(sysregs, CTX_TPIDRRO_EL0, pos);
+}
+
+/*******************************************************************************
+ * Run the partition 'id' on the calling CPU with the arguments of the call in
+ * the non-secure context 'ns_ctx', and return the results to this context.
+ * The partition starts at its entry point with the arguments in x0 to x5 and
+ * returns its results in x1 to x4 with SPM_PARTITION_RETURN.
+ ******************************************************************************/
+static uint64_t spm_partition_call(unsigned int id, void *ns_ctx)
+{
+	unsigned int pos = plat_my_core_pos();
+	spm_cpu_state_t *cpu = &spm_cpu_state[pos];
+	const spm_partition_desc_t *desc = &spm_partitions.desc[id];
+	cpu_context_t *ctx = spm_get_partition_ctx(id, pos);
+	gp_regs_t *ns_gpregs = get_gpregs_ctx(ns_ctx);
+	gp_regs_t *gpregs;
+	u_register_t res[SPM_PARTITION_RESULTS];
+	unsigned int i;
+	uint64_t rc;
+
+	assert(cpu->c_rt_ctx == 0);
+
+	cm_el1_sysregs_context_save(NON_SECURE);
+	cm_set_context(ctx, SECURE);
+
+	if ((cpu->ctx_valid & (1U << id)) == 0) {
+		spm_init_partition_ctx(desc, pos);
+		cpu->ctx_valid |= 1U << id;
+	}
+
+	/* Each call starts afresh at the entry point, on an empty stack */
+	gpregs = get_gpregs_ctx(ctx);
+	zeromem(gpregs, sizeof(*gpregs));
+	for (i = 0; i < SPM_PARTITION_ARGS; i++)
+		write_ctx_reg(gpregs, (CTX_GPREG_X0 + (i << DWORD_SHIFT)),
+			      read_ctx_reg(ns_gpregs,
+					   (CTX_GPREG_X2 + (i << DWORD_SHIFT))));
+	write_ctx_reg(gpregs, CTX_GPREG_SP_EL0,
+		      desc->stack_base + ((pos + 1) * desc->stack_size));
+	cm_set_elr_spsr_el3(SECURE, desc->entrypoint, SPM_PARTITION_SPSR);
+
+	/* The partitions share the ASIDs of the secure EL1&0 regime */
+	if (cpu->last_partition != id) {
+		tlbivmalle1();
+		dsbish();
+		cpu->last_partition = id;
+	}
+
+	cm_el1_sysregs_context_restore(SECURE);
+	cm_set_next_eret_context(SECURE);
+
+	rc = spm_enter_sp(&cpu->c_rt_ctx);
+	cpu->c_rt_ctx = 0;
+
+	for (i = 0; i < SPM_PARTITION_RESULTS; i++)
+		res[i] = read_ctx_reg(gpregs,
+				      (CTX_GPREG_X1 + (i << DWORD_SHIFT)));
+
+	cm_el1_sysregs_context_restore(NON_SECURE);
+	cm_set_next_eret_context(NON_SECURE);
+
+	if (rc != SPM_SUCCESS)
+		SMC_RET1(ns_ctx, rc);
+
+	SMC_RET5(ns_ctx, SPM_SUCCESS, res[0], res[1], res[2], res[3]);
+}
+
+void spm_init(void)
+{
+	unsigned int i;
+
+	if (spm_partitions.num > (sizeof(spm_cpu_state[0].ctx_valid) * 8)) {
+		ERROR("SPM: Too many partitions (%u)\n", spm_partitions.num);
+		panic();
+	}
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+		spm_cpu_state[i].last_partition = SPM_NO_PARTITION;
+
+	INFO("SPM: %u secure partitions\n", spm_partitions.num);
+}
+
+uint64_t spm_smc_handler(uint32_t smc_fid,
+			 uint64_t x1,
+			 uint64_t x2,
+			 uint64_t x3,
+			 uint64_t x4,
+			 void *cookie,
+			 void *handle,
+			 uint64_t flags)
+{
+	spm_cpu_state_t *cpu = &spm_cpu_state[plat_my_core_pos()];
+
+	if (smc_fid == SPM_VERSION)
+		SMC_RET1(handle, SPM_VERSION_COMPILED);
+
+	if (is_caller_non_secure(flags)) {
+		if (smc_fid != SPM_PARTITION_CALL)
+			SMC_RET1(handle, SPM_DENIED);
+
+		if (x1 >= spm_partitions.num)
+			SMC_RET1(handle, SPM_INVALID_PARAMETER);
+
+		return spm_partition_call(x1, handle);
+	}
+
+	/* Only the partitions run in the secure world */
+	assert(cpu->c_rt_ctx != 0);
+
+	switch (smc_fid) {
+	case SPM_PARTITION_RETURN:
+		spm_exit_sp(cpu->c_rt_ctx, SPM_SUCCESS);
+
+	case SPM_PARTITION_ABORT:
+		ERROR("SPM: Partition %u aborted on CPU %u, ESR 0x%llx,"
+		      " ELR 0x%llx, FAR 0x%llx\n", cpu->last_partition,
+		      plat_my_core_pos(), (unsigned long long)x1,
+		      (unsigned long long)x2, (unsigned long long)x3);
+		spm_exit_sp(cpu->c_rt_ctx, SPM_ABORTED);
+
+	default:
+		SMC_RET1(handle, SPM_DENIED);
+	}
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __SPM_PRIVATE_H__
+#define __SPM_PRIVATE_H__
+
+/*
+ * Layout of the C runtime context of BL31 saved on its stack when it enters a
+ * partition, i.e. the callee-saved registers.
+ */
+#define SPM_C_RT_CTX_X19		0x0
+#define SPM_C_RT_CTX_X20		0x8
+#define SPM_C_RT_CTX_X21		0x10
+#define SPM_C_RT_CTX_X22		0x18
+#define SPM_C_RT_CTX_X23		0x20
+#define SPM_C_RT_CTX_X24		0x28
+#define SPM_C_RT_CTX_X25		0x30
+#define SPM_C_RT_CTX_X26		0x38
+#define SPM_C_RT_CTX_X27		0x40
+#define SPM_C_RT_CTX_X28		0x48
+#define SPM_C_RT_CTX_X29		0x50
+#define SPM_C_RT_CTX_X30		0x58
+#define SPM_C_RT_CTX_SIZE		0x60
+
+#ifndef __ASSEMBLY__
+
+#include <spm_svc.h>
+#include <stdint.h>
+
+/* No partition has run on the CPU */
+#define SPM_NO_PARTITION		~0U
+
+typedef struct spm_cpu_state {
+	/* Address of the C runtime context while a partition runs, 0 if none */
+	uint64_t c_rt_ctx;
+	/* Partition which ran last, whose TLB entries may still be cached */
+	unsigned int last_partition;
+	/* Bit N is set once the context of the partition N is initialised */
+	unsigned int ctx_valid;
+} spm_cpu_state_t;
+
+uint64_t spm_enter_sp(uint64_t *c_rt_ctx);
+void __dead2 spm_exit_sp(uint64_t c_rt_ctx, uint64_t ret);
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* __SPM_PRIVATE_H__ */
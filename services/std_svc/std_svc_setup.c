@@ -7,11 +7,15 @@
 #include <assert.h>
 #include <cpu_data.h>
 #include <debug.h>
+#include <platform.h>
+#include <platform_def.h>
 #include <pmf.h>
 #include <psci.h>
 #include <runtime_instr.h>
 #include <runtime_svc.h>
+#include <sdei.h>
 #include <smcc_helpers.h>
+#include <spm_svc.h>
 #include <std_svc.h>
 #include <stdint.h>
 #include <uuid.h>
@@ -21,6 +25,78 @@ DEFINE_SVC_UUID(arm_svc_uid,
 		0x108d905b, 0xf863, 0x47e8, 0xae, 0x2d,
 		0xc0, 0xfb, 0x56, 0x41, 0xf6, 0xe2);
 
+#if ENABLE_RUNTIME_INSTRUMENTATION
+/*
+ * Latency histograms of the phases of the PSCI calls that entered a low power
+ * state, per CPU. Bucket N counts the phases that took [2^N, 2^(N+1)) system
+ * counter ticks. Each CPU only updates its own histograms so no locking is
+ * needed.
+ */
+static unsigned int rt_instr_psci_stats[PLATFORM_CORE_COUNT]
+				       [RT_INSTR_TOTAL_PHASES]
+				       [RT_INSTR_STATS_BUCKETS]
+	__aligned(CACHE_WRITEBACK_GRANULE);
+
+/* Return floor(log2(ticks)), clamped to the number of buckets */
+static unsigned int rt_instr_bucket(unsigned long long ticks)
+{
+	if ((ticks >> 32) != 0)
+		return RT_INSTR_STATS_BUCKETS - 1;
+	if (ticks == 0)
+		return 0;
+	return 31 - __builtin_clz((unsigned int)ticks);
+}
+
+/*
+ * Account for the previous PSCI call of this CPU if it went through a low power
+ * state. This is done when the next PSCI call starts, as a call that powers
+ * the CPU down returns through the warm boot path, and all its time-stamps are
+ * only known once it has returned. The time-stamps are in order only if the low
+ * power state was entered during that call, so each call is accounted for
+ * once.
+ */
+static void rt_instr_psci_stats_update(void)
+{
+	unsigned int pos = plat_my_core_pos();
+	unsigned long long ts[RT_INSTR_EXIT_HW_LOW_PWR + 1];
+	unsigned int tid;
+
+	for (tid = RT_INSTR_ENTER_PSCI; tid <= RT_INSTR_EXIT_HW_LOW_PWR; tid++)
+		PMF_GET_TIMESTAMP_BY_INDEX(rt_instr_svc, tid, pos,
+					   PMF_NO_CACHE_MAINT, ts[tid]);
+
+	if ((ts[RT_INSTR_ENTER_PSCI] == 0) ||
+	    (ts[RT_INSTR_ENTER_HW_LOW_PWR] < ts[RT_INSTR_ENTER_PSCI]) ||
+	    (ts[RT_INSTR_EXIT_HW_LOW_PWR] < ts[RT_INSTR_ENTER_HW_LOW_PWR]) ||
+	    (ts[RT_INSTR_EXIT_PSCI] < ts[RT_INSTR_EXIT_HW_LOW_PWR]))
+		return;
+
+	rt_instr_psci_stats[pos][RT_INSTR_PHASE_ENTRY]
+		[rt_instr_bucket(ts[RT_INSTR_ENTER_HW_LOW_PWR] -
+				 ts[RT_INSTR_ENTER_PSCI])]++;
+	rt_instr_psci_stats[pos][RT_INSTR_PHASE_LOW_PWR]
+		[rt_instr_bucket(ts[RT_INSTR_EXIT_HW_LOW_PWR] -
+				 ts[RT_INSTR_ENTER_HW_LOW_PWR])]++;
+	rt_instr_psci_stats[pos][RT_INSTR_PHASE_EXIT]
+		[rt_instr_bucket(ts[RT_INSTR_EXIT_PSCI] -
+				 ts[RT_INSTR_EXIT_HW_LOW_PWR])]++;
+}
+
+/*
+ * Return the number of low power PSCI calls of a CPU whose given phase falls in
+ * the given latency bucket.
+ */
+unsigned int rt_instr_psci_stats_get(unsigned int cpu_idx, unsigned int phase,
+				     unsigned int bucket)
+{
+	assert((cpu_idx < PLATFORM_CORE_COUNT) &&
+	       (phase < RT_INSTR_TOTAL_PHASES) &&
+	       (bucket < RT_INSTR_STATS_BUCKETS));
+
+	return rt_instr_psci_stats[cpu_idx][phase][bucket];
+}
+#endif /* ENABLE_RUNTIME_INSTRUMENTATION */
+
 /* Setup Standard Services */
 static int32_t std_svc_setup(void)
 {
@@ -29,8 +105,16 @@ static int32_t std_svc_setup(void)
 	svc_arg = get_arm_std_svc_args(PSCI_FID_MASK);
 	assert(svc_arg);
 
+#if SDEI_SUPPORT
+	sdei_init();
+#endif
+
+#if ENABLE_SPM
+	spm_init();
+#endif
+
 	/*
-	 * PSCI is the only specification implemented as a Standard Service.
+	 * PSCI is the main specification implemented as a Standard Service.
 	 * The `psci_setup()` also does EL3 architectural setup.
 	 */
 	return psci_setup((const psci_lib_args_t *)svc_arg);
@@ -40,14 +124,14 @@ static int32_t std_svc_setup(void)
  * Top-level Standard Service SMC handler. This handler will in turn dispatch
  * calls to PSCI SMC handler
  */
-uintptr_t std_svc_smc_handler(uint32_t smc_fid,
-			     u_register_t x1,
-			     u_register_t x2,
-			     u_register_t x3,
-			     u_register_t x4,
-			     void *cookie,
-			     void *handle,
-			     u_register_t flags)
+uintptr_t __hot std_svc_smc_handler(uint32_t smc_fid,
+				    u_register_t x1,
+				    u_register_t x2,
+				    u_register_t x3,
+				    u_register_t x4,
+				    void *cookie,
+				    void *handle,
+				    u_register_t flags)
 {
 	/*
 	 * Dispatch PSCI calls to PSCI SMC handler and return its return
@@ -57,6 +141,7 @@ uintptr_t std_svc_smc_handler(uint32_t smc_fid,
 		uint64_t ret;
 
 #if ENABLE_RUNTIME_INSTRUMENTATION
+		rt_instr_psci_stats_update();
 
 		/*
 		 * Flush cache line so that even if CPU power down happens
@@ -80,6 +165,18 @@ uintptr_t std_svc_smc_handler(uint32_t smc_fid,
 		SMC_RET1(handle, ret);
 	}
 
+#if SDEI_SUPPORT
+	if (is_sdei_fid(smc_fid))
+		return sdei_smc_handler(smc_fid, x1, x2, x3, x4, cookie,
+					handle, flags);
+#endif
+
+#if ENABLE_SPM
+	if (is_spm_fid(smc_fid))
+		return spm_smc_handler(smc_fid, x1, x2, x3, x4, cookie,
+				       handle, flags);
+#endif
+
 	switch (smc_fid) {
 	case ARM_STD_SVC_CALL_COUNT:
 		/*
@@ -112,3 +209,22 @@ DECLARE_RT_SVC(
 		std_svc_setup,
 		std_svc_smc_handler
 );
+
+#if ENABLE_SMC_LEAF_HANDLERS
+/*
+ * Leaf handler for the PSCI calls which only report information about the
+ * PSCI implementation and can therefore skip the full context save.
+ */
+static void std_svc_leaf_handler(uint32_t smc_fid,
+				 u_register_t x1,
+				 u_register_t x2,
+				 u_register_t x3,
+				 u_register_t *ret,
+				 u_register_t flags)
+{
+	ret[0] = psci_smc_handler(smc_fid, x1, x2, x3, 0, NULL, NULL, flags);
+}
+
+DECLARE_RT_LEAF_SVC(psci_version, PSCI_VERSION, std_svc_leaf_handler);
+DECLARE_RT_LEAF_SVC(psci_features, PSCI_FEATURES, std_svc_leaf_handler);
+#endif
@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host tool that runs microbenchmarks on firmware libraries built natively,
+ * with the architectural helpers replaced by host implementations.
+ *
+ * The iterations of a benchmark are timed in samples of at least the minimum
+ * sample time, and the best and median time per operation over the samples
+ * are reported. The best time is the most stable one to compare two builds.
+ * The results can also be written as a JSON report along with the build
+ * options of the firmware code, for the results of builds to be tracked.
+ */
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <utils_def.h>
+
+#include "bench.h"
+
+#define DEFAULT_SAMPLE_MS	20
+#define DEFAULT_SAMPLES		5
+#define MAX_SAMPLES		100
+
+static const bench_t *const bench_groups[] = {
+	xlat_benchs,
+	psci_benchs,
+	fdt_benchs,
+	auth_benchs,
+};
+
+/* Build options of the firmware code, recorded in the JSON report */
+#define BENCH_OPTION(_name)	{ #_name, _name }
+
+static const struct {
+	const char *name;
+	long value;
+} bench_options[] = {
+	BENCH_OPTION(DEBUG),
+	BENCH_OPTION(ENABLE_ASSERTIONS),
+	BENCH_OPTION(ENABLE_PMF),
+	BENCH_OPTION(ENABLE_PSCI_CPU_FREEZE),
+	BENCH_OPTION(ENABLE_PSCI_STAT),
+	BENCH_OPTION(ENABLE_RUNTIME_INSTRUMENTATION),
+	BENCH_OPTION(HW_ASSISTED_COHERENCY),
+	BENCH_OPTION(PSCI_CACHE_ALIGNED_STATE),
+	BENCH_OPTION(PSCI_CPU_ON_MULTI),
+	BENCH_OPTION(PSCI_EXTENDED_STATE_ID),
+	BENCH_OPTION(PSCI_OS_INIT_MODE),
+	BENCH_OPTION(PSCI_PD_SNAPSHOT),
+	BENCH_OPTION(PSCI_RUN_CPU_COUNTS),
+	BENCH_OPTION(PSCI_SUSPEND_GOVERNOR),
+	BENCH_OPTION(PSCI_SUSPEND_LOCK_ELISION),
+	BENCH_OPTION(PSCI_TICKET_LOCKS),
+	BENCH_OPTION(USE_COHERENT_MEM),
+	BENCH_OPTION(XLAT_TABLES_HANDOFF),
+	BENCH_OPTION(XLAT_TABLES_PREBUILT),
+	BENCH_OPTION(BENCH_CLUSTER_COUNT),
+	BENCH_OPTION(BENCH_CLUSTER_CORE_COUNT),
+};
+
+static unsigned int sample_ms = DEFAULT_SAMPLE_MS;
+static unsigned int samples = DEFAULT_SAMPLES;
+
+/* JSON report, and number of results written to it */
+static FILE *report;
+static unsigned int report_count;
+
+void bench_check(int cond, const char *what)
+{
+	if (cond)
+		return;
+
+	fprintf(stderr, "ERROR: %s failed\n", what);
+	exit(1);
+}
+
+static unsigned long long now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static unsigned long long time_iterations(const bench_t *bench,
+					  unsigned long long iterations)
+{
+	unsigned long long i, start = now_ns();
+
+	for (i = 0; i < iterations; i++)
+		bench->run();
+
+	return now_ns() - start;
+}
+
+static int cmp_ns(const void *a, const void *b)
+{
+	double x = *(const double *)a, y = *(const double *)b;
+
+	return (x > y) - (x < y);
+}
+
+static void report_open(const char *path)
+{
+	unsigned int i;
+
+	report = fopen(path, "w");
+	if (report == NULL) {
+		perror(path);
+		exit(1);
+	}
+
+	fprintf(report, "{\n  \"samples\": %u,\n  \"sample_ms\": %u,\n",
+		samples, sample_ms);
+	fprintf(report, "  \"build_options\": {");
+	for (i = 0; i < ARRAY_SIZE(bench_options); i++)
+		fprintf(report, "%s\n    \"%s\": %ld", (i == 0) ? "" : ",",
+			bench_options[i].name, bench_options[i].value);
+	fprintf(report, "\n  },\n  \"benchmarks\": [");
+}
+
+static void report_result(const char *name, unsigned long long ops,
+			  double best, double median)
+{
+	fprintf(report, "%s\n    { \"name\": \"%s\", \"operations\": %llu, "
+		"\"best_ns_per_op\": %.1f, \"median_ns_per_op\": %.1f }",
+		(report_count++ == 0) ? "" : ",", name, ops, best, median);
+}
+
+static void report_close(void)
+{
+	fprintf(report, "\n  ]\n}\n");
+	if (fclose(report) != 0) {
+		perror("report");
+		exit(1);
+	}
+}
+
+static void run_bench(const bench_t *bench)
+{
+	unsigned long long iterations = 1, elapsed;
+	double ns_per_op[MAX_SAMPLES];
+	unsigned int i;
+
+	if ((bench->setup != NULL) && (bench->setup() != 0)) {
+		fprintf(stderr, "ERROR: setup of %s failed\n", bench->name);
+		exit(1);
+	}
+
+	/* Find the number of iterations that last the minimum sample time */
+	while ((elapsed = time_iterations(bench, iterations)) <
+	       sample_ms * 1000000ULL)
+		iterations *= 2;
+
+	for (i = 0; i < samples; i++) {
+		elapsed = time_iterations(bench, iterations);
+		ns_per_op[i] = (double)elapsed / iterations / bench->ops;
+	}
+	qsort(ns_per_op, samples, sizeof(ns_per_op[0]), cmp_ns);
+
+	printf("%-32s %12llu %14.1f %14.1f\n", bench->name,
+	       iterations * bench->ops, ns_per_op[0], ns_per_op[samples / 2]);
+
+	if (report != NULL)
+		report_result(bench->name, iterations * bench->ops,
+			      ns_per_op[0], ns_per_op[samples / 2]);
+}
+
+static int selected(const char *name, int argc, char *argv[])
+{
+	int i;
+
+	if (argc == 0)
+		return 1;
+
+	for (i = 0; i < argc; i++) {
+		if (strncmp(name, argv[i], strlen(argv[i])) == 0)
+			return 1;
+	}
+	return 0;
+}
+
+static void usage(void)
+{
+	printf("benchmark [-l] [-j <file>] [-s <samples>] [-t <ms>] "
+	       "[<prefix>...]\n");
+	printf("  -l         List the benchmarks\n");
+	printf("  -j <file>  Also write the results as a JSON report\n");
+	printf("  -s <n>     Number of samples of each benchmark "
+	       "(default %u)\n", DEFAULT_SAMPLES);
+	printf("  -t <ms>    Minimum duration of a sample (default %u)\n",
+	       DEFAULT_SAMPLE_MS);
+	printf("Only the benchmarks whose name starts with one of the prefixes "
+	       "are run.\n");
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	const bench_t *bench;
+	unsigned int i;
+	const char *report_path = NULL;
+	int opt, list = 0;
+
+	while ((opt = getopt(argc, argv, "lj:s:t:")) != -1) {
+		switch (opt) {
+		case 'l':
+			list = 1;
+			break;
+		case 'j':
+			report_path = optarg;
+			break;
+		case 's':
+			samples = strtoul(optarg, NULL, 0);
+			if ((samples == 0) || (samples > MAX_SAMPLES))
+				usage();
+			break;
+		case 't':
+			sample_ms = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			usage();
+		}
+	}
+	argc -= optind;
+	argv += optind;
+
+	if (!list) {
+		if (report_path != NULL)
+			report_open(report_path);
+		printf("%-32s %12s %14s %14s\n", "benchmark", "operations",
+		       "best ns/op", "median ns/op");
+	}
+
+	for (i = 0; i < ARRAY_SIZE(bench_groups); i++) {
+		for (bench = bench_groups[i]; bench->name != NULL; bench++) {
+			if (!selected(bench->name, argc, argv))
+				continue;
+			if (list)
+				printf("%s\n", bench->name);
+			else
+				run_bench(bench);
+		}
+	}
+
+	if (report != NULL)
+		report_close();
+
+	return 0;
+}
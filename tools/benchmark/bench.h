@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <types.h>
+
+typedef struct bench {
+	const char *name;
+	/* Prepare the state used by run(), before timing it. Optional. */
+	int (*setup)(void);
+	/* Run one iteration, made of 'ops' operations of the benchmark */
+	void (*run)(void);
+	unsigned int ops;
+} bench_t;
+
+/* Arrays of benchmarks of each library, terminated by an empty entry */
+extern const bench_t xlat_benchs[];
+extern const bench_t psci_benchs[];
+extern const bench_t fdt_benchs[];
+extern const bench_t auth_benchs[];
+
+/* Make the calling code run as if it were on the CPU 'cpu_idx' */
+void host_set_cpu(unsigned int cpu_idx);
+u_register_t host_cpu_mpidr(unsigned int cpu_idx);
+
+/* Abort the benchmarks when an operation of the firmware code fails */
+void bench_check(int cond, const char *what);
+
+#endif /* __BENCH_H__ */
@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Benchmarks of the authentication framework walking the TBBR chain of trust.
+ *
+ * The certificates are parsed by a stand-in parser, and the hashes and
+ * signatures are accepted by a stand-in crypto library, so that the time
+ * measured is the one spent by the authentication module itself. The
+ * certificates are built from the CoT descriptors, with a record for each
+ * parameter that the CoT extracts from them.
+ */
+
+#include <auth_mod.h>
+#include <crypto_mod.h>
+#include <img_parser_mod.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <string.h>
+#include <utils_def.h>
+
+#include "bench.h"
+
+#define BENCH_CERT_MAGIC	0x54524543	/* "CERT" */
+#define BENCH_CERT_SIZE		4096
+#define BENCH_IMAGE_SIZE	(16 * 1024)
+#define BENCH_MAX_IMAGES	32
+
+#define ASN1_INTEGER		0x02
+
+/* Sizes of the parameters that are not copied to the CoT buffers */
+#define BENCH_TBS_SIZE		1024
+#define BENCH_SIG_SIZE		256
+#define BENCH_ALG_SIZE		16
+#define BENCH_PK_SIZE		294
+
+/* A certificate is a header followed by records padded to 8 bytes */
+typedef struct {
+	uint32_t magic;
+	uint32_t len;
+} bench_cert_hdr_t;
+
+typedef struct {
+	uint32_t type;
+	uint32_t len;
+	const void *cookie;
+} bench_cert_rec_t;
+
+typedef struct {
+	unsigned char data[BENCH_CERT_SIZE] __aligned(8);
+	unsigned int len;
+} bench_cert_t;
+
+extern const auth_img_desc_t *const cot_desc_ptr;
+extern const unsigned int cot_desc_size;
+extern unsigned int auth_img_flags[];
+
+static bench_cert_t certs[BENCH_MAX_IMAGES];
+
+static unsigned char image[BENCH_IMAGE_SIZE];
+
+static unsigned char rotpk_hash[51];
+
+/* Images loaded by BL1 and by BL2, with their parents first */
+static const unsigned int bl1_images[] = {
+	TRUSTED_BOOT_FW_CERT_ID,
+	BL2_IMAGE_ID,
+};
+
+static const unsigned int bl2_images[] = {
+	TRUSTED_KEY_CERT_ID,
+	SCP_FW_KEY_CERT_ID,
+	SCP_FW_CONTENT_CERT_ID,
+	SCP_BL2_IMAGE_ID,
+	SOC_FW_KEY_CERT_ID,
+	SOC_FW_CONTENT_CERT_ID,
+	BL31_IMAGE_ID,
+	TRUSTED_OS_FW_KEY_CERT_ID,
+	TRUSTED_OS_FW_CONTENT_CERT_ID,
+	BL32_IMAGE_ID,
+	NON_TRUSTED_FW_KEY_CERT_ID,
+	NON_TRUSTED_FW_CONTENT_CERT_ID,
+	BL33_IMAGE_ID,
+};
+
+/*
+ * Stand-in certificate parser
+ */
+static void cert_parser_init(void)
+{
+}
+
+static const bench_cert_rec_t *cert_next_rec(const void *img,
+					     unsigned int img_len,
+					     const bench_cert_rec_t *rec)
+{
+	uintptr_t next, end = (uintptr_t)img + img_len;
+
+	if (rec == NULL)
+		next = (uintptr_t)img + sizeof(bench_cert_hdr_t);
+	else
+		next = (uintptr_t)(rec + 1) + round_up(rec->len, 8);
+
+	if ((next == end) || (next + sizeof(*rec) > end))
+		return NULL;
+	rec = (const bench_cert_rec_t *)next;
+	if (rec->len > end - (uintptr_t)(rec + 1))
+		return NULL;
+	return rec;
+}
+
+static int cert_check_integrity(void *img, unsigned int img_len)
+{
+	const bench_cert_hdr_t *hdr = img;
+	const bench_cert_rec_t *rec = NULL;
+	uintptr_t end = (uintptr_t)img + img_len;
+
+	if ((img_len < sizeof(*hdr)) || (hdr->magic != BENCH_CERT_MAGIC) ||
+	    (hdr->len != img_len))
+		return IMG_PARSER_ERR_FORMAT;
+
+	while ((rec = cert_next_rec(img, img_len, rec)) != NULL) {
+		if ((uintptr_t)(rec + 1) + round_up(rec->len, 8) == end)
+			return IMG_PARSER_OK;
+	}
+	return IMG_PARSER_ERR_FORMAT;
+}
+
+static int cert_get_auth_param(const auth_param_type_desc_t *type_desc,
+			       void *img, unsigned int img_len,
+			       void **param, unsigned int *param_len)
+{
+	const bench_cert_rec_t *rec = NULL;
+
+	while ((rec = cert_next_rec(img, img_len, rec)) != NULL) {
+		if ((rec->type == type_desc->type) &&
+		    (rec->cookie == type_desc->cookie)) {
+			*param = (void *)(rec + 1);
+			*param_len = rec->len;
+			return IMG_PARSER_OK;
+		}
+	}
+	return IMG_PARSER_ERR_NOT_FOUND;
+}
+
+REGISTER_IMG_PARSER_LIB(IMG_CERT, "bench_cert", cert_parser_init,
+			cert_check_integrity, cert_get_auth_param);
+
+/*
+ * Stand-in crypto library, which accepts all the signatures and hashes
+ */
+static void crypto_init(void)
+{
+}
+
+static int verify_signature(void *data_ptr, unsigned int data_len,
+			    void *sig_ptr, unsigned int sig_len,
+			    void *sig_alg, unsigned int sig_alg_len,
+			    void *pk_ptr, unsigned int pk_len)
+{
+	return CRYPTO_SUCCESS;
+}
+
+static int verify_hash(void *data_ptr, unsigned int data_len,
+		       void *digest_info_ptr, unsigned int digest_info_len)
+{
+	return CRYPTO_SUCCESS;
+}
+
+REGISTER_CRYPTO_LIB("bench", crypto_init, verify_signature, verify_hash);
+
+/*
+ * Platform functions used by the authentication module
+ */
+int plat_get_rotpk_info(void *cookie, void **key_ptr, unsigned int *key_len,
+			unsigned int *flags)
+{
+	*key_ptr = rotpk_hash;
+	*key_len = sizeof(rotpk_hash);
+	*flags = ROTPK_IS_HASH;
+	return 0;
+}
+
+int plat_get_nv_ctr(void *cookie, unsigned int *nv_ctr)
+{
+	*nv_ctr = 0;
+	return 0;
+}
+
+int plat_set_nv_ctr(void *cookie, unsigned int nv_ctr)
+{
+	return 0;
+}
+
+/*
+ * Certificates built from the CoT
+ */
+static void cert_add_rec(bench_cert_t *cert,
+			 const auth_param_type_desc_t *type_desc,
+			 const void *data, unsigned int len)
+{
+	bench_cert_rec_t *rec = (bench_cert_rec_t *)&cert->data[cert->len];
+
+	bench_check(cert->len + sizeof(*rec) + round_up(len, 8) <=
+		    BENCH_CERT_SIZE, "cert_add_rec()");
+
+	rec->type = type_desc->type;
+	rec->len = len;
+	rec->cookie = type_desc->cookie;
+	if (data != NULL)
+		memcpy(rec + 1, data, len);
+	else
+		memset(rec + 1, 0xa5, len);
+	cert->len += sizeof(*rec) + round_up(len, 8);
+}
+
+static void cert_build(unsigned int img_id)
+{
+	static const unsigned char nv_ctr_der[] = { ASN1_INTEGER, 1, 0 };
+	const auth_img_desc_t *img_desc = &cot_desc_ptr[img_id];
+	const auth_method_desc_t *method;
+	const auth_param_desc_t *data;
+	bench_cert_t *cert = &certs[img_id];
+	bench_cert_hdr_t *hdr = (bench_cert_hdr_t *)cert->data;
+	unsigned int i;
+
+	cert->len = sizeof(*hdr);
+
+	for (i = 0; i < AUTH_METHOD_NUM; i++) {
+		method = &img_desc->img_auth_methods[i];
+		switch (method->type) {
+		case AUTH_METHOD_SIG:
+			cert_add_rec(cert, method->param.sig.data, NULL,
+				     BENCH_TBS_SIZE);
+			cert_add_rec(cert, method->param.sig.sig, NULL,
+				     BENCH_SIG_SIZE);
+			cert_add_rec(cert, method->param.sig.alg, NULL,
+				     BENCH_ALG_SIZE);
+			/* The ROTPK hash is checked against the key */
+			if (img_desc->parent == NULL)
+				cert_add_rec(cert, method->param.sig.pk, NULL,
+					     BENCH_PK_SIZE);
+			break;
+		case AUTH_METHOD_NV_CTR:
+			cert_add_rec(cert, method->param.nv_ctr.cert_nv_ctr,
+				     nv_ctr_der, sizeof(nv_ctr_der));
+			break;
+		default:
+			break;
+		}
+	}
+
+	for (i = 0; i < COT_MAX_VERIFIED_PARAMS; i++) {
+		data = &img_desc->authenticated_data[i];
+		if (data->type_desc != NULL)
+			cert_add_rec(cert, data->type_desc, NULL,
+				     data->data.len);
+	}
+
+	hdr->magic = BENCH_CERT_MAGIC;
+	hdr->len = cert->len;
+}
+
+static int auth_bench_setup(void)
+{
+	static int initialised;
+	unsigned int i;
+
+	if (initialised)
+		return 0;
+
+	if (cot_desc_size > BENCH_MAX_IMAGES)
+		return 1;
+
+	auth_mod_init();
+
+	for (i = 0; i < cot_desc_size; i++) {
+		if (cot_desc_ptr[i].img_type == IMG_CERT)
+			cert_build(i);
+	}
+
+	initialised = 1;
+	return 0;
+}
+
+static void auth_verify_images(const unsigned int *img_ids, unsigned int num)
+{
+	const auth_img_desc_t *img_desc;
+	unsigned int i;
+	int rc;
+
+	/* Start each boot stage with no image authenticated */
+	memset(auth_img_flags, 0, cot_desc_size * sizeof(auth_img_flags[0]));
+
+	for (i = 0; i < num; i++) {
+		img_desc = &cot_desc_ptr[img_ids[i]];
+		if (img_desc->img_type == IMG_CERT)
+			rc = auth_mod_verify_img(img_ids[i],
+						 certs[img_ids[i]].data,
+						 certs[img_ids[i]].len);
+		else
+			rc = auth_mod_verify_img(img_ids[i], image,
+						 sizeof(image));
+		bench_check(rc == 0, "auth_mod_verify_img()");
+	}
+}
+
+/* Authenticate BL2, as BL1 does */
+static void auth_cot_bl1(void)
+{
+	auth_verify_images(bl1_images, ARRAY_SIZE(bl1_images));
+}
+
+/* Authenticate the images that BL2 loads */
+static void auth_cot_bl2(void)
+{
+	auth_verify_images(bl2_images, ARRAY_SIZE(bl2_images));
+}
+
+const bench_t auth_benchs[] = {
+	{ "auth_cot_bl1", auth_bench_setup, auth_cot_bl1,
+	  ARRAY_SIZE(bl1_images) },
+	{ "auth_cot_bl2", auth_bench_setup, auth_cot_bl2,
+	  ARRAY_SIZE(bl2_images) },
+	{ NULL }
+};
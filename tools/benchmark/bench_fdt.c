@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Benchmarks of libfdt on a DT describing the CPUs of the benchmark platform
+ * and a set of devices. The edits are the ones that a BL image does on the DT
+ * that it passes to the normal world, as the QEMU port does.
+ */
+
+#include <fdt_index.h>
+#include <libfdt.h>
+#include <platform_def.h>
+#include <stdio.h>
+#include <string.h>
+#include <utils_def.h>
+
+#include "bench.h"
+
+#define FDT_DEVICES		64
+#define FDT_SIZE		(64 * 1024)
+
+static unsigned char fdt_base[FDT_SIZE];
+static unsigned char fdt_work[FDT_SIZE];
+
+static char device_paths[FDT_DEVICES][48];
+
+static fdt_index_node_t fdt_index_nodes[FDT_DEVICES + PLATFORM_CORE_COUNT + 8];
+static fdt_index_t fdt_base_index;
+
+#define fdt_try(_call)	bench_check((_call) >= 0, #_call)
+
+static void fdt_property_reg(void *fdt, uint64_t base, uint64_t size)
+{
+	fdt64_t reg[2] = { cpu_to_fdt64(base), cpu_to_fdt64(size) };
+
+	fdt_try(fdt_property(fdt, "reg", reg, sizeof(reg)));
+}
+
+static int fdt_bench_setup(void)
+{
+	void *fdt = fdt_base;
+	char name[32];
+	unsigned int i;
+
+	if (fdt_check_header(fdt) == 0)
+		return 0;
+
+	fdt_try(fdt_create(fdt, FDT_SIZE));
+	fdt_try(fdt_finish_reservemap(fdt));
+	fdt_try(fdt_begin_node(fdt, ""));
+	fdt_try(fdt_property_string(fdt, "compatible", "arm,benchmark"));
+	fdt_try(fdt_property_u32(fdt, "#address-cells", 2));
+	fdt_try(fdt_property_u32(fdt, "#size-cells", 2));
+
+	fdt_try(fdt_begin_node(fdt, "cpus"));
+	fdt_try(fdt_property_u32(fdt, "#address-cells", 1));
+	fdt_try(fdt_property_u32(fdt, "#size-cells", 0));
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		snprintf(name, sizeof(name), "cpu@%lx",
+			 (unsigned long)host_cpu_mpidr(i));
+		fdt_try(fdt_begin_node(fdt, name));
+		fdt_try(fdt_property_string(fdt, "device_type", "cpu"));
+		fdt_try(fdt_property_string(fdt, "compatible",
+					    "arm,cortex-a57"));
+		fdt_try(fdt_property_u32(fdt, "reg", host_cpu_mpidr(i)));
+		fdt_try(fdt_end_node(fdt));
+	}
+	fdt_try(fdt_end_node(fdt));
+
+	fdt_try(fdt_begin_node(fdt, "soc"));
+	fdt_try(fdt_property_u32(fdt, "#address-cells", 2));
+	fdt_try(fdt_property_u32(fdt, "#size-cells", 2));
+	fdt_try(fdt_property(fdt, "ranges", NULL, 0));
+	for (i = 0; i < FDT_DEVICES; i++) {
+		snprintf(name, sizeof(name), "dev@%x",
+			 0x1c000000 + i * 0x10000);
+		snprintf(device_paths[i], sizeof(device_paths[i]), "/soc/%s",
+			 name);
+		fdt_try(fdt_begin_node(fdt, name));
+		fdt_try(fdt_property_string(fdt, "compatible", "arm,pl011"));
+		fdt_property_reg(fdt, 0x1c000000 + i * 0x10000, 0x1000);
+		fdt_try(fdt_property_u32(fdt, "interrupts", 32 + i));
+		fdt_try(fdt_property_string(fdt, "status", "okay"));
+		fdt_try(fdt_end_node(fdt));
+	}
+	fdt_try(fdt_end_node(fdt));
+
+	fdt_try(fdt_begin_node(fdt, "memory@80000000"));
+	fdt_try(fdt_property_string(fdt, "device_type", "memory"));
+	fdt_property_reg(fdt, 0x80000000, 0x80000000);
+	fdt_try(fdt_end_node(fdt));
+
+	fdt_try(fdt_end_node(fdt));
+	fdt_try(fdt_finish(fdt));
+
+	return fdt_check_header(fdt);
+}
+
+/* Look up each device by path and read its registers */
+static void fdt_lookup(void)
+{
+	const void *reg;
+	unsigned int i;
+	int offs, len;
+
+	for (i = 0; i < FDT_DEVICES; i++) {
+		offs = fdt_path_offset(fdt_base, device_paths[i]);
+		fdt_try(offs);
+		reg = fdt_getprop(fdt_base, offs, "reg", &len);
+		bench_check((reg != NULL) && (len == 16), "fdt_getprop()");
+	}
+}
+
+static int fdt_index_setup(void)
+{
+	int rc = fdt_bench_setup();
+
+	if (rc != 0)
+		return rc;
+
+	return fdt_index_init(&fdt_base_index, fdt_base, fdt_index_nodes,
+			      ARRAY_SIZE(fdt_index_nodes));
+}
+
+/* Same with the index of the DT */
+static void fdt_lookup_index(void)
+{
+	const void *reg;
+	unsigned int i;
+	int offs, len;
+
+	for (i = 0; i < FDT_DEVICES; i++) {
+		offs = fdt_index_path_offset(&fdt_base_index, device_paths[i]);
+		fdt_try(offs);
+		reg = fdt_getprop(fdt_base, offs, "reg", &len);
+		bench_check((reg != NULL) && (len == 16), "fdt_getprop()");
+	}
+}
+
+/* Index the DT, as done once before the lookups */
+static void fdt_index_build(void)
+{
+	fdt_try(fdt_index_init(&fdt_base_index, fdt_base, fdt_index_nodes,
+			       ARRAY_SIZE(fdt_index_nodes)));
+}
+
+/* Add a PSCI node to a copy of the DT */
+static void fdt_add_psci_node(void)
+{
+	void *fdt = fdt_work;
+	int offs;
+
+	fdt_try(fdt_open_into(fdt_base, fdt, FDT_SIZE));
+
+	offs = fdt_path_offset(fdt, "/");
+	fdt_try(offs);
+	offs = fdt_add_subnode(fdt, offs, "psci");
+	fdt_try(offs);
+	fdt_try(fdt_appendprop_string(fdt, offs, "compatible",
+				      "arm,psci-1.0"));
+	fdt_try(fdt_appendprop_string(fdt, offs, "compatible",
+				      "arm,psci-0.2"));
+	fdt_try(fdt_setprop_string(fdt, offs, "method", "smc"));
+	fdt_try(fdt_setprop_u32(fdt, offs, "cpu_suspend", 0xc4000001));
+	fdt_try(fdt_setprop_u32(fdt, offs, "cpu_off", 0x84000002));
+	fdt_try(fdt_setprop_u32(fdt, offs, "cpu_on", 0xc4000003));
+}
+
+/* Set the enable method of every CPU node of a copy of the DT */
+static void fdt_cpu_enable_methods(void)
+{
+	void *fdt = fdt_work;
+	const char *type;
+	int offs = 0;
+
+	fdt_try(fdt_open_into(fdt_base, fdt, FDT_SIZE));
+
+	while ((offs = fdt_next_node(fdt, offs, NULL)) >= 0) {
+		type = fdt_getprop(fdt, offs, "device_type", NULL);
+		if ((type == NULL) || (strcmp(type, "cpu") != 0))
+			continue;
+		fdt_try(fdt_setprop_string(fdt, offs, "enable-method",
+					   "psci"));
+	}
+}
+
+const bench_t fdt_benchs[] = {
+	{ "fdt_lookup", fdt_bench_setup, fdt_lookup, FDT_DEVICES },
+	{ "fdt_lookup_index", fdt_index_setup, fdt_lookup_index, FDT_DEVICES },
+	{ "fdt_index_build", fdt_bench_setup, fdt_index_build, 1 },
+	{ "fdt_add_psci_node", fdt_bench_setup, fdt_add_psci_node, 1 },
+	{ "fdt_cpu_enable_methods", fdt_bench_setup, fdt_cpu_enable_methods,
+	  PLATFORM_CORE_COUNT },
+	{ NULL }
+};
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Benchmarks of the state coordination of the PSCI library. The CPUs of the
+ * platform take turns on the host thread, and go through the steps of a
+ * CPU_SUSPEND and of the following wake-up that coordinate the power states.
+ */
+
+#include <platform.h>
+#include <platform_def.h>
+#include <psci.h>
+#include <psci_lib.h>
+
+#include "psci_private.h"
+
+#include "bench.h"
+
+static unsigned char power_domain_tree_desc[2 + BENCH_CLUSTER_COUNT];
+
+static const plat_psci_ops_t bench_psci_ops;
+
+const unsigned char *plat_get_power_domain_tree_desc(void)
+{
+	unsigned int i;
+
+	power_domain_tree_desc[0] = 1;
+	power_domain_tree_desc[1] = BENCH_CLUSTER_COUNT;
+	for (i = 0; i < BENCH_CLUSTER_COUNT; i++)
+		power_domain_tree_desc[2 + i] = BENCH_CLUSTER_CORE_COUNT;
+
+	return power_domain_tree_desc;
+}
+
+int plat_setup_psci_ops(uintptr_t sec_entrypoint,
+			const plat_psci_ops_t **psci_ops)
+{
+	*psci_ops = &bench_psci_ops;
+	return 0;
+}
+
+/* Request a power state and coordinate it, as psci_cpu_suspend_start() */
+static void cpu_suspend(unsigned int cpu_idx, plat_local_state_t state)
+{
+	psci_power_state_t state_info;
+	unsigned int lock_pwrlvl = PLAT_MAX_PWR_LVL;
+	unsigned int lvl;
+
+	for (lvl = PSCI_CPU_PWR_LVL; lvl <= PLAT_MAX_PWR_LVL; lvl++)
+		state_info.pwr_domain_state[lvl] = state;
+
+	host_set_cpu(cpu_idx);
+#if PSCI_SUSPEND_LOCK_ELISION
+	lock_pwrlvl = psci_acquire_suspend_locks(PLAT_MAX_PWR_LVL, cpu_idx);
+#else
+	psci_acquire_pwr_domain_locks(PLAT_MAX_PWR_LVL, cpu_idx);
+#endif
+	psci_do_state_coordination(PLAT_MAX_PWR_LVL, &state_info);
+	psci_release_pwr_domain_locks(lock_pwrlvl, cpu_idx);
+}
+
+/* Return to the RUN state, as psci_warmboot_entrypoint() */
+static void cpu_resume(unsigned int cpu_idx)
+{
+	psci_power_state_t state_info;
+
+	host_set_cpu(cpu_idx);
+	psci_acquire_pwr_domain_locks(PLAT_MAX_PWR_LVL, cpu_idx);
+	psci_get_target_local_pwr_states(PLAT_MAX_PWR_LVL, &state_info);
+	psci_set_pwr_domains_to_run(PLAT_MAX_PWR_LVL);
+	psci_release_pwr_domain_locks(PLAT_MAX_PWR_LVL, cpu_idx);
+}
+
+static int psci_bench_setup(void)
+{
+	static int initialised;
+	unsigned int i;
+	int rc;
+
+	DEFINE_STATIC_PSCI_LIB_ARGS_V1(lib_args, (mailbox_entrypoint_t)1);
+
+	if (initialised)
+		return 0;
+
+	/* The primary CPU sets up the library, then the others are turned on */
+	host_set_cpu(0);
+	rc = psci_setup(&lib_args);
+	if (rc != 0)
+		return rc;
+
+	for (i = 1; i < PLATFORM_CORE_COUNT; i++) {
+		host_set_cpu(i);
+		psci_cpu_pd_nodes[i].mpidr = host_cpu_mpidr(i);
+		psci_set_pwr_domains_to_run(PLAT_MAX_PWR_LVL);
+	}
+
+	initialised = 1;
+	return 0;
+}
+
+/*
+ * Power down all the CPUs in turn, which powers down each cluster with its last
+ * CPU and the system with the last cluster, then wake them up.
+ */
+static void psci_suspend_all(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+		cpu_suspend(i, PLAT_MAX_OFF_STATE);
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+		cpu_resume(i);
+}
+
+/* Power down and wake up each CPU in turn while the others are running */
+static void psci_suspend_one(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		cpu_suspend(i, PLAT_MAX_OFF_STATE);
+		cpu_resume(i);
+	}
+}
+
+const bench_t psci_benchs[] = {
+	{ "psci_suspend_all", psci_bench_setup, psci_suspend_all,
+	  2 * PLATFORM_CORE_COUNT },
+	{ "psci_suspend_one", psci_bench_setup, psci_suspend_one,
+	  2 * PLATFORM_CORE_COUNT },
+	{ NULL }
+};
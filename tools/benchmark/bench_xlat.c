@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Benchmarks of the translation table library. They use a context of their own,
+ * laid out like the one of xlat_tables_common.c, so that the tables can be
+ * built again from scratch at each iteration.
+ */
+
+#include <arch_helpers.h>
+#include <platform_def.h>
+#include <string.h>
+#include <utils_def.h>
+#include <xlat_tables_v2.h>
+
+#include "aarch64/xlat_tables_arch.h"
+#include "xlat_tables_private.h"
+
+#include "bench.h"
+
+/* Regions of a few pages, not aligned to the blocks of any level */
+#define REGION_BASE		0x40000000UL
+#define REGION_SIZE		(4 * PAGE_SIZE)
+#define REGION_STRIDE		(16 * PAGE_SIZE)
+#define REGION_ATTR		(MT_MEMORY | MT_RW | MT_SECURE)
+
+/* Pages whose attributes are changed back and forth */
+#define ATTR_PAGES		64
+
+#define BENCH_XLAT_MAX_REGIONS	256
+
+static mmap_region_t bench_mmap[MAX_MMAP_REGIONS + 1];
+
+static uint64_t bench_tables[MAX_XLAT_TABLES][XLAT_TABLE_ENTRIES]
+		__aligned(XLAT_TABLE_SIZE);
+
+static uint64_t bench_base_table[NUM_BASE_LEVEL_ENTRIES]
+		__aligned(NUM_BASE_LEVEL_ENTRIES * sizeof(uint64_t));
+
+static int bench_tables_mapped_regions[MAX_XLAT_TABLES];
+
+static xlat_ctx_t bench_ctx;
+
+static unsigned int nr_regions;
+
+static void ctx_reset(void)
+{
+	memset(&bench_ctx, 0, sizeof(bench_ctx));
+	memset(bench_mmap, 0, sizeof(bench_mmap));
+
+	bench_ctx.pa_max_address = PLAT_PHY_ADDR_SPACE_SIZE - 1;
+	bench_ctx.va_max_address = PLAT_VIRT_ADDR_SPACE_SIZE - 1;
+	bench_ctx.mmap = bench_mmap;
+	bench_ctx.mmap_num = MAX_MMAP_REGIONS;
+	bench_ctx.tables = bench_tables;
+	bench_ctx.tables_num = MAX_XLAT_TABLES;
+	bench_ctx.tables_mapped_regions = bench_tables_mapped_regions;
+	bench_ctx.base_table = bench_base_table;
+	bench_ctx.base_table_entries = NUM_BASE_LEVEL_ENTRIES;
+	bench_ctx.base_level = XLAT_TABLE_LEVEL_BASE;
+	bench_ctx.execute_never_mask =
+			xlat_arch_get_xn_desc(xlat_arch_current_el());
+}
+
+static void region_init(mmap_region_t *mm, unsigned int i)
+{
+	mm->base_pa = REGION_BASE + i * REGION_STRIDE;
+	mm->base_va = REGION_BASE + i * REGION_STRIDE;
+	mm->size = REGION_SIZE;
+	mm->attr = REGION_ATTR;
+}
+
+/* Run at EL3 with the MMU enabled, so that the TLB maintenance is done */
+static void xlat_setup_cpu(void)
+{
+	write_CurrentEl(MODE_EL3 << MODE_EL_SHIFT);
+	write_sctlr_el3(SCTLR_M_BIT);
+}
+
+static int xlat_setup(void)
+{
+	xlat_setup_cpu();
+	ctx_reset();
+	init_xlation_table(&bench_ctx);
+	return 0;
+}
+
+static int xlat_setup_16(void)
+{
+	nr_regions = 16;
+	return xlat_setup();
+}
+
+static int xlat_setup_256(void)
+{
+	nr_regions = BENCH_XLAT_MAX_REGIONS;
+	return xlat_setup();
+}
+
+/* Map the regions statically, as an image does before enabling the MMU */
+static void xlat_init_static(void)
+{
+	mmap_region_t mm;
+	unsigned int i;
+
+	ctx_reset();
+	for (i = 0; i < nr_regions; i++) {
+		region_init(&mm, i);
+		mmap_add_region_ctx(&bench_ctx, &mm);
+	}
+	init_xlation_table(&bench_ctx);
+}
+
+/* Add then remove the regions once the tables are in use */
+static void xlat_map_dynamic(void)
+{
+	mmap_region_t mm;
+	unsigned int i;
+	int rc;
+
+	for (i = 0; i < nr_regions; i++) {
+		region_init(&mm, i);
+		rc = mmap_add_dynamic_region_ctx(&bench_ctx, &mm);
+		bench_check(rc == 0, "mmap_add_dynamic_region_ctx()");
+	}
+	for (i = 0; i < nr_regions; i++) {
+		region_init(&mm, i);
+		rc = mmap_remove_dynamic_region_ctx(&bench_ctx, mm.base_va,
+						    mm.size);
+		bench_check(rc == 0, "mmap_remove_dynamic_region_ctx()");
+	}
+}
+
+/* Same, deferring the TLB maintenance to the end of the batch */
+static void xlat_map_dynamic_batch(void)
+{
+	mmap_dynamic_batch_start_ctx(&bench_ctx);
+	xlat_map_dynamic();
+	mmap_dynamic_batch_end_ctx(&bench_ctx);
+}
+
+static int xlat_setup_attrs(void)
+{
+	mmap_region_t mm = {
+		.base_pa = REGION_BASE,
+		.base_va = REGION_BASE,
+		.size = ATTR_PAGES * PAGE_SIZE,
+		.attr = REGION_ATTR,
+	};
+
+	xlat_setup_cpu();
+	ctx_reset();
+	mmap_add_region_ctx(&bench_ctx, &mm);
+	init_xlation_table(&bench_ctx);
+	return 0;
+}
+
+/* Make pages read-only then writable again, as done for the image data */
+static void xlat_change_attrs(void)
+{
+	int rc;
+
+	rc = change_mem_attributes_ctx(&bench_ctx, REGION_BASE,
+				       ATTR_PAGES * PAGE_SIZE,
+				       MT_MEMORY | MT_RO | MT_SECURE);
+	bench_check(rc == 0, "change_mem_attributes_ctx()");
+	rc = change_mem_attributes_ctx(&bench_ctx, REGION_BASE,
+				       ATTR_PAGES * PAGE_SIZE, REGION_ATTR);
+	bench_check(rc == 0, "change_mem_attributes_ctx()");
+}
+
+const bench_t xlat_benchs[] = {
+	{ "xlat_init_static_16", xlat_setup_16, xlat_init_static, 16 },
+	{ "xlat_init_static_256", xlat_setup_256, xlat_init_static, 256 },
+	{ "xlat_map_dynamic_16", xlat_setup_16, xlat_map_dynamic, 2 * 16 },
+	{ "xlat_map_dynamic_256", xlat_setup_256, xlat_map_dynamic, 2 * 256 },
+	{ "xlat_map_dynamic_batch_256", xlat_setup_256,
+	  xlat_map_dynamic_batch, 2 * 256 },
+	{ "xlat_change_attrs", xlat_setup_attrs, xlat_change_attrs,
+	  2 * ATTR_PAGES },
+	{ NULL }
+};
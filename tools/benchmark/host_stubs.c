@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host implementations of the architectural and platform functions that the
+ * firmware libraries built for the benchmarks depend on. They are written in
+ * assembly or provided by a platform port in the firmware.
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <context_mgmt.h>
+#include <cpu_data.h>
+#include <errata_report.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <spinlock.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ticket_lock.h>
+#include <utils.h>
+
+#include "bench.h"
+
+#define _DEFINE_HOST_SYSREG(_name)	uint64_t host_sysreg_ ## _name;
+
+HOST_SYSREGS(_DEFINE_HOST_SYSREG)
+
+unsigned long long host_tlbi_count;
+
+extern cpu_data_t percpu_data[];
+
+static unsigned int host_cpu_idx;
+
+void host_set_cpu(unsigned int cpu_idx)
+{
+	host_cpu_idx = cpu_idx;
+	write_mpidr_el1(host_cpu_mpidr(cpu_idx));
+	write_tpidr_el3((uintptr_t)_cpu_data_by_index(cpu_idx));
+}
+
+u_register_t host_cpu_mpidr(unsigned int cpu_idx)
+{
+	return ((cpu_idx / BENCH_CLUSTER_CORE_COUNT) << MPIDR_AFF1_SHIFT) |
+	       ((cpu_idx % BENCH_CLUSTER_CORE_COUNT) << MPIDR_AFF0_SHIFT);
+}
+
+unsigned int plat_my_core_pos(void)
+{
+	return host_cpu_idx;
+}
+
+int plat_core_pos_by_mpidr(u_register_t mpidr)
+{
+	unsigned int cluster = (mpidr >> MPIDR_AFF1_SHIFT) & MPIDR_AFFLVL_MASK;
+	unsigned int core = (mpidr >> MPIDR_AFF0_SHIFT) & MPIDR_AFFLVL_MASK;
+
+	if ((mpidr & ~(u_register_t)(MPIDR_CLUSTER_MASK | MPIDR_CPU_MASK)) ||
+	    (cluster >= BENCH_CLUSTER_COUNT) ||
+	    (core >= BENCH_CLUSTER_CORE_COUNT))
+		return -1;
+
+	return cluster * BENCH_CLUSTER_CORE_COUNT + core;
+}
+
+unsigned int plat_get_syscnt_freq2(void)
+{
+	return 100000000;
+}
+
+cpu_data_t *_cpu_data_by_index(uint32_t cpu_index)
+{
+	return &percpu_data[cpu_index];
+}
+
+void init_cpu_ops(void)
+{
+}
+
+/* The contexts of the lower ELs are not used by the benchmarks */
+void *cm_get_context_slot_by_index(unsigned int cpu_idx,
+				   unsigned int security_state)
+{
+	return NULL;
+}
+
+void cm_set_context_by_index(unsigned int cpu_idx, void *context,
+			     unsigned int security_state)
+{
+}
+
+#if DEBUG
+void print_errata_status(void)
+{
+}
+#endif
+
+/* The benchmarks run on a single thread, so the locks are never contended */
+void spin_lock(spinlock_t *lock)
+{
+	while (__atomic_exchange_n(&lock->lock, 1, __ATOMIC_ACQUIRE))
+		;
+}
+
+void spin_unlock(spinlock_t *lock)
+{
+	__atomic_store_n(&lock->lock, 0, __ATOMIC_RELEASE);
+}
+
+void ticket_lock(ticket_lock_t *lock)
+{
+	uint16_t ticket = __atomic_fetch_add(&lock->next, 1, __ATOMIC_RELAXED);
+
+	while (__atomic_load_n(&lock->owner, __ATOMIC_ACQUIRE) != ticket)
+		;
+}
+
+void ticket_unlock(ticket_lock_t *lock)
+{
+	__atomic_store_n(&lock->owner, lock->owner + 1, __ATOMIC_RELEASE);
+}
+
+/* The host caches are coherent */
+void flush_dcache_range(uintptr_t addr, size_t size)
+{
+}
+
+void clean_dcache_range(uintptr_t addr, size_t size)
+{
+}
+
+void inv_dcache_range(uintptr_t addr, size_t size)
+{
+}
+
+void zeromem(void *mem, u_register_t length)
+{
+	memset(mem, 0, length);
+}
+
+void tf_printf(const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	vprintf(fmt, args);
+	va_end(args);
+}
+
+void do_panic(void)
+{
+	fprintf(stderr, "PANIC in the firmware code\n");
+	abort();
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __ARCH_HELPERS_H__
+#define __ARCH_HELPERS_H__
+
+/*
+ * Host replacement of include/lib/aarch64/arch_helpers.h for the benchmarks.
+ * The system registers are backed by variables that the benchmarks may set, the
+ * barriers are compiler barriers and the TLB maintenance operations are only
+ * counted.
+ */
+
+#include <arch.h>	/* for additional register definitions */
+#include <stdint.h>
+#include <types.h>
+
+/* System registers accessed by the libraries built for the host */
+#define HOST_SYSREGS(X)		\
+	X(CurrentEl)		\
+	X(cntfrq_el0)		\
+	X(cnthp_ctl_el2)	\
+	X(cnthp_cval_el2)	\
+	X(cntp_ctl_el0)		\
+	X(cntp_cval_el0)	\
+	X(cntpct_el0)		\
+	X(cntps_ctl_el1)	\
+	X(cntps_cval_el1)	\
+	X(cntv_ctl_el0)		\
+	X(cntv_cval_el0)	\
+	X(cntvoff_el2)		\
+	X(id_aa64mmfr0_el1)	\
+	X(id_aa64pfr0_el1)	\
+	X(mpidr_el1)		\
+	X(scr_el3)		\
+	X(sctlr_el1)		\
+	X(sctlr_el2)		\
+	X(sctlr_el3)		\
+	X(tpidr_el3)		\
+	X(mair_el1)		\
+	X(mair_el3)		\
+	X(tcr_el1)		\
+	X(tcr_el3)		\
+	X(ttbr0_el1)		\
+	X(ttbr0_el3)
+
+#define _DECLARE_HOST_SYSREG(_name)				\
+extern uint64_t host_sysreg_ ## _name;				\
+static inline uint64_t read_ ## _name(void)			\
+{								\
+	return host_sysreg_ ## _name;				\
+}								\
+static inline void write_ ## _name(uint64_t v)			\
+{								\
+	host_sysreg_ ## _name = v;				\
+}
+
+HOST_SYSREGS(_DECLARE_HOST_SYSREG)
+
+/* Number of TLB maintenance operations issued so far */
+extern unsigned long long host_tlbi_count;
+
+#define DEFINE_HOST_BARRIER_FUNC(_name)				\
+static inline void _name(void)					\
+{								\
+	__asm__ volatile ("" ::: "memory");			\
+}
+
+#define DEFINE_HOST_TLBI_FUNC(_type)				\
+static inline void tlbi ## _type(void)				\
+{								\
+	host_tlbi_count++;					\
+}
+
+#define DEFINE_HOST_TLBI_PARAM_FUNC(_type)			\
+static inline void tlbi ## _type(uint64_t v)			\
+{								\
+	(void)v;						\
+	host_tlbi_count++;					\
+}
+
+DEFINE_HOST_TLBI_FUNC(alle1)
+DEFINE_HOST_TLBI_FUNC(alle1is)
+DEFINE_HOST_TLBI_FUNC(alle3)
+DEFINE_HOST_TLBI_FUNC(alle3is)
+DEFINE_HOST_TLBI_FUNC(vmalle1)
+DEFINE_HOST_TLBI_FUNC(vmalle1is)
+DEFINE_HOST_TLBI_PARAM_FUNC(vaae1is)
+DEFINE_HOST_TLBI_PARAM_FUNC(vaale1is)
+DEFINE_HOST_TLBI_PARAM_FUNC(vae3is)
+DEFINE_HOST_TLBI_PARAM_FUNC(vale3is)
+
+DEFINE_HOST_BARRIER_FUNC(wfi)
+DEFINE_HOST_BARRIER_FUNC(wfe)
+DEFINE_HOST_BARRIER_FUNC(sev)
+DEFINE_HOST_BARRIER_FUNC(dsbsy)
+DEFINE_HOST_BARRIER_FUNC(dmbsy)
+DEFINE_HOST_BARRIER_FUNC(dmbst)
+DEFINE_HOST_BARRIER_FUNC(dmbld)
+DEFINE_HOST_BARRIER_FUNC(dsbish)
+DEFINE_HOST_BARRIER_FUNC(dsbishst)
+DEFINE_HOST_BARRIER_FUNC(dmbish)
+DEFINE_HOST_BARRIER_FUNC(isb)
+
+void flush_dcache_range(uintptr_t addr, size_t size);
+void clean_dcache_range(uintptr_t addr, size_t size);
+void inv_dcache_range(uintptr_t addr, size_t size);
+
+#define IS_IN_EL(x) \
+	(GET_EL(read_CurrentEl()) == MODE_EL##x)
+
+#define IS_IN_EL1() IS_IN_EL(1)
+#define IS_IN_EL3() IS_IN_EL(3)
+
+#define EL_IMPLEMENTED(el) \
+	((read_id_aa64pfr0_el1() >> ID_AA64PFR0_EL##el##_SHIFT) \
+		& ID_AA64PFR0_ELX_MASK)
+
+#define read_current_el()	read_CurrentEl()
+
+#define dsb()			dsbsy()
+
+#define read_mpidr()		read_mpidr_el1()
+
+#endif /* __ARCH_HELPERS_H__ */
@@ -0,0 +1,16 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host replacement of include/lib/stdlib/assert.h: the assertions are enabled
+ * by ENABLE_ASSERTIONS rather than by NDEBUG, as in the firmware.
+ */
+
+#if !ENABLE_ASSERTIONS && !defined(NDEBUG)
+#define NDEBUG
+#endif
+
+#include_next <assert.h>
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __HOST_CDEFS_H__
+#define __HOST_CDEFS_H__
+
+/*
+ * BSD definitions that the firmware gets from include/lib/stdlib/sys/cdefs.h
+ * and that the host C library does not provide. This header is included before
+ * any other one when building the firmware sources for the host.
+ */
+
+#include <sys/cdefs.h>
+
+#define	__dead2		__attribute__((__noreturn__))
+#define	__unused	__attribute__((__unused__))
+#define	__used		__attribute__((__used__))
+#define	__packed	__attribute__((__packed__))
+#define	__aligned(x)	__attribute__((__aligned__(x)))
+#define	__section(x)	__attribute__((__section__(x)))
+#define	__deprecated	__attribute__((__deprecated__))
+#define	__printflike(fmtarg, firstvararg) \
+	__attribute__((__format__ (__printf__, fmtarg, firstvararg)))
+
+#endif /* __HOST_CDEFS_H__ */
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __PLATFORM_DEF_H__
+#define __PLATFORM_DEF_H__
+
+#include <tbbr_img_def.h>
+
+/*
+ * Platform definitions used to build the firmware libraries for the host. The
+ * topology can be changed from the command line to benchmark the coordination
+ * of more or fewer CPUs.
+ */
+
+#ifndef BENCH_CLUSTER_COUNT
+#define BENCH_CLUSTER_COUNT		4
+#endif
+#ifndef BENCH_CLUSTER_CORE_COUNT
+#define BENCH_CLUSTER_CORE_COUNT	8
+#endif
+
+#define PLATFORM_CORE_COUNT		(BENCH_CLUSTER_COUNT * \
+					 BENCH_CLUSTER_CORE_COUNT)
+#define PLAT_NUM_PWR_DOMAINS		(PLATFORM_CORE_COUNT + \
+					 BENCH_CLUSTER_COUNT + 1)
+#define PLAT_MAX_PWR_LVL		2
+#define PLAT_MAX_RET_STATE		1
+#define PLAT_MAX_OFF_STATE		2
+
+#define CACHE_WRITEBACK_SHIFT		6
+#define CACHE_WRITEBACK_GRANULE		(1 << CACHE_WRITEBACK_SHIFT)
+
+#define PLAT_PHY_ADDR_SPACE_SIZE	(1ull << 32)
+#define PLAT_VIRT_ADDR_SPACE_SIZE	(1ull << 32)
+#define MAX_MMAP_REGIONS		300
+#define MAX_XLAT_TABLES			40
+#define PLAT_XLAT_TABLES_DYNAMIC	1
+
+#endif /* __PLATFORM_DEF_H__ */
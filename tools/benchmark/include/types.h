@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __HOST_TYPES_H__
+#define __HOST_TYPES_H__
+
+/* Host replacement of include/lib/stdlib/sys/types.h */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+typedef uintptr_t u_register_t;
+
+#endif /* __HOST_TYPES_H__ */
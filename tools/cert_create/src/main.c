@@ -7,11 +7,14 @@
 #include <assert.h>
 #include <ctype.h>
 #include <getopt.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include <openssl/conf.h>
+#include <openssl/crypto.h>
 #include <openssl/engine.h>
 #include <openssl/err.h>
 #include <openssl/pem.h>
@@ -71,6 +74,14 @@ static int key_alg;
 static int new_keys;
 static int save_keys;
 static int print_cert;
+static long num_jobs = 1;
+static const char *hash_cache;
+
+/* Hash algorithm of the image hashes in the certificate extensions */
+static const EVP_MD *md_info;
+
+/* Certificates whose issuer has been created */
+static unsigned int *ready_certs;
 
 /* Info messages created in the Makefile */
 extern const char build_msg[];
@@ -149,6 +160,121 @@ static int get_key_alg(const char *key_alg_str)
 	return -1;
 }
 
+static long get_num_jobs(const char *arg)
+{
+	char *endptr;
+	long n;
+
+	n = strtol(arg, &endptr, 0);
+	if ((*endptr != '\0') || (n < 0)) {
+		ERROR("Invalid number of jobs '%s'\n", arg);
+		exit(1);
+	}
+
+	if (n == 0) {
+		n = sysconf(_SC_NPROCESSORS_ONLN);
+		if (n < 1) {
+			n = 1;
+		}
+	}
+
+	return n;
+}
+
+/*
+ * OpenSSL 1.0 relies on the application to provide the locks that make it
+ * safe to use from several threads. More recent versions do their own
+ * locking.
+ */
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+static pthread_mutex_t *openssl_locks;
+
+static void openssl_lock(int mode, int n, const char *file, int line)
+{
+	if (mode & CRYPTO_LOCK) {
+		pthread_mutex_lock(&openssl_locks[n]);
+	} else {
+		pthread_mutex_unlock(&openssl_locks[n]);
+	}
+}
+
+static void openssl_thread_id(CRYPTO_THREADID *id)
+{
+	CRYPTO_THREADID_set_numeric(id, (unsigned long)pthread_self());
+}
+
+static void openssl_init_locks(void)
+{
+	int i;
+
+	CHECK_NULL(openssl_locks, malloc(CRYPTO_num_locks() *
+					 sizeof(*openssl_locks)));
+	for (i = 0; i < CRYPTO_num_locks(); i++) {
+		pthread_mutex_init(&openssl_locks[i], NULL);
+	}
+
+	CRYPTO_THREADID_set_callback(openssl_thread_id);
+	CRYPTO_set_locking_callback(openssl_lock);
+}
+#else
+static void openssl_init_locks(void)
+{
+}
+#endif
+
+/*
+ * Call 'fn' once for each index in [0, num), spread over up to 'num_jobs'
+ * threads, and wait for all the calls to finish.
+ */
+static void (*job_fn)(unsigned int idx);
+static unsigned int job_next, job_num;
+static pthread_mutex_t job_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void *job_thread(void *arg)
+{
+	unsigned int idx;
+
+	while (1) {
+		pthread_mutex_lock(&job_lock);
+		idx = job_next++;
+		pthread_mutex_unlock(&job_lock);
+		if (idx >= job_num) {
+			break;
+		}
+		job_fn(idx);
+	}
+
+	return NULL;
+}
+
+static void run_jobs(void (*fn)(unsigned int idx), unsigned int num)
+{
+	pthread_t *threads;
+	long i, num_threads;
+
+	job_fn = fn;
+	job_next = 0;
+	job_num = num;
+
+	num_threads = (num_jobs < num) ? num_jobs : num;
+	if (num_threads <= 1) {
+		job_thread(NULL);
+		return;
+	}
+
+	CHECK_NULL(threads, malloc(num_threads * sizeof(*threads)));
+	for (i = 0; i < num_threads; i++) {
+		if (pthread_create(&threads[i], NULL, job_thread, NULL) != 0) {
+			ERROR("Cannot create thread\n");
+			exit(1);
+		}
+	}
+	for (i = 0; i < num_threads; i++) {
+		pthread_join(threads[i], NULL);
+	}
+	free(threads);
+}
+
 static void check_cmd_params(void)
 {
 	cert_t *cert;
@@ -217,10 +343,19 @@ static void check_cmd_params(void)
 
 /* Common command line options */
 static const cmd_opt_t common_cmd_opt[] = {
+	{
+		{ "hash-cache", required_argument, NULL, 'c' },
+		"Reuse the image hashes saved in this file by a previous run"
+	},
 	{
 		{ "help", no_argument, NULL, 'h' },
 		"Print this message and exit"
 	},
+	{
+		{ "jobs", required_argument, NULL, 'j' },
+		"Number of keys and certificates created in parallel "
+		"(default: 1, 0: one per CPU)"
+	},
 	{
 		{ "key-alg", required_argument, NULL, 'a' },
 		"Key algorithm: 'rsa' (default), 'ecdsa'"
@@ -239,21 +374,146 @@ static const cmd_opt_t common_cmd_opt[] = {
 	}
 };
 
-int main(int argc, char *argv[])
+/* Load a private key from its file (or generate a new one) */
+static void load_key(unsigned int idx)
+{
+	key_t *key = &keys[idx];
+	unsigned int err_code;
+
+	if (!key_new(key)) {
+		ERROR("Failed to allocate key container\n");
+		exit(1);
+	}
+
+	/* First try to load the key from disk */
+	if (key_load(key, &err_code)) {
+		/* Key loaded successfully */
+		return;
+	}
+
+	/* Key not loaded. Check the error code */
+	if (err_code == KEY_ERR_LOAD) {
+		/* File exists, but it does not contain a valid private
+		 * key. Abort. */
+		ERROR("Error loading '%s'\n", key->fn);
+		exit(1);
+	}
+
+	/* File does not exist, could not be opened or no filename was
+	 * given */
+	if (new_keys) {
+		/* Try to create a new key */
+		NOTICE("Creating new key for '%s'\n", key->desc);
+		if (!key_create(key, key_alg)) {
+			ERROR("Error creating key '%s'\n", key->desc);
+			exit(1);
+		}
+	} else {
+		if (err_code == KEY_ERR_OPEN) {
+			ERROR("Error opening '%s'\n", key->fn);
+		} else {
+			ERROR("Key '%s' not specified\n", key->desc);
+		}
+		exit(1);
+	}
+}
+
+/* Build the extensions of a certificate and sign it */
+static void create_cert(unsigned int idx)
 {
 	STACK_OF(X509_EXTENSION) * sk;
 	X509_EXTENSION *cert_ext;
+	ext_t *ext;
+	cert_t *cert = &certs[idx];
+	int j, ext_nid, nvctr;
+	unsigned char md[SHA256_DIGEST_LENGTH];
+
+	/* Create a new stack of extensions. This stack will be used
+	 * to create the certificate */
+	CHECK_NULL(sk, sk_X509_EXTENSION_new_null());
+
+	for (j = 0 ; j < cert->num_ext ; j++) {
+
+		ext = &extensions[cert->ext[j]];
+
+		/* Get OpenSSL internal ID for this extension */
+		CHECK_OID(ext_nid, ext->oid);
+
+		/*
+		 * Three types of extensions are currently supported:
+		 *     - EXT_TYPE_NVCOUNTER
+		 *     - EXT_TYPE_HASH
+		 *     - EXT_TYPE_PKEY
+		 */
+		switch (ext->type) {
+		case EXT_TYPE_NVCOUNTER:
+			if (ext->arg) {
+				nvctr = atoi(ext->arg);
+				CHECK_NULL(cert_ext, ext_new_nvcounter(ext_nid,
+					EXT_CRIT, nvctr));
+			}
+			break;
+		case EXT_TYPE_HASH:
+			if (ext->arg == NULL) {
+				if (ext->optional) {
+					/* Include a hash filled with zeros */
+					memset(md, 0x0, SHA256_DIGEST_LENGTH);
+				} else {
+					/* Do not include this hash in the certificate */
+					break;
+				}
+			} else {
+				/* Calculate the hash of the file */
+				if (!sha_file(ext->arg, md)) {
+					ERROR("Cannot calculate hash of %s\n",
+						ext->arg);
+					exit(1);
+				}
+			}
+			CHECK_NULL(cert_ext, ext_new_hash(ext_nid,
+					EXT_CRIT, md_info, md,
+					SHA256_DIGEST_LENGTH));
+			break;
+		case EXT_TYPE_PKEY:
+			CHECK_NULL(cert_ext, ext_new_key(ext_nid,
+				EXT_CRIT, keys[ext->attr.key].key));
+			break;
+		default:
+			ERROR("Unknown extension type '%d' in %s\n",
+					ext->type, cert->cn);
+			exit(1);
+		}
+
+		/* Push the extension into the stack */
+		sk_X509_EXTENSION_push(sk, cert_ext);
+	}
+
+	/* Create certificate. Signed with ROT key */
+	if (cert->fn && !cert_new(cert, VAL_DAYS, 0, sk)) {
+		ERROR("Cannot create %s\n", cert->cn);
+		exit(1);
+	}
+
+	sk_X509_EXTENSION_free(sk);
+}
+
+static void create_ready_cert(unsigned int idx)
+{
+	create_cert(ready_certs[idx]);
+}
+
+int main(int argc, char *argv[])
+{
 	ext_t *ext;
 	key_t *key;
 	cert_t *cert;
 	FILE *file;
-	int i, j, ext_nid, nvctr;
+	int i;
 	int c, opt_idx = 0;
 	const struct option *cmd_opt;
 	const char *cur_opt;
-	unsigned int err_code;
-	unsigned char md[SHA256_DIGEST_LENGTH];
-	const EVP_MD *md_info;
+	char *cert_done;
+	unsigned int num_done, num_ready;
 
 	NOTICE("CoT Generation Tool: %s\n", build_msg);
 	NOTICE("Target platform: %s\n", platform_msg);
@@ -289,7 +549,7 @@ int main(int argc, char *argv[])
 
 	while (1) {
 		/* getopt_long stores the option index here. */
-		c = getopt_long(argc, argv, "a:hknp", cmd_opt, &opt_idx);
+		c = getopt_long(argc, argv, "a:c:hj:knp", cmd_opt, &opt_idx);
 
 		/* Detect the end of the options. */
 		if (c == -1) {
@@ -304,9 +564,15 @@ int main(int argc, char *argv[])
 				exit(1);
 			}
 			break;
+		case 'c':
+			hash_cache = optarg;
+			break;
 		case 'h':
 			print_help(argv[0], cmd_opt);
 			break;
+		case 'j':
+			num_jobs = get_num_jobs(optarg);
+			break;
 		case 'k':
 			save_keys = 1;
 			break;
@@ -345,120 +611,43 @@ int main(int argc, char *argv[])
 	 * extension */
 	md_info = EVP_sha256();
 
-	/* Load private keys from files (or generate new ones) */
-	for (i = 0 ; i < num_keys ; i++) {
-		if (!key_new(&keys[i])) {
-			ERROR("Failed to allocate key container\n");
-			exit(1);
-		}
-
-		/* First try to load the key from disk */
-		if (key_load(&keys[i], &err_code)) {
-			/* Key loaded successfully */
-			continue;
-		}
-
-		/* Key not loaded. Check the error code */
-		if (err_code == KEY_ERR_LOAD) {
-			/* File exists, but it does not contain a valid private
-			 * key. Abort. */
-			ERROR("Error loading '%s'\n", keys[i].fn);
-			exit(1);
-		}
-
-		/* File does not exist, could not be opened or no filename was
-		 * given */
-		if (new_keys) {
-			/* Try to create a new key */
-			NOTICE("Creating new key for '%s'\n", keys[i].desc);
-			if (!key_create(&keys[i], key_alg)) {
-				ERROR("Error creating key '%s'\n", keys[i].desc);
-				exit(1);
-			}
-		} else {
-			if (err_code == KEY_ERR_OPEN) {
-				ERROR("Error opening '%s'\n", keys[i].fn);
-			} else {
-				ERROR("Key '%s' not specified\n", keys[i].desc);
-			}
-			exit(1);
-		}
+	if (hash_cache && !sha_cache_load(hash_cache)) {
+		ERROR("Cannot load %s\n", hash_cache);
+		exit(1);
 	}
 
-	/* Create the certificates */
-	for (i = 0 ; i < num_certs ; i++) {
-
-		cert = &certs[i];
-
-		/* Create a new stack of extensions. This stack will be used
-		 * to create the certificate */
-		CHECK_NULL(sk, sk_X509_EXTENSION_new_null());
-
-		for (j = 0 ; j < cert->num_ext ; j++) {
-
-			ext = &extensions[cert->ext[j]];
-
-			/* Get OpenSSL internal ID for this extension */
-			CHECK_OID(ext_nid, ext->oid);
+	openssl_init_locks();
 
-			/*
-			 * Three types of extensions are currently supported:
-			 *     - EXT_TYPE_NVCOUNTER
-			 *     - EXT_TYPE_HASH
-			 *     - EXT_TYPE_PKEY
-			 */
-			switch (ext->type) {
-			case EXT_TYPE_NVCOUNTER:
-				if (ext->arg) {
-					nvctr = atoi(ext->arg);
-					CHECK_NULL(cert_ext, ext_new_nvcounter(ext_nid,
-						EXT_CRIT, nvctr));
-				}
-				break;
-			case EXT_TYPE_HASH:
-				if (ext->arg == NULL) {
-					if (ext->optional) {
-						/* Include a hash filled with zeros */
-						memset(md, 0x0, SHA256_DIGEST_LENGTH);
-					} else {
-						/* Do not include this hash in the certificate */
-						break;
-					}
-				} else {
-					/* Calculate the hash of the file */
-					if (!sha_file(ext->arg, md)) {
-						ERROR("Cannot calculate hash of %s\n",
-							ext->arg);
-						exit(1);
-					}
-				}
-				CHECK_NULL(cert_ext, ext_new_hash(ext_nid,
-						EXT_CRIT, md_info, md,
-						SHA256_DIGEST_LENGTH));
-				break;
-			case EXT_TYPE_PKEY:
-				CHECK_NULL(cert_ext, ext_new_key(ext_nid,
-					EXT_CRIT, keys[ext->attr.key].key));
-				break;
-			default:
-				ERROR("Unknown extension type '%d' in %s\n",
-						ext->type, cert->cn);
-				exit(1);
+	/* Load private keys from files (or generate new ones) */
+	run_jobs(load_key, num_keys);
+
+	/*
+	 * Create the certificates. A certificate signed by another one is
+	 * created after its issuer, so the certificates are created in rounds
+	 * of those whose issuer has been created.
+	 */
+	CHECK_NULL(cert_done, calloc(num_certs, sizeof(*cert_done)));
+	CHECK_NULL(ready_certs, malloc(num_certs * sizeof(*ready_certs)));
+	for (num_done = 0; num_done < num_certs; num_done += num_ready) {
+		num_ready = 0;
+		for (i = 0; i < num_certs; i++) {
+			if (!cert_done[i] &&
+			    ((certs[i].issuer == i) ||
+			     cert_done[certs[i].issuer])) {
+				ready_certs[num_ready++] = i;
 			}
-
-			/* Push the extension into the stack */
-			sk_X509_EXTENSION_push(sk, cert_ext);
 		}
-
-		/* Create certificate. Signed with ROT key */
-		if (cert->fn && !cert_new(cert, VAL_DAYS, 0, sk)) {
-			ERROR("Cannot create %s\n", cert->cn);
+		if (num_ready == 0) {
+			ERROR("Circular chain of certificate issuers\n");
 			exit(1);
 		}
-
-		sk_X509_EXTENSION_free(sk);
+		run_jobs(create_ready_cert, num_ready);
+		for (i = 0; i < num_ready; i++) {
+			cert_done[ready_certs[i]] = 1;
+		}
 	}
-
+	free(ready_certs);
+	free(cert_done);
 
 	/* Print the certificates */
 	if (print_cert) {
@@ -493,6 +682,11 @@ int main(int argc, char *argv[])
 		}
 	}
 
+	/* Save the image hashes for the next run */
+	if (hash_cache) {
+		sha_cache_save(hash_cache);
+	}
+
 #ifndef OPENSSL_NO_ENGINE
 	ENGINE_cleanup();
 #endif
@@ -1,20 +1,111 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+/* Required for the nanoseconds of the file modification time */
+#define _XOPEN_SOURCE 700
+
+#include <pthread.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
 #include <openssl/sha.h>
 
 #include "debug.h"
+#include "sha.h"
 
 #define BUFFER_SIZE	256
+#define CACHE_LINE_SIZE	4224
+
+/*
+ * Entry of the cache of image hashes. The hash of a file is reused as long as
+ * its size and modification time have not changed.
+ */
+typedef struct sha_cache_entry_s {
+	char *fn;
+	off_t size;
+	struct timespec mtime;
+	unsigned char md[SHA256_DIGEST_LENGTH];
+	int used;		/* Hash of an image of this run */
+} sha_cache_entry_t;
+
+static sha_cache_entry_t *sha_cache;
+static unsigned int sha_cache_num;
+static int sha_cache_enabled;
+static time_t sha_cache_time;
+static pthread_mutex_t sha_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static sha_cache_entry_t *sha_cache_lookup(const char *filename)
+{
+	unsigned int i;
+
+	for (i = 0; i < sha_cache_num; i++) {
+		if (strcmp(sha_cache[i].fn, filename) == 0) {
+			return &sha_cache[i];
+		}
+	}
+
+	return NULL;
+}
+
+static int sha_cache_add(const char *filename, const struct stat *st,
+			 const unsigned char *md)
+{
+	sha_cache_entry_t *entry, *cache;
+
+	entry = sha_cache_lookup(filename);
+	if (entry == NULL) {
+		cache = realloc(sha_cache,
+				(sha_cache_num + 1) * sizeof(*cache));
+		if (cache == NULL) {
+			return 0;
+		}
+		sha_cache = cache;
+		entry = &sha_cache[sha_cache_num];
+		entry->fn = strdup(filename);
+		if (entry->fn == NULL) {
+			return 0;
+		}
+		entry->used = 0;
+		sha_cache_num++;
+	}
+
+	entry->size = st->st_size;
+	entry->mtime = st->st_mtim;
+	memcpy(entry->md, md, SHA256_DIGEST_LENGTH);
+
+	return 1;
+}
+
+static int sha_cache_get(const char *filename, const struct stat *st,
+			 unsigned char *md)
+{
+	sha_cache_entry_t *entry;
+	int found = 0;
+
+	pthread_mutex_lock(&sha_cache_lock);
+	entry = sha_cache_lookup(filename);
+	if ((entry != NULL) && (entry->size == st->st_size) &&
+	    (entry->mtime.tv_sec == st->st_mtim.tv_sec) &&
+	    (entry->mtime.tv_nsec == st->st_mtim.tv_nsec)) {
+		memcpy(md, entry->md, SHA256_DIGEST_LENGTH);
+		entry->used = 1;
+		found = 1;
+	}
+	pthread_mutex_unlock(&sha_cache_lock);
+
+	return found;
+}
 
 int sha_file(const char *filename, unsigned char *md)
 {
 	FILE *inFile;
 	SHA256_CTX shaContext;
+	struct stat st;
 	int bytes;
 	unsigned char data[BUFFER_SIZE];
 
@@ -29,6 +120,19 @@ int sha_file(const char *filename, unsigned char *md)
 		return 0;
 	}
 
+	if (sha_cache_enabled) {
+		if (fstat(fileno(inFile), &st) != 0) {
+			ERROR("Cannot stat %s\n", filename);
+			fclose(inFile);
+			return 0;
+		}
+		if (sha_cache_get(filename, &st, md)) {
+			VERBOSE("Reusing the hash of %s\n", filename);
+			fclose(inFile);
+			return 1;
+		}
+	}
+
 	SHA256_Init(&shaContext);
 	while ((bytes = fread(data, 1, BUFFER_SIZE, inFile)) != 0) {
 		SHA256_Update(&shaContext, data, bytes);
@@ -36,5 +140,136 @@ int sha_file(const char *filename, unsigned char *md)
 	SHA256_Final(md, &shaContext);
 
 	fclose(inFile);
+
+	/*
+	 * A file modified in the same second as the cache is loaded may be
+	 * modified again afterwards without its modification time changing
+	 * on filesystems with coarse timestamps, so it is not cached.
+	 */
+	if (sha_cache_enabled && (st.st_mtim.tv_sec < sha_cache_time)) {
+		pthread_mutex_lock(&sha_cache_lock);
+		if (sha_cache_add(filename, &st, md)) {
+			sha_cache_lookup(filename)->used = 1;
+		} else {
+			WARN("Cannot cache the hash of %s\n", filename);
+		}
+		pthread_mutex_unlock(&sha_cache_lock);
+	}
+
+	return 1;
+}
+
+/*
+ * Load the cache of image hashes from a file. Each line contains a hash, the
+ * size and modification time of the file it was calculated from, and the
+ * name of that file. A missing file results in an empty cache.
+ */
+int sha_cache_load(const char *filename)
+{
+	FILE *fp;
+	char line[CACHE_LINE_SIZE];
+	char hex[2 * SHA256_DIGEST_LENGTH + 1];
+	unsigned char md[SHA256_DIGEST_LENGTH];
+	unsigned int byte;
+	long long size, sec;
+	long nsec;
+	struct stat st;
+	int i, n;
+	char *fn;
+
+	sha_cache_enabled = 1;
+	sha_cache_time = time(NULL);
+
+	fp = fopen(filename, "r");
+	if (fp == NULL) {
+		return 1;
+	}
+
+	while (fgets(line, sizeof(line), fp) != NULL) {
+		fn = strchr(line, '\n');
+		if (fn == NULL) {
+			break;
+		}
+		*fn = '\0';
+
+		if ((sscanf(line, "%64s %lld %lld %ld %n", hex, &size, &sec,
+			    &nsec, &n) != 4) ||
+		    (strlen(hex) != 2 * SHA256_DIGEST_LENGTH) ||
+		    (line[n] == '\0')) {
+			break;
+		}
+		for (i = 0; i < SHA256_DIGEST_LENGTH; i++) {
+			if (sscanf(&hex[2 * i], "%2x", &byte) != 1) {
+				break;
+			}
+			md[i] = byte;
+		}
+		if (i != SHA256_DIGEST_LENGTH) {
+			break;
+		}
+
+		memset(&st, 0, sizeof(st));
+		st.st_size = size;
+		st.st_mtim.tv_sec = sec;
+		st.st_mtim.tv_nsec = nsec;
+		if (!sha_cache_add(&line[n], &st, md)) {
+			fclose(fp);
+			return 0;
+		}
+	}
+
+	if (!feof(fp)) {
+		WARN("Ignoring the rest of the hash cache %s\n", filename);
+	}
+
+	fclose(fp);
 	return 1;
 }
+
+/*
+ * Save the hashes of the images of this run, replacing the previous cache
+ * file atomically.
+ */
+int sha_cache_save(const char *filename)
+{
+	FILE *fp;
+	char *tmp;
+	unsigned int i;
+	int j, rc = 0;
+
+	tmp = malloc(strlen(filename) + sizeof(".tmp"));
+	if (tmp == NULL) {
+		return 0;
+	}
+	sprintf(tmp, "%s.tmp", filename);
+
+	fp = fopen(tmp, "w");
+	if (fp == NULL) {
+		ERROR("Cannot create file %s\n", tmp);
+		free(tmp);
+		return 0;
+	}
+
+	for (i = 0; i < sha_cache_num; i++) {
+		if (!sha_cache[i].used) {
+			continue;
+		}
+		for (j = 0; j < SHA256_DIGEST_LENGTH; j++) {
+			fprintf(fp, "%02x", sha_cache[i].md[j]);
+		}
+		fprintf(fp, " %lld %lld %ld %s\n",
+			(long long)sha_cache[i].size,
+			(long long)sha_cache[i].mtime.tv_sec,
+			(long)sha_cache[i].mtime.tv_nsec, sha_cache[i].fn);
+	}
+
+	if ((fclose(fp) == 0) && (rename(tmp, filename) == 0)) {
+		rc = 1;
+	} else {
+		ERROR("Cannot save %s\n", filename);
+		remove(tmp);
+	}
+
+	free(tmp);
+	return rc;
+}
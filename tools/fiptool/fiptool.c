@@ -11,15 +11,12 @@
 #include <errno.h>
 #include <getopt.h>
 #include <limits.h>
-#include <stdarg.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
-#include <openssl/sha.h>
-
 #include <firmware_image_package.h>
 
 #include "fiptool.h"
@@ -28,6 +25,10 @@
 #define OPT_TOC_ENTRY 0
 #define OPT_PLAT_TOC_FLAGS 1
 #define OPT_ALIGN 2
+#define OPT_COMPRESS 3
+#define OPT_SLACK 4
+#define OPT_IN_PLACE 5
+#define OPT_OPS 6
 
 static int info_cmd(int argc, char *argv[]);
 static void info_usage(void);
@@ -39,6 +40,8 @@ static int unpack_cmd(int argc, char *argv[]);
 static void unpack_usage(void);
 static int remove_cmd(int argc, char *argv[]);
 static void remove_usage(void);
+static int batch_cmd(int argc, char *argv[]);
+static void batch_usage(void);
 static int version_cmd(int argc, char *argv[]);
 static void version_usage(void);
 static int help_cmd(int argc, char *argv[]);
@@ -51,367 +54,20 @@ static cmd_t cmds[] = {
 	{ .name = "update",  .handler = update_cmd,  .usage = update_usage  },
 	{ .name = "unpack",  .handler = unpack_cmd,  .usage = unpack_usage  },
 	{ .name = "remove",  .handler = remove_cmd,  .usage = remove_usage  },
+	{ .name = "batch",   .handler = batch_cmd,   .usage = batch_usage   },
 	{ .name = "version", .handler = version_cmd, .usage = version_usage },
 	{ .name = "help",    .handler = help_cmd,    .usage = NULL          },
 };
 
-static image_desc_t *image_desc_head;
-static size_t nr_image_descs;
 static uuid_t uuid_null = { 0 };
 static int verbose;
 
-static void vlog(int prio, const char *msg, va_list ap)
-{
-	char *prefix[] = { "DEBUG", "WARN", "ERROR" };
-
-	fprintf(stderr, "%s: ", prefix[prio]);
-	vfprintf(stderr, msg, ap);
-	fputc('\n', stderr);
-}
-
-static void log_dbgx(const char *msg, ...)
-{
-	va_list ap;
-
-	va_start(ap, msg);
-	vlog(LOG_DBG, msg, ap);
-	va_end(ap);
-}
-
-static void log_warnx(const char *msg, ...)
-{
-	va_list ap;
-
-	va_start(ap, msg);
-	vlog(LOG_WARN, msg, ap);
-	va_end(ap);
-}
-
-static void log_err(const char *msg, ...)
-{
-	char buf[512];
-	va_list ap;
-
-	va_start(ap, msg);
-	snprintf(buf, sizeof(buf), "%s: %s", msg, strerror(errno));
-	vlog(LOG_ERR, buf, ap);
-	va_end(ap);
-	exit(1);
-}
-
-static void log_errx(const char *msg, ...)
-{
-	va_list ap;
-
-	va_start(ap, msg);
-	vlog(LOG_ERR, msg, ap);
-	va_end(ap);
-	exit(1);
-}
-
-static char *xstrdup(const char *s, const char *msg)
-{
-	char *d;
-
-	d = strdup(s);
-	if (d == NULL)
-		log_errx("strdup: %s", msg);
-	return d;
-}
-
-static void *xmalloc(size_t size, const char *msg)
-{
-	void *d;
-
-	d = malloc(size);
-	if (d == NULL)
-		log_errx("malloc: %s", msg);
-	return d;
-}
-
-static void *xzalloc(size_t size, const char *msg)
-{
-	return memset(xmalloc(size, msg), 0, size);
-}
-
-static void xfwrite(void *buf, size_t size, FILE *fp, const char *filename)
-{
-	if (fwrite(buf, 1, size, fp) != size)
-		log_errx("Failed to write %s", filename);
-}
-
-static image_desc_t *new_image_desc(const uuid_t *uuid,
-    const char *name, const char *cmdline_name)
-{
-	image_desc_t *desc;
-
-	desc = xzalloc(sizeof(*desc),
-	    "failed to allocate memory for image descriptor");
-	memcpy(&desc->uuid, uuid, sizeof(uuid_t));
-	desc->name = xstrdup(name,
-	    "failed to allocate memory for image name");
-	desc->cmdline_name = xstrdup(cmdline_name,
-	    "failed to allocate memory for image command line name");
-	desc->action = DO_UNSPEC;
-	return desc;
-}
-
-static void set_image_desc_action(image_desc_t *desc, int action,
-    const char *arg)
-{
-	assert(desc != NULL);
-
-	if (desc->action_arg != DO_UNSPEC)
-		free(desc->action_arg);
-	desc->action = action;
-	desc->action_arg = NULL;
-	if (arg != NULL)
-		desc->action_arg = xstrdup(arg,
-		    "failed to allocate memory for argument");
-}
-
-static void free_image_desc(image_desc_t *desc)
-{
-	free(desc->name);
-	free(desc->cmdline_name);
-	free(desc->action_arg);
-	free(desc->image);
-	free(desc);
-}
-
-static void add_image_desc(image_desc_t *desc)
-{
-	image_desc_t **p = &image_desc_head;
-
-	while (*p)
-		p = &(*p)->next;
-
-	assert(*p == NULL);
-	*p = desc;
-	nr_image_descs++;
-}
-
-static void free_image_descs(void)
-{
-	image_desc_t *desc = image_desc_head, *tmp;
-
-	while (desc != NULL) {
-		tmp = desc->next;
-		free_image_desc(desc);
-		desc = tmp;
-		nr_image_descs--;
-	}
-	assert(nr_image_descs == 0);
-}
-
-static void fill_image_descs(void)
-{
-	toc_entry_t *toc_entry;
-
-	for (toc_entry = toc_entries;
-	     toc_entry->cmdline_name != NULL;
-	     toc_entry++) {
-		image_desc_t *desc;
-
-		desc = new_image_desc(&toc_entry->uuid,
-		    toc_entry->name,
-		    toc_entry->cmdline_name);
-		add_image_desc(desc);
-	}
-}
-
-static image_desc_t *lookup_image_desc_from_uuid(const uuid_t *uuid)
-{
-	image_desc_t *desc;
-
-	for (desc = image_desc_head; desc != NULL; desc = desc->next)
-		if (memcmp(&desc->uuid, uuid, sizeof(uuid_t)) == 0)
-			return desc;
-	return NULL;
-}
-
-static image_desc_t *lookup_image_desc_from_opt(const char *opt)
-{
-	image_desc_t *desc;
-
-	for (desc = image_desc_head; desc != NULL; desc = desc->next)
-		if (strcmp(desc->cmdline_name, opt) == 0)
-			return desc;
-	return NULL;
-}
-
-static void uuid_to_str(char *s, size_t len, const uuid_t *u)
-{
-	assert(len >= (_UUID_STR_LEN + 1));
-
-	snprintf(s, len, "%08X-%04X-%04X-%04X-%04X%04X%04X",
-	    u->time_low,
-	    u->time_mid,
-	    u->time_hi_and_version,
-	    ((uint16_t)u->clock_seq_hi_and_reserved << 8) | u->clock_seq_low,
-	    ((uint16_t)u->node[0] << 8) | u->node[1],
-	    ((uint16_t)u->node[2] << 8) | u->node[3],
-	    ((uint16_t)u->node[4] << 8) | u->node[5]);
-}
-
-static void uuid_from_str(uuid_t *u, const char *s)
-{
-	int n;
-
-	if (s == NULL)
-		log_errx("UUID cannot be NULL");
-	if (strlen(s) != _UUID_STR_LEN)
-		log_errx("Invalid UUID: %s", s);
-
-	n = sscanf(s,
-	    "%8x-%4hx-%4hx-%2hhx%2hhx-%2hhx%2hhx%2hhx%2hhx%2hhx%2hhx",
-	    &u->time_low, &u->time_mid, &u->time_hi_and_version,
-	    &u->clock_seq_hi_and_reserved, &u->clock_seq_low, &u->node[0],
-	    &u->node[1], &u->node[2], &u->node[3], &u->node[4], &u->node[5]);
-	/*
-	 * Given the format specifier above, we expect 11 items to be scanned
-	 * for a properly formatted UUID.
-	 */
-	if (n != 11)
-		log_errx("Invalid UUID: %s", s);
-}
-
-static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
-{
-	struct stat st;
-	FILE *fp;
-	char *buf, *bufend;
-	fip_toc_header_t *toc_header;
-	fip_toc_entry_t *toc_entry;
-	int terminated = 0;
-
-	fp = fopen(filename, "r");
-	if (fp == NULL)
-		log_err("fopen %s", filename);
-
-	if (fstat(fileno(fp), &st) == -1)
-		log_err("fstat %s", filename);
-
-	buf = xmalloc(st.st_size, "failed to load file into memory");
-	if (fread(buf, 1, st.st_size, fp) != st.st_size)
-		log_errx("Failed to read %s", filename);
-	bufend = buf + st.st_size;
-	fclose(fp);
-
-	if (st.st_size < sizeof(fip_toc_header_t))
-		log_errx("FIP %s is truncated", filename);
-
-	toc_header = (fip_toc_header_t *)buf;
-	toc_entry = (fip_toc_entry_t *)(toc_header + 1);
-
-	if (toc_header->name != TOC_HEADER_NAME)
-		log_errx("%s is not a FIP file", filename);
-
-	/* Return the ToC header if the caller wants it. */
-	if (toc_header_out != NULL)
-		*toc_header_out = *toc_header;
-
-	/* Walk through each ToC entry in the file. */
-	while ((char *)toc_entry + sizeof(*toc_entry) - 1 < bufend) {
-		image_t *image;
-		image_desc_t *desc;
-
-		/* Found the ToC terminator, we are done. */
-		if (memcmp(&toc_entry->uuid, &uuid_null, sizeof(uuid_t)) == 0) {
-			terminated = 1;
-			break;
-		}
-
-		/*
-		 * Build a new image out of the ToC entry and add it to the
-		 * table of images.
-		 */
-		image = xzalloc(sizeof(*image),
-		    "failed to allocate memory for image");
-		image->toc_e = *toc_entry;
-		image->buffer = xmalloc(toc_entry->size,
-		    "failed to allocate image buffer, is FIP file corrupted?");
-		/* Overflow checks before memory copy. */
-		if (toc_entry->size > (uint64_t)-1 - toc_entry->offset_address)
-			log_errx("FIP %s is corrupted", filename);
-		if (toc_entry->size + toc_entry->offset_address > st.st_size)
-			log_errx("FIP %s is corrupted", filename);
-
-		memcpy(image->buffer, buf + toc_entry->offset_address,
-		    toc_entry->size);
-
-		/* If this is an unknown image, create a descriptor for it. */
-		desc = lookup_image_desc_from_uuid(&toc_entry->uuid);
-		if (desc == NULL) {
-			char name[_UUID_STR_LEN + 1], filename[PATH_MAX];
-
-			uuid_to_str(name, sizeof(name), &toc_entry->uuid);
-			snprintf(filename, sizeof(filename), "%s%s",
-			    name, ".bin");
-			desc = new_image_desc(&toc_entry->uuid, name, "blob");
-			desc->action = DO_UNPACK;
-			desc->action_arg = xstrdup(filename,
-			    "failed to allocate memory for blob filename");
-			add_image_desc(desc);
-		}
-
-		assert(desc->image == NULL);
-		desc->image = image;
-
-		toc_entry++;
-	}
-
-	if (terminated == 0)
-		log_errx("FIP %s does not have a ToC terminator entry",
-		    filename);
-	free(buf);
-	return 0;
-}
-
-static image_t *read_image_from_file(const uuid_t *uuid, const char *filename)
-{
-	struct stat st;
-	image_t *image;
-	FILE *fp;
-
-	assert(uuid != NULL);
-
-	fp = fopen(filename, "r");
-	if (fp == NULL)
-		log_err("fopen %s", filename);
-
-	if (fstat(fileno(fp), &st) == -1)
-		log_errx("fstat %s", filename);
-
-	image = xzalloc(sizeof(*image), "failed to allocate memory for image");
-	image->toc_e.uuid = *uuid;
-	image->buffer = xmalloc(st.st_size, "failed to allocate image buffer");
-	if (fread(image->buffer, 1, st.st_size, fp) != st.st_size)
-		log_errx("Failed to read %s", filename);
-	image->toc_e.size = st.st_size;
-
-	fclose(fp);
-	return image;
-}
-
-static int write_image_to_file(const image_t *image, const char *filename)
-{
-	FILE *fp;
-
-	fp = fopen(filename, "w");
-	if (fp == NULL)
-		log_err("fopen");
-	xfwrite(image->buffer, image->toc_e.size, fp, filename);
-	fclose(fp);
-	return 0;
-}
-
 static struct option *add_opt(struct option *opts, size_t *nr_opts,
     const char *name, int has_arg, int val)
 {
 	opts = realloc(opts, (*nr_opts + 1) * sizeof(*opts));
 	if (opts == NULL)
-		log_err("realloc");
+		fip_log_err("realloc");
 	opts[*nr_opts].name = name;
 	opts[*nr_opts].has_arg = has_arg;
 	opts[*nr_opts].flag = NULL;
@@ -425,7 +81,7 @@ static struct option *fill_common_opts(struct option *opts, size_t *nr_opts,
 {
 	image_desc_t *desc;
 
-	for (desc = image_desc_head; desc != NULL; desc = desc->next)
+	for (desc = fip_image_descs(); desc != NULL; desc = desc->next)
 		opts = add_opt(opts, nr_opts, desc->cmdline_name, has_arg,
 		    OPT_TOC_ENTRY);
 	return opts;
@@ -448,18 +104,20 @@ static int info_cmd(int argc, char *argv[])
 		info_usage();
 	argc--, argv++;
 
-	parse_fip(argv[0], &toc_header);
+	fip_parse(argv[0], &toc_header);
 
 	if (verbose) {
-		log_dbgx("toc_header[name]: 0x%llX",
+		fip_log_dbgx("toc_header[name]: 0x%llX",
 		    (unsigned long long)toc_header.name);
-		log_dbgx("toc_header[serial_number]: 0x%llX",
+		fip_log_dbgx("toc_header[serial_number]: 0x%llX",
 		    (unsigned long long)toc_header.serial_number);
-		log_dbgx("toc_header[flags]: 0x%llX",
+		fip_log_dbgx("toc_header[flags]: 0x%llX",
 		    (unsigned long long)toc_header.flags);
+
+		fip_hash_images();
 	}
 
-	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+	for (desc = fip_image_descs(); desc != NULL; desc = desc->next) {
 		image_t *image = desc->image;
 
 		if (image == NULL)
@@ -469,12 +127,11 @@ static int info_cmd(int argc, char *argv[])
 		       (unsigned long long)image->toc_e.offset_address,
 		       (unsigned long long)image->toc_e.size,
 		       desc->cmdline_name);
+		if (image->toc_e.flags & TOC_ENTRY_FLAG_LZ4)
+			printf(", compressed=lz4");
 		if (verbose) {
-			unsigned char md[SHA256_DIGEST_LENGTH];
-
-			SHA256(image->buffer, image->toc_e.size, md);
 			printf(", sha256=");
-			md_print(md, sizeof(md));
+			md_print(image->md, sizeof(image->md));
 		}
 		putchar('\n');
 	}
@@ -488,117 +145,6 @@ static void info_usage(void)
 	exit(1);
 }
 
-static int pack_images(const char *filename, uint64_t toc_flags, unsigned long align)
-{
-	FILE *fp;
-	image_desc_t *desc;
-	fip_toc_header_t *toc_header;
-	fip_toc_entry_t *toc_entry;
-	char *buf;
-	uint64_t entry_offset, buf_size, payload_size = 0;
-	size_t nr_images = 0;
-
-	for (desc = image_desc_head; desc != NULL; desc = desc->next)
-		if (desc->image != NULL)
-			nr_images++;
-
-	buf_size = sizeof(fip_toc_header_t) +
-	    sizeof(fip_toc_entry_t) * (nr_images + 1);
-	buf = calloc(1, buf_size);
-	if (buf == NULL)
-		log_err("calloc");
-
-	/* Build up header and ToC entries from the image table. */
-	toc_header = (fip_toc_header_t *)buf;
-	toc_header->name = TOC_HEADER_NAME;
-	toc_header->serial_number = TOC_HEADER_SERIAL_NUMBER;
-	toc_header->flags = toc_flags;
-
-	toc_entry = (fip_toc_entry_t *)(toc_header + 1);
-
-	entry_offset = buf_size;
-	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
-		image_t *image = desc->image;
-
-		if (image == NULL)
-			continue;
-		payload_size += image->toc_e.size;
-		entry_offset = (entry_offset + align - 1) & ~(align - 1);
-		image->toc_e.offset_address = entry_offset;
-		*toc_entry++ = image->toc_e;
-		entry_offset += image->toc_e.size;
-	}
-
-	/* Append a null uuid entry to mark the end of ToC entries. */
-	memset(toc_entry, 0, sizeof(*toc_entry));
-	toc_entry->offset_address = entry_offset;
-
-	/* Generate the FIP file. */
-	fp = fopen(filename, "w");
-	if (fp == NULL)
-		log_err("fopen %s", filename);
-
-	if (verbose)
-		log_dbgx("Metadata size: %zu bytes", buf_size);
-
-	xfwrite(buf, buf_size, fp, filename);
-	free(buf);
-
-	if (verbose)
-		log_dbgx("Payload size: %zu bytes", payload_size);
-
-	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
-		image_t *image = desc->image;
-
-		if (image == NULL)
-			continue;
-		if (fseek(fp, image->toc_e.offset_address, SEEK_SET))
-			log_errx("Failed to set file position");
-
-		xfwrite(image->buffer, image->toc_e.size, fp, filename);
-	}
-
-	fclose(fp);
-	return 0;
-}
-
-/*
- * This function is shared between the create and update subcommands.
- * The difference between the two subcommands is that when the FIP file
- * is created, the parsing of an existing FIP is skipped.  This results
- * in update_fip() creating the new FIP file from scratch because the
- * internal image table is not populated.
- */
-static void update_fip(void)
-{
-	image_desc_t *desc;
-
-	/* Add or replace images in the FIP file. */
-	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
-		image_t *image;
-
-		if (desc->action != DO_PACK)
-			continue;
-
-		image = read_image_from_file(&desc->uuid,
-		    desc->action_arg);
-		if (desc->image != NULL) {
-			if (verbose) {
-				log_dbgx("Replacing %s with %s",
-				    desc->cmdline_name,
-				    desc->action_arg);
-			}
-			free(desc->image);
-			desc->image = image;
-		} else {
-			if (verbose)
-				log_dbgx("Adding image %s",
-				    desc->action_arg);
-			desc->image = image;
-		}
-	}
-}
-
 static void parse_plat_toc_flags(const char *arg, unsigned long long *toc_flags)
 {
 	unsigned long long flags;
@@ -607,7 +153,7 @@ static void parse_plat_toc_flags(const char *arg, unsigned long long *toc_flags)
 	errno = 0;
 	flags = strtoull(arg, &endptr, 16);
 	if (*endptr != '\0' || flags > UINT16_MAX || errno != 0)
-		log_errx("Invalid platform ToC flags: %s", arg);
+		fip_log_errx("Invalid platform ToC flags: %s", arg);
 	/* Platform ToC flags is a 16-bit field occupying bits [32-47]. */
 	*toc_flags |= flags << 32;
 }
@@ -625,11 +171,43 @@ static unsigned long get_image_align(char *arg)
 	errno = 0;
 	align = strtoul(arg, &endptr, 0);
 	if (*endptr != '\0' || !is_power_of_2(align) || errno != 0)
-		log_errx("Invalid alignment: %s", arg);
+		fip_log_errx("Invalid alignment: %s", arg);
 
 	return align;
 }
 
+static unsigned long get_image_slack(char *arg)
+{
+	char *endptr;
+	unsigned long slack;
+
+	errno = 0;
+	slack = strtoul(arg, &endptr, 0);
+	if (*endptr != '\0' || errno != 0)
+		fip_log_errx("Invalid slack: %s", arg);
+
+	return slack;
+}
+
+static long get_nr_jobs(const char *arg)
+{
+	char *endptr;
+	long n;
+
+	errno = 0;
+	n = strtol(arg, &endptr, 0);
+	if (*endptr != '\0' || n < 0 || errno != 0)
+		fip_log_errx("Invalid number of jobs: %s", arg);
+
+	if (n == 0) {
+		n = sysconf(_SC_NPROCESSORS_ONLN);
+		if (n < 1)
+			n = 1;
+	}
+
+	return n;
+}
+
 static void parse_blob_opt(char *arg, uuid_t *uuid, char *filename, size_t len)
 {
 	char *p;
@@ -637,7 +215,7 @@ static void parse_blob_opt(char *arg, uuid_t *uuid, char *filename, size_t len)
 	for (p = strtok(arg, ","); p != NULL; p = strtok(NULL, ",")) {
 		if (strncmp(p, "uuid=", strlen("uuid=")) == 0) {
 			p += strlen("uuid=");
-			uuid_from_str(uuid, p);
+			fip_uuid_from_str(uuid, p);
 		} else if (strncmp(p, "file=", strlen("file=")) == 0) {
 			p += strlen("file=");
 			snprintf(filename, len, "%s", p);
@@ -651,6 +229,8 @@ static int create_cmd(int argc, char *argv[])
 	size_t nr_opts = 0;
 	unsigned long long toc_flags = 0;
 	unsigned long align = 1;
+	unsigned long slack = 0;
+	int compress = 0;
 
 	if (argc < 2)
 		create_usage();
@@ -659,6 +239,8 @@ static int create_cmd(int argc, char *argv[])
 	opts = add_opt(opts, &nr_opts, "plat-toc-flags", required_argument,
 	    OPT_PLAT_TOC_FLAGS);
 	opts = add_opt(opts, &nr_opts, "align", required_argument, OPT_ALIGN);
+	opts = add_opt(opts, &nr_opts, "compress", no_argument, OPT_COMPRESS);
+	opts = add_opt(opts, &nr_opts, "slack", required_argument, OPT_SLACK);
 	opts = add_opt(opts, &nr_opts, "blob", required_argument, 'b');
 	opts = add_opt(opts, &nr_opts, NULL, 0, 0);
 
@@ -673,8 +255,8 @@ static int create_cmd(int argc, char *argv[])
 		case OPT_TOC_ENTRY: {
 			image_desc_t *desc;
 
-			desc = lookup_image_desc_from_opt(opts[opt_index].name);
-			set_image_desc_action(desc, DO_PACK, optarg);
+			desc = fip_image_desc_from_opt(opts[opt_index].name);
+			fip_set_image_desc_action(desc, DO_PACK, optarg);
 			break;
 		}
 		case OPT_PLAT_TOC_FLAGS:
@@ -683,6 +265,12 @@ static int create_cmd(int argc, char *argv[])
 		case OPT_ALIGN:
 			align = get_image_align(optarg);
 			break;
+		case OPT_COMPRESS:
+			compress = 1;
+			break;
+		case OPT_SLACK:
+			slack = get_image_slack(optarg);
+			break;
 		case 'b': {
 			char name[_UUID_STR_LEN + 1];
 			char filename[PATH_MAX] = { 0 };
@@ -696,13 +284,13 @@ static int create_cmd(int argc, char *argv[])
 			    filename[0] == '\0')
 				create_usage();
 
-			desc = lookup_image_desc_from_uuid(&uuid);
+			desc = fip_image_desc_from_uuid(&uuid);
 			if (desc == NULL) {
-				uuid_to_str(name, sizeof(name), &uuid);
-				desc = new_image_desc(&uuid, name, "blob");
-				add_image_desc(desc);
+				fip_uuid_to_str(name, sizeof(name), &uuid);
+				desc = fip_new_image_desc(&uuid, name, "blob");
+				fip_add_image_desc(desc);
 			}
-			set_image_desc_action(desc, DO_PACK, filename);
+			fip_set_image_desc_action(desc, DO_PACK, filename);
 			break;
 		}
 		default:
@@ -716,9 +304,9 @@ static int create_cmd(int argc, char *argv[])
 	if (argc == 0)
 		create_usage();
 
-	update_fip();
+	fip_read_images(compress);
 
-	pack_images(argv[0], toc_flags, align);
+	fip_pack(argv[0], toc_flags, align, slack);
 	return 0;
 }
 
@@ -731,7 +319,9 @@ static void create_usage(void)
 	printf("Options:\n");
 	printf("  --align <value>\t\tEach image is aligned to <value> (default: 1).\n");
 	printf("  --blob uuid=...,file=...\tAdd an image with the given UUID pointed to by file.\n");
+	printf("  --compress\t\t\tCompress the images with LZ4.\n");
 	printf("  --plat-toc-flags <value>\t16-bit platform specific flag field occupying bits 32-47 in 64-bit ToC header.\n");
+	printf("  --slack <value>\t\tReserve <value> bytes after each image for in-place updates (default: 0).\n");
 	printf("\n");
 	printf("Specific images are packed with the following options:\n");
 	for (; toc_entry->cmdline_name != NULL; toc_entry++)
@@ -748,6 +338,9 @@ static int update_cmd(int argc, char *argv[])
 	fip_toc_header_t toc_header = { 0 };
 	unsigned long long toc_flags = 0;
 	unsigned long align = 1;
+	unsigned long slack = 0;
+	int compress = 0;
+	int in_place = 0;
 	int pflag = 0;
 
 	if (argc < 2)
@@ -756,9 +349,12 @@ static int update_cmd(int argc, char *argv[])
 	opts = fill_common_opts(opts, &nr_opts, required_argument);
 	opts = add_opt(opts, &nr_opts, "align", required_argument, OPT_ALIGN);
 	opts = add_opt(opts, &nr_opts, "blob", required_argument, 'b');
+	opts = add_opt(opts, &nr_opts, "compress", no_argument, OPT_COMPRESS);
+	opts = add_opt(opts, &nr_opts, "in-place", no_argument, OPT_IN_PLACE);
 	opts = add_opt(opts, &nr_opts, "out", required_argument, 'o');
 	opts = add_opt(opts, &nr_opts, "plat-toc-flags", required_argument,
 	    OPT_PLAT_TOC_FLAGS);
+	opts = add_opt(opts, &nr_opts, "slack", required_argument, OPT_SLACK);
 	opts = add_opt(opts, &nr_opts, NULL, 0, 0);
 
 	while (1) {
@@ -772,8 +368,8 @@ static int update_cmd(int argc, char *argv[])
 		case OPT_TOC_ENTRY: {
 			image_desc_t *desc;
 
-			desc = lookup_image_desc_from_opt(opts[opt_index].name);
-			set_image_desc_action(desc, DO_PACK, optarg);
+			desc = fip_image_desc_from_opt(opts[opt_index].name);
+			fip_set_image_desc_action(desc, DO_PACK, optarg);
 			break;
 		}
 		case OPT_PLAT_TOC_FLAGS:
@@ -793,18 +389,27 @@ static int update_cmd(int argc, char *argv[])
 			    filename[0] == '\0')
 				update_usage();
 
-			desc = lookup_image_desc_from_uuid(&uuid);
+			desc = fip_image_desc_from_uuid(&uuid);
 			if (desc == NULL) {
-				uuid_to_str(name, sizeof(name), &uuid);
-				desc = new_image_desc(&uuid, name, "blob");
-				add_image_desc(desc);
+				fip_uuid_to_str(name, sizeof(name), &uuid);
+				desc = fip_new_image_desc(&uuid, name, "blob");
+				fip_add_image_desc(desc);
 			}
-			set_image_desc_action(desc, DO_PACK, filename);
+			fip_set_image_desc_action(desc, DO_PACK, filename);
 			break;
 		}
 		case OPT_ALIGN:
 			align = get_image_align(optarg);
 			break;
+		case OPT_COMPRESS:
+			compress = 1;
+			break;
+		case OPT_IN_PLACE:
+			in_place = 1;
+			break;
+		case OPT_SLACK:
+			slack = get_image_slack(optarg);
+			break;
 		case 'o':
 			snprintf(outfile, sizeof(outfile), "%s", optarg);
 			break;
@@ -819,19 +424,29 @@ static int update_cmd(int argc, char *argv[])
 	if (argc == 0)
 		update_usage();
 
+	if (in_place && outfile[0] != '\0')
+		fip_log_errx("--in-place and --out are mutually exclusive");
+
 	if (outfile[0] == '\0')
 		snprintf(outfile, sizeof(outfile), "%s", argv[0]);
 
 	if (access(argv[0], F_OK) == 0)
-		parse_fip(argv[0], &toc_header);
+		fip_parse(argv[0], &toc_header);
+	else if (in_place)
+		fip_log_errx("FIP %s must exist to be updated in place",
+		    argv[0]);
 
 	if (pflag)
 		toc_header.flags &= ~(0xffffULL << 32);
 	toc_flags = (toc_header.flags |= toc_flags);
 
-	update_fip();
+	fip_read_images(compress);
+
+	if (in_place &&
+	    fip_update_in_place(outfile, toc_flags, align, slack) == 0)
+		return 0;
 
-	pack_images(outfile, toc_flags, align);
+	fip_pack(outfile, toc_flags, align, slack);
 	return 0;
 }
 
@@ -844,8 +459,11 @@ static void update_usage(void)
 	printf("Options:\n");
 	printf("  --align <value>\t\tEach image is aligned to <value> (default: 1).\n");
 	printf("  --blob uuid=...,file=...\tAdd or update an image with the given UUID pointed to by file.\n");
+	printf("  --compress\t\t\tCompress the images added or updated with LZ4.\n");
+	printf("  --in-place\t\t\tOnly write the images added or updated and the ToC.\n");
 	printf("  --out FIP_FILENAME\t\tSet an alternative output FIP file.\n");
 	printf("  --plat-toc-flags <value>\t16-bit platform specific flag field occupying bits 32-47 in 64-bit ToC header.\n");
+	printf("  --slack <value>\t\tReserve <value> bytes after each image for in-place updates (default: 0).\n");
 	printf("\n");
 	printf("Specific images are packed with the following options:\n");
 	for (; toc_entry->cmdline_name != NULL; toc_entry++)
@@ -854,6 +472,7 @@ static void update_usage(void)
 	exit(1);
 }
 
+
 static int unpack_cmd(int argc, char *argv[])
 {
 	struct option *opts = NULL;
@@ -883,8 +502,8 @@ static int unpack_cmd(int argc, char *argv[])
 		case OPT_TOC_ENTRY: {
 			image_desc_t *desc;
 
-			desc = lookup_image_desc_from_opt(opts[opt_index].name);
-			set_image_desc_action(desc, DO_UNPACK, optarg);
+			desc = fip_image_desc_from_opt(opts[opt_index].name);
+			fip_set_image_desc_action(desc, DO_UNPACK, optarg);
 			unpack_all = 0;
 			break;
 		}
@@ -901,13 +520,13 @@ static int unpack_cmd(int argc, char *argv[])
 			    filename[0] == '\0')
 				unpack_usage();
 
-			desc = lookup_image_desc_from_uuid(&uuid);
+			desc = fip_image_desc_from_uuid(&uuid);
 			if (desc == NULL) {
-				uuid_to_str(name, sizeof(name), &uuid);
-				desc = new_image_desc(&uuid, name, "blob");
-				add_image_desc(desc);
+				fip_uuid_to_str(name, sizeof(name), &uuid);
+				desc = fip_new_image_desc(&uuid, name, "blob");
+				fip_add_image_desc(desc);
 			}
-			set_image_desc_action(desc, DO_UNPACK, filename);
+			fip_set_image_desc_action(desc, DO_UNPACK, filename);
 			unpack_all = 0;
 			break;
 		}
@@ -928,14 +547,14 @@ static int unpack_cmd(int argc, char *argv[])
 	if (argc == 0)
 		unpack_usage();
 
-	parse_fip(argv[0], NULL);
+	fip_parse(argv[0], NULL);
 
 	if (outdir[0] != '\0')
 		if (chdir(outdir) == -1)
-			log_err("chdir %s", outdir);
+			fip_log_err("chdir %s", outdir);
 
 	/* Unpack all specified images. */
-	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+	for (desc = fip_image_descs(); desc != NULL; desc = desc->next) {
 		char file[PATH_MAX];
 		image_t *image = desc->image;
 
@@ -950,23 +569,27 @@ static int unpack_cmd(int argc, char *argv[])
 			snprintf(file, sizeof(file), "%s",
 			    desc->action_arg);
 
+		/* Only the images selected below are written. */
+		desc->action = DO_UNSPEC;
+
 		if (image == NULL) {
 			if (!unpack_all)
-				log_warnx("%s does not exist in %s",
+				fip_log_warnx("%s does not exist in %s",
 				    file, argv[0]);
 			continue;
 		}
 
 		if (access(file, F_OK) != 0 || fflag) {
-			if (verbose)
-				log_dbgx("Unpacking %s", file);
-			write_image_to_file(image, file);
+			fip_set_image_desc_action(desc, DO_UNPACK, file);
 		} else {
-			log_warnx("File %s already exists, use --force to overwrite it",
+			fip_log_warnx("File %s already exists, use --force to overwrite it",
 			    file);
 		}
 	}
 
+	/* Write the images selected above, one job per image. */
+	fip_unpack_images();
+
 	return 0;
 }
 
@@ -1021,8 +644,8 @@ static int remove_cmd(int argc, char *argv[])
 		case OPT_TOC_ENTRY: {
 			image_desc_t *desc;
 
-			desc = lookup_image_desc_from_opt(opts[opt_index].name);
-			set_image_desc_action(desc, DO_REMOVE, NULL);
+			desc = fip_image_desc_from_opt(opts[opt_index].name);
+			fip_set_image_desc_action(desc, DO_REMOVE, NULL);
 			break;
 		}
 		case OPT_ALIGN:
@@ -1039,13 +662,13 @@ static int remove_cmd(int argc, char *argv[])
 			if (memcmp(&uuid, &uuid_null, sizeof(uuid_t)) == 0)
 				remove_usage();
 
-			desc = lookup_image_desc_from_uuid(&uuid);
+			desc = fip_image_desc_from_uuid(&uuid);
 			if (desc == NULL) {
-				uuid_to_str(name, sizeof(name), &uuid);
-				desc = new_image_desc(&uuid, name, "blob");
-				add_image_desc(desc);
+				fip_uuid_to_str(name, sizeof(name), &uuid);
+				desc = fip_new_image_desc(&uuid, name, "blob");
+				fip_add_image_desc(desc);
 			}
-			set_image_desc_action(desc, DO_REMOVE, NULL);
+			fip_set_image_desc_action(desc, DO_REMOVE, NULL);
 			break;
 		}
 		case 'f':
@@ -1066,31 +689,30 @@ static int remove_cmd(int argc, char *argv[])
 		remove_usage();
 
 	if (outfile[0] != '\0' && access(outfile, F_OK) == 0 && !fflag)
-		log_errx("File %s already exists, use --force to overwrite it",
+		fip_log_errx("File %s already exists, use --force to overwrite it",
 		    outfile);
 
 	if (outfile[0] == '\0')
 		snprintf(outfile, sizeof(outfile), "%s", argv[0]);
 
-	parse_fip(argv[0], &toc_header);
+	fip_parse(argv[0], &toc_header);
 
-	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+	for (desc = fip_image_descs(); desc != NULL; desc = desc->next) {
 		if (desc->action != DO_REMOVE)
 			continue;
 
 		if (desc->image != NULL) {
 			if (verbose)
-				log_dbgx("Removing %s",
+				fip_log_dbgx("Removing %s",
 				    desc->cmdline_name);
-			free(desc->image);
-			desc->image = NULL;
+			fip_remove_image(desc);
 		} else {
-			log_warnx("%s does not exist in %s",
+			fip_log_warnx("%s does not exist in %s",
 			    desc->cmdline_name, argv[0]);
 		}
 	}
 
-	pack_images(outfile, toc_header.flags, align);
+	fip_pack(outfile, toc_header.flags, align, 0);
 	return 0;
 }
 
@@ -1113,6 +735,256 @@ static void remove_usage(void)
 	exit(1);
 }
 
+/* Unpack an image of the batch subcommand from the FIP as it was parsed */
+static void batch_unpack(image_desc_t *desc, const char *file, int fflag)
+{
+	if (desc->image == NULL) {
+		fip_log_warnx("%s does not exist in the FIP",
+		    desc->cmdline_name);
+		return;
+	}
+
+	if (access(file, F_OK) == 0 && !fflag) {
+		fip_log_warnx("File %s already exists, use --force to overwrite it",
+		    file);
+		return;
+	}
+
+	if (verbose)
+		fip_log_dbgx("Unpacking %s", file);
+	fip_write_image(desc->image, file);
+}
+
+/*
+ * Apply a line of the operations of the batch subcommand. The images are
+ * unpacked right away, while the images updated or removed are only recorded
+ * in their descriptors, to be processed together once all the lines are read.
+ */
+static void batch_op(char *line, unsigned long lineno, int fflag)
+{
+	const char *sep = " \t\r\n";
+	char *op, *opt, *arg, *save;
+	int action = DO_UNSPEC;
+
+	op = strtok_r(line, sep, &save);
+	if (op == NULL || op[0] == '#')
+		return;
+
+	if (strcmp(op, "update") == 0)
+		action = DO_PACK;
+	else if (strcmp(op, "remove") == 0)
+		action = DO_REMOVE;
+	else if (strcmp(op, "unpack") == 0)
+		action = DO_UNPACK;
+	else
+		fip_log_errx("Line %lu: invalid operation %s", lineno, op);
+
+	while ((opt = strtok_r(NULL, sep, &save)) != NULL) {
+		char filename[PATH_MAX] = { 0 };
+		image_desc_t *desc;
+
+		if (strncmp(opt, "--", 2) != 0)
+			fip_log_errx("Line %lu: invalid option %s",
+			    lineno, opt);
+		opt += 2;
+
+		/* Only the images removed are not given a file. */
+		arg = NULL;
+		if (action != DO_REMOVE || strcmp(opt, "blob") == 0) {
+			arg = strtok_r(NULL, sep, &save);
+			if (arg == NULL)
+				fip_log_errx("Line %lu: --%s needs an argument",
+				    lineno, opt);
+		}
+
+		if (strcmp(opt, "blob") == 0) {
+			char name[_UUID_STR_LEN + 1];
+			uuid_t uuid = { 0 };
+
+			parse_blob_opt(arg, &uuid, filename, sizeof(filename));
+
+			if (memcmp(&uuid, &uuid_null, sizeof(uuid_t)) == 0 ||
+			    (action != DO_REMOVE && filename[0] == '\0'))
+				fip_log_errx("Line %lu: invalid --blob",
+				    lineno);
+
+			desc = fip_image_desc_from_uuid(&uuid);
+			if (desc == NULL) {
+				fip_uuid_to_str(name, sizeof(name), &uuid);
+				desc = fip_new_image_desc(&uuid, name, "blob");
+				fip_add_image_desc(desc);
+			}
+			arg = action != DO_REMOVE ? filename : NULL;
+		} else {
+			desc = fip_image_desc_from_opt(opt);
+			if (desc == NULL)
+				fip_log_errx("Line %lu: invalid option --%s",
+				    lineno, opt);
+		}
+
+		if (action == DO_UNPACK)
+			batch_unpack(desc, arg, fflag);
+		else
+			fip_set_image_desc_action(desc, action, arg);
+	}
+}
+
+static int batch_cmd(int argc, char *argv[])
+{
+	struct option *opts = NULL;
+	size_t nr_opts = 0;
+	char outfile[PATH_MAX] = { 0 };
+	char opsfile[PATH_MAX] = { 0 };
+	fip_toc_header_t toc_header = { 0 };
+	unsigned long long toc_flags = 0;
+	unsigned long align = 1;
+	unsigned long slack = 0;
+	unsigned long lineno = 0;
+	image_desc_t *desc;
+	char *line = NULL;
+	size_t line_size = 0;
+	FILE *fp = stdin;
+	int compress = 0;
+	int in_place = 0;
+	int fflag = 0;
+	int pflag = 0;
+
+	if (argc < 2)
+		batch_usage();
+
+	opts = add_opt(opts, &nr_opts, "align", required_argument, OPT_ALIGN);
+	opts = add_opt(opts, &nr_opts, "compress", no_argument, OPT_COMPRESS);
+	opts = add_opt(opts, &nr_opts, "force", no_argument, 'f');
+	opts = add_opt(opts, &nr_opts, "in-place", no_argument, OPT_IN_PLACE);
+	opts = add_opt(opts, &nr_opts, "ops", required_argument, OPT_OPS);
+	opts = add_opt(opts, &nr_opts, "out", required_argument, 'o');
+	opts = add_opt(opts, &nr_opts, "plat-toc-flags", required_argument,
+	    OPT_PLAT_TOC_FLAGS);
+	opts = add_opt(opts, &nr_opts, "slack", required_argument, OPT_SLACK);
+	opts = add_opt(opts, &nr_opts, NULL, 0, 0);
+
+	while (1) {
+		int c, opt_index = 0;
+
+		c = getopt_long(argc, argv, "fo:", opts, &opt_index);
+		if (c == -1)
+			break;
+
+		switch (c) {
+		case OPT_ALIGN:
+			align = get_image_align(optarg);
+			break;
+		case OPT_COMPRESS:
+			compress = 1;
+			break;
+		case 'f':
+			fflag = 1;
+			break;
+		case OPT_IN_PLACE:
+			in_place = 1;
+			break;
+		case OPT_OPS:
+			snprintf(opsfile, sizeof(opsfile), "%s", optarg);
+			break;
+		case 'o':
+			snprintf(outfile, sizeof(outfile), "%s", optarg);
+			break;
+		case OPT_PLAT_TOC_FLAGS:
+			parse_plat_toc_flags(optarg, &toc_flags);
+			pflag = 1;
+			break;
+		case OPT_SLACK:
+			slack = get_image_slack(optarg);
+			break;
+		default:
+			batch_usage();
+		}
+	}
+	argc -= optind;
+	argv += optind;
+	free(opts);
+
+	if (argc == 0)
+		batch_usage();
+
+	if (in_place && outfile[0] != '\0')
+		fip_log_errx("--in-place and --out are mutually exclusive");
+
+	if (outfile[0] == '\0')
+		snprintf(outfile, sizeof(outfile), "%s", argv[0]);
+
+	/* The FIP is parsed once for all the operations. */
+	if (access(argv[0], F_OK) == 0)
+		fip_parse(argv[0], &toc_header);
+	else if (in_place)
+		fip_log_errx("FIP %s must exist to be updated in place",
+		    argv[0]);
+
+	if (opsfile[0] != '\0') {
+		fp = fopen(opsfile, "r");
+		if (fp == NULL)
+			fip_log_err("fopen %s", opsfile);
+	}
+	while (getline(&line, &line_size, fp) != -1)
+		batch_op(line, ++lineno, fflag);
+	if (ferror(fp))
+		fip_log_err("Failed to read the operations");
+	free(line);
+	if (fp != stdin)
+		fclose(fp);
+
+	for (desc = fip_image_descs(); desc != NULL; desc = desc->next) {
+		if (desc->action != DO_REMOVE)
+			continue;
+
+		if (desc->image != NULL) {
+			if (verbose)
+				fip_log_dbgx("Removing %s",
+				    desc->cmdline_name);
+			fip_remove_image(desc);
+		} else {
+			fip_log_warnx("%s does not exist in %s",
+			    desc->cmdline_name, argv[0]);
+		}
+	}
+
+	if (pflag)
+		toc_header.flags &= ~(0xffffULL << 32);
+	toc_flags = (toc_header.flags |= toc_flags);
+
+	/* Read the images added or replaced, then write the FIP once. */
+	fip_read_images(compress);
+
+	if (in_place &&
+	    fip_update_in_place(outfile, toc_flags, align, slack) == 0)
+		return 0;
+
+	fip_pack(outfile, toc_flags, align, slack);
+	return 0;
+}
+
+static void batch_usage(void)
+{
+	printf("fiptool batch [opts] FIP_FILENAME\n");
+	printf("\n");
+	printf("Options:\n");
+	printf("  --align <value>\t\tEach image is aligned to <value> (default: 1).\n");
+	printf("  --compress\t\t\tCompress the images added with LZ4.\n");
+	printf("  --force\t\t\tOverwrite the files the images are unpacked to.\n");
+	printf("  --in-place\t\t\tUpdate the images without rewriting the whole FIP.\n");
+	printf("  --ops <file>\t\t\tRead the operations from <file> (default: standard input).\n");
+	printf("  --out FIP_FILENAME\t\tSet an alternative output FIP file.\n");
+	printf("  --plat-toc-flags <value>\t16-bit platform specific flag field occupying bits 32-47 in 64-bit ToC header.\n");
+	printf("  --slack <value>\t\tReserve <value> bytes after each image added for in-place updates (default: 0).\n");
+	printf("\n");
+	printf("Operations, one per line, using the image options of the create command:\n");
+	printf("  update --<image> FILENAME ...\tAdd or replace images.\n");
+	printf("  remove --<image> ...\t\tRemove images.\n");
+	printf("  unpack --<image> FILENAME ...\tUnpack images from FIP_FILENAME as it was parsed.\n");
+	printf("The FIP is parsed once and written once, after all the operations.\n");
+	exit(1);
+}
+
 static int version_cmd(int argc, char *argv[])
 {
 #ifdef VERSION
@@ -1150,8 +1022,9 @@ static int help_cmd(int argc, char *argv[])
 
 static void usage(void)
 {
-	printf("usage: fiptool [--verbose] <command> [<args>]\n");
+	printf("usage: fiptool [--jobs N] [--verbose] <command> [<args>]\n");
 	printf("Global options supported:\n");
+	printf("  --jobs N\tProcess up to N images in parallel, 0 for one per CPU.\n");
 	printf("  --verbose\tEnable verbose output for all commands.\n");
 	printf("\n");
 	printf("Commands supported:\n");
@@ -1160,6 +1033,7 @@ static void usage(void)
 	printf("  update\tUpdate an existing FIP with the given images.\n");
 	printf("  unpack\tUnpack images from FIP.\n");
 	printf("  remove\tRemove images from FIP.\n");
+	printf("  batch\t\tApply a list of operations to a FIP.\n");
 	printf("  version\tShow fiptool version.\n");
 	printf("  help\t\tShow help for given command.\n");
 	exit(1);
@@ -1172,6 +1046,7 @@ int main(int argc, char *argv[])
 	while (1) {
 		int c, opt_index = 0;
 		static struct option opts[] = {
+			{ "jobs", required_argument, NULL, 'j' },
 			{ "verbose", no_argument, NULL, 'v' },
 			{ NULL, no_argument, NULL, 0 }
 		};
@@ -1180,13 +1055,17 @@ int main(int argc, char *argv[])
 		 * Set POSIX mode so getopt stops at the first non-option
 		 * which is the subcommand.
 		 */
-		c = getopt_long(argc, argv, "+v", opts, &opt_index);
+		c = getopt_long(argc, argv, "+j:v", opts, &opt_index);
 		if (c == -1)
 			break;
 
 		switch (c) {
+		case 'j':
+			fip_set_jobs(get_nr_jobs(optarg));
+			break;
 		case 'v':
 			verbose = 1;
+			fip_set_verbose(1);
 			break;
 		default:
 			usage();
@@ -1200,7 +1079,7 @@ int main(int argc, char *argv[])
 	if (argc == 0)
 		usage();
 
-	fill_image_descs();
+	fip_fill_image_descs();
 	for (i = 0; i < NELEM(cmds); i++) {
 		if (strcmp(cmds[i].name, argv[0]) == 0) {
 			ret = cmds[i].handler(argc, argv);
@@ -1209,6 +1088,7 @@ int main(int argc, char *argv[])
 	}
 	if (i == NELEM(cmds))
 		usage();
-	free_image_descs();
+	fip_free_image_descs();
 	return ret;
 }
+
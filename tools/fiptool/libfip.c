@@ -0,0 +1,859 @@
+/*
+ * Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <firmware_image_package.h>
+
+#include "libfip.h"
+#include "lz4_compress.h"
+#include "tbbr_config.h"
+
+static image_desc_t *image_desc_head;
+static size_t nr_image_descs;
+static uuid_t uuid_null = { 0 };
+static int verbose;
+static long nr_jobs = 1;
+
+void fip_set_verbose(int enable)
+{
+	verbose = enable;
+}
+
+void fip_set_jobs(long n)
+{
+	nr_jobs = n;
+}
+
+/*
+ * FIP parsed by fip_parse(). Its images are used straight from its mapping,
+ * so it must not be truncated to write the new FIP over it.
+ */
+static struct {
+	char *buf;
+	size_t size;
+	dev_t dev;
+	ino_t ino;
+} parsed_fip;
+
+/* Image descriptors not yet picked by the threads of run_jobs() */
+static struct {
+	pthread_mutex_t lock;
+	image_desc_t *next;
+	void (*fn)(image_desc_t *desc, void *arg);
+	void *arg;
+} job_queue = { PTHREAD_MUTEX_INITIALIZER };
+
+static void vlog(int prio, const char *msg, va_list ap)
+{
+	char *prefix[] = { "DEBUG", "WARN", "ERROR" };
+
+	/* Keep the messages of the jobs from interleaving */
+	flockfile(stderr);
+	fprintf(stderr, "%s: ", prefix[prio]);
+	vfprintf(stderr, msg, ap);
+	fputc('\n', stderr);
+	funlockfile(stderr);
+}
+
+void fip_log_dbgx(const char *msg, ...)
+{
+	va_list ap;
+
+	va_start(ap, msg);
+	vlog(LOG_DBG, msg, ap);
+	va_end(ap);
+}
+
+void fip_log_warnx(const char *msg, ...)
+{
+	va_list ap;
+
+	va_start(ap, msg);
+	vlog(LOG_WARN, msg, ap);
+	va_end(ap);
+}
+
+void fip_log_err(const char *msg, ...)
+{
+	char buf[512];
+	va_list ap;
+
+	va_start(ap, msg);
+	snprintf(buf, sizeof(buf), "%s: %s", msg, strerror(errno));
+	vlog(LOG_ERR, buf, ap);
+	va_end(ap);
+	exit(1);
+}
+
+void fip_log_errx(const char *msg, ...)
+{
+	va_list ap;
+
+	va_start(ap, msg);
+	vlog(LOG_ERR, msg, ap);
+	va_end(ap);
+	exit(1);
+}
+
+static char *xstrdup(const char *s, const char *msg)
+{
+	char *d;
+
+	d = strdup(s);
+	if (d == NULL)
+		fip_log_errx("strdup: %s", msg);
+	return d;
+}
+
+static void *xmalloc(size_t size, const char *msg)
+{
+	void *d;
+
+	d = malloc(size);
+	if (d == NULL)
+		fip_log_errx("malloc: %s", msg);
+	return d;
+}
+
+static void *xzalloc(size_t size, const char *msg)
+{
+	return memset(xmalloc(size, msg), 0, size);
+}
+
+static void xfwrite(void *buf, size_t size, FILE *fp, const char *filename)
+{
+	if (fwrite(buf, 1, size, fp) != size)
+		fip_log_errx("Failed to write %s", filename);
+}
+
+static void *job_thread(void *unused)
+{
+	image_desc_t *desc;
+
+	for (;;) {
+		pthread_mutex_lock(&job_queue.lock);
+		desc = job_queue.next;
+		if (desc != NULL)
+			job_queue.next = desc->next;
+		pthread_mutex_unlock(&job_queue.lock);
+
+		if (desc == NULL)
+			return NULL;
+		job_queue.fn(desc, job_queue.arg);
+	}
+}
+
+/*
+ * Call 'fn' on every image descriptor, from up to 'nr_jobs' threads. 'fn'
+ * must not access any other descriptor than the one it is passed.
+ */
+static void run_jobs(void (*fn)(image_desc_t *desc, void *arg), void *arg)
+{
+	pthread_t *threads;
+	image_desc_t *desc;
+	long i, n;
+
+	n = nr_jobs < (long)nr_image_descs ? nr_jobs : (long)nr_image_descs;
+	if (n <= 1) {
+		for (desc = image_desc_head; desc != NULL; desc = desc->next)
+			fn(desc, arg);
+		return;
+	}
+
+	job_queue.next = image_desc_head;
+	job_queue.fn = fn;
+	job_queue.arg = arg;
+
+	threads = xmalloc(n * sizeof(*threads),
+	    "failed to allocate memory for threads");
+	for (i = 0; i < n; i++)
+		if (pthread_create(&threads[i], NULL, job_thread, NULL) != 0)
+			fip_log_errx("Failed to create thread");
+	for (i = 0; i < n; i++)
+		pthread_join(threads[i], NULL);
+	free(threads);
+}
+
+image_desc_t *fip_new_image_desc(const uuid_t *uuid,
+    const char *name, const char *cmdline_name)
+{
+	image_desc_t *desc;
+
+	desc = xzalloc(sizeof(*desc),
+	    "failed to allocate memory for image descriptor");
+	memcpy(&desc->uuid, uuid, sizeof(uuid_t));
+	desc->name = xstrdup(name,
+	    "failed to allocate memory for image name");
+	desc->cmdline_name = xstrdup(cmdline_name,
+	    "failed to allocate memory for image command line name");
+	desc->action = DO_UNSPEC;
+	return desc;
+}
+
+void fip_set_image_desc_action(image_desc_t *desc, int action,
+    const char *arg)
+{
+	assert(desc != NULL);
+
+	if (desc->action_arg != DO_UNSPEC)
+		free(desc->action_arg);
+	desc->action = action;
+	desc->action_arg = NULL;
+	if (arg != NULL)
+		desc->action_arg = xstrdup(arg,
+		    "failed to allocate memory for argument");
+}
+
+static void free_image_desc(image_desc_t *desc)
+{
+	free(desc->name);
+	free(desc->cmdline_name);
+	free(desc->action_arg);
+	free(desc->image);
+	free(desc);
+}
+
+void fip_add_image_desc(image_desc_t *desc)
+{
+	image_desc_t **p = &image_desc_head;
+
+	while (*p)
+		p = &(*p)->next;
+
+	assert(*p == NULL);
+	*p = desc;
+	nr_image_descs++;
+}
+
+void fip_free_image_descs(void)
+{
+	image_desc_t *desc = image_desc_head, *tmp;
+
+	while (desc != NULL) {
+		tmp = desc->next;
+		free_image_desc(desc);
+		desc = tmp;
+		nr_image_descs--;
+	}
+	assert(nr_image_descs == 0);
+}
+
+image_desc_t *fip_image_descs(void)
+{
+	return image_desc_head;
+}
+
+void fip_fill_image_descs(void)
+{
+	toc_entry_t *toc_entry;
+
+	for (toc_entry = toc_entries;
+	     toc_entry->cmdline_name != NULL;
+	     toc_entry++) {
+		image_desc_t *desc;
+
+		desc = fip_new_image_desc(&toc_entry->uuid,
+		    toc_entry->name,
+		    toc_entry->cmdline_name);
+		fip_add_image_desc(desc);
+	}
+}
+
+image_desc_t *fip_image_desc_from_uuid(const uuid_t *uuid)
+{
+	image_desc_t *desc;
+
+	for (desc = image_desc_head; desc != NULL; desc = desc->next)
+		if (memcmp(&desc->uuid, uuid, sizeof(uuid_t)) == 0)
+			return desc;
+	return NULL;
+}
+
+image_desc_t *fip_image_desc_from_opt(const char *opt)
+{
+	image_desc_t *desc;
+
+	for (desc = image_desc_head; desc != NULL; desc = desc->next)
+		if (strcmp(desc->cmdline_name, opt) == 0)
+			return desc;
+	return NULL;
+}
+
+void fip_uuid_to_str(char *s, size_t len, const uuid_t *u)
+{
+	assert(len >= (_UUID_STR_LEN + 1));
+
+	snprintf(s, len, "%08X-%04X-%04X-%04X-%04X%04X%04X",
+	    u->time_low,
+	    u->time_mid,
+	    u->time_hi_and_version,
+	    ((uint16_t)u->clock_seq_hi_and_reserved << 8) | u->clock_seq_low,
+	    ((uint16_t)u->node[0] << 8) | u->node[1],
+	    ((uint16_t)u->node[2] << 8) | u->node[3],
+	    ((uint16_t)u->node[4] << 8) | u->node[5]);
+}
+
+void fip_uuid_from_str(uuid_t *u, const char *s)
+{
+	int n;
+
+	if (s == NULL)
+		fip_log_errx("UUID cannot be NULL");
+	if (strlen(s) != _UUID_STR_LEN)
+		fip_log_errx("Invalid UUID: %s", s);
+
+	n = sscanf(s,
+	    "%8x-%4hx-%4hx-%2hhx%2hhx-%2hhx%2hhx%2hhx%2hhx%2hhx%2hhx",
+	    &u->time_low, &u->time_mid, &u->time_hi_and_version,
+	    &u->clock_seq_hi_and_reserved, &u->clock_seq_low, &u->node[0],
+	    &u->node[1], &u->node[2], &u->node[3], &u->node[4], &u->node[5]);
+	/*
+	 * Given the format specifier above, we expect 11 items to be scanned
+	 * for a properly formatted UUID.
+	 */
+	if (n != 11)
+		fip_log_errx("Invalid UUID: %s", s);
+}
+
+int fip_parse(const char *filename, fip_toc_header_t *toc_header_out)
+{
+	struct stat st;
+	FILE *fp;
+	char *buf, *bufend;
+	fip_toc_header_t *toc_header;
+	fip_toc_entry_t *toc_entry;
+	int terminated = 0;
+
+	fp = fopen(filename, "r");
+	if (fp == NULL)
+		fip_log_err("fopen %s", filename);
+
+	if (fstat(fileno(fp), &st) == -1)
+		fip_log_err("fstat %s", filename);
+
+	if (st.st_size < sizeof(fip_toc_header_t))
+		fip_log_errx("FIP %s is truncated", filename);
+
+	/* Use the images straight from the page cache */
+	buf = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+	if (buf == MAP_FAILED)
+		fip_log_err("mmap %s", filename);
+	bufend = buf + st.st_size;
+	fclose(fp);
+
+	assert(parsed_fip.buf == NULL);
+	parsed_fip.buf = buf;
+	parsed_fip.size = st.st_size;
+	parsed_fip.dev = st.st_dev;
+	parsed_fip.ino = st.st_ino;
+
+	toc_header = (fip_toc_header_t *)buf;
+	toc_entry = (fip_toc_entry_t *)(toc_header + 1);
+
+	if (toc_header->name != TOC_HEADER_NAME)
+		fip_log_errx("%s is not a FIP file", filename);
+
+	/* Return the ToC header if the caller wants it. */
+	if (toc_header_out != NULL)
+		*toc_header_out = *toc_header;
+
+	/* Walk through each ToC entry in the file. */
+	while ((char *)toc_entry + sizeof(*toc_entry) - 1 < bufend) {
+		image_t *image;
+		image_desc_t *desc;
+
+		/* Found the ToC terminator, we are done. */
+		if (memcmp(&toc_entry->uuid, &uuid_null, sizeof(uuid_t)) == 0) {
+			terminated = 1;
+			break;
+		}
+
+		/*
+		 * Build a new image out of the ToC entry and add it to the
+		 * table of images.
+		 */
+		image = xzalloc(sizeof(*image),
+		    "failed to allocate memory for image");
+		image->toc_e = *toc_entry;
+		/* Overflow checks before using the payload. */
+		if (toc_entry->size > (uint64_t)-1 - toc_entry->offset_address)
+			fip_log_errx("FIP %s is corrupted", filename);
+		if (toc_entry->size + toc_entry->offset_address > st.st_size)
+			fip_log_errx("FIP %s is corrupted", filename);
+
+		image->buffer = buf + toc_entry->offset_address;
+
+		/* If this is an unknown image, create a descriptor for it. */
+		desc = fip_image_desc_from_uuid(&toc_entry->uuid);
+		if (desc == NULL) {
+			char name[_UUID_STR_LEN + 1], filename[PATH_MAX];
+
+			fip_uuid_to_str(name, sizeof(name), &toc_entry->uuid);
+			snprintf(filename, sizeof(filename), "%s%s",
+			    name, ".bin");
+			desc = fip_new_image_desc(&toc_entry->uuid, name,
+			    "blob");
+			desc->action = DO_UNPACK;
+			desc->action_arg = xstrdup(filename,
+			    "failed to allocate memory for blob filename");
+			fip_add_image_desc(desc);
+		}
+
+		assert(desc->image == NULL);
+		desc->image = image;
+
+		toc_entry++;
+	}
+
+	if (terminated == 0)
+		fip_log_errx("FIP %s does not have a ToC terminator entry",
+		    filename);
+	return 0;
+}
+
+/*
+ * Map an input file rather than reading it, so that large images (e.g. a
+ * kernel with its initramfs as BL33) do not have to be held in memory. Their
+ * pages are read from the page cache as they are written to the FIP.
+ */
+
+static image_t *read_image_from_file(const uuid_t *uuid, const char *filename)
+{
+	struct stat st;
+	image_t *image;
+	FILE *fp;
+
+	assert(uuid != NULL);
+
+	fp = fopen(filename, "r");
+	if (fp == NULL)
+		fip_log_err("fopen %s", filename);
+
+	if (fstat(fileno(fp), &st) == -1)
+		fip_log_errx("fstat %s", filename);
+
+	image = xzalloc(sizeof(*image), "failed to allocate memory for image");
+	image->toc_e.uuid = *uuid;
+	/* Empty files cannot be mapped */
+	if (st.st_size != 0) {
+		image->buffer = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE,
+		    fileno(fp), 0);
+		if (image->buffer == MAP_FAILED)
+			fip_log_err("mmap %s", filename);
+		image->mapped = 1;
+	}
+	image->toc_e.size = st.st_size;
+
+	fclose(fp);
+	return image;
+}
+
+int fip_write_image(const image_t *image, const char *filename)
+{
+	FILE *fp;
+
+	fp = fopen(filename, "w");
+	if (fp == NULL)
+		fip_log_err("fopen");
+	xfwrite(image->buffer, image->toc_e.size, fp, filename);
+	fclose(fp);
+	return 0;
+}
+
+static void hash_image_job(image_desc_t *desc, void *unused)
+{
+	image_t *image = desc->image;
+
+	if (image != NULL)
+		SHA256(image->buffer, image->toc_e.size, image->md);
+}
+
+void fip_hash_images(void)
+{
+	run_jobs(hash_image_job, NULL);
+}
+
+void fip_remove_image(image_desc_t *desc)
+{
+	free(desc->image);
+	desc->image = NULL;
+}
+
+/*
+ * Open the file a FIP is written to. The FIP parsed by fip_parse() still holds
+ * the images being packed, so it is replaced by a temporary file with the same
+ * permissions, renamed over it once written. '*tmpname' returns the name of
+ * this file, or NULL when 'filename' is written directly.
+ */
+static FILE *open_fip_output(const char *filename, char **tmpname)
+{
+	struct stat st;
+	FILE *fp;
+	size_t len;
+	int fd;
+
+	*tmpname = NULL;
+	if (parsed_fip.buf == NULL || stat(filename, &st) == -1 ||
+	    st.st_dev != parsed_fip.dev || st.st_ino != parsed_fip.ino) {
+		fp = fopen(filename, "w");
+		if (fp == NULL)
+			fip_log_err("fopen %s", filename);
+		return fp;
+	}
+
+	len = strlen(filename) + sizeof(".XXXXXX");
+	*tmpname = xmalloc(len, "failed to allocate memory for file name");
+	snprintf(*tmpname, len, "%s.XXXXXX", filename);
+	fd = mkstemp(*tmpname);
+	if (fd == -1)
+		fip_log_err("mkstemp %s", *tmpname);
+	if (fchmod(fd, st.st_mode & 07777) == -1)
+		fip_log_err("fchmod %s", *tmpname);
+	fp = fdopen(fd, "w");
+	if (fp == NULL)
+		fip_log_err("fdopen %s", *tmpname);
+	return fp;
+}
+
+int fip_pack(const char *filename, uint64_t toc_flags,
+    unsigned long align, unsigned long slack)
+{
+	FILE *fp;
+	char *tmpname;
+	image_desc_t *desc;
+	fip_toc_header_t *toc_header;
+	fip_toc_entry_t *toc_entry;
+	char *buf;
+	uint64_t entry_offset, buf_size, payload_size = 0;
+	size_t nr_images = 0;
+
+	for (desc = image_desc_head; desc != NULL; desc = desc->next)
+		if (desc->image != NULL)
+			nr_images++;
+
+	buf_size = sizeof(fip_toc_header_t) +
+	    sizeof(fip_toc_entry_t) * (nr_images + 1);
+	buf = calloc(1, buf_size);
+	if (buf == NULL)
+		fip_log_err("calloc");
+
+	/* Build up header and ToC entries from the image table. */
+	toc_header = (fip_toc_header_t *)buf;
+	toc_header->name = TOC_HEADER_NAME;
+	toc_header->serial_number = TOC_HEADER_SERIAL_NUMBER;
+	toc_header->flags = toc_flags;
+
+	toc_entry = (fip_toc_entry_t *)(toc_header + 1);
+
+	entry_offset = buf_size;
+	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+		image_t *image = desc->image;
+
+		if (image == NULL)
+			continue;
+		payload_size += image->toc_e.size;
+		entry_offset = (entry_offset + align - 1) & ~(align - 1);
+		image->toc_e.offset_address = entry_offset;
+		*toc_entry++ = image->toc_e;
+		entry_offset += image->toc_e.size + slack;
+	}
+
+	/* Append a null uuid entry to mark the end of ToC entries. */
+	memset(toc_entry, 0, sizeof(*toc_entry));
+	toc_entry->offset_address = entry_offset;
+
+	/* Generate the FIP file. */
+	fp = open_fip_output(filename, &tmpname);
+
+	if (verbose)
+		fip_log_dbgx("Metadata size: %zu bytes", buf_size);
+
+	xfwrite(buf, buf_size, fp, filename);
+	free(buf);
+
+	if (verbose)
+		fip_log_dbgx("Payload size: %zu bytes", payload_size);
+
+	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+		image_t *image = desc->image;
+
+		if (image == NULL)
+			continue;
+		if (fseek(fp, image->toc_e.offset_address, SEEK_SET))
+			fip_log_errx("Failed to set file position");
+
+		xfwrite(image->buffer, image->toc_e.size, fp, filename);
+	}
+
+	/* Extend the file over the slack reserved after the last image. */
+	fflush(fp);
+	if (ftruncate(fileno(fp), entry_offset) == -1)
+		fip_log_err("ftruncate %s", filename);
+
+	fclose(fp);
+	if (tmpname != NULL) {
+		if (rename(tmpname, filename) == -1)
+			fip_log_err("rename %s", filename);
+		free(tmpname);
+	}
+	return 0;
+}
+
+/*
+ * Return the size of the slot of an image in the FIP it was parsed from,
+ * which extends up to the next payload or to the end of the file.
+ */
+static uint64_t get_image_slot_size(const image_t *image, uint64_t file_size)
+{
+	image_desc_t *desc;
+	uint64_t slot_end = file_size;
+
+	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+		uint64_t offset;
+
+		if (desc->image == NULL || desc->image == image)
+			continue;
+		offset = desc->image->toc_e.offset_address;
+		if (offset > image->toc_e.offset_address && offset < slot_end)
+			slot_end = offset;
+	}
+
+	return slot_end - image->toc_e.offset_address;
+}
+
+static void xfzero(uint64_t size, FILE *fp, const char *filename)
+{
+	static char zeroes[4096];
+
+	while (size > 0) {
+		size_t n = size < sizeof(zeroes) ? size : sizeof(zeroes);
+
+		xfwrite(zeroes, n, fp, filename);
+		size -= n;
+	}
+}
+
+/*
+ * Write the images being added or replaced into an existing FIP without
+ * rewriting the rest of it. An image that fits in the slot of the one it
+ * replaces is written over it and the remainder of the slot cleared. Any
+ * other image is appended to the end of the file, followed by 'slack'
+ * bytes of room for a later update. The ToC is rewritten last.
+ *
+ * Return -1 without modifying the file if the ToC has no room for the
+ * entries of the added images, in which case the FIP has to be packed
+ * again.
+ */
+int fip_update_in_place(const char *filename, uint64_t toc_flags,
+    unsigned long align, unsigned long slack)
+{
+	struct stat st;
+	FILE *fp;
+	image_desc_t *desc;
+	fip_toc_header_t *toc_header;
+	fip_toc_entry_t *toc_entry;
+	char *buf;
+	uint64_t buf_size, payload_start = (uint64_t)-1, file_end;
+	size_t nr_images = 0;
+
+	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+		image_t *image = desc->image;
+
+		if (image == NULL)
+			continue;
+		nr_images++;
+		/* Images added to the FIP do not have an offset yet. */
+		if (image->toc_e.offset_address != 0 &&
+		    image->toc_e.offset_address < payload_start)
+			payload_start = image->toc_e.offset_address;
+	}
+
+	buf_size = sizeof(fip_toc_header_t) +
+	    sizeof(fip_toc_entry_t) * (nr_images + 1);
+	if (buf_size > payload_start) {
+		if (verbose)
+			fip_log_dbgx("No room left in the ToC of %s", filename);
+		return -1;
+	}
+
+	fp = fopen(filename, "r+");
+	if (fp == NULL)
+		fip_log_err("fopen %s", filename);
+
+	if (fstat(fileno(fp), &st) == -1)
+		fip_log_err("fstat %s", filename);
+	file_end = st.st_size;
+
+	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+		image_t *image = desc->image;
+		uint64_t slot_size = 0;
+
+		if (image == NULL || desc->action != DO_PACK)
+			continue;
+
+		/*
+		 * Appended images start at or beyond the original end of the
+		 * file, so they do not shrink the slots of the others.
+		 */
+		if (image->toc_e.offset_address != 0)
+			slot_size = get_image_slot_size(image, st.st_size);
+		if (image->toc_e.size > slot_size) {
+			if (verbose)
+				fip_log_dbgx("Appending %s",
+				    desc->cmdline_name);
+			file_end = (file_end + align - 1) & ~(align - 1);
+			image->toc_e.offset_address = file_end;
+			file_end += image->toc_e.size + slack;
+			slot_size = image->toc_e.size;
+		} else if (verbose) {
+			fip_log_dbgx("Overwriting %s in place",
+			    desc->cmdline_name);
+		}
+
+		if (fseek(fp, image->toc_e.offset_address, SEEK_SET))
+			fip_log_errx("Failed to set file position");
+		xfwrite(image->buffer, image->toc_e.size, fp, filename);
+		xfzero(slot_size - image->toc_e.size, fp, filename);
+	}
+
+	/* Rewrite the ToC to point at the new images. */
+	buf = calloc(1, buf_size);
+	if (buf == NULL)
+		fip_log_err("calloc");
+
+	toc_header = (fip_toc_header_t *)buf;
+	toc_header->name = TOC_HEADER_NAME;
+	toc_header->serial_number = TOC_HEADER_SERIAL_NUMBER;
+	toc_header->flags = toc_flags;
+
+	toc_entry = (fip_toc_entry_t *)(toc_header + 1);
+	for (desc = image_desc_head; desc != NULL; desc = desc->next)
+		if (desc->image != NULL)
+			*toc_entry++ = desc->image->toc_e;
+	toc_entry->offset_address = file_end;
+
+	if (fseek(fp, 0, SEEK_SET))
+		fip_log_errx("Failed to set file position");
+	xfwrite(buf, buf_size, fp, filename);
+	free(buf);
+
+	fflush(fp);
+	if (file_end > st.st_size && ftruncate(fileno(fp), file_end) == -1)
+		fip_log_err("ftruncate %s", filename);
+
+	fclose(fp);
+	return 0;
+}
+
+/*
+ * Replace the payload of an image with an LZ4 frame, unless this does not
+ * make it smaller.
+ */
+static void compress_image(image_t *image, const char *filename)
+{
+	void *buf;
+	size_t size;
+
+	buf = lz4_frame_compress(image->buffer, image->toc_e.size,
+	    FIP_LZ4_BLOCK_SIZE, &size);
+	if (buf == NULL)
+		fip_log_errx("Failed to compress %s", filename);
+
+	if (size >= image->toc_e.size) {
+		if (verbose)
+			fip_log_dbgx("Not compressing %s", filename);
+		free(buf);
+		return;
+	}
+
+	if (verbose)
+		fip_log_dbgx("Compressed %s from %llu to %zu bytes", filename,
+		    (unsigned long long)image->toc_e.size, size);
+	if (image->mapped)
+		munmap(image->buffer, image->toc_e.size);
+	image->buffer = buf;
+	image->mapped = 0;
+	image->toc_e.size = size;
+	image->toc_e.flags |= TOC_ENTRY_FLAG_LZ4;
+}
+
+void fip_read_image(image_desc_t *desc, int compress)
+{
+	image_t *image;
+
+	assert(desc->action == DO_PACK);
+
+	image = read_image_from_file(&desc->uuid,
+	    desc->action_arg);
+	if (compress)
+		compress_image(image, desc->action_arg);
+	if (desc->image != NULL) {
+		if (verbose) {
+			fip_log_dbgx("Replacing %s with %s",
+			    desc->cmdline_name,
+			    desc->action_arg);
+		}
+		/* Keep the offset of the slot for an in-place update. */
+		image->toc_e.offset_address =
+		    desc->image->toc_e.offset_address;
+		free(desc->image);
+		desc->image = image;
+	} else {
+		if (verbose)
+			fip_log_dbgx("Adding image %s",
+			    desc->action_arg);
+		desc->image = image;
+	}
+}
+
+static void read_image_job(image_desc_t *desc, void *compress)
+{
+	if (desc->action == DO_PACK)
+		fip_read_image(desc, *(int *)compress);
+}
+
+/*
+ * This function is shared between the create and update subcommands.
+ * The difference between the two subcommands is that when the FIP file
+ * is created, the parsing of an existing FIP is skipped.  This results
+ * in fip_read_images() creating the new FIP file from scratch because the
+ * internal image table is not populated. With 'compress' set, the images
+ * added or replaced are compressed with LZ4.
+ */
+void fip_read_images(int compress)
+{
+	/* Add or replace images in the FIP file, one job per image. */
+	run_jobs(read_image_job, &compress);
+}
+
+static void unpack_image_job(image_desc_t *desc, void *unused)
+{
+	if (desc->action != DO_UNPACK)
+		return;
+
+	if (verbose)
+		fip_log_dbgx("Unpacking %s", desc->action_arg);
+	fip_write_image(desc->image, desc->action_arg);
+}
+
+void fip_unpack_images(void)
+{
+	run_jobs(unpack_image_job, NULL);
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __LIBFIP_H__
+#define __LIBFIP_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <openssl/sha.h>
+
+#include <firmware_image_package.h>
+#include <uuid.h>
+
+/*
+ * libfip parses, modifies and writes a FIP. It holds the table of the images
+ * of one FIP at a time, with a descriptor per known image type and one per
+ * unknown UUID met in the parsed FIP. An image is added, replaced, removed or
+ * unpacked by setting the action of its descriptor, on which the calls below
+ * act. Errors are fatal: they are reported on stderr and the process exits.
+ */
+
+enum {
+	DO_UNSPEC = 0,
+	DO_PACK   = 1,
+	DO_UNPACK = 2,
+	DO_REMOVE = 3
+};
+
+enum {
+	LOG_DBG,
+	LOG_WARN,
+	LOG_ERR
+};
+
+typedef struct image_desc {
+	uuid_t             uuid;
+	char              *name;
+	char              *cmdline_name;
+	int                action;
+	char              *action_arg;
+	struct image      *image;
+	struct image_desc *next;
+} image_desc_t;
+
+typedef struct image {
+	struct fip_toc_entry toc_e;
+	void                *buffer;
+	int                  mapped; /* buffer is a mapping of the input file */
+	unsigned char        md[SHA256_DIGEST_LENGTH];
+} image_t;
+
+/* Print debug messages, and process up to 'n' images in parallel */
+void fip_set_verbose(int enable);
+void fip_set_jobs(long n);
+
+void fip_log_dbgx(const char *msg, ...);
+void fip_log_warnx(const char *msg, ...);
+void fip_log_err(const char *msg, ...);
+void fip_log_errx(const char *msg, ...);
+
+/* Image table */
+void fip_fill_image_descs(void);
+void fip_free_image_descs(void);
+image_desc_t *fip_image_descs(void);
+image_desc_t *fip_new_image_desc(const uuid_t *uuid,
+    const char *name, const char *cmdline_name);
+void fip_add_image_desc(image_desc_t *desc);
+void fip_set_image_desc_action(image_desc_t *desc, int action,
+    const char *arg);
+image_desc_t *fip_image_desc_from_uuid(const uuid_t *uuid);
+image_desc_t *fip_image_desc_from_opt(const char *opt);
+
+void fip_uuid_to_str(char *s, size_t len, const uuid_t *u);
+void fip_uuid_from_str(uuid_t *u, const char *s);
+
+/* Fill the image table from a FIP, returning its ToC header if not NULL */
+int fip_parse(const char *filename, fip_toc_header_t *toc_header_out);
+
+/*
+ * Read the image of a descriptor, whose action is DO_PACK, from the file given
+ * as its argument, or those of all such descriptors. With 'compress' set, the
+ * images are compressed with LZ4.
+ */
+void fip_read_image(image_desc_t *desc, int compress);
+void fip_read_images(int compress);
+
+void fip_remove_image(image_desc_t *desc);
+
+/* Compute the SHA-256 hash of all the images */
+void fip_hash_images(void);
+
+/* Write an image to a file, or those of the descriptors set to DO_UNPACK */
+int fip_write_image(const image_t *image, const char *filename);
+void fip_unpack_images(void);
+
+/*
+ * Write a FIP with all the images of the table. fip_update_in_place() only
+ * writes the images set to DO_PACK in the FIP they were parsed from, and
+ * returns -1 without modifying it if its ToC has no room left.
+ */
+int fip_pack(const char *filename, uint64_t toc_flags,
+    unsigned long align, unsigned long slack);
+int fip_update_in_place(const char *filename, uint64_t toc_flags,
+    unsigned long align, unsigned long slack);
+
+#endif /* __LIBFIP_H__ */
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lz4_compress.h"
+
+/*
+ * Minimal LZ4 compressor producing frames in the format described in the
+ * lz4_Frame_format.md and lz4_Block_format.md documents of the LZ4 C library.
+ * The frames hold the content size and are made of independent blocks, so
+ * they can be decompressed by the firmware one block at a time, as well as by
+ * the lz4 command line tool.
+ */
+
+#define LZ4_FRAME_MAGIC		0x184D2204
+/* Version 01, independent blocks, content size present */
+#define LZ4_FRAME_FLG		0x68
+/* Maximum block size of 64KB */
+#define LZ4_FRAME_BD		0x40
+#define LZ4_FRAME_HEADER_SIZE	15
+#define LZ4_BLOCK_UNCOMPRESSED	(1U << 31)
+
+#define MIN_MATCH		4
+/* The last match must start at least 12 bytes before the end of the block */
+#define MF_LIMIT		12
+/* The last 5 bytes of a block are always literals */
+#define LAST_LITERALS		5
+#define MAX_OFFSET		65535
+
+#define HASH_BITS		12
+
+#define XXH_PRIME32_1		2654435761U
+#define XXH_PRIME32_2		2246822519U
+#define XXH_PRIME32_3		3266489917U
+#define XXH_PRIME32_4		668265263U
+#define XXH_PRIME32_5		374761393U
+
+static uint32_t read_le32(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void write_le32(uint8_t *p, uint32_t v)
+{
+	p[0] = v;
+	p[1] = v >> 8;
+	p[2] = v >> 16;
+	p[3] = v >> 24;
+}
+
+static uint32_t rotl32(uint32_t x, int r)
+{
+	return (x << r) | (x >> (32 - r));
+}
+
+/* XXH32 with a zero seed, for the inputs shorter than 16 bytes only */
+static uint32_t xxh32_short(const uint8_t *p, size_t len)
+{
+	uint32_t h = XXH_PRIME32_5 + (uint32_t)len;
+
+	assert(len < 16);
+
+	for (; len >= 4; p += 4, len -= 4) {
+		h += read_le32(p) * XXH_PRIME32_3;
+		h = rotl32(h, 17) * XXH_PRIME32_4;
+	}
+	for (; len > 0; p++, len--) {
+		h += *p * XXH_PRIME32_5;
+		h = rotl32(h, 11) * XXH_PRIME32_1;
+	}
+
+	h ^= h >> 15;
+	h *= XXH_PRIME32_2;
+	h ^= h >> 13;
+	h *= XXH_PRIME32_3;
+	h ^= h >> 16;
+	return h;
+}
+
+static unsigned int hash4(const uint8_t *p)
+{
+	return (read_le32(p) * XXH_PRIME32_1) >> (32 - HASH_BITS);
+}
+
+/* Encode the extra bytes of a length of 15 or more */
+static uint8_t *write_length(uint8_t *op, size_t len)
+{
+	for (; len >= 255; len -= 255)
+		*op++ = 255;
+	*op++ = len;
+	return op;
+}
+
+/* Emit a sequence of literals, followed by a match if 'match_len' is not 0 */
+static uint8_t *write_sequence(uint8_t *op, const uint8_t *lit, size_t lit_len,
+    size_t offset, size_t match_len)
+{
+	uint8_t *token = op++;
+	size_t ml = match_len ? match_len - MIN_MATCH : 0;
+
+	*token = ((lit_len < 15 ? lit_len : 15) << 4) | (ml < 15 ? ml : 15);
+	if (lit_len >= 15)
+		op = write_length(op, lit_len - 15);
+	memcpy(op, lit, lit_len);
+	op += lit_len;
+
+	if (match_len == 0)
+		return op;
+
+	*op++ = offset;
+	*op++ = offset >> 8;
+	if (ml >= 15)
+		op = write_length(op, ml - 15);
+	return op;
+}
+
+/*
+ * Compress a block with a greedy parse using a single entry hash table. The
+ * output buffer must be able to hold the worst case expansion of the input.
+ */
+static size_t lz4_compress_block(const uint8_t *src, size_t len, uint8_t *dst)
+{
+	const uint8_t *table[1 << HASH_BITS] = { NULL };
+	const uint8_t *ip = src, *anchor = src;
+	const uint8_t *iend = src + len;
+	const uint8_t *mflimit = iend - MF_LIMIT;
+	const uint8_t *matchlimit = iend - LAST_LITERALS;
+	uint8_t *op = dst;
+
+	if (len > MF_LIMIT) {
+		while (ip < mflimit) {
+			const uint8_t *ref;
+			unsigned int h = hash4(ip);
+			size_t match_len;
+
+			ref = table[h];
+			table[h] = ip;
+			if (ref == NULL || ip - ref > MAX_OFFSET ||
+			    read_le32(ref) != read_le32(ip)) {
+				ip++;
+				continue;
+			}
+
+			match_len = MIN_MATCH;
+			while (ip + match_len < matchlimit &&
+			    ref[match_len] == ip[match_len])
+				match_len++;
+
+			op = write_sequence(op, anchor, ip - anchor, ip - ref,
+			    match_len);
+			ip += match_len;
+			anchor = ip;
+		}
+	}
+
+	/* The remaining bytes are emitted as the final literals */
+	op = write_sequence(op, anchor, iend - anchor, 0, 0);
+	return op - dst;
+}
+
+/*
+ * Compress 'len' bytes at 'src' into a newly allocated LZ4 frame, whose size
+ * is returned in 'out_len'. Each block holds 'block_size' bytes of the input,
+ * and is stored as is when it does not compress.
+ */
+void *lz4_frame_compress(const void *src, size_t len, size_t block_size,
+    size_t *out_len)
+{
+	const uint8_t *ip = src;
+	uint8_t *dst, *op;
+	size_t nr_blocks, bound, chunk, n;
+	uint64_t size = len;
+	int i;
+
+	assert(block_size > 0 && block_size <= 0x10000);
+
+	/* Worst case: every block stored as is, plus the end mark */
+	nr_blocks = (len + block_size - 1) / block_size;
+	bound = LZ4_FRAME_HEADER_SIZE + nr_blocks * (block_size + 4) + 4;
+	dst = malloc(bound + block_size + block_size / 255 + 16);
+	if (dst == NULL)
+		return NULL;
+
+	write_le32(dst, LZ4_FRAME_MAGIC);
+	dst[4] = LZ4_FRAME_FLG;
+	dst[5] = LZ4_FRAME_BD;
+	for (i = 0; i < 8; i++)
+		dst[6 + i] = size >> (8 * i);
+	dst[14] = (xxh32_short(&dst[4], 10) >> 8) & 0xff;
+	op = dst + LZ4_FRAME_HEADER_SIZE;
+
+	for (; len > 0; ip += chunk, len -= chunk) {
+		chunk = len < block_size ? len : block_size;
+		n = lz4_compress_block(ip, chunk, op + 4);
+		if (n >= chunk) {
+			memcpy(op + 4, ip, chunk);
+			write_le32(op, chunk | LZ4_BLOCK_UNCOMPRESSED);
+			n = chunk;
+		} else {
+			write_le32(op, n);
+		}
+		op += 4 + n;
+	}
+
+	/* End mark */
+	write_le32(op, 0);
+	op += 4;
+
+	*out_len = op - dst;
+	return dst;
+}
@@ -0,0 +1,15 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __LZ4_COMPRESS_H__
+#define __LZ4_COMPRESS_H__
+
+#include <stddef.h>
+
+void *lz4_frame_compress(const void *src, size_t len, size_t block_size,
+    size_t *out_len);
+
+#endif /* __LZ4_COMPRESS_H__ */
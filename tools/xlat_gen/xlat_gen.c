@@ -0,0 +1,566 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host tool that builds the translation tables of a BL image at build time.
+ *
+ * It reads the parameters of the translation context and the static regions of
+ * the image from the XLAT_GEN_PARAMS_SECTION and XLAT_GEN_MMAP_SECTION sections
+ * of an object file built for the target, maps them exactly like the
+ * translation table library does at runtime and writes an assembly file with
+ * the resulting tables. The descriptors pointing to the next level tables are
+ * emitted as relocations so that the linker places the tables anywhere.
+ */
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <xlat_gen.h>
+#include <xlat_tables_v2.h>
+
+/* ELF definitions needed to find the sections of a relocatable object. */
+#define EI_CLASS		4
+#define ELFCLASS32		1
+#define ELFCLASS64		2
+#define SHT_RELA		4
+#define SHT_REL			9
+
+/* Layout of mmap_region_t in the AArch32 and AArch64 target ABIs. */
+#define MMAP_REGION_SIZE_32	24
+#define MMAP_REGION_SIZE_64	32
+
+#define BLOCK_SIZE(level)	(1ULL << XLAT_ADDR_SHIFT(level))
+#define BLOCK_MASK(level)	(BLOCK_SIZE(level) - 1)
+
+/* Regions of the image, in the order that the runtime library uses. */
+typedef struct region {
+	uint64_t base_pa;
+	uint64_t base_va;
+	uint64_t size;
+	uint32_t attr;
+} region_t;
+
+static int is_aarch64;
+static xlat_gen_params_t params;
+
+static region_t *regions;
+static unsigned int regions_num;
+
+static uint64_t *base_table;
+static uint64_t (*tables)[XLAT_TABLE_ENTRIES];
+static unsigned int tables_used;
+
+static uint64_t max_pa, max_va;
+
+static void log_errx(const char *msg, ...)
+{
+	va_list ap;
+
+	va_start(ap, msg);
+	fprintf(stderr, "ERROR: ");
+	vfprintf(stderr, msg, ap);
+	fputc('\n', stderr);
+	va_end(ap);
+	exit(1);
+}
+
+static void *xzalloc(size_t size, const char *msg)
+{
+	void *d;
+
+	d = calloc(1, size);
+	if (d == NULL)
+		log_errx("calloc: %s", msg);
+	return d;
+}
+
+static uint64_t read_le(const unsigned char *p, unsigned int bytes)
+{
+	uint64_t val = 0;
+
+	while (bytes--)
+		val = (val << 8) | p[bytes];
+	return val;
+}
+
+static unsigned char *read_file(const char *path, size_t *size)
+{
+	unsigned char *buf;
+	FILE *fp;
+	long len;
+
+	fp = fopen(path, "rb");
+	if (fp == NULL)
+		log_errx("fopen %s: %s", path, strerror(errno));
+
+	if (fseek(fp, 0, SEEK_END) != 0 || (len = ftell(fp)) < 0 ||
+	    fseek(fp, 0, SEEK_SET) != 0)
+		log_errx("Failed to get the size of %s", path);
+
+	buf = xzalloc(len ? len : 1, path);
+	if (fread(buf, 1, len, fp) != (size_t)len)
+		log_errx("Failed to read %s", path);
+
+	fclose(fp);
+	*size = len;
+	return buf;
+}
+
+/*
+ * Looks for the section called 'name' in the ELF relocatable object 'elf'.
+ * Its contents mustn't be subject to any relocation, i.e. they must only be
+ * made of values known at compile time.
+ */
+static const unsigned char *elf_find_section(const unsigned char *elf,
+					     size_t elf_size, const char *name,
+					     size_t *size)
+{
+	unsigned int addr_bytes = is_aarch64 ? 8 : 4;
+	uint64_t shoff, shentsize, shnum, shstrndx, stroff;
+	const unsigned char *sh;
+	uint64_t found = 0, i;
+
+	shoff = read_le(elf + (is_aarch64 ? 0x28 : 0x20), addr_bytes);
+	shentsize = read_le(elf + (is_aarch64 ? 0x3a : 0x2e), 2);
+	shnum = read_le(elf + (is_aarch64 ? 0x3c : 0x30), 2);
+	shstrndx = read_le(elf + (is_aarch64 ? 0x3e : 0x32), 2);
+
+	if (shoff + shnum * shentsize > elf_size || shstrndx >= shnum)
+		log_errx("Invalid section header table");
+
+#define SH(idx)		(elf + shoff + (idx) * shentsize)
+#define SH_NAME(sh)	read_le((sh), 4)
+#define SH_TYPE(sh)	read_le((sh) + 4, 4)
+#define SH_OFFSET(sh)	read_le((sh) + (is_aarch64 ? 0x18 : 0x10), \
+				addr_bytes)
+#define SH_SIZE(sh)	read_le((sh) + (is_aarch64 ? 0x20 : 0x14), \
+				addr_bytes)
+#define SH_INFO(sh)	read_le((sh) + (is_aarch64 ? 0x2c : 0x1c), 4)
+
+	stroff = SH_OFFSET(SH(shstrndx));
+
+	for (i = 1; i < shnum; i++) {
+		sh = SH(i);
+		if (stroff + SH_NAME(sh) + strlen(name) >= elf_size)
+			continue;
+		if (strcmp((const char *)elf + stroff + SH_NAME(sh), name) == 0)
+			found = i;
+	}
+
+	if (found == 0)
+		log_errx("Section %s not found", name);
+
+	for (i = 1; i < shnum; i++) {
+		sh = SH(i);
+		if ((SH_TYPE(sh) == SHT_REL || SH_TYPE(sh) == SHT_RELA) &&
+		    SH_INFO(sh) == found)
+			log_errx("Section %s must only contain constants",
+				 name);
+	}
+
+	sh = SH(found);
+	if (SH_OFFSET(sh) + SH_SIZE(sh) > elf_size)
+		log_errx("Section %s is truncated", name);
+
+	*size = SH_SIZE(sh);
+	return elf + SH_OFFSET(sh);
+
+#undef SH
+#undef SH_NAME
+#undef SH_TYPE
+#undef SH_OFFSET
+#undef SH_SIZE
+#undef SH_INFO
+}
+
+/*
+ * Adds a region to the list, keeping the order and applying the same checks
+ * as mmap_add_region_ctx().
+ */
+static void add_region(const region_t *mm)
+{
+	uint64_t end_pa = mm->base_pa + mm->size - 1;
+	uint64_t end_va = mm->base_va + mm->size - 1;
+	unsigned int i, pos;
+
+	if (!IS_PAGE_ALIGNED(mm->base_pa) || !IS_PAGE_ALIGNED(mm->base_va) ||
+	    !IS_PAGE_ALIGNED(mm->size))
+		log_errx("Region VA:0x%llx is not page aligned",
+			 (unsigned long long)mm->base_va);
+
+	if (mm->base_pa > end_pa || mm->base_va > end_va ||
+	    end_va > params.va_max_address || end_pa > params.pa_max_address)
+		log_errx("Region VA:0x%llx is out of the address space",
+			 (unsigned long long)mm->base_va);
+
+	for (i = 0; i < regions_num; i++) {
+		const region_t *r = &regions[i];
+		uint64_t r_end_va = r->base_va + r->size - 1;
+		uint64_t r_end_pa = r->base_pa + r->size - 1;
+		int fully_overlapped_va =
+			(mm->base_va >= r->base_va && end_va <= r_end_va) ||
+			(r->base_va >= mm->base_va && r_end_va <= end_va);
+
+		if (fully_overlapped_va) {
+			if ((r->base_va - r->base_pa) !=
+			    (mm->base_va - mm->base_pa) ||
+			    (r->base_va == mm->base_va && r->size == mm->size))
+				log_errx("Invalid overlap of region VA:0x%llx",
+					 (unsigned long long)mm->base_va);
+		} else if (!((end_va < r->base_va || mm->base_va > r_end_va) &&
+			     (end_pa < r->base_pa || mm->base_pa > r_end_pa))) {
+			log_errx("Invalid overlap of region VA:0x%llx",
+				 (unsigned long long)mm->base_va);
+		}
+	}
+
+	for (pos = 0; pos < regions_num; pos++) {
+		const region_t *r = &regions[pos];
+		uint64_t r_end_va = r->base_va + r->size - 1;
+
+		if (r_end_va > end_va ||
+		    (r_end_va == end_va && r->size >= mm->size))
+			break;
+	}
+
+	memmove(&regions[pos + 1], &regions[pos],
+		(regions_num - pos) * sizeof(region_t));
+	regions[pos] = *mm;
+	regions_num++;
+
+	if (end_pa > max_pa)
+		max_pa = end_pa;
+	if (end_va > max_va)
+		max_va = end_va;
+}
+
+static void read_input(const char *path)
+{
+	const unsigned char *data;
+	unsigned int entry_size;
+	unsigned char *elf;
+	size_t elf_size, size, i;
+	region_t mm;
+
+	elf = read_file(path, &elf_size);
+
+	if (elf_size < 0x40 || memcmp(elf, "\177ELF", 4) != 0)
+		log_errx("%s is not an ELF file", path);
+
+	if (elf[EI_CLASS] == ELFCLASS64)
+		is_aarch64 = 1;
+	else if (elf[EI_CLASS] != ELFCLASS32)
+		log_errx("%s has an unknown ELF class", path);
+
+	data = elf_find_section(elf, elf_size, XLAT_GEN_PARAMS_SECTION, &size);
+	if (size != sizeof(params))
+		log_errx("Unexpected size of section " XLAT_GEN_PARAMS_SECTION);
+
+	params.va_max_address = read_le(data, 8);
+	params.pa_max_address = read_le(data + 8, 8);
+	params.max_tables = read_le(data + 16, 8);
+	params.base_level = read_le(data + 24, 8);
+	params.base_table_entries = read_le(data + 32, 8);
+	params.min_block_level = read_le(data + 40, 8);
+	params.execute_never_mask = read_le(data + 48, 8);
+
+	if (params.base_level > XLAT_TABLE_LEVEL_MAX ||
+	    params.base_table_entries > XLAT_TABLE_ENTRIES)
+		log_errx("Invalid translation context parameters");
+
+	data = elf_find_section(elf, elf_size, XLAT_GEN_MMAP_SECTION, &size);
+	entry_size = is_aarch64 ? MMAP_REGION_SIZE_64 : MMAP_REGION_SIZE_32;
+
+	regions = xzalloc(((size / entry_size) + 1) * sizeof(region_t),
+			  "regions");
+
+	for (i = 0; i + entry_size <= size; i += entry_size) {
+		mm.base_pa = read_le(data + i, 8);
+		if (is_aarch64) {
+			mm.base_va = read_le(data + i + 8, 8);
+			mm.size = read_le(data + i + 16, 8);
+			mm.attr = read_le(data + i + 24, 4);
+		} else {
+			mm.base_va = read_le(data + i + 8, 4);
+			mm.size = read_le(data + i + 12, 4);
+			mm.attr = read_le(data + i + 16, 4);
+		}
+
+		if (mm.size == 0)
+			break;
+
+		add_region(&mm);
+	}
+
+	free(elf);
+}
+
+/* Same as xlat_desc() in the translation table library. */
+static uint64_t block_desc(uint32_t attr, uint64_t addr_pa, int level)
+{
+	uint64_t desc = addr_pa;
+	uint32_t mem_type = MT_TYPE(attr);
+
+	desc |= (level == XLAT_TABLE_LEVEL_MAX) ? PAGE_DESC : BLOCK_DESC;
+	desc |= (attr & MT_NS) ? LOWER_ATTRS(NS) : 0;
+	desc |= (attr & MT_RW) ? LOWER_ATTRS(AP_RW) : LOWER_ATTRS(AP_RO);
+	desc |= LOWER_ATTRS(ACCESS_FLAG);
+
+	if (mem_type == MT_DEVICE) {
+		desc |= LOWER_ATTRS(ATTR_DEVICE_INDEX | OSH);
+		desc |= params.execute_never_mask;
+	} else {
+		if ((attr & MT_RW) || (attr & MT_EXECUTE_NEVER))
+			desc |= params.execute_never_mask;
+
+		if (mem_type == MT_MEMORY)
+			desc |= LOWER_ATTRS(ATTR_IWBWA_OWBWA_NTR_INDEX | ISH);
+		else if (mem_type == MT_NON_CACHEABLE)
+			desc |= LOWER_ATTRS(ATTR_NON_CACHEABLE_INDEX | OSH);
+		else
+			log_errx("Invalid memory type 0x%x", mem_type);
+	}
+
+	return desc;
+}
+
+/*
+ * The subtables are identified in the table descriptors by their index in the
+ * tables array plus one, shifted like a table address.
+ */
+static uint64_t *subtable_of(uint64_t desc)
+{
+	return tables[((desc & TABLE_ADDR_MASK) >> XLAT_TABLE_SIZE_SHIFT) - 1];
+}
+
+/* Same as xlat_tables_map_region() in the translation table library. */
+static void map_region(const region_t *mm, uint64_t table_base_va,
+		       uint64_t *table_base, unsigned int table_entries,
+		       int level)
+{
+	uint64_t mm_end_va = mm->base_va + mm->size - 1;
+	uint64_t table_idx_va, entry_end_va, table_idx_pa;
+	unsigned int table_idx;
+
+	if (mm->base_va > table_base_va) {
+		table_idx_va = mm->base_va & ~BLOCK_MASK(level);
+		table_idx = (table_idx_va - table_base_va) >>
+			    XLAT_ADDR_SHIFT(level);
+	} else {
+		table_idx_va = table_base_va;
+		table_idx = 0;
+	}
+
+	for (; table_idx < table_entries;
+	     table_idx++, table_idx_va += BLOCK_SIZE(level)) {
+		uint64_t desc = table_base[table_idx];
+		uint64_t desc_type = desc & DESC_MASK;
+
+		if (table_idx_va > mm_end_va)
+			break;
+
+		entry_end_va = table_idx_va + BLOCK_SIZE(level) - 1;
+		table_idx_pa = mm->base_pa + table_idx_va - mm->base_va;
+
+		if (mm->base_va <= table_idx_va && mm_end_va >= entry_end_va) {
+			/* The entry is covered by the region. */
+			if (level == XLAT_TABLE_LEVEL_MAX) {
+				if (desc_type == INVALID_DESC)
+					table_base[table_idx] = block_desc(
+						mm->attr, table_idx_pa, level);
+				continue;
+			}
+
+			if (desc_type == BLOCK_DESC)
+				continue;
+
+			if (desc_type == INVALID_DESC &&
+			    (table_idx_pa & BLOCK_MASK(level)) == 0 &&
+			    level >= (int)params.min_block_level) {
+				table_base[table_idx] = block_desc(mm->attr,
+							table_idx_pa, level);
+				continue;
+			}
+		}
+
+		/* A finer table is needed. */
+		if (desc_type == BLOCK_DESC)
+			log_errx("Region VA:0x%llx partially overlaps a block",
+				 (unsigned long long)mm->base_va);
+
+		if (desc_type == INVALID_DESC) {
+			if (tables_used >= params.max_tables)
+				log_errx("Not enough tables to map region "
+					 "VA:0x%llx",
+					 (unsigned long long)mm->base_va);
+
+			table_base[table_idx] = TABLE_DESC |
+				((uint64_t)++tables_used <<
+				 XLAT_TABLE_SIZE_SHIFT);
+		}
+
+		map_region(mm, table_idx_va, subtable_of(table_base[table_idx]),
+			   XLAT_TABLE_ENTRIES, level + 1);
+	}
+}
+
+static void emit_u64(FILE *fp, uint64_t val)
+{
+	if (is_aarch64)
+		fprintf(fp, "\t.quad\t0x%016llx\n", (unsigned long long)val);
+	else
+		fprintf(fp, "\t.word\t0x%08llx, 0x%08llx\n",
+			(unsigned long long)(val & 0xffffffffULL),
+			(unsigned long long)(val >> 32));
+}
+
+static void emit_table(FILE *fp, const uint64_t *table, unsigned int entries,
+		       int level)
+{
+	unsigned int i;
+
+	for (i = 0; i < entries; i++) {
+		uint64_t desc = table[i];
+		uint64_t offset;
+
+		if (level == XLAT_TABLE_LEVEL_MAX ||
+		    (desc & DESC_MASK) != TABLE_DESC) {
+			emit_u64(fp, desc);
+			continue;
+		}
+
+		offset = (subtable_of(desc) - tables[0]) * sizeof(uint64_t);
+		fprintf(fp, is_aarch64 ?
+			"\t.quad\txlat_prebuilt_tables + 0x%llx + 0x%x\n" :
+			"\t.word\txlat_prebuilt_tables + 0x%llx + 0x%x, 0\n",
+			(unsigned long long)offset, TABLE_DESC);
+	}
+}
+
+/*
+ * Returns the level of the given table by walking the tables from the base
+ * one. Every subtable is pointed to by exactly one table descriptor.
+ */
+static int table_level(const uint64_t *table, const uint64_t *parent,
+		       unsigned int entries, int level)
+{
+	unsigned int i;
+	int ret;
+
+	if (table == parent)
+		return level;
+
+	if (level == XLAT_TABLE_LEVEL_MAX)
+		return -1;
+
+	for (i = 0; i < entries; i++) {
+		if ((parent[i] & DESC_MASK) != TABLE_DESC)
+			continue;
+
+		ret = table_level(table, subtable_of(parent[i]),
+				  XLAT_TABLE_ENTRIES, level + 1);
+		if (ret >= 0)
+			return ret;
+	}
+
+	return -1;
+}
+
+static void emit_symbol(FILE *fp, const char *name, unsigned int align_shift)
+{
+	fprintf(fp, "\n\t.globl\t%s\n\t.p2align\t%u\n%s:\n",
+		name, align_shift, name);
+}
+
+static void write_output(const char *path)
+{
+	unsigned int i, base_align_shift = 0;
+	FILE *fp;
+
+	fp = fopen(path, "w");
+	if (fp == NULL)
+		log_errx("fopen %s: %s", path, strerror(errno));
+
+	while ((1ULL << base_align_shift) <
+	       params.base_table_entries * sizeof(uint64_t))
+		base_align_shift++;
+
+	fprintf(fp, "/* Generated by xlat_gen, do not edit. */\n\n");
+	fprintf(fp, "\t.section\t.rodata.xlat_prebuilt, \"a\"\n");
+
+	emit_symbol(fp, "xlat_prebuilt_tables", XLAT_TABLE_SIZE_SHIFT);
+	for (i = 0; i < tables_used; i++) {
+		emit_table(fp, tables[i], XLAT_TABLE_ENTRIES,
+			   table_level(tables[i], base_table,
+				       params.base_table_entries,
+				       params.base_level));
+	}
+
+	emit_symbol(fp, "xlat_prebuilt_base_table", base_align_shift);
+	emit_table(fp, base_table, params.base_table_entries,
+		   params.base_level);
+
+	emit_symbol(fp, "xlat_prebuilt_max_pa", 3);
+	emit_u64(fp, max_pa);
+
+	emit_symbol(fp, "xlat_prebuilt_max_va", 3);
+	emit_u64(fp, max_va);
+
+	emit_symbol(fp, "xlat_prebuilt_tables_num", 2);
+	fprintf(fp, "\t.word\t%u\n", tables_used);
+
+	/* Copy of the regions, in the target layout of mmap_region_t. */
+	emit_symbol(fp, "xlat_prebuilt_regions", 3);
+	for (i = 0; i <= regions_num; i++) {
+		emit_u64(fp, regions[i].base_pa);
+		if (is_aarch64) {
+			emit_u64(fp, regions[i].base_va);
+			emit_u64(fp, regions[i].size);
+			fprintf(fp, "\t.word\t0x%x, 0\n", regions[i].attr);
+		} else {
+			fprintf(fp, "\t.word\t0x%llx, 0x%llx, 0x%x, 0\n",
+				(unsigned long long)regions[i].base_va,
+				(unsigned long long)regions[i].size,
+				regions[i].attr);
+		}
+	}
+
+	if (fclose(fp) != 0)
+		log_errx("Failed to write %s", path);
+}
+
+static void usage(void)
+{
+	printf("xlat_gen <input object> <output assembly file>\n");
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned int i;
+
+	if (argc != 3)
+		usage();
+
+	read_input(argv[1]);
+
+	base_table = xzalloc(params.base_table_entries * sizeof(uint64_t),
+			     "base table");
+	tables = xzalloc((params.max_tables ? params.max_tables : 1) *
+			 sizeof(*tables), "tables");
+
+	for (i = 0; i < regions_num; i++)
+		map_region(&regions[i], 0, base_table,
+			   params.base_table_entries, params.base_level);
+
+	write_output(argv[2]);
+
+	return 0;
+}